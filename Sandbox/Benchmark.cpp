@@ -0,0 +1,217 @@
+#include "Benchmark.h"
+#include "Common/CommandLine.h"
+#include "Common/JSON.h"
+
+// The median of sections shorter than this is mostly noise, they are not checked.
+static constexpr double minimumCheckedMilliseconds = 0.05;
+
+// Only the median is read back, by name.
+static eastl::vector_map< eastl::wstring, double > ReadBaseline( const wchar_t* path )
+{
+  eastl::vector_map< eastl::wstring, double > medians;
+
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, path, L"rb" ) )
+    return medians;
+
+  char          line[ 1024 ];
+  eastl::string name;
+  while ( fgets( line, sizeof( line ), fileHandle ) )
+  {
+    auto nameStart = strstr( line, "\"name\": \"" );
+    if ( !nameStart )
+      continue;
+
+    auto nameEnd = ReadJSONString( nameStart + strlen( "\"name\": \"" ), name );
+    auto median  = nameEnd ? strstr( nameEnd, "\"median\": " ) : nullptr;
+    if ( !median )
+      continue;
+
+    medians[ W( name.data() ) ] = atof( median + strlen( "\"median\": " ) );
+  }
+
+  fclose( fileHandle );
+  return medians;
+}
+
+bool Benchmark::ParseCommandLine( const wchar_t* commandLine, Options& options )
+{
+  auto tokens = SplitCommandLine( commandLine );
+  bool enabled = false;
+
+  for ( int tokenIx = 0; tokenIx < int( tokens.size() ); ++tokenIx )
+  {
+    auto& token   = tokens[ tokenIx ];
+    bool  hasNext = tokenIx + 1 < int( tokens.size() );
+
+    if ( token == L"-benchmark" )
+    {
+      enabled = true;
+      if ( hasNext && iswdigit( tokens[ tokenIx + 1 ][ 0 ] ) )
+        options.frameCount = eastl::max( _wtoi( tokens[ ++tokenIx ].data() ), 1 );
+    }
+    else if ( token == L"-output" && hasNext )
+      options.outputPath = tokens[ ++tokenIx ];
+    else if ( token == L"-baseline" && hasNext )
+      options.baselinePath = tokens[ ++tokenIx ];
+    else if ( token == L"-threshold" && hasNext )
+      options.threshold = _wtof( tokens[ ++tokenIx ].data() );
+    else if ( token == L"-headless" )
+      options.headless = true;
+    else if ( token == L"-cpuculling" )
+      options.cpuCulling = true;
+  }
+
+  return enabled;
+}
+
+Benchmark::Benchmark( const Options& options )
+  : options( options )
+{
+  QueryPerformanceCounter( &startTime );
+  startTicks = CPUProfiler::GetTimestamp();
+
+  CPUProfiler::SetCollecting( true );
+}
+
+Benchmark::~Benchmark()
+{
+  CPUProfiler::SetCollecting( false );
+}
+
+int Benchmark::GetSectionIndex( const wchar_t* name )
+{
+  // Names are literals, the same name may come from more literals though.
+  auto literalIter = literalIndices.find( name );
+  if ( literalIter != literalIndices.end() )
+    return literalIter->second;
+
+  auto nameIter = sectionIndices.find_as( name );
+  if ( nameIter == sectionIndices.end() )
+  {
+    nameIter = sectionIndices.emplace( name, int( sections.size() ) ).first;
+
+    Section section;
+    section.name = name;
+    section.frameTicks.resize( frameCount + 1, 0 );
+    sections.emplace_back( eastl::move( section ) );
+  }
+
+  literalIndices.emplace( name, nameIter->second );
+  return nameIter->second;
+}
+
+void Benchmark::EndFrame()
+{
+  for ( auto& section : sections )
+    section.frameTicks.push_back( 0 );
+
+  CPUProfiler::CollectSections( [ this ]( const wchar_t* name, uint64_t start, uint64_t end )
+  {
+    sections[ GetSectionIndex( name ) ].frameTicks.back() += end - start;
+  } );
+
+  ++frameCount;
+}
+
+bool Benchmark::IsDone() const
+{
+  return frameCount > options.frameCount;
+}
+
+int Benchmark::Finish()
+{
+  CPUProfiler::SetCollecting( false );
+
+  // The timestamp counter runs at a constant rate, measure it against the performance counter.
+  LARGE_INTEGER endTime, frequency;
+  auto endTicks = CPUProfiler::GetTimestamp();
+  QueryPerformanceCounter( &endTime );
+  QueryPerformanceFrequency( &frequency );
+
+  auto elapsedMilliseconds = double( endTime.QuadPart - startTime.QuadPart ) * 1000 / frequency.QuadPart;
+  auto ticksPerMillisecond = eastl::max( double( endTicks - startTicks ) / elapsedMilliseconds, 1.0 );
+
+  eastl::vector< SectionStats > stats;
+  eastl::vector< double >       sorted;
+
+  for ( auto& section : sections )
+  {
+    // Only the frames the section was recorded in are samples of it.
+    sorted.clear();
+    for ( auto ticks : section.frameTicks )
+      if ( ticks > 0 )
+        sorted.push_back( double( ticks ) / ticksPerMillisecond );
+
+    if ( sorted.empty() )
+      continue;
+
+    eastl::sort( sorted.begin(), sorted.end() );
+
+    double sum = 0;
+    for ( auto sample : sorted )
+      sum += sample;
+
+    // Nearest rank percentiles.
+    int  count      = int( sorted.size() );
+    auto percentile = [ & ]( double fraction ) { return sorted[ eastl::max( int( ceil( fraction * count ) ) - 1, 0 ) ]; };
+
+    SectionStats sectionStats;
+    sectionStats.name    = section.name;
+    sectionStats.average = sum / count;
+    sectionStats.median  = percentile( 0.5 );
+    sectionStats.p95     = percentile( 0.95 );
+    sectionStats.max     = sorted.back();
+    sectionStats.samples = count;
+    stats.emplace_back( eastl::move( sectionStats ) );
+  }
+
+  eastl::vector< eastl::string > regressions;
+  if ( !options.baselinePath.empty() )
+  {
+    auto baseline = ReadBaseline( options.baselinePath.data() );
+    for ( auto& sectionStats : stats )
+    {
+      auto iter = baseline.find( sectionStats.name );
+      if ( iter == baseline.end() || sectionStats.median < minimumCheckedMilliseconds )
+        continue;
+
+      if ( sectionStats.median > iter->second * ( 1 + options.threshold ) )
+      {
+        char line[ 512 ];
+        sprintf_s( line, "{ \"name\": \"%s\", \"baseline\": %.4f, \"median\": %.4f }", EscapeJSON( sectionStats.name.data() ).data(), iter->second, sectionStats.median );
+        regressions.emplace_back( line );
+
+        eastl::wstring message;
+        OutputDebugStringW( message.sprintf( L"Benchmark regression: %s %.4f ms -> %.4f ms\n", sectionStats.name.data(), iter->second, sectionStats.median ).data() );
+      }
+    }
+  }
+
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, options.outputPath.data(), L"wb" ) )
+    return int( regressions.size() );
+
+  fprintf( fileHandle, "{\n  \"frames\": %d,\n  \"threshold\": %.3f,\n  \"sections\": [\n", options.frameCount, options.threshold );
+  for ( int statIx = 0; statIx < int( stats.size() ); ++statIx )
+  {
+    auto& sectionStats = stats[ statIx ];
+    fprintf( fileHandle
+           , "    { \"name\": \"%s\", \"average\": %.4f, \"median\": %.4f, \"p95\": %.4f, \"max\": %.4f, \"samples\": %d }%s\n"
+           , EscapeJSON( sectionStats.name.data() ).data()
+           , sectionStats.average
+           , sectionStats.median
+           , sectionStats.p95
+           , sectionStats.max
+           , sectionStats.samples
+           , statIx + 1 < int( stats.size() ) ? "," : "" );
+  }
+  fprintf( fileHandle, "  ],\n  \"regressions\": [\n" );
+  for ( int regressionIx = 0; regressionIx < int( regressions.size() ); ++regressionIx )
+    fprintf( fileHandle, "    %s%s\n", regressions[ regressionIx ].data(), regressionIx + 1 < int( regressions.size() ) ? "," : "" );
+  fprintf( fileHandle, "  ]\n}\n" );
+
+  fclose( fileHandle );
+
+  return int( regressions.size() );
+}
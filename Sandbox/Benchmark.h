@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Common/CPUProfiler.h"
+
+// Runs the app for a fixed number of frames and collects the time of every CPUSection per frame.
+// The sections are taken from the rings of the CPU profiler after each frame, so the recording
+// threads take no lock for it. The summary is written as JSON, and when a baseline is given,
+// sections which got slower than the threshold are listed as regressions. The sections closed
+// before the first EndFrame, like the scene load, make up a setup frame of their own.
+class Benchmark
+{
+public:
+  struct Options
+  {
+    int            frameCount = 300;
+    eastl::wstring outputPath = L"Benchmark.json";
+    eastl::wstring baselinePath;
+    double         threshold  = 0.1;
+    bool           headless   = false;
+    bool           cpuCulling = false;
+  };
+
+  struct SectionStats
+  {
+    eastl::wstring name;
+    double         average;
+    double         median;
+    double         p95;
+    double         max;
+    int            samples;
+  };
+
+  // Returns false without -benchmark on the command line.
+  // -benchmark [frames] [-output path] [-baseline path] [-threshold fraction] [-headless] [-cpuculling]
+  static bool ParseCommandLine( const wchar_t* commandLine, Options& options );
+
+  Benchmark( const Options& options );
+  ~Benchmark();
+
+  // Called by the main thread at the end of every frame.
+  void EndFrame();
+
+  bool IsDone() const;
+
+  // Writes the summary and returns the number of regressions against the baseline.
+  int Finish();
+
+private:
+  // The milliseconds of the frames are converted at the end, the ticks per frame are summed up to then.
+  struct Section
+  {
+    eastl::wstring            name;
+    eastl::vector< uint64_t > frameTicks;
+  };
+
+  int GetSectionIndex( const wchar_t* name );
+
+  Options options;
+
+  eastl::vector< Section >                 sections;
+  eastl::vector_map< eastl::wstring, int > sectionIndices;
+  eastl::vector_map< const wchar_t*, int > literalIndices;
+  int                                      frameCount = 0;
+
+  uint64_t      startTicks = 0;
+  LARGE_INTEGER startTime  = {};
+};
\ No newline at end of file
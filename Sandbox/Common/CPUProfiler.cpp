@@ -0,0 +1,220 @@
+#include "CPUProfiler.h"
+#include "JSON.h"
+
+struct TraceEvent
+{
+  const wchar_t* name;
+  uint64_t       start;
+  uint64_t       end;
+};
+
+// Written by its own thread only. The exporter reads it once the capture has stopped, the collector
+// reads up to the write index while the thread goes on.
+struct ThreadBuffer
+{
+  TraceEvent             events[ CPUProfiler::ThreadEventCapacity ];
+  eastl::atomic< int >   writeIndex = 0;
+  int                    readIndex  = 0;
+  eastl::atomic< bool >  owned      = true;
+  int                    threadId   = 0;
+  eastl::string          name;
+};
+
+struct ThreadSlot
+{
+  ~ThreadSlot()
+  {
+    if ( buffer )
+      buffer->owned = false;
+  }
+
+  ThreadBuffer* buffer = nullptr;
+};
+
+static eastl::mutex                                       registryLock;
+static eastl::vector< eastl::unique_ptr< ThreadBuffer > > threadBuffers;
+
+static thread_local ThreadSlot threadSlot;
+
+static eastl::atomic< int > framesLeft        = 0;
+static eastl::wstring       capturePath;
+static uint64_t             captureStartTicks = 0;
+static LARGE_INTEGER        captureStartTime  = {};
+
+static ThreadBuffer& GetThreadBuffer()
+{
+  if ( threadSlot.buffer )
+    return *threadSlot.buffer;
+
+  eastl::lock_guard< eastl::mutex > autoLock( registryLock );
+
+  // Buffers of finished threads are reused, but not during a capture, where they still hold events,
+  // and not before their events are collected.
+  ThreadBuffer* buffer = nullptr;
+  if ( !CPUProfiler::IsCapturing() )
+  {
+    for ( auto& candidate : threadBuffers )
+    {
+      if ( !candidate->owned && candidate->readIndex == candidate->writeIndex )
+      {
+        buffer = candidate.get();
+        buffer->owned      = true;
+        buffer->writeIndex = 0;
+        buffer->readIndex  = 0;
+        buffer->name.clear();
+        break;
+      }
+    }
+  }
+
+  if ( !buffer )
+  {
+    threadBuffers.emplace_back( new ThreadBuffer );
+    buffer = threadBuffers.back().get();
+  }
+
+  buffer->threadId  = int( GetCurrentThreadId() );
+  threadSlot.buffer = buffer;
+  return *buffer;
+}
+
+static void WriteChromeTrace( const wchar_t* path, uint64_t startTicks, double ticksPerMicrosecond )
+{
+  eastl::string json = "{\"traceEvents\":[\n";
+  bool first = true;
+
+  eastl::lock_guard< eastl::mutex > autoLock( registryLock );
+
+  for ( auto& buffer : threadBuffers )
+  {
+    int count = buffer->writeIndex.load( eastl::memory_order_acquire );
+    if ( count == 0 )
+      continue;
+
+    char line[ 256 ];
+    sprintf_s( line, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"", first ? "" : ",\n", buffer->threadId );
+    json += line;
+    if ( buffer->name.empty() )
+      json += eastl::to_string( buffer->threadId );
+    else
+      AppendJSONEscaped( json, buffer->name );
+    json += "\"}}";
+    first = false;
+
+    // When the ring wrapped around, only the newest events are still there.
+    int oldest = eastl::max( count - CPUProfiler::ThreadEventCapacity, 0 );
+    for ( int eventIx = oldest; eventIx < count; ++eventIx )
+    {
+      auto& event = buffer->events[ eventIx & ( CPUProfiler::ThreadEventCapacity - 1 ) ];
+      if ( event.start < startTicks )
+        continue;
+
+      json += ",\n{\"name\":\"";
+      AppendJSONEscaped( json, N( event.name ) );
+      sprintf_s( line, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}"
+               , buffer->threadId
+               , double( event.start - startTicks ) / ticksPerMicrosecond
+               , double( event.end - event.start ) / ticksPerMicrosecond );
+      json += line;
+    }
+  }
+
+  json += "\n]}\n";
+
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, path, L"wb" ) )
+    return;
+
+  fwrite( json.data(), 1, json.size(), fileHandle );
+  fclose( fileHandle );
+}
+
+static_assert( ( CPUProfiler::ThreadEventCapacity & ( CPUProfiler::ThreadEventCapacity - 1 ) ) == 0, "The event capacity has to be a power of two" );
+
+void CPUProfiler::SetThreadName( const char* name )
+{
+  GetThreadBuffer().name = name;
+}
+
+void CPUProfiler::StartCapture( int frameCount, const wchar_t* path )
+{
+  if ( IsCapturing() || frameCount <= 0 )
+    return;
+
+  {
+    eastl::lock_guard< eastl::mutex > autoLock( registryLock );
+    for ( auto& buffer : threadBuffers )
+    {
+      buffer->writeIndex = 0;
+      buffer->readIndex  = 0;
+    }
+  }
+
+  capturePath = path;
+  framesLeft  = frameCount;
+
+  QueryPerformanceCounter( &captureStartTime );
+  captureStartTicks = GetTimestamp();
+
+  capturing = true;
+  UpdateRecording();
+}
+
+void CPUProfiler::SetCollecting( bool enable )
+{
+  collecting = enable;
+  UpdateRecording();
+}
+
+void CPUProfiler::CollectSections( const SectionFunc& func )
+{
+  eastl::lock_guard< eastl::mutex > autoLock( registryLock );
+
+  for ( auto& buffer : threadBuffers )
+  {
+    int count  = buffer->writeIndex.load( eastl::memory_order_acquire );
+    int oldest = eastl::max( buffer->readIndex, count - ThreadEventCapacity );
+
+    for ( int eventIx = oldest; eventIx < count; ++eventIx )
+    {
+      auto& event = buffer->events[ eventIx & ( ThreadEventCapacity - 1 ) ];
+      func( event.name, event.start, event.end );
+    }
+
+    buffer->readIndex = count;
+  }
+}
+
+void CPUProfiler::EndFrame()
+{
+  if ( !IsCapturing() || --framesLeft > 0 )
+    return;
+
+  capturing = false;
+  UpdateRecording();
+
+  // The timestamp counter runs at a constant rate, measure it against the performance counter.
+  LARGE_INTEGER endTime, frequency;
+  auto endTicks = GetTimestamp();
+  QueryPerformanceCounter( &endTime );
+  QueryPerformanceFrequency( &frequency );
+
+  auto elapsedMicroseconds = double( endTime.QuadPart - captureStartTime.QuadPart ) * 1000000 / frequency.QuadPart;
+  auto ticksPerMicrosecond = eastl::max( double( endTicks - captureStartTicks ) / elapsedMicroseconds, 1.0 );
+
+  WriteChromeTrace( capturePath.data(), captureStartTicks, ticksPerMicrosecond );
+}
+
+void CPUProfiler::UpdateRecording()
+{
+  recording = capturing || collecting;
+}
+
+void CPUProfiler::RecordEvent( const wchar_t* name, uint64_t start, uint64_t end )
+{
+  auto& buffer = GetThreadBuffer();
+
+  int index = buffer.writeIndex.load( eastl::memory_order_relaxed );
+  buffer.events[ index & ( ThreadEventCapacity - 1 ) ] = { name, start, end };
+  buffer.writeIndex.store( index + 1, eastl::memory_order_release );
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+// Records CPUSection scopes of every thread while a capture is running, and writes them out in the
+// Chrome trace event format, which chrome://tracing and Perfetto both open. Each thread writes into
+// a ring of its own, so recording takes no lock. Outside of a capture a scope only costs two rdtsc.
+// The rings can be collected without a capture too, like the benchmark mode does after each frame.
+class CPUProfiler
+{
+public:
+  static constexpr int ThreadEventCapacity = 16 * 1024;
+
+  using SectionFunc = eastl::function< void( const wchar_t* name, uint64_t start, uint64_t end ) >;
+
+  // Names the calling thread in the captures. SetThreadName calls it.
+  static void SetThreadName( const char* name );
+
+  // Records the next frameCount frames, and writes them to path when they are done.
+  static void StartCapture( int frameCount, const wchar_t* path );
+
+  // Called at the end of every frame by the main thread.
+  static void EndFrame();
+
+  // Keeps recording the sections outside of a capture, for CollectSections.
+  static void SetCollecting( bool enable );
+
+  // Hands the sections recorded since the previous call to func, thread by thread. Only one thread may
+  // collect. A thread which recorded more than the capacity of its ring in between loses the oldest ones.
+  static void CollectSections( const SectionFunc& func );
+
+  static bool IsCapturing()
+  {
+    return capturing.load( eastl::memory_order_relaxed );
+  }
+
+  static uint64_t GetTimestamp()
+  {
+    return __rdtsc();
+  }
+
+  // The name has to outlive the capture, scopes are named with literals.
+  static void Record( const wchar_t* name, uint64_t start, uint64_t end )
+  {
+    if ( recording.load( eastl::memory_order_relaxed ) )
+      RecordEvent( name, start, end );
+  }
+
+private:
+  static void RecordEvent( const wchar_t* name, uint64_t start, uint64_t end );
+  static void UpdateRecording();
+
+  static inline eastl::atomic< bool > capturing  = false;
+  static inline eastl::atomic< bool > collecting = false;
+  static inline eastl::atomic< bool > recording  = false;
+};
+
+struct CPUSection
+{
+  CPUSection( const wchar_t* name )
+    : name( name )
+    , start( CPUProfiler::GetTimestamp() )
+  {
+    #if USE_PIX
+      PIXBeginEvent( PIX_COLOR_DEFAULT, name );
+    #endif // USE_PIX
+  }
+  ~CPUSection()
+  {
+    Close();
+  }
+  void Close()
+  {
+    if ( !closed )
+    {
+      CPUProfiler::Record( name, start, CPUProfiler::GetTimestamp() );
+
+      #if USE_PIX
+        PIXEndEvent();
+      #endif // USE_PIX
+    }
+    closed = true;
+  }
+
+private:
+  const wchar_t* name;
+  uint64_t       start;
+  bool           closed = false;
+};
\ No newline at end of file
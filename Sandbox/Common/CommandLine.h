@@ -0,0 +1,25 @@
+#pragma once
+
+// Splits the command line at white spaces, quotes are not handled.
+inline eastl::vector< eastl::wstring > SplitCommandLine( const wchar_t* commandLine )
+{
+  eastl::vector< eastl::wstring > tokens;
+  eastl::wstring token;
+
+  for ( auto c = commandLine; c && *c; ++c )
+  {
+    if ( iswspace( *c ) )
+    {
+      if ( !token.empty() )
+        tokens.emplace_back( eastl::move( token ) );
+      token.clear();
+    }
+    else
+      token.push_back( *c );
+  }
+
+  if ( !token.empty() )
+    tokens.emplace_back( eastl::move( token ) );
+
+  return tokens;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+// Appends text as the content of a JSON string. Quotes and backslashes are escaped, control characters are dropped.
+inline void AppendJSONEscaped( eastl::string& json, const eastl::string& text )
+{
+  for ( auto c : text )
+  {
+    if ( c == '"' || c == '\\' )
+      json.push_back( '\\' );
+    if ( uint8_t( c ) >= 0x20 )
+      json.push_back( c );
+  }
+}
+
+inline eastl::string EscapeJSON( const wchar_t* text )
+{
+  eastl::string json;
+  AppendJSONEscaped( json, N( text ) );
+  return json;
+}
+
+// Reads the JSON string starting after its opening quote, up to the closing one. Returns the position after it,
+// or null when the string does not end. Only the escapes written by AppendJSONEscaped are expected.
+inline const char* ReadJSONString( const char* json, eastl::string& text )
+{
+  text.clear();
+
+  for ( auto c = json; *c; ++c )
+  {
+    if ( *c == '"' )
+      return c + 1;
+
+    if ( *c == '\\' && c[ 1 ] )
+      ++c;
+
+    text.push_back( *c );
+  }
+
+  return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "MappedFile.h"
+#include "WorkerPool.h"
+
+static constexpr int MaxPooledBuffers  = 16;
+static constexpr int LoaderThreadCount = 2;
+
+static eastl::mutex                                     bufferPoolLock;
+static eastl::vector< eastl::unique_ptr< uint8_t[] > > bufferPool;
+
+static eastl::unique_ptr< uint8_t[] > RequestPooledBuffer()
+{
+  eastl::lock_guard< eastl::mutex > autoLock( bufferPoolLock );
+
+  if ( bufferPool.empty() )
+    return eastl::unique_ptr< uint8_t[] >( new uint8_t[ MappedFile::PooledBufferSize ] );
+
+  auto buffer = eastl::move( bufferPool.back() );
+  bufferPool.pop_back();
+  return buffer;
+}
+
+static void DiscardPooledBuffer( eastl::unique_ptr< uint8_t[] > buffer )
+{
+  eastl::lock_guard< eastl::mutex > autoLock( bufferPoolLock );
+
+  if ( bufferPool.size() < MaxPooledBuffers )
+    bufferPool.emplace_back( eastl::move( buffer ) );
+}
+
+// The loads wait on the disk most of the time, a few threads of their own keep the disk busy without taking the
+// threads of the frame work.
+static WorkerPool& GetLoaderPool()
+{
+  static WorkerPool loaderPool( LoaderThreadCount, "File loader" );
+  return loaderPool;
+}
+
+std::future< MappedFile > MappedFile::OpenAsync( const wchar_t* path, AccessHint hint )
+{
+  return GetLoaderPool().Async( [ filePath = eastl::wstring( path ), hint ]()
+  {
+    MappedFile file( filePath.data(), hint );
+
+    // Touching a byte per page waits for the prefetch here, instead of on the thread using the data.
+    if ( hint == AccessHint::WillNeed && file.mappingHandle )
+    {
+      uint8_t sum = 0;
+      for ( size_t offset = 0; offset < file.fileSize; offset += 4096 )
+        sum += file.fileData[ offset ];
+
+      volatile uint8_t sink = sum;
+    }
+
+    return file;
+  } );
+}
+
+MappedFile::MappedFile( const wchar_t* path, AccessHint hint )
+{
+  CPUSection cpuSection( L"Open mapped file" );
+
+  DWORD flags = FILE_ATTRIBUTE_NORMAL;
+  if ( hint == AccessHint::Sequential )
+    flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+  else if ( hint == AccessHint::Random )
+    flags |= FILE_FLAG_RANDOM_ACCESS;
+
+  HANDLE fileHandle = CreateFileW( path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr );
+  if ( fileHandle == INVALID_HANDLE_VALUE )
+    return;
+
+  auto closeFile = eastl::make_finally( [ fileHandle ]() { CloseHandle( fileHandle ); } );
+
+  LARGE_INTEGER length;
+  if ( !GetFileSizeEx( fileHandle, &length ) || length.QuadPart == 0 )
+    return;
+
+  if ( uint64_t( length.QuadPart ) <= PooledBufferSize )
+  {
+    auto buffer = RequestPooledBuffer();
+
+    DWORD bytesRead = 0;
+    if ( !ReadFile( fileHandle, buffer.get(), DWORD( length.QuadPart ), &bytesRead, nullptr ) || bytesRead != DWORD( length.QuadPart ) )
+    {
+      DiscardPooledBuffer( eastl::move( buffer ) );
+      return;
+    }
+
+    pooledBuffer = eastl::move( buffer );
+    fileData     = pooledBuffer.get();
+    fileSize     = size_t( length.QuadPart );
+    return;
+  }
+
+  // The mapping keeps the file open, the handle is not needed after this.
+  mappingHandle = CreateFileMappingW( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+  if ( !mappingHandle )
+    return;
+
+  fileData = static_cast< const uint8_t* >( MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+  if ( !fileData )
+  {
+    Release();
+    return;
+  }
+
+  fileSize = size_t( length.QuadPart );
+
+  if ( hint == AccessHint::WillNeed )
+    Prefetch();
+}
+
+MappedFile::MappedFile( MappedFile&& other )
+{
+  *this = eastl::move( other );
+}
+
+MappedFile& MappedFile::operator = ( MappedFile&& other )
+{
+  if ( this != &other )
+  {
+    Release();
+
+    mappingHandle = other.mappingHandle;
+    fileData      = other.fileData;
+    fileSize      = other.fileSize;
+    pooledBuffer  = eastl::move( other.pooledBuffer );
+
+    other.mappingHandle = nullptr;
+    other.fileData      = nullptr;
+    other.fileSize      = 0;
+  }
+
+  return *this;
+}
+
+MappedFile::~MappedFile()
+{
+  Release();
+}
+
+void MappedFile::Release()
+{
+  if ( pooledBuffer )
+    DiscardPooledBuffer( eastl::move( pooledBuffer ) );
+  else if ( fileData )
+    UnmapViewOfFile( fileData );
+
+  if ( mappingHandle )
+    CloseHandle( mappingHandle );
+
+  mappingHandle = nullptr;
+  fileData      = nullptr;
+  fileSize      = 0;
+}
+
+const uint8_t* MappedFile::data() const
+{
+  return fileData;
+}
+
+size_t MappedFile::size() const
+{
+  return fileSize;
+}
+
+bool MappedFile::empty() const
+{
+  return fileSize == 0;
+}
+
+void MappedFile::Prefetch( size_t offset, size_t length ) const
+{
+  // Pooled buffers are in memory already.
+  if ( !mappingHandle || offset >= fileSize )
+    return;
+
+  WIN32_MEMORY_RANGE_ENTRY range;
+  range.VirtualAddress = const_cast< uint8_t* >( fileData + offset );
+  range.NumberOfBytes  = eastl::min( length, fileSize - offset );
+  PrefetchVirtualMemory( GetCurrentProcess(), 1, &range, 0 );
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+// A read only view of a whole file, without copying it into a vector first. Large files are memory
+// mapped, small ones are read into a pooled buffer, as mapping them costs more than the read.
+class MappedFile
+{
+public:
+  static constexpr size_t PooledBufferSize = 64 * 1024;
+
+  // Like the madvise advice, tells the system how the data is going to be read.
+  enum class AccessHint
+  {
+    Normal,
+    Sequential,
+    Random,
+    WillNeed,
+  };
+
+  // Opens the file on a thread of the loader pool. With WillNeed the data is also paged in there, so a batch of
+  // files can be opened together and consumed later, once they are needed.
+  static std::future< MappedFile > OpenAsync( const wchar_t* path, AccessHint hint = AccessHint::WillNeed );
+
+  MappedFile() = default;
+  MappedFile( const wchar_t* path, AccessHint hint = AccessHint::Normal );
+  MappedFile( MappedFile&& other );
+  MappedFile& operator = ( MappedFile&& other );
+  ~MappedFile();
+
+  MappedFile( const MappedFile& ) = delete;
+  MappedFile& operator = ( const MappedFile& ) = delete;
+
+  const uint8_t* data() const;
+  size_t size() const;
+  bool empty() const;
+
+  // Starts reading the range into memory ahead of the access. It returns without waiting for the reads.
+  void Prefetch( size_t offset = 0, size_t length = SIZE_MAX ) const;
+
+private:
+  void Release();
+
+  HANDLE         mappingHandle = nullptr;
+  const uint8_t* fileData      = nullptr;
+  size_t         fileSize      = 0;
+
+  eastl::unique_ptr< uint8_t[] > pooledBuffer;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "WorkerPool.h"
+
+// Splits [0, count) into one range per thread of the shared worker pool, each at least minRangeSize long, and calls
+// func( begin, end ) for each of them. The calling thread takes ranges too, and the call returns when all of them are
+// done. The ranges are taken by whoever gets to them first, so a ParallelFor in func does not wait for a busy pool.
+template< typename RangeFunc >
+inline void ParallelFor( int count, int minRangeSize, RangeFunc&& func )
+{
+  if ( count <= 0 )
+    return;
+
+  auto& pool = WorkerPool::GetShared();
+
+  int rangeCount = eastl::min( pool.GetThreadCount() + 1, ( count + minRangeSize - 1 ) / minRangeSize );
+  if ( rangeCount <= 1 )
+  {
+    func( 0, count );
+    return;
+  }
+
+  int rangeSize = ( count + rangeCount - 1 ) / rangeCount;
+  rangeCount = ( count + rangeSize - 1 ) / rangeSize;
+
+  // Shared with the jobs, as a job can start after all the ranges are done and this call returned.
+  struct State
+  {
+    eastl::atomic< int >    nextRange = 0;
+    int                     doneRanges = 0;
+    std::mutex              doneLock;
+    std::condition_variable allDone;
+  };
+
+  auto state = eastl::make_shared< State >();
+
+  // func is only touched while there are ranges left, so the caller is still waiting for them.
+  auto takeRanges = [ state, &func, count, rangeCount, rangeSize ]()
+  {
+    for ( int rangeIx = state->nextRange++; rangeIx < rangeCount; rangeIx = state->nextRange++ )
+    {
+      int begin = rangeIx * rangeSize;
+      func( begin, eastl::min( begin + rangeSize, count ) );
+
+      std::lock_guard< std::mutex > autoLock( state->doneLock );
+      if ( ++state->doneRanges == rangeCount )
+        state->allDone.notify_one();
+    }
+  };
+
+  for ( int jobIx = 1; jobIx < rangeCount; jobIx++ )
+    pool.Enqueue( takeRanges );
+
+  takeRanges();
+
+  std::unique_lock< std::mutex > autoLock( state->doneLock );
+  state->allDone.wait( autoLock, [ &state, rangeCount ]() { return state->doneRanges == rangeCount; } );
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool( int threadCount, const char* name )
+  : name( name )
+{
+  assert( threadCount > 0 );
+
+  threads.reserve( threadCount );
+  for ( int threadIx = 0; threadIx < threadCount; threadIx++ )
+    threads.emplace_back( WorkerThreadFunc, eastl::ref( *this ), threadIx );
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard< std::mutex > autoLock( queueLock );
+    keepWorking = false;
+  }
+
+  queueChanged.notify_all();
+
+  for ( auto& thread : threads )
+    thread.join();
+}
+
+void WorkerPool::Enqueue( Job&& job )
+{
+  {
+    std::lock_guard< std::mutex > autoLock( queueLock );
+    jobs.emplace( eastl::move( job ) );
+  }
+
+  queueChanged.notify_one();
+}
+
+int WorkerPool::GetThreadCount() const
+{
+  return int( threads.size() );
+}
+
+WorkerPool& WorkerPool::GetShared()
+{
+  static WorkerPool sharedPool( eastl::max( int( std::thread::hardware_concurrency() ) - 1, 1 ), "Worker" );
+  return sharedPool;
+}
+
+void WorkerPool::WorkerThreadFunc( WorkerPool& thiz, int threadIx )
+{
+  char threadName[ 64 ];
+  sprintf_s( threadName, "%s %d", thiz.name.data(), threadIx );
+  SetThreadName( GetCurrentThreadId(), threadName );
+
+  while ( true )
+  {
+    Job job;
+
+    {
+      std::unique_lock< std::mutex > autoLock( thiz.queueLock );
+      thiz.queueChanged.wait( autoLock, [ &thiz ]() { return !thiz.jobs.empty() || !thiz.keepWorking; } );
+
+      // Only stops when the queue is empty, so the futures of the queued jobs are all fulfilled.
+      if ( thiz.jobs.empty() )
+        return;
+
+      job = eastl::move( thiz.jobs.front() );
+      thiz.jobs.pop();
+    }
+
+    job();
+  }
+}
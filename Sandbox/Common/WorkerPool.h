@@ -0,0 +1,52 @@
+#pragma once
+
+// A fixed set of threads taking jobs from a shared queue, so the work spread over the cores does not start threads of
+// its own every time. The jobs are started in the order they were enqueued, with more threads they can finish in any
+// order. The jobs still queued when the pool is destroyed are run before its threads exit.
+class WorkerPool
+{
+public:
+  using Job = eastl::function< void() >;
+
+  WorkerPool( int threadCount, const char* name );
+  ~WorkerPool();
+
+  WorkerPool( const WorkerPool& ) = delete;
+  WorkerPool& operator = ( const WorkerPool& ) = delete;
+
+  void Enqueue( Job&& job );
+
+  // Runs func on a worker thread, the future gets its result.
+  template< typename Func >
+  auto Async( Func&& func ) -> std::future< decltype( func() ) >;
+
+  int GetThreadCount() const;
+
+  // Used by ParallelFor and the frame work, with a thread for every core but the one of the calling thread.
+  static WorkerPool& GetShared();
+
+private:
+  static void WorkerThreadFunc( WorkerPool& thiz, int threadIx );
+
+  eastl::string                name;
+  eastl::vector< std::thread > threads;
+
+  std::mutex              queueLock;
+  std::condition_variable queueChanged;
+  eastl::queue< Job >     jobs;
+  bool                    keepWorking = true;
+};
+
+template< typename Func >
+inline auto WorkerPool::Async( Func&& func ) -> std::future< decltype( func() ) >
+{
+  using Result = decltype( func() );
+
+  // The job has to be copyable, the task is shared with it instead of being moved in.
+  auto task   = eastl::make_shared< std::packaged_task< Result() > >( eastl::forward< Func >( func ) );
+  auto result = task->get_future();
+
+  Enqueue( [ task ]() { ( *task )(); } );
+
+  return result;
+}
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <thread>
 #include <cassert>
 #include <mutex>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <future>
@@ -493,6 +494,8 @@ inline void Convert( uint16_t* __restrict out, const float in )
 
 }
 
+#include "Common/CPUProfiler.h"
+
 const DWORD MS_VC_EXCEPTION = 0x406D1388;
 
 #pragma pack( push, 8 )
@@ -520,12 +523,15 @@ inline void SetThreadName( DWORD dwThreadID, char* threadName )
   __except ( EXCEPTION_EXECUTE_HANDLER )
   {
   }
+
+  if ( dwThreadID == GetCurrentThreadId() )
+    CPUProfiler::SetThreadName( threadName );
 }
 
 template< size_t length >
 constexpr unsigned atou_cex( const char (&str)[ length ] )
 {
-  static_assert( length <= 5, "Too long string" );
+  static_assert( length <= 6, "Too long string" );
 
   int result = 0;
 
@@ -541,32 +547,8 @@ constexpr unsigned atou_cex( const char (&str)[ length ] )
   if constexpr ( length > 4 )
     result += ( str[ length - 5 ] - '0' ) * 1000;
 
-  return result;
-}
+  if constexpr ( length > 5 )
+    result += ( str[ length - 6 ] - '0' ) * 10000;
 
-struct CPUSection
-{
-  CPUSection( const wchar_t* name )
-  {
-    #if USE_PIX
-      PIXBeginEvent( PIX_COLOR_DEFAULT, name );
-    #endif // USE_PIX
-  }
-  ~CPUSection()
-  {
-    Close();
-  }
-  void Close()
-  {
-    if ( !closed )
-    {
-      #if USE_PIX
-        PIXEndEvent();
-      #endif // USE_PIX
-    }
-    closed = true;
-  }
-
-private:
-  bool closed = false;
-};
\ No newline at end of file
+  return result;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "HeadlessWindow.h"
+
+eastl::unique_ptr< Window > Window::CreateHeadless( int width, int height )
+{
+  return eastl::unique_ptr< Window >( new HeadlessWindow( width, height ) );
+}
+
+HeadlessWindow::HeadlessWindow( int width, int height )
+  : width( width )
+  , height( height )
+{
+}
+
+bool HeadlessWindow::IsValid() const
+{
+  return true;
+}
+
+bool HeadlessWindow::ProcessMessages()
+{
+  return true;
+}
+
+int HeadlessWindow::GetClientWidth()
+{
+  return width;
+}
+
+int HeadlessWindow::GetClientHeight()
+{
+  return height;
+}
+
+void HeadlessWindow::SetCaption( const wchar_t* caption )
+{
+}
+
+void HeadlessWindow::DearImGuiNewFrame()
+{
+}
+
+void HeadlessWindow::SetCameraControlMode( bool enabled )
+{
+}
+
+bool HeadlessWindow::IsCameraControlMode() const
+{
+  return false;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Window.h"
+
+// A window without an OS window behind it, for the null backend. Its size never changes and no input arrives.
+class HeadlessWindow final : public Window
+{
+  friend struct Window;
+
+public:
+  bool IsValid() const override;
+
+  bool ProcessMessages() override;
+
+  int GetClientWidth() override;
+  int GetClientHeight() override;
+
+  void SetCaption( const wchar_t* caption ) override;
+
+  void DearImGuiNewFrame() override;
+
+  void SetCameraControlMode( bool enabled ) override;
+  bool IsCameraControlMode() const override;
+
+private:
+  HeadlessWindow( int width, int height );
+
+  int width;
+  int height;
+};
\ No newline at end of file
@@ -5,6 +5,7 @@
 struct Window
 {
   static eastl::unique_ptr< Window > Create( int width, int height );
+  static eastl::unique_ptr< Window > CreateHeadless( int width, int height );
 
   virtual ~Window() = default;
 
@@ -2,8 +2,9 @@
 #include "CommandAllocator.h"
 #include "Device.h"
 
-CommandAllocatorPool::CommandAllocatorPool( CommandQueueType queueType )
+CommandAllocatorPool::CommandAllocatorPool( CommandQueueType queueType, int maxAllocators )
   : commandQueueType( queueType )
+  , maxAllocators( maxAllocators )
 {
 }
 
@@ -15,24 +16,39 @@ CommandAllocator* CommandAllocatorPool::RequestAllocator( Device& device, uint64
 {
   eastl::lock_guard< eastl::mutex > lockGuard( allocatorMutex );
 
+  lastCompletedFence = eastl::max( lastCompletedFence, completedFenceValue );
+
+  auto isCompleted = [ this ]( const RetiredAllocator& retired ) { return retired.fence <= lastCompletedFence; };
+
   CommandAllocator* allocator = nullptr;
 
-  if ( !readyAllocators.empty() )
+  auto iter = eastl::find_if( retiredAllocators.begin(), retiredAllocators.end(), isCompleted );
+  if ( iter != retiredAllocators.end() )
+  {
+    allocator = iter->allocator;
+    retiredAllocators.erase_unsorted( iter );
+  }
+
+  // Shrink back to the cap with the completed ones left after a spike.
+  while ( int( allocatorPool.size() ) > maxAllocators )
   {
-    eastl::pair< uint64_t, CommandAllocator* >& allocatorPair = readyAllocators.front();
-
-    if ( allocatorPair.first <= completedFenceValue )
-    {
-      allocator = allocatorPair.second;
-      allocator->Reset();
-      readyAllocators.pop();
-    }
+    iter = eastl::find_if( retiredAllocators.begin(), retiredAllocators.end(), isCompleted );
+    if ( iter == retiredAllocators.end() )
+      break;
+
+    Destroy( iter->allocator );
+    retiredAllocators.erase_unsorted( iter );
   }
 
-  if ( !allocator )
+  if ( allocator )
+    allocator->Reset();
+  else
   {
     allocatorPool.emplace_back( device.CreateCommandAllocator( commandQueueType ) );
     allocator = allocatorPool.back().get();
+
+    ++createdTotal;
+    peak = eastl::max( peak, int( allocatorPool.size() ) );
   }
 
   return allocator;
@@ -42,10 +58,43 @@ void CommandAllocatorPool::DiscardAllocator( uint64_t fenceValue, CommandAllocat
 {
   eastl::lock_guard< eastl::mutex > lockGuard( allocatorMutex );
 
-  readyAllocators.push( eastl::make_pair( fenceValue, allocator ) );
+  retiredAllocators.push_back( { fenceValue, allocator } );
 }
 
 size_t CommandAllocatorPool::Size() const
 {
-  return size_t();
+  eastl::lock_guard< eastl::mutex > lockGuard( allocatorMutex );
+
+  return allocatorPool.size();
 }
+
+CommandAllocatorPool::Stats CommandAllocatorPool::GetStats() const
+{
+  eastl::lock_guard< eastl::mutex > lockGuard( allocatorMutex );
+
+  Stats stats = {};
+  stats.live           = int( allocatorPool.size() );
+  stats.peak           = peak;
+  stats.createdTotal   = createdTotal;
+  stats.destroyedTotal = destroyedTotal;
+
+  for ( auto& retired : retiredAllocators )
+  {
+    if ( retired.fence > lastCompletedFence )
+      ++stats.inFlight;
+    else
+      ++stats.idle;
+  }
+
+  stats.recording = stats.live - stats.inFlight - stats.idle;
+  return stats;
+}
+
+void CommandAllocatorPool::Destroy( CommandAllocator* allocator )
+{
+  auto iter = eastl::find_if( allocatorPool.begin(), allocatorPool.end(), [ allocator ]( const eastl::unique_ptr< CommandAllocator >& pooled ) { return pooled.get() == allocator; } );
+  assert( iter != allocatorPool.end() );
+
+  allocatorPool.erase_unsorted( iter );
+  ++destroyedTotal;
+}
\ No newline at end of file
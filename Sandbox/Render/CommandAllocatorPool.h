@@ -5,10 +5,26 @@
 struct Device;
 struct CommandAllocator;
 
+// Allocators discarded with the fence of their submission are reused once any of them completes,
+// not only the oldest. Requests never wait for the GPU, so the pool can go over the cap for a
+// while, and the extra allocators are destroyed as soon as they complete.
 class CommandAllocatorPool
 {
 public:
-  CommandAllocatorPool( CommandQueueType queueType );
+  static constexpr int DefaultMaxAllocators = 32;
+
+  struct Stats
+  {
+    int live;
+    int recording;
+    int inFlight;
+    int idle;
+    int peak;
+    int createdTotal;
+    int destroyedTotal;
+  };
+
+  CommandAllocatorPool( CommandQueueType queueType, int maxAllocators = DefaultMaxAllocators );
   ~CommandAllocatorPool();
 
   CommandAllocator* RequestAllocator( Device& device, uint64_t completedFenceValue );
@@ -16,10 +32,26 @@ public:
 
   size_t Size() const;
 
+  Stats GetStats() const;
+
 private:
+  struct RetiredAllocator
+  {
+    uint64_t          fence;
+    CommandAllocator* allocator;
+  };
+
+  void Destroy( CommandAllocator* allocator );
+
   CommandQueueType commandQueueType;
 
-  eastl::vector< eastl::unique_ptr< CommandAllocator > >     allocatorPool;
-  eastl::queue< eastl::pair< uint64_t, CommandAllocator* > > readyAllocators;
-  eastl::mutex                                               allocatorMutex;
+  eastl::vector< eastl::unique_ptr< CommandAllocator > > allocatorPool;
+  eastl::vector< RetiredAllocator >                      retiredAllocators;
+  mutable eastl::mutex                                   allocatorMutex;
+
+  int      maxAllocators;
+  int      peak               = 0;
+  int      createdTotal       = 0;
+  int      destroyedTotal     = 0;
+  uint64_t lastCompletedFence = 0;
 };
\ No newline at end of file
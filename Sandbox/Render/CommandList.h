@@ -6,12 +6,16 @@ struct Resource;
 struct PipelineState;
 struct Color;
 struct RTTopLevelAccelerator;
+struct RTBottomLevelAccelerator;
+struct MemoryHeap;
 struct DescriptorHeap;
 struct ComputeShader;
 struct ResourceDescriptor;
 struct CommandSignature;
 struct RTShaders;
 
+class UploadAllocator;
+
 enum class VRSBlock : uint32_t;
 
 struct CommandList
@@ -22,12 +26,36 @@ struct CommandList
     ResourceState newState;
   };
 
+  // Barriers for AddBarriers. The split ones are begun after the last use of the resource and ended before the next,
+  // the state isn't changed until the end half is added.
+  struct ResourceBarrier
+  {
+    enum class Type
+    {
+      Transition,
+      Aliasing,
+    };
+
+    enum class Split
+    {
+      None,
+      Begin,
+      End,
+    };
+
+    Type          type;
+    Split         split;
+    Resource*     resource;
+    ResourceState newState;
+  };
+
   virtual ~CommandList() = default;
 
   virtual void BindHeaps() = 0;
 
   virtual void ChangeResourceState( Resource& resource, ResourceState newState ) = 0;
   virtual void ChangeResourceState( eastl::initializer_list< ResourceStateChange > resources ) = 0;
+  virtual void AddBarriers( const ResourceBarrier* barriers, int count ) = 0;
 
   virtual void ClearRenderTarget( Resource& texture, const Color& color ) = 0;
   virtual void ClearDepthStencil( Resource& texture, float depth ) = 0;
@@ -81,29 +109,44 @@ struct CommandList
 
   virtual void UploadTextureResource( eastl::unique_ptr< Resource > source, Resource& destination, const void* data, int stride, int rows ) = 0;
   virtual void UploadTextureRegion( eastl::unique_ptr< Resource > source, Resource& destination, int mip, int left, int top, int width, int height ) = 0;
-  virtual void UploadBufferResource( eastl::unique_ptr< Resource > source, Resource& destination, const void* data, int dataSize ) = 0;
+  virtual void UploadBufferResource( Resource& destination, const void* data, int dataSize ) = 0;
 
-  virtual void UpdateBufferRegion( eastl::unique_ptr< Resource > source, Resource& destination, int offset ) = 0;
+  virtual void UpdateBufferRegion( Resource& destination, int offset, const void* data, int dataSize ) = 0;
 
   virtual void CopyResource( Resource& source, Resource& destination ) = 0;
+  virtual void CopyBufferRegion( Resource& source, int sourceOffset, Resource& destination, int destinationOffset, int size ) = 0;
 
   virtual void ResolveMSAA( Resource& source, Resource& destination ) = 0;
 
   virtual void HoldResource( eastl::unique_ptr< Resource > resource ) = 0;
   virtual void HoldResource( eastl::unique_ptr< RTTopLevelAccelerator > resource ) = 0;
+  virtual void HoldResource( eastl::unique_ptr< RTBottomLevelAccelerator > resource ) = 0;
   virtual void HoldResource( IUnknown* unknown ) = 0;
 
+  // Heaps are released after the resources held by the same list, so the ones placed in them go first.
+  virtual void HoldResource( eastl::unique_ptr< MemoryHeap > heap ) = 0;
+
   virtual eastl::vector< eastl::unique_ptr< Resource > > TakeHeldResources() = 0;
   virtual eastl::vector< eastl::unique_ptr< RTTopLevelAccelerator > > TakeHeldTLAS() = 0;
+  virtual eastl::vector< eastl::unique_ptr< RTBottomLevelAccelerator > > TakeHeldBLAS() = 0;
   virtual eastl::vector< CComPtr< IUnknown > > TakeHeldUnknowns() = 0;
+  virtual eastl::vector< eastl::unique_ptr< MemoryHeap > > TakeHeldHeaps() = 0;
 
   virtual void BeginEvent( const wchar_t* format, ... ) = 0;
   virtual void EndEvent() = 0;
 
+  // Ends the innermost event on this list, but keeps its timed section running. It is carried on with
+  // ContinueEvent on a list executed later in the same frame, and its GPU time covers the lists in between.
+  virtual int  SuspendEvent() = 0;
+  virtual void ContinueEvent( const wchar_t* name, int sectionId ) = 0;
+
   using EndFrameCallback = eastl::function< void() >;
   virtual void RegisterEndFrameCallback( EndFrameCallback&& callback ) = 0;
   virtual eastl::vector< EndFrameCallback > TakeEndFrameCallbacks() = 0;
 
+  // Upload memory for this list, valid until the list is executed.
+  virtual UploadAllocator& GetUploadAllocator() = 0;
+
   template< typename T >
   void SetConstantValues( int index, const T& values, int offset )
   {
@@ -122,7 +165,8 @@ struct CommandList
 struct GPUSection
 {
   GPUSection( CommandList& commandList, const wchar_t* name )
-    : commandList( commandList )
+    : commandList( &commandList )
+    , name( name )
   {
     commandList.BeginEvent( name );
   }
@@ -132,12 +176,33 @@ struct GPUSection
   }
   void Close()
   {
-    if ( !closed )
-      commandList.EndEvent();
+    if ( !closed && !suspended )
+      commandList->EndEvent();
     closed = true;
   }
 
+  // Moves the section over to the list continuing the frame. The sections nested in this one are suspended
+  // before it, and continued after it.
+  void Suspend()
+  {
+    if ( !closed && !suspended )
+      sectionId = commandList->SuspendEvent();
+    suspended = true;
+  }
+  void Continue( CommandList& nextList )
+  {
+    assert( suspended );
+
+    commandList = &nextList;
+    if ( !closed )
+      nextList.ContinueEvent( name, sectionId );
+    suspended = false;
+  }
+
 private:
-  CommandList& commandList;
-  bool closed = false;
+  CommandList*   commandList;
+  const wchar_t* name;
+  int            sectionId = -1;
+  bool           closed    = false;
+  bool           suspended = false;
 };
\ No newline at end of file
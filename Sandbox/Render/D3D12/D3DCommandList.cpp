@@ -4,11 +4,13 @@
 #include "D3DResource.h"
 #include "D3DPipelineState.h"
 #include "D3DRTTopLevelAccelerator.h"
+#include "D3DRTBottomLevelAccelerator.h"
 #include "D3DDescriptorHeap.h"
 #include "D3DResourceDescriptor.h"
 #include "D3DComputeShader.h"
 #include "D3DCommandSignature.h"
 #include "D3DRTShaders.h"
+#include "D3DGPUProfiler.h"
 #include "D3DUtils.h"
 #include "Conversion.h"
 #include "Common/Color.h"
@@ -17,6 +19,9 @@
 #include "../ShaderValues.h"
 #include "../DearImGui/imgui_impl_dx12.h"
 
+// Buffer copies have no alignment requirement, this keeps the uploaded structures aligned for the memcpy.
+static constexpr int uploadAlignment = 16;
+
 static D3D12_SHADING_RATE Convert( VRSBlock block )
 {
   switch ( block )
@@ -36,13 +41,17 @@ static D3D12_SHADING_RATE Convert( VRSBlock block )
 }
 
 D3DCommandList::D3DCommandList( D3DDevice& device, D3DCommandAllocator& commandAllocator, CommandQueueType queueType, uint64_t queueFrequency )
-  : device( device )
+  : uploadAllocator( device.GetUploadPagePool() )
+  , device( device )
 {
   device.GetD3DDevice()->CreateCommandList( 0, Convert( queueType ), commandAllocator.GetD3DCommandAllocator(), nullptr, IID_PPV_ARGS( &d3dGraphicsCommandList ) );
   frequency = queueFrequency;
 
   if ( queueType == CommandQueueType::Direct )
     BindHeaps();
+
+  // Copy queue timestamps need extra support, and the compute queue is not used for passes.
+  timeSections = queueType == CommandQueueType::Direct;
 }
 
 D3DCommandList::~D3DCommandList()
@@ -137,6 +146,49 @@ void D3DCommandList::ChangeResourceState( eastl::initializer_list<ResourceStateC
     d3dGraphicsCommandList->ResourceBarrier( resIx, barriers );
 }
 
+void D3DCommandList::AddBarriers( const ResourceBarrier* barriers, int count )
+{
+  eastl::vector< D3D12_RESOURCE_BARRIER > d3dBarriers;
+  d3dBarriers.reserve( count );
+
+  for ( int barrierIx = 0; barrierIx < count; ++barrierIx )
+  {
+    auto& barrier     = barriers[ barrierIx ];
+    auto  d3dResource = static_cast< D3DResource* >( barrier.resource );
+
+    D3D12_RESOURCE_BARRIER d3dBarrier = {};
+
+    if ( barrier.type == ResourceBarrier::Type::Aliasing )
+    {
+      // Any placed resource could have used the memory before, the graph doesn't track that
+      d3dBarrier.Type                    = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+      d3dBarrier.Aliasing.pResourceAfter = d3dResource->GetD3DResource();
+      d3dBarriers.push_back( d3dBarrier );
+      continue;
+    }
+
+    // The begin half doesn't change the tracked state, so the end half finds the same state here.
+    if ( d3dResource->resourceState.bits == barrier.newState.bits )
+      continue;
+
+    d3dBarrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    d3dBarrier.Flags                  = barrier.split == ResourceBarrier::Split::Begin ? D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY
+                                      : barrier.split == ResourceBarrier::Split::End   ? D3D12_RESOURCE_BARRIER_FLAG_END_ONLY
+                                      : D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    d3dBarrier.Transition.pResource   = d3dResource->GetD3DResource();
+    d3dBarrier.Transition.StateBefore = Convert( d3dResource->resourceState );
+    d3dBarrier.Transition.StateAfter  = Convert( barrier.newState );
+    d3dBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    d3dBarriers.push_back( d3dBarrier );
+
+    if ( barrier.split != ResourceBarrier::Split::Begin )
+      d3dResource->resourceState = barrier.newState;
+  }
+
+  if ( !d3dBarriers.empty() )
+    d3dGraphicsCommandList->ResourceBarrier( UINT( d3dBarriers.size() ), d3dBarriers.data() );
+}
+
 void D3DCommandList::ClearRenderTarget( Resource& texture, const Color& color )
 {
   auto d3dTexture    = static_cast< D3DResource* >( &texture );
@@ -572,52 +624,17 @@ void D3DCommandList::UploadTextureRegion( eastl::unique_ptr< Resource > source,
   HoldResource( eastl::move( source ) );
 }
 
-void D3DCommandList::UploadBufferResource( eastl::unique_ptr< Resource > source, Resource& destination, const void* data, int dataSize )
+void D3DCommandList::UploadBufferResource( Resource& destination, const void* data, int dataSize )
 {
-  auto oldState = destination.GetCurrentResourceState();
-  ChangeResourceState( destination, ResourceStateBits::CopyDestination );
-
-  auto d3dSource      = static_cast< D3DResource* >( source.get() )->GetD3DResource();
-  auto d3dDestination = static_cast< D3DResource* >( &destination )->GetD3DResource();
-
-  D3D12_SUBRESOURCE_DATA subresource;
-  subresource.pData      = data;
-  subresource.RowPitch   = dataSize;
-  subresource.SlicePitch = dataSize;
-
-  auto uploadSize = source->GetBufferSize();
-  eastl::vector< uint8_t > paddedUploadBuffer;
-  if ( dataSize < uploadSize )
-  {
-    paddedUploadBuffer.resize( uploadSize );
-    memcpy_s( paddedUploadBuffer.data(), paddedUploadBuffer.size(), data, dataSize );
-    subresource.pData      = paddedUploadBuffer.data();
-    subresource.RowPitch   = paddedUploadBuffer.size();
-    subresource.SlicePitch = paddedUploadBuffer.size();
-  }
-
-  UpdateSubresources( d3dGraphicsCommandList, d3dDestination, d3dSource, 0, 0, 1, &subresource );
-
-  ChangeResourceState( destination, oldState );
-
-  heldResources.emplace_back( eastl::move( source ) );
+  UpdateBufferRegion( destination, 0, data, dataSize );
 }
 
-void D3DCommandList::UpdateBufferRegion( eastl::unique_ptr< Resource > source, Resource& destination, int offset )
+void D3DCommandList::UpdateBufferRegion( Resource& destination, int offset, const void* data, int dataSize )
 {
-  auto d3dSource      = static_cast< D3DResource* >( source.get() )->GetD3DResource();
-  auto d3dDestination = static_cast< D3DResource* >( &destination )->GetD3DResource();
-
-  auto oldState = destination.GetCurrentResourceState();
-
-  ChangeResourceState( { { destination, ResourceStateBits::CopyDestination }
-                       , { *source,     ResourceStateBits::CopySource      } } );
-
-  d3dGraphicsCommandList->CopyBufferRegion( d3dDestination, offset, d3dSource, 0, source->GetBufferSize() );
+  auto upload = uploadAllocator.Allocate( dataSize, uploadAlignment );
+  memcpy( upload.cpuAddress, data, dataSize );
 
-  ChangeResourceState( destination, oldState );
-
-  heldResources.emplace_back( eastl::move( source ) );
+  CopyBufferRegion( *upload.resource, upload.offset, destination, offset, dataSize );
 }
 
 void D3DCommandList::CopyResource( Resource& source, Resource& destination )
@@ -634,6 +651,21 @@ void D3DCommandList::CopyResource( Resource& source, Resource& destination )
                        , { source,      oldSrcState } } );
 }
 
+void D3DCommandList::CopyBufferRegion( Resource& source, int sourceOffset, Resource& destination, int destinationOffset, int size )
+{
+  auto d3dSource      = static_cast< D3DResource* >( &source )->GetD3DResource();
+  auto d3dDestination = static_cast< D3DResource* >( &destination )->GetD3DResource();
+
+  auto oldState = destination.GetCurrentResourceState();
+
+  // Upload heap resources have to stay in the generic read state, which already allows copying from them.
+  ChangeResourceState( destination, ResourceStateBits::CopyDestination );
+
+  d3dGraphicsCommandList->CopyBufferRegion( d3dDestination, destinationOffset, d3dSource, sourceOffset, size );
+
+  ChangeResourceState( destination, oldState );
+}
+
 void D3DCommandList::ResolveMSAA( Resource& source, Resource& destination )
 {
   auto oldDstState = destination.GetCurrentResourceState();
@@ -660,12 +692,29 @@ void D3DCommandList::HoldResource( eastl::unique_ptr< RTTopLevelAccelerator > re
     heldTLAS.emplace_back( eastl::move( resource ) );
 }
 
+void D3DCommandList::HoldResource( eastl::unique_ptr< RTBottomLevelAccelerator > resource )
+{
+  if ( resource )
+    heldBLAS.emplace_back( eastl::move( resource ) );
+}
+
 void D3DCommandList::HoldResource( IUnknown* unknown )
 {
   if ( unknown )
     heldUnknowns.emplace_back( unknown );
 }
 
+void D3DCommandList::HoldResource( eastl::unique_ptr< MemoryHeap > heap )
+{
+  if ( heap )
+    heldHeaps.emplace_back( eastl::move( heap ) );
+}
+
+UploadAllocator& D3DCommandList::GetUploadAllocator()
+{
+  return uploadAllocator;
+}
+
 eastl::vector< eastl::unique_ptr< Resource > > D3DCommandList::TakeHeldResources()
 {
   return eastl::move( heldResources );
@@ -676,14 +725,23 @@ eastl::vector<eastl::unique_ptr<RTTopLevelAccelerator>> D3DCommandList::TakeHeld
   return eastl::move( heldTLAS );
 }
 
+eastl::vector< eastl::unique_ptr< RTBottomLevelAccelerator > > D3DCommandList::TakeHeldBLAS()
+{
+  return eastl::move( heldBLAS );
+}
+
 eastl::vector< CComPtr< IUnknown > > D3DCommandList::TakeHeldUnknowns()
 {
   return eastl::move( heldUnknowns );
 }
 
+eastl::vector< eastl::unique_ptr< MemoryHeap > > D3DCommandList::TakeHeldHeaps()
+{
+  return eastl::move( heldHeaps );
+}
+
 void D3DCommandList::BeginEvent( const wchar_t* format, ... )
 {
-#if USE_PIX
   wchar_t msg[ 512 ];
 
   va_list args;
@@ -691,8 +749,12 @@ void D3DCommandList::BeginEvent( const wchar_t* format, ... )
   vswprintf_s( msg, format, args );
   va_end( args );
 
+#if USE_PIX
   PIXBeginEvent( (ID3D12GraphicsCommandList6*)d3dGraphicsCommandList, PIX_COLOR_DEFAULT, msg );
 #endif // USE_PIX
+
+  if ( timeSections )
+    openSections.push_back( device.GetGPUProfiler().BeginSection( *this, msg ) );
 }
 
 void D3DCommandList::EndEvent()
@@ -700,6 +762,36 @@ void D3DCommandList::EndEvent()
 #if USE_PIX
   PIXEndEvent( (ID3D12GraphicsCommandList6*)d3dGraphicsCommandList );
 #endif // USE_PIX
+
+  if ( timeSections && !openSections.empty() )
+  {
+    device.GetGPUProfiler().EndSection( *this, openSections.back() );
+    openSections.pop_back();
+  }
+}
+
+int D3DCommandList::SuspendEvent()
+{
+#if USE_PIX
+  PIXEndEvent( (ID3D12GraphicsCommandList6*)d3dGraphicsCommandList );
+#endif // USE_PIX
+
+  if ( !timeSections || openSections.empty() )
+    return -1;
+
+  int sectionId = openSections.back();
+  openSections.pop_back();
+  return sectionId;
+}
+
+void D3DCommandList::ContinueEvent( const wchar_t* name, int sectionId )
+{
+#if USE_PIX
+  PIXBeginEvent( (ID3D12GraphicsCommandList6*)d3dGraphicsCommandList, PIX_COLOR_DEFAULT, name );
+#endif // USE_PIX
+
+  if ( timeSections )
+    openSections.push_back( sectionId );
 }
 
 void D3DCommandList::RegisterEndFrameCallback( EndFrameCallback&& callback )
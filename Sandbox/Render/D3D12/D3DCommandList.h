@@ -2,6 +2,8 @@
 
 #include "../CommandList.h"
 #include "../Types.h"
+#include "../UploadAllocator.h"
+#include "../MemoryHeap.h"
 
 class D3DCommandAllocator;
 struct AllocatedResource;
@@ -19,6 +21,7 @@ public:
 
   void ChangeResourceState( Resource& resource, ResourceState newState ) override;
   void ChangeResourceState( eastl::initializer_list< ResourceStateChange > resources ) override;
+  void AddBarriers( const ResourceBarrier* barriers, int count ) override;
 
   void ClearRenderTarget( Resource& texture, const Color& color ) override;
   void ClearDepthStencil( Resource& texture, float depth ) override;
@@ -72,28 +75,37 @@ public:
 
   void UploadTextureResource( eastl::unique_ptr< Resource > source, Resource& destination, const void* data, int stride, int rows ) override;
   void UploadTextureRegion( eastl::unique_ptr< Resource > source, Resource& destination, int mip, int left, int top, int width, int height ) override;
-  void UploadBufferResource( eastl::unique_ptr< Resource > source, Resource& destination, const void* data, int dataSize ) override;
+  void UploadBufferResource( Resource& destination, const void* data, int dataSize ) override;
 
-  void UpdateBufferRegion( eastl::unique_ptr< Resource > source, Resource& destination, int offset ) override;
+  void UpdateBufferRegion( Resource& destination, int offset, const void* data, int dataSize ) override;
 
   void CopyResource( Resource& source, Resource& destination ) override;
+  void CopyBufferRegion( Resource& source, int sourceOffset, Resource& destination, int destinationOffset, int size ) override;
 
   void ResolveMSAA( Resource& source, Resource& destination ) override;
 
   void HoldResource( eastl::unique_ptr< Resource > resource ) override;
   void HoldResource( eastl::unique_ptr< RTTopLevelAccelerator > resource ) override;
+  void HoldResource( eastl::unique_ptr< RTBottomLevelAccelerator > resource ) override;
   void HoldResource( IUnknown* unknown ) override;
+  void HoldResource( eastl::unique_ptr< MemoryHeap > heap ) override;
 
   eastl::vector< eastl::unique_ptr< Resource > > TakeHeldResources() override;
   eastl::vector< eastl::unique_ptr< RTTopLevelAccelerator > > TakeHeldTLAS() override;
+  eastl::vector< eastl::unique_ptr< RTBottomLevelAccelerator > > TakeHeldBLAS() override;
   eastl::vector< CComPtr< IUnknown > > TakeHeldUnknowns() override;
+  eastl::vector< eastl::unique_ptr< MemoryHeap > > TakeHeldHeaps() override;
 
   void BeginEvent( const wchar_t* format, ... ) override;
   void EndEvent() override;
+  int  SuspendEvent() override;
+  void ContinueEvent( const wchar_t* name, int sectionId ) override;
 
   void RegisterEndFrameCallback( EndFrameCallback&& callback ) override;
   eastl::vector< EndFrameCallback > TakeEndFrameCallbacks() override;
 
+  UploadAllocator& GetUploadAllocator() override;
+
   void HoldResource( D3D12MA::Allocation* allocation );
   void HoldResource( AllocatedResource&& allocation );
 
@@ -106,13 +118,21 @@ private:
 
   CComPtr< ID3D12GraphicsCommandList6 > d3dGraphicsCommandList;
 
+  // Declared first, so the list destroys the held heaps after the resources placed in them.
+  eastl::vector< eastl::unique_ptr< MemoryHeap > > heldHeaps;
   eastl::vector< eastl::unique_ptr< Resource > > heldResources;
   eastl::vector< eastl::unique_ptr< RTTopLevelAccelerator > > heldTLAS;
+  eastl::vector< eastl::unique_ptr< RTBottomLevelAccelerator > > heldBLAS;
   eastl::vector< CComPtr< IUnknown > > heldUnknowns;
   eastl::vector< EndFrameCallback > endFrameCallbacks;
 
+  UploadAllocator uploadAllocator;
+
   uint64_t frequency = 1;
 
+  bool                 timeSections = false;
+  eastl::vector< int > openSections;
+
   D3D12_DISPATCH_RAYS_DESC rayDesc;
 
   D3DDevice& device;
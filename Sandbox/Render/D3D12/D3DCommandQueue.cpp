@@ -127,6 +127,7 @@ uint64_t D3DCommandQueue::GetNextFenceValue()
 
 uint64_t D3DCommandQueue::GetLastCompletedFenceValue()
 {
+  lastCompletedFenceValue = eastl::max( lastCompletedFenceValue, d3dFence->GetCompletedValue() );
   return lastCompletedFenceValue;
 }
 
@@ -134,7 +135,7 @@ uint64_t D3DCommandQueue::Submit( eastl::vector< eastl::unique_ptr< CommandList
 {
   eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
 
-  ID3D12CommandList* d3dCommandLists[ 8 ] = {};
+  ID3D12CommandList* d3dCommandLists[ 16 ] = {};
 
   assert( _countof( d3dCommandLists ) >= commandLists.size() );
 
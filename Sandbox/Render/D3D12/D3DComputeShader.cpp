@@ -1,18 +1,28 @@
 #include "D3DComputeShader.h"
 #include "D3DDevice.h"
+#include "../PipelineKey.h"
 
 D3DComputeShader::D3DComputeShader( D3DDevice& device, const void* shaderData, int shaderSize, const wchar_t* debugName )
+  : shaderData( shaderData )
+  , shaderSize( shaderSize )
+  , debugName( debugName ? debugName : L"" )
 {
-  auto hr = device.GetD3DDevice()->CreateRootSignature( 0, shaderData, shaderSize, IID_PPV_ARGS( &d3dRootSignature ) );
-  assert( SUCCEEDED( hr ) );
+  d3dRootSignature = device.GetPipelineCache().GetRootSignature( shaderData, shaderSize );
 
-  D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
-  desc.pRootSignature     = d3dRootSignature;
-  desc.CS.pShaderBytecode = shaderData;
-  desc.CS.BytecodeLength  = SIZE_T( shaderSize );
-  device.GetD3DDevice()->CreateComputePipelineState( &desc, IID_PPV_ARGS( &d3dPipelineState ) );
-  if ( debugName )
-    d3dPipelineState->SetName( debugName );
+  auto key = HashBytes( shaderData, shaderSize );
+  d3dPipelineState.Start( [ this, &device, key ]()
+  {
+    D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
+    desc.pRootSignature     = d3dRootSignature;
+    desc.CS.pShaderBytecode = this->shaderData;
+    desc.CS.BytecodeLength  = SIZE_T( this->shaderSize );
+
+    auto pipelineState = device.GetPipelineCache().GetComputePipeline( key, desc );
+    if ( pipelineState && !this->debugName.empty() )
+      pipelineState->SetName( this->debugName.data() );
+
+    return pipelineState;
+  } );
 }
 
 ID3D12RootSignature* D3DComputeShader::GetD3DRootSignature()
@@ -22,5 +32,5 @@ ID3D12RootSignature* D3DComputeShader::GetD3DRootSignature()
 
 ID3D12PipelineState* D3DComputeShader::GetD3DPipelineState()
 {
-  return d3dPipelineState;
+  return d3dPipelineState.Get();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../ComputeShader.h"
+#include "D3DPipelineCache.h"
 
 class D3DComputeShader : public ComputeShader
 {
@@ -8,11 +9,19 @@ class D3DComputeShader : public ComputeShader
 
 public:
   ID3D12RootSignature* GetD3DRootSignature();
+
+  // Waits for the pipeline, if it is still being compiled.
   ID3D12PipelineState* GetD3DPipelineState();
 
 private:
   D3DComputeShader( D3DDevice& device, const void* shaderData, int shaderSize, const wchar_t* debugName );
 
+  // Points into the shader package, which outlives the build.
+  const void*    shaderData;
+  int            shaderSize;
+  eastl::wstring debugName;
+
   CComPtr< ID3D12RootSignature > d3dRootSignature;
-  CComPtr< ID3D12PipelineState > d3dPipelineState;
+
+  D3DAsyncPipeline d3dPipelineState;
 };
\ No newline at end of file
@@ -5,9 +5,23 @@
 
 D3DDescriptorHeap::D3DDescriptorHeap( D3DDevice& device, int descriptorCount, D3D12_DESCRIPTOR_HEAP_TYPE heapType, const wchar_t* debugName )
   : heapType( heapType )
+  , pageSize( descriptorCount )
+  , debugName( debugName ? debugName : L"" )
 {
-  for ( int index = 0; index < descriptorCount; ++index )
-    freeDescriptors.emplace( index );
+  if ( heapType == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV )
+  {
+    regions.emplace_back( Engine2DResourceBaseSlot,     Engine2DResourceCount );
+    regions.emplace_back( EngineCubeResourceBaseSlot,   EngineCubeResourceCount );
+    regions.emplace_back( EngineVolResourceBaseSlot,    EngineVolResourceCount );
+    regions.emplace_back( EngineBufferResourceBaseSlot, EngineBufferResourceCount );
+    regions.emplace_back( Scene2DResourceBaseSlot,      Scene2DResourceCount );
+    regions.emplace_back( Scene2DFeedbackBaseSlot,      Scene2DResourceCount );
+    regions.emplace_back( SceneBufferResourceBaseSlot,  SceneBufferResourceCount );
+    regions.emplace_back( Engine2DTileTexturesBaseSlot, Engine2DTileTexturesCount );
+    assert( descriptorCount == AllResourceCount );
+  }
+  else
+    regions.emplace_back( 0, descriptorCount );
 
   D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
   heapDesc.NumDescriptors = descriptorCount;
@@ -209,18 +223,26 @@ eastl::unique_ptr<ResourceDescriptor> D3DDescriptorHeap::RequestDescriptorAuto(
 eastl::unique_ptr< ResourceDescriptor > D3DDescriptorHeap::RequestDescriptor( Device& device, ResourceDescriptorType type, int base, int slot, Resource& resource, int bufferElementSize, int mipLevel )
 {
   eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
-  
-  assert( !freeDescriptors.empty() );
-
-  if ( slot < 0 )
-    slot = *freeDescriptors.lower_bound( base );
-
-  assert( !freeDescriptors.empty() );
 
   D3D12_CPU_DESCRIPTOR_HANDLE d3dCPUHandle = {};
   D3D12_CPU_DESCRIPTOR_HANDLE d3dShaderVisibleCPUHandle = {};
   D3D12_GPU_DESCRIPTOR_HANDLE d3dShaderVisibleGPUHandle = {};
-  RequestDescriptor( slot, d3dCPUHandle, d3dShaderVisibleCPUHandle, d3dShaderVisibleGPUHandle );
+
+  if ( slot < 0 )
+  {
+    auto region = FindRegion( base );
+    assert( region );
+    slot = region ? region->Allocate() : -1;
+    if ( slot < 0 && region && AddCPUPage( *static_cast< D3DDevice* >( &device ) ) )
+      slot = region->Allocate();
+    assert( slot >= 0 );
+    if ( slot < 0 )
+      return nullptr;
+
+    GetHandles( slot, d3dCPUHandle, d3dShaderVisibleCPUHandle, d3dShaderVisibleGPUHandle );
+  }
+  else
+    RequestDescriptor( slot, d3dCPUHandle, d3dShaderVisibleCPUHandle, d3dShaderVisibleGPUHandle );
 
   return eastl::unique_ptr< ResourceDescriptor >( new D3DResourceDescriptor( *static_cast< D3DDevice* >( &device )
                                                                            , *this
@@ -234,6 +256,42 @@ eastl::unique_ptr< ResourceDescriptor > D3DDescriptorHeap::RequestDescriptor( De
                                                                            , d3dShaderVisibleGPUHandle ) );
 }
 
+eastl::vector< eastl::unique_ptr< ResourceDescriptor > > D3DDescriptorHeap::RequestDescriptorRangeAuto( Device& device, ResourceDescriptorType type, int base, eastl::initializer_list< eastl::reference_wrapper< Resource > > resources, int bufferElementSize )
+{
+  eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
+
+  eastl::vector< eastl::unique_ptr< ResourceDescriptor > > descriptors;
+
+  auto region = FindRegion( base );
+  assert( region );
+  int slot = region ? region->Allocate( int( resources.size() ) ) : -1;
+  assert( slot >= 0 );
+  if ( slot < 0 )
+    return descriptors;
+
+  for ( auto& resource : resources )
+  {
+    D3D12_CPU_DESCRIPTOR_HANDLE d3dCPUHandle = {};
+    D3D12_CPU_DESCRIPTOR_HANDLE d3dShaderVisibleCPUHandle = {};
+    D3D12_GPU_DESCRIPTOR_HANDLE d3dShaderVisibleGPUHandle = {};
+
+    GetHandles( slot, d3dCPUHandle, d3dShaderVisibleCPUHandle, d3dShaderVisibleGPUHandle );
+
+    descriptors.emplace_back( new D3DResourceDescriptor( *static_cast< D3DDevice* >( &device )
+                                                       , *this
+                                                       , type
+                                                       , slot++
+                                                       , *static_cast< D3DResource* >( &resource.get() )
+                                                       , 0
+                                                       , bufferElementSize
+                                                       , d3dCPUHandle
+                                                       , d3dShaderVisibleCPUHandle
+                                                       , d3dShaderVisibleGPUHandle ) );
+  }
+
+  return descriptors;
+}
+
 int D3DDescriptorHeap::GetDescriptorSize() const
 {
   return int( handleSize );
@@ -243,26 +301,71 @@ void D3DDescriptorHeap::FreeDescriptor( int index )
 {
   eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
 
-  freeDescriptors.emplace( index );
+  auto region = FindRegion( index );
+  assert( region );
+  if ( region )
+    region->Free( index );
 }
 
 void D3DDescriptorHeap::RequestDescriptor( int slot, D3D12_CPU_DESCRIPTOR_HANDLE& d3dCPUHandle, D3D12_CPU_DESCRIPTOR_HANDLE& d3dShaderVisibleCPUHandle, D3D12_GPU_DESCRIPTOR_HANDLE& d3dShaderVisibleGPUHandle )
 {
   eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
-  
-  assert( !freeDescriptors.empty() );
+
   assert( slot >= 0 );
 
-  bool isFree = freeDescriptors.count( slot ) == 1;
+  auto region = FindRegion( slot );
+  bool isFree = region && region->AllocateAt( slot );
   assert( isFree );
   if ( !isFree )
     return;
 
-  freeDescriptors.erase( slot );
-  assert( !freeDescriptors.empty() );
+  GetHandles( slot, d3dCPUHandle, d3dShaderVisibleCPUHandle, d3dShaderVisibleGPUHandle );
+}
+
+DescriptorAllocator* D3DDescriptorHeap::FindRegion( int slot )
+{
+  for ( auto& region : regions )
+    if ( region.Contains( slot ) )
+      return &region;
+
+  return nullptr;
+}
+
+bool D3DDescriptorHeap::AddCPUPage( D3DDevice& device )
+{
+  // The shader visible heaps are bound as a whole and their regions are baked into the root signatures.
+  if ( d3dGPUVisibleHeap || regions.size() != 1 )
+    return false;
+
+  D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+  heapDesc.NumDescriptors = pageSize;
+  heapDesc.Flags          = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+  heapDesc.Type           = heapType;
+
+  CComPtr< ID3D12DescriptorHeap > d3dPage;
+  if ( FAILED( device.GetD3DDevice()->CreateDescriptorHeap( &heapDesc, IID_PPV_ARGS( &d3dPage ) ) ) )
+    return false;
+
+  if ( !debugName.empty() )
+  {
+    auto debugNameCpu = debugName + L"_CPU";
+    d3dPage->SetName( debugNameCpu.data() );
+  }
+
+  d3dExtraCPUPages.emplace_back( d3dPage );
+  regions.front().Grow( regions.front().GetCapacity() + pageSize );
+  return true;
+}
+
+void D3DDescriptorHeap::GetHandles( int slot, D3D12_CPU_DESCRIPTOR_HANDLE& d3dCPUHandle, D3D12_CPU_DESCRIPTOR_HANDLE& d3dShaderVisibleCPUHandle, D3D12_GPU_DESCRIPTOR_HANDLE& d3dShaderVisibleGPUHandle )
+{
+  int page = slot / pageSize;
+  assert( page <= int( d3dExtraCPUPages.size() ) );
+
+  ID3D12DescriptorHeap* d3dCPUPage = page > 0 ? d3dExtraCPUPages[ page - 1 ].p : d3dCPUVisibleHeap.p;
 
-  d3dCPUHandle = d3dCPUVisibleHeap->GetCPUDescriptorHandleForHeapStart();
-  d3dCPUHandle.ptr += slot * handleSize;
+  d3dCPUHandle      = d3dCPUPage->GetCPUDescriptorHandleForHeapStart();
+  d3dCPUHandle.ptr += ( slot % pageSize ) * handleSize;
 
   if ( d3dGPUVisibleHeap )
   {
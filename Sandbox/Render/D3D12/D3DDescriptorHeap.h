@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../DescriptorHeap.h"
+#include "../DescriptorAllocator.h"
 
 class D3DDescriptorHeap : public DescriptorHeap
 {
@@ -11,6 +12,7 @@ public:
 
   eastl::unique_ptr< ResourceDescriptor > RequestDescriptorFromSlot( Device& device, ResourceDescriptorType type, int slot, Resource& resource, int bufferElementSize, int mipLevel = 0 ) override;
   eastl::unique_ptr< ResourceDescriptor > RequestDescriptorAuto( Device& device, ResourceDescriptorType type, int base, Resource& resource, int bufferElementSize, int mipLevel = 0 ) override;
+  eastl::vector< eastl::unique_ptr< ResourceDescriptor > > RequestDescriptorRangeAuto( Device& device, ResourceDescriptorType type, int base, eastl::initializer_list< eastl::reference_wrapper< Resource > > resources, int bufferElementSize ) override;
 
   int GetDescriptorSize() const override;
 
@@ -28,17 +30,30 @@ private:
 
   eastl::unique_ptr< ResourceDescriptor > RequestDescriptor( Device& device, ResourceDescriptorType type, int base, int slot, Resource& resource, int bufferElementSize, int mipLevel );
 
+  DescriptorAllocator* FindRegion( int slot );
+  bool AddCPUPage( D3DDevice& device );
+  void GetHandles( int slot, D3D12_CPU_DESCRIPTOR_HANDLE& d3dCPUHandle, D3D12_CPU_DESCRIPTOR_HANDLE& d3dShaderVisibleCPUHandle, D3D12_GPU_DESCRIPTOR_HANDLE& d3dShaderVisibleGPUHandle );
+
   CComPtr< ID3D12DescriptorHeap > d3dCPUVisibleHeap;
   CComPtr< ID3D12DescriptorHeap > d3dGPUVisibleHeap;
 
+  // Heaps which are not shader visible grow by pages of the initial size when they run out.
+  // The earlier pages stay where they are, so the handles already given out remain valid.
+  eastl::vector< CComPtr< ID3D12DescriptorHeap > > d3dExtraCPUPages;
+
   CComPtr< ID3D12Resource > d3dDummySRVBuffer;
   CComPtr< ID3D12Resource > d3dDummySRVTexture;
   CComPtr< ID3D12Resource > d3dDummyUAVTexture;
 
   eastl::recursive_mutex descriptorLock;
-  eastl::vector_set< int > freeDescriptors;
+
+  // The shader visible layout of ShaderValues.h, or the whole heap as one region.
+  eastl::vector< DescriptorAllocator > regions;
 
   size_t handleSize = 0;
+  int    pageSize   = 0;
+
+  eastl::wstring debugName;
 
   D3D12_DESCRIPTOR_HEAP_TYPE heapType;
 };
\ No newline at end of file
@@ -13,14 +13,17 @@
 #include "D3DMemoryHeap.h"
 #include "D3DComputeShader.h"
 #include "D3DGPUTimeQuery.h"
+#include "D3DGPUProfiler.h"
+#include "D3DPipelineCache.h"
 #include "D3DRTShaders.h"
 #include "D3DUtils.h"
 #include "Conversion.h"
 #include "DirectXTex/DDSTextureLoader/DDSTextureLoader12.h"
-#include "Common/Files.h"
+#include "../ShaderPackage.h"
 #include "../FileLoader.h"
 #include "../ShaderValues.h"
 #include "../ShaderStructures.h"
+#include "../UploadAllocator.h"
 #include "../DearImGui/imgui_impl_dx12.h"
 #include "../D3D12MemoryAllocator/D3D12MemAlloc.h"
 #include "WinPixEventRuntime/pix3.h"
@@ -172,13 +175,21 @@ D3DDevice::D3DDevice( D3DAdapter& adapter )
 
   SetContainerObject( d3dDevice, this );
 
-  auto shaderData = ReadFileToMemory( L"Content/Shaders/Downsample.cso" );
-  mipmapGenComputeShader.reset( new D3DComputeShader( *this, shaderData.data(), int( shaderData.size() ), L"MipMapGen" ) );
+  DXGI_ADAPTER_DESC1 adapterDesc;
+  adapter.GetDXGIAdapter()->GetDesc1( &adapterDesc );
+  pipelineCache.reset( new D3DPipelineCache( d3dDevice, adapterDesc, L"PipelineCache.bin" ) );
+
+  auto shaderData = ShaderPackage::GetInstance().GetShader( L"Downsample" );
+  mipmapGenComputeShader.reset( new D3DComputeShader( *this, shaderData.data, shaderData.size, L"MipMapGen" ) );
 
   UpdateSamplers();
 
   for ( auto pixelFormat : { PixelFormat::BC1UN, PixelFormat::BC2UN, PixelFormat::BC3UN, PixelFormat::BC4UN, PixelFormat::BC5UN } )
     tileHeaps[ pixelFormat ].reset( new D3DTileHeap( *this, pixelFormat, L"D3DTileHeap" ) );
+
+  uploadPagePool.reset( new UploadPagePool( [ this ]( int size ) { return AllocateUploadBuffer( size, L"UploadPage" ); } ) );
+
+  gpuProfiler.reset( new D3DGPUProfiler( *this ) );
 }
 
 void D3DDevice::UpdateSamplers()
@@ -241,6 +252,8 @@ CComPtr< ID3D12Resource > D3DDevice::CreateTileUploadBuffer( ID3D12Resource* tar
 
 D3DDevice::~D3DDevice()
 {
+  gpuProfiler.reset();
+  uploadPagePool.reset();
   tileHeaps.clear();
 
   if ( enableImGui )
@@ -254,6 +267,11 @@ D3DDevice::~D3DDevice()
   d3dmipmapGenHeap.Release();
   mipmapGenComputeShader.reset();
 
+  // Pipelines still alive are in the library already, they don't need to be gone.
+  if ( pipelineCache )
+    pipelineCache->Save();
+  pipelineCache.reset();
+
   allocator->Release();
   globalGPUAllocator = allocator;
 }
@@ -414,6 +432,55 @@ eastl::unique_ptr< Resource > D3DDevice::CreateReserved2DTexture( int width, int
   return CreateTexture( nullptr, width, height, 1, 1, format, 1, 0, false, slot, eastl::nullopt, mipLevels, debugName, true );
 }
 
+static D3D12_RESOURCE_DESC GetPlaced2DTextureDesc( int width, int height, PixelFormat format )
+{
+  D3D12_RESOURCE_DESC desc = {};
+  desc.Dimension          = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+  desc.Alignment          = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+  desc.Width              = width;
+  desc.Height             = height;
+  desc.DepthOrArraySize   = 1;
+  desc.MipLevels          = 1;
+  desc.Format             = Convert( format );
+  desc.SampleDesc.Count   = 1;
+  desc.SampleDesc.Quality = 0;
+  desc.Layout             = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+  desc.Flags              = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+  return desc;
+}
+
+eastl::unique_ptr< Resource > D3DDevice::CreatePlaced2DTexture( MemoryHeap& heap, uint64_t offset, int width, int height, PixelFormat format, int slot, int uavSlot, const wchar_t* debugName )
+{
+  assert( offset % D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT == 0 );
+
+  // Placed textures share their heap with others, so they are UAV only, which the heap flags allow.
+  ResourceState initialState = ResourceStateBits::UnorderedAccess;
+
+  auto desc = GetPlaced2DTextureDesc( width, height, format );
+
+  CComPtr< ID3D12Resource > d3dResource;
+  auto hr = d3dDevice->CreatePlacedResource( static_cast< D3DMemoryHeap& >( heap ).GetD3DHeap(), offset, &desc, Convert( initialState ), nullptr, IID_PPV_ARGS( &d3dResource ) );
+  assert( SUCCEEDED( hr ) );
+
+  AllocatedResource allocatedResource( d3dResource );
+  allocatedResource->SetName( debugName );
+
+  eastl::unique_ptr< D3DResource > resource( new D3DResource( eastl::move( allocatedResource ), initialState ) );
+
+  auto& descriptorHeap = descriptorHeaps[ D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV ];
+
+  if ( slot > 0 )
+  {
+    auto descriptor = descriptorHeap->RequestDescriptorFromSlot( *this, ResourceDescriptorType::ShaderResourceView, slot, *resource, 0 );
+    resource->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( descriptor ) );
+  }
+
+  auto descriptor = descriptorHeap->RequestDescriptorFromSlot( *this, ResourceDescriptorType::UnorderedAccessView, uavSlot, *resource, 0 );
+  resource->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( descriptor ) );
+
+  return resource;
+}
+
 eastl::unique_ptr<ComputeShader> D3DDevice::CreateComputeShader( const void* shaderData, int shaderSize, const wchar_t* debugName )
 {
   return eastl::unique_ptr< ComputeShader >( new D3DComputeShader( *this, shaderData, shaderSize, debugName ) );
@@ -438,17 +505,17 @@ void D3DDevice::PreallocateTiles( CommandQueue& directQueue )
   tileHeaps[ PixelFormat::BC5UN ]->prealloc( *this, directQueue, 256 );
 }
 
-eastl::unique_ptr<RTShaders> D3DDevice::CreateRTShaders( CommandList& commandList, const eastl::vector<uint8_t>& rootSignatureShaderBinary, const eastl::vector<uint8_t>& shaderBinary, const wchar_t* rayGenEntryName, const wchar_t* missEntryName, const wchar_t* anyHitEntryName, const wchar_t* closestHitEntryName, int attributeSize, int payloadSize, int maxRecursionDepth )
+eastl::unique_ptr<RTShaders> D3DDevice::CreateRTShaders( CommandList& commandList, const ShaderBinary& rootSignatureShaderBinary, const ShaderBinary& shaderBinary, const wchar_t* rayGenEntryName, const wchar_t* missEntryName, const wchar_t* anyHitEntryName, const wchar_t* closestHitEntryName, int attributeSize, int payloadSize, int maxRecursionDepth )
 {
   return eastl::unique_ptr< RTShaders >( new D3DRTShaders( *this, commandList, rootSignatureShaderBinary, shaderBinary, rayGenEntryName, missEntryName, anyHitEntryName, closestHitEntryName, attributeSize, payloadSize, maxRecursionDepth ) );
 }
 
-eastl::unique_ptr<Resource> D3DDevice::Load2DTexture( CommandList& commandList, eastl::vector< uint8_t >&& textureData, int slot, const wchar_t* debugName )
+eastl::unique_ptr<Resource> D3DDevice::Load2DTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName )
 {
   CComPtr< ID3D12Resource > resourceLoader;
   std::vector< D3D12_SUBRESOURCE_DATA > d3dSubresources;
   bool isCubeMap;
-  if FAILED( LoadDDSTextureFromMemory( d3dDevice, textureData.data(), textureData.size(), &resourceLoader, d3dSubresources, 0, nullptr, &isCubeMap ) )
+  if FAILED( LoadDDSTextureFromMemory( d3dDevice, static_cast< const uint8_t* >( textureData ), textureSize, &resourceLoader, d3dSubresources, 0, nullptr, &isCubeMap ) )
     return nullptr;
 
   AllocatedResource allocatedResource = AllocatedResource( GetAllocationFromD3DResource( resourceLoader ) );
@@ -476,12 +543,12 @@ eastl::unique_ptr<Resource> D3DDevice::Load2DTexture( CommandList& commandList,
   return resource;
 }
 
-eastl::unique_ptr< Resource > D3DDevice::LoadCubeTexture( CommandList& commandList, eastl::vector< uint8_t >&& textureData, int slot, const wchar_t* debugName )
+eastl::unique_ptr< Resource > D3DDevice::LoadCubeTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName )
 {
   CComPtr< ID3D12Resource > resourceLoader;
   std::vector< D3D12_SUBRESOURCE_DATA > d3dSubresources;
   bool isCubeMap;
-  if FAILED( LoadDDSTextureFromMemory( d3dDevice, textureData.data(), textureData.size(), &resourceLoader, d3dSubresources, 0, nullptr, &isCubeMap ) )
+  if FAILED( LoadDDSTextureFromMemory( d3dDevice, static_cast< const uint8_t* >( textureData ), textureSize, &resourceLoader, d3dSubresources, 0, nullptr, &isCubeMap ) )
     return nullptr;
 
   AllocatedResource allocatedResource = AllocatedResource( GetAllocationFromD3DResource( resourceLoader ) );
@@ -588,6 +655,31 @@ eastl::unique_ptr< Resource > D3DDevice::AllocateUploadBuffer( int dataSize, con
   return eastl::unique_ptr< Resource >( new D3DResource( ::AllocateUploadBuffer( *this, dataSize, resourceName ), ResourceStateBits::GenericRead ) );
 }
 
+UploadPagePool& D3DDevice::GetUploadPagePool()
+{
+  return *uploadPagePool;
+}
+
+GPUPassStatistics& D3DDevice::GetGPUPassStatistics()
+{
+  return gpuProfiler->GetStatistics();
+}
+
+void D3DDevice::ResolveGPUTimestamps( CommandList& commandList )
+{
+  gpuProfiler->ResolveFrame( *static_cast< D3DCommandList* >( &commandList ) );
+}
+
+D3DGPUProfiler& D3DDevice::GetGPUProfiler()
+{
+  return *gpuProfiler;
+}
+
+D3DPipelineCache& D3DDevice::GetPipelineCache()
+{
+  return *pipelineCache;
+}
+
 DescriptorHeap& D3DDevice::GetShaderResourceHeap()
 {
   return *descriptorHeaps[ D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV ];
@@ -611,6 +703,12 @@ int D3DDevice::GetUploadSizeForResource( Resource& resource )
   return int( totalBytes );
 }
 
+uint64_t D3DDevice::GetPlaced2DTextureSize( int width, int height, PixelFormat format )
+{
+  auto desc = GetPlaced2DTextureDesc( width, height, format );
+  return d3dDevice->GetResourceAllocationInfo( 0, 1, &desc ).SizeInBytes;
+}
+
 void D3DDevice::SetTextureLODBias( float bias )
 {
   textureLODBias = bias;
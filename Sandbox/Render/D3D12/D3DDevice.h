@@ -11,6 +11,8 @@ class D3DCommandQueue;
 class D3DComputeShader;
 class D3DResource;
 class D3DMemoryHeap;
+class D3DGPUProfiler;
+class D3DPipelineCache;
 
 namespace D3D12MA { class Allocator; }
 
@@ -38,6 +40,7 @@ public:
   eastl::unique_ptr< Resource >                 Create2DTexture( CommandList* commandList, int width, int height, const void* data, int dataSize, PixelFormat format, int samples, int sampleQuality, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName ) override;
   eastl::unique_ptr< Resource >                 CreateCubeTexture( CommandList* commandList, int width, const void* data, int dataSize, PixelFormat format, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName ) override;
   eastl::unique_ptr< Resource >                 CreateReserved2DTexture( int width, int height, PixelFormat format, int slot, bool mipLevels, const wchar_t* debugName ) override;
+  eastl::unique_ptr< Resource >                 CreatePlaced2DTexture( MemoryHeap& heap, uint64_t offset, int width, int height, PixelFormat format, int slot, int uavSlot, const wchar_t* debugName ) override;
   eastl::unique_ptr< ComputeShader >            CreateComputeShader( const void* shaderData, int shaderSize, const wchar_t* debugName ) override;
   eastl::unique_ptr< MemoryHeap >               CreateMemoryHeap( uint64_t size, const wchar_t* debugName ) override;
   eastl::unique_ptr< GPUTimeQuery >             CreateGPUTimeQuery() override;
@@ -45,8 +48,8 @@ public:
   void PreallocateTiles( CommandQueue& directQueue ) override;
 
   eastl::unique_ptr< RTShaders > CreateRTShaders( CommandList& commandList
-                                              , const eastl::vector< uint8_t >& rootSignatureShaderBinary
-                                              , const eastl::vector< uint8_t >& shaderBinary
+                                              , const ShaderBinary& rootSignatureShaderBinary
+                                              , const ShaderBinary& shaderBinary
                                               , const wchar_t* rayGenEntryName
                                               , const wchar_t* missEntryName
                                               , const wchar_t* anyHitEntryName
@@ -55,8 +58,8 @@ public:
                                               , int payloadSize
                                               , int maxRecursionDepth ) override;
 
-  eastl::unique_ptr< Resource > Load2DTexture( CommandList& commandList, eastl::vector< uint8_t >&& textureData, int slot, const wchar_t* debugName ) override;
-  eastl::unique_ptr< Resource > LoadCubeTexture( CommandList& commandList, eastl::vector< uint8_t >&& textureData, int slot, const wchar_t* debugName ) override;
+  eastl::unique_ptr< Resource > Load2DTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName ) override;
+  eastl::unique_ptr< Resource > LoadCubeTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName ) override;
 
   eastl::unique_ptr< Resource > Stream2DTexture( CommandQueue& directQueue
                                                , CommandList& commandList
@@ -67,6 +70,11 @@ public:
 
   eastl::unique_ptr< Resource > AllocateUploadBuffer( int dataSize, const wchar_t* resourceName = nullptr ) override;
 
+  UploadPagePool& GetUploadPagePool() override;
+
+  GPUPassStatistics& GetGPUPassStatistics() override;
+  void ResolveGPUTimestamps( CommandList& commandList ) override;
+
   AllocatedResource AllocateResource( HeapType heapType, const D3D12_RESOURCE_DESC& desc, ResourceState resourceState, const D3D12_CLEAR_VALUE* optimizedClearValue = nullptr, bool committed = false );
 
   DescriptorHeap& GetShaderResourceHeap() override;
@@ -74,6 +82,8 @@ public:
 
   int GetUploadSizeForResource( Resource& resource ) override;
 
+  uint64_t GetPlaced2DTextureSize( int width, int height, PixelFormat format ) override;
+
   void SetTextureLODBias( float bias ) override;
 
   void StartNewFrame() override;
@@ -93,6 +103,10 @@ public:
 
   ID3D12DescriptorHeap* GetD3DDearImGuiHeap();
 
+  D3DGPUProfiler& GetGPUProfiler();
+
+  D3DPipelineCache& GetPipelineCache();
+
   ID3D12RootSignature*  GetMipMapGenD3DRootSignature();
   ID3D12PipelineState*  GetMipMapGenD3DPipelineState();
   ID3D12DescriptorHeap* GetMipMapGenD3DDescriptorHeap();
@@ -118,6 +132,8 @@ private:
 
   CComPtr< ID3D12DescriptorHeap > d3dDearImGuiHeap;
 
+  eastl::unique_ptr< D3DPipelineCache > pipelineCache;
+
   eastl::unique_ptr< D3DComputeShader > mipmapGenComputeShader;
   CComPtr< ID3D12DescriptorHeap >       d3dmipmapGenHeap;
   int                                   mipmapGenDescCounter = 0;
@@ -129,4 +145,8 @@ private:
   D3D12MA::Allocator* allocator = nullptr;
 
   eastl::vector_map< PixelFormat, eastl::unique_ptr< TileHeap > > tileHeaps;
+
+  eastl::unique_ptr< UploadPagePool > uploadPagePool;
+
+  eastl::unique_ptr< D3DGPUProfiler > gpuProfiler;
 };
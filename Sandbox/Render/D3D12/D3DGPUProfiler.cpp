@@ -0,0 +1,122 @@
+#include "D3DGPUProfiler.h"
+#include "D3DDevice.h"
+#include "D3DCommandList.h"
+#include "D3DResource.h"
+#include "../GPUPassStatistics.h"
+
+D3DGPUProfiler::D3DGPUProfiler( D3DDevice& device )
+  : statistics( new GPUPassStatistics )
+{
+  D3D12_QUERY_HEAP_DESC desc = {};
+  desc.Type     = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+  desc.Count    = FramesInFlight * MaxSectionsPerFrame * 2;
+  device.GetD3DDevice()->CreateQueryHeap( &desc, IID_PPV_ARGS( &d3dQueryHeap ) );
+  d3dQueryHeap->SetName( L"GPU profiler query heap" );
+
+  constexpr int frameSize = MaxSectionsPerFrame * 2 * sizeof( uint64_t );
+
+  for ( auto& frame : frames )
+  {
+    frame.readbackBuffer.reset( static_cast< D3DResource* >( device.CreateBuffer( ResourceType::Buffer, HeapType::Readback, false, frameSize, sizeof( uint64_t ), L"GPUProfilerReadbackBuffer" ).release() ) );
+    frame.sections.resize( MaxSectionsPerFrame );
+  }
+}
+
+D3DGPUProfiler::~D3DGPUProfiler()
+{
+}
+
+int D3DGPUProfiler::BeginSection( D3DCommandList& commandList, const wchar_t* name )
+{
+  auto& frame = frames[ currentFrame ];
+
+  // The previous use of this frame is not read back yet, this frame goes untimed.
+  if ( frame.busy )
+    return -1;
+
+  int sectionIx = frame.sectionCount++;
+  if ( sectionIx >= MaxSectionsPerFrame )
+    return -1;
+
+  auto& section = frame.sections[ sectionIx ];
+  section.name   = name;
+  section.closed = false;
+
+  int sectionId = currentFrame * MaxSectionsPerFrame + sectionIx;
+  commandList.GetD3DGraphicsCommandList()->EndQuery( d3dQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, sectionId * 2 );
+  return sectionId;
+}
+
+void D3DGPUProfiler::EndSection( D3DCommandList& commandList, int sectionId )
+{
+  if ( sectionId < 0 )
+    return;
+
+  // The begin of the section was resolved already without its end. Sections carried over to another list are to be
+  // suspended and continued, not left open over the resolve.
+  assert( sectionId / MaxSectionsPerFrame == currentFrame );
+  if ( sectionId / MaxSectionsPerFrame != currentFrame )
+  {
+    OutputDebugStringW( ( L"GPU section \"" + frames[ sectionId / MaxSectionsPerFrame ].sections[ sectionId % MaxSectionsPerFrame ].name + L"\" ended after the timestamps were resolved, it is not timed.\n" ).data() );
+    return;
+  }
+
+  commandList.GetD3DGraphicsCommandList()->EndQuery( d3dQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, sectionId * 2 + 1 );
+  frames[ currentFrame ].sections[ sectionId % MaxSectionsPerFrame ].closed = true;
+}
+
+void D3DGPUProfiler::ResolveFrame( D3DCommandList& commandList )
+{
+  auto& frame = frames[ currentFrame ];
+  currentFrame = ( currentFrame + 1 ) % FramesInFlight;
+
+  int sectionCount = eastl::min( frame.sectionCount.load(), MaxSectionsPerFrame );
+  if ( frame.busy || sectionCount == 0 )
+    return;
+
+  frame.busy = true;
+
+  for ( int sectionIx = 0; sectionIx < sectionCount; ++sectionIx )
+    if ( !frame.sections[ sectionIx ].closed )
+      OutputDebugStringW( ( L"GPU section \"" + frame.sections[ sectionIx ].name + L"\" is still open at the resolve, it is not timed.\n" ).data() );
+
+  int firstQuery = int( &frame - frames ) * MaxSectionsPerFrame * 2;
+  commandList.GetD3DGraphicsCommandList()->ResolveQueryData( d3dQueryHeap
+                                                           , D3D12_QUERY_TYPE_TIMESTAMP
+                                                           , firstQuery
+                                                           , sectionCount * 2
+                                                           , frame.readbackBuffer->GetD3DResource()
+                                                           , 0 );
+
+  auto frequency = double( commandList.GetFrequency() );
+
+  commandList.RegisterEndFrameCallback( [ this, &frame, sectionCount, frequency ]()
+  {
+    if ( auto data = static_cast< const uint64_t* >( frame.readbackBuffer->Map() ) )
+    {
+      for ( int sectionIx = 0; sectionIx < sectionCount; ++sectionIx )
+      {
+        auto& section = frame.sections[ sectionIx ];
+        if ( !section.closed )
+          continue;
+
+        auto begin = data[ sectionIx * 2 ];
+        auto end   = data[ sectionIx * 2 + 1 ];
+        if ( end > begin )
+          statistics->AddSample( section.name.data(), double( end - begin ) * 1000 / frequency );
+      }
+
+      frame.readbackBuffer->Unmap();
+    }
+
+    statistics->EndFrame();
+
+    frame.sectionCount = 0;
+    frame.busy         = false;
+  } );
+}
+
+GPUPassStatistics& D3DGPUProfiler::GetStatistics()
+{
+  return *statistics;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+class D3DDevice;
+class D3DResource;
+class D3DCommandList;
+class GPUPassStatistics;
+
+// Puts a timestamp pair around every GPU section recorded into direct command lists. The
+// queries of a frame are resolved together into the readback buffer of the frame, which is
+// read once the frame's fence has passed and fed into the pass statistics.
+class D3DGPUProfiler
+{
+public:
+  static constexpr int FramesInFlight      = 3;
+  static constexpr int MaxSectionsPerFrame = 256;
+
+  D3DGPUProfiler( D3DDevice& device );
+  ~D3DGPUProfiler();
+
+  // Returns the section id, or -1 if the section is not timed.
+  int  BeginSection( D3DCommandList& commandList, const wchar_t* name );
+  void EndSection( D3DCommandList& commandList, int sectionId );
+
+  // Records the resolve of the current frame's queries and moves on to the next frame.
+  void ResolveFrame( D3DCommandList& commandList );
+
+  GPUPassStatistics& GetStatistics();
+
+private:
+  struct Section
+  {
+    eastl::wstring name;
+    bool           closed;
+  };
+
+  struct Frame
+  {
+    eastl::unique_ptr< D3DResource > readbackBuffer;
+    eastl::vector< Section >         sections;
+    eastl::atomic< int >             sectionCount = 0;
+    eastl::atomic< bool >            busy         = false;
+  };
+
+  CComPtr< ID3D12QueryHeap > d3dQueryHeap;
+
+  Frame frames[ FramesInFlight ];
+  int   currentFrame = 0;
+
+  eastl::unique_ptr< GPUPassStatistics > statistics;
+};
\ No newline at end of file
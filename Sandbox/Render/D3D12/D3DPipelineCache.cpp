@@ -0,0 +1,175 @@
+#include "D3DPipelineCache.h"
+#include "../PipelineKey.h"
+
+// PSOC
+static constexpr uint32_t cacheMagic = 0x434F5350;
+
+static void FormatPipelineName( wchar_t ( &name )[ 20 ], wchar_t kind, uint64_t key )
+{
+  swprintf_s( name, L"%c%016llx", kind, key );
+}
+
+D3DPipelineCache::FileHeader D3DPipelineCache::MakeFileHeader( const DXGI_ADAPTER_DESC1& adapterDesc )
+{
+  FileHeader header = {};
+  header.magic    = cacheMagic;
+  header.version  = Version;
+  header.vendorId = adapterDesc.VendorId;
+  header.deviceId = adapterDesc.DeviceId;
+  header.subSysId = adapterDesc.SubSysId;
+  header.revision = adapterDesc.Revision;
+  return header;
+}
+
+eastl::vector< uint8_t > D3DPipelineCache::ReadLibraryFile( const wchar_t* path, const FileHeader& header )
+{
+  eastl::vector< uint8_t > library;
+
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, path, L"rb" ) )
+    return library;
+
+  FileHeader fileHeader;
+  if ( fread( &fileHeader, sizeof( fileHeader ), 1, fileHandle ) == 1
+    && fileHeader.magic    == header.magic
+    && fileHeader.version  == header.version
+    && fileHeader.vendorId == header.vendorId
+    && fileHeader.deviceId == header.deviceId
+    && fileHeader.subSysId == header.subSysId
+    && fileHeader.revision == header.revision )
+  {
+    library.resize( size_t( fileHeader.librarySize ) );
+    if ( fread( library.data(), 1, library.size(), fileHandle ) != library.size() )
+      library.clear();
+  }
+
+  fclose( fileHandle );
+
+  return library;
+}
+
+bool D3DPipelineCache::WriteLibraryFile( const wchar_t* path, const FileHeader& header, const eastl::vector< uint8_t >& library )
+{
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, path, L"wb" ) )
+    return false;
+
+  auto fileHeader = header;
+  fileHeader.librarySize = library.size();
+
+  bool written = fwrite( &fileHeader, sizeof( fileHeader ), 1, fileHandle ) == 1
+              && fwrite( library.data(), 1, library.size(), fileHandle ) == library.size();
+  fclose( fileHandle );
+
+  return written;
+}
+
+D3DPipelineCache::D3DPipelineCache( ID3D12DeviceX* d3dDevice, const DXGI_ADAPTER_DESC1& adapterDesc, const wchar_t* path )
+  : d3dDevice( d3dDevice )
+  , path( path )
+  , header( MakeFileHeader( adapterDesc ) )
+{
+  libraryData = ReadLibraryFile( path, header );
+
+  // The runtime refuses libraries of other drivers too, those start empty as well.
+  if ( libraryData.empty() || FAILED( d3dDevice->CreatePipelineLibrary( libraryData.data(), libraryData.size(), IID_PPV_ARGS( &pipelineLibrary ) ) ) )
+  {
+    libraryData.clear();
+    auto hr = d3dDevice->CreatePipelineLibrary( nullptr, 0, IID_PPV_ARGS( &pipelineLibrary ) );
+    assert( SUCCEEDED( hr ) );
+  }
+}
+
+D3DPipelineCache::~D3DPipelineCache()
+{
+}
+
+ID3D12RootSignature* D3DPipelineCache::GetRootSignature( const void* data, size_t size )
+{
+  auto key = HashBytes( data, size );
+
+  eastl::lock_guard< eastl::mutex > autoLock( rootSignatureLock );
+
+  auto& rootSignature = rootSignatures[ key ];
+  if ( !rootSignature )
+  {
+    auto hr = d3dDevice->CreateRootSignature( 0, data, size, IID_PPV_ARGS( &rootSignature ) );
+    assert( SUCCEEDED( hr ) );
+  }
+
+  return rootSignature;
+}
+
+CComPtr< ID3D12PipelineState > D3DPipelineCache::GetGraphicsPipeline( uint64_t key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc )
+{
+  wchar_t name[ 20 ];
+  FormatPipelineName( name, L'G', key );
+
+  CComPtr< ID3D12PipelineState > pipelineState;
+
+  {
+    eastl::lock_guard< eastl::mutex > autoLock( libraryLock );
+    if ( pipelineLibrary && SUCCEEDED( pipelineLibrary->LoadGraphicsPipeline( name, &desc, IID_PPV_ARGS( &pipelineState ) ) ) )
+      return pipelineState;
+  }
+
+  auto hr = d3dDevice->CreateGraphicsPipelineState( &desc, IID_PPV_ARGS( &pipelineState ) );
+  assert( SUCCEEDED( hr ) );
+
+  StorePipeline( name, pipelineState );
+
+  return pipelineState;
+}
+
+CComPtr< ID3D12PipelineState > D3DPipelineCache::GetComputePipeline( uint64_t key, const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc )
+{
+  wchar_t name[ 20 ];
+  FormatPipelineName( name, L'C', key );
+
+  CComPtr< ID3D12PipelineState > pipelineState;
+
+  {
+    eastl::lock_guard< eastl::mutex > autoLock( libraryLock );
+    if ( pipelineLibrary && SUCCEEDED( pipelineLibrary->LoadComputePipeline( name, &desc, IID_PPV_ARGS( &pipelineState ) ) ) )
+      return pipelineState;
+  }
+
+  auto hr = d3dDevice->CreateComputePipelineState( &desc, IID_PPV_ARGS( &pipelineState ) );
+  assert( SUCCEEDED( hr ) );
+
+  StorePipeline( name, pipelineState );
+
+  return pipelineState;
+}
+
+void D3DPipelineCache::StorePipeline( const wchar_t* name, ID3D12PipelineState* pipelineState )
+{
+  if ( !pipelineLibrary || !pipelineState )
+    return;
+
+  // Fails when the name is taken, by the same pipeline built twice, or by a key collision.
+  eastl::lock_guard< eastl::mutex > autoLock( libraryLock );
+  if ( SUCCEEDED( pipelineLibrary->StorePipeline( name, pipelineState ) ) )
+    dirty = true;
+}
+
+void D3DPipelineCache::Save()
+{
+  eastl::lock_guard< eastl::mutex > autoLock( libraryLock );
+
+  if ( !pipelineLibrary || !dirty )
+    return;
+
+  eastl::vector< uint8_t > serialized( pipelineLibrary->GetSerializedSize() );
+  if ( FAILED( pipelineLibrary->Serialize( serialized.data(), serialized.size() ) ) )
+    return;
+
+  if ( WriteLibraryFile( path.data(), header, serialized ) )
+    dirty = false;
+}
+
+WorkerPool& D3DAsyncPipeline::GetCompilerPool()
+{
+  static WorkerPool compilerPool( eastl::max( int( std::thread::hardware_concurrency() ), 1 ), "Pipeline compiler" );
+  return compilerPool;
+}
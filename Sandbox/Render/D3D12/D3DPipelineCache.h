@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Common/WorkerPool.h"
+
+// Keeps the compiled pipelines in a D3D12 pipeline library, which is written to disk when the
+// device goes away, so the next launch loads them instead of compiling. The file starts with a
+// header of the cache version and the adapter, a mismatch starts an empty library. Root
+// signatures are shared between the pipelines made from the same blob.
+class D3DPipelineCache
+{
+public:
+  // Bump it when the translation of the pipeline descriptions changes.
+  static constexpr uint32_t Version = 1;
+
+  struct FileHeader
+  {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendorId;
+    uint32_t deviceId;
+    uint32_t subSysId;
+    uint32_t revision;
+    uint64_t librarySize;
+  };
+
+  static FileHeader MakeFileHeader( const DXGI_ADAPTER_DESC1& adapterDesc );
+
+  // Returns the library of the file, or nothing when the file is missing, truncated, or its header differs from
+  // header in anything but the library size. The write fills in the library size.
+  static eastl::vector< uint8_t > ReadLibraryFile( const wchar_t* path, const FileHeader& header );
+  static bool WriteLibraryFile( const wchar_t* path, const FileHeader& header, const eastl::vector< uint8_t >& library );
+
+  D3DPipelineCache( ID3D12DeviceX* d3dDevice, const DXGI_ADAPTER_DESC1& adapterDesc, const wchar_t* path );
+  ~D3DPipelineCache();
+
+  ID3D12RootSignature* GetRootSignature( const void* data, size_t size );
+
+  // Free threaded, the pipelines not found in the library are compiled on the calling thread.
+  CComPtr< ID3D12PipelineState > GetGraphicsPipeline( uint64_t key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc );
+  CComPtr< ID3D12PipelineState > GetComputePipeline( uint64_t key, const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc );
+
+  // Only writes when pipelines were added since the load.
+  void Save();
+
+private:
+  void StorePipeline( const wchar_t* name, ID3D12PipelineState* pipelineState );
+
+  ID3D12DeviceX* d3dDevice;
+  eastl::wstring path;
+  FileHeader     header = {};
+
+  // The library reads the pipelines from this, so it has to live as long as the library.
+  eastl::vector< uint8_t >         libraryData;
+  CComPtr< ID3D12PipelineLibrary > pipelineLibrary;
+  eastl::mutex                     libraryLock;
+  bool                             dirty = false;
+
+  eastl::vector_map< uint64_t, CComPtr< ID3D12RootSignature > > rootSignatures;
+  eastl::mutex                                                  rootSignatureLock;
+};
+
+// A pipeline compiled on a worker thread, so independent pipelines are built in parallel. Get
+// waits for it, and can be called from any thread. Declare it after everything the build reads,
+// so it is destroyed, and waited for, first. The compiler threads are a pool of their own, so a
+// pass recorded on the shared pool can wait for a pipeline without holding up its build.
+class D3DAsyncPipeline
+{
+public:
+  ~D3DAsyncPipeline()
+  {
+    if ( build.valid() )
+      build.wait();
+  }
+
+  template< typename BuildFunc >
+  void Start( BuildFunc&& buildFunc )
+  {
+    build = GetCompilerPool().Async( [ this, buildFunc = eastl::forward< BuildFunc >( buildFunc ) ]() mutable { pipelineState = buildFunc(); } );
+  }
+
+  static WorkerPool& GetCompilerPool();
+
+  ID3D12PipelineState* Get() const
+  {
+    if ( !ready.load( eastl::memory_order_acquire ) )
+    {
+      eastl::lock_guard< eastl::mutex > autoLock( waitLock );
+      if ( !ready.load( eastl::memory_order_relaxed ) )
+      {
+        build.wait();
+        ready.store( true, eastl::memory_order_release );
+      }
+    }
+
+    return pipelineState;
+  }
+
+private:
+  CComPtr< ID3D12PipelineState > pipelineState;
+
+  mutable std::future< void >   build;
+  mutable eastl::mutex          waitLock;
+  mutable eastl::atomic< bool > ready = false;
+};
\ No newline at end of file
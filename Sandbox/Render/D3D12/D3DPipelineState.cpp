@@ -1,20 +1,22 @@
 #include "D3DPipelineState.h"
 #include "D3DDevice.h"
 #include "Conversion.h"
+#include "../PipelineKey.h"
 
 D3DPipelineState::D3DPipelineState( const PipelineDesc& desc, D3DDevice& device, const wchar_t* debugName )
+  : desc( desc )
+  , debugName( debugName ? debugName : L"" )
 {
-  auto d3dDevice = device.GetD3DDevice();
-    
-  D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc;
-  ZeroObject( psoDesc );
+  d3dRootSignature = device.GetPipelineCache().GetRootSignature( desc.vsData, desc.vsSize );
 
-  auto hr = d3dDevice->CreateRootSignature( 0, desc.vsData, desc.vsSize, IID_PPV_ARGS( &d3dRootSignature ) );
-  assert( SUCCEEDED( hr ) );
+  auto key = HashPipelineDesc( this->desc );
+  d3dPipelineState.Start( [ this, &device, key ]() { return CreatePipelineState( device, key ); } );
+}
 
-  CComPtr< ID3D12RootSignatureDeserializer > deserializer;
-  D3D12CreateRootSignatureDeserializer( desc.vsData, desc.vsSize, IID_PPV_ARGS( &deserializer ) );
-  auto rsDesc = deserializer->GetRootSignatureDesc();
+CComPtr< ID3D12PipelineState > D3DPipelineState::CreatePipelineState( D3DDevice& device, uint64_t key ) const
+{
+  D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc;
+  ZeroObject( psoDesc );
 
   psoDesc.pRootSignature = d3dRootSignature;
 
@@ -108,10 +110,12 @@ D3DPipelineState::D3DPipelineState( const PipelineDesc& desc, D3DDevice& device,
 
   psoDesc.SampleMask = UINT_MAX;
 
-  d3dDevice->CreateGraphicsPipelineState( &psoDesc, IID_PPV_ARGS( &d3dPipelineState ) );
+  auto pipelineState = device.GetPipelineCache().GetGraphicsPipeline( key, psoDesc );
+
+  if ( pipelineState && !debugName.empty() )
+    pipelineState->SetName( debugName.data() );
 
-  if ( debugName )
-    d3dPipelineState->SetName( debugName );
+  return pipelineState;
 }
 
 D3DPipelineState::~D3DPipelineState()
@@ -120,7 +124,7 @@ D3DPipelineState::~D3DPipelineState()
 
 ID3D12PipelineState* D3DPipelineState::GetD3DPipelineState() const
 {
-  return d3dPipelineState;
+  return d3dPipelineState.Get();
 }
 
 ID3D12RootSignature* D3DPipelineState::GetD3DRootSignature() const
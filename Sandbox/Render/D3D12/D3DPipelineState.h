@@ -2,6 +2,7 @@
 
 #include "../PipelineState.h"
 #include "../Types.h"
+#include "D3DPipelineCache.h"
 
 class D3DPipelineState : public PipelineState
 {
@@ -10,12 +11,20 @@ class D3DPipelineState : public PipelineState
 public:
   ~D3DPipelineState();
 
+  // Waits for the pipeline, if it is still being compiled.
   ID3D12PipelineState* GetD3DPipelineState() const;
   ID3D12RootSignature* GetD3DRootSignature() const;
 
 private:
   D3DPipelineState( const PipelineDesc& desc, D3DDevice& device, const wchar_t* debugName );
 
-  CComPtr< ID3D12PipelineState > d3dPipelineState;
+  CComPtr< ID3D12PipelineState > CreatePipelineState( D3DDevice& device, uint64_t key ) const;
+
+  // A copy, as the build outlives the caller's desc. The shaders come from the shader package, and are not copied.
+  PipelineDesc   desc;
+  eastl::wstring debugName;
+
   CComPtr< ID3D12RootSignature > d3dRootSignature;
+
+  D3DAsyncPipeline d3dPipelineState;
 };
\ No newline at end of file
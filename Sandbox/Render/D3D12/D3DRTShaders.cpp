@@ -2,11 +2,12 @@
 #include "D3DDevice.h"
 #include "D3DResource.h"
 #include "../Utils.h"
+#include "../ShaderPackage.h"
 
 D3DRTShaders::D3DRTShaders( D3DDevice& d3dDevice
                           , CommandList& commandList
-                          , const eastl::vector< uint8_t >& rootSignatureShaderBinary
-                          , const eastl::vector< uint8_t >& shaderBinary
+                          , const ShaderBinary& rootSignatureShaderBinary
+                          , const ShaderBinary& shaderBinary
                           , const wchar_t* rayGenEntryName
                           , const wchar_t* missEntryName
                           , const wchar_t* anyHitEntryName
@@ -17,7 +18,7 @@ D3DRTShaders::D3DRTShaders( D3DDevice& d3dDevice
 {
   assert( rayGenEntryName );
 
-  auto hr = d3dDevice.GetD3DDevice()->CreateRootSignature(0, rootSignatureShaderBinary.data(), rootSignatureShaderBinary.size(), IID_PPV_ARGS( &d3dRootSignature ) );
+  auto hr = d3dDevice.GetD3DDevice()->CreateRootSignature(0, rootSignatureShaderBinary.data, rootSignatureShaderBinary.size, IID_PPV_ARGS( &d3dRootSignature ) );
   assert( SUCCEEDED( hr ) );
 
   eastl::vector< D3D12_STATE_SUBOBJECT > subobjects;
@@ -59,8 +60,8 @@ D3DRTShaders::D3DRTShaders( D3DDevice& d3dDevice
   }
 
   D3D12_DXIL_LIBRARY_DESC shaderBinaryDesc;
-  shaderBinaryDesc.DXILLibrary.pShaderBytecode = shaderBinary.data();
-  shaderBinaryDesc.DXILLibrary.BytecodeLength  = shaderBinary.size();
+  shaderBinaryDesc.DXILLibrary.pShaderBytecode = shaderBinary.data;
+  shaderBinaryDesc.DXILLibrary.BytecodeLength  = shaderBinary.size;
   shaderBinaryDesc.NumExports                  = UINT( exports.size() );
   shaderBinaryDesc.pExports                    = exports.data();
 
@@ -212,8 +213,7 @@ D3DRTShaders::D3DRTShaders( D3DDevice& d3dDevice
     data += oneShaderSize;
   }
 
-  auto uploadBuffer = RenderManager::GetInstance().GetUploadBufferForResource( *shaderTable );
-  commandList.UploadBufferResource( eastl::move( uploadBuffer ), *shaderTable, cache.data(), int( cache.size() ) );
+  commandList.UploadBufferResource( *shaderTable, cache.data(), int( cache.size() ) );
 }
 
 D3DRTShaders::~D3DRTShaders()
@@ -3,6 +3,7 @@
 #include "../RTShaders.h"
 
 class D3DResource;
+struct ShaderBinary;
 
 class D3DRTShaders : public RTShaders
 {
@@ -21,8 +22,8 @@ public:
 private:
   D3DRTShaders( D3DDevice& d3dDevice
               , CommandList& commandList
-              , const eastl::vector< uint8_t >& rootSignatureShaderBinary
-              , const eastl::vector< uint8_t >& shaderBinary
+              , const ShaderBinary& rootSignatureShaderBinary
+              , const ShaderBinary& shaderBinary
               , const wchar_t* rayGenEntryName
               , const wchar_t* missEntryName
               , const wchar_t* anyHitEntryName
@@ -8,156 +8,151 @@
 #include "D3DUtils.h"
 #include "../ShaderValues.h"
 
+// Refitting degrades the quality of the structure, so it is rebuilt after too many refits or too many changes.
+static constexpr int   maxRefitsInARow    = 64;
+static constexpr float rebuildChangeRatio = 0.25f;
+
 D3DRTTopLevelAccelerator::D3DRTTopLevelAccelerator( D3DDevice& device, D3DCommandList& commandList, eastl::vector< RTInstance > instances, int slot )
   : slot( slot )
 {
-  auto instanceDataSize = eastl::max( sizeof( D3D12_RAYTRACING_INSTANCE_DESC ) * instances.size(), size_t( 1 ) );
-
-  AllocatedResource instanceDescs = AllocateUploadBuffer( device, instanceDataSize, L"InstanceDescs" );
-
-  D3D12_RAYTRACING_INSTANCE_DESC* mappedData;
-  instanceDescs->Map( 0, nullptr, (void**)&mappedData );
-  for ( auto& instance : instances )
-  {
-    assert( instance.accel->GetInfoIndex() > -1 );
-    assert( instance.accel->GetInfoIndex() < ( 1 << 24 ) );
-
-    mappedData->Transform[ 0 ][ 0 ]                 = instance.transform._11;
-    mappedData->Transform[ 0 ][ 1 ]                 = instance.transform._21;
-    mappedData->Transform[ 0 ][ 2 ]                 = instance.transform._31;
-    mappedData->Transform[ 0 ][ 3 ]                 = instance.transform._41;
-    mappedData->Transform[ 1 ][ 0 ]                 = instance.transform._12;
-    mappedData->Transform[ 1 ][ 1 ]                 = instance.transform._22;
-    mappedData->Transform[ 1 ][ 2 ]                 = instance.transform._32;
-    mappedData->Transform[ 1 ][ 3 ]                 = instance.transform._42;
-    mappedData->Transform[ 2 ][ 0 ]                 = instance.transform._13;
-    mappedData->Transform[ 2 ][ 1 ]                 = instance.transform._23;
-    mappedData->Transform[ 2 ][ 2 ]                 = instance.transform._33;
-    mappedData->Transform[ 2 ][ 3 ]                 = instance.transform._43;
-    mappedData->InstanceID                          = instance.accel->GetInfoIndex();
-    mappedData->InstanceMask                        = 0xFFU;
-    mappedData->InstanceContributionToHitGroupIndex = 0;
-    mappedData->Flags                               = D3D12_RAYTRACING_INSTANCE_FLAG_TRIANGLE_CULL_DISABLE;
-    mappedData->AccelerationStructure               = static_cast< D3DRTBottomLevelAccelerator* >( instance.accel )->GetD3DUAVBuffer()->GetGPUVirtualAddress();
+  ZeroMemory( &d3dAcceleratorDesc, sizeof( d3dAcceleratorDesc ) );
 
-    mappedData++;
-  }
-  instanceDescs->Unmap( 0, nullptr );
+  SetInstances( instances );
+  Build( device, commandList, false );
+}
 
-  D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS topLevelInputs = {};
-  topLevelInputs.DescsLayout    = D3D12_ELEMENTS_LAYOUT_ARRAY;
-  topLevelInputs.Flags          = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
-  topLevelInputs.NumDescs       = UINT( instances.size() );
-  topLevelInputs.Type           = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-  topLevelInputs.InstanceDescs  = instanceDescs->GetGPUVirtualAddress();
+D3DRTTopLevelAccelerator::~D3DRTTopLevelAccelerator()
+{
+}
 
-  D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO topLevelPrebuildInfo = {};
-  device.GetD3DDevice()->GetRaytracingAccelerationStructurePrebuildInfo( &topLevelInputs, &topLevelPrebuildInfo );
-  assert( topLevelPrebuildInfo.ResultDataMaxSizeInBytes > 0 );
+void D3DRTTopLevelAccelerator::Update( Device& device, CommandList& commandList, eastl::vector< RTInstance > instances )
+{
+  auto& d3dDevice      = *static_cast< D3DDevice* >( &device );
+  auto& d3dCommandList = *static_cast< D3DCommandList* >( &commandList );
 
-  CComPtr< ID3D12Resource > d3dScratchBuffer = device.RequestD3DRTScartchBuffer( commandList, int( topLevelPrebuildInfo.ScratchDataSizeInBytes ) );
-  auto rtBuffer = AllocateUAVBuffer( device, topLevelPrebuildInfo.ResultDataMaxSizeInBytes, ResourceStateBits::RTAccelerationStructure, L"TLAS" );
+  // A new instance list can reference other bottom level structures, so it is always built from scratch.
+  SetInstances( instances );
+  Build( d3dDevice, d3dCommandList, false );
+}
 
-  ZeroMemory( &d3dAcceleratorDesc, sizeof( d3dAcceleratorDesc ) );
-  d3dAcceleratorDesc.Inputs                           = topLevelInputs;
-  d3dAcceleratorDesc.ScratchAccelerationStructureData = d3dScratchBuffer->GetGPUVirtualAddress();
-  d3dAcceleratorDesc.DestAccelerationStructureData    = rtBuffer->GetGPUVirtualAddress();
+void D3DRTTopLevelAccelerator::UpdateTransforms( Device& device, CommandList& commandList, const eastl::vector< RTInstanceTransform >& transforms )
+{
+  if ( transforms.empty() )
+    return;
 
-  D3D12_RESOURCE_BARRIER barrier = {};
-  barrier.Type          = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-  barrier.UAV.pResource = *rtBuffer;
+  auto& d3dDevice      = *static_cast< D3DDevice* >( &device );
+  auto& d3dCommandList = *static_cast< D3DCommandList* >( &commandList );
 
-  commandList.GetD3DGraphicsCommandList()->BuildRaytracingAccelerationStructure( &d3dAcceleratorDesc, 0, nullptr );
-  commandList.GetD3DGraphicsCommandList()->ResourceBarrier( 1, &barrier );
+  instanceRing.BeginChanges();
 
-  commandList.HoldResource( eastl::unique_ptr< Resource >( new D3DResource( eastl::move( instanceDescs ), ResourceStateBits::Common ) ) );
+  for ( auto& transform : transforms )
+    PackRTTransform( transform.transform, instanceRing.ChangeInstance( transform.instanceIndex ).Transform );
 
-  d3dResource.reset( new D3DResource( eastl::move( rtBuffer ), ResourceStateBits::RTAccelerationStructure ) );
-  resourceDescriptor = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, slot, *d3dResource, 0 );
-}
+  bool canRefit = refitsInARow < maxRefitsInARow && transforms.size() <= instanceRing.GetInstanceCount() * rebuildChangeRatio;
 
-D3DRTTopLevelAccelerator::~D3DRTTopLevelAccelerator()
-{
+  Build( d3dDevice, d3dCommandList, canRefit );
 }
 
-void D3DRTTopLevelAccelerator::Update( Device& device, CommandList& commandList, eastl::vector< RTInstance > instances )
+void D3DRTTopLevelAccelerator::SetInstances( const eastl::vector< RTInstance >& instances )
 {
-  auto& d3dDevice        = *static_cast< D3DDevice* >( &device );
-  auto& d3dCommandList   = *static_cast< D3DCommandList* >( &commandList );
-  auto  instanceDataSize = sizeof( D3D12_RAYTRACING_INSTANCE_DESC ) * instances.size();
-
-  AllocatedResource instanceDescs = AllocateUploadBuffer( d3dDevice, instanceDataSize, L"InstanceDescs" );
-
-  D3D12_RAYTRACING_INSTANCE_DESC* mappedData;
-  instanceDescs->Map( 0, nullptr, (void**)&mappedData );
+  auto mappedData = instanceRing.ResetInstances( int( instances.size() ) );
   for ( auto& instance : instances )
   {
     assert( instance.accel->GetInfoIndex() > -1 );
     assert( instance.accel->GetInfoIndex() < ( 1 << 24 ) );
 
-    mappedData->Transform[ 0 ][ 0 ]                 = instance.transform._11;
-    mappedData->Transform[ 0 ][ 1 ]                 = instance.transform._21;
-    mappedData->Transform[ 0 ][ 2 ]                 = instance.transform._31;
-    mappedData->Transform[ 0 ][ 3 ]                 = instance.transform._41;
-    mappedData->Transform[ 1 ][ 0 ]                 = instance.transform._12;
-    mappedData->Transform[ 1 ][ 1 ]                 = instance.transform._22;
-    mappedData->Transform[ 1 ][ 2 ]                 = instance.transform._32;
-    mappedData->Transform[ 1 ][ 3 ]                 = instance.transform._42;
-    mappedData->Transform[ 2 ][ 0 ]                 = instance.transform._13;
-    mappedData->Transform[ 2 ][ 1 ]                 = instance.transform._23;
-    mappedData->Transform[ 2 ][ 2 ]                 = instance.transform._33;
-    mappedData->Transform[ 2 ][ 3 ]                 = instance.transform._43;
+    PackRTTransform( instance.transform, mappedData->Transform );
     mappedData->InstanceID                          = instance.accel->GetInfoIndex();
     mappedData->InstanceMask                        = 0xFFU;
     mappedData->InstanceContributionToHitGroupIndex = 0;
-    mappedData->Flags	                              = D3D12_RAYTRACING_INSTANCE_FLAG_TRIANGLE_CULL_DISABLE;
+    mappedData->Flags                               = D3D12_RAYTRACING_INSTANCE_FLAG_TRIANGLE_CULL_DISABLE;
     mappedData->AccelerationStructure               = static_cast< D3DRTBottomLevelAccelerator* >( instance.accel )->GetD3DUAVBuffer()->GetGPUVirtualAddress();
 
     mappedData++;
   }
-  instanceDescs->Unmap( 0, nullptr );
+}
+
+int D3DRTTopLevelAccelerator::AcquireInstanceBuffer( D3DDevice& device )
+{
+  return instanceRing.AcquireBuffer( *completedBuild, [ this, &device ]( int bufferIndex, int count )
+  {
+    if ( bufferIndex >= int( instanceBuffers.size() ) )
+      instanceBuffers.resize( bufferIndex + 1 );
+
+    auto& instanceBuffer = instanceBuffers[ bufferIndex ];
+    instanceBuffer = AllocateUploadBuffer( device, sizeof( D3D12_RAYTRACING_INSTANCE_DESC ) * count, L"InstanceDescs" );
+
+    D3D12_RAYTRACING_INSTANCE_DESC* mappedData = nullptr;
+    instanceBuffer->Map( 0, nullptr, (void**)&mappedData );
+    return mappedData;
+  } );
+}
+
+void D3DRTTopLevelAccelerator::Build( D3DDevice& device, D3DCommandList& commandList, bool performUpdate )
+{
+  performUpdate = performUpdate && d3dResource;
+
+  int instanceBufferIndex = AcquireInstanceBuffer( device );
 
   D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS topLevelInputs = {};
   topLevelInputs.DescsLayout    = D3D12_ELEMENTS_LAYOUT_ARRAY;
-  topLevelInputs.Flags          = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
-  topLevelInputs.NumDescs       = UINT( instances.size() );
+  topLevelInputs.Flags          = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
+  topLevelInputs.NumDescs       = UINT( instanceRing.GetInstanceCount() );
   topLevelInputs.Type           = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-  topLevelInputs.InstanceDescs  = instanceDescs->GetGPUVirtualAddress();
+  topLevelInputs.InstanceDescs  = instanceBuffers[ instanceBufferIndex ]->GetGPUVirtualAddress();
+
+  if ( performUpdate )
+    topLevelInputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
 
   D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO topLevelPrebuildInfo = {};
-  d3dDevice.GetD3DDevice()->GetRaytracingAccelerationStructurePrebuildInfo( &topLevelInputs, &topLevelPrebuildInfo );
+  device.GetD3DDevice()->GetRaytracingAccelerationStructurePrebuildInfo( &topLevelInputs, &topLevelPrebuildInfo );
   assert( topLevelPrebuildInfo.ResultDataMaxSizeInBytes > 0 );
 
-  CComPtr< ID3D12Resource > d3dScratchBuffer = d3dDevice.RequestD3DRTScartchBuffer( d3dCommandList, int( topLevelPrebuildInfo.ScratchDataSizeInBytes ) );
-  
+  auto scratchSize = performUpdate ? topLevelPrebuildInfo.UpdateScratchDataSizeInBytes : topLevelPrebuildInfo.ScratchDataSizeInBytes;
+  CComPtr< ID3D12Resource > d3dScratchBuffer = device.RequestD3DRTScartchBuffer( commandList, int( scratchSize ) );
+
   AllocatedResource newRTBuffer;
-  if ( d3dResource->GetD3DResource()->GetDesc().Width < topLevelPrebuildInfo.ResultDataMaxSizeInBytes )
-    newRTBuffer = AllocateUAVBuffer( d3dDevice, topLevelPrebuildInfo.ResultDataMaxSizeInBytes, ResourceStateBits::RTAccelerationStructure, L"TLAS" );
+  if ( !d3dResource || d3dResource->GetD3DResource()->GetDesc().Width < topLevelPrebuildInfo.ResultDataMaxSizeInBytes )
+    newRTBuffer = AllocateUAVBuffer( device, topLevelPrebuildInfo.ResultDataMaxSizeInBytes, ResourceStateBits::RTAccelerationStructure, L"TLAS" );
 
   d3dAcceleratorDesc.Inputs                           = topLevelInputs;
   d3dAcceleratorDesc.ScratchAccelerationStructureData = d3dScratchBuffer->GetGPUVirtualAddress();
-  d3dAcceleratorDesc.SourceAccelerationStructureData  = d3dResource->GetD3DResource()->GetGPUVirtualAddress();
+  d3dAcceleratorDesc.SourceAccelerationStructureData  = performUpdate ? d3dResource->GetD3DResource()->GetGPUVirtualAddress() : 0;
   d3dAcceleratorDesc.DestAccelerationStructureData    = newRTBuffer ? newRTBuffer->GetGPUVirtualAddress() : d3dResource->GetD3DResource()->GetGPUVirtualAddress();
 
   D3D12_RESOURCE_BARRIER barrier = {};
-  barrier.Type          = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-  barrier.UAV.pResource = d3dResource->GetD3DResource();
-  d3dCommandList.GetD3DGraphicsCommandList()->ResourceBarrier( 1, &barrier );
+  barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
 
-  d3dCommandList.GetD3DGraphicsCommandList()->BuildRaytracingAccelerationStructure( &d3dAcceleratorDesc, 0, nullptr );
+  if ( d3dResource )
+  {
+    barrier.UAV.pResource = d3dResource->GetD3DResource();
+    commandList.GetD3DGraphicsCommandList()->ResourceBarrier( 1, &barrier );
+  }
+
+  commandList.GetD3DGraphicsCommandList()->BuildRaytracingAccelerationStructure( &d3dAcceleratorDesc, 0, nullptr );
 
-  barrier.Transition.pResource = newRTBuffer ? *newRTBuffer : d3dResource->GetD3DResource();
-  d3dCommandList.GetD3DGraphicsCommandList()->ResourceBarrier( 1, &barrier );
+  barrier.UAV.pResource = newRTBuffer ? *newRTBuffer : d3dResource->GetD3DResource();
+  commandList.GetD3DGraphicsCommandList()->ResourceBarrier( 1, &barrier );
 
-  commandList.HoldResource( eastl::unique_ptr< Resource >( new D3DResource( eastl::move( instanceDescs ), ResourceStateBits::Common ) ) );
+  instanceRing.RetireBuffer( instanceBufferIndex, ++buildCount );
+  commandList.RegisterEndFrameCallback( [ completedBuild = completedBuild, build = buildCount ]()
+  {
+    *completedBuild = eastl::max( *completedBuild, build );
+  } );
 
   if ( newRTBuffer )
   {
-    d3dResource->RemoveAllResourceDescriptors();
-    commandList.HoldResource( eastl::move( d3dResource ) );
+    if ( d3dResource )
+    {
+      d3dResource->RemoveAllResourceDescriptors();
+      commandList.HoldResource( eastl::move( d3dResource ) );
+    }
+
     d3dResource.reset( new D3DResource( eastl::move( newRTBuffer ), ResourceStateBits::RTAccelerationStructure ) );
     resourceDescriptor = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, slot, *d3dResource, 0 );
   }
+
+  refitsInARow = performUpdate ? refitsInARow + 1 : 0;
 }
 
 ResourceDescriptor& D3DRTTopLevelAccelerator::GetResourceDescriptor()
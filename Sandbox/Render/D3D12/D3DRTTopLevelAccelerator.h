@@ -2,6 +2,7 @@
 
 #include "../Types.h"
 #include "../RTTopLevelAccelerator.h"
+#include "../RTInstanceRing.h"
 #include "AllocatedResource.h"
 
 class D3DCommandList;
@@ -17,6 +18,7 @@ public:
   virtual ~D3DRTTopLevelAccelerator();
 
   void Update( Device& device, CommandList& commandList, eastl::vector< RTInstance > instances ) override;
+  void UpdateTransforms( Device& device, CommandList& commandList, const eastl::vector< RTInstanceTransform >& transforms ) override;
 
   ResourceDescriptor& GetResourceDescriptor() override;
 
@@ -25,10 +27,23 @@ public:
 private:
   D3DRTTopLevelAccelerator( D3DDevice& device, D3DCommandList& commandList, eastl::vector< RTInstance > instances, int slot );
 
+  void SetInstances( const eastl::vector< RTInstance >& instances );
+  int  AcquireInstanceBuffer( D3DDevice& device );
+  void Build( D3DDevice& device, D3DCommandList& commandList, bool performUpdate );
+
   eastl::unique_ptr< D3DResource > d3dResource;
   D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC d3dAcceleratorDesc;
 
   eastl::unique_ptr< ResourceDescriptor > resourceDescriptor;
 
+  // The builds are the fences of the instance buffers, the end of frame callbacks tell the completed ones.
+  // Shared with the callbacks, as the accelerator can be released before the callbacks of its last frame run.
+  RTInstanceRing< D3D12_RAYTRACING_INSTANCE_DESC > instanceRing;
+  eastl::vector< AllocatedResource >               instanceBuffers;
+  eastl::shared_ptr< uint64_t >                    completedBuild = eastl::make_shared< uint64_t >( 0 );
+
+  uint64_t buildCount   = 0;
+  int      refitsInARow = 0;
+
   int slot;
-};
\ No newline at end of file
+};
@@ -26,7 +26,7 @@ D3DTileHeap::Texture::Texture( eastl::unique_ptr< Resource >&& resource, eastl::
   ZeroMemory( usage.data(), usage.size() );
 }
 
-D3DTileHeap::D3DTileHeap( D3DDevice& device, PixelFormat pixelFormat, const wchar_t* debugName )
+D3DTileHeap::D3DTileHeap( Device& device, PixelFormat pixelFormat, const wchar_t* debugName )
   : pixelFormat( pixelFormat )
 {
   InitializeCriticalSectionAndSpinCount( &allocationLock, 4000 );
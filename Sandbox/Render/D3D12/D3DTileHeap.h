@@ -8,9 +8,9 @@ enum class PixelFormat : uint32_t;
 
 class D3DTileHeap : public TileHeap
 {
-  friend class D3DDevice;
-
 public:
+  // Only the interfaces of the device are used, the micro benchmarks run it on the null device.
+  D3DTileHeap( Device& device, PixelFormat pixelFormat, const wchar_t* debugName );
   ~D3DTileHeap();
 
   void prealloc( Device& device, CommandQueue& directQueue, int sizeMB ) override;
@@ -19,8 +19,6 @@ public:
   void free( Allocation allocation ) override;
 
 private:
-  D3DTileHeap( D3DDevice& device, PixelFormat pixelFormat, const wchar_t* debugName );
-
   struct Texture
   {
     Texture() = default;
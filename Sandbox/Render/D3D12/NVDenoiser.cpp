@@ -7,7 +7,7 @@
 #include "D3DCommandQueue.h"
 #include "D3DComputeShader.h"
 #include "D3DResource.h"
-#include "Common/Files.h"
+#include "../ShaderPackage.h"
 
 #include "NRI.h"
 #include "Extensions/NRIWrapperD3D12.h"
@@ -131,8 +131,8 @@ NVDenoiser::NVDenoiser( Device& device, CommandQueue& directQueue, CommandList&
   nrdInternalTextures[ InternalTextures::Validation ].nextAccess = nri::AccessBits::SHADER_RESOURCE_STORAGE;
   nrdInternalTextures[ InternalTextures::Validation ].nextLayout = nri::TextureLayout::GENERAL;
 
-  auto preparationFile = ReadFileToMemory( L"Content/Shaders/PrepareDenoiser.cso" );
-  preparationShader = device.CreateComputeShader( preparationFile.data(), int( preparationFile.size() ), L"Denoiser preparation" );
+  auto preparationFile = ShaderPackage::GetInstance().GetShader( L"PrepareDenoiser" );
+  preparationShader = device.CreateComputeShader( preparationFile.data, preparationFile.size, L"Denoiser preparation" );
 
   commonSettings = eastl::make_unique< nrd::CommonSettings >();
 }
@@ -1,5 +1,6 @@
 #include "../../ShaderValues.h"
 #include "Utils.hlsli"
+#include "Culling.hlsli"
 
 #define _RootSignature "RootFlags( 0 )," \
                        "DescriptorTable( SRV( t0 ) )," \
@@ -17,6 +18,9 @@
                        "DescriptorTable( UAV( u7 ) )," \
                        "DescriptorTable( UAV( u8 ) )," \
                        "DescriptorTable( UAV( u9 ) )," \
+                       "RootConstants( b0, num32BitConstants = 3 )," \
+                       "DescriptorTable( SRV( t0, space = 1, numDescriptors = " HiZLevelCountStr " ) )," \
+                       "DescriptorTable( UAV( u10 ) )," \
 
 StructuredBuffer< NodeSlot     > nodes                   : register( t0 );
 StructuredBuffer< MeshSlot     > meshes                  : register( t1 );
@@ -35,6 +39,14 @@ RWStructuredBuffer< FrameParams >    frameParams                             : r
 RWStructuredBuffer< LightParams >    frameLights                             : register( u8 );
 RWStructuredBuffer< Sky         >    sky                                     : register( u9 );
 
+RWStructuredBuffer< OcclusionCandidate > occlusionCandidates : register( u10 );
+
+cbuffer cb0 : register( b0 )
+{
+  uint  hiZValid;
+  uint2 depthSize;
+};
+
 float4x4 CameraMatrixToViewMatrix( float4x4 c )
 {
   float4x4 t = transpose( c );
@@ -52,21 +64,6 @@ float4x4 CameraMatrixToViewMatrix( float4x4 c )
   return transpose( v );
 }
 
-void WriteMesh( RWStructuredBuffer< IndirectRender > buffer, uint bufferIndex, uint index, uint meshSlot, float4x4 transform )
-{
-  buffer[ index ].worldTransform = transform;
-  buffer[ index ].ibIndex        = meshes[ meshSlot ].ibIndex;
-  buffer[ index ].vbIndex        = meshes[ meshSlot ].vbIndex;
-  buffer[ index ].materialIndex  = meshes[ meshSlot ].materialIndex;
-  buffer[ index ].modelId        = index | ( bufferIndex << 13 );
-  buffer[ index ].randomValues   = meshes[ meshSlot ].randomValues;
-
-  buffer[ index ].vertexCountPerInstance = meshes[ meshSlot ].indexCount;
-  buffer[ index ].instanceCount          = 1;
-  buffer[ index ].startVertexLocation    = 0;
-  buffer[ index ].startInstanceLocation  = 0;
-}
-
 bool IsOBBVisible( float4x4 viewProjection, float4x4 nodeTransform, float4 center, float4 extents )
 {
   float4x4 mvp = mul( viewProjection, nodeTransform );
@@ -163,6 +160,16 @@ void main( uint3 dispatchThreadID : SV_DispatchThreadID )
       if ( !IsOBBVisible( cullTransform, currentTransform, meshes[ meshSlot ].aabbCenter, meshes[ meshSlot ].aabbExtents ) )
         continue;
 
+      // Meshes hidden by the last frame's depth are left for the late pass, which tests them against this frame's
+      if ( hiZValid && IsOccludedByHiZ( mul( frameParams[ 0 ].prevVPTransformNoJitter, currentTransform ), meshes[ meshSlot ].aabbCenter, meshes[ meshSlot ].aabbExtents, depthSize ) )
+      {
+        uint candidateIndex;
+        instanceCount.InterlockedAdd( 24, 1, candidateIndex );
+        occlusionCandidates[ candidateIndex ].worldTransform = currentTransform;
+        occlusionCandidates[ candidateIndex ].meshSlot       = meshSlot;
+        continue;
+      }
+
       bool isOpaque      = ( materials[ meshes[ meshSlot ].materialIndex ].flags & MaterialSlot::Translucent ) == 0;
       bool isTwoSided    = ( materials[ meshes[ meshSlot ].materialIndex ].flags & MaterialSlot::TwoSided ) != 0;
       bool isAlphaTested = ( materials[ meshes[ meshSlot ].materialIndex ].flags & MaterialSlot::AlphaTested ) != 0;
@@ -176,12 +183,12 @@ void main( uint3 dispatchThreadID : SV_DispatchThreadID )
           if ( isAlphaTested )
           {
             instanceCount.InterlockedAdd( 12, 1, indirectIndex );
-            WriteMesh( indirectOpaqueTwoSidedAlphaTestedRender, 3, indirectIndex, meshSlot, currentTransform );
+            WriteMesh( indirectOpaqueTwoSidedAlphaTestedRender, 3, indirectIndex, meshes[ meshSlot ], currentTransform );
           }
           else
           {
             instanceCount.InterlockedAdd( 4, 1, indirectIndex );
-            WriteMesh( indirectOpaqueTwoSidedRender, 1, indirectIndex, meshSlot, currentTransform );
+            WriteMesh( indirectOpaqueTwoSidedRender, 1, indirectIndex, meshes[ meshSlot ], currentTransform );
           }
         }
         else
@@ -189,12 +196,12 @@ void main( uint3 dispatchThreadID : SV_DispatchThreadID )
           if ( isAlphaTested )
           {
             instanceCount.InterlockedAdd( 8, 1, indirectIndex );
-            WriteMesh( indirectOpaqueAlphaTestedRender, 2, indirectIndex, meshSlot, currentTransform );
+            WriteMesh( indirectOpaqueAlphaTestedRender, 2, indirectIndex, meshes[ meshSlot ], currentTransform );
           }
           else
           {
             instanceCount.InterlockedAdd( 0, 1, indirectIndex );
-            WriteMesh( indirectOpaqueRender, 0, indirectIndex, meshSlot, currentTransform );
+            WriteMesh( indirectOpaqueRender, 0, indirectIndex, meshes[ meshSlot ], currentTransform );
           }
         }
       }
@@ -204,13 +211,13 @@ void main( uint3 dispatchThreadID : SV_DispatchThreadID )
         {
           uint indirectIndex;
           instanceCount.InterlockedAdd( 20, 1, indirectIndex );
-          WriteMesh( indirectTranslucentTwoSidedRender, 5, indirectIndex, meshSlot, currentTransform );
+          WriteMesh( indirectTranslucentTwoSidedRender, 5, indirectIndex, meshes[ meshSlot ], currentTransform );
         }
         else
         {
           uint indirectIndex;
           instanceCount.InterlockedAdd( 16, 1, indirectIndex );
-          WriteMesh( indirectTranslucentRender, 4, indirectIndex, meshSlot, currentTransform );
+          WriteMesh( indirectTranslucentRender, 4, indirectIndex, meshes[ meshSlot ], currentTransform );
         }
       }
     }
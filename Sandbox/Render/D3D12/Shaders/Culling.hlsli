@@ -0,0 +1,84 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include "RootSignatures/ShaderStructures.hlsli"
+
+// The Hi-Z pyramid. Level 0 is half the depth resolution, every texel keeps the farthest depth below it.
+Texture2D< float > hiZLevels[ HiZLevelCount ] : register( t0, space1 );
+
+void WriteMesh( RWStructuredBuffer< IndirectRender > buffer, uint bufferIndex, uint index, MeshSlot mesh, float4x4 transform )
+{
+  buffer[ index ].worldTransform = transform;
+  buffer[ index ].ibIndex        = mesh.ibIndex;
+  buffer[ index ].vbIndex        = mesh.vbIndex;
+  buffer[ index ].materialIndex  = mesh.materialIndex;
+  buffer[ index ].modelId        = index | ( bufferIndex << 13 );
+  buffer[ index ].randomValues   = mesh.randomValues;
+
+  buffer[ index ].vertexCountPerInstance = mesh.indexCount;
+  buffer[ index ].instanceCount          = 1;
+  buffer[ index ].startVertexLocation    = 0;
+  buffer[ index ].startInstanceLocation  = 0;
+}
+
+// Scene/HiZPyramid.cpp does the same test on the CPU, keep the two in sync.
+bool IsOccludedByHiZ( float4x4 mvp, float4 center, float4 extents, uint2 depthSize )
+{
+  float3 ndcMin =  INF;
+  float3 ndcMax = -INF;
+
+  [unroll]
+  for ( int corner = 0; corner < 8; ++corner )
+  {
+    float4 offset = float4( corner & 1 ? extents.x : -extents.x
+                          , corner & 2 ? extents.y : -extents.y
+                          , corner & 4 ? extents.z : -extents.z
+                          , 0 );
+
+    float4 clip = mul( mvp, center + offset );
+
+    // Boxes crossing the near plane are too close to be hidden.
+    if ( clip.w <= 0 )
+      return false;
+
+    float3 ndc = clip.xyz / clip.w;
+    ndcMin = min( ndcMin, ndc );
+    ndcMax = max( ndcMax, ndc );
+  }
+
+  // Off screen boxes are left for the frustum culling to decide.
+  if ( ndcMax.x < -1 || ndcMax.y < -1 || ndcMin.x > 1 || ndcMin.y > 1 )
+    return false;
+
+  float2 uvMin = saturate( float2( ndcMin.x, -ndcMax.y ) * 0.5 + 0.5 );
+  float2 uvMax = saturate( float2( ndcMax.x, -ndcMin.y ) * 0.5 + 0.5 );
+
+  int2 pixelMin = min( int2( uvMin * depthSize ), int2( depthSize ) - 1 );
+  int2 pixelMax = min( int2( uvMax * depthSize ), int2( depthSize ) - 1 );
+  int2 span     = pixelMax - pixelMin;
+
+  // Pick the level where the rectangle is at most 2x2 texels
+  int  level     = clamp( firstbithigh( max( max( span.x, span.y ), 1 ) ), 0, HiZLevelCount - 1 );
+  int2 levelSize = max( int2( depthSize ) >> ( level + 1 ), 1 );
+  int2 texelMin  = min( pixelMin >> ( level + 1 ), levelSize - 1 );
+  int2 texelMax  = min( pixelMax >> ( level + 1 ), levelSize - 1 );
+
+  // Too big for the smallest level, just let it through.
+  if ( any( texelMax - texelMin > 1 ) )
+    return false;
+
+  float d0 = hiZLevels[ NonUniformResourceIndex( level ) ].Load( int3( texelMin.x, texelMin.y, 0 ) );
+  float d1 = hiZLevels[ NonUniformResourceIndex( level ) ].Load( int3( texelMax.x, texelMin.y, 0 ) );
+  float d2 = hiZLevels[ NonUniformResourceIndex( level ) ].Load( int3( texelMin.x, texelMax.y, 0 ) );
+  float d3 = hiZLevels[ NonUniformResourceIndex( level ) ].Load( int3( texelMax.x, texelMax.y, 0 ) );
+
+  #if USE_REVERSE_PROJECTION
+    float farthest = min( min( d0, d1 ), min( d2, d3 ) );
+    return ndcMax.z < farthest;
+  #else
+    float farthest = max( max( d0, d1 ), max( d2, d3 ) );
+    return ndcMin.z > farthest;
+  #endif
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "../../ShaderValues.h"
+#include "Utils.hlsli"
+#include "Culling.hlsli"
+
+#define _RootSignature "RootFlags( 0 )," \
+                       "RootConstants( b0, num32BitConstants = 2 )," \
+                       "DescriptorTable( SRV( t0 ) )," \
+                       "DescriptorTable( SRV( t1 ) )," \
+                       "DescriptorTable( SRV( t0, space = 1, numDescriptors = " HiZLevelCountStr " ) )," \
+                       "DescriptorTable( UAV( u0 ) )," \
+                       "DescriptorTable( UAV( u1 ) )," \
+                       "DescriptorTable( UAV( u2 ) )," \
+                       "DescriptorTable( UAV( u3 ) )," \
+                       "DescriptorTable( UAV( u4 ) )," \
+                       "DescriptorTable( UAV( u5 ) )," \
+                       "DescriptorTable( UAV( u6 ) )," \
+                       "DescriptorTable( UAV( u7 ) )," \
+                       "DescriptorTable( UAV( u8 ) )," \
+                       "DescriptorTable( UAV( u9 ) )," \
+                       "DescriptorTable( UAV( u10 ) )," \
+                       "DescriptorTable( UAV( u11 ) )," \
+                       "DescriptorTable( UAV( u12 ) )," \
+
+cbuffer cb0 : register( b0 )
+{
+  uint2 depthSize;
+};
+
+StructuredBuffer< MeshSlot     > meshes    : register( t0 );
+StructuredBuffer< MaterialSlot > materials : register( t1 );
+
+RWStructuredBuffer< IndirectRender >     indirectOpaqueRender                        : register( u0 );
+RWStructuredBuffer< IndirectRender >     indirectOpaqueTwoSidedRender                : register( u1 );
+RWStructuredBuffer< IndirectRender >     indirectOpaqueAlphaTestedRender             : register( u2 );
+RWStructuredBuffer< IndirectRender >     indirectOpaqueTwoSidedAlphaTestedRender     : register( u3 );
+RWStructuredBuffer< IndirectRender >     indirectTranslucentRender                   : register( u4 );
+RWStructuredBuffer< IndirectRender >     indirectTranslucentTwoSidedRender           : register( u5 );
+RWStructuredBuffer< IndirectRender >     indirectLateOpaqueRender                    : register( u6 );
+RWStructuredBuffer< IndirectRender >     indirectLateOpaqueTwoSidedRender            : register( u7 );
+RWStructuredBuffer< IndirectRender >     indirectLateOpaqueAlphaTestedRender         : register( u8 );
+RWStructuredBuffer< IndirectRender >     indirectLateOpaqueTwoSidedAlphaTestedRender : register( u9 );
+RWByteAddressBuffer                      instanceCount                               : register( u10 );
+RWStructuredBuffer< FrameParams >        frameParams                                 : register( u11 );
+RWStructuredBuffer< OcclusionCandidate > occlusionCandidates                         : register( u12 );
+
+// The opaque meshes go to the main buffers too, so the geometry ids of the late meshes point to valid records.
+// The late buffers only hold copies of them, to draw them without redrawing what the early pass already did.
+void WriteLateMesh( RWStructuredBuffer< IndirectRender > buffer, RWStructuredBuffer< IndirectRender > lateBuffer, uint bufferIndex, uint countOffset, MeshSlot mesh, float4x4 transform )
+{
+  uint indirectIndex;
+  instanceCount.InterlockedAdd( countOffset, 1, indirectIndex );
+  WriteMesh( buffer, bufferIndex, indirectIndex, mesh, transform );
+
+  uint lateIndex;
+  instanceCount.InterlockedAdd( 28 + bufferIndex * 4, 1, lateIndex );
+  lateBuffer[ lateIndex ] = buffer[ indirectIndex ];
+}
+
+[RootSignature( _RootSignature )]
+[numthreads( CullingKernelWidth, 1, 1 )]
+void main( uint3 dispatchThreadID : SV_DispatchThreadID )
+{
+  if ( dispatchThreadID.x >= instanceCount.Load( 24 ) )
+    return;
+
+  OcclusionCandidate candidate = occlusionCandidates[ dispatchThreadID.x ];
+  MeshSlot           mesh      = meshes[ candidate.meshSlot ];
+
+  // The Hi-Z is built from this frame's depth at this point, so this is the same projection it was rendered with
+  if ( IsOccludedByHiZ( mul( frameParams[ 0 ].vpTransform, candidate.worldTransform ), mesh.aabbCenter, mesh.aabbExtents, depthSize ) )
+    return;
+
+  bool isOpaque      = ( materials[ mesh.materialIndex ].flags & MaterialSlot::Translucent ) == 0;
+  bool isTwoSided    = ( materials[ mesh.materialIndex ].flags & MaterialSlot::TwoSided ) != 0;
+  bool isAlphaTested = ( materials[ mesh.materialIndex ].flags & MaterialSlot::AlphaTested ) != 0;
+
+  [branch]
+  if ( isOpaque )
+  {
+    if ( isTwoSided )
+    {
+      if ( isAlphaTested )
+        WriteLateMesh( indirectOpaqueTwoSidedAlphaTestedRender, indirectLateOpaqueTwoSidedAlphaTestedRender, 3, 12, mesh, candidate.worldTransform );
+      else
+        WriteLateMesh( indirectOpaqueTwoSidedRender, indirectLateOpaqueTwoSidedRender, 1, 4, mesh, candidate.worldTransform );
+    }
+    else
+    {
+      if ( isAlphaTested )
+        WriteLateMesh( indirectOpaqueAlphaTestedRender, indirectLateOpaqueAlphaTestedRender, 2, 8, mesh, candidate.worldTransform );
+      else
+        WriteLateMesh( indirectOpaqueRender, indirectLateOpaqueRender, 0, 0, mesh, candidate.worldTransform );
+    }
+  }
+  else
+  {
+    // Translucent meshes are drawn after the depth pass, so they can go straight to the main buffers
+    uint indirectIndex;
+    if ( isTwoSided )
+    {
+      instanceCount.InterlockedAdd( 20, 1, indirectIndex );
+      WriteMesh( indirectTranslucentTwoSidedRender, 5, indirectIndex, mesh, candidate.worldTransform );
+    }
+    else
+    {
+      instanceCount.InterlockedAdd( 16, 1, indirectIndex );
+      WriteMesh( indirectTranslucentRender, 4, indirectIndex, mesh, candidate.worldTransform );
+    }
+  }
+}
\ No newline at end of file
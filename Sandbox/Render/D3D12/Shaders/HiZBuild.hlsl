@@ -0,0 +1,48 @@
+#include "../../ShaderValues.h"
+#include "Utils.hlsli"
+
+#define _RootSignature "RootFlags( 0 )," \
+                       "RootConstants( b0, num32BitConstants = 4 )," \
+                       "DescriptorTable( SRV( t0, flags = DATA_VOLATILE ) )," \
+                       "DescriptorTable( UAV( u0, flags = DATA_VOLATILE ) )," \
+
+cbuffer cb0 : register( b0 )
+{
+  uint2 sourceSize;
+  uint2 targetSize;
+};
+
+Texture2D< float >   source      : register( t0 );
+RWTexture2D< float > destination : register( u0 );
+
+float Farthest( float a, float b )
+{
+  #if USE_REVERSE_PROJECTION
+    return min( a, b );
+  #else
+    return max( a, b );
+  #endif
+}
+
+[RootSignature( _RootSignature )]
+[numthreads( HiZKernelWidth, HiZKernelHeight, 1 )]
+void main( uint3 dispatchThreadID : SV_DispatchThreadID )
+{
+  if ( any( dispatchThreadID.xy >= targetSize ) )
+    return;
+
+  // The last row and column also cover the texels left over by odd source sizes
+  uint2 first = min( dispatchThreadID.xy * 2, sourceSize - 1 );
+  uint2 last  = min( first + 1, sourceSize - 1 );
+  if ( dispatchThreadID.x == targetSize.x - 1 )
+    last.x = sourceSize.x - 1;
+  if ( dispatchThreadID.y == targetSize.y - 1 )
+    last.y = sourceSize.y - 1;
+
+  float farthest = source[ first ];
+  for ( uint y = first.y; y <= last.y; ++y )
+    for ( uint x = first.x; x <= last.x; ++x )
+      farthest = Farthest( farthest, source[ uint2( x, y ) ] );
+
+  destination[ dispatchThreadID.xy ] = farthest;
+}
\ No newline at end of file
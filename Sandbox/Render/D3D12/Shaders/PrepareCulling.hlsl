@@ -43,6 +43,13 @@ void main( uint3 dispatchThreadID : SV_DispatchThreadID )
     instanceCount.Store( 16, 0 );
     instanceCount.Store( 20, 0 );
 
+    // Occlusion candidates and the late opaque draws
+    instanceCount.Store( 24, 0 );
+    instanceCount.Store( 28, 0 );
+    instanceCount.Store( 32, 0 );
+    instanceCount.Store( 36, 0 );
+    instanceCount.Store( 40, 0 );
+
     frameParams[ 0 ].lightCount = 0;
   }
 
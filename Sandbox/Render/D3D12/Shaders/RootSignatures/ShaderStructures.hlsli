@@ -136,6 +136,13 @@ struct IndirectRender
   uint     startInstanceLocation;
 };
 
+struct OcclusionCandidate
+{
+  float4x4 worldTransform;
+  uint     meshSlot;
+  uint     padding[ 3 ];
+};
+
 struct FrameParams
 {
   matrix vpTransform;
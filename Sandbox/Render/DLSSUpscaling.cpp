@@ -6,7 +6,7 @@
 #include "D3D12/D3DDevice.h"
 #include "D3D12/D3DCommandList.h"
 #include "D3D12/D3DResource.h"
-#include "Halton.h"
+#include "LowDiscrepancy.h"
 
 #include "DLSS/Include/nvsdk_ngx.h"
 #include "DLSS/Include/nvsdk_ngx_helpers.h"
@@ -91,14 +91,13 @@ void DLSSUpscaling::Initialize( CommandList& commandList, Quality quality, int o
   jitterPhase = 0;
 
   int basePhaseCount = 8;
-  int baseValues[]   = { 2, 3 };
   jitterSequence.resize( size_t( basePhaseCount * pow( float( outputHeight ) / renderHeight, 2 ) ) );
 
   for ( int hi = 0; hi < int( jitterSequence.size() ); ++hi )
   {
-    auto vals = halton_base( hi + 1, 2, baseValues );
-    jitterSequence[ hi ].x = vals[ 0 ] - 0.5f;
-    jitterSequence[ hi ].y = vals[ 1 ] - 0.5f;
+    auto vals = LowDiscrepancy::Halton2D( hi + 1 );
+    jitterSequence[ hi ].x = vals.x - 0.5f;
+    jitterSequence[ hi ].y = vals.y - 0.5f;
   }
 
   commandList.BindHeaps();
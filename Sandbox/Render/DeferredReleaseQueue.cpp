@@ -0,0 +1,119 @@
+#include "DeferredReleaseQueue.h"
+
+static constexpr int initialCapacity = 256;
+
+DeferredReleaseBatch::~DeferredReleaseBatch()
+{
+  for ( auto& release : entries )
+    release.dispose( release.object, false );
+}
+
+DeferredReleaseQueue::DeferredReleaseQueue()
+{
+  ring.resize( initialCapacity );
+}
+
+DeferredReleaseQueue::~DeferredReleaseQueue()
+{
+  Clear();
+}
+
+void DeferredReleaseQueue::EnableBackgroundDestruction( const char* threadName )
+{
+  if ( background )
+    return;
+
+  background = true;
+
+  Start( []( DeferredReleaseBatch& batch )
+  {
+    for ( auto& release : batch.entries )
+      release.dispose( release.object, false );
+    batch.entries.clear();
+  }, threadName );
+}
+
+void DeferredReleaseQueue::Release( uint64_t fence, CComPtr< IUnknown >&& unknown )
+{
+  if ( unknown )
+    Push( { fence, unknown.Detach(), []( void* pointer, bool ) { static_cast< IUnknown* >( pointer )->Release(); }, false } );
+}
+
+void DeferredReleaseQueue::Release( uint64_t fence, eastl::function< void() >&& callback )
+{
+  auto stored = new eastl::function< void() >( eastl::move( callback ) );
+  Push( { fence, stored, []( void* pointer, bool invoke )
+  {
+    auto function = static_cast< eastl::function< void() >* >( pointer );
+    if ( invoke )
+      ( *function )();
+    delete function;
+  }, true } );
+}
+
+void DeferredReleaseQueue::Push( const DeferredRelease& release )
+{
+  int capacity = int( ring.size() );
+
+  assert( count == 0 || ring[ ( head + count - 1 ) & ( capacity - 1 ) ].fence <= release.fence );
+
+  if ( count == capacity )
+  {
+    eastl::vector< DeferredRelease > grown( capacity * 2 );
+    for ( int index = 0; index < count; ++index )
+      grown[ index ] = ring[ ( head + index ) & ( capacity - 1 ) ];
+
+    ring     = eastl::move( grown );
+    head     = 0;
+    capacity = int( ring.size() );
+  }
+
+  ring[ ( head + count ) & ( capacity - 1 ) ] = release;
+  ++count;
+}
+
+int DeferredReleaseQueue::Collect( uint64_t completedFence )
+{
+  int capacity = int( ring.size() );
+  int collected = 0;
+
+  DeferredReleaseBatch batch;
+
+  while ( count > 0 && ring[ head ].fence <= completedFence )
+  {
+    auto& release = ring[ head ];
+
+    if ( background && !release.callback )
+      batch.entries.push_back( release );
+    else
+      release.dispose( release.object, true );
+
+    head = ( head + 1 ) & ( capacity - 1 );
+    --count;
+    ++collected;
+  }
+
+  if ( !batch.entries.empty() )
+    Enqueue( eastl::move( batch ) );
+
+  return collected;
+}
+
+void DeferredReleaseQueue::Clear()
+{
+  int capacity = int( ring.size() );
+
+  for ( ; count > 0; --count )
+  {
+    auto& release = ring[ head ];
+    release.dispose( release.object, false );
+    head = ( head + 1 ) & ( capacity - 1 );
+  }
+
+  head = 0;
+}
+
+int DeferredReleaseQueue::GetCount() const
+{
+  return count;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Common/AsyncJobThread.h"
+
+struct DeferredRelease
+{
+  // Destroys the object. Callbacks are only invoked when asked, dropping them at shutdown.
+  using Dispose = void ( * )( void* object, bool invoke );
+
+  uint64_t fence;
+  void*    object;
+  Dispose  dispose;
+  bool     callback;
+};
+
+// Disposes whatever is left in it, so batches dropped by the release thread are not leaked.
+struct DeferredReleaseBatch
+{
+  DeferredReleaseBatch() = default;
+  DeferredReleaseBatch( DeferredReleaseBatch&& ) = default;
+  DeferredReleaseBatch& operator = ( DeferredReleaseBatch&& ) = default;
+  ~DeferredReleaseBatch();
+
+  eastl::vector< DeferredRelease > entries;
+};
+
+// Objects released on one queue, destroyed once the fence they were released with completes.
+// Fences only grow on a queue, so the entries are kept in a ring in release order, and collecting
+// stops at the first one the GPU isn't done with.
+class DeferredReleaseQueue : public AsyncJobThread< DeferredReleaseBatch >
+{
+public:
+  DeferredReleaseQueue();
+  ~DeferredReleaseQueue();
+
+  // Destroys the released objects on a worker thread. Callbacks still run in Collect.
+  void EnableBackgroundDestruction( const char* threadName );
+
+  template< typename T >
+  void Release( uint64_t fence, eastl::unique_ptr< T >&& object )
+  {
+    if ( object )
+      Push( { fence, object.release(), []( void* pointer, bool ) { delete static_cast< T* >( pointer ); }, false } );
+  }
+
+  void Release( uint64_t fence, CComPtr< IUnknown >&& unknown );
+  void Release( uint64_t fence, eastl::function< void() >&& callback );
+
+  // Returns the number of entries disposed or handed to the worker thread.
+  int Collect( uint64_t completedFence );
+
+  // Disposes everything without invoking the callbacks. The GPU has to be idle.
+  void Clear();
+
+  int GetCount() const;
+
+private:
+  void Push( const DeferredRelease& release );
+
+  eastl::vector< DeferredRelease > ring;
+  int                              head  = 0;
+  int                              count = 0;
+
+  bool background = false;
+};
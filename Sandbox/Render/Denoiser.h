@@ -44,4 +44,5 @@ struct Denoiser
                                , bool enableValidation ) = 0;
 };
 
-eastl::unique_ptr< Denoiser > CreateDenoiser( Device& device, CommandQueue& directQueue, CommandList& commandList, int width, int height );
\ No newline at end of file
+eastl::unique_ptr< Denoiser > CreateDenoiser( Device& device, CommandQueue& directQueue, CommandList& commandList, int width, int height );
+eastl::unique_ptr< Denoiser > CreateNullDenoiser();
\ No newline at end of file
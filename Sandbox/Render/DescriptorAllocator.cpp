@@ -0,0 +1,221 @@
+#include "DescriptorAllocator.h"
+
+static int FloorLog2( uint32_t value )
+{
+  unsigned long index;
+  _BitScanReverse( &index, value );
+  return int( index );
+}
+
+static int CeilLog2( uint32_t value )
+{
+  return value > 1 ? FloorLog2( value - 1 ) + 1 : 0;
+}
+
+static int LowestBit( uint32_t value )
+{
+  unsigned long index;
+  _BitScanForward( &index, value );
+  return int( index );
+}
+
+DescriptorAllocator::DescriptorAllocator( int base, int capacity )
+  : base( base )
+{
+  for ( auto& head : classHeads )
+    head = -1;
+
+  Grow( capacity );
+}
+
+int DescriptorAllocator::Allocate( int count )
+{
+  assert( count > 0 );
+
+  int start = -1;
+
+  // Every range in a class at least as large as the rounded up count fits, take the smallest such class.
+  int  sizeClass = CeilLog2( count );
+  auto fitting   = sizeClass < classCount ? classMask & ~( ( 1U << sizeClass ) - 1 ) : 0;
+  if ( fitting )
+    start = classHeads[ LowestBit( fitting ) ];
+  else if ( sizeClass > 0 )
+  {
+    // Near full, the class below can still hold a range which is large enough.
+    for ( int candidate = classHeads[ sizeClass - 1 ]; candidate >= 0; candidate = nextRange[ candidate ] )
+    {
+      if ( rangeSize[ candidate ] >= count )
+      {
+        start = candidate;
+        break;
+      }
+    }
+  }
+
+  if ( start < 0 )
+    return -1;
+
+  int size = rangeSize[ start ];
+  RemoveRange( start );
+  if ( size > count )
+    InsertRange( start + count, size - count );
+
+  for ( int slot = start; slot < start + count; ++slot )
+    freeSlots[ slot ] = 0;
+
+  used += count;
+  return base + start;
+}
+
+bool DescriptorAllocator::AllocateAt( int slot )
+{
+  assert( Contains( slot ) );
+
+  int local = slot - base;
+  if ( !freeSlots[ local ] )
+    return false;
+
+  // Everything between the slot and the start of its range is free, and the fixed slots
+  // are mostly taken in order, so this stops right away.
+  int start = local;
+  while ( rangeSize[ start ] == 0 )
+    --start;
+
+  int size = rangeSize[ start ];
+  RemoveRange( start );
+  if ( local > start )
+    InsertRange( start, local - start );
+  if ( start + size > local + 1 )
+    InsertRange( local + 1, start + size - local - 1 );
+
+  freeSlots[ local ] = 0;
+  ++used;
+  return true;
+}
+
+void DescriptorAllocator::Free( int slot, int count )
+{
+  assert( Contains( slot ) && Contains( slot + count - 1 ) );
+
+  ReleaseRange( slot - base, count );
+  used -= count;
+}
+
+void DescriptorAllocator::Grow( int newCapacity )
+{
+  assert( newCapacity >= capacity );
+  if ( newCapacity == capacity )
+    return;
+
+  rangeSize.resize( newCapacity, 0 );
+  rangeStart.resize( newCapacity, -1 );
+  nextRange.resize( newCapacity, -1 );
+  prevRange.resize( newCapacity, -1 );
+  freeSlots.resize( newCapacity, 0 );
+
+  int oldCapacity = capacity;
+  capacity = newCapacity;
+
+  ReleaseRange( oldCapacity, newCapacity - oldCapacity );
+}
+
+bool DescriptorAllocator::Contains( int slot ) const
+{
+  return slot >= base && slot < base + capacity;
+}
+
+bool DescriptorAllocator::IsFree( int slot ) const
+{
+  return Contains( slot ) && freeSlots[ slot - base ];
+}
+
+int DescriptorAllocator::GetBase() const
+{
+  return base;
+}
+
+int DescriptorAllocator::GetCapacity() const
+{
+  return capacity;
+}
+
+DescriptorAllocator::Stats DescriptorAllocator::GetStats() const
+{
+  Stats stats = {};
+  stats.capacity = capacity;
+  stats.used     = used;
+
+  for ( int sizeClass = 0; sizeClass < classCount; ++sizeClass )
+  {
+    for ( int start = classHeads[ sizeClass ]; start >= 0; start = nextRange[ start ] )
+    {
+      stats.largestFree = eastl::max( stats.largestFree, rangeSize[ start ] );
+      ++stats.freeRanges;
+    }
+  }
+
+  return stats;
+}
+
+void DescriptorAllocator::InsertRange( int start, int size )
+{
+  int sizeClass = FloorLog2( size );
+
+  rangeSize [ start ]            = size;
+  rangeStart[ start + size - 1 ] = start;
+  prevRange [ start ]            = -1;
+  nextRange [ start ]            = classHeads[ sizeClass ];
+
+  if ( classHeads[ sizeClass ] >= 0 )
+    prevRange[ classHeads[ sizeClass ] ] = start;
+
+  classHeads[ sizeClass ] = start;
+  classMask |= 1U << sizeClass;
+}
+
+void DescriptorAllocator::RemoveRange( int start )
+{
+  int size      = rangeSize[ start ];
+  int sizeClass = FloorLog2( size );
+
+  if ( prevRange[ start ] >= 0 )
+    nextRange[ prevRange[ start ] ] = nextRange[ start ];
+  else
+    classHeads[ sizeClass ] = nextRange[ start ];
+
+  if ( nextRange[ start ] >= 0 )
+    prevRange[ nextRange[ start ] ] = prevRange[ start ];
+
+  if ( classHeads[ sizeClass ] < 0 )
+    classMask &= ~( 1U << sizeClass );
+
+  rangeSize [ start ]            = 0;
+  rangeStart[ start + size - 1 ] = -1;
+}
+
+void DescriptorAllocator::ReleaseRange( int start, int size )
+{
+  for ( int slot = start; slot < start + size; ++slot )
+  {
+    assert( !freeSlots[ slot ] );
+    freeSlots[ slot ] = 1;
+  }
+
+  // Merge with the free neighbours, so the ranges stay as large as possible.
+  int end = start + size;
+  if ( end < capacity && rangeSize[ end ] > 0 )
+  {
+    size += rangeSize[ end ];
+    RemoveRange( end );
+  }
+
+  if ( start > 0 && rangeStart[ start - 1 ] >= 0 )
+  {
+    int left = rangeStart[ start - 1 ];
+    size += rangeSize[ left ];
+    start = left;
+    RemoveRange( left );
+  }
+
+  InsertRange( start, size );
+}
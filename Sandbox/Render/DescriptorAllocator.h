@@ -0,0 +1,62 @@
+#pragma once
+
+// Hands out contiguous slot ranges of a descriptor heap region. Free ranges are kept in
+// segregated lists by the power of two class of their size, with a bitmask of the non empty
+// classes, so finding a fitting range and freeing one with coalescing are constant time.
+// It only deals with indices, the heap owns the descriptors themselves.
+class DescriptorAllocator
+{
+public:
+  struct Stats
+  {
+    int capacity;
+    int used;
+    int largestFree;
+    int freeRanges;
+  };
+
+  DescriptorAllocator( int base, int capacity );
+
+  // Returns the first slot of the range, or -1 if no free range is large enough.
+  int Allocate( int count = 1 );
+
+  // Takes a given slot, for the fixed slots of the engine textures. Returns false if it is taken.
+  bool AllocateAt( int slot );
+
+  // The range is reusable right away. Descriptors are owned by resources, which are only
+  // destroyed once the GPU is done with them, so there is no need to hold the slots here.
+  void Free( int slot, int count = 1 );
+
+  // Adds slots at the end of the region.
+  void Grow( int newCapacity );
+
+  bool Contains( int slot ) const;
+  bool IsFree( int slot ) const;
+
+  int GetBase() const;
+  int GetCapacity() const;
+
+  Stats GetStats() const;
+
+private:
+  static constexpr int classCount = 32;
+
+  void InsertRange( int start, int size );
+  void RemoveRange( int start );
+  void ReleaseRange( int start, int size );
+
+  int base     = 0;
+  int capacity = 0;
+  int used     = 0;
+
+  // Indexed by the region relative slot. Size and links are only valid at the start of a free range,
+  // rangeStart only at its last slot.
+  eastl::vector< int >     rangeSize;
+  eastl::vector< int >     rangeStart;
+  eastl::vector< int >     nextRange;
+  eastl::vector< int >     prevRange;
+  eastl::vector< uint8_t > freeSlots;
+
+  int      classHeads[ classCount ];
+  uint32_t classMask = 0;
+};
@@ -13,5 +13,9 @@ struct DescriptorHeap
   virtual eastl::unique_ptr< ResourceDescriptor > RequestDescriptorFromSlot( Device& device, ResourceDescriptorType type, int slot, Resource& resource, int bufferElementSize, int mipLevel = 0 ) = 0;
   virtual eastl::unique_ptr< ResourceDescriptor > RequestDescriptorAuto( Device& device, ResourceDescriptorType type, int base, Resource& resource, int bufferElementSize, int mipLevel = 0 ) = 0;
 
+  // One descriptor for each resource, in contiguous slots of the region of base, for the descriptor tables covering
+  // more than one of them. Each descriptor frees its own slot.
+  virtual eastl::vector< eastl::unique_ptr< ResourceDescriptor > > RequestDescriptorRangeAuto( Device& device, ResourceDescriptorType type, int base, eastl::initializer_list< eastl::reference_wrapper< Resource > > resources, int bufferElementSize ) = 0;
+
   virtual int GetDescriptorSize() const = 0;
 };
\ No newline at end of file
@@ -17,6 +17,10 @@ struct ComputeShader;
 struct GPUTimeQuery;
 struct TFFHeader;
 struct FileLoaderFile;
+struct ShaderBinary;
+
+class UploadPagePool;
+class GPUPassStatistics;
 
 struct Device
 {
@@ -42,6 +46,7 @@ struct Device
   virtual eastl::unique_ptr< Resource >                 Create2DTexture( CommandList* commandList, int width, int height, const void* data, int dataSize, PixelFormat format, int samples, int sampleQuality, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName ) = 0;
   virtual eastl::unique_ptr< Resource >                 CreateCubeTexture( CommandList* commandList, int width, const void* data, int dataSize, PixelFormat format, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName ) = 0;
   virtual eastl::unique_ptr< Resource >                 CreateReserved2DTexture( int width, int height, PixelFormat format, int slot, bool mipLevels, const wchar_t* debugName ) = 0;
+  virtual eastl::unique_ptr< Resource >                 CreatePlaced2DTexture( MemoryHeap& heap, uint64_t offset, int width, int height, PixelFormat format, int slot, int uavSlot, const wchar_t* debugName ) = 0;
   virtual eastl::unique_ptr< ComputeShader >            CreateComputeShader( const void* shaderData, int shaderSize, const wchar_t* debugName ) = 0;
   virtual eastl::unique_ptr< MemoryHeap >               CreateMemoryHeap( uint64_t size, const wchar_t* debugName ) = 0;
   virtual eastl::unique_ptr< GPUTimeQuery >             CreateGPUTimeQuery() = 0;
@@ -49,8 +54,8 @@ struct Device
   virtual void PreallocateTiles( CommandQueue& directQueue ) = 0;
 
   virtual eastl::unique_ptr< RTShaders > CreateRTShaders( CommandList& commandList
-                                                      , const eastl::vector< uint8_t >& rootSignatureShaderBinary
-                                                      , const eastl::vector< uint8_t >& shaderBinary
+                                                      , const ShaderBinary& rootSignatureShaderBinary
+                                                      , const ShaderBinary& shaderBinary
                                                       , const wchar_t* rayGenEntryName
                                                       , const wchar_t* missEntryName
                                                       , const wchar_t* anyHitEntryName
@@ -60,8 +65,8 @@ struct Device
                                                       , int maxRecursionDepth ) = 0;
 
 
-  virtual eastl::unique_ptr< Resource > Load2DTexture( CommandList& commandList, eastl::vector< uint8_t >&& textureData, int slot, const wchar_t* debugName ) = 0;
-  virtual eastl::unique_ptr< Resource > LoadCubeTexture( CommandList& commandList, eastl::vector< uint8_t >&& textureData, int slot, const wchar_t* debugName ) = 0;
+  virtual eastl::unique_ptr< Resource > Load2DTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName ) = 0;
+  virtual eastl::unique_ptr< Resource > LoadCubeTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName ) = 0;
 
   virtual eastl::unique_ptr< Resource > Stream2DTexture( CommandQueue& directQueue
                                                        , CommandList& commandList
@@ -72,11 +77,20 @@ struct Device
 
   virtual eastl::unique_ptr< Resource > AllocateUploadBuffer( int dataSize, const wchar_t* resourceName = nullptr ) = 0;
 
+  virtual UploadPagePool& GetUploadPagePool() = 0;
+
+  // GPU sections of direct command lists are timed, this resolves the frame's timestamps into the statistics.
+  virtual GPUPassStatistics& GetGPUPassStatistics() = 0;
+  virtual void ResolveGPUTimestamps( CommandList& commandList ) = 0;
+
   virtual DescriptorHeap& GetShaderResourceHeap() = 0;
   virtual DescriptorHeap& GetSamplerHeap() = 0;
 
   virtual int GetUploadSizeForResource( Resource& resource ) = 0;
 
+  // The heap memory a texture made by CreatePlaced2DTexture takes.
+  virtual uint64_t GetPlaced2DTextureSize( int width, int height, PixelFormat format ) = 0;
+
   virtual void SetTextureLODBias( float bias ) = 0;
 
   virtual void StartNewFrame() = 0;
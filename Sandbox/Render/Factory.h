@@ -10,6 +10,9 @@ struct Factory
 {
   static eastl::unique_ptr< Factory > Create();
 
+  // Headless backend, records the command lists without a GPU.
+  static eastl::unique_ptr< Factory > CreateNull();
+
   virtual ~Factory() = default;
 
   virtual bool IsVRRSupported() const = 0;
@@ -0,0 +1,112 @@
+#include "GPUPassStatistics.h"
+
+GPUPassStatistics::GPUPassStatistics( int historyLength )
+  : historyLength( historyLength )
+{
+}
+
+void GPUPassStatistics::AddSample( const wchar_t* name, double milliseconds )
+{
+  auto iter = passIndices.find_as( name );
+  if ( iter == passIndices.end() )
+  {
+    iter = passIndices.emplace( name, int( passes.size() ) ).first;
+
+    Pass pass;
+    pass.name = name;
+    pass.history.resize( historyLength );
+    passes.emplace_back( eastl::move( pass ) );
+  }
+
+  auto& pass = passes[ iter->second ];
+  pass.frameTotal += milliseconds;
+  pass.recorded    = true;
+}
+
+void GPUPassStatistics::EndFrame()
+{
+  for ( auto& pass : passes )
+  {
+    if ( !pass.recorded )
+      continue;
+
+    pass.history[ pass.next ] = float( pass.frameTotal );
+    pass.next       = ( pass.next + 1 ) % historyLength;
+    pass.count      = eastl::min( pass.count + 1, historyLength );
+    pass.frameTotal = 0;
+    pass.recorded   = false;
+    pass.lastFrame  = frameIndex;
+  }
+
+  ++frameIndex;
+
+  auto stale = eastl::remove_if( passes.begin(), passes.end(), [ this ]( const Pass& pass ) { return frameIndex - pass.lastFrame > historyLength; } );
+  if ( stale != passes.end() )
+  {
+    passes.erase( stale, passes.end() );
+
+    passIndices.clear();
+    for ( int passIx = 0; passIx < int( passes.size() ); ++passIx )
+      passIndices.emplace( passes[ passIx ].name, passIx );
+  }
+}
+
+eastl::vector< GPUPassStatistics::PassStats > GPUPassStatistics::GetStats() const
+{
+  eastl::vector< PassStats > stats;
+  eastl::vector< float >     sorted;
+
+  for ( auto& pass : passes )
+  {
+    if ( pass.count == 0 )
+      continue;
+
+    sorted.assign( pass.history.begin(), pass.history.begin() + pass.count );
+    eastl::sort( sorted.begin(), sorted.end() );
+
+    double sum = 0;
+    for ( auto sample : sorted )
+      sum += sample;
+
+    // Nearest rank percentiles.
+    auto percentile = [ & ]( double fraction ) { return double( sorted[ eastl::max( int( ceil( fraction * pass.count ) ) - 1, 0 ) ] ); };
+
+    PassStats passStats;
+    passStats.name    = pass.name;
+    passStats.average = sum / pass.count;
+    passStats.median  = percentile( 0.5 );
+    passStats.p95     = percentile( 0.95 );
+    passStats.max     = sorted.back();
+    passStats.samples = pass.count;
+    stats.emplace_back( eastl::move( passStats ) );
+  }
+
+  return stats;
+}
+
+bool GPUPassStatistics::WriteCSV( const wchar_t* path ) const
+{
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, path, L"wb" ) )
+    return false;
+
+  fprintf( fileHandle, "pass,average_ms,median_ms,p95_ms,max_ms,samples\n" );
+
+  for ( auto& passStats : GetStats() )
+  {
+    // Pass names are free text, so they are quoted.
+    auto name = N( passStats.name.data() );
+    eastl::string quoted;
+    for ( auto c : name )
+    {
+      if ( c == '"' )
+        quoted.push_back( '"' );
+      quoted.push_back( c );
+    }
+
+    fprintf( fileHandle, "\"%s\",%.4f,%.4f,%.4f,%.4f,%d\n", quoted.data(), passStats.average, passStats.median, passStats.p95, passStats.max, passStats.samples );
+  }
+
+  fclose( fileHandle );
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+// Rolling GPU time statistics of the passes, fed with the resolved timestamps of each frame.
+// Passes recorded more than once in a frame are summed. It knows nothing about the queries,
+// so it can be fed with any timings.
+class GPUPassStatistics
+{
+public:
+  static constexpr int DefaultHistoryLength = 120;
+
+  struct PassStats
+  {
+    eastl::wstring name;
+    double         average;
+    double         median;
+    double         p95;
+    double         max;
+    int            samples;
+  };
+
+  GPUPassStatistics( int historyLength = DefaultHistoryLength );
+
+  void AddSample( const wchar_t* name, double milliseconds );
+
+  // Closes the frame. Passes which were not recorded for a whole history are dropped.
+  void EndFrame();
+
+  // In the order the passes were first seen, which is mostly the frame order.
+  eastl::vector< PassStats > GetStats() const;
+
+  bool WriteCSV( const wchar_t* path ) const;
+
+private:
+  struct Pass
+  {
+    eastl::wstring         name;
+    eastl::vector< float > history;
+    int                    next       = 0;
+    int                    count      = 0;
+    double                 frameTotal = 0;
+    bool                   recorded   = false;
+    int                    lastFrame  = 0;
+  };
+
+  int historyLength;
+  int frameIndex = 0;
+
+  eastl::vector< Pass >                  passes;
+  eastl::vector_map< eastl::wstring, int > passIndices;
+};
\ No newline at end of file
@@ -0,0 +1,180 @@
+#pragma once
+
+// Halton, R2, Sobol and Owen scrambled Sobol sequences. Every function is stateless, so any thread
+// can sample them, and constexpr.
+// Sobol values are 32 bit fixed point, ToUnitFloat turns them into [0,1).
+namespace LowDiscrepancy
+{
+  static constexpr int HaltonMaxDimension = 8;
+  static constexpr int SobolMaxDimension  = 8;
+
+  static constexpr uint32_t haltonBases[ HaltonMaxDimension ] = { 2, 3, 5, 7, 11, 13, 17, 19 };
+
+  // 2^32 / g and 2^32 / g^2, where g is the plastic number.
+  static constexpr uint32_t r2AlphaX = 0xC13FA9A9;
+  static constexpr uint32_t r2AlphaY = 0x91E10DA6;
+
+  constexpr float ToUnitFloat( uint32_t value )
+  {
+    return float( value >> 8 ) * ( 1.0f / ( 1 << 24 ) );
+  }
+
+  constexpr uint32_t ReverseBits( uint32_t value )
+  {
+    value = ( value << 16 ) | ( value >> 16 );
+    value = ( ( value & 0x00FF00FF ) << 8 ) | ( ( value & 0xFF00FF00 ) >> 8 );
+    value = ( ( value & 0x0F0F0F0F ) << 4 ) | ( ( value & 0xF0F0F0F0 ) >> 4 );
+    value = ( ( value & 0x33333333 ) << 2 ) | ( ( value & 0xCCCCCCCC ) >> 2 );
+    value = ( ( value & 0x55555555 ) << 1 ) | ( ( value & 0xAAAAAAAA ) >> 1 );
+    return value;
+  }
+
+  constexpr float RadicalInverse( uint32_t index, uint32_t base )
+  {
+    double inverseBase = 1.0 / base;
+    double factor      = inverseBase;
+    double result      = 0;
+    while ( index > 0 )
+    {
+      result += ( index % base ) * factor;
+      index  /= base;
+      factor *= inverseBase;
+    }
+
+    // Stays below one after the rounding to float.
+    return result < 0.99999994 ? float( result ) : 0.99999994f;
+  }
+
+  constexpr float Halton( uint32_t index, int dimension )
+  {
+    assert( dimension < HaltonMaxDimension );
+    return dimension == 0 ? ToUnitFloat( ReverseBits( index ) ) : RadicalInverse( index, haltonBases[ dimension ] );
+  }
+
+  constexpr XMFLOAT2 Halton2D( uint32_t index )
+  {
+    return XMFLOAT2( Halton( index, 0 ), Halton( index, 1 ) );
+  }
+
+  constexpr XMFLOAT2 R2( uint32_t index )
+  {
+    return XMFLOAT2( ToUnitFloat( 0x80000000u + index * r2AlphaX ), ToUnitFloat( 0x80000000u + index * r2AlphaY ) );
+  }
+
+  struct SobolDirections
+  {
+    uint32_t v[ 32 ];
+  };
+
+  // From the primitive polynomial of degree s with coefficients a and the initial m values.
+  constexpr SobolDirections MakeSobolDirections( int s, uint32_t a, const uint32_t ( &m )[ 5 ] )
+  {
+    SobolDirections directions = {};
+    if ( s == 0 )
+    {
+      for ( int bit = 0; bit < 32; ++bit )
+        directions.v[ bit ] = 1u << ( 31 - bit );
+      return directions;
+    }
+
+    for ( int bit = 0; bit < s; ++bit )
+      directions.v[ bit ] = m[ bit ] << ( 31 - bit );
+
+    for ( int bit = s; bit < 32; ++bit )
+    {
+      auto value = directions.v[ bit - s ] ^ ( directions.v[ bit - s ] >> s );
+      for ( int k = 1; k < s; ++k )
+        value ^= ( ( a >> ( s - 1 - k ) ) & 1 ) * directions.v[ bit - k ];
+      directions.v[ bit ] = value;
+    }
+
+    return directions;
+  }
+
+  // The first dimensions of the Joe-Kuo new-joe-kuo-6.21201 set.
+  static constexpr SobolDirections sobolDirections[ SobolMaxDimension ] =
+  {
+    MakeSobolDirections( 0, 0, { 0 } ),
+    MakeSobolDirections( 1, 0, { 1 } ),
+    MakeSobolDirections( 2, 1, { 1, 3 } ),
+    MakeSobolDirections( 3, 1, { 1, 3, 1 } ),
+    MakeSobolDirections( 3, 2, { 1, 1, 1 } ),
+    MakeSobolDirections( 4, 1, { 1, 1, 3, 3 } ),
+    MakeSobolDirections( 4, 4, { 1, 3, 5, 13 } ),
+    MakeSobolDirections( 5, 2, { 1, 1, 5, 5, 17 } ),
+  };
+
+  constexpr uint32_t Sobol( uint32_t index, int dimension )
+  {
+    assert( dimension < SobolMaxDimension );
+
+    uint32_t result = 0;
+    for ( int bit = 0; index; index >>= 1, ++bit )
+      if ( index & 1 )
+        result ^= sobolDirections[ dimension ].v[ bit ];
+    return result;
+  }
+
+  // Chris Wellons' lowbias32.
+  constexpr uint32_t Hash( uint32_t value )
+  {
+    value ^= value >> 16;
+    value *= 0x7FEB352D;
+    value ^= value >> 15;
+    value *= 0x846CA68B;
+    value ^= value >> 16;
+    return value;
+  }
+
+  constexpr uint32_t HashCombine( uint32_t seed, uint32_t value )
+  {
+    return seed ^ ( value + 0x9E3779B9 + ( seed << 6 ) + ( seed >> 2 ) );
+  }
+
+  // Nested uniform scramble with the Laine-Karras permutation, as in Burley's practical hash based
+  // Owen scrambling.
+  constexpr uint32_t NestedUniformScramble( uint32_t value, uint32_t seed )
+  {
+    value  = ReverseBits( value );
+    value += seed;
+    value ^= value * 0x6C50B47C;
+    value ^= value * 0xB82F1E52;
+    value ^= value * 0xC7AFE638;
+    value ^= value * 0x8D22F6E6;
+    return ReverseBits( value );
+  }
+
+  // The index is shuffled too, so every seed gives a different, still stratified, sequence.
+  constexpr uint32_t OwenSobol( uint32_t index, int dimension, uint32_t seed )
+  {
+    auto shuffledIndex = NestedUniformScramble( index, seed );
+    return NestedUniformScramble( Sobol( shuffledIndex, dimension ), HashCombine( seed, uint32_t( dimension ) ) );
+  }
+
+  // The layout of sobol_256_4d.dds: RGBA8, one texel per sample, each channel a dimension.
+  inline eastl::vector< uint8_t > BuildSobolTable( int sampleCount, uint32_t seed )
+  {
+    eastl::vector< uint8_t > table( sampleCount * 4 );
+    for ( int sampleIx = 0; sampleIx < sampleCount; ++sampleIx )
+      for ( int dimension = 0; dimension < 4; ++dimension )
+        table[ sampleIx * 4 + dimension ] = uint8_t( OwenSobol( sampleIx, dimension, seed ) >> 24 );
+    return table;
+  }
+
+  // The layout of scrambling_ranking_128x128_2d_1spp.dds: RGBA8, xy is the scrambling of the pixel
+  // and z its ranking key. These are hashed per pixel, so unlike the optimized file the error is
+  // not distributed as blue noise.
+  inline eastl::vector< uint8_t > BuildScramblingRankingTable( int size, uint32_t seed )
+  {
+    eastl::vector< uint8_t > table( size * size * 4 );
+    for ( int pixelIx = 0; pixelIx < size * size; ++pixelIx )
+    {
+      auto hash = Hash( HashCombine( seed, uint32_t( pixelIx ) ) );
+      table[ pixelIx * 4 + 0 ] = uint8_t( hash );
+      table[ pixelIx * 4 + 1 ] = uint8_t( hash >> 8 );
+      table[ pixelIx * 4 + 2 ] = uint8_t( hash >> 16 );
+      table[ pixelIx * 4 + 3 ] = 0;
+    }
+    return table;
+  }
+}
\ No newline at end of file
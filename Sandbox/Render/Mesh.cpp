@@ -48,11 +48,18 @@ Mesh::Mesh( CommandList& commandList
   modelMetaSlot.indexBufferIndex  = ibSlot - SceneBufferResourceBaseSlot;
   modelMetaSlot.vertexBufferIndex = vbSlot - SceneBufferResourceBaseSlot;
 
-  commandList.UpdateBufferRegion( CreateBufferFromData( &modelMetaSlot, 1, ResourceType::Buffer, device, commandList, L"modelMetaSlot" ), modelMetaBuffer, sizeof( ModelMetaSlot ) * modelMetaIndex );
+  commandList.UpdateBufferRegion( modelMetaBuffer, sizeof( ModelMetaSlot ) * modelMetaIndex, &modelMetaSlot, sizeof( modelMetaSlot ) );
 
   blas = device.CreateRTBottomLevelAccelerator( commandList, *vertexBuffer, vertexCount, sizeof( uint16_t ) * 8, sizeof( VertexFormat ), *indexBuffer, sizeof( uint32_t ) * 8, indexCount, modelMetaIndex, opaque, false, false );
 }
 
+Mesh::Mesh( const BoundingBox& aabb, int indexCount, int materialIndex )
+: indexCount   ( indexCount )
+, materialIndex( materialIndex )
+, aabb         ( aabb )
+{
+}
+
 Mesh::~Mesh()
 {
 }
@@ -111,4 +118,5 @@ void Mesh::Dispose( CommandList& commandList )
 {
   commandList.HoldResource( eastl::move( vertexBuffer ) );
   commandList.HoldResource( eastl::move( indexBuffer ) );
+  commandList.HoldResource( eastl::move( blas ) );
 }
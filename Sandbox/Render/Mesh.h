@@ -25,6 +25,11 @@ public:
       , int modelMetaIndex
       , const BoundingBox& aabb
       , const char* debugName );
+
+  // Only the bounds, without buffers and descriptors. SceneStore and the CPU culling need nothing else, the tests
+  // build their scenes of these.
+  Mesh( const BoundingBox& aabb, int indexCount, int materialIndex );
+
   ~Mesh();
 
   bool HasTranslucent() const;
@@ -42,6 +47,7 @@ public:
 
   const BoundingBox& GetAABB() const;
 
+  // Hands the buffers and the bottom level structure to the command list, to be released when the GPU is done.
   void Dispose( CommandList& commandList );
 
 private:
@@ -0,0 +1,15 @@
+#include "NullAdapter.h"
+#include "NullDevice.h"
+
+NullAdapter::NullAdapter()
+{
+}
+
+NullAdapter::~NullAdapter()
+{
+}
+
+eastl::unique_ptr< Device > NullAdapter::CreateDevice()
+{
+  return eastl::unique_ptr< Device >( new NullDevice );
+}
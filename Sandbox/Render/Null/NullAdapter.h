@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../Adapter.h"
+
+class NullAdapter : public Adapter
+{
+  friend class NullFactory;
+
+public:
+  ~NullAdapter();
+
+  eastl::unique_ptr< Device > CreateDevice() override;
+
+private:
+  NullAdapter();
+};
\ No newline at end of file
@@ -0,0 +1,511 @@
+#include "NullCommandList.h"
+#include "NullDevice.h"
+#include "NullResource.h"
+#include "../RTTopLevelAccelerator.h"
+#include "../RTBottomLevelAccelerator.h"
+
+// Same as the D3D lists, so the upload pages fill up the same way.
+static constexpr int uploadAlignment = 16;
+
+void NullCommandStats::Add( const NullCommandStats& other )
+{
+  for ( int typeIx = 0; typeIx < int( NullCommand::Type::Count ); ++typeIx )
+    counts[ typeIx ] += other.counts[ typeIx ];
+
+  commandListCount += other.commandListCount;
+}
+
+NullCommandList::NullCommandList( NullDevice& device, CommandQueueType queueType )
+  : queueType( queueType )
+  , uploadAllocator( device.GetUploadPagePool() )
+  , device( device )
+{
+}
+
+NullCommandList::~NullCommandList()
+{
+}
+
+void NullCommandList::Record( NullCommand::Type type, const void* object, int arg0, int arg1, int arg2, int arg3, bool compute )
+{
+  commands.push_back( { type, compute, object, { arg0, arg1, arg2, arg3 } } );
+}
+
+void NullCommandList::Transition( Resource& resource, ResourceState newState )
+{
+  auto& nullResource = static_cast< NullResource& >( resource );
+  if ( nullResource.resourceState.bits == newState.bits )
+    return;
+
+  Record( NullCommand::Type::Barrier, &resource, int( nullResource.resourceState.bits ), int( newState.bits ) );
+  nullResource.resourceState = newState;
+}
+
+void NullCommandList::WriteMemory( Resource& destination, int offset, const void* data, int dataSize )
+{
+  auto& memory = static_cast< NullResource& >( destination ).GetMemory();
+  assert( offset >= 0 && offset + dataSize <= int( memory.size() ) );
+  if ( offset >= 0 && offset + dataSize <= int( memory.size() ) )
+    memcpy( memory.data() + offset, data, dataSize );
+}
+
+void NullCommandList::BindHeaps()
+{
+}
+
+void NullCommandList::ChangeResourceState( Resource& resource, ResourceState newState )
+{
+  Transition( resource, newState );
+}
+
+void NullCommandList::ChangeResourceState( eastl::initializer_list< ResourceStateChange > resources )
+{
+  for ( auto& res : resources )
+    Transition( res.resource, res.newState );
+}
+
+void NullCommandList::AddBarriers( const ResourceBarrier* barriers, int count )
+{
+  for ( int barrierIx = 0; barrierIx < count; ++barrierIx )
+  {
+    auto& barrier      = barriers[ barrierIx ];
+    auto& nullResource = *static_cast< NullResource* >( barrier.resource );
+
+    if ( barrier.type == ResourceBarrier::Type::Aliasing )
+    {
+      Record( NullCommand::Type::AliasingBarrier, barrier.resource );
+      continue;
+    }
+
+    // The begin half doesn't change the tracked state, so the end half finds the same state here.
+    if ( nullResource.resourceState.bits == barrier.newState.bits )
+      continue;
+
+    Record( NullCommand::Type::Barrier, barrier.resource, int( nullResource.resourceState.bits ), int( barrier.newState.bits ), int( barrier.split ) );
+
+    if ( barrier.split != ResourceBarrier::Split::Begin )
+      nullResource.resourceState = barrier.newState;
+  }
+}
+
+void NullCommandList::ClearRenderTarget( Resource& texture, const Color& color )
+{
+  Record( NullCommand::Type::ClearRenderTarget, &texture );
+}
+
+void NullCommandList::ClearDepthStencil( Resource& texture, float depth )
+{
+  Record( NullCommand::Type::ClearDepthStencil, &texture );
+}
+
+void NullCommandList::ClearUnorderedAccess( Resource& resource, uint32_t values[ 4 ] )
+{
+  Record( NullCommand::Type::ClearUnorderedAccess, &resource, int( values[ 0 ] ) );
+
+  // Buffers are cleared with the first value, as the raw views of the D3D backend do.
+  if ( resource.GetBufferSize() > 0 )
+  {
+    auto& memory = static_cast< NullResource& >( resource ).GetMemory();
+    auto  words  = reinterpret_cast< uint32_t* >( memory.data() );
+    for ( size_t wordIx = 0; wordIx < memory.size() / 4; ++wordIx )
+      words[ wordIx ] = values[ 0 ];
+  }
+}
+
+void NullCommandList::SetPipelineState( PipelineState& pipelineState )
+{
+  Record( NullCommand::Type::SetPipelineState, &pipelineState );
+}
+
+void NullCommandList::SetComputeShader( ComputeShader& shader )
+{
+  Record( NullCommand::Type::SetComputeShader, &shader, 0, 0, 0, 0, true );
+}
+
+void NullCommandList::SetRayTracingShader( RTShaders& shaders )
+{
+  Record( NullCommand::Type::SetRayTracingShader, &shaders, 0, 0, 0, 0, true );
+}
+
+void NullCommandList::SetRenderTarget( Resource& colorTexture, Resource* depthTexture )
+{
+  Record( NullCommand::Type::SetRenderTarget, &colorTexture, 1, depthTexture ? 1 : 0 );
+}
+
+void NullCommandList::SetRenderTarget( const eastl::vector< Resource* >& colorTextures, Resource* depthTexture )
+{
+  Record( NullCommand::Type::SetRenderTarget, colorTextures.empty() ? depthTexture : colorTextures.front(), int( colorTextures.size() ), depthTexture ? 1 : 0 );
+}
+
+void NullCommandList::SetRenderTarget( ResourceDescriptor& colorTextureDesciptor, ResourceDescriptor* depthTextureDesciptor )
+{
+  Record( NullCommand::Type::SetRenderTarget, &colorTextureDesciptor, 1, depthTextureDesciptor ? 1 : 0 );
+}
+
+void NullCommandList::SetRenderTarget( const eastl::vector< ResourceDescriptor* >& colorTextureDesciptors, ResourceDescriptor* depthTextureDesciptor )
+{
+  Record( NullCommand::Type::SetRenderTarget, colorTextureDesciptors.empty() ? depthTextureDesciptor : colorTextureDesciptors.front(), int( colorTextureDesciptors.size() ), depthTextureDesciptor ? 1 : 0 );
+}
+
+void NullCommandList::SetViewport( int left, int top, int width, int height )
+{
+  Record( NullCommand::Type::SetViewport, nullptr, left, top, width, height );
+}
+
+void NullCommandList::SetScissor( int left, int top, int width, int height )
+{
+  Record( NullCommand::Type::SetScissor, nullptr, left, top, width, height );
+}
+
+void NullCommandList::SetVertexBuffer( Resource& resource )
+{
+  Record( NullCommand::Type::SetVertexBuffer, &resource );
+}
+
+void NullCommandList::SetIndexBuffer( Resource& resource )
+{
+  Record( NullCommand::Type::SetIndexBuffer, &resource );
+}
+
+void NullCommandList::SetVertexBufferToNull()
+{
+  Record( NullCommand::Type::SetVertexBuffer );
+}
+
+void NullCommandList::SetIndexBufferToNull()
+{
+  Record( NullCommand::Type::SetIndexBuffer );
+}
+
+void NullCommandList::SetConstantBuffer( int index, Resource& resource )
+{
+  Record( NullCommand::Type::SetConstantBuffer, &resource, index );
+}
+
+void NullCommandList::SetShaderResourceView( int index, Resource& resource )
+{
+  Record( NullCommand::Type::SetShaderResourceView, &resource, index );
+}
+
+void NullCommandList::SetUnorderedAccessView( int index, Resource& resource )
+{
+  Record( NullCommand::Type::SetUnorderedAccessView, &resource, index );
+}
+
+void NullCommandList::SetDescriptorHeap( int index, DescriptorHeap& heap, int offset )
+{
+  Record( NullCommand::Type::SetDescriptorHeap, &heap, index, offset );
+}
+
+void NullCommandList::SetConstantValues( int index, const void* values, int numValues, int offset )
+{
+  Record( NullCommand::Type::SetConstantValues, nullptr, index, numValues, offset );
+}
+
+void NullCommandList::SetRayTracingScene( int index, RTTopLevelAccelerator& accelerator )
+{
+  Record( NullCommand::Type::SetRayTracingScene, &accelerator, index );
+}
+
+void NullCommandList::SetPrimitiveType( PrimitiveType primitiveType )
+{
+  Record( NullCommand::Type::SetPrimitiveType, nullptr, int( primitiveType ) );
+}
+
+void NullCommandList::Draw( int vertexCount, int instanceCount, int startVertex, int startInstance )
+{
+  Record( NullCommand::Type::Draw, nullptr, vertexCount, instanceCount, startVertex, startInstance );
+}
+
+void NullCommandList::DrawIndexed( int indexCount, int instanceCount, int startIndex, int baseVertex, int startInstance )
+{
+  Record( NullCommand::Type::DrawIndexed, nullptr, indexCount, instanceCount, startIndex, baseVertex );
+}
+
+void NullCommandList::SetComputeConstantValues( int index, const void* values, int numValues, int offset )
+{
+  Record( NullCommand::Type::SetConstantValues, nullptr, index, numValues, offset, 0, true );
+}
+
+void NullCommandList::SetComputeConstantBuffer( int index, Resource& resource )
+{
+  Record( NullCommand::Type::SetConstantBuffer, &resource, index, 0, 0, 0, true );
+}
+
+void NullCommandList::SetComputeShaderResourceView( int index, Resource& resource )
+{
+  Record( NullCommand::Type::SetShaderResourceView, &resource, index, 0, 0, 0, true );
+}
+
+void NullCommandList::SetComputeUnorderedAccessView( int index, Resource& resource )
+{
+  Record( NullCommand::Type::SetUnorderedAccessView, &resource, index, 0, 0, 0, true );
+}
+
+void NullCommandList::SetComputeRayTracingScene( int index, RTTopLevelAccelerator& accelerator )
+{
+  Record( NullCommand::Type::SetRayTracingScene, &accelerator, index, 0, 0, 0, true );
+}
+
+void NullCommandList::SetComputeDescriptorHeap( int index, DescriptorHeap& heap, int offset )
+{
+  Record( NullCommand::Type::SetDescriptorHeap, &heap, index, offset, 0, 0, true );
+}
+
+void NullCommandList::SetVariableRateShading( VRSBlock block )
+{
+  Record( NullCommand::Type::SetVariableRateShading, nullptr, int( block ) );
+}
+
+void NullCommandList::Dispatch( int groupsX, int groupsY, int groupsZ )
+{
+  Record( NullCommand::Type::Dispatch, nullptr, groupsX, groupsY, groupsZ, 0, true );
+}
+
+void NullCommandList::DispatchRays( int width, int height, int depth )
+{
+  Record( NullCommand::Type::DispatchRays, nullptr, width, height, depth, 0, true );
+}
+
+void NullCommandList::ExecuteIndirect( CommandSignature& commandSignature, Resource& argsBuffer, int argsOffset, Resource& countBuffer, int countOffset, int maximumCount )
+{
+  Record( NullCommand::Type::ExecuteIndirect, &commandSignature, argsOffset, countOffset, maximumCount );
+}
+
+void NullCommandList::GenerateMipmaps( Resource& resource )
+{
+  Record( NullCommand::Type::GenerateMipmaps, &resource, resource.GetTextureMipLevels() );
+}
+
+void NullCommandList::AddUAVBarrier( eastl::initializer_list< eastl::reference_wrapper< Resource > > resources )
+{
+  for ( auto& resource : resources )
+    Record( NullCommand::Type::UAVBarrier, &resource.get() );
+}
+
+void NullCommandList::AddNativeUAVBarrier( eastl::initializer_list< void* > resources )
+{
+  for ( auto resource : resources )
+    Record( NullCommand::Type::UAVBarrier, resource );
+}
+
+void NullCommandList::DearImGuiRender()
+{
+}
+
+void NullCommandList::UploadTextureResource( eastl::unique_ptr< Resource > source, Resource& destination, const void* data, int stride, int rows )
+{
+  FillTexture( destination, data, stride * rows );
+
+  HoldResource( eastl::move( source ) );
+}
+
+void NullCommandList::UploadTextureRegion( eastl::unique_ptr< Resource > source, Resource& destination, int mip, int left, int top, int width, int height )
+{
+  // Tiles of reserved textures land in the heaps, which have no memory here.
+  Record( NullCommand::Type::Upload, &destination, mip, left, top );
+
+  HoldResource( eastl::move( source ) );
+}
+
+void NullCommandList::FillTexture( Resource& destination, const void* data, int dataSize )
+{
+  auto oldState = destination.GetCurrentResourceState();
+  Transition( destination, ResourceStateBits::CopyDestination );
+
+  Record( NullCommand::Type::Upload, &destination, dataSize );
+
+  // The data can be the top mip only, the rest is generated on the GPU.
+  auto& memory = static_cast< NullResource& >( destination ).GetMemory();
+  memcpy( memory.data(), data, eastl::min( size_t( dataSize ), memory.size() ) );
+
+  Transition( destination, oldState );
+}
+
+void NullCommandList::UploadBufferResource( Resource& destination, const void* data, int dataSize )
+{
+  UpdateBufferRegion( destination, 0, data, dataSize );
+}
+
+void NullCommandList::UpdateBufferRegion( Resource& destination, int offset, const void* data, int dataSize )
+{
+  // Staged through the upload pages like on the GPU, so their use can be measured.
+  auto upload = uploadAllocator.Allocate( dataSize, uploadAlignment );
+  memcpy( upload.cpuAddress, data, dataSize );
+
+  CopyBufferRegion( *upload.resource, upload.offset, destination, offset, dataSize );
+}
+
+void NullCommandList::CopyResource( Resource& source, Resource& destination )
+{
+  auto oldDstState = destination.GetCurrentResourceState();
+  auto oldSrcState = source.GetCurrentResourceState();
+
+  ChangeResourceState( { { destination, ResourceStateBits::CopyDestination }
+                       , { source,      ResourceStateBits::CopySource      } } );
+
+  Record( NullCommand::Type::Copy, &destination, int( source.GetVirtualAllocationSize() ) );
+
+  auto& sourceMemory      = static_cast< NullResource& >( source ).GetMemory();
+  auto& destinationMemory = static_cast< NullResource& >( destination ).GetMemory();
+  memcpy( destinationMemory.data(), sourceMemory.data(), eastl::min( sourceMemory.size(), destinationMemory.size() ) );
+
+  ChangeResourceState( { { destination, oldDstState }
+                       , { source,      oldSrcState } } );
+}
+
+void NullCommandList::CopyBufferRegion( Resource& source, int sourceOffset, Resource& destination, int destinationOffset, int size )
+{
+  auto oldState = destination.GetCurrentResourceState();
+
+  // Upload heap resources have to stay in the generic read state, which already allows copying from them.
+  Transition( destination, ResourceStateBits::CopyDestination );
+
+  Record( NullCommand::Type::Copy, &destination, size, sourceOffset, destinationOffset );
+
+  auto& sourceMemory = static_cast< NullResource& >( source ).GetMemory();
+  assert( sourceOffset >= 0 && sourceOffset + size <= int( sourceMemory.size() ) );
+  WriteMemory( destination, destinationOffset, sourceMemory.data() + sourceOffset, size );
+
+  Transition( destination, oldState );
+}
+
+void NullCommandList::ResolveMSAA( Resource& source, Resource& destination )
+{
+  auto oldDstState = destination.GetCurrentResourceState();
+  auto oldSrcState = source.GetCurrentResourceState();
+
+  ChangeResourceState( { { destination, ResourceStateBits::ResolveDestination }
+                       , { source,      ResourceStateBits::ResolveSource      } } );
+
+  Record( NullCommand::Type::ResolveMSAA, &destination );
+
+  ChangeResourceState( { { destination, oldDstState }
+                       , { source,      oldSrcState } } );
+}
+
+void NullCommandList::HoldResource( eastl::unique_ptr< Resource > resource )
+{
+  if ( resource )
+    heldResources.emplace_back( eastl::move( resource ) );
+}
+
+void NullCommandList::HoldResource( eastl::unique_ptr< RTTopLevelAccelerator > resource )
+{
+  if ( resource )
+    heldTLAS.emplace_back( eastl::move( resource ) );
+}
+
+void NullCommandList::HoldResource( eastl::unique_ptr< RTBottomLevelAccelerator > resource )
+{
+  if ( resource )
+    heldBLAS.emplace_back( eastl::move( resource ) );
+}
+
+void NullCommandList::HoldResource( IUnknown* unknown )
+{
+  if ( unknown )
+    heldUnknowns.emplace_back( unknown );
+}
+
+void NullCommandList::HoldResource( eastl::unique_ptr< MemoryHeap > heap )
+{
+  if ( heap )
+    heldHeaps.emplace_back( eastl::move( heap ) );
+}
+
+eastl::vector< eastl::unique_ptr< Resource > > NullCommandList::TakeHeldResources()
+{
+  return eastl::move( heldResources );
+}
+
+eastl::vector< eastl::unique_ptr< RTTopLevelAccelerator > > NullCommandList::TakeHeldTLAS()
+{
+  return eastl::move( heldTLAS );
+}
+
+eastl::vector< eastl::unique_ptr< RTBottomLevelAccelerator > > NullCommandList::TakeHeldBLAS()
+{
+  return eastl::move( heldBLAS );
+}
+
+eastl::vector< CComPtr< IUnknown > > NullCommandList::TakeHeldUnknowns()
+{
+  return eastl::move( heldUnknowns );
+}
+
+eastl::vector< eastl::unique_ptr< MemoryHeap > > NullCommandList::TakeHeldHeaps()
+{
+  return eastl::move( heldHeaps );
+}
+
+void NullCommandList::BeginEvent( const wchar_t* format, ... )
+{
+  wchar_t msg[ 512 ];
+
+  va_list args;
+  va_start( args, format );
+  vswprintf_s( msg, format, args );
+  va_end( args );
+
+  Record( NullCommand::Type::BeginEvent, nullptr, int( eventNames.size() ) );
+  eventNames.emplace_back( msg );
+}
+
+void NullCommandList::EndEvent()
+{
+  Record( NullCommand::Type::EndEvent );
+}
+
+int NullCommandList::SuspendEvent()
+{
+  EndEvent();
+  return -1;
+}
+
+void NullCommandList::ContinueEvent( const wchar_t* name, int sectionId )
+{
+  Record( NullCommand::Type::BeginEvent, nullptr, int( eventNames.size() ) );
+  eventNames.emplace_back( name );
+}
+
+void NullCommandList::RegisterEndFrameCallback( EndFrameCallback&& callback )
+{
+  endFrameCallbacks.emplace_back( eastl::move( callback ) );
+}
+
+eastl::vector< CommandList::EndFrameCallback > NullCommandList::TakeEndFrameCallbacks()
+{
+  return eastl::move( endFrameCallbacks );
+}
+
+UploadAllocator& NullCommandList::GetUploadAllocator()
+{
+  return uploadAllocator;
+}
+
+CommandQueueType NullCommandList::GetQueueType() const
+{
+  return queueType;
+}
+
+const eastl::vector< NullCommand >& NullCommandList::GetCommands() const
+{
+  return commands;
+}
+
+const eastl::vector< eastl::wstring >& NullCommandList::GetEventNames() const
+{
+  return eventNames;
+}
+
+NullCommandStats NullCommandList::GetStats() const
+{
+  NullCommandStats stats;
+  stats.commandListCount = 1;
+
+  for ( auto& command : commands )
+    ++stats.counts[ int( command.type ) ];
+
+  return stats;
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "../CommandList.h"
+#include "../Types.h"
+#include "../UploadAllocator.h"
+#include "../MemoryHeap.h"
+
+class NullDevice;
+class NullResource;
+
+// One recorded call. The object is the resource, pipeline or shader the call is about,
+// the meaning of the arguments depends on the type.
+struct NullCommand
+{
+  enum class Type : uint8_t
+  {
+    Barrier,
+    UAVBarrier,
+    AliasingBarrier,
+    ClearRenderTarget,
+    ClearDepthStencil,
+    ClearUnorderedAccess,
+    SetPipelineState,
+    SetComputeShader,
+    SetRayTracingShader,
+    SetRenderTarget,
+    SetViewport,
+    SetScissor,
+    SetVertexBuffer,
+    SetIndexBuffer,
+    SetConstantBuffer,
+    SetShaderResourceView,
+    SetUnorderedAccessView,
+    SetDescriptorHeap,
+    SetConstantValues,
+    SetRayTracingScene,
+    SetPrimitiveType,
+    SetVariableRateShading,
+    Draw,
+    DrawIndexed,
+    Dispatch,
+    DispatchRays,
+    ExecuteIndirect,
+    GenerateMipmaps,
+    Upload,
+    Copy,
+    ResolveMSAA,
+    BeginEvent,
+    EndEvent,
+
+    Count
+  };
+
+  Type        type;
+  bool        compute;
+  const void* object;
+  int         args[ 4 ];
+};
+
+struct NullCommandStats
+{
+  int counts[ int( NullCommand::Type::Count ) ] = {};
+  int commandListCount = 0;
+
+  int  Get( NullCommand::Type type ) const { return counts[ int( type ) ]; }
+  void Add( const NullCommandStats& other );
+};
+
+class NullCommandList : public CommandList
+{
+  friend class NullDevice;
+
+public:
+  ~NullCommandList();
+
+  void BindHeaps() override;
+
+  void ChangeResourceState( Resource& resource, ResourceState newState ) override;
+  void ChangeResourceState( eastl::initializer_list< ResourceStateChange > resources ) override;
+  void AddBarriers( const ResourceBarrier* barriers, int count ) override;
+
+  void ClearRenderTarget( Resource& texture, const Color& color ) override;
+  void ClearDepthStencil( Resource& texture, float depth ) override;
+  void ClearUnorderedAccess( Resource& resource, uint32_t values[ 4 ] ) override;
+
+  void SetPipelineState( PipelineState& pipelineState ) override;
+  void SetComputeShader( ComputeShader& shader ) override;
+  void SetRayTracingShader( RTShaders& shaders ) override;
+
+  void SetRenderTarget( Resource& colorTexture, Resource* depthTexture ) override;
+  void SetRenderTarget( const eastl::vector< Resource* >& colorTextures, Resource* depthTexture ) override;
+  void SetRenderTarget( ResourceDescriptor& colorTextureDesciptor, ResourceDescriptor* depthTextureDesciptor ) override;
+  void SetRenderTarget( const eastl::vector< ResourceDescriptor* >& colorTextureDesciptors, ResourceDescriptor* depthTextureDesciptor ) override;
+  void SetViewport( int left, int top, int width, int height ) override;
+  void SetScissor( int left, int top, int width, int height ) override;
+  void SetVertexBuffer( Resource& resource ) override;
+  void SetIndexBuffer( Resource& resource ) override;
+  void SetVertexBufferToNull() override;
+  void SetIndexBufferToNull() override;
+  void SetConstantBuffer( int index, Resource& resource ) override;
+  void SetShaderResourceView( int index, Resource& resource ) override;
+  void SetUnorderedAccessView( int index, Resource& resource ) override;
+  void SetDescriptorHeap( int index, DescriptorHeap& heap, int offset ) override;
+  void SetConstantValues( int index, const void* values, int numValues, int offset = 0 ) override;
+  void SetRayTracingScene( int index, RTTopLevelAccelerator& accelerator ) override;
+  void SetPrimitiveType( PrimitiveType primitiveType ) override;
+
+  void Draw( int vertexCount, int instanceCount = 1, int startVertex = 0, int startInstance = 0 ) override;
+  void DrawIndexed( int indexCount, int instanceCount = 1, int startIndex = 0, int baseVertex = 0, int startInstance = 0 ) override;
+
+  void SetComputeConstantValues( int index, const void* values, int numValues, int offset = 0 ) override;
+  void SetComputeConstantBuffer( int index, Resource& resource ) override;
+  void SetComputeShaderResourceView( int index, Resource& resource ) override;
+  void SetComputeUnorderedAccessView( int index, Resource& resource ) override;
+  void SetComputeRayTracingScene( int index, RTTopLevelAccelerator& accelerator ) override;
+  void SetComputeDescriptorHeap( int index, DescriptorHeap& heap, int offset ) override;
+
+  void SetVariableRateShading( VRSBlock block ) override;
+
+  void Dispatch( int groupsX, int groupsY, int groupsZ ) override;
+  void DispatchRays( int width, int height, int depth ) override;
+
+  void ExecuteIndirect( CommandSignature& commandSignature, Resource& argsBuffer, int argsOffset, Resource& countBuffer, int countOffset, int maximumCount ) override;
+
+  void GenerateMipmaps( Resource& resource ) override;
+
+  void AddUAVBarrier( eastl::initializer_list< eastl::reference_wrapper< Resource > > resources ) override;
+  void AddNativeUAVBarrier( eastl::initializer_list< void* > resources ) override;
+
+  void DearImGuiRender() override;
+
+  void UploadTextureResource( eastl::unique_ptr< Resource > source, Resource& destination, const void* data, int stride, int rows ) override;
+  void UploadTextureRegion( eastl::unique_ptr< Resource > source, Resource& destination, int mip, int left, int top, int width, int height ) override;
+  void UploadBufferResource( Resource& destination, const void* data, int dataSize ) override;
+
+  void UpdateBufferRegion( Resource& destination, int offset, const void* data, int dataSize ) override;
+
+  void CopyResource( Resource& source, Resource& destination ) override;
+  void CopyBufferRegion( Resource& source, int sourceOffset, Resource& destination, int destinationOffset, int size ) override;
+
+  void ResolveMSAA( Resource& source, Resource& destination ) override;
+
+  void HoldResource( eastl::unique_ptr< Resource > resource ) override;
+  void HoldResource( eastl::unique_ptr< RTTopLevelAccelerator > resource ) override;
+  void HoldResource( eastl::unique_ptr< RTBottomLevelAccelerator > resource ) override;
+  void HoldResource( IUnknown* unknown ) override;
+  void HoldResource( eastl::unique_ptr< MemoryHeap > heap ) override;
+
+  eastl::vector< eastl::unique_ptr< Resource > > TakeHeldResources() override;
+  eastl::vector< eastl::unique_ptr< RTTopLevelAccelerator > > TakeHeldTLAS() override;
+  eastl::vector< eastl::unique_ptr< RTBottomLevelAccelerator > > TakeHeldBLAS() override;
+  eastl::vector< CComPtr< IUnknown > > TakeHeldUnknowns() override;
+  eastl::vector< eastl::unique_ptr< MemoryHeap > > TakeHeldHeaps() override;
+
+  void BeginEvent( const wchar_t* format, ... ) override;
+  void EndEvent() override;
+  int  SuspendEvent() override;
+  void ContinueEvent( const wchar_t* name, int sectionId ) override;
+
+  void RegisterEndFrameCallback( EndFrameCallback&& callback ) override;
+  eastl::vector< EndFrameCallback > TakeEndFrameCallbacks() override;
+
+  UploadAllocator& GetUploadAllocator() override;
+
+  // Writes the texture's memory from the start, mip after mip.
+  void FillTexture( Resource& destination, const void* data, int dataSize );
+
+  CommandQueueType GetQueueType() const;
+
+  const eastl::vector< NullCommand >&    GetCommands() const;
+  const eastl::vector< eastl::wstring >& GetEventNames() const;
+
+  NullCommandStats GetStats() const;
+
+private:
+  NullCommandList( NullDevice& device, CommandQueueType queueType );
+
+  void Record( NullCommand::Type type, const void* object = nullptr, int arg0 = 0, int arg1 = 0, int arg2 = 0, int arg3 = 0, bool compute = false );
+
+  void Transition( Resource& resource, ResourceState newState );
+
+  void WriteMemory( Resource& destination, int offset, const void* data, int dataSize );
+
+  CommandQueueType queueType;
+
+  eastl::vector< NullCommand >    commands;
+  eastl::vector< eastl::wstring > eventNames;
+
+  // Declared first, so the list destroys the held heaps after the resources placed in them.
+  eastl::vector< eastl::unique_ptr< MemoryHeap > > heldHeaps;
+  eastl::vector< eastl::unique_ptr< Resource > > heldResources;
+  eastl::vector< eastl::unique_ptr< RTTopLevelAccelerator > > heldTLAS;
+  eastl::vector< eastl::unique_ptr< RTBottomLevelAccelerator > > heldBLAS;
+  eastl::vector< CComPtr< IUnknown > > heldUnknowns;
+  eastl::vector< EndFrameCallback > endFrameCallbacks;
+
+  UploadAllocator uploadAllocator;
+
+  NullDevice& device;
+};
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "NullCommandQueue.h"
+#include "NullResource.h"
+
+NullCommandQueue::NullCommandQueue( CommandQueueType type )
+  : type( type )
+{
+}
+
+NullCommandQueue::~NullCommandQueue()
+{
+}
+
+CommandQueueType NullCommandQueue::GetCommandListType() const
+{
+  return type;
+}
+
+void NullCommandQueue::Signal()
+{
+  auto signaled = nextFenceValue++;
+  if ( signaled > uint64_t( latency ) )
+    lastCompletedFenceValue = eastl::max( lastCompletedFenceValue, signaled - latency );
+}
+
+uint64_t NullCommandQueue::IncrementFence()
+{
+  eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
+  auto fenceValue = nextFenceValue;
+  Signal();
+  return fenceValue;
+}
+
+uint64_t NullCommandQueue::GetNextFenceValue()
+{
+  return nextFenceValue;
+}
+
+uint64_t NullCommandQueue::GetLastCompletedFenceValue()
+{
+  eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
+  return lastCompletedFenceValue;
+}
+
+uint64_t NullCommandQueue::Submit( eastl::vector< eastl::unique_ptr< CommandList > >& commandLists )
+{
+  eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
+
+  for ( auto& commandList : commandLists )
+  {
+    auto& nullCommandList = static_cast< NullCommandList& >( *commandList );
+    assert( nullCommandList.GetQueueType() == type );
+    stats.Add( nullCommandList.GetStats() );
+  }
+
+  auto fenceValue = nextFenceValue;
+  Signal();
+  return fenceValue;
+}
+
+bool NullCommandQueue::IsFenceComplete( uint64_t fenceValue )
+{
+  eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
+  return fenceValue <= lastCompletedFenceValue;
+}
+
+void NullCommandQueue::WaitForFence( uint64_t fenceValue )
+{
+  eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
+  assert( fenceValue < nextFenceValue );
+  lastCompletedFenceValue = eastl::max( lastCompletedFenceValue, fenceValue );
+}
+
+void NullCommandQueue::WaitForIdle()
+{
+  WaitForFence( IncrementFence() );
+}
+
+uint64_t NullCommandQueue::GetFrequency()
+{
+  return 1000000;
+}
+
+void NullCommandQueue::UpdateTileMapping( Resource& resource, int tileX, int tileY, int mip, MemoryHeap* heap, int heapStartOffsetInTiles )
+{
+  static_cast< NullResource& >( resource ).UpdateTileMapping( tileX, tileY, mip, heap, heapStartOffsetInTiles );
+
+  eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
+  ++tileMappingUpdateCount;
+}
+
+void NullCommandQueue::SetLatency( int fenceCount )
+{
+  eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
+  latency = eastl::max( fenceCount, 0 );
+}
+
+NullCommandStats NullCommandQueue::TakeStats()
+{
+  eastl::lock_guard< eastl::mutex > lockGuard( fenceMutex );
+  auto taken = stats;
+  stats = NullCommandStats();
+  return taken;
+}
+
+int NullCommandQueue::GetTileMappingUpdateCount() const
+{
+  return tileMappingUpdateCount;
+}
\ No newline at end of file
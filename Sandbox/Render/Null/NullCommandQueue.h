@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../CommandQueue.h"
+#include "../Types.h"
+#include "NullCommandList.h"
+
+// Nothing executes, so submitted work is complete as soon as the simulated GPU gets to it.
+// With a latency of N, a submission completes when N more have been made after it, or when
+// it is waited for, which mimics the frames in flight of a real queue.
+class NullCommandQueue : public CommandQueue
+{
+  friend class NullDevice;
+
+public:
+  ~NullCommandQueue();
+
+  CommandQueueType GetCommandListType() const override;
+
+  uint64_t IncrementFence() override;
+  uint64_t GetNextFenceValue() override;
+  uint64_t GetLastCompletedFenceValue() override;
+
+  uint64_t Submit( eastl::vector< eastl::unique_ptr< CommandList > >& commandLists ) override;
+
+  bool IsFenceComplete( uint64_t fenceValue ) override;
+
+  void WaitForFence( uint64_t fenceValue ) override;
+  void WaitForIdle() override;
+
+  uint64_t GetFrequency() override;
+
+  void UpdateTileMapping( Resource& resource, int tileX, int tileY, int mip, MemoryHeap* heap, int heapStartOffsetInTiles ) override;
+
+  void SetLatency( int fenceCount );
+
+  // The commands submitted since the last call.
+  NullCommandStats TakeStats();
+
+  int GetTileMappingUpdateCount() const;
+
+private:
+  NullCommandQueue( CommandQueueType type );
+
+  void Signal();
+
+  CommandQueueType type;
+
+  uint64_t nextFenceValue          = 1;
+  uint64_t lastCompletedFenceValue = 0;
+  int      latency                 = 0;
+
+  NullCommandStats stats;
+  int              tileMappingUpdateCount = 0;
+
+  eastl::mutex fenceMutex;
+};
\ No newline at end of file
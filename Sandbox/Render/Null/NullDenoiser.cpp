@@ -0,0 +1,41 @@
+#include "NullDenoiser.h"
+
+eastl::unique_ptr< Denoiser > CreateNullDenoiser()
+{
+  return eastl::make_unique< NullDenoiser >();
+}
+
+const XMFLOAT4& NullDenoiser::GetHitDistanceParams() const
+{
+  return hitDistanceParams;
+}
+
+void NullDenoiser::TearDown( CommandList* commandList )
+{
+}
+
+void NullDenoiser::Preprocess( CommandList& commandList, TriangleSetupCallback triangleSetupCallback, float nearZ, float farZ )
+{
+}
+
+Denoiser::DenoiseResult NullDenoiser::Denoise( CommandAllocator& commandAllocator
+                                             , CommandList& commandList
+                                             , Resource& giTexture
+                                             , Resource* aoTexture
+                                             , Resource& shadowTexture
+                                             , Resource& shadowTransTexture
+                                             , Resource& reflectionTexture
+                                             , CXMMATRIX viewTransform
+                                             , CXMMATRIX projTransform
+                                             , float jitterX
+                                             , float jitterY
+                                             , uint32_t frameIndex
+                                             , bool enableValidation )
+{
+  DenoiseResult result;
+  result.globalIllumination = &giTexture;
+  result.ambientOcclusion   = aoTexture;
+  result.shadow             = &shadowTexture;
+  result.reflection         = &reflectionTexture;
+  return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../Denoiser.h"
+
+// Stands in for the NRD denoiser on the null backend, NRD needs the D3D device. The noisy textures are passed on as
+// they are, so the passes after the denoiser record the same commands.
+class NullDenoiser : public Denoiser
+{
+public:
+  const XMFLOAT4& GetHitDistanceParams() const override;
+
+  void TearDown( CommandList* commandList ) override;
+
+  void Preprocess( CommandList& commandList, TriangleSetupCallback triangleSetupCallback, float nearZ, float farZ ) override;
+  DenoiseResult Denoise( CommandAllocator& commandAllocator
+                       , CommandList& commandList
+                       , Resource& giTexture
+                       , Resource* aoTexture
+                       , Resource& shadowTexture
+                       , Resource& shadowTransTexture
+                       , Resource& reflectionTexture
+                       , CXMMATRIX viewTransform
+                       , CXMMATRIX projTransform
+                       , float jitterX
+                       , float jitterY
+                       , uint32_t frameIndex
+                       , bool enableValidation ) override;
+
+private:
+  XMFLOAT4 hitDistanceParams = { 3, 0.1f, 20, -25 };
+};
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "NullDescriptorHeap.h"
+#include "../ShaderValues.h"
+
+NullResourceDescriptor::NullResourceDescriptor( NullDescriptorHeap& heap, ResourceDescriptorType type, int slot, Resource& resource )
+  : heap( heap )
+  , type( type )
+  , slot( slot )
+  , resource( resource )
+{
+}
+
+NullResourceDescriptor::~NullResourceDescriptor()
+{
+  heap.FreeDescriptor( slot );
+}
+
+int NullResourceDescriptor::GetSlot() const
+{
+  return slot;
+}
+
+ResourceDescriptorType NullResourceDescriptor::GetType() const
+{
+  return type;
+}
+
+Resource& NullResourceDescriptor::GetResource() const
+{
+  return resource;
+}
+
+NullDescriptorHeap::NullDescriptorHeap( int descriptorCount, bool shaderResourceLayout, bool growable )
+  : pageSize( descriptorCount )
+  , growable( growable && !shaderResourceLayout )
+{
+  if ( shaderResourceLayout )
+  {
+    regions.emplace_back( Engine2DResourceBaseSlot,     Engine2DResourceCount );
+    regions.emplace_back( EngineCubeResourceBaseSlot,   EngineCubeResourceCount );
+    regions.emplace_back( EngineVolResourceBaseSlot,    EngineVolResourceCount );
+    regions.emplace_back( EngineBufferResourceBaseSlot, EngineBufferResourceCount );
+    regions.emplace_back( Scene2DResourceBaseSlot,      Scene2DResourceCount );
+    regions.emplace_back( Scene2DFeedbackBaseSlot,      Scene2DResourceCount );
+    regions.emplace_back( SceneBufferResourceBaseSlot,  SceneBufferResourceCount );
+    regions.emplace_back( Engine2DTileTexturesBaseSlot, Engine2DTileTexturesCount );
+    assert( descriptorCount == AllResourceCount );
+  }
+  else
+    regions.emplace_back( 0, descriptorCount );
+}
+
+NullDescriptorHeap::~NullDescriptorHeap()
+{
+}
+
+eastl::unique_ptr< ResourceDescriptor > NullDescriptorHeap::RequestDescriptorFromSlot( Device& device, ResourceDescriptorType type, int slot, Resource& resource, int bufferElementSize, int mipLevel )
+{
+  eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
+
+  assert( slot >= 0 );
+
+  auto region = FindRegion( slot );
+  bool isFree = region && region->AllocateAt( slot );
+  assert( isFree );
+  if ( !isFree )
+    return nullptr;
+
+  return eastl::unique_ptr< ResourceDescriptor >( new NullResourceDescriptor( *this, type, slot, resource ) );
+}
+
+eastl::unique_ptr< ResourceDescriptor > NullDescriptorHeap::RequestDescriptorAuto( Device& device, ResourceDescriptorType type, int base, Resource& resource, int bufferElementSize, int mipLevel )
+{
+  eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
+
+  auto region = FindRegion( base );
+  assert( region );
+  int slot = region ? region->Allocate() : -1;
+  if ( slot < 0 && region && growable )
+  {
+    region->Grow( region->GetCapacity() + pageSize );
+    slot = region->Allocate();
+  }
+  assert( slot >= 0 );
+  if ( slot < 0 )
+    return nullptr;
+
+  return eastl::unique_ptr< ResourceDescriptor >( new NullResourceDescriptor( *this, type, slot, resource ) );
+}
+
+eastl::vector< eastl::unique_ptr< ResourceDescriptor > > NullDescriptorHeap::RequestDescriptorRangeAuto( Device& device, ResourceDescriptorType type, int base, eastl::initializer_list< eastl::reference_wrapper< Resource > > resources, int bufferElementSize )
+{
+  eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
+
+  eastl::vector< eastl::unique_ptr< ResourceDescriptor > > descriptors;
+
+  auto region = FindRegion( base );
+  assert( region );
+  int slot = region ? region->Allocate( int( resources.size() ) ) : -1;
+  assert( slot >= 0 );
+  if ( slot < 0 )
+    return descriptors;
+
+  for ( auto& resource : resources )
+    descriptors.emplace_back( new NullResourceDescriptor( *this, type, slot++, resource.get() ) );
+
+  return descriptors;
+}
+
+int NullDescriptorHeap::GetDescriptorSize() const
+{
+  return 32;
+}
+
+void NullDescriptorHeap::FreeDescriptor( int slot )
+{
+  eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
+
+  auto region = FindRegion( slot );
+  assert( region );
+  if ( region )
+    region->Free( slot );
+}
+
+int NullDescriptorHeap::GetUsedDescriptorCount()
+{
+  eastl::lock_guard< eastl::recursive_mutex > autoLock( descriptorLock );
+
+  int used = 0;
+  for ( auto& region : regions )
+    used += region.GetStats().used;
+
+  return used;
+}
+
+DescriptorAllocator* NullDescriptorHeap::FindRegion( int slot )
+{
+  for ( auto& region : regions )
+    if ( region.Contains( slot ) )
+      return &region;
+
+  return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../DescriptorHeap.h"
+#include "../DescriptorAllocator.h"
+#include "../ResourceDescriptor.h"
+
+class NullDescriptorHeap;
+
+// Only the slot is real, but the slots are allocated the same way as on the D3D heaps,
+// so running out of them or double booking them shows up here too.
+class NullResourceDescriptor : public ResourceDescriptor
+{
+  friend class NullDescriptorHeap;
+
+public:
+  ~NullResourceDescriptor();
+
+  int GetSlot() const override;
+
+  ResourceDescriptorType GetType() const;
+  Resource&              GetResource() const;
+
+private:
+  NullResourceDescriptor( NullDescriptorHeap& heap, ResourceDescriptorType type, int slot, Resource& resource );
+
+  NullDescriptorHeap&    heap;
+  ResourceDescriptorType type;
+  int                    slot;
+  Resource&              resource;
+};
+
+class NullDescriptorHeap : public DescriptorHeap
+{
+public:
+  // With shaderResourceLayout, the heap is split into the regions of ShaderValues.h.
+  // A growable heap adds descriptorCount slots when it runs out, like the D3D render target and depth heaps.
+  NullDescriptorHeap( int descriptorCount, bool shaderResourceLayout, bool growable = false );
+  ~NullDescriptorHeap();
+
+  eastl::unique_ptr< ResourceDescriptor > RequestDescriptorFromSlot( Device& device, ResourceDescriptorType type, int slot, Resource& resource, int bufferElementSize, int mipLevel = 0 ) override;
+  eastl::unique_ptr< ResourceDescriptor > RequestDescriptorAuto( Device& device, ResourceDescriptorType type, int base, Resource& resource, int bufferElementSize, int mipLevel = 0 ) override;
+  eastl::vector< eastl::unique_ptr< ResourceDescriptor > > RequestDescriptorRangeAuto( Device& device, ResourceDescriptorType type, int base, eastl::initializer_list< eastl::reference_wrapper< Resource > > resources, int bufferElementSize ) override;
+
+  int GetDescriptorSize() const override;
+
+  void FreeDescriptor( int slot );
+
+  int GetUsedDescriptorCount();
+
+private:
+  DescriptorAllocator* FindRegion( int slot );
+
+  eastl::recursive_mutex descriptorLock;
+
+  eastl::vector< DescriptorAllocator > regions;
+
+  int  pageSize;
+  bool growable;
+};
\ No newline at end of file
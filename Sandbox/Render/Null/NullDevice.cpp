@@ -0,0 +1,418 @@
+#include "NullDevice.h"
+#include "NullCommandQueue.h"
+#include "NullCommandList.h"
+#include "NullDescriptorHeap.h"
+#include "NullResource.h"
+#include "NullObjects.h"
+#include "../UploadAllocator.h"
+#include "../GPUPassStatistics.h"
+#include "../FileLoader.h"
+#include "../TextureStreamers/TFFFormat.h"
+
+static constexpr uint32_t MakeFourCC( char a, char b, char c, char d )
+{
+  return uint32_t( a ) | ( uint32_t( b ) << 8 ) | ( uint32_t( c ) << 16 ) | ( uint32_t( d ) << 24 );
+}
+
+// Only the formats the content uses, enough to size the texture.
+static PixelFormat GetDDSPixelFormat( const uint32_t* header )
+{
+  auto fourCC = header[ 21 ];
+  if ( fourCC == MakeFourCC( 'D', 'X', '1', '0' ) )
+  {
+    switch ( header[ 32 ] )
+    {
+    case 71: case 72: return PixelFormat::BC1UN;
+    case 74: case 75: return PixelFormat::BC2UN;
+    case 77: case 78: return PixelFormat::BC3UN;
+    case 80:          return PixelFormat::BC4UN;
+    case 83:          return PixelFormat::BC5UN;
+    case 10:          return PixelFormat::RGBA16161616F;
+    case 2:           return PixelFormat::RGBA32323232F;
+    default:          return PixelFormat::RGBA8888UN;
+    }
+  }
+
+  if ( fourCC == MakeFourCC( 'D', 'X', 'T', '1' ) )
+    return PixelFormat::BC1UN;
+  if ( fourCC == MakeFourCC( 'D', 'X', 'T', '3' ) )
+    return PixelFormat::BC2UN;
+  if ( fourCC == MakeFourCC( 'D', 'X', 'T', '5' ) )
+    return PixelFormat::BC3UN;
+  if ( fourCC == MakeFourCC( 'A', 'T', 'I', '1' ) || fourCC == MakeFourCC( 'B', 'C', '4', 'U' ) )
+    return PixelFormat::BC4UN;
+  if ( fourCC == MakeFourCC( 'A', 'T', 'I', '2' ) || fourCC == MakeFourCC( 'B', 'C', '5', 'U' ) )
+    return PixelFormat::BC5UN;
+
+  return PixelFormat::RGBA8888UN;
+}
+
+NullDevice::NullDevice()
+{
+  shaderResourceHeap.reset( new NullDescriptorHeap( AllResourceCount, true ) );
+  samplerHeap.reset( new NullDescriptorHeap( 20, false ) );
+  renderTargetHeap.reset( new NullDescriptorHeap( 40, false, true ) );
+  depthStencilHeap.reset( new NullDescriptorHeap( 20, false, true ) );
+
+  uploadPagePool.reset( new UploadPagePool( [ this ]( int size ) { return AllocateUploadBuffer( size, L"UploadPage" ); } ) );
+
+  gpuPassStatistics.reset( new GPUPassStatistics );
+}
+
+NullDevice::~NullDevice()
+{
+  uploadPagePool.reset();
+}
+
+int NullDevice::GetMaxSampleCountForTextures( PixelFormat format ) const
+{
+  return 1;
+}
+
+int NullDevice::GetMatchingSampleCountForTextures( PixelFormat format, int count ) const
+{
+  return 1;
+}
+
+int NullDevice::GetNumberOfQualityLevelsForTextures( PixelFormat format, int samples ) const
+{
+  return 1;
+}
+
+eastl::unique_ptr< CommandQueue > NullDevice::CreateCommandQueue( CommandQueueType type )
+{
+  return eastl::unique_ptr< CommandQueue >( new NullCommandQueue( type ) );
+}
+
+eastl::unique_ptr< CommandAllocator > NullDevice::CreateCommandAllocator( CommandQueueType type )
+{
+  return eastl::unique_ptr< CommandAllocator >( new NullCommandAllocator );
+}
+
+eastl::unique_ptr< CommandList > NullDevice::CreateCommandList( CommandAllocator& commandAllocator, CommandQueueType queueType, uint64_t queueFrequency )
+{
+  return eastl::unique_ptr< CommandList >( new NullCommandList( *this, queueType ) );
+}
+
+eastl::unique_ptr< PipelineState > NullDevice::CreatePipelineState( PipelineDesc& desc, const wchar_t* debugName )
+{
+  return eastl::unique_ptr< PipelineState >( new NullPipelineState( debugName ) );
+}
+
+eastl::unique_ptr< CommandSignature > NullDevice::CreateCommandSignature( CommandSignatureDesc& desc, PipelineState& pipelineState )
+{
+  return eastl::unique_ptr< CommandSignature >( new NullCommandSignature );
+}
+
+eastl::unique_ptr< Resource > NullDevice::CreateBuffer( ResourceType resourceType, HeapType heapType, bool unorderedAccess, int size, int elementSize, const wchar_t* debugName )
+{
+  return eastl::unique_ptr< Resource >( new NullResource( resourceType, heapType, size, elementSize, debugName ) );
+}
+
+eastl::unique_ptr< RTBottomLevelAccelerator > NullDevice::CreateRTBottomLevelAccelerator( CommandList& commandList, Resource& vertexBuffer, int vertexCount, int positionElementSize, int vertexStride, Resource& indexBuffer, int indexSize, int indexCount, int infoIndex, bool opaque, bool allowUpdate, bool fastBuild )
+{
+  return eastl::unique_ptr< RTBottomLevelAccelerator >( new NullRTBottomLevelAccelerator( infoIndex ) );
+}
+
+eastl::unique_ptr< RTTopLevelAccelerator > NullDevice::CreateRTTopLevelAccelerator( CommandList& commandList, eastl::vector< RTInstance > instances, int slot )
+{
+  return eastl::unique_ptr< RTTopLevelAccelerator >( new NullRTTopLevelAccelerator( *this, eastl::move( instances ), slot ) );
+}
+
+eastl::unique_ptr< Resource > NullDevice::CreateVolumeTexture( CommandList* commandList, int width, int height, int depth, const void* data, int dataSize, PixelFormat format, int slot, eastl::optional< int > uavSlot, const wchar_t* debugName )
+{
+  auto resource = CreateTexture( commandList, ResourceType::Texture3D, width, height, depth, 1, format, false, slot, uavSlot, false, debugName, false );
+
+  assert( !data || commandList );
+
+  if ( data )
+    static_cast< NullCommandList* >( commandList )->FillTexture( *resource, data, dataSize );
+
+  return resource;
+}
+
+eastl::unique_ptr< Resource > NullDevice::Create2DTexture( CommandList* commandList, int width, int height, const void* data, int dataSize, PixelFormat format, int samples, int sampleQuality, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName )
+{
+  auto resource = CreateTexture( commandList, ResourceType::Texture2D, width, height, 1, 1, format, renderable, slot, uavSlot, mipLevels, debugName, false );
+
+  assert( !data || commandList );
+
+  if ( data )
+    static_cast< NullCommandList* >( commandList )->FillTexture( *resource, data, dataSize );
+
+  return resource;
+}
+
+eastl::unique_ptr< Resource > NullDevice::CreateCubeTexture( CommandList* commandList, int width, const void* data, int dataSize, PixelFormat format, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName )
+{
+  assert( !data && "NullDevice::CreateCubeTexture doesn't support initial data yet!" );
+
+  return CreateTexture( commandList, ResourceType::Texture2D, width, width, 1, 6, format, renderable, slot, uavSlot, mipLevels, debugName, false );
+}
+
+eastl::unique_ptr< Resource > NullDevice::CreateReserved2DTexture( int width, int height, PixelFormat format, int slot, bool mipLevels, const wchar_t* debugName )
+{
+  return CreateTexture( nullptr, ResourceType::Texture2D, width, height, 1, 1, format, false, slot, eastl::nullopt, mipLevels, debugName, true );
+}
+
+eastl::unique_ptr< Resource > NullDevice::CreatePlaced2DTexture( MemoryHeap& heap, uint64_t offset, int width, int height, PixelFormat format, int slot, int uavSlot, const wchar_t* debugName )
+{
+  assert( offset % NullResource::TileSizeInBytes == 0 );
+
+  eastl::unique_ptr< NullResource > resource( new NullResource( ResourceType::Texture2D, width, height, 1, 1, format, ResourceStateBits::UnorderedAccess, false, debugName ) );
+
+  if ( slot > 0 )
+  {
+    auto descriptor = shaderResourceHeap->RequestDescriptorFromSlot( *this, ResourceDescriptorType::ShaderResourceView, slot, *resource, 0 );
+    resource->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( descriptor ) );
+  }
+
+  auto descriptor = shaderResourceHeap->RequestDescriptorFromSlot( *this, ResourceDescriptorType::UnorderedAccessView, uavSlot, *resource, 0 );
+  resource->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( descriptor ) );
+
+  return resource;
+}
+
+eastl::unique_ptr< ComputeShader > NullDevice::CreateComputeShader( const void* shaderData, int shaderSize, const wchar_t* debugName )
+{
+  return eastl::unique_ptr< ComputeShader >( new NullComputeShader( debugName ) );
+}
+
+eastl::unique_ptr< MemoryHeap > NullDevice::CreateMemoryHeap( uint64_t size, const wchar_t* debugName )
+{
+  return eastl::unique_ptr< MemoryHeap >( new NullMemoryHeap( size ) );
+}
+
+eastl::unique_ptr< GPUTimeQuery > NullDevice::CreateGPUTimeQuery()
+{
+  return eastl::unique_ptr< GPUTimeQuery >( new NullGPUTimeQuery );
+}
+
+void NullDevice::PreallocateTiles( CommandQueue& directQueue )
+{
+}
+
+eastl::unique_ptr< RTShaders > NullDevice::CreateRTShaders( CommandList& commandList
+                                                          , const ShaderBinary& rootSignatureShaderBinary
+                                                          , const ShaderBinary& shaderBinary
+                                                          , const wchar_t* rayGenEntryName
+                                                          , const wchar_t* missEntryName
+                                                          , const wchar_t* anyHitEntryName
+                                                          , const wchar_t* closestHitEntryName
+                                                          , int attributeSize
+                                                          , int payloadSize
+                                                          , int maxRecursionDepth )
+{
+  return eastl::unique_ptr< RTShaders >( new NullRTShaders );
+}
+
+eastl::unique_ptr< Resource > NullDevice::Load2DTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName )
+{
+  return LoadDDSTexture( commandList, textureData, textureSize, 1, slot, debugName );
+}
+
+eastl::unique_ptr< Resource > NullDevice::LoadCubeTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName )
+{
+  return LoadDDSTexture( commandList, textureData, textureSize, 6, slot, debugName );
+}
+
+eastl::unique_ptr< Resource > NullDevice::Stream2DTexture( CommandQueue& directQueue
+                                                         , CommandList& commandList
+                                                         , const TFFHeader& tffHeader
+                                                         , eastl::unique_ptr< FileLoaderFile >&& fileHandle
+                                                         , int slot
+                                                         , const wchar_t* debugName )
+{
+  #if TEXTURE_STREAMING_MODE == TEXTURE_STREAMING_OFF
+    return nullptr;
+  #else
+    PixelFormat pixelFormat = PixelFormat::Unknown;
+    switch ( tffHeader.pixelFormat )
+    {
+      case TFFHeader::PixelFormat::BC1: pixelFormat = PixelFormat::BC1UN; break;
+      case TFFHeader::PixelFormat::BC2: pixelFormat = PixelFormat::BC2UN; break;
+      case TFFHeader::PixelFormat::BC3: pixelFormat = PixelFormat::BC3UN; break;
+      case TFFHeader::PixelFormat::BC4: pixelFormat = PixelFormat::BC4UN; break;
+      case TFFHeader::PixelFormat::BC5: pixelFormat = PixelFormat::BC5UN; break;
+      default: return nullptr;
+    }
+
+    auto texture = CreateReserved2DTexture( tffHeader.width, tffHeader.height, pixelFormat, slot, true, debugName );
+
+    // The packed mip tail is loaded through the D3D copy path, so only the file is kept here.
+    static_cast< NullResource* >( texture.get() )->SetLoader( eastl::move( fileHandle ) );
+
+    return texture;
+  #endif
+}
+
+eastl::unique_ptr< Resource > NullDevice::AllocateUploadBuffer( int dataSize, const wchar_t* resourceName )
+{
+  return eastl::unique_ptr< Resource >( new NullResource( ResourceType::Buffer, HeapType::Upload, dataSize, 1, resourceName ) );
+}
+
+UploadPagePool& NullDevice::GetUploadPagePool()
+{
+  return *uploadPagePool;
+}
+
+GPUPassStatistics& NullDevice::GetGPUPassStatistics()
+{
+  return *gpuPassStatistics;
+}
+
+void NullDevice::ResolveGPUTimestamps( CommandList& commandList )
+{
+}
+
+DescriptorHeap& NullDevice::GetShaderResourceHeap()
+{
+  return *shaderResourceHeap;
+}
+
+DescriptorHeap& NullDevice::GetSamplerHeap()
+{
+  return *samplerHeap;
+}
+
+int NullDevice::GetUploadSizeForResource( Resource& resource )
+{
+  return int( resource.GetVirtualAllocationSize() );
+}
+
+uint64_t NullDevice::GetPlaced2DTextureSize( int width, int height, PixelFormat format )
+{
+  auto size = NullResource::CalcSurfaceSize( width, height, format );
+  return ( size + NullResource::TileSizeInBytes - 1 ) & ~uint64_t( NullResource::TileSizeInBytes - 1 );
+}
+
+void NullDevice::SetTextureLODBias( float bias )
+{
+}
+
+void NullDevice::StartNewFrame()
+{
+  ++frameIndex;
+}
+
+void NullDevice::CaptureNextFrames( int count )
+{
+}
+
+void NullDevice::DearImGuiNewFrame()
+{
+}
+
+void* NullDevice::GetDearImGuiHeap()
+{
+  return nullptr;
+}
+
+eastl::wstring NullDevice::GetMemoryInfo( bool includeIndividualAllocations )
+{
+  eastl::wstring result;
+  result.sprintf( L"Null device, frame %llu\nShader resource descriptors: %d\nRender target descriptors: %d\nDepth stencil descriptors: %d\n"
+                , frameIndex
+                , shaderResourceHeap->GetUsedDescriptorCount()
+                , renderTargetHeap->GetUsedDescriptorCount()
+                , depthStencilHeap->GetUsedDescriptorCount() );
+  return result;
+}
+
+uint64_t NullDevice::GetFrameIndex() const
+{
+  return frameIndex;
+}
+
+eastl::unique_ptr< NullResource > NullDevice::CreateTexture( CommandList* commandList, ResourceType resourceType, int width, int height, int depth, int slices, PixelFormat format, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName, bool reserved )
+{
+  bool isCubeTexture = slices > 1;
+
+  ResourceState initialState;
+  if ( IsDepthFormat( format ) )
+    initialState.bits = ResourceStateBits::DepthWrite;
+  if ( renderable )
+    initialState.bits = ResourceStateBits::RenderTarget;
+  if ( uavSlot.has_value() )
+    initialState.bits = ResourceStateBits::UnorderedAccess;
+
+  if ( initialState.bits == 0 )
+    initialState.bits = ResourceStateBits::CopyDestination;
+
+  int mipCount = 1;
+  if ( mipLevels )
+    mipCount = int( floor( log2( eastl::max( width, height ) ) ) ) + 1;
+
+  eastl::unique_ptr< NullResource > resource( new NullResource( resourceType, width, height, eastl::max( depth, slices ), mipCount, format, initialState, reserved, debugName ) );
+
+  if ( slot > 0 )
+  {
+    auto descriptor = shaderResourceHeap->RequestDescriptorFromSlot( *this, ResourceDescriptorType::ShaderResourceView, slot, *resource, 0 );
+    resource->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( descriptor ) );
+  }
+
+  if ( IsDepthFormat( format ) )
+  {
+    auto descriptor = depthStencilHeap->RequestDescriptorAuto( *this, ResourceDescriptorType::DepthStencilView, 0, *resource, 0 );
+    resource->AttachResourceDescriptor( ResourceDescriptorType::DepthStencilView, eastl::move( descriptor ) );
+  }
+  if ( renderable )
+  {
+    auto descriptor = renderTargetHeap->RequestDescriptorAuto( *this, ResourceDescriptorType::RenderTargetView, 0, *resource, 0 );
+    resource->AttachResourceDescriptor( ResourceDescriptorType::RenderTargetView, eastl::move( descriptor ) );
+
+    if ( isCubeTexture )
+    {
+      for ( int slot = 1; slot < 6; ++slot )
+      {
+        auto namedSlot  = ResourceDescriptorType( int( ResourceDescriptorType::RenderTargetView0 ) + slot );
+        auto descriptor = renderTargetHeap->RequestDescriptorAuto( *this, namedSlot, 0, *resource, 0 );
+        resource->AttachResourceDescriptor( namedSlot, eastl::move( descriptor ) );
+      }
+    }
+  }
+
+  if ( uavSlot.has_value() )
+  {
+    auto descriptor = shaderResourceHeap->RequestDescriptorFromSlot( *this, ResourceDescriptorType::UnorderedAccessView, *uavSlot, *resource, 0 );
+    resource->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( descriptor ) );
+
+    if ( commandList )
+      commandList->AddUAVBarrier( { *resource } );
+  }
+
+  return resource;
+}
+
+eastl::unique_ptr< Resource > NullDevice::LoadDDSTexture( CommandList& commandList, const void* textureData, int textureSize, int slices, int slot, const wchar_t* debugName )
+{
+  static constexpr int headerSize      = 128;
+  static constexpr int dx10HeaderSize  = 20;
+
+  if ( textureSize < headerSize )
+    return nullptr;
+
+  auto header = reinterpret_cast< const uint32_t* >( textureData );
+  if ( header[ 0 ] != MakeFourCC( 'D', 'D', 'S', ' ' ) )
+    return nullptr;
+
+  int payloadOffset = headerSize;
+  if ( header[ 21 ] == MakeFourCC( 'D', 'X', '1', '0' ) )
+    payloadOffset += dx10HeaderSize;
+
+  if ( textureSize < payloadOffset )
+    return nullptr;
+
+  int height   = int( header[ 3 ] );
+  int width    = int( header[ 4 ] );
+  int mipCount = eastl::max( int( header[ 7 ] ), 1 );
+
+  eastl::unique_ptr< NullResource > resource( new NullResource( ResourceType::Texture2D, width, height, slices, mipCount, GetDDSPixelFormat( header ), ResourceStateBits::CopyDestination, false, debugName ) );
+
+  auto descriptor = shaderResourceHeap->RequestDescriptorFromSlot( *this, ResourceDescriptorType::ShaderResourceView, slot, *resource, 0 );
+  resource->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( descriptor ) );
+
+  static_cast< NullCommandList* >( &commandList )->FillTexture( *resource, static_cast< const uint8_t* >( textureData ) + payloadOffset, textureSize - payloadOffset );
+
+  return resource;
+}
\ No newline at end of file
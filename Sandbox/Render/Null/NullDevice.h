@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../Device.h"
+
+class NullDescriptorHeap;
+class NullResource;
+
+// Device of the headless backend. Everything lives in CPU memory and command lists are only
+// recorded, so the code above the render API can run and be measured without a GPU.
+class NullDevice : public Device
+{
+  friend class NullAdapter;
+
+public:
+  ~NullDevice();
+
+  int GetMaxSampleCountForTextures( PixelFormat format ) const override;
+  int GetMatchingSampleCountForTextures( PixelFormat format, int count ) const override;
+  int GetNumberOfQualityLevelsForTextures( PixelFormat format, int samples ) const override;
+
+  eastl::unique_ptr< CommandQueue >             CreateCommandQueue( CommandQueueType type ) override;
+  eastl::unique_ptr< CommandAllocator >         CreateCommandAllocator( CommandQueueType type ) override;
+  eastl::unique_ptr< CommandList >              CreateCommandList( CommandAllocator& commandAllocator, CommandQueueType queueType, uint64_t queueFrequency ) override;
+  eastl::unique_ptr< PipelineState >            CreatePipelineState( PipelineDesc& desc, const wchar_t* debugName ) override;
+  eastl::unique_ptr< CommandSignature >         CreateCommandSignature( CommandSignatureDesc& desc, PipelineState& pipelineState ) override;
+  eastl::unique_ptr< Resource >                 CreateBuffer( ResourceType resourceType, HeapType heapType, bool unorderedAccess, int size, int elementSize, const wchar_t* debugName ) override;
+  eastl::unique_ptr< RTBottomLevelAccelerator > CreateRTBottomLevelAccelerator( CommandList& commandList, Resource& vertexBuffer, int vertexCount, int positionElementSize, int vertexStride, Resource& indexBuffer, int indexSize, int indexCount, int infoIndex, bool opaque, bool allowUpdate, bool fastBuild ) override;
+  eastl::unique_ptr< RTTopLevelAccelerator >    CreateRTTopLevelAccelerator( CommandList& commandList, eastl::vector< RTInstance > instances, int slot ) override;
+  eastl::unique_ptr< Resource >                 CreateVolumeTexture( CommandList* commandList, int width, int height, int depth, const void* data, int dataSize, PixelFormat format, int slot, eastl::optional< int > uavSlot, const wchar_t* debugName ) override;
+  eastl::unique_ptr< Resource >                 Create2DTexture( CommandList* commandList, int width, int height, const void* data, int dataSize, PixelFormat format, int samples, int sampleQuality, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName ) override;
+  eastl::unique_ptr< Resource >                 CreateCubeTexture( CommandList* commandList, int width, const void* data, int dataSize, PixelFormat format, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName ) override;
+  eastl::unique_ptr< Resource >                 CreateReserved2DTexture( int width, int height, PixelFormat format, int slot, bool mipLevels, const wchar_t* debugName ) override;
+  eastl::unique_ptr< Resource >                 CreatePlaced2DTexture( MemoryHeap& heap, uint64_t offset, int width, int height, PixelFormat format, int slot, int uavSlot, const wchar_t* debugName ) override;
+  eastl::unique_ptr< ComputeShader >            CreateComputeShader( const void* shaderData, int shaderSize, const wchar_t* debugName ) override;
+  eastl::unique_ptr< MemoryHeap >               CreateMemoryHeap( uint64_t size, const wchar_t* debugName ) override;
+  eastl::unique_ptr< GPUTimeQuery >             CreateGPUTimeQuery() override;
+
+  void PreallocateTiles( CommandQueue& directQueue ) override;
+
+  eastl::unique_ptr< RTShaders > CreateRTShaders( CommandList& commandList
+                                              , const ShaderBinary& rootSignatureShaderBinary
+                                              , const ShaderBinary& shaderBinary
+                                              , const wchar_t* rayGenEntryName
+                                              , const wchar_t* missEntryName
+                                              , const wchar_t* anyHitEntryName
+                                              , const wchar_t* closestHitEntryName
+                                              , int attributeSize
+                                              , int payloadSize
+                                              , int maxRecursionDepth ) override;
+
+  eastl::unique_ptr< Resource > Load2DTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName ) override;
+  eastl::unique_ptr< Resource > LoadCubeTexture( CommandList& commandList, const void* textureData, int textureSize, int slot, const wchar_t* debugName ) override;
+
+  eastl::unique_ptr< Resource > Stream2DTexture( CommandQueue& directQueue
+                                               , CommandList& commandList
+                                               , const TFFHeader& tffHeader
+                                               , eastl::unique_ptr< FileLoaderFile >&& fileHandle
+                                               , int slot
+                                               , const wchar_t* debugName ) override;
+
+  eastl::unique_ptr< Resource > AllocateUploadBuffer( int dataSize, const wchar_t* resourceName = nullptr ) override;
+
+  UploadPagePool& GetUploadPagePool() override;
+
+  GPUPassStatistics& GetGPUPassStatistics() override;
+  void ResolveGPUTimestamps( CommandList& commandList ) override;
+
+  DescriptorHeap& GetShaderResourceHeap() override;
+  DescriptorHeap& GetSamplerHeap() override;
+
+  int GetUploadSizeForResource( Resource& resource ) override;
+
+  uint64_t GetPlaced2DTextureSize( int width, int height, PixelFormat format ) override;
+
+  void SetTextureLODBias( float bias ) override;
+
+  void StartNewFrame() override;
+
+  void CaptureNextFrames( int count ) override;
+
+  void  DearImGuiNewFrame() override;
+  void* GetDearImGuiHeap() override;
+
+  eastl::wstring GetMemoryInfo( bool includeIndividualAllocations ) override;
+
+  uint64_t GetFrameIndex() const;
+
+private:
+  NullDevice();
+
+  eastl::unique_ptr< NullResource > CreateTexture( CommandList* commandList, ResourceType resourceType, int width, int height, int depth, int slices, PixelFormat format, bool renderable, int slot, eastl::optional< int > uavSlot, bool mipLevels, const wchar_t* debugName, bool reserved );
+
+  eastl::unique_ptr< Resource > LoadDDSTexture( CommandList& commandList, const void* textureData, int textureSize, int slices, int slot, const wchar_t* debugName );
+
+  eastl::unique_ptr< NullDescriptorHeap > shaderResourceHeap;
+  eastl::unique_ptr< NullDescriptorHeap > samplerHeap;
+  eastl::unique_ptr< NullDescriptorHeap > renderTargetHeap;
+  eastl::unique_ptr< NullDescriptorHeap > depthStencilHeap;
+
+  eastl::unique_ptr< UploadPagePool >    uploadPagePool;
+  eastl::unique_ptr< GPUPassStatistics > gpuPassStatistics;
+
+  uint64_t frameIndex = 0;
+};
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "NullFactory.h"
+#include "NullAdapter.h"
+#include "NullObjects.h"
+#include "Platform/Window.h"
+
+eastl::unique_ptr< Factory > Factory::CreateNull()
+{
+  return eastl::unique_ptr< Factory >( new NullFactory );
+}
+
+NullFactory::NullFactory()
+{
+}
+
+NullFactory::~NullFactory()
+{
+}
+
+bool NullFactory::IsVRRSupported() const
+{
+  return false;
+}
+
+eastl::unique_ptr< Adapter > NullFactory::CreateDefaultAdapter()
+{
+  return eastl::unique_ptr< Adapter >( new NullAdapter );
+}
+
+eastl::unique_ptr< Swapchain > NullFactory::CreateSwapchain( Device& device, CommandQueue& directQueue, Window& window )
+{
+  return eastl::unique_ptr< Swapchain >( new NullSwapchain( window.GetClientWidth(), window.GetClientHeight() ) );
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../Factory.h"
+
+// Factory of the headless backend, see NullDevice.
+class NullFactory : public Factory
+{
+  friend struct Factory;
+
+public:
+  ~NullFactory();
+
+  bool IsVRRSupported() const override;
+
+  eastl::unique_ptr< Adapter >   CreateDefaultAdapter() override;
+  eastl::unique_ptr< Swapchain > CreateSwapchain( Device& device, CommandQueue& directQueue, Window& window ) override;
+
+private:
+  NullFactory();
+};
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "NullObjects.h"
+#include "NullDevice.h"
+#include "NullResource.h"
+#include "NullDescriptorHeap.h"
+#include "Platform/Window.h"
+
+void NullCommandAllocator::Reset()
+{
+  ++resetCount;
+}
+
+int NullCommandAllocator::GetResetCount() const
+{
+  return resetCount;
+}
+
+NullPipelineState::NullPipelineState( const wchar_t* debugName )
+  : debugName( debugName ? debugName : L"" )
+{
+}
+
+const eastl::wstring& NullPipelineState::GetDebugName() const
+{
+  return debugName;
+}
+
+NullComputeShader::NullComputeShader( const wchar_t* debugName )
+  : debugName( debugName ? debugName : L"" )
+{
+}
+
+const eastl::wstring& NullComputeShader::GetDebugName() const
+{
+  return debugName;
+}
+
+NullRTBottomLevelAccelerator::NullRTBottomLevelAccelerator( int infoIndex )
+  : infoIndex( infoIndex )
+{
+}
+
+void NullRTBottomLevelAccelerator::Update( Device& device, CommandList& commandList, Resource& vertexBuffer, Resource& indexBuffer )
+{
+}
+
+int NullRTBottomLevelAccelerator::GetInfoIndex() const
+{
+  return infoIndex;
+}
+
+NullRTTopLevelAccelerator::NullRTTopLevelAccelerator( NullDevice& device, eastl::vector< RTInstance > instances, int slot )
+  : instances( eastl::move( instances ) )
+  , resource( new NullResource( ResourceType::Buffer, HeapType::Default, 0, 0, L"TLAS" ) )
+{
+  resourceDescriptor = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, slot, *resource, 0 );
+}
+
+NullRTTopLevelAccelerator::~NullRTTopLevelAccelerator()
+{
+}
+
+void NullRTTopLevelAccelerator::Update( Device& device, CommandList& commandList, eastl::vector< RTInstance > instances )
+{
+  this->instances = eastl::move( instances );
+}
+
+void NullRTTopLevelAccelerator::UpdateTransforms( Device& device, CommandList& commandList, const eastl::vector< RTInstanceTransform >& transforms )
+{
+}
+
+ResourceDescriptor& NullRTTopLevelAccelerator::GetResourceDescriptor()
+{
+  return *resourceDescriptor;
+}
+
+const eastl::vector< RTInstance >& NullRTTopLevelAccelerator::GetInstances() const
+{
+  return instances;
+}
+
+NullMemoryHeap::NullMemoryHeap( uint64_t size )
+{
+  assert( size % BlockSize == 0 );
+  usedBlocks.resize( size_t( size / BlockSize ) );
+}
+
+uint64_t NullMemoryHeap::alloc( uint64_t size )
+{
+  assert( size == BlockSize ); // Only ready for this for now, as the D3D heap
+
+  eastl::lock_guard< eastl::mutex > autoLock( allocationLock );
+
+  for ( size_t blockIx = 0; blockIx < usedBlocks.size(); ++blockIx )
+  {
+    if ( !usedBlocks[ blockIx ] )
+    {
+      usedBlocks[ blockIx ] = true;
+      ++allocatedBlockCount;
+      return blockIx * BlockSize;
+    }
+  }
+
+  return InvalidAllocation;
+}
+
+void NullMemoryHeap::free( uint64_t address )
+{
+  eastl::lock_guard< eastl::mutex > autoLock( allocationLock );
+
+  auto blockIx = size_t( address / BlockSize );
+  assert( blockIx < usedBlocks.size() && usedBlocks[ blockIx ] );
+
+  usedBlocks[ blockIx ] = false;
+  --allocatedBlockCount;
+}
+
+int NullMemoryHeap::GetAllocatedBlockCount() const
+{
+  return allocatedBlockCount;
+}
+
+void NullGPUTimeQuery::Insert( CommandList& commandList )
+{
+}
+
+double NullGPUTimeQuery::GetResult( CommandList& commandList )
+{
+  return 0;
+}
+
+NullSwapchain::NullSwapchain( int width, int height )
+  : width( width )
+  , height( height )
+  , backBufferDescriptors( new NullDescriptorHeap( BackBufferCount, false ) )
+{
+}
+
+NullSwapchain::~NullSwapchain()
+{
+  frameData.clear();
+}
+
+void NullSwapchain::BuildBackBufferTextures( Device& device )
+{
+  frameData.resize( BackBufferCount );
+  for ( int index = 0; index < BackBufferCount; ++index )
+  {
+    auto bufferName = eastl::wstring( L"backBuffer_" ) + eastl::to_wstring( index );
+
+    auto& texture = frameData[ index ].texture;
+    texture.reset( new NullResource( ResourceType::Texture2D, width, height, 1, 1, PixelFormat::RGBA1010102UN, ResourceStateBits::Present, false, bufferName.data() ) );
+
+    auto descriptor = backBufferDescriptors->RequestDescriptorFromSlot( device, ResourceDescriptorType::RenderTargetView, index, *texture, 0 );
+    texture->AttachResourceDescriptor( ResourceDescriptorType::RenderTargetView, eastl::move( descriptor ) );
+  }
+}
+
+Resource& NullSwapchain::GetCurrentBackBufferTexture()
+{
+  return *frameData[ currentFrameIndex ].texture;
+}
+
+int NullSwapchain::GetCurrentBackBufferTextureIndex()
+{
+  return currentFrameIndex;
+}
+
+uint64_t NullSwapchain::Present( uint64_t fenceValue, bool useVSync )
+{
+  ++presentCount;
+
+  frameData[ currentFrameIndex ].fenceValue = fenceValue;
+
+  currentFrameIndex = ( currentFrameIndex + 1 ) % BackBufferCount;
+  return frameData[ currentFrameIndex ].fenceValue;
+}
+
+void NullSwapchain::ToggleFullscreen( CommandList& commandList, Device& device, Window& window )
+{
+  Resize( commandList, device, window );
+}
+
+void NullSwapchain::Resize( CommandList& commandList, Device& device, Window& window )
+{
+  frameData.clear();
+
+  width  = window.GetClientWidth();
+  height = window.GetClientHeight();
+
+  BuildBackBufferTextures( device );
+
+  currentFrameIndex = 0;
+}
+
+int NullSwapchain::GetPresentCount() const
+{
+  return presentCount;
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "../CommandAllocator.h"
+#include "../PipelineState.h"
+#include "../CommandSignature.h"
+#include "../ComputeShader.h"
+#include "../RTShaders.h"
+#include "../RTBottomLevelAccelerator.h"
+#include "../RTTopLevelAccelerator.h"
+#include "../MemoryHeap.h"
+#include "../GPUTimeQuery.h"
+#include "../Swapchain.h"
+
+class NullDevice;
+class NullResource;
+class NullDescriptorHeap;
+
+// The state objects of the null backend. They hold nothing but what the callers can query back.
+
+class NullCommandAllocator : public CommandAllocator
+{
+public:
+  void Reset() override;
+
+  int GetResetCount() const;
+
+private:
+  int resetCount = 0;
+};
+
+class NullPipelineState : public PipelineState
+{
+public:
+  NullPipelineState( const wchar_t* debugName );
+
+  const eastl::wstring& GetDebugName() const;
+
+private:
+  eastl::wstring debugName;
+};
+
+class NullCommandSignature : public CommandSignature
+{
+};
+
+class NullComputeShader : public ComputeShader
+{
+public:
+  NullComputeShader( const wchar_t* debugName );
+
+  const eastl::wstring& GetDebugName() const;
+
+private:
+  eastl::wstring debugName;
+};
+
+class NullRTShaders : public RTShaders
+{
+};
+
+class NullRTBottomLevelAccelerator : public RTBottomLevelAccelerator
+{
+public:
+  NullRTBottomLevelAccelerator( int infoIndex );
+
+  void Update( Device& device, CommandList& commandList, Resource& vertexBuffer, Resource& indexBuffer ) override;
+
+  int GetInfoIndex() const override;
+
+private:
+  int infoIndex;
+};
+
+class NullRTTopLevelAccelerator : public RTTopLevelAccelerator
+{
+public:
+  NullRTTopLevelAccelerator( NullDevice& device, eastl::vector< RTInstance > instances, int slot );
+  ~NullRTTopLevelAccelerator();
+
+  void Update( Device& device, CommandList& commandList, eastl::vector< RTInstance > instances ) override;
+  void UpdateTransforms( Device& device, CommandList& commandList, const eastl::vector< RTInstanceTransform >& transforms ) override;
+
+  ResourceDescriptor& GetResourceDescriptor() override;
+
+  const eastl::vector< RTInstance >& GetInstances() const;
+
+private:
+  eastl::vector< RTInstance > instances;
+
+  eastl::unique_ptr< NullResource >       resource;
+  eastl::unique_ptr< ResourceDescriptor > resourceDescriptor;
+};
+
+// Same 64KB block granularity as the D3D heaps, only the bookkeeping.
+class NullMemoryHeap : public MemoryHeap
+{
+public:
+  static constexpr uint64_t BlockSize = 64 * 1024;
+
+  NullMemoryHeap( uint64_t size );
+
+  uint64_t alloc( uint64_t size ) override;
+  void free( uint64_t address ) override;
+
+  int GetAllocatedBlockCount() const;
+
+private:
+  eastl::vector< bool > usedBlocks;
+  int                   allocatedBlockCount = 0;
+
+  eastl::mutex allocationLock;
+};
+
+class NullGPUTimeQuery : public GPUTimeQuery
+{
+public:
+  void   Insert( CommandList& commandList ) override;
+  double GetResult( CommandList& commandList ) override;
+};
+
+class NullSwapchain : public Swapchain
+{
+public:
+  static constexpr int BackBufferCount = 3;
+
+  NullSwapchain( int width, int height );
+  ~NullSwapchain();
+
+  void BuildBackBufferTextures( Device& device ) override;
+
+  Resource& GetCurrentBackBufferTexture() override;
+  int GetCurrentBackBufferTextureIndex() override;
+
+  uint64_t Present( uint64_t fenceValue, bool useVSync ) override;
+
+  void ToggleFullscreen( CommandList& commandList, Device& device, Window& window ) override;
+  void Resize( CommandList& commandList, Device& device, Window& window ) override;
+
+  int GetPresentCount() const;
+
+private:
+  struct FrameData
+  {
+    eastl::unique_ptr< NullResource > texture;
+    uint64_t                          fenceValue = 0;
+  };
+
+  int width;
+  int height;
+
+  eastl::unique_ptr< NullDescriptorHeap > backBufferDescriptors;
+
+  eastl::vector< FrameData > frameData;
+  int                        currentFrameIndex = 0;
+  int                        presentCount      = 0;
+};
\ No newline at end of file
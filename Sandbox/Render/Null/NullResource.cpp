@@ -0,0 +1,304 @@
+#include "NullResource.h"
+#include "../FileLoader.h"
+
+static int CalcTexelSize( PixelFormat format )
+{
+  switch ( format )
+  {
+  case PixelFormat::R8U:
+  case PixelFormat::R8UN:
+  case PixelFormat::A8UN:
+    return 1;
+  case PixelFormat::RG88UN:
+  case PixelFormat::R16F:
+  case PixelFormat::R16UN:
+  case PixelFormat::D16:
+    return 2;
+  case PixelFormat::RGBA16161616F:
+    return 8;
+  case PixelFormat::RGB323232F:
+    return 12;
+  case PixelFormat::RGBA32323232F:
+    return 16;
+  default:
+    return 4;
+  }
+}
+
+static int CalcBlockSize( PixelFormat format )
+{
+  switch ( format )
+  {
+  case PixelFormat::BC1UN:
+  case PixelFormat::BC4UN:
+    return 8;
+  case PixelFormat::BC2UN:
+  case PixelFormat::BC3UN:
+  case PixelFormat::BC5UN:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+NullResource::NullResource( ResourceType resourceType, HeapType heapType, int size, int elementSize, const wchar_t* debugName )
+  : resourceType( resourceType )
+  , heapType( heapType )
+  , bufferSize( size )
+  , elementSize( elementSize )
+  , debugName( debugName ? debugName : L"" )
+{
+  // Same initial states as the D3D buffers, so the recorded barriers match.
+  resourceState = heapType == HeapType::Upload ? ResourceStateBits::GenericRead : ( resourceType == ResourceType::IndexBuffer ? ResourceStateBits::IndexBuffer : ResourceStateBits::VertexOrConstantBuffer );
+  resourceState = heapType == HeapType::Readback ? ResourceStateBits::CopyDestination : resourceState;
+
+  if ( resourceType == ResourceType::ConstantBuffer )
+  {
+    bufferSize         = ( size + 256 - 1 ) & -256;
+    this->resourceType = ResourceType::Buffer;
+  }
+
+  memory.resize( bufferSize );
+}
+
+NullResource::NullResource( ResourceType resourceType, int width, int height, int depth, int mipLevels, PixelFormat format, ResourceState initialState, bool reserved, const wchar_t* debugName )
+  : resourceType( resourceType )
+  , heapType( HeapType::Default )
+  , resourceState( initialState )
+  , width( width )
+  , height( height )
+  , depth( depth )
+  , mipLevels( mipLevels )
+  , pixelFormat( format )
+  , reserved( reserved )
+  , debugName( debugName ? debugName : L"" )
+{
+  if ( !reserved )
+    return;
+
+  // 64KB tiles, as the standard swizzle lays them out.
+  if ( auto blockSize = CalcBlockSize( format ) )
+  {
+    tileWidth  = blockSize == 8 ? 512 : 256;
+    tileHeight = 256;
+  }
+  else
+  {
+    auto texelSize = CalcTexelSize( format );
+    tileWidth  = texelSize == 1 ? 256 : ( texelSize <= 4 ? 128 : 64 );
+    tileHeight = texelSize <= 2 ? 256 : ( texelSize == 4 ? 128 : 64 );
+  }
+
+  tileMappings.resize( mipLevels );
+  for ( int mip = 0; mip < mipLevels; ++mip )
+  {
+    auto tilesX = ( eastl::max( width  >> mip, 1 ) + tileWidth  - 1 ) / tileWidth;
+    auto tilesY = ( eastl::max( height >> mip, 1 ) + tileHeight - 1 ) / tileHeight;
+    tileMappings[ mip ].resize( tilesX * tilesY );
+  }
+}
+
+NullResource::~NullResource()
+{
+}
+
+void NullResource::AttachResourceDescriptor( ResourceDescriptorType type, eastl::unique_ptr< ResourceDescriptor > descriptor )
+{
+  resourceDescriptors[ int( type ) ] = eastl::move( descriptor );
+}
+
+ResourceDescriptor* NullResource::GetResourceDescriptor( ResourceDescriptorType type )
+{
+  return resourceDescriptors[ int( type ) ].get();
+}
+
+void NullResource::RemoveResourceDescriptor( ResourceDescriptorType type )
+{
+  resourceDescriptors[ int( type ) ].reset();
+}
+
+void NullResource::RemoveAllResourceDescriptors()
+{
+  for ( auto& descriptor : resourceDescriptors )
+    descriptor.reset();
+}
+
+ResourceState NullResource::GetCurrentResourceState() const
+{
+  return resourceState;
+}
+
+ResourceType NullResource::GetResourceType() const
+{
+  return resourceType;
+}
+
+bool NullResource::IsUploadResource() const
+{
+  return heapType == HeapType::Upload;
+}
+
+int NullResource::GetBufferSize() const
+{
+  return bufferSize;
+}
+
+int NullResource::GetTextureWidth() const
+{
+  return width;
+}
+
+int NullResource::GetTextureHeight() const
+{
+  return height;
+}
+
+int NullResource::GetTextureDepthOrArraySize() const
+{
+  return depth;
+}
+
+int NullResource::GetTextureMipLevels() const
+{
+  return mipLevels;
+}
+
+int NullResource::GetTextureTileWidth() const
+{
+  return tileWidth;
+}
+
+int NullResource::GetTextureTileHeight() const
+{
+  return tileHeight;
+}
+
+PixelFormat NullResource::GetTexturePixelFormat() const
+{
+  return pixelFormat;
+}
+
+uint64_t NullResource::GetVirtualAllocationSize() const
+{
+  if ( IsTexture() )
+    return CalcTextureSize();
+
+  return uint64_t( bufferSize );
+}
+
+uint64_t NullResource::GetPhysicalAllocationSize() const
+{
+  if ( reserved )
+    return uint64_t( mappedTileCount ) * TileSizeInBytes;
+
+  return GetVirtualAllocationSize();
+}
+
+void* NullResource::Map()
+{
+  ++mapCount;
+  return GetMemory().data();
+}
+
+void NullResource::Unmap()
+{
+  assert( mapCount > 0 );
+  --mapCount;
+}
+
+void NullResource::UploadLoadedTiles( Device& device, CommandQueue& copyQueue, CommandList& commandList )
+{
+  if ( streamingFileHandle )
+    streamingFileHandle->UploadLoadedTiles( device, copyQueue, commandList );
+}
+
+void NullResource::EndFeedback( CommandQueue& graphicsQueue, CommandQueue& copyQueue, Device& device, CommandList& commandList, uint64_t fence, uint64_t frameNo, int globalFeedback )
+{
+  // There is no sampler feedback to resolve, the mapped tiles stay as they are.
+}
+
+FileLoaderFile* NullResource::GetLoader()
+{
+  return streamingFileHandle.get();
+}
+
+void NullResource::SetLoader( eastl::unique_ptr< FileLoaderFile >&& fileHandle )
+{
+  streamingFileHandle = eastl::move( fileHandle );
+}
+
+void NullResource::UpdateTileMapping( int tileX, int tileY, int mip, MemoryHeap* heap, int heapStartOffsetInTiles )
+{
+  assert( reserved && mip < int( tileMappings.size() ) );
+
+  auto tilesX = ( eastl::max( width >> mip, 1 ) + tileWidth - 1 ) / tileWidth;
+  auto index  = tileY * tilesX + tileX;
+  assert( index < int( tileMappings[ mip ].size() ) );
+
+  auto& mapping = tileMappings[ mip ][ index ];
+  if ( mapping.heap && !heap )
+    --mappedTileCount;
+  else if ( !mapping.heap && heap )
+    ++mappedTileCount;
+
+  mapping.heap                   = heap;
+  mapping.heapStartOffsetInTiles = heap ? heapStartOffsetInTiles : -1;
+}
+
+const NullResource::TileMapping* NullResource::GetTileMapping( int tileX, int tileY, int mip ) const
+{
+  if ( mip >= int( tileMappings.size() ) )
+    return nullptr;
+
+  auto tilesX = ( eastl::max( width >> mip, 1 ) + tileWidth - 1 ) / tileWidth;
+  auto index  = tileY * tilesX + tileX;
+  return index < int( tileMappings[ mip ].size() ) ? &tileMappings[ mip ][ index ] : nullptr;
+}
+
+int NullResource::GetMappedTileCount() const
+{
+  return mappedTileCount;
+}
+
+eastl::vector< uint8_t >& NullResource::GetMemory()
+{
+  if ( memory.empty() && !reserved && IsTexture() )
+    memory.resize( size_t( CalcTextureSize() ) );
+
+  return memory;
+}
+
+const eastl::wstring& NullResource::GetDebugName() const
+{
+  return debugName;
+}
+
+uint64_t NullResource::CalcSurfaceSize( int width, int height, PixelFormat format )
+{
+  if ( auto blockSize = CalcBlockSize( format ) )
+    return uint64_t( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * blockSize;
+
+  return uint64_t( width ) * height * CalcTexelSize( format );
+}
+
+bool NullResource::IsTexture() const
+{
+  return resourceType == ResourceType::Texture1D || resourceType == ResourceType::Texture2D || resourceType == ResourceType::Texture3D;
+}
+
+uint64_t NullResource::CalcTextureSize() const
+{
+  if ( reserved )
+  {
+    uint64_t tileCount = 0;
+    for ( auto& mip : tileMappings )
+      tileCount += mip.size();
+    return tileCount * TileSizeInBytes;
+  }
+
+  uint64_t size = 0;
+  for ( int mip = 0; mip < mipLevels; ++mip )
+    size += CalcSurfaceSize( eastl::max( width >> mip, 1 ), eastl::max( height >> mip, 1 ), pixelFormat ) * depth;
+
+  return size;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../Resource.h"
+#include "../ResourceDescriptor.h"
+
+struct MemoryHeap;
+
+// A resource in CPU memory. Buffers are allocated up front, textures only when they are written or
+// mapped, as most of them are render targets which are never read on the CPU. Reserved textures
+// keep a table of their tile mappings instead of memory.
+class NullResource : public Resource
+{
+  friend class NullDevice;
+  friend class NullCommandList;
+
+public:
+  static constexpr int TileSizeInBytes = 64 * 1024;
+
+  struct TileMapping
+  {
+    MemoryHeap* heap                   = nullptr;
+    int         heapStartOffsetInTiles = -1;
+  };
+
+  NullResource( ResourceType resourceType, HeapType heapType, int size, int elementSize, const wchar_t* debugName );
+  NullResource( ResourceType resourceType, int width, int height, int depth, int mipLevels, PixelFormat format, ResourceState initialState, bool reserved, const wchar_t* debugName );
+  ~NullResource();
+
+  void                AttachResourceDescriptor( ResourceDescriptorType type, eastl::unique_ptr< ResourceDescriptor > descriptor ) override;
+  ResourceDescriptor* GetResourceDescriptor( ResourceDescriptorType type ) override;
+  void                RemoveResourceDescriptor( ResourceDescriptorType type ) override;
+  void                RemoveAllResourceDescriptors() override;
+
+  ResourceState GetCurrentResourceState() const override;
+
+  ResourceType GetResourceType() const override;
+  bool IsUploadResource() const override;
+
+  int GetBufferSize() const override;
+
+  int GetTextureWidth() const override;
+  int GetTextureHeight() const override;
+  int GetTextureDepthOrArraySize() const override;
+  int GetTextureMipLevels() const override;
+  int GetTextureTileWidth() const override;
+  int GetTextureTileHeight() const override;
+  PixelFormat GetTexturePixelFormat() const override;
+
+  uint64_t GetVirtualAllocationSize() const override;
+  uint64_t GetPhysicalAllocationSize() const override;
+
+  void* Map() override;
+  void  Unmap() override;
+
+  void UploadLoadedTiles( Device& device, CommandQueue& copyQueue, CommandList& commandList ) override;
+
+  void EndFeedback( CommandQueue& graphicsQueue, CommandQueue& copyQueue, Device& device, CommandList& commandList, uint64_t fence, uint64_t frameNo, int globalFeedback ) override;
+
+  FileLoaderFile* GetLoader() override;
+
+  void SetLoader( eastl::unique_ptr< FileLoaderFile >&& fileHandle );
+
+  // Null heap unmaps the tile.
+  void UpdateTileMapping( int tileX, int tileY, int mip, MemoryHeap* heap, int heapStartOffsetInTiles );
+  const TileMapping* GetTileMapping( int tileX, int tileY, int mip ) const;
+  int GetMappedTileCount() const;
+
+  // The contents, allocated on first use. Textures are stored as tightly packed mips.
+  eastl::vector< uint8_t >& GetMemory();
+
+  const eastl::wstring& GetDebugName() const;
+
+  static uint64_t CalcSurfaceSize( int width, int height, PixelFormat format );
+
+private:
+  bool     IsTexture() const;
+  uint64_t CalcTextureSize() const;
+
+  ResourceType  resourceType;
+  HeapType      heapType;
+  ResourceState resourceState;
+
+  int         bufferSize   = 0;
+  int         elementSize  = 0;
+  int         width        = 0;
+  int         height       = 0;
+  int         depth        = 1;
+  int         mipLevels    = 1;
+  int         tileWidth    = 0;
+  int         tileHeight   = 0;
+  PixelFormat pixelFormat  = PixelFormat::Unknown;
+  bool        reserved     = false;
+  int         mapCount     = 0;
+
+  eastl::vector< uint8_t > memory;
+
+  eastl::unique_ptr< ResourceDescriptor > resourceDescriptors[ int( ResourceDescriptorType::UnorderedAccessView ) + 1 ];
+
+  // Per mip, row major.
+  eastl::vector< eastl::vector< TileMapping > > tileMappings;
+  int                                            mappedTileCount = 0;
+
+  eastl::unique_ptr< FileLoaderFile > streamingFileHandle;
+
+  eastl::wstring debugName;
+};
\ No newline at end of file
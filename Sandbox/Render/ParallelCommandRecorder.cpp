@@ -0,0 +1,55 @@
+#include "ParallelCommandRecorder.h"
+#include "RenderManager.h"
+#include "CommandList.h"
+#include "Common/ParallelFor.h"
+
+void ParallelCommandRecorder::AddPass( const wchar_t* name, RecordFn&& record )
+{
+  passes.push_back( { name, eastl::move( record ) } );
+}
+
+ParallelCommandRecorder::RecordedLists ParallelCommandRecorder::Record( CommandQueueType queueType )
+{
+  auto& renderManager = RenderManager::GetInstance();
+
+  // The allocator pool and the queues are polled from this thread only, the workers just record.
+  RecordedLists commandLists( passes.size() );
+  for ( auto& commandList : commandLists )
+  {
+    commandList.second = renderManager.RequestCommandAllocator( queueType );
+    commandList.first  = renderManager.CreateCommandList( *commandList.second, queueType );
+  }
+
+  Record( commandLists );
+
+  return commandLists;
+}
+
+void ParallelCommandRecorder::Record( RecordedLists& commandLists )
+{
+  assert( commandLists.size() == passes.size() );
+
+  timings.resize( passes.size() );
+
+  ParallelFor( int( passes.size() ), 1, [ & ]( int begin, int end )
+  {
+    for ( int passIx = begin; passIx < end; ++passIx )
+    {
+      auto& pass      = passes[ passIx ];
+      auto  startTime = GetCPUTime();
+
+      CPUSection cpuSection( pass.name );
+      pass.record( *commandLists[ passIx ].first );
+      cpuSection.Close();
+
+      timings[ passIx ] = { pass.name, GetCPUTime() - startTime };
+    }
+  } );
+
+  passes.clear();
+}
+
+const eastl::vector< ParallelCommandRecorder::PassTiming >& ParallelCommandRecorder::GetTimings() const
+{
+  return timings;
+}
\ No newline at end of file
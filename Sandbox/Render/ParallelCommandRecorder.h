@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Types.h"
+
+struct CommandList;
+struct CommandAllocator;
+
+// Records independent passes into a command list each, in parallel. The lists come back in the order
+// the passes were added, to be submitted between the lists recorded before and after them.
+// Resource states are tracked on the resources, so a pass must not change the state of anything
+// another pass of the same batch touches. Shared inputs are transitioned before recording.
+class ParallelCommandRecorder
+{
+public:
+  using RecordFn      = eastl::function< void( CommandList& ) >;
+  using RecordedLists = eastl::vector< eastl::pair< eastl::unique_ptr< CommandList >, CommandAllocator* > >;
+
+  struct PassTiming
+  {
+    const wchar_t* name;
+    double         recordTime;
+  };
+
+  void AddPass( const wchar_t* name, RecordFn&& record );
+
+  // Records the passes added since the last call, and returns when all of them are done.
+  RecordedLists Record( CommandQueueType queueType );
+
+  // The same, into lists of the caller, one for each pass. The recording benchmark uses it with null lists.
+  void Record( RecordedLists& commandLists );
+
+  // CPU time spent recording each pass of the last batch, in seconds.
+  const eastl::vector< PassTiming >& GetTimings() const;
+
+private:
+  struct Pass
+  {
+    const wchar_t* name;
+    RecordFn       record;
+  };
+
+  eastl::vector< Pass >       passes;
+  eastl::vector< PassTiming > timings;
+};
\ No newline at end of file
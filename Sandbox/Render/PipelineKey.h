@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Types.h"
+
+// 64 bit FNV-1a, used to key the pipeline caches. The backends check the cached pipelines against
+// their descriptions, so a collision only costs a rebuild, never a wrong pipeline.
+inline uint64_t HashBytes( const void* data, size_t size, uint64_t hash = 0xCBF29CE484222325 )
+{
+  auto bytes = static_cast< const uint8_t* >( data );
+  for ( size_t byteIx = 0; byteIx < size; ++byteIx )
+  {
+    hash ^= bytes[ byteIx ];
+    hash *= 0x100000001B3;
+  }
+  return hash;
+}
+
+template< typename T >
+inline uint64_t HashValue( const T& value, uint64_t hash )
+{
+  return HashBytes( &value, sizeof( value ), hash );
+}
+
+// Field by field, so no padding ends up in the key.
+inline uint64_t HashPipelineDesc( const PipelineDesc& desc )
+{
+  uint64_t hash = HashBytes( desc.vsData, desc.vsSize );
+  hash = HashBytes( desc.psData, desc.psSize, hash );
+
+  auto& blend = desc.blendDesc;
+  hash = HashValue( blend.colorWrite, hash );
+  hash = HashValue( blend.alphaToCoverage, hash );
+  hash = HashValue( blend.alphaBlend, hash );
+  hash = HashValue( blend.colorBlendOperation, hash );
+  hash = HashValue( blend.alphaBlendOperation, hash );
+  hash = HashValue( blend.sourceColorBlend, hash );
+  hash = HashValue( blend.destinationColorBlend, hash );
+  hash = HashValue( blend.sourceAlphaBlend, hash );
+  hash = HashValue( blend.destinationAlphaBlend, hash );
+
+  auto& depthStencil = desc.depthStencilDesc;
+  hash = HashValue( depthStencil.depthFunction, hash );
+  hash = HashValue( depthStencil.depthTest, hash );
+  hash = HashValue( depthStencil.depthWrite, hash );
+  hash = HashValue( depthStencil.stencilEnable, hash );
+  hash = HashValue( depthStencil.stencilReadMask, hash );
+  hash = HashValue( depthStencil.stencilWriteMask, hash );
+  hash = HashValue( depthStencil.stencilFrontPass, hash );
+  hash = HashValue( depthStencil.stencilFrontFail, hash );
+  hash = HashValue( depthStencil.stencilFrontDepthFail, hash );
+  hash = HashValue( depthStencil.stencilFrontFunction, hash );
+  hash = HashValue( depthStencil.stencilBackPass, hash );
+  hash = HashValue( depthStencil.stencilBackFail, hash );
+  hash = HashValue( depthStencil.stencilBackDepthFail, hash );
+  hash = HashValue( depthStencil.stencilBackFunction, hash );
+
+  auto& rasterizer = desc.rasterizerDesc;
+  hash = HashValue( rasterizer.cullMode, hash );
+  hash = HashValue( rasterizer.cullFront, hash );
+  hash = HashValue( rasterizer.depthBias, hash );
+  hash = HashValue( rasterizer.conservative, hash );
+
+  for ( auto& element : desc.vertexDesc.elements )
+  {
+    if ( element.dataType == VertexDesc::Element::DataType::None )
+      break;
+
+    hash = HashValue( element.dataType, hash );
+    hash = HashValue( element.dataOffset, hash );
+    hash = HashBytes( element.elementName, strnlen( element.elementName, sizeof( element.elementName ) ), hash );
+    hash = HashValue( element.elementIndex, hash );
+  }
+  hash = HashValue( desc.vertexDesc.stride, hash );
+
+  hash = HashValue( desc.primitiveType, hash );
+  for ( auto format : desc.targetFormat )
+    hash = HashValue( format, hash );
+  hash = HashValue( desc.depthFormat, hash );
+  hash = HashValue( desc.samples, hash );
+  hash = HashValue( desc.sampleQuality, hash );
+  hash = HashValue( desc.indexSize, hash );
+
+  return hash;
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+// DXR and Vulkan both take the first three rows of the column major instance transform, which are the rows of the
+// transposed one.
+inline void PackRTTransform( const XMFLOAT4X4& transform, float ( &packed )[ 3 ][ 4 ] )
+{
+  auto transposed = XMMatrixTranspose( XMLoadFloat4x4( &transform ) );
+  XMStoreFloat4( reinterpret_cast< XMFLOAT4* >( packed[ 0 ] ), transposed.r[ 0 ] );
+  XMStoreFloat4( reinterpret_cast< XMFLOAT4* >( packed[ 1 ] ), transposed.r[ 1 ] );
+  XMStoreFloat4( reinterpret_cast< XMFLOAT4* >( packed[ 2 ] ), transposed.r[ 2 ] );
+}
+
+// The CPU side of the top level instance updates. It keeps the instance descriptors, a log of the instances changed
+// in each version, and a ring of mapped instance buffers the backend owns the memory of. A buffer is handed out again
+// once the fence it was retired with completes, and only the instances changed since its previous use are copied
+// into it. The fences are whatever the backend counts the uses of the buffers with.
+template< typename InstanceDesc >
+class RTInstanceRing
+{
+public:
+  // Returns the mapped memory of count descriptors for the buffer, replacing the previous memory of it if any.
+  using AllocateFunc = eastl::function< InstanceDesc*( int bufferIndex, int count ) >;
+
+  struct Buffer
+  {
+    InstanceDesc* mappedData = nullptr;
+    int           capacity   = 0;
+    uint64_t      version    = 0;
+    uint64_t      fence      = 0;
+  };
+
+  // Replaces every instance, each buffer is rewritten in full the next time it is acquired.
+  InstanceDesc* ResetInstances( int count )
+  {
+    instances.resize( count );
+    fullVersion = ++version;
+    changes.clear();
+    return instances.data();
+  }
+
+  // Starts a new version, the instances changed until the next one are logged with it.
+  void BeginChanges()
+  {
+    ++version;
+  }
+
+  InstanceDesc& ChangeInstance( int instanceIndex )
+  {
+    assert( instanceIndex >= 0 && instanceIndex < int( instances.size() ) );
+
+    changes.push_back( { version, instanceIndex } );
+    return instances[ instanceIndex ];
+  }
+
+  // Takes a buffer the GPU is done with, or a new one, and brings it up to date. The buffer is not handed out
+  // again until the fence given to RetireBuffer completes.
+  int AcquireBuffer( uint64_t completedFence, const AllocateFunc& allocateBuffer )
+  {
+    int instanceCount = eastl::max( int( instances.size() ), 1 );
+
+    int bufferIndex = -1;
+    for ( int bufferIx = 0; bufferIx < int( buffers.size() ) && bufferIndex < 0; ++bufferIx )
+      if ( buffers[ bufferIx ].fence <= completedFence )
+        bufferIndex = bufferIx;
+
+    if ( bufferIndex < 0 )
+    {
+      bufferIndex = int( buffers.size() );
+      buffers.emplace_back();
+    }
+
+    auto& buffer = buffers[ bufferIndex ];
+
+    if ( buffer.capacity < instanceCount )
+    {
+      buffer.mappedData = allocateBuffer( bufferIndex, instanceCount );
+      buffer.capacity   = instanceCount;
+      buffer.version    = 0;
+    }
+
+    auto firstChange = FindFirstChangeAfter( buffer.version );
+
+    if ( buffer.version < fullVersion || size_t( changes.end() - firstChange ) >= instances.size() )
+    {
+      memcpy( buffer.mappedData, instances.data(), sizeof( InstanceDesc ) * instances.size() );
+      lastCopyCount = int( instances.size() );
+    }
+    else
+    {
+      for ( auto change = firstChange; change != changes.end(); ++change )
+        buffer.mappedData[ change->instanceIndex ] = instances[ change->instanceIndex ];
+      lastCopyCount = int( changes.end() - firstChange );
+    }
+
+    buffer.version = version;
+    buffer.fence   = UINT64_MAX;
+
+    // Changes already in every buffer can be dropped.
+    auto oldestVersion = version;
+    for ( auto& otherBuffer : buffers )
+      oldestVersion = eastl::min( oldestVersion, eastl::max( otherBuffer.version, fullVersion ) );
+
+    changes.erase( changes.begin(), FindFirstChangeAfter( oldestVersion ) );
+
+    return bufferIndex;
+  }
+
+  void RetireBuffer( int bufferIndex, uint64_t fence )
+  {
+    buffers[ bufferIndex ].fence = fence;
+  }
+
+  int                 GetInstanceCount() const { return int( instances.size() ); }
+  const InstanceDesc* GetInstances() const { return instances.data(); }
+  int                 GetBufferCount() const { return int( buffers.size() ); }
+  const Buffer&       GetBuffer( int bufferIndex ) const { return buffers[ bufferIndex ]; }
+  int                 GetChangeCount() const { return int( changes.size() ); }
+
+  // The number of descriptors the last AcquireBuffer copied.
+  int GetLastCopyCount() const { return lastCopyCount; }
+
+private:
+  struct InstanceChange
+  {
+    uint64_t version;
+    int      instanceIndex;
+  };
+
+  typename eastl::vector< InstanceChange >::iterator FindFirstChangeAfter( uint64_t afterVersion )
+  {
+    return eastl::upper_bound( changes.begin(), changes.end(), afterVersion, []( uint64_t version, const InstanceChange& change )
+    {
+      return version < change.version;
+    } );
+  }
+
+  eastl::vector< InstanceDesc >   instances;
+  eastl::vector< InstanceChange > changes;
+  eastl::vector< Buffer >         buffers;
+
+  uint64_t version       = 1;
+  uint64_t fullVersion   = 1;
+  int      lastCopyCount = 0;
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 struct RTInstance;
+struct RTInstanceTransform;
 struct CommandList;
 struct Device;
 struct ResourceDescriptor;
@@ -9,7 +10,11 @@ struct RTTopLevelAccelerator
 {
   virtual ~RTTopLevelAccelerator() = default;
 
+  // Replaces the instances and builds the structure from scratch.
   virtual void Update( Device& device, CommandList& commandList, eastl::vector< RTInstance > instances ) = 0;
 
+  // Patches the transforms of the given instances only, the rest are kept from the previous update.
+  virtual void UpdateTransforms( Device& device, CommandList& commandList, const eastl::vector< RTInstanceTransform >& transforms ) = 0;
+
   virtual ResourceDescriptor& GetResourceDescriptor() = 0;
 };
\ No newline at end of file
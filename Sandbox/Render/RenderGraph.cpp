@@ -0,0 +1,305 @@
+#include "RenderGraph.h"
+#include "Device.h"
+#include "MemoryHeap.h"
+#include "Resource.h"
+
+static constexpr uint32_t readOnlyStates = ResourceStateBits::VertexOrConstantBuffer
+                                         | ResourceStateBits::IndexBuffer
+                                         | ResourceStateBits::DepthRead
+                                         | ResourceStateBits::PixelShaderInput
+                                         | ResourceStateBits::NonPixelShaderInput
+                                         | ResourceStateBits::IndirectArgument
+                                         | ResourceStateBits::CopySource
+                                         | ResourceStateBits::ResolveSource
+                                         | ResourceStateBits::GenericRead;
+
+static bool IsReadOnly( ResourceState state )
+{
+  return state.bits != 0 && ( state.bits & ~readOnlyStates ) == 0;
+}
+
+static uint64_t AlignUp( uint64_t value, uint64_t alignment )
+{
+  return ( value + alignment - 1 ) / alignment * alignment;
+}
+
+RenderGraph::Handle RenderGraph::ImportResource( Resource* resource )
+{
+  Node node;
+  node.resource = resource;
+  node.imported = true;
+  nodes.emplace_back( eastl::move( node ) );
+  compiled = false;
+  return Handle( nodes.size() - 1 );
+}
+
+RenderGraph::Handle RenderGraph::CreateTransientTexture( const TransientTextureDesc& desc )
+{
+  Node node;
+  node.desc = desc;
+  nodes.emplace_back( eastl::move( node ) );
+  compiled = false;
+  return Handle( nodes.size() - 1 );
+}
+
+void RenderGraph::SetImportedResource( Handle handle, Resource& resource )
+{
+  assert( nodes[ handle ].imported );
+  nodes[ handle ].resource = &resource;
+}
+
+int RenderGraph::AddPass( const wchar_t* name, PassFunction function )
+{
+  Pass pass;
+  pass.name     = name;
+  pass.function = eastl::move( function );
+  passes.emplace_back( eastl::move( pass ) );
+  compiled = false;
+  return int( passes.size() - 1 );
+}
+
+void RenderGraph::Use( int pass, Handle handle, ResourceState state )
+{
+  assert( pass >= 0 && pass < int( passes.size() ) );
+  assert( handle >= 0 && handle < int( nodes.size() ) );
+
+  auto& uses = nodes[ handle ].uses;
+
+  // Passes declare their uses in order, so the same pass can only be at the back
+  if ( !uses.empty() && uses.back().pass == pass )
+  {
+    uses.back().state.bits |= state.bits;
+  }
+  else
+  {
+    assert( uses.empty() || uses.back().pass < pass );
+    uses.push_back( { pass, state } );
+  }
+
+  compiled = false;
+}
+
+void RenderGraph::Compile( const SizeQuery& sizeQuery )
+{
+  using Type  = CommandList::ResourceBarrier::Type;
+  using Split = CommandList::ResourceBarrier::Split;
+
+  stats = Stats();
+
+  for ( auto& pass : passes )
+    pass.barriers.clear();
+
+  PlaceTransients( sizeQuery );
+
+  for ( int handle = 0; handle < int( nodes.size() ); ++handle )
+  {
+    auto& node = nodes[ handle ];
+    if ( node.uses.empty() )
+      continue;
+
+    // Runs of read only uses are merged, so one transition covers all of them
+    struct Segment
+    {
+      int           firstPass;
+      int           lastPass;
+      ResourceState state;
+    };
+
+    eastl::vector< Segment > segments;
+    for ( auto& use : node.uses )
+    {
+      if ( !segments.empty() && IsReadOnly( segments.back().state ) && IsReadOnly( use.state ) )
+      {
+        segments.back().lastPass    = use.pass;
+        segments.back().state.bits |= use.state.bits;
+      }
+      else
+        segments.push_back( { use.pass, use.pass, use.state } );
+    }
+
+    if ( !node.imported )
+    {
+      bool aliased = false;
+      for ( int other = 0; other < int( nodes.size() ) && !aliased; ++other )
+      {
+        auto& otherNode = nodes[ other ];
+        if ( other == handle || otherNode.imported || otherNode.uses.empty() )
+          continue;
+        aliased = node.offset < otherNode.offset + otherNode.size && otherNode.offset < node.offset + node.size;
+      }
+
+      if ( aliased )
+        passes[ segments.front().firstPass ].barriers.push_back( { Type::Aliasing, Split::None, handle, ResourceState() } );
+    }
+
+    passes[ segments.front().firstPass ].barriers.push_back( { Type::Transition, Split::None, handle, segments.front().state } );
+
+    for ( int segIx = 1; segIx < int( segments.size() ); ++segIx )
+    {
+      auto& prev = segments[ segIx - 1 ];
+      auto& curr = segments[ segIx ];
+
+      // With passes between the uses, the transition can overlap with them
+      if ( curr.firstPass - prev.lastPass > 1 )
+      {
+        passes[ prev.lastPass + 1 ].barriers.push_back( { Type::Transition, Split::Begin, handle, curr.state } );
+        passes[ curr.firstPass ].barriers.push_back( { Type::Transition, Split::End, handle, curr.state } );
+      }
+      else
+        passes[ curr.firstPass ].barriers.push_back( { Type::Transition, Split::None, handle, curr.state } );
+    }
+  }
+
+  stats.passCount = int( passes.size() );
+  for ( auto& pass : passes )
+  {
+    if ( !pass.barriers.empty() )
+      ++stats.batchCount;
+
+    stats.barrierCount += int( pass.barriers.size() );
+    for ( auto& barrier : pass.barriers )
+    {
+      if ( barrier.type == Type::Aliasing )
+        ++stats.aliasingBarrierCount;
+      else if ( barrier.split == Split::Begin )
+        ++stats.splitBarrierCount;
+    }
+  }
+
+  compiled = true;
+}
+
+void RenderGraph::PlaceTransients( const SizeQuery& sizeQuery )
+{
+  eastl::vector< Handle > transients;
+  for ( int handle = 0; handle < int( nodes.size() ); ++handle )
+  {
+    auto& node = nodes[ handle ];
+    if ( node.imported || node.uses.empty() )
+      continue;
+
+    node.firstPass = node.uses.front().pass;
+    node.lastPass  = node.uses.back().pass;
+    node.size      = AlignUp( sizeQuery( node.desc.width, node.desc.height, node.desc.format ), HeapAlignment );
+    node.offset    = 0;
+
+    stats.transientMemory += node.size;
+    transients.push_back( handle );
+  }
+
+  eastl::sort( transients.begin(), transients.end(), [ this ]( Handle a, Handle b )
+  {
+    return nodes[ a ].size > nodes[ b ].size;
+  } );
+
+  // Largest first, each at the lowest offset free from the placed ones living at the same time
+  eastl::vector< Handle > placed;
+  for ( auto handle : transients )
+  {
+    auto& node = nodes[ handle ];
+
+    eastl::vector< Handle > conflicts;
+    for ( auto other : placed )
+    {
+      auto& otherNode = nodes[ other ];
+      if ( node.firstPass <= otherNode.lastPass && otherNode.firstPass <= node.lastPass )
+        conflicts.push_back( other );
+    }
+
+    eastl::sort( conflicts.begin(), conflicts.end(), [ this ]( Handle a, Handle b )
+    {
+      return nodes[ a ].offset < nodes[ b ].offset;
+    } );
+
+    uint64_t offset = 0;
+    for ( auto other : conflicts )
+    {
+      auto& otherNode = nodes[ other ];
+      if ( offset + node.size <= otherNode.offset )
+        break;
+      offset = eastl::max( offset, otherNode.offset + otherNode.size );
+    }
+
+    node.offset    = offset;
+    stats.heapSize = eastl::max( stats.heapSize, offset + node.size );
+    placed.push_back( handle );
+  }
+}
+
+void RenderGraph::Realize( Device& device )
+{
+  assert( compiled );
+
+  if ( stats.heapSize == 0 )
+    return;
+
+  heap = device.CreateMemoryHeap( stats.heapSize, L"RenderGraph" );
+
+  for ( auto& node : nodes )
+  {
+    if ( node.imported || node.uses.empty() )
+      continue;
+
+    node.transient = device.CreatePlaced2DTexture( *heap, node.offset, node.desc.width, node.desc.height, node.desc.format, node.desc.slot, node.desc.uavSlot, node.desc.name );
+    node.resource  = node.transient.get();
+  }
+}
+
+void RenderGraph::Execute( CommandList& commandList )
+{
+  assert( compiled );
+
+  eastl::vector< CommandList::ResourceBarrier > batch;
+
+  for ( auto& pass : passes )
+  {
+    batch.clear();
+    for ( auto& barrier : pass.barriers )
+    {
+      assert( nodes[ barrier.handle ].resource );
+      batch.push_back( { barrier.type, barrier.split, nodes[ barrier.handle ].resource, barrier.state } );
+    }
+
+    if ( !batch.empty() )
+      commandList.AddBarriers( batch.data(), int( batch.size() ) );
+
+    GPUSection gpuSection( commandList, pass.name );
+    pass.function( commandList, *this );
+  }
+}
+
+void RenderGraph::TearDown( CommandList& commandList )
+{
+  for ( auto& node : nodes )
+  {
+    if ( node.imported )
+      continue;
+
+    commandList.HoldResource( eastl::move( node.transient ) );
+    node.resource = nullptr;
+  }
+
+  commandList.HoldResource( eastl::move( heap ) );
+}
+
+Resource& RenderGraph::GetResource( Handle handle )
+{
+  assert( nodes[ handle ].resource );
+  return *nodes[ handle ].resource;
+}
+
+const eastl::vector< RenderGraph::Barrier >& RenderGraph::GetBarriers( int pass ) const
+{
+  return passes[ pass ].barriers;
+}
+
+uint64_t RenderGraph::GetHeapOffset( Handle handle ) const
+{
+  assert( !nodes[ handle ].imported );
+  return nodes[ handle ].offset;
+}
+
+const RenderGraph::Stats& RenderGraph::GetStats() const
+{
+  return stats;
+}
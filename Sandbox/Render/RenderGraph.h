@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Types.h"
+#include "CommandList.h"
+
+struct Device;
+struct Resource;
+struct MemoryHeap;
+
+// Records passes with the resources they use, and places the barriers between them.
+// Transient textures only live from their first to their last use, and the ones with
+// disjoint lifetimes share memory in one heap.
+class RenderGraph
+{
+public:
+  using Handle       = int;
+  using PassFunction = eastl::function< void( CommandList&, RenderGraph& ) >;
+  using SizeQuery    = eastl::function< uint64_t( int width, int height, PixelFormat format ) >;
+
+  static constexpr Handle   InvalidHandle = -1;
+  static constexpr uint64_t HeapAlignment = 64 * 1024;
+
+  struct TransientTextureDesc
+  {
+    int            width;
+    int            height;
+    PixelFormat    format;
+    int            slot;
+    int            uavSlot;
+    const wchar_t* name;
+  };
+
+  struct Barrier
+  {
+    CommandList::ResourceBarrier::Type  type;
+    CommandList::ResourceBarrier::Split split;
+    Handle                              handle;
+    ResourceState                       state;
+  };
+
+  struct Stats
+  {
+    int      passCount            = 0;
+    int      barrierCount         = 0;
+    int      batchCount           = 0;
+    int      splitBarrierCount    = 0;
+    int      aliasingBarrierCount = 0;
+    uint64_t transientMemory      = 0;
+    uint64_t heapSize             = 0;
+  };
+
+  Handle ImportResource( Resource* resource );
+  Handle CreateTransientTexture( const TransientTextureDesc& desc );
+
+  // Imported resources can change between frames, like the back buffer, and can be set late.
+  void SetImportedResource( Handle handle, Resource& resource );
+
+  int  AddPass( const wchar_t* name, PassFunction function );
+  void Use( int pass, Handle handle, ResourceState state );
+
+  // Builds the barrier batches and the transient placement. Doesn't touch the device,
+  // the sizes of the transient textures come from the query.
+  void Compile( const SizeQuery& sizeQuery );
+
+  // Creates the heap and the transient textures in it.
+  void Realize( Device& device );
+
+  void Execute( CommandList& commandList );
+
+  // Hands the transient textures and the heap to the command list, they are released when the GPU is done with it.
+  void TearDown( CommandList& commandList );
+
+  Resource& GetResource( Handle handle );
+
+  const eastl::vector< Barrier >& GetBarriers( int pass ) const;
+  uint64_t                        GetHeapOffset( Handle handle ) const;
+  const Stats&                    GetStats() const;
+
+private:
+  struct ResourceUse
+  {
+    int           pass;
+    ResourceState state;
+  };
+
+  struct Node
+  {
+    Resource*                     resource = nullptr;
+    eastl::unique_ptr< Resource > transient;
+    TransientTextureDesc          desc     = {};
+    bool                          imported = false;
+    eastl::vector< ResourceUse >  uses;
+    int                           firstPass = -1;
+    int                           lastPass  = -1;
+    uint64_t                      size      = 0;
+    uint64_t                      offset    = 0;
+  };
+
+  struct Pass
+  {
+    const wchar_t*           name;
+    PassFunction             function;
+    eastl::vector< Barrier > barriers;
+  };
+
+  void PlaceTransients( const SizeQuery& sizeQuery );
+
+  eastl::unique_ptr< MemoryHeap > heap;
+
+  eastl::vector< Node > nodes;
+  eastl::vector< Pass > passes;
+
+  Stats stats;
+
+  bool compiled = false;
+};
@@ -10,6 +10,7 @@
 #include "DescriptorHeap.h"
 #include "Mesh.h"
 #include "RTTopLevelAccelerator.h"
+#include "RTBottomLevelAccelerator.h"
 #include "ShaderStructures.h"
 #include "ShaderValues.h"
 #include "CommandQueueManager.h"
@@ -17,7 +18,10 @@
 #include "CommandAllocatorPool.h"
 #include "CommandList.h"
 #include "ComputeShader.h"
-#include "Common/Files.h"
+#include "UploadAllocator.h"
+#include "DeferredReleaseQueue.h"
+#include "MemoryHeap.h"
+#include "ShaderPackage.h"
 #include "Platform/Window.h"
 
 #include "TextureStreamers/TextureStreamer_Immediate.h"
@@ -25,9 +29,9 @@
 
 RenderManager* RenderManager::instance = nullptr;
 
-bool RenderManager::CreateInstance( eastl::shared_ptr< Window > window )
+bool RenderManager::CreateInstance( eastl::shared_ptr< Window > window, bool headless )
 {
-  instance = new RenderManager( window );
+  instance = new RenderManager( window, headless );
   return true;
 }
 
@@ -51,6 +55,8 @@ void RenderManager::UpdateBeforeFrame( CommandList& commandList )
 
 TextureStreamer::UpdateResult RenderManager::UpdateAfterFrame( CommandList& commandList, uint64_t fence )
 {
+  CPUSection cpuSection( L"Update texture streaming" );
+
   #if TEXTURE_STREAMING_MODE != TEXTURE_STREAMING_OFF
     if ( pendingGlobalTextureReadbackFence )
     {
@@ -236,41 +242,39 @@ uint64_t RenderManager::Submit( eastl::unique_ptr<CommandList>&& commandList, Co
 
 uint64_t RenderManager::Submit( eastl::vector< eastl::unique_ptr< CommandList > >&& commandLists, CommandQueueType queueType, bool wait )
 {
+  CPUSection cpuSection( L"Submit" );
+
   auto& queue      = commandQueueManager->GetQueue( queueType );
   auto  fenceValue = queue.Submit( commandLists );
+
+  for ( auto& commandList : commandLists )
+    commandList->GetUploadAllocator().Retire( queueType, fenceValue );
+
   if ( wait )
     queue.WaitForFence( fenceValue );
   else
   {
+    auto& releaseQueue = releaseQueues[ int( queueType ) ];
+
     for ( auto& commandList : commandLists )
     {
-      auto heldResources = commandList->TakeHeldResources();
-      if ( !heldResources.empty() )
-      {
-        auto& hold = stagingResources[ queueType ][ fenceValue ];
-        eastl::move( heldResources.begin(), heldResources.end(), eastl::back_inserter( hold ) );
-      }
+      for ( auto& resource : commandList->TakeHeldResources() )
+        releaseQueue.Release( fenceValue, eastl::move( resource ) );
 
-      auto heldTLAS = commandList->TakeHeldTLAS();
-      if ( !heldTLAS.empty() )
-      {
-        auto& hold = stagingTLAS[ queueType ][ fenceValue ];
-        eastl::move( heldTLAS.begin(), heldTLAS.end(), eastl::back_inserter( hold ) );
-      }
+      for ( auto& tlas : commandList->TakeHeldTLAS() )
+        releaseQueue.Release( fenceValue, eastl::move( tlas ) );
 
-      auto heldUnknowns = commandList->TakeHeldUnknowns();
-      if ( !heldUnknowns.empty() )
-      {
-        auto& hold = stagingUnknowns[ queueType ][ fenceValue ];
-        eastl::move( heldUnknowns.begin(), heldUnknowns.end(), eastl::back_inserter( hold ) );
-      }
+      for ( auto& blas : commandList->TakeHeldBLAS() )
+        releaseQueue.Release( fenceValue, eastl::move( blas ) );
 
-      auto newEndFrameCallbacks = commandList->TakeEndFrameCallbacks();
-      if ( !newEndFrameCallbacks.empty() )
-      {
-        auto& hold = endFrameCallbacks[ queueType ][ fenceValue ];
-        eastl::move( newEndFrameCallbacks.begin(), newEndFrameCallbacks.end(), eastl::back_inserter( hold ) );
-      }
+      for ( auto& unknown : commandList->TakeHeldUnknowns() )
+        releaseQueue.Release( fenceValue, eastl::move( unknown ) );
+
+      for ( auto& heap : commandList->TakeHeldHeaps() )
+        releaseQueue.Release( fenceValue, eastl::move( heap ) );
+
+      for ( auto& callback : commandList->TakeEndFrameCallbacks() )
+        releaseQueue.Release( fenceValue, eastl::move( callback ) );
     }
   }
   return fenceValue;
@@ -278,6 +282,8 @@ uint64_t RenderManager::Submit( eastl::vector< eastl::unique_ptr< CommandList >
 
 uint64_t RenderManager::Present( uint64_t fenceValue, bool useVSync )
 {
+  CPUSection cpuSection( L"Present" );
+
   return swapchain->Present( fenceValue, useVSync );
 }
 
@@ -342,81 +348,17 @@ void RenderManager::TidyUp()
 {
   for ( int queueType = 0; queueType < 3; ++queueType )
   {
-    auto& queue     = commandQueueManager->GetQueue( CommandQueueType( queueType ) );
-    auto& resources = stagingResources[ CommandQueueType( queueType ) ];
-    auto& tlas      = stagingTLAS[ CommandQueueType( queueType ) ];
-    auto& unknowns  = stagingUnknowns[ CommandQueueType( queueType ) ];
-    auto& efcs      = endFrameCallbacks[ CommandQueueType( queueType ) ];
-
-    for ( auto iter = resources.begin(); iter != resources.end(); )
-    {
-      if ( queue.IsFenceComplete( iter->first ) )
-      {
-        for ( auto& resource : iter->second )
-        {
-          if ( resource->IsUploadResource() && resource->GetResourceType() == ResourceType::Buffer )
-            ReuseUploadConstantBuffer( eastl::move( resource ) );
-        }
-        iter = resources.erase( iter );
-      }
-      else
-        ++iter;
-    }
-
-    for ( auto iter = tlas.begin(); iter != tlas.end(); )
-    {
-      if ( queue.IsFenceComplete( iter->first ) )
-        iter = tlas.erase( iter );
-      else
-        ++iter;
-    }
-
-    for ( auto iter = unknowns.begin(); iter != unknowns.end(); )
-    {
-      if ( queue.IsFenceComplete( iter->first ) )
-        iter = unknowns.erase( iter );
-      else
-        ++iter;
-    }
-
-    for ( auto iter = efcs.begin(); iter != efcs.end(); )
-    {
-      if ( queue.IsFenceComplete( iter->first ) )
-      {
-        for ( auto& efc : iter->second )
-          efc();
-        iter = efcs.erase( iter );
-      }
-      else
-        ++iter;
-    }
-  }
-}
-
-eastl::unique_ptr<Resource> RenderManager::GetUploadBufferForSize( int size )
-{
-  eastl::lock_guard< eastl::mutex > lock( uploadBuffersLock );
+    auto& queue          = commandQueueManager->GetQueue( CommandQueueType( queueType ) );
+    auto  completedFence = queue.GetLastCompletedFenceValue();
 
-  auto iter = uploadBuffers.find( size );
-  if ( iter == uploadBuffers.end() || iter->second.empty() )
-    return device->CreateBuffer( ResourceType::Buffer, HeapType::Upload, false, size, 0, L"UploadCB" );
-  else
-  {
-    auto buffer = eastl::move( iter->second.back() );
-    iter->second.pop_back();
-    return buffer;
+    device->GetUploadPagePool().RecyclePages( CommandQueueType( queueType ), completedFence );
+    releaseQueues[ queueType ].Collect( completedFence );
   }
 }
 
-eastl::unique_ptr< Resource > RenderManager::GetUploadBufferForResource( Resource& resource )
+bool RenderManager::IsHeadless() const
 {
-  return GetUploadBufferForSize( device->GetUploadSizeForResource( resource ) );
-}
-
-void RenderManager::ReuseUploadConstantBuffer( eastl::unique_ptr< Resource > buffer )
-{
-  auto bufferSize = buffer->GetBufferSize();
-  uploadBuffers[ bufferSize ].emplace_back( eastl::move( buffer ) );
+  return headless;
 }
 
 Device& RenderManager::GetDevice()
@@ -429,12 +371,15 @@ Swapchain& RenderManager::GetSwapchain()
   return *swapchain;
 }
 
-RenderManager::RenderManager( eastl::shared_ptr< Window > window )
+RenderManager::RenderManager( eastl::shared_ptr< Window > window, bool headless )
   : window( window )
+  , headless( headless )
 {
-  Device::EnableDebugExtensions();
+  if ( !headless )
+    Device::EnableDebugExtensions();
 
-  factory = Factory::Create();
+  // The headless backend only records the command lists, to run the renderer without a GPU.
+  factory = headless ? Factory::CreateNull() : Factory::Create();
   adapter = factory->CreateDefaultAdapter();
   device  = adapter->CreateDevice();
 
@@ -449,17 +394,17 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
   device->PreallocateTiles( commandQueueManager->GetQueue( CommandQueueType::Direct ) );
 
   {
-    auto vertexShader = ReadFileToMemory( L"Content/Shaders/ModelTranslucentVS.cso" );
-    auto  pixelShader = ReadFileToMemory( L"Content/Shaders/ModelTranslucentPS.cso" );
+    auto vertexShader = ShaderPackage::GetInstance().GetShader( L"ModelTranslucentVS" );
+    auto  pixelShader = ShaderPackage::GetInstance().GetShader( L"ModelTranslucentPS" );
 
     PipelineDesc pipelineDesc;
 
     pipelineDesc.depthStencilDesc.depthWrite    = false;
     pipelineDesc.blendDesc                      = BlendDesc( BlendPreset::Blend );
-    pipelineDesc.vsData                         = vertexShader.data();
-    pipelineDesc.psData                         = pixelShader.data();
-    pipelineDesc.vsSize                         = vertexShader.size();
-    pipelineDesc.psSize                         = pixelShader.size();
+    pipelineDesc.vsData                         = vertexShader.data;
+    pipelineDesc.psData                         = pixelShader.data;
+    pipelineDesc.vsSize                         = vertexShader.size;
+    pipelineDesc.psSize                         = pixelShader.size;
     pipelineDesc.targetFormat[ 0 ]              = RenderManager::HDRFormat;
     pipelineDesc.depthFormat                    = RenderManager::DepthFormat;
     pipelineDesc.samples                        = msaaSamples;
@@ -471,16 +416,16 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
   }
 
   {
-    auto vertexShader = ReadFileToMemory( L"Content/Shaders/ModelDepthVS.cso" );
-    auto  pixelShader = ReadFileToMemory( L"Content/Shaders/ModelDepthPS.cso" );
+    auto vertexShader = ShaderPackage::GetInstance().GetShader( L"ModelDepthVS" );
+    auto  pixelShader = ShaderPackage::GetInstance().GetShader( L"ModelDepthPS" );
 
     PipelineDesc pipelineDesc;
 
     pipelineDesc.blendDesc         = BlendDesc( BlendPreset::DirectWrite );
-    pipelineDesc.vsData            = vertexShader.data();
-    pipelineDesc.psData            = pixelShader.data();
-    pipelineDesc.vsSize            = vertexShader.size();
-    pipelineDesc.psSize            = pixelShader.size();
+    pipelineDesc.vsData            = vertexShader.data;
+    pipelineDesc.psData            = pixelShader.data;
+    pipelineDesc.vsSize            = vertexShader.size;
+    pipelineDesc.psSize            = pixelShader.size;
     pipelineDesc.targetFormat[ 0 ] = RenderManager::MotionVectorFormat;
     pipelineDesc.targetFormat[ 1 ] = RenderManager::TextureMipFormat;
     pipelineDesc.targetFormat[ 2 ] = RenderManager::GeometryIdsFormat;
@@ -496,16 +441,16 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
 
 
   {
-    auto vertexShader = ReadFileToMemory( L"Content/Shaders/ModelDepthVS.cso" );
-    auto  pixelShader = ReadFileToMemory( L"Content/Shaders/ModelDepthAtestPS.cso" );
+    auto vertexShader = ShaderPackage::GetInstance().GetShader( L"ModelDepthVS" );
+    auto  pixelShader = ShaderPackage::GetInstance().GetShader( L"ModelDepthAtestPS" );
 
     PipelineDesc pipelineDesc;
 
     pipelineDesc.blendDesc         = BlendDesc( BlendPreset::DirectWrite );
-    pipelineDesc.vsData            = vertexShader.data();
-    pipelineDesc.psData            = pixelShader.data();
-    pipelineDesc.vsSize            = vertexShader.size();
-    pipelineDesc.psSize            = pixelShader.size();
+    pipelineDesc.vsData            = vertexShader.data;
+    pipelineDesc.psData            = pixelShader.data;
+    pipelineDesc.vsSize            = vertexShader.size;
+    pipelineDesc.psSize            = pixelShader.size;
     pipelineDesc.targetFormat[ 0 ] = RenderManager::MotionVectorFormat;
     pipelineDesc.targetFormat[ 1 ] = RenderManager::TextureMipFormat;
     pipelineDesc.targetFormat[ 2 ] = RenderManager::GeometryIdsFormat;
@@ -520,18 +465,18 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
   }
 
   {
-    auto vertexShader = ReadFileToMemory( L"Content/Shaders/SkyVS.cso" );
-    auto  pixelShader = ReadFileToMemory( L"Content/Shaders/SkyPS.cso" );
+    auto vertexShader = ShaderPackage::GetInstance().GetShader( L"SkyVS" );
+    auto  pixelShader = ShaderPackage::GetInstance().GetShader( L"SkyPS" );
 
     PipelineDesc pipelineDesc;
 
     pipelineDesc.depthStencilDesc.depthWrite = false;
     pipelineDesc.rasterizerDesc.cullMode     = RasterizerDesc::CullMode::None;
     pipelineDesc.blendDesc                   = BlendDesc( BlendPreset::DirectWrite );
-    pipelineDesc.vsData                      = vertexShader.data();
-    pipelineDesc.psData                      = pixelShader.data();
-    pipelineDesc.vsSize                      = vertexShader.size();
-    pipelineDesc.psSize                      = pixelShader.size();
+    pipelineDesc.vsData                      = vertexShader.data;
+    pipelineDesc.psData                      = pixelShader.data;
+    pipelineDesc.vsSize                      = vertexShader.size;
+    pipelineDesc.psSize                      = pixelShader.size;
     pipelineDesc.targetFormat[ 0 ]           = RenderManager::HDRFormat;
     pipelineDesc.depthFormat                 = RenderManager::DepthFormat;
     pipelineDesc.samples                     = msaaSamples;
@@ -547,8 +492,8 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
   }
 
   {
-    auto vertexShader = ReadFileToMemory( L"Content/Shaders/ToneMappingVS.cso" );
-    auto  pixelShader = ReadFileToMemory( L"Content/Shaders/ToneMappingPS.cso" );
+    auto vertexShader = ShaderPackage::GetInstance().GetShader( L"ToneMappingVS" );
+    auto  pixelShader = ShaderPackage::GetInstance().GetShader( L"ToneMappingPS" );
 
     PipelineDesc pipelineDesc;
 
@@ -556,10 +501,10 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
     pipelineDesc.depthStencilDesc.depthWrite = false;
     pipelineDesc.rasterizerDesc.cullMode     = RasterizerDesc::CullMode::None;
     pipelineDesc.blendDesc                   = BlendDesc( BlendPreset::DirectWrite );
-    pipelineDesc.vsData                      = vertexShader.data();
-    pipelineDesc.psData                      = pixelShader.data();
-    pipelineDesc.vsSize                      = vertexShader.size();
-    pipelineDesc.psSize                      = pixelShader.size();
+    pipelineDesc.vsData                      = vertexShader.data;
+    pipelineDesc.psData                      = pixelShader.data;
+    pipelineDesc.vsSize                      = vertexShader.size;
+    pipelineDesc.psSize                      = pixelShader.size;
     pipelineDesc.targetFormat[ 0 ]           = RenderManager::SDRFormat;
     pipelineDesc.depthFormat                 = PixelFormat::Unknown;
     pipelineDesc.samples                     = 1;
@@ -568,8 +513,8 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
   }
 
   {
-    auto vertexShader = ReadFileToMemory( L"Content/Shaders/DirectLightingVS.cso" );
-    auto  pixelShader = ReadFileToMemory( L"Content/Shaders/DirectLightingPS.cso" );
+    auto vertexShader = ShaderPackage::GetInstance().GetShader( L"DirectLightingVS" );
+    auto  pixelShader = ShaderPackage::GetInstance().GetShader( L"DirectLightingPS" );
 
     PipelineDesc pipelineDesc;
 
@@ -577,10 +522,10 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
     pipelineDesc.depthStencilDesc.depthWrite = false;
     pipelineDesc.rasterizerDesc.cullMode     = RasterizerDesc::CullMode::None;
     pipelineDesc.blendDesc                   = BlendDesc( BlendPreset::DirectWrite );
-    pipelineDesc.vsData                      = vertexShader.data();
-    pipelineDesc.psData                      = pixelShader.data();
-    pipelineDesc.vsSize                      = vertexShader.size();
-    pipelineDesc.psSize                      = pixelShader.size();
+    pipelineDesc.vsData                      = vertexShader.data;
+    pipelineDesc.psData                      = pixelShader.data;
+    pipelineDesc.vsSize                      = vertexShader.size;
+    pipelineDesc.psSize                      = pixelShader.size;
     pipelineDesc.targetFormat[ 0 ]           = RenderManager::HDRFormat;
     pipelineDesc.depthFormat                 = PixelFormat::Unknown;
     pipelineDesc.samples                     = 1;
@@ -589,18 +534,18 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
   }
 
   {
-    auto vertexShader = ReadFileToMemory( L"Content/Shaders/ScreenQuadVS.cso" );
-    auto  pixelShader = ReadFileToMemory( L"Content/Shaders/ScreenQuadPS.cso" );
+    auto vertexShader = ShaderPackage::GetInstance().GetShader( L"ScreenQuadVS" );
+    auto  pixelShader = ShaderPackage::GetInstance().GetShader( L"ScreenQuadPS" );
 
     PipelineDesc pipelineDesc;
     pipelineDesc.rasterizerDesc.cullMode        = RasterizerDesc::CullMode::None;
     pipelineDesc.depthStencilDesc.depthFunction = DepthStencilDesc::Comparison::Always;
     pipelineDesc.depthStencilDesc.depthWrite    = false;
     pipelineDesc.blendDesc                      = BlendDesc( BlendPreset::DirectWrite );
-    pipelineDesc.vsData                         = vertexShader.data();
-    pipelineDesc.psData                         = pixelShader.data();
-    pipelineDesc.vsSize                         = vertexShader.size();
-    pipelineDesc.psSize                         = pixelShader.size();
+    pipelineDesc.vsData                         = vertexShader.data;
+    pipelineDesc.psData                         = pixelShader.data;
+    pipelineDesc.vsSize                         = vertexShader.size;
+    pipelineDesc.psSize                         = pixelShader.size;
     pipelineDesc.targetFormat[ 0 ]              = RenderManager::SDRFormat;
     pipelineDesc.depthFormat                    = PixelFormat::Unknown;
     pipelineDesc.samples                        = 1;
@@ -609,18 +554,18 @@ RenderManager::RenderManager( eastl::shared_ptr< Window > window )
   }
 
   {
-    auto vertexShader = ReadFileToMemory( L"Content/Shaders/DSTransferBufferDebugVS.cso" );
-    auto  pixelShader = ReadFileToMemory( L"Content/Shaders/DSTransferBufferDebugPS.cso" );
+    auto vertexShader = ShaderPackage::GetInstance().GetShader( L"DSTransferBufferDebugVS" );
+    auto  pixelShader = ShaderPackage::GetInstance().GetShader( L"DSTransferBufferDebugPS" );
 
     PipelineDesc pipelineDesc;
     pipelineDesc.rasterizerDesc.cullMode        = RasterizerDesc::CullMode::None;
     pipelineDesc.depthStencilDesc.depthFunction = DepthStencilDesc::Comparison::Always;
     pipelineDesc.depthStencilDesc.depthWrite    = false;
     pipelineDesc.blendDesc                      = BlendDesc( BlendPreset::DirectWrite );
-    pipelineDesc.vsData                         = vertexShader.data();
-    pipelineDesc.psData                         = pixelShader.data();
-    pipelineDesc.vsSize                         = vertexShader.size();
-    pipelineDesc.psSize                         = pixelShader.size();
+    pipelineDesc.vsData                         = vertexShader.data;
+    pipelineDesc.psData                         = pixelShader.data;
+    pipelineDesc.vsSize                         = vertexShader.size;
+    pipelineDesc.psSize                         = pixelShader.size;
     pipelineDesc.targetFormat[ 0 ]              = RenderManager::SDRFormat;
     pipelineDesc.depthFormat                    = PixelFormat::Unknown;
     pipelineDesc.samples                        = 1;
@@ -653,8 +598,8 @@ RenderManager::~RenderManager()
   // We need to destruct all objects in the correct order!
 
   commandQueueManager->IdleGPU();
-  stagingResources.clear();
-  uploadBuffers.clear();
+  for ( auto& releaseQueue : releaseQueues )
+    releaseQueue.Clear();
   randomTexture.reset();
   globalTextureFeedbackBuffer.reset();
   globalTextureFeedbackReadbackBuffer.reset();
@@ -701,3 +646,8 @@ TextureStreamer::MemoryStats RenderManager::GetMemoryStats() const
 {
   return textureStreamer->GetMemoryStats();
 }
+
+CommandAllocatorPool::Stats RenderManager::GetCommandAllocatorStats( CommandQueueType queueType ) const
+{
+  return commandQueueManager->GetAllocatorPool( queueType ).GetStats();
+}
@@ -3,6 +3,8 @@
 #include "Types.h"
 #include "ShaderStructures.h"
 #include "TextureStreamers/TextureStreamer.h"
+#include "DeferredReleaseQueue.h"
+#include "CommandAllocatorPool.h"
 
 struct Window;
 struct Factory;
@@ -39,7 +41,7 @@ public:
   static constexpr PixelFormat TextureMipFormat   = PixelFormat::R16F;
   static constexpr PixelFormat GeometryIdsFormat  = PixelFormat::RG1616U;
 
-  static bool           CreateInstance( eastl::shared_ptr< Window > window );
+  static bool           CreateInstance( eastl::shared_ptr< Window > window, bool headless = false );
   static RenderManager& GetInstance();
   static void           DeleteInstance();
 
@@ -62,6 +64,9 @@ public:
   uint64_t Submit( eastl::vector< eastl::unique_ptr< CommandList > >&& commandLists, CommandQueueType queueType, bool wait );
   uint64_t Present( uint64_t fenceValue, bool useVSync );
 
+  // True on the null backend, nothing is executed and the vendor libraries are not available.
+  bool IsHeadless() const;
+
   Device&           GetDevice();
   Swapchain&        GetSwapchain();
   PipelineState&    GetPipelinePreset( PipelinePresets preset );
@@ -74,10 +79,6 @@ public:
 
   void TidyUp();
 
-  eastl::unique_ptr< Resource > GetUploadBufferForSize( int size );
-  eastl::unique_ptr< Resource > GetUploadBufferForResource( Resource& resource );
-  void ReuseUploadConstantBuffer( eastl::unique_ptr< Resource > buffer );
-
   void RecreateWindowSizeDependantResources( CommandList& commandList );
 
   int GetMSAASamples() const;
@@ -89,8 +90,10 @@ public:
 
   TextureStreamer::MemoryStats GetMemoryStats() const;
 
+  CommandAllocatorPool::Stats GetCommandAllocatorStats( CommandQueueType queueType ) const;
+
 private:
-  RenderManager( eastl::shared_ptr< Window > window );
+  RenderManager( eastl::shared_ptr< Window > window, bool headless );
   ~RenderManager();
 
   static RenderManager* instance;
@@ -100,6 +103,8 @@ private:
 
   eastl::shared_ptr< Window > window;
 
+  bool headless;
+
   eastl::unique_ptr< Factory >   factory;
   eastl::unique_ptr< Adapter >   adapter;
   eastl::unique_ptr< Device >    device;
@@ -110,10 +115,7 @@ private:
   eastl::unique_ptr< PipelineState > pipelinePresets[ int( PipelinePresets::PresetCount ) ];
   eastl::unique_ptr< CommandSignature > commandSignatures[ int( CommandSignatures::PresetCount ) ];
 
-  eastl::vector_map< CommandQueueType, eastl::map< uint64_t, eastl::vector< eastl::unique_ptr< Resource > > > >              stagingResources;
-  eastl::vector_map< CommandQueueType, eastl::map< uint64_t, eastl::vector< eastl::unique_ptr< RTTopLevelAccelerator > > > > stagingTLAS;
-  eastl::vector_map< CommandQueueType, eastl::map< uint64_t, eastl::vector< CComPtr< IUnknown > > > >                        stagingUnknowns;
-  eastl::vector_map< CommandQueueType, eastl::map< uint64_t, eastl::vector< eastl::function< void() > > > >                  endFrameCallbacks;
+  DeferredReleaseQueue releaseQueues[ 3 ];
 
   eastl::unique_ptr< Resource > randomTexture;
   eastl::unique_ptr< Resource > globalTextureFeedbackBuffer;
@@ -121,8 +123,5 @@ private:
 
   eastl::unique_ptr< TextureStreamer > textureStreamer;
 
-  eastl::mutex                                                      uploadBuffersLock;
-  eastl::map< int, eastl::vector< eastl::unique_ptr< Resource > > > uploadBuffers;
-
   uint64_t pendingGlobalTextureReadbackFence = 0;
 };
@@ -0,0 +1,113 @@
+#include "ShaderPackage.h"
+#include "ShaderPackageFormat.h"
+
+#ifdef _DEBUG
+  static const wchar_t* packagePath = L"Content/Shaders/Shaders_d.pak";
+#else
+  static const wchar_t* packagePath = L"Content/Shaders/Shaders.pak";
+#endif
+
+ShaderPackage& ShaderPackage::GetInstance()
+{
+  static ShaderPackage instance( packagePath );
+  return instance;
+}
+
+ShaderPackage::ShaderPackage( const wchar_t* path )
+{
+  if ( !Map( path ) )
+  {
+    Unmap();
+    OutputDebugStringW( L"Shader package is missing or invalid, using the loose shader files.\n" );
+  }
+}
+
+ShaderPackage::~ShaderPackage()
+{
+  Unmap();
+}
+
+bool ShaderPackage::Map( const wchar_t* path )
+{
+  fileHandle = CreateFileW( path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr );
+  if ( fileHandle == INVALID_HANDLE_VALUE )
+    return false;
+
+  LARGE_INTEGER fileSize;
+  if ( !GetFileSizeEx( fileHandle, &fileSize ) || fileSize.QuadPart < sizeof( ShaderPackageHeader ) )
+    return false;
+
+  mappingHandle = CreateFileMappingW( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+  if ( !mappingHandle )
+    return false;
+
+  mappedData = static_cast< const uint8_t* >( MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+  if ( !mappedData )
+    return false;
+
+  auto& header = *reinterpret_cast< const ShaderPackageHeader* >( mappedData );
+  if ( header.magic != ShaderPackageHeader::Magic || header.version != ShaderPackageHeader::Version )
+    return false;
+
+  uint64_t tocEnd = sizeof( ShaderPackageHeader ) + uint64_t( header.entryCount ) * sizeof( ShaderPackageEntry );
+  if ( tocEnd > uint64_t( fileSize.QuadPart ) )
+    return false;
+
+  entries    = reinterpret_cast< const ShaderPackageEntry* >( mappedData + sizeof( ShaderPackageHeader ) );
+  entryCount = int( header.entryCount );
+
+  for ( int entryIx = 0; entryIx < entryCount; ++entryIx )
+    if ( uint64_t( entries[ entryIx ].offset ) + entries[ entryIx ].size > uint64_t( fileSize.QuadPart ) )
+      return false;
+
+  return true;
+}
+
+void ShaderPackage::Unmap()
+{
+  if ( mappedData )
+    UnmapViewOfFile( mappedData );
+  if ( mappingHandle )
+    CloseHandle( mappingHandle );
+  if ( fileHandle != INVALID_HANDLE_VALUE )
+    CloseHandle( fileHandle );
+
+  fileHandle    = INVALID_HANDLE_VALUE;
+  mappingHandle = nullptr;
+  mappedData    = nullptr;
+  entries       = nullptr;
+  entryCount    = 0;
+}
+
+ShaderBinary ShaderPackage::GetShader( const wchar_t* name )
+{
+  auto nameHash = HashShaderName( name );
+
+  auto entriesEnd = entries + entryCount;
+  auto entry      = eastl::lower_bound( entries, entriesEnd, nameHash, []( const ShaderPackageEntry& entry, uint64_t hash ) { return entry.nameHash < hash; } );
+  if ( entry != entriesEnd && entry->nameHash == nameHash )
+    return { mappedData + entry->offset, int( entry->size ) };
+
+  eastl::lock_guard< eastl::mutex > autoLock( looseLock );
+
+  // The map moves the files when it grows, which keeps their data in place, so earlier binaries stay valid.
+  auto iter = looseShaders.find( nameHash );
+  if ( iter == looseShaders.end() )
+  {
+    eastl::wstring path( L"Content/Shaders/" );
+    path += name;
+    #ifdef _DEBUG
+      path += L"_d";
+    #endif
+    path += L".cso";
+    iter = looseShaders.emplace( nameHash, MappedFile( path.data(), MappedFile::AccessHint::Sequential ) ).first;
+  }
+
+  assert( !iter->second.empty() && "Shader not found" );
+  return { iter->second.data(), int( iter->second.size() ) };
+}
+
+bool ShaderPackage::IsMapped() const
+{
+  return mappedData != nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Common/MappedFile.h"
+
+struct ShaderPackageEntry;
+
+struct ShaderBinary
+{
+  const uint8_t* data = nullptr;
+  int            size = 0;
+
+  bool empty() const { return size == 0; }
+};
+
+// Compiled shaders, memory mapped from the package the ShaderPacker builds next to the .cso files.
+// The binaries stay valid until the process exits, so pipelines can reference them without a copy.
+// Shaders not in the package, or every shader when there is no package, are read from the loose files.
+class ShaderPackage
+{
+public:
+  static ShaderPackage& GetInstance();
+
+  // The name is the .cso file name without the extension, like L"Culling".
+  ShaderBinary GetShader( const wchar_t* name );
+
+  bool IsMapped() const;
+
+private:
+  ShaderPackage( const wchar_t* path );
+  ~ShaderPackage();
+
+  bool Map( const wchar_t* path );
+  void Unmap();
+
+  HANDLE         fileHandle    = INVALID_HANDLE_VALUE;
+  HANDLE         mappingHandle = nullptr;
+  const uint8_t* mappedData    = nullptr;
+
+  const ShaderPackageEntry* entries    = nullptr;
+  int                       entryCount = 0;
+
+  eastl::mutex                                 looseLock;
+  eastl::vector_map< uint64_t, MappedFile > looseShaders;
+};
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+// Shared with the ShaderPacker tool.
+
+struct ShaderPackageHeader
+{
+  static constexpr uint32_t Magic         = 0x4B415053; // SPAK
+  static constexpr uint32_t Version       = 1;
+  static constexpr uint32_t DataAlignment = 16;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t reserved;
+};
+
+// The entries follow the header, sorted by the name hash.
+struct ShaderPackageEntry
+{
+  uint64_t nameHash;
+  uint32_t offset;
+  uint32_t size;
+};
+
+// Case insensitive FNV-1a of the shader name, which is the file name without the extension and the debug suffix.
+inline uint64_t HashShaderName( const wchar_t* name )
+{
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for ( ; *name; ++name )
+  {
+    wchar_t c = *name;
+    if ( c >= L'A' && c <= L'Z' )
+      c += L'a' - L'A';
+
+    hash ^= uint64_t( c );
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
\ No newline at end of file
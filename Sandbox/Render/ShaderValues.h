@@ -13,12 +13,14 @@
 
 #define INF 1e5
 
-#define Engine2DResourceCount         70
+// The region sizes are compiled into the root signatures of the shader package, so they are fixed for a build.
+// Past Scene2DResourceCount the scene textures fall back to the dummy texture, raise it here for larger scenes.
+#define Engine2DResourceCount         100
 #define EngineCubeResourceCount       10
 #define EngineVolResourceCount        10
-#define EngineBufferResourceCount     40
-#define Scene2DResourceCount          300
-#define SceneBufferResourceCount      5000
+#define EngineBufferResourceCount     50
+#define Scene2DResourceCount          1024
+#define SceneBufferResourceCount      16384
 #define Engine2DTileTexturesCount     100
 
 #define AllResourceCount ( Engine2DResourceCount + EngineCubeResourceCount + EngineVolResourceCount + EngineBufferResourceCount + Scene2DResourceCount * 2 + SceneBufferResourceCount + Engine2DTileTexturesCount )
@@ -32,12 +34,12 @@
 #define SceneBufferResourceBaseSlot      ( Scene2DFeedbackBaseSlot          + Scene2DResourceCount )
 #define Engine2DTileTexturesBaseSlot     ( SceneBufferResourceBaseSlot      + SceneBufferResourceCount )
 
-#define Engine2DResourceCountStr         "70"
+#define Engine2DResourceCountStr         "100"
 #define EngineCubeResourceCountStr       "10"
 #define EngineVolResourceCountStr        "10"
-#define EngineBufferResourceCountStr     "40"
-#define Scene2DResourceCountStr          "300"
-#define SceneBufferResourceCountStr      "5000"
+#define EngineBufferResourceCountStr     "50"
+#define Scene2DResourceCountStr          "1024"
+#define SceneBufferResourceCountStr      "16384"
 #define Engine2DTileTexturesCountStr     "100"
 
 #ifdef __cplusplus
@@ -127,10 +129,32 @@ enum Texture2DSlots
   BloomB3TextureUAVSlot,
   BloomB4TextureUAVSlot,
 
+  HiZ0TextureSlot,
+  HiZ1TextureSlot,
+  HiZ2TextureSlot,
+  HiZ3TextureSlot,
+  HiZ4TextureSlot,
+  HiZ5TextureSlot,
+  HiZ6TextureSlot,
+  HiZ7TextureSlot,
+  HiZ8TextureSlot,
+  HiZ9TextureSlot,
+
+  HiZ0TextureUAVSlot,
+  HiZ1TextureUAVSlot,
+  HiZ2TextureUAVSlot,
+  HiZ3TextureUAVSlot,
+  HiZ4TextureUAVSlot,
+  HiZ5TextureUAVSlot,
+  HiZ6TextureUAVSlot,
+  HiZ7TextureUAVSlot,
+  HiZ8TextureUAVSlot,
+  HiZ9TextureUAVSlot,
+
   Texture2DSlotCount
 };
 
-#define Texture2DSlotCountStr "66"
+#define Texture2DSlotCountStr "86"
 
 #ifdef __cplusplus
   static_assert( Texture2DSlotCount < Engine2DResourceBaseSlot + Engine2DResourceCount, "Too many engine 2D textures!" );
@@ -178,11 +202,7 @@ enum BufferSlots
 #endif // __cplusplus
   ,
 
-  NodeBufferSlot,
-  RootNodeChildrenInidcesBufferSlot,
-  MeshBufferSlot,
   MaterialBufferSlot,
-  CameraBufferSlot,
   LightBufferSlot,
   ModelMetaBufferSlot,
   FrameParamsBufferUAVSlot,
@@ -194,18 +214,6 @@ enum BufferSlots
   SkyBufferUAVSlot,
   SkyBufferCBVSlot,
   IndirectDrawCountBufferSlot,
-  IndirectOpaqueDrawBufferSRVSlot,
-  IndirectOpaqueTwoSidedDrawBufferSRVSlot,
-  IndirectOpaqueAlphaTestedDrawBufferSRVSlot,
-  IndirectOpaqueTwoSidedAlphaTestedDrawBufferSRVSlot,
-  IndirectTranslucentDrawBufferSRVSlot,
-  IndirectTranslucentTwoSidedDrawBufferSRVSlot,
-  IndirectOpaqueDrawBufferUAVSlot,
-  IndirectOpaqueTwoSidedDrawBufferUAVSlot,
-  IndirectOpaqueAlphaTestedDrawBufferUAVSlot,
-  IndirectOpaqueTwoSidedAlphaTestedDrawBufferUAVSlot,
-  IndirectTranslucentDrawBufferUAVSlot,
-  IndirectTranslucentTwoSidedDrawBufferUAVSlot,
   ExposureBufferCBVSlot,
   ExposureBufferUAVSlot,
   HistogramBufferSlot,
@@ -238,6 +246,15 @@ enum BufferSlots
 
 #define CullingKernelWidth 64
 
+#define HiZLevelCount      10
+#define HiZLevelCountStr   "10"
+#define HiZKernelWidth     8
+#define HiZKernelHeight    8
+
+#ifdef __cplusplus
+  static_assert( HiZLevelCount == atou_cex( HiZLevelCountStr ), "HiZLevelCountStr is wrong" );
+#endif // __cplusplus
+
 #define DownsamplingKernelWidth  8
 #define DownsamplingKernelHeight 8
 
@@ -1,5 +1,5 @@
 #include "TextureStreamer_Immediate.h"
-#include "Common/Files.h"
+#include "Common/MappedFile.h"
 #include "Render/Device.h"
 #include "Render/RenderManager.h"
 #include "Render/Resource.h"
@@ -10,14 +10,19 @@ void ImmediateTextureStreamer::CacheTexture( CommandQueue& directQueue, CommandL
 {
   auto& device = RenderManager::GetInstance().GetDevice();
 
+  // Out of scene texture slots, the material falls back to the dummy texture as for a missing file.
   int slot = int( textures.size() );
-  assert( slot < Scene2DResourceCount );
+  if ( slot >= Scene2DResourceCount )
+  {
+    OutputDebugStringW( ( L"Out of scene texture slots, skipping " + path + L"\n" ).data() );
+    return;
+  }
 
-  auto fileData = ReadFileToMemory( path.data() );
-  if ( fileData.empty() )
+  MappedFile file( path.data(), MappedFile::AccessHint::Sequential );
+  if ( file.empty() )
     return;
 
-  auto texture = device.Load2DTexture( commandList, eastl::move( fileData ), Scene2DResourceBaseSlot + slot, path.data() );
+  auto texture = device.Load2DTexture( commandList, file.data(), int( file.size() ), Scene2DResourceBaseSlot + slot, path.data() );
   if ( !texture )
     return;
 
@@ -133,8 +133,13 @@ void TiledTextureStreamer::CacheTexture( CommandQueue& directQueue, CommandList&
 
   auto& device = RenderManager::GetInstance().GetDevice();
 
+  // Out of scene texture slots, the material falls back to the dummy texture as for a missing file.
   int slot = int( textures.size() );
-  assert( slot < Scene2DResourceCount );
+  if ( slot >= Scene2DResourceCount )
+  {
+    OutputDebugStringW( ( L"Out of scene texture slots, skipping " + path + L"\n" ).data() );
+    return;
+  }
 
   TFFHeader tffHeader;
 
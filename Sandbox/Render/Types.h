@@ -442,6 +442,12 @@ struct RTInstance
   XMFLOAT4X4                       transform;
 };
 
+struct RTInstanceTransform
+{
+  int        instanceIndex;
+  XMFLOAT4X4 transform;
+};
+
 struct IndexRange
 {
   int startIndex;
@@ -0,0 +1,132 @@
+#include "UploadAllocator.h"
+#include "Resource.h"
+
+UploadPagePool::UploadPagePool( PageFactory pageFactory, int pageSize )
+  : pageFactory( eastl::move( pageFactory ) )
+  , pageSize( pageSize )
+{
+}
+
+UploadPagePool::~UploadPagePool()
+{
+  for ( auto& page : pages )
+    page->resource->Unmap();
+}
+
+UploadPagePool::Page* UploadPagePool::RequestPage( int minimumSize )
+{
+  eastl::lock_guard< eastl::mutex > lock( pagesLock );
+
+  if ( minimumSize <= pageSize && !freePages.empty() )
+  {
+    auto page = freePages.back();
+    freePages.pop_back();
+    return page;
+  }
+
+  auto size = eastl::max( minimumSize, pageSize );
+
+  eastl::unique_ptr< Page > page( new Page );
+  page->resource   = pageFactory( size );
+  page->cpuAddress = static_cast< uint8_t* >( page->resource->Map() );
+  page->size       = size;
+
+  pages.emplace_back( eastl::move( page ) );
+  return pages.back().get();
+}
+
+void UploadPagePool::RetirePages( eastl::vector< Page* >& retired, CommandQueueType queueType, uint64_t fence )
+{
+  eastl::lock_guard< eastl::mutex > lock( pagesLock );
+
+  // Fences only grow on a queue, so the oldest retired pages are always at the front
+  auto& queue = retiredPages[ int( queueType ) ];
+  for ( auto page : retired )
+    queue.push_back( { page, fence } );
+
+  retired.clear();
+}
+
+void UploadPagePool::RecyclePages( CommandQueueType queueType, uint64_t completedFence )
+{
+  eastl::lock_guard< eastl::mutex > lock( pagesLock );
+
+  auto& queue = retiredPages[ int( queueType ) ];
+  while ( !queue.empty() && queue.front().fence <= completedFence )
+  {
+    auto page = queue.front().page;
+    queue.pop_front();
+
+    if ( page->size > pageSize )
+      ReleasePage( page );
+    else
+      freePages.push_back( page );
+  }
+}
+
+void UploadPagePool::ReleasePage( Page* page )
+{
+  auto iter = eastl::find_if( pages.begin(), pages.end(), [ page ]( const eastl::unique_ptr< Page >& p ) { return p.get() == page; } );
+  assert( iter != pages.end() );
+
+  ( *iter )->resource->Unmap();
+  pages.erase( iter );
+}
+
+int UploadPagePool::GetPageSize() const
+{
+  return pageSize;
+}
+
+UploadPagePool::Stats UploadPagePool::GetStats()
+{
+  eastl::lock_guard< eastl::mutex > lock( pagesLock );
+
+  Stats stats;
+  stats.pageCount     = int( pages.size() );
+  stats.freePageCount = int( freePages.size() );
+  for ( auto& queue : retiredPages )
+    stats.retiredPageCount += int( queue.size() );
+  for ( auto& page : pages )
+    stats.pageMemory += page->size;
+  return stats;
+}
+
+UploadAllocator::UploadAllocator( UploadPagePool& pool )
+  : pool( pool )
+{
+}
+
+UploadAllocator::~UploadAllocator()
+{
+  assert( usedPages.empty() && "UploadAllocator::Retire wasn't called for the command list!" );
+}
+
+UploadAllocator::Allocation UploadAllocator::Allocate( int size, int alignment )
+{
+  assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+
+  int offset = ( currentOffset + alignment - 1 ) & ~( alignment - 1 );
+
+  if ( !currentPage || offset + size > currentPage->size )
+  {
+    currentPage = pool.RequestPage( size );
+    usedPages.push_back( currentPage );
+    offset = 0;
+  }
+
+  currentOffset = offset + size;
+
+  Allocation allocation;
+  allocation.resource   = currentPage->resource.get();
+  allocation.offset     = offset;
+  allocation.cpuAddress = currentPage->cpuAddress + offset;
+  return allocation;
+}
+
+void UploadAllocator::Retire( CommandQueueType queueType, uint64_t fence )
+{
+  pool.RetirePages( usedPages, queueType, fence );
+  currentPage   = nullptr;
+  currentOffset = 0;
+}
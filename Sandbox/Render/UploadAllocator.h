@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Types.h"
+
+struct Resource;
+
+// Shared pool of persistently mapped upload pages. Pages are handed out and taken back under the lock,
+// sub-allocating inside a page is done by the UploadAllocator owning it, without locking.
+class UploadPagePool
+{
+public:
+  static constexpr int DefaultPageSize = 2 * 1024 * 1024;
+
+  using PageFactory = eastl::function< eastl::unique_ptr< Resource >( int size ) >;
+
+  struct Page
+  {
+    eastl::unique_ptr< Resource > resource;
+    uint8_t*                      cpuAddress;
+    int                           size;
+  };
+
+  struct Stats
+  {
+    int      pageCount        = 0;
+    int      freePageCount    = 0;
+    int      retiredPageCount = 0;
+    uint64_t pageMemory       = 0;
+  };
+
+  UploadPagePool( PageFactory pageFactory, int pageSize = DefaultPageSize );
+  ~UploadPagePool();
+
+  // Allocations larger than the page size get a page of their own, which is released instead of reused.
+  Page* RequestPage( int minimumSize );
+
+  // The pages can be reused once the fence on the queue completes.
+  void RetirePages( eastl::vector< Page* >& pages, CommandQueueType queueType, uint64_t fence );
+  void RecyclePages( CommandQueueType queueType, uint64_t completedFence );
+
+  int   GetPageSize() const;
+  Stats GetStats();
+
+private:
+  struct RetiredPage
+  {
+    Page*    page;
+    uint64_t fence;
+  };
+
+  void ReleasePage( Page* page );
+
+  PageFactory pageFactory;
+  int         pageSize;
+
+  eastl::mutex pagesLock;
+
+  eastl::vector< eastl::unique_ptr< Page > > pages;
+  eastl::vector< Page* >                     freePages;
+  eastl::deque< RetiredPage >                retiredPages[ 3 ];
+};
+
+// Linear allocator for the uploads recorded into one command list. The list's recording thread owns it,
+// and it hands its pages back to the pool when the list is submitted.
+class UploadAllocator
+{
+public:
+  struct Allocation
+  {
+    Resource* resource   = nullptr;
+    int       offset     = 0;
+    uint8_t*  cpuAddress = nullptr;
+  };
+
+  explicit UploadAllocator( UploadPagePool& pool );
+  ~UploadAllocator();
+
+  Allocation Allocate( int size, int alignment );
+
+  void Retire( CommandQueueType queueType, uint64_t fence );
+
+private:
+  UploadPagePool& pool;
+
+  UploadPagePool::Page*                currentPage   = nullptr;
+  int                                  currentOffset = 0;
+  eastl::vector< UploadPagePool::Page* > usedPages;
+};
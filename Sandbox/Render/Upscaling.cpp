@@ -1,9 +1,14 @@
 #include "Upscaling.h"
 #include "ComputeShader.h"
 #include "DLSSUpscaling.h"
+#include "RenderManager.h"
 
 eastl::unique_ptr< Upscaling > Upscaling::Instantiate()
 {
+  // DLSS needs the D3D device, the headless backend renders at the full resolution.
+  if ( RenderManager::GetInstance().IsHeadless() )
+    return nullptr;
+
   if ( DLSSUpscaling::IsAvailable() )
     return eastl::make_unique< DLSSUpscaling >();
 
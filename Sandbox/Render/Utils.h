@@ -18,14 +18,34 @@ inline eastl::unique_ptr< Resource > CreateBufferFromData( const T* firstElement
   int  bs = elementCount * es;
 
   auto resultBuffer = device.CreateBuffer( resourceType, HeapType::Default, false, bs, es, debugName );
-  auto uploadBuffer = RenderManager::GetInstance().GetUploadBufferForResource( *resultBuffer );
-  commandList.UploadBufferResource( eastl::move( uploadBuffer ), *resultBuffer, firstElement, es * elementCount );
+  commandList.UploadBufferResource( *resultBuffer, firstElement, bs );
   return resultBuffer;
 }
 
-inline eastl::pair< const void*, int > ParseSimpleDDS( const eastl::vector< uint8_t >& data, int& width, int& height, PixelFormat& pf )
+struct SlotRange
 {
-  const uint32_t* cursor = reinterpret_cast< const uint32_t* >( data.data() );
+  int first;
+  int count;
+};
+
+// Merges the sorted slot indices into contiguous ranges. Gaps not larger than maxGap are merged too,
+// as copying a few unchanged slots is cheaper than recording an extra copy.
+inline void CoalesceSlotRanges( const eastl::vector_set< int >& slots, int maxGap, eastl::vector< SlotRange >& ranges )
+{
+  ranges.clear();
+
+  for ( int slot : slots )
+  {
+    if ( !ranges.empty() && slot - ( ranges.back().first + ranges.back().count ) <= maxGap )
+      ranges.back().count = slot - ranges.back().first + 1;
+    else
+      ranges.push_back( { slot, 1 } );
+  }
+}
+
+inline eastl::pair< const void*, int > ParseSimpleDDS( const uint8_t* data, int dataSize, int& width, int& height, PixelFormat& pf )
+{
+  const uint32_t* cursor = reinterpret_cast< const uint32_t* >( data );
 
   height = int( cursor[ 3 ] );
   width  = int( cursor[ 4 ] );
@@ -50,5 +70,5 @@ inline eastl::pair< const void*, int > ParseSimpleDDS( const eastl::vector< uint
   #undef ISBITMASK
 
   static constexpr int headerSize = 32 * sizeof( uint32_t );
-  return { data.data() + headerSize, int( data.size() ) - headerSize };
+  return { data + headerSize, dataSize - headerSize };
 }
\ No newline at end of file
@@ -10,6 +10,9 @@
 #include "Common/Files.h"
 #include "Scene/Scene.h"
 #include "Sandbox.h"
+#include "Benchmark.h"
+#include "WorldStreamingSimulation.h"
+#include "Tests/TestRunner.h"
 #include "UI/Debug/DebugWindow.h"
 #include "../DearImGui/imgui.h"
 #include "../External/tinyxml2/tinyxml2.h"
@@ -36,7 +39,26 @@ o Raycast camera
 
 int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow)
 {
-  if ( enableImGui )
+  // The tests and micro benchmarks run without a window, the ones needing a device create the null one.
+  TestRunner::Options testOptions;
+  if ( TestRunner::ParseCommandLine( lpCmdLine, testOptions ) )
+    return TestRunner::Run( testOptions );
+
+  // The simulation runs without a window or a device.
+  WorldStreamingSimulation::Options simulationOptions;
+  if ( WorldStreamingSimulation::ParseCommandLine( lpCmdLine, simulationOptions ) )
+    return WorldStreamingSimulation::Run( scenePath, simulationOptions );
+
+  eastl::unique_ptr< Benchmark > benchmark;
+  Benchmark::Options benchmarkOptions;
+  if ( Benchmark::ParseCommandLine( lpCmdLine, benchmarkOptions ) )
+    benchmark = eastl::make_unique< Benchmark >( benchmarkOptions );
+
+  // Headless runs on the null backend, without a window and the debug UI. Only the benchmark ends such a run.
+  bool headless = benchmark && benchmarkOptions.headless;
+  bool useImGui = enableImGui && !headless;
+
+  if ( useImGui )
   {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -44,8 +66,10 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
     ImGui::StyleColorsDark();
   }
 
-  eastl::shared_ptr< Window > window = Window::Create( 1920, 1080 );
-  if ( RenderManager::CreateInstance( window ) )
+  int exitCode = 0;
+
+  eastl::shared_ptr< Window > window = headless ? Window::CreateHeadless( 1920, 1080 ) : Window::Create( 1920, 1080 );
+  if ( RenderManager::CreateInstance( window, headless ) )
   {
     {
       auto&    renderManager       = RenderManager::GetInstance();
@@ -58,6 +82,11 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
       renderManager.RecreateWindowSizeDependantResources( *commandList );
 
       eastl::unique_ptr< Scene > scene = eastl::make_unique< Scene >( *commandList, scenePath, window->GetClientWidth(), window->GetClientHeight() );
+
+      // The benchmark measures the streamed in scene, not the frames while the cells around the camera arrive.
+      if ( benchmark )
+        scene->FinishLoading( *commandList );
+
       if ( !scene->GetError().empty() )
       {
         OutputDebugStringW( scene->GetError().data() );
@@ -80,16 +109,23 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
 
       Sandbox::SetupCameraControl( *window );
 
-      auto     lastFrameTime = GetCPUTime();
-      uint64_t frameCounter  = 0;
+      auto lastFrameTime = GetCPUTime();
 
       DebugWindow debugWindow;
 
       renderManager.Submit( eastl::move( commandList ), CommandQueueType::Direct, true );
 
+      // Everything up to here, like the scene load, is the setup frame of the benchmark.
+      if ( benchmark )
+        benchmark->EndFrame();
+
+      SetThreadName( GetCurrentThreadId(), (char*)"Main thread" );
+
       auto shoudQuit = false;
       while ( !shoudQuit )
       {
+        CPUSection cpuFrameSection( L"Frame" );
+
         shoudQuit = !window->ProcessMessages();
 
         auto commandAllocator = renderManager.RequestCommandAllocator( CommandQueueType::Direct );
@@ -119,8 +155,8 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
 
         scene->SetManualExposure( debugWindow.GetManualExposure() );
 
-        eastl::wstring frameName;
-        GPUSection gpuFrameSection( *commandList, frameName.sprintf( L"Render frame %llu", frameCounter++ ).data() );
+        // Not numbered, so the pass statistics collect all frames under one name.
+        GPUSection gpuFrameSection( *commandList, L"Render frame" );
 
         if ( windowResized || Sandbox::toggleFullscreen )
         {
@@ -135,7 +171,7 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
             renderManager.GetSwapchain().Resize( *commandList, renderManager.GetDevice(), *window );
 
           // This is really not needed. Scene buffers only rebuilt to update camera projection.
-          scene->TearDownSceneBuffers( *commandList );
+          scene->TearDownSceneBuffers( commandList.get() );
           scene->TearDownScreenSizeDependantTextures( *commandList );
 
           auto fenceValue = renderManager.Submit( eastl::move( commandList ), CommandQueueType::Direct, true );
@@ -154,13 +190,21 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
           renderManager.IdleGPU();
         }
 
+        scene->UpdateLoading( *commandList );
+        if ( !scene->GetError().empty() )
+        {
+          OutputDebugStringW( scene->GetError().data() );
+          exitCode  = -1;
+          shoudQuit = true;
+        }
+
         auto& backBuffer = renderManager.GetSwapchain().GetCurrentBackBufferTexture();
 
         auto thisFrameTime = GetCPUTime();
         auto timeElapsed = thisFrameTime - lastFrameTime;
         lastFrameTime = thisFrameTime;
 
-        if ( enableImGui )
+        if ( useImGui )
         {
           renderManager.GetDevice().DearImGuiNewFrame();
           window->DearImGuiNewFrame();
@@ -178,14 +222,23 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
           renderManager.UpdateBeforeFrame( *commandList );
         }
 
-        Sandbox::TickCamera( *commandList, *scene, timeElapsed );
+        if ( scene->IsRenderable() )
+          Sandbox::TickCamera( *commandList, *scene, timeElapsed );
+
+        // The CPU culling is only measured, the GPU culling decides what gets drawn.
+        bool cpuCulling = benchmark ? benchmarkOptions.cpuCulling : debugWindow.GetCPUCulling();
+        if ( cpuCulling && scene->IsRenderable() )
+          debugWindow.SetCPUCullingStats( scene->CullCameraViewOnCPU() );
 
-        scene->Render( *commandAllocator
-                     , *commandList
-                     , backBuffer
-                     , debugWindow.GetUpdateTextureStreaming()
-                     , debugWindow.GetFreezeCulling()
-                     , debugWindow.GetDebugOutput() );
+        auto sceneCommandLists = scene->Render( commandAllocator
+                                              , commandList
+                                              , { &gpuCommandListSection, &gpuFrameSection }
+                                              , backBuffer
+                                              , debugWindow.GetUpdateTextureStreaming()
+                                              , debugWindow.GetFreezeCulling()
+                                              , debugWindow.GetDebugOutput() );
+
+        debugWindow.SetPassRecordTimings( scene->GetPassRecordTimings() );
 
         TextureStreamer::UpdateResult streamingCommandLists;
         if ( debugWindow.GetUpdateTextureStreaming() )
@@ -197,7 +250,7 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
           renderManager.RenderDebugHeapTexture( *commandList, texIndex, backBuffer.GetTextureWidth(), backBuffer.GetTextureHeight(), DebugOutput::None );
 
 
-        if ( enableImGui )
+        if ( useImGui )
         {
           GPUSection gpuSection( *commandList, L"DearImGui" );
 
@@ -216,20 +269,39 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
         gpuFrameSection.Close();
         gpuCommandListSection.Close();
 
+        renderManager.GetDevice().ResolveGPUTimestamps( *commandList );
+
         eastl::vector< eastl::unique_ptr< CommandList > > submitList;
         for ( auto& scl : streamingCommandLists )
           submitList.emplace_back( eastl::move( scl.first ) );
+        for ( auto& scl : sceneCommandLists )
+          submitList.emplace_back( eastl::move( scl.first ) );
         submitList.emplace_back( eastl::move( commandList ) );
         auto fenceValue = renderManager.Submit( eastl::move( submitList ), CommandQueueType::Direct, false );
         for ( auto& scl : streamingCommandLists )
           renderManager.DiscardCommandAllocator( CommandQueueType::Direct, scl.second, fenceValue );
+        for ( auto& scl : sceneCommandLists )
+          renderManager.DiscardCommandAllocator( CommandQueueType::Direct, scl.second, fenceValue );
         renderManager.DiscardCommandAllocator( CommandQueueType::Direct, commandAllocator, fenceValue );
-        nextFrameFenceValue = renderManager.Present( fenceValue, debugWindow.GetUseVSync() );
+        nextFrameFenceValue = renderManager.Present( fenceValue, debugWindow.GetUseVSync() && !benchmark );
 
         renderManager.TidyUp();
         renderManager.GetDevice().StartNewFrame();
+
+        cpuFrameSection.Close();
+        CPUProfiler::EndFrame();
+
+        if ( benchmark )
+        {
+          benchmark->EndFrame();
+          if ( benchmark->IsDone() )
+            shoudQuit = true;
+        }
       }
 
+      if ( benchmark )
+        exitCode = benchmark->Finish();
+
       renderManager.IdleGPU();
 
       scene->TearDown( nullptr );
@@ -238,8 +310,8 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
     RenderManager::DeleteInstance();
   }
 
-  if ( enableImGui )
+  if ( useImGui )
     ImGui::DestroyContext();
 
-  return 0;
+  return exitCode;
 }
@@ -106,8 +106,8 @@ namespace Sandbox
     if ( !cameraDX && !cameraDY && !cameraMoveX && !cameraMoveY && !cameraMoveZ )
       return;
 
-    auto cameraNode    = scene.FindNodeByName( "Camera" );
-    auto nodeTransform = cameraNode->GetFullTransform();
+    auto cameraNode    = scene.GetCameraNode();
+    auto nodeTransform = scene.GetNodeWorldTransform( *cameraNode );
 
     if ( cameraDX )
     {
@@ -162,11 +162,6 @@ namespace Sandbox
       nodeTransform.r[ 3 ] += offset;
     }
 
-    auto parentTransform    = cameraNode->GetParentFullTransform();
-    auto invParentTransform = XMMatrixInverse( nullptr, parentTransform );
-    auto localTransform     = nodeTransform * invParentTransform;
-
-    cameraNode->SetTransform( localTransform );
-    scene.OnNodeTransformChanged( commandList, *cameraNode );
+    scene.SetNodeWorldTransform( *cameraNode, nodeTransform );
   }
 }
@@ -0,0 +1,266 @@
+#include "FrustumCulling.h"
+#include "SceneStore.h"
+#include "Common/ParallelFor.h"
+
+static constexpr int boxesPerBlock     = 8;
+static constexpr int minBlocksPerRange = 64;
+
+// The projected boxes of a block in SoA layout. Every corner is base +/- axisX +/- axisY +/- axisZ.
+struct alignas( 32 ) BoxBlock
+{
+  float base [ 4 ][ boxesPerBlock ];
+  float axisX[ 4 ][ boxesPerBlock ];
+  float axisY[ 4 ][ boxesPerBlock ];
+  float axisZ[ 4 ][ boxesPerBlock ];
+};
+
+static bool IsAVXSupported()
+{
+  int info[ 4 ];
+  __cpuid( info, 1 );
+
+  bool osxsave = ( info[ 2 ] & ( 1 << 27 ) ) != 0;
+  bool avx     = ( info[ 2 ] & ( 1 << 28 ) ) != 0;
+
+  // The OS has to save the YMM registers too, not only the CPU supporting them.
+  return osxsave && avx && ( _xgetbv( 0 ) & 6 ) == 6;
+}
+
+static void StoreLane( float ( &target )[ 4 ][ boxesPerBlock ], int lane, FXMVECTOR value )
+{
+  XMFLOAT4A unpacked;
+  XMStoreFloat4A( &unpacked, value );
+  target[ 0 ][ lane ] = unpacked.x;
+  target[ 1 ][ lane ] = unpacked.y;
+  target[ 2 ][ lane ] = unpacked.z;
+  target[ 3 ][ lane ] = unpacked.w;
+}
+
+static void PrepareBlock( const SceneStore& sceneStore, FXMMATRIX viewProjection, int firstSlot, BoxBlock& block )
+{
+  auto& meshSlots = sceneStore.GetMeshSlots();
+  int   lastSlot  = int( meshSlots.size() ) - 1;
+  int   lastNode  = -1;
+
+  XMMATRIX mvp;
+
+  for ( int lane = 0; lane < boxesPerBlock; lane++ )
+  {
+    // The tail of the last block repeats the last box, its results are thrown away.
+    int   meshSlot  = eastl::min( firstSlot + lane, lastSlot );
+    int   nodeIndex = sceneStore.GetMeshSlotNode( meshSlot );
+    auto& mesh      = meshSlots[ meshSlot ];
+
+    if ( nodeIndex != lastNode )
+    {
+      mvp      = sceneStore.GetWorldTransform( nodeIndex ) * viewProjection;
+      lastNode = nodeIndex;
+    }
+
+    auto center = XMVectorSetW( XMLoadFloat4( &mesh.aabbCenter ), 1 );
+
+    StoreLane( block.base,  lane, XMVector4Transform( center, mvp ) );
+    StoreLane( block.axisX, lane, XMVectorScale( mvp.r[ 0 ], mesh.aabbExtents.x ) );
+    StoreLane( block.axisY, lane, XMVectorScale( mvp.r[ 1 ], mesh.aabbExtents.y ) );
+    StoreLane( block.axisZ, lane, XMVectorScale( mvp.r[ 2 ], mesh.aabbExtents.z ) );
+  }
+}
+
+// Projects the 8 corners of 8 boxes at once, returns one visible bit per box.
+static uint32_t CullBlockAVX( const BoxBlock& block )
+{
+  __m256 minClip[ 3 ];
+  __m256 maxClip[ 3 ];
+
+  __m256 corners[ 4 ][ 8 ];
+  for ( int component = 0; component < 4; component++ )
+  {
+    auto base  = _mm256_load_ps( block.base [ component ] );
+    auto axisX = _mm256_load_ps( block.axisX[ component ] );
+    auto axisY = _mm256_load_ps( block.axisY[ component ] );
+    auto axisZ = _mm256_load_ps( block.axisZ[ component ] );
+
+    auto px  = _mm256_add_ps( base, axisX );
+    auto nx  = _mm256_sub_ps( base, axisX );
+    auto pxy = _mm256_add_ps( px, axisY );
+    auto pxn = _mm256_sub_ps( px, axisY );
+    auto nxy = _mm256_add_ps( nx, axisY );
+    auto nxn = _mm256_sub_ps( nx, axisY );
+
+    auto& target = corners[ component ];
+    target[ 0 ] = _mm256_add_ps( pxy, axisZ );
+    target[ 1 ] = _mm256_sub_ps( pxy, axisZ );
+    target[ 2 ] = _mm256_add_ps( pxn, axisZ );
+    target[ 3 ] = _mm256_sub_ps( pxn, axisZ );
+    target[ 4 ] = _mm256_add_ps( nxy, axisZ );
+    target[ 5 ] = _mm256_sub_ps( nxy, axisZ );
+    target[ 6 ] = _mm256_add_ps( nxn, axisZ );
+    target[ 7 ] = _mm256_sub_ps( nxn, axisZ );
+  }
+
+  for ( int component = 0; component < 3; component++ )
+  {
+    auto first = _mm256_div_ps( corners[ component ][ 0 ], corners[ 3 ][ 0 ] );
+    minClip[ component ] = first;
+    maxClip[ component ] = first;
+
+    for ( int corner = 1; corner < 8; corner++ )
+    {
+      auto projected = _mm256_div_ps( corners[ component ][ corner ], corners[ 3 ][ corner ] );
+      minClip[ component ] = _mm256_min_ps( minClip[ component ], projected );
+      maxClip[ component ] = _mm256_max_ps( maxClip[ component ], projected );
+    }
+  }
+
+  auto one      = _mm256_set1_ps( 1 );
+  auto minusOne = _mm256_set1_ps( -1 );
+  auto zero     = _mm256_setzero_ps();
+
+  auto culled = _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( minClip[ 0 ], one, _CMP_GT_OQ )
+                                          , _mm256_cmp_ps( minClip[ 1 ], one, _CMP_GT_OQ ) )
+                            , _mm256_or_ps( _mm256_cmp_ps( minClip[ 2 ], one, _CMP_GT_OQ )
+                                          , _mm256_cmp_ps( maxClip[ 0 ], minusOne, _CMP_LT_OQ ) ) );
+  culled = _mm256_or_ps( culled, _mm256_or_ps( _mm256_cmp_ps( maxClip[ 1 ], minusOne, _CMP_LT_OQ )
+                                             , _mm256_cmp_ps( maxClip[ 2 ], zero, _CMP_LT_OQ ) ) );
+
+  uint32_t visibleBits = ~uint32_t( _mm256_movemask_ps( culled ) ) & 0xFF;
+
+  // Avoid the penalty of the SSE code following this.
+  _mm256_zeroupper();
+
+  return visibleBits;
+}
+
+// Same as CullBlockAVX, with 4 wide vectors, one box at a time.
+static uint32_t CullBlockSSE( const BoxBlock& block )
+{
+  uint32_t visibleBits = 0;
+
+  for ( int lane = 0; lane < boxesPerBlock; lane++ )
+  {
+    auto base  = XMVectorSet( block.base [ 0 ][ lane ], block.base [ 1 ][ lane ], block.base [ 2 ][ lane ], block.base [ 3 ][ lane ] );
+    auto axisX = XMVectorSet( block.axisX[ 0 ][ lane ], block.axisX[ 1 ][ lane ], block.axisX[ 2 ][ lane ], block.axisX[ 3 ][ lane ] );
+    auto axisY = XMVectorSet( block.axisY[ 0 ][ lane ], block.axisY[ 1 ][ lane ], block.axisY[ 2 ][ lane ], block.axisY[ 3 ][ lane ] );
+    auto axisZ = XMVectorSet( block.axisZ[ 0 ][ lane ], block.axisZ[ 1 ][ lane ], block.axisZ[ 2 ][ lane ], block.axisZ[ 3 ][ lane ] );
+
+    auto px  = XMVectorAdd( base, axisX );
+    auto nx  = XMVectorSubtract( base, axisX );
+    auto pxy = XMVectorAdd( px, axisY );
+    auto pxn = XMVectorSubtract( px, axisY );
+    auto nxy = XMVectorAdd( nx, axisY );
+    auto nxn = XMVectorSubtract( nx, axisY );
+
+    XMVECTOR corners[ 8 ] =
+    {
+      XMVectorAdd( pxy, axisZ ), XMVectorSubtract( pxy, axisZ ),
+      XMVectorAdd( pxn, axisZ ), XMVectorSubtract( pxn, axisZ ),
+      XMVectorAdd( nxy, axisZ ), XMVectorSubtract( nxy, axisZ ),
+      XMVectorAdd( nxn, axisZ ), XMVectorSubtract( nxn, axisZ ),
+    };
+
+    auto minClip = XMVectorDivide( corners[ 0 ], XMVectorSplatW( corners[ 0 ] ) );
+    auto maxClip = minClip;
+    for ( int corner = 1; corner < 8; corner++ )
+    {
+      auto projected = XMVectorDivide( corners[ corner ], XMVectorSplatW( corners[ corner ] ) );
+      minClip = XMVectorMin( minClip, projected );
+      maxClip = XMVectorMax( maxClip, projected );
+    }
+
+    XMFLOAT4A minValues, maxValues;
+    XMStoreFloat4A( &minValues, minClip );
+    XMStoreFloat4A( &maxValues, maxClip );
+
+    bool culled = minValues.x > 1 || minValues.y > 1 || minValues.z > 1 || maxValues.x < -1 || maxValues.y < -1 || maxValues.z < 0;
+    if ( !culled )
+      visibleBits |= 1 << lane;
+  }
+
+  return visibleBits;
+}
+
+void CullMeshSlots( const SceneStore& sceneStore, FXMMATRIX viewProjection, eastl::vector< uint8_t >& visibility )
+{
+  static const bool useAVX = IsAVXSupported();
+
+  int slotCount  = sceneStore.GetInstanceCount();
+  int blockCount = ( slotCount + boxesPerBlock - 1 ) / boxesPerBlock;
+
+  visibility.resize( slotCount );
+
+  // The blocks are independent, and each of them writes its own range of the output.
+  ParallelFor( blockCount, minBlocksPerRange, [ & ]( int firstBlock, int lastBlock )
+  {
+    BoxBlock block;
+
+    for ( int blockIx = firstBlock; blockIx < lastBlock; blockIx++ )
+    {
+      int firstSlot = blockIx * boxesPerBlock;
+
+      PrepareBlock( sceneStore, viewProjection, firstSlot, block );
+
+      uint32_t visibleBits = useAVX ? CullBlockAVX( block ) : CullBlockSSE( block );
+
+      int boxCount = eastl::min( boxesPerBlock, slotCount - firstSlot );
+      for ( int lane = 0; lane < boxCount; lane++ )
+      {
+        int meshSlot = firstSlot + lane;
+        visibility[ meshSlot ] = sceneStore.GetMeshSlotNode( meshSlot ) != 0 && ( visibleBits & ( 1 << lane ) ) != 0;
+      }
+    }
+  } );
+}
+
+void CullMeshSlotsReference( const SceneStore& sceneStore, FXMMATRIX viewProjection, eastl::vector< uint8_t >& visibility )
+{
+  auto& meshSlots = sceneStore.GetMeshSlots();
+
+  visibility.resize( meshSlots.size() );
+
+  for ( int meshSlot = 0; meshSlot < int( meshSlots.size() ); meshSlot++ )
+  {
+    int nodeIndex = sceneStore.GetMeshSlotNode( meshSlot );
+    if ( nodeIndex == 0 )
+    {
+      visibility[ meshSlot ] = 0;
+      continue;
+    }
+
+    auto mvp = sceneStore.GetWorldTransform( nodeIndex ) * viewProjection;
+    visibility[ meshSlot ] = IsOBBVisible( mvp, meshSlots[ meshSlot ].aabbCenter, meshSlots[ meshSlot ].aabbExtents );
+  }
+}
+
+bool IsOBBVisible( FXMMATRIX mvp, const XMFLOAT4& center, const XMFLOAT4& extents )
+{
+  auto centerV = XMLoadFloat4( &center );
+
+  XMVECTOR corners[ 8 ] =
+  {
+    XMVector4Transform( XMVectorAdd( centerV, XMVectorSet(  extents.x,  extents.y,  extents.z, 0 ) ), mvp ),
+    XMVector4Transform( XMVectorAdd( centerV, XMVectorSet(  extents.x,  extents.y, -extents.z, 0 ) ), mvp ),
+    XMVector4Transform( XMVectorAdd( centerV, XMVectorSet(  extents.x, -extents.y,  extents.z, 0 ) ), mvp ),
+    XMVector4Transform( XMVectorAdd( centerV, XMVectorSet(  extents.x, -extents.y, -extents.z, 0 ) ), mvp ),
+    XMVector4Transform( XMVectorAdd( centerV, XMVectorSet( -extents.x,  extents.y,  extents.z, 0 ) ), mvp ),
+    XMVector4Transform( XMVectorAdd( centerV, XMVectorSet( -extents.x,  extents.y, -extents.z, 0 ) ), mvp ),
+    XMVector4Transform( XMVectorAdd( centerV, XMVectorSet( -extents.x, -extents.y,  extents.z, 0 ) ), mvp ),
+    XMVector4Transform( XMVectorAdd( centerV, XMVectorSet( -extents.x, -extents.y, -extents.z, 0 ) ), mvp ),
+  };
+
+  for ( auto& corner : corners )
+    corner = XMVectorDivide( corner, XMVectorSplatW( corner ) );
+
+  auto minClip = corners[ 0 ];
+  auto maxClip = corners[ 0 ];
+  for ( int ix = 1; ix < 8; ix++ )
+  {
+    minClip = XMVectorMin( minClip, corners[ ix ] );
+    maxClip = XMVectorMax( maxClip, corners[ ix ] );
+  }
+
+  XMFLOAT4A minValues, maxValues;
+  XMStoreFloat4A( &minValues, minClip );
+  XMStoreFloat4A( &maxValues, maxClip );
+
+  return !( minValues.x > 1 || minValues.y > 1 || minValues.z > 1 || maxValues.x < -1 || maxValues.y < -1 || maxValues.z < 0 );
+}
\ No newline at end of file
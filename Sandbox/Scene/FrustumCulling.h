@@ -0,0 +1,29 @@
+#pragma once
+
+class SceneStore;
+
+// The CPU culling of the camera view, shown by the debug window next to the GPU culling.
+struct CPUCullingStats
+{
+  int    meshSlots      = 0;
+  int    frustumVisible = 0;
+  double frustumMs      = 0;
+
+  // The frustum visible mesh slots hidden by the occluders, zero when the scene has none.
+  int    occlusionCulled = 0;
+  double occlusionMs     = 0;
+
+  // The conservative frustum query of the instance BVH, over the world space bounds.
+  int    bvhCandidates = 0;
+  double bvhMs         = 0;
+};
+
+// CPU side of the scene culling shader (Culling.hlsl). The mesh slot bounding boxes are tested in their node's world
+// space against viewProjection, with the same corner projection test as IsOBBVisible. visibility gets one entry per
+// mesh slot, 1 for the visible ones. The meshes of the root node are never visible, just like on the GPU.
+void CullMeshSlots( const SceneStore& sceneStore, FXMMATRIX viewProjection, eastl::vector< uint8_t >& visibility );
+
+// One box at a time reference implementation of CullMeshSlots, written exactly as the shader does the test.
+void CullMeshSlotsReference( const SceneStore& sceneStore, FXMMATRIX viewProjection, eastl::vector< uint8_t >& visibility );
+
+bool IsOBBVisible( FXMMATRIX mvp, const XMFLOAT4& center, const XMFLOAT4& extents );
\ No newline at end of file
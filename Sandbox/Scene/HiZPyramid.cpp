@@ -0,0 +1,151 @@
+#include "HiZPyramid.h"
+
+static float Farthest( float a, float b )
+{
+  #if USE_REVERSE_PROJECTION
+    return eastl::min( a, b );
+  #else
+    return eastl::max( a, b );
+  #endif
+}
+
+static float Saturate( float value )
+{
+  return eastl::clamp( value, 0.0f, 1.0f );
+}
+
+// The same as firstbithigh in HLSL, -1 for zero.
+static int FirstBitHigh( uint32_t value )
+{
+  int index = -1;
+  for ( ; value; value >>= 1 )
+    ++index;
+  return index;
+}
+
+void HiZPyramid::Build( const float* depth, int width, int height )
+{
+  depthWidth  = width;
+  depthHeight = height;
+
+  const float* source       = depth;
+  int          sourceWidth  = width;
+  int          sourceHeight = height;
+
+  for ( auto& level : levels )
+  {
+    level.width  = eastl::max( sourceWidth  >> 1, 1 );
+    level.height = eastl::max( sourceHeight >> 1, 1 );
+    level.texels.resize( level.width * level.height );
+
+    for ( int y = 0; y < level.height; ++y )
+    {
+      for ( int x = 0; x < level.width; ++x )
+      {
+        // The last row and column also cover the texels left over by odd source sizes
+        int firstX = eastl::min( x * 2, sourceWidth  - 1 );
+        int firstY = eastl::min( y * 2, sourceHeight - 1 );
+        int lastX  = x == level.width  - 1 ? sourceWidth  - 1 : eastl::min( firstX + 1, sourceWidth  - 1 );
+        int lastY  = y == level.height - 1 ? sourceHeight - 1 : eastl::min( firstY + 1, sourceHeight - 1 );
+
+        float farthest = source[ firstY * sourceWidth + firstX ];
+        for ( int sy = firstY; sy <= lastY; ++sy )
+          for ( int sx = firstX; sx <= lastX; ++sx )
+            farthest = Farthest( farthest, source[ sy * sourceWidth + sx ] );
+
+        level.texels[ y * level.width + x ] = farthest;
+      }
+    }
+
+    source       = level.texels.data();
+    sourceWidth  = level.width;
+    sourceHeight = level.height;
+  }
+}
+
+bool HiZPyramid::IsOccluded( FXMMATRIX mvp, const XMFLOAT4& center, const XMFLOAT4& extents ) const
+{
+  if ( depthWidth == 0 || depthHeight == 0 )
+    return false;
+
+  auto centerV = XMVectorSetW( XMLoadFloat4( &center ), 1 );
+
+  auto ndcMin = XMVectorReplicate(  FLT_MAX );
+  auto ndcMax = XMVectorReplicate( -FLT_MAX );
+
+  for ( int corner = 0; corner < 8; ++corner )
+  {
+    auto offset = XMVectorSet( corner & 1 ? extents.x : -extents.x
+                             , corner & 2 ? extents.y : -extents.y
+                             , corner & 4 ? extents.z : -extents.z
+                             , 0 );
+
+    auto clip = XMVector4Transform( XMVectorAdd( centerV, offset ), mvp );
+
+    // Boxes crossing the near plane are too close to be hidden.
+    float w = XMVectorGetW( clip );
+    if ( w <= 0 )
+      return false;
+
+    auto ndc = XMVectorScale( clip, 1.0f / w );
+    ndcMin = XMVectorMin( ndcMin, ndc );
+    ndcMax = XMVectorMax( ndcMax, ndc );
+  }
+
+  XMFLOAT3 mn, mx;
+  XMStoreFloat3( &mn, ndcMin );
+  XMStoreFloat3( &mx, ndcMax );
+
+  // Off screen boxes are left for the frustum culling to decide.
+  if ( mx.x < -1 || mx.y < -1 || mn.x > 1 || mn.y > 1 )
+    return false;
+
+  float uvMinX = Saturate(  mn.x * 0.5f + 0.5f );
+  float uvMinY = Saturate( -mx.y * 0.5f + 0.5f );
+  float uvMaxX = Saturate(  mx.x * 0.5f + 0.5f );
+  float uvMaxY = Saturate( -mn.y * 0.5f + 0.5f );
+
+  int pixelMinX = eastl::min( int( uvMinX * depthWidth  ), depthWidth  - 1 );
+  int pixelMinY = eastl::min( int( uvMinY * depthHeight ), depthHeight - 1 );
+  int pixelMaxX = eastl::min( int( uvMaxX * depthWidth  ), depthWidth  - 1 );
+  int pixelMaxY = eastl::min( int( uvMaxY * depthHeight ), depthHeight - 1 );
+
+  // Pick the level where the rectangle is at most 2x2 texels
+  int span  = eastl::max( eastl::max( pixelMaxX - pixelMinX, pixelMaxY - pixelMinY ), 1 );
+  int level = eastl::clamp( FirstBitHigh( uint32_t( span ) ), 0, HiZLevelCount - 1 );
+
+  auto& hiZ = levels[ level ];
+
+  int texelMinX = eastl::min( pixelMinX >> ( level + 1 ), hiZ.width  - 1 );
+  int texelMinY = eastl::min( pixelMinY >> ( level + 1 ), hiZ.height - 1 );
+  int texelMaxX = eastl::min( pixelMaxX >> ( level + 1 ), hiZ.width  - 1 );
+  int texelMaxY = eastl::min( pixelMaxY >> ( level + 1 ), hiZ.height - 1 );
+
+  // Too big for the smallest level, just let it through.
+  if ( texelMaxX - texelMinX > 1 || texelMaxY - texelMinY > 1 )
+    return false;
+
+  float farthest = Farthest( Farthest( hiZ.texels[ texelMinY * hiZ.width + texelMinX ], hiZ.texels[ texelMinY * hiZ.width + texelMaxX ] )
+                           , Farthest( hiZ.texels[ texelMaxY * hiZ.width + texelMinX ], hiZ.texels[ texelMaxY * hiZ.width + texelMaxX ] ) );
+
+  #if USE_REVERSE_PROJECTION
+    return mx.z < farthest;
+  #else
+    return mn.z > farthest;
+  #endif
+}
+
+int HiZPyramid::GetLevelWidth( int level ) const
+{
+  return levels[ level ].width;
+}
+
+int HiZPyramid::GetLevelHeight( int level ) const
+{
+  return levels[ level ].height;
+}
+
+const float* HiZPyramid::GetLevel( int level ) const
+{
+  return levels[ level ].texels.data();
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Render/ShaderValues.h"
+
+// CPU version of the Hi-Z pyramid the GPU culling builds from the depth buffer. It follows HiZBuild.hlsl and
+// IsOccludedByHiZ in Culling.hlsli texel by texel, so it can be used to check the GPU results against.
+class HiZPyramid
+{
+public:
+  // Builds the levels from a full resolution depth buffer, in the depth convention set by USE_REVERSE_PROJECTION.
+  void Build( const float* depth, int width, int height );
+
+  bool IsOccluded( FXMMATRIX mvp, const XMFLOAT4& center, const XMFLOAT4& extents ) const;
+
+  int          GetLevelWidth( int level ) const;
+  int          GetLevelHeight( int level ) const;
+  const float* GetLevel( int level ) const;
+
+private:
+  struct Level
+  {
+    int                    width  = 0;
+    int                    height = 0;
+    eastl::vector< float > texels;
+  };
+
+  int   depthWidth  = 0;
+  int   depthHeight = 0;
+  Level levels[ HiZLevelCount ];
+};
\ No newline at end of file
@@ -0,0 +1,421 @@
+#include "InstanceBVH.h"
+#include "SceneStore.h"
+
+static constexpr int binCount     = 16;
+static constexpr int maxLeafSize  = 8;
+static constexpr int minSplitSize = 2;
+
+static float HalfArea( FXMVECTOR aabbMin, FXMVECTOR aabbMax )
+{
+  XMFLOAT3 size;
+  XMStoreFloat3( &size, XMVectorMax( XMVectorSubtract( aabbMax, aabbMin ), XMVectorZero() ) );
+  return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+void InstanceBVH::Build( const SceneStore& sceneStore )
+{
+  nodes.clear();
+  leafMeshSlots.clear();
+
+  int slotCount = sceneStore.GetInstanceCount();
+
+  instanceMin.resize( slotCount );
+  instanceMax.resize( slotCount );
+
+  for ( int meshSlot = 0; meshSlot < slotCount; meshSlot++ )
+  {
+    UpdateInstanceBounds( sceneStore, meshSlot );
+    if ( sceneStore.GetMeshSlotNode( meshSlot ) != 0 )
+      leafMeshSlots.push_back( meshSlot );
+  }
+
+  if ( leafMeshSlots.empty() )
+    return;
+
+  // A binary tree with n leaves never has more than 2n - 1 nodes, so the node references stay valid while splitting.
+  nodes.reserve( leafMeshSlots.size() * 2 );
+
+  nodes.emplace_back();
+  nodes[ 0 ].leftOrFirst   = 0;
+  nodes[ 0 ].instanceCount = int( leafMeshSlots.size() );
+  UpdateNodeBounds( 0 );
+
+  eastl::vector< int > stack;
+  stack.push_back( 0 );
+
+  while ( !stack.empty() )
+  {
+    int nodeIx = stack.back();
+    stack.pop_back();
+
+    if ( Split( nodeIx ) )
+    {
+      stack.push_back( nodes[ nodeIx ].leftOrFirst );
+      stack.push_back( nodes[ nodeIx ].leftOrFirst + 1 );
+    }
+  }
+}
+
+void InstanceBVH::Refit( const SceneStore& sceneStore, const int* movedNodes, int movedNodeCount )
+{
+  if ( nodes.empty() )
+    return;
+
+  auto& nodeSlots = sceneStore.GetNodeSlots();
+
+  bool anyMeshMoved = false;
+  for ( int movedIx = 0; movedIx < movedNodeCount; movedIx++ )
+  {
+    int nodeIx        = movedNodes[ movedIx ];
+    int meshSlotCount = sceneStore.GetMeshSlotCount( nodeIx );
+    if ( nodeIx == 0 || meshSlotCount == 0 )
+      continue;
+
+    int firstMeshSlot = nodeSlots[ nodeIx ].firstMeshSlot;
+    for ( int meshSlot = firstMeshSlot; meshSlot < firstMeshSlot + meshSlotCount; meshSlot++ )
+      UpdateInstanceBounds( sceneStore, meshSlot );
+
+    anyMeshMoved = true;
+  }
+
+  if ( !anyMeshMoved )
+    return;
+
+  // Children are always stored after their parent, so a reverse walk visits them first.
+  for ( int nodeIx = int( nodes.size() ) - 1; nodeIx >= 0; nodeIx-- )
+  {
+    auto& node = nodes[ nodeIx ];
+    if ( node.instanceCount > 0 )
+    {
+      UpdateNodeBounds( nodeIx );
+      continue;
+    }
+
+    auto& left  = nodes[ node.leftOrFirst ];
+    auto& right = nodes[ node.leftOrFirst + 1 ];
+    XMStoreFloat3( &node.aabbMin, XMVectorMin( XMLoadFloat3( &left.aabbMin ), XMLoadFloat3( &right.aabbMin ) ) );
+    XMStoreFloat3( &node.aabbMax, XMVectorMax( XMLoadFloat3( &left.aabbMax ), XMLoadFloat3( &right.aabbMax ) ) );
+  }
+}
+
+void InstanceBVH::QueryFrustum( FXMMATRIX viewProjection, eastl::vector< int >& meshSlots ) const
+{
+  if ( nodes.empty() )
+    return;
+
+  // Clip space planes, for the same 0 <= z <= w depth range the culling shader tests.
+  auto columns = XMMatrixTranspose( viewProjection );
+  XMVECTOR planes[ 6 ] =
+  {
+    XMVectorAdd     ( columns.r[ 3 ], columns.r[ 0 ] ),
+    XMVectorSubtract( columns.r[ 3 ], columns.r[ 0 ] ),
+    XMVectorAdd     ( columns.r[ 3 ], columns.r[ 1 ] ),
+    XMVectorSubtract( columns.r[ 3 ], columns.r[ 1 ] ),
+    columns.r[ 2 ],
+    XMVectorSubtract( columns.r[ 3 ], columns.r[ 2 ] ),
+  };
+
+  enum class Overlap { Outside, Intersects, Inside };
+
+  auto testBox = [ &planes ]( const XMFLOAT3& boxMin, const XMFLOAT3& boxMax )
+  {
+    auto aabbMin = XMLoadFloat3( &boxMin );
+    auto aabbMax = XMLoadFloat3( &boxMax );
+    auto center  = XMVectorSetW( XMVectorScale( XMVectorAdd( aabbMin, aabbMax ), 0.5f ), 1 );
+    auto extents = XMVectorScale( XMVectorSubtract( aabbMax, aabbMin ), 0.5f );
+
+    auto result = Overlap::Inside;
+    for ( auto& plane : planes )
+    {
+      float distance = XMVectorGetX( XMVector4Dot( plane, center ) );
+      float radius   = XMVectorGetX( XMVector3Dot( XMVectorAbs( plane ), extents ) );
+      if ( distance + radius < 0 )
+        return Overlap::Outside;
+      if ( distance - radius < 0 )
+        result = Overlap::Intersects;
+    }
+    return result;
+  };
+
+  auto addLeaves = [ this, &meshSlots ]( const BVHNode& node )
+  {
+    meshSlots.insert( meshSlots.end()
+                    , leafMeshSlots.begin() + node.leftOrFirst
+                    , leafMeshSlots.begin() + node.leftOrFirst + node.instanceCount );
+  };
+
+  eastl::vector< int > stack;
+  stack.push_back( 0 );
+
+  while ( !stack.empty() )
+  {
+    auto& node = nodes[ stack.back() ];
+    stack.pop_back();
+
+    auto overlap = testBox( node.aabbMin, node.aabbMax );
+    if ( overlap == Overlap::Outside )
+      continue;
+
+    if ( overlap == Overlap::Inside )
+    {
+      // Everything below is visible, collect the leaves without testing them.
+      eastl::vector< int > insideStack;
+      insideStack.push_back( int( &node - nodes.data() ) );
+      while ( !insideStack.empty() )
+      {
+        auto& insideNode = nodes[ insideStack.back() ];
+        insideStack.pop_back();
+
+        if ( insideNode.instanceCount > 0 )
+          addLeaves( insideNode );
+        else
+        {
+          insideStack.push_back( insideNode.leftOrFirst );
+          insideStack.push_back( insideNode.leftOrFirst + 1 );
+        }
+      }
+      continue;
+    }
+
+    if ( node.instanceCount == 0 )
+    {
+      stack.push_back( node.leftOrFirst );
+      stack.push_back( node.leftOrFirst + 1 );
+      continue;
+    }
+
+    for ( int leafIx = node.leftOrFirst; leafIx < node.leftOrFirst + node.instanceCount; leafIx++ )
+    {
+      int meshSlot = leafMeshSlots[ leafIx ];
+      if ( testBox( instanceMin[ meshSlot ], instanceMax[ meshSlot ] ) != Overlap::Outside )
+        meshSlots.push_back( meshSlot );
+    }
+  }
+}
+
+void InstanceBVH::QuerySphere( FXMVECTOR center, float radius, eastl::vector< int >& meshSlots ) const
+{
+  if ( nodes.empty() )
+    return;
+
+  float radiusSq = radius * radius;
+
+  auto testBox = [ center, radiusSq ]( const XMFLOAT3& boxMin, const XMFLOAT3& boxMax )
+  {
+    auto closest = XMVectorClamp( center, XMLoadFloat3( &boxMin ), XMLoadFloat3( &boxMax ) );
+    return XMVectorGetX( XMVector3LengthSq( XMVectorSubtract( closest, center ) ) ) <= radiusSq;
+  };
+
+  eastl::vector< int > stack;
+  stack.push_back( 0 );
+
+  while ( !stack.empty() )
+  {
+    auto& node = nodes[ stack.back() ];
+    stack.pop_back();
+
+    if ( !testBox( node.aabbMin, node.aabbMax ) )
+      continue;
+
+    if ( node.instanceCount == 0 )
+    {
+      stack.push_back( node.leftOrFirst );
+      stack.push_back( node.leftOrFirst + 1 );
+      continue;
+    }
+
+    for ( int leafIx = node.leftOrFirst; leafIx < node.leftOrFirst + node.instanceCount; leafIx++ )
+    {
+      int meshSlot = leafMeshSlots[ leafIx ];
+      if ( testBox( instanceMin[ meshSlot ], instanceMax[ meshSlot ] ) )
+        meshSlots.push_back( meshSlot );
+    }
+  }
+}
+
+const eastl::vector< BVHNode >& InstanceBVH::GetNodes() const
+{
+  return nodes;
+}
+
+const eastl::vector< int >& InstanceBVH::GetLeafMeshSlots() const
+{
+  return leafMeshSlots;
+}
+
+void InstanceBVH::UpdateInstanceBounds( const SceneStore& sceneStore, int meshSlot )
+{
+  auto& mesh      = sceneStore.GetMeshSlots()[ meshSlot ];
+  auto  transform = sceneStore.GetWorldTransform( sceneStore.GetMeshSlotNode( meshSlot ) );
+
+  auto center = XMVector3Transform( XMLoadFloat4( &mesh.aabbCenter ), transform );
+
+  // The extents of the transformed box are the extents projected to the absolute values of the rotated axes.
+  auto extents = XMVectorAdd( XMVectorAdd( XMVectorScale( XMVectorAbs( transform.r[ 0 ] ), mesh.aabbExtents.x )
+                                         , XMVectorScale( XMVectorAbs( transform.r[ 1 ] ), mesh.aabbExtents.y ) )
+                                         , XMVectorScale( XMVectorAbs( transform.r[ 2 ] ), mesh.aabbExtents.z ) );
+
+  XMStoreFloat3( &instanceMin[ meshSlot ], XMVectorSubtract( center, extents ) );
+  XMStoreFloat3( &instanceMax[ meshSlot ], XMVectorAdd( center, extents ) );
+}
+
+void InstanceBVH::UpdateNodeBounds( int nodeIndex )
+{
+  auto& node = nodes[ nodeIndex ];
+
+  auto aabbMin = XMVectorReplicate(  FLT_MAX );
+  auto aabbMax = XMVectorReplicate( -FLT_MAX );
+  for ( int leafIx = node.leftOrFirst; leafIx < node.leftOrFirst + node.instanceCount; leafIx++ )
+  {
+    int meshSlot = leafMeshSlots[ leafIx ];
+    aabbMin = XMVectorMin( aabbMin, XMLoadFloat3( &instanceMin[ meshSlot ] ) );
+    aabbMax = XMVectorMax( aabbMax, XMLoadFloat3( &instanceMax[ meshSlot ] ) );
+  }
+
+  XMStoreFloat3( &node.aabbMin, aabbMin );
+  XMStoreFloat3( &node.aabbMax, aabbMax );
+}
+
+bool InstanceBVH::Split( int nodeIndex )
+{
+  auto& node = nodes[ nodeIndex ];
+  if ( node.instanceCount <= minSplitSize )
+    return false;
+
+  int firstLeaf = node.leftOrFirst;
+  int lastLeaf  = node.leftOrFirst + node.instanceCount;
+
+  auto centroid = [ this ]( int meshSlot )
+  {
+    return XMVectorScale( XMVectorAdd( XMLoadFloat3( &instanceMin[ meshSlot ] ), XMLoadFloat3( &instanceMax[ meshSlot ] ) ), 0.5f );
+  };
+
+  auto centroidMinV = XMVectorReplicate(  FLT_MAX );
+  auto centroidMaxV = XMVectorReplicate( -FLT_MAX );
+  for ( int leafIx = firstLeaf; leafIx < lastLeaf; leafIx++ )
+  {
+    auto c = centroid( leafMeshSlots[ leafIx ] );
+    centroidMinV = XMVectorMin( centroidMinV, c );
+    centroidMaxV = XMVectorMax( centroidMaxV, c );
+  }
+
+  XMFLOAT3 centroidMin, centroidMax;
+  XMStoreFloat3( &centroidMin, centroidMinV );
+  XMStoreFloat3( &centroidMax, centroidMaxV );
+
+  struct Bin
+  {
+    XMVECTOR aabbMin;
+    XMVECTOR aabbMax;
+    int      count;
+  };
+
+  float bestCost = FLT_MAX;
+  int   bestAxis = -1;
+  int   bestBin  = -1;
+
+  for ( int axis = 0; axis < 3; axis++ )
+  {
+    float axisMin = ( &centroidMin.x )[ axis ];
+    float axisMax = ( &centroidMax.x )[ axis ];
+    if ( axisMax <= axisMin )
+      continue;
+
+    Bin bins[ binCount ];
+    for ( auto& bin : bins )
+    {
+      bin.aabbMin = XMVectorReplicate(  FLT_MAX );
+      bin.aabbMax = XMVectorReplicate( -FLT_MAX );
+      bin.count   = 0;
+    }
+
+    float scale = binCount / ( axisMax - axisMin );
+    for ( int leafIx = firstLeaf; leafIx < lastLeaf; leafIx++ )
+    {
+      int   meshSlot = leafMeshSlots[ leafIx ];
+      int   binIx    = eastl::min( binCount - 1, int( ( XMVectorGetByIndex( centroid( meshSlot ), axis ) - axisMin ) * scale ) );
+      auto& bin      = bins[ binIx ];
+      bin.aabbMin = XMVectorMin( bin.aabbMin, XMLoadFloat3( &instanceMin[ meshSlot ] ) );
+      bin.aabbMax = XMVectorMax( bin.aabbMax, XMLoadFloat3( &instanceMax[ meshSlot ] ) );
+      bin.count++;
+    }
+
+    // Sweep from both sides, so the cost of every split plane between the bins is known.
+    float leftArea [ binCount - 1 ];
+    float rightArea[ binCount - 1 ];
+    int   leftCount [ binCount - 1 ];
+    int   rightCount[ binCount - 1 ];
+
+    auto leftMin  = XMVectorReplicate(  FLT_MAX );
+    auto leftMax  = XMVectorReplicate( -FLT_MAX );
+    auto rightMin = XMVectorReplicate(  FLT_MAX );
+    auto rightMax = XMVectorReplicate( -FLT_MAX );
+    int  leftSum  = 0;
+    int  rightSum = 0;
+    for ( int binIx = 0; binIx < binCount - 1; binIx++ )
+    {
+      leftSum += bins[ binIx ].count;
+      leftMin  = XMVectorMin( leftMin, bins[ binIx ].aabbMin );
+      leftMax  = XMVectorMax( leftMax, bins[ binIx ].aabbMax );
+      leftCount[ binIx ] = leftSum;
+      leftArea [ binIx ] = HalfArea( leftMin, leftMax );
+
+      rightSum += bins[ binCount - 1 - binIx ].count;
+      rightMin  = XMVectorMin( rightMin, bins[ binCount - 1 - binIx ].aabbMin );
+      rightMax  = XMVectorMax( rightMax, bins[ binCount - 1 - binIx ].aabbMax );
+      rightCount[ binCount - 2 - binIx ] = rightSum;
+      rightArea [ binCount - 2 - binIx ] = HalfArea( rightMin, rightMax );
+    }
+
+    for ( int binIx = 0; binIx < binCount - 1; binIx++ )
+    {
+      if ( leftCount[ binIx ] == 0 || rightCount[ binIx ] == 0 )
+        continue;
+
+      float cost = leftCount[ binIx ] * leftArea[ binIx ] + rightCount[ binIx ] * rightArea[ binIx ];
+      if ( cost < bestCost )
+      {
+        bestCost = cost;
+        bestAxis = axis;
+        bestBin  = binIx;
+      }
+    }
+  }
+
+  // All the centroids are in the same spot, there is nothing to split along.
+  if ( bestAxis < 0 )
+    return false;
+
+  float leafCost = node.instanceCount * HalfArea( XMLoadFloat3( &node.aabbMin ), XMLoadFloat3( &node.aabbMax ) );
+  if ( bestCost >= leafCost && node.instanceCount <= maxLeafSize )
+    return false;
+
+  float axisMin = ( &centroidMin.x )[ bestAxis ];
+  float scale   = binCount / ( ( &centroidMax.x )[ bestAxis ] - axisMin );
+
+  auto middle = eastl::partition( leafMeshSlots.begin() + firstLeaf, leafMeshSlots.begin() + lastLeaf, [ & ]( int meshSlot )
+  {
+    int binIx = eastl::min( binCount - 1, int( ( XMVectorGetByIndex( centroid( meshSlot ), bestAxis ) - axisMin ) * scale ) );
+    return binIx <= bestBin;
+  } );
+
+  int leftCount = int( middle - leafMeshSlots.begin() ) - firstLeaf;
+  assert( leftCount > 0 && leftCount < node.instanceCount );
+
+  int leftIx = int( nodes.size() );
+
+  nodes.emplace_back();
+  nodes.back().leftOrFirst   = firstLeaf;
+  nodes.back().instanceCount = leftCount;
+  UpdateNodeBounds( leftIx );
+
+  nodes.emplace_back();
+  nodes.back().leftOrFirst   = firstLeaf + leftCount;
+  nodes.back().instanceCount = node.instanceCount - leftCount;
+  UpdateNodeBounds( leftIx + 1 );
+
+  node.leftOrFirst   = leftIx;
+  node.instanceCount = 0;
+
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+class SceneStore;
+
+// 32 bytes, so the array can be uploaded and walked by the shaders as it is.
+struct BVHNode
+{
+  XMFLOAT3 aabbMin;
+  int      leftOrFirst;   // First child for inner nodes, the second one follows it. First instance for leaves.
+  XMFLOAT3 aabbMax;
+  int      instanceCount; // Zero for inner nodes.
+};
+
+// Bounding volume hierarchy over the world space bounds of the mesh slots, built with the binned surface area heuristic.
+// The meshes of the root node are left out, as the GPU culling never renders them either.
+class InstanceBVH
+{
+public:
+  void Build( const SceneStore& sceneStore );
+
+  // Updates the bounds of the meshes of the moved nodes, and refits the tree if any of them had meshes.
+  // The topology is kept, so the tree quality degrades if the instances move far.
+  void Refit( const SceneStore& sceneStore, const int* movedNodes, int movedNodeCount );
+
+  void QueryFrustum( FXMMATRIX viewProjection, eastl::vector< int >& meshSlots ) const;
+  void QuerySphere( FXMVECTOR center, float radius, eastl::vector< int >& meshSlots ) const;
+
+  const eastl::vector< BVHNode >& GetNodes() const;
+  const eastl::vector< int     >& GetLeafMeshSlots() const;
+
+private:
+  void UpdateInstanceBounds( const SceneStore& sceneStore, int meshSlot );
+  void UpdateNodeBounds( int nodeIndex );
+  bool Split( int nodeIndex );
+
+  eastl::vector< BVHNode > nodes;
+  eastl::vector< int     > leafMeshSlots;
+
+  eastl::vector< XMFLOAT3 > instanceMin;
+  eastl::vector< XMFLOAT3 > instanceMax;
+};
\ No newline at end of file
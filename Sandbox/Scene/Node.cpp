@@ -36,7 +36,7 @@ void Node::AddChildLight( int lightIndex )
 
 void Node::SetTransform( FXMMATRIX transform )
 {
-  return XMStoreFloat4x4( &this->transform, transform );
+  XMStoreFloat4x4( &this->transform, transform );
 }
 
 void Node::SetName( const char* name )
@@ -5,6 +5,8 @@ class Mesh;
 
 class Node
 {
+  friend class SceneStore;
+
 public:
   Node();
   ~Node();
@@ -20,6 +22,9 @@ public:
   const char* GetName() const;
 
   XMMATRIX GetTransform() const;
+
+  // Composed from the ancestors on every call. The scene keeps the world transforms of all nodes in its SceneStore,
+  // these are for the nodes not built into it yet. See Scene::GetNodeWorldTransform.
   XMMATRIX GetParentFullTransform() const;
   XMMATRIX GetFullTransform() const;
 
@@ -39,6 +44,9 @@ private:
 
   XMFLOAT4X4 transform;
 
+  // The index of the node in the SceneStore built from its tree, -1 outside of it.
+  int storeIndex = -1;
+
   Node*                                    parent = nullptr;
   eastl::vector< eastl::unique_ptr< Node   > > children;
   eastl::vector< eastl::unique_ptr< Camera > > cameras;
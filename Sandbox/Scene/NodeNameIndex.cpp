@@ -0,0 +1,91 @@
+#include "NodeNameIndex.h"
+#include "Node.h"
+
+static bool MatchPattern( const char* pattern, const char* name )
+{
+  const char* starPattern = nullptr;
+  const char* starName    = nullptr;
+
+  while ( *name )
+  {
+    if ( *pattern == '*' )
+    {
+      starPattern = ++pattern;
+      starName    = name;
+    }
+    else if ( *pattern == '?' || *pattern == *name )
+    {
+      ++pattern;
+      ++name;
+    }
+    else if ( starPattern )
+    {
+      pattern = starPattern;
+      name    = ++starName;
+    }
+    else
+      return false;
+  }
+
+  while ( *pattern == '*' )
+    ++pattern;
+
+  return !*pattern;
+}
+
+void NodeNameIndex::Add( Node& node )
+{
+  nodesByName.insert( eastl::make_pair( eastl::string( node.GetName() ), &node ) );
+  sortedNames.emplace_back( eastl::string( node.GetName() ), &node );
+  sortedNamesDirty = true;
+}
+
+void NodeNameIndex::Clear()
+{
+  nodesByName.clear();
+  sortedNames.clear();
+  sortedNamesDirty = false;
+}
+
+Node* NodeNameIndex::Find( const char* name ) const
+{
+  auto iter = nodesByName.find_as( name, eastl::hash< const char* >(), eastl::equal_to_2< eastl::string, const char* >() );
+  return iter == nodesByName.end() ? nullptr : iter->second;
+}
+
+void NodeNameIndex::FindByPrefix( const char* prefix, eastl::vector< Node* >& nodes ) const
+{
+  SortNames();
+
+  auto prefixLength = strlen( prefix );
+  auto iter         = eastl::lower_bound( sortedNames.begin(), sortedNames.end(), prefix, []( const eastl::pair< eastl::string, Node* >& entry, const char* prefix )
+  {
+    return entry.first.compare( prefix ) < 0;
+  } );
+
+  for ( ; iter != sortedNames.end() && iter->first.compare( 0, prefixLength, prefix ) == 0; ++iter )
+    nodes.push_back( iter->second );
+}
+
+void NodeNameIndex::FindByPattern( const char* pattern, eastl::vector< Node* >& nodes ) const
+{
+  SortNames();
+
+  for ( auto& entry : sortedNames )
+    if ( MatchPattern( pattern, entry.first.data() ) )
+      nodes.push_back( entry.second );
+}
+
+void NodeNameIndex::SortNames() const
+{
+  if ( !sortedNamesDirty )
+    return;
+
+  // Stable, so nodes with the same name stay in the order they were added.
+  eastl::stable_sort( sortedNames.begin(), sortedNames.end(), []( const eastl::pair< eastl::string, Node* >& a, const eastl::pair< eastl::string, Node* >& b )
+  {
+    return a.first < b.first;
+  } );
+
+  sortedNamesDirty = false;
+}
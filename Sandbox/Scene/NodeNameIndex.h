@@ -0,0 +1,30 @@
+#pragma once
+
+#include <EASTL/hash_map.h>
+
+class Node;
+
+// Maps node names to nodes. Nodes are owned by their parents through unique pointers, so the returned
+// pointers stay valid for the lifetime of the scene.
+class NodeNameIndex
+{
+public:
+  void Add( Node& node );
+  void Clear();
+
+  // Returns the first added node with the name, like the depth first search did.
+  Node* Find( const char* name ) const;
+
+  void FindByPrefix( const char* prefix, eastl::vector< Node* >& nodes ) const;
+
+  // Supports the '*' and '?' wildcards.
+  void FindByPattern( const char* pattern, eastl::vector< Node* >& nodes ) const;
+
+private:
+  void SortNames() const;
+
+  eastl::hash_map< eastl::string, Node* > nodesByName;
+
+  mutable eastl::vector< eastl::pair< eastl::string, Node* > > sortedNames;
+  mutable bool                                                 sortedNamesDirty = false;
+};
@@ -0,0 +1,316 @@
+#include "OcclusionCuller.h"
+#include "SceneStore.h"
+#include "Common/ParallelFor.h"
+
+static constexpr float nearW            = 1e-3f;
+static constexpr float minTriangleArea  = 1e-6f;
+static constexpr int   minSlotsPerRange = 512;
+
+static_assert( OcclusionCuller::BufferWidth  % OcclusionCuller::TileWidth  == 0, "The buffer has to be made of whole tiles!" );
+static_assert( OcclusionCuller::BufferHeight % OcclusionCuller::TileHeight == 0, "The buffer has to be made of whole tiles!" );
+static_assert( OcclusionCuller::TileWidth % 4 == 0, "The rasterizer writes 4 pixels at a time!" );
+
+// Clip space to buffer pixel coordinates, with 1/w in z.
+static XMFLOAT3 ToScreen( FXMVECTOR clip )
+{
+  XMFLOAT4 c;
+  XMStoreFloat4( &c, clip );
+
+  float invW = 1.0f / c.w;
+  return XMFLOAT3( ( c.x * invW *  0.5f + 0.5f ) * OcclusionCuller::BufferWidth
+                 , ( c.y * invW * -0.5f + 0.5f ) * OcclusionCuller::BufferHeight
+                 , invW );
+}
+
+void OcclusionCuller::AddOccluderMesh( int meshIndex, eastl::vector< XMFLOAT3 >&& positions, eastl::vector< uint32_t >&& indices )
+{
+  auto& mesh = occluderMeshes[ meshIndex ];
+  mesh.positions = eastl::move( positions );
+  mesh.indices   = eastl::move( indices );
+}
+
+bool OcclusionCuller::HasOccluderMesh( int meshIndex ) const
+{
+  return occluderMeshes.find( meshIndex ) != occluderMeshes.end();
+}
+
+bool OcclusionCuller::HasOccluders() const
+{
+  return !occluderMeshes.empty();
+}
+
+void OcclusionCuller::SetUpInstances( const SceneStore& sceneStore )
+{
+  occluderSlots.clear();
+
+  // The root node meshes are not rendered, so they are not occluding anything either.
+  for ( int meshSlot = 0; meshSlot < sceneStore.GetInstanceCount(); meshSlot++ )
+    if ( sceneStore.GetMeshSlotNode( meshSlot ) != 0 && HasOccluderMesh( sceneStore.GetMeshIndex( meshSlot ) ) )
+      occluderSlots.push_back( meshSlot );
+}
+
+void OcclusionCuller::RenderOccluders( const SceneStore& sceneStore, FXMMATRIX viewProjection )
+{
+  auto startTime = GetCPUTime();
+
+  XMStoreFloat4x4( &this->viewProjection, viewProjection );
+
+  depthBuffer.resize( BufferWidth * BufferHeight );
+  tileDepths.resize( TileCountX * TileCountY );
+  eastl::fill( depthBuffer.begin(), depthBuffer.end(), 0.0f );
+
+  stats.occluderTriangles = 0;
+
+  eastl::vector< XMFLOAT4 > clipPositions;
+
+  for ( int meshSlot : occluderSlots )
+  {
+    auto& mesh = occluderMeshes.find( sceneStore.GetMeshIndex( meshSlot ) )->second;
+    auto  mvp  = sceneStore.GetWorldTransform( sceneStore.GetMeshSlotNode( meshSlot ) ) * viewProjection;
+
+    clipPositions.resize( mesh.positions.size() );
+    XMVector3TransformStream( clipPositions.data(), sizeof( XMFLOAT4 ), mesh.positions.data(), sizeof( XMFLOAT3 ), mesh.positions.size(), mvp );
+
+    for ( size_t index = 0; index + 2 < mesh.indices.size(); index += 3 )
+    {
+      auto& c0 = clipPositions[ mesh.indices[ index + 0 ] ];
+      auto& c1 = clipPositions[ mesh.indices[ index + 1 ] ];
+      auto& c2 = clipPositions[ mesh.indices[ index + 2 ] ];
+
+      // Leaving out an occluder triangle is always safe, so there is no near plane clipping.
+      if ( c0.w < nearW || c1.w < nearW || c2.w < nearW )
+        continue;
+
+      RasterizeTriangle( ToScreen( XMLoadFloat4( &c0 ) ), ToScreen( XMLoadFloat4( &c1 ) ), ToScreen( XMLoadFloat4( &c2 ) ) );
+      stats.occluderTriangles++;
+    }
+  }
+
+  BuildHierarchy();
+
+  stats.rasterTime = GetCPUTime() - startTime;
+}
+
+void OcclusionCuller::CullMeshSlots( const SceneStore& sceneStore, eastl::vector< uint8_t >& visibility )
+{
+  auto startTime = GetCPUTime();
+
+  auto vp = XMLoadFloat4x4( &viewProjection );
+
+  eastl::atomic< int > testedInstances = 0;
+  eastl::atomic< int > culledInstances = 0;
+
+  ParallelFor( int( visibility.size() ), minSlotsPerRange, [ & ]( int firstSlot, int lastSlot )
+  {
+    auto& meshSlots = sceneStore.GetMeshSlots();
+    int   lastNode  = -1;
+    int   tested    = 0;
+    int   culled    = 0;
+
+    XMMATRIX mvp;
+
+    for ( int meshSlot = firstSlot; meshSlot < lastSlot; meshSlot++ )
+    {
+      if ( !visibility[ meshSlot ] )
+        continue;
+
+      int nodeIndex = sceneStore.GetMeshSlotNode( meshSlot );
+      if ( nodeIndex != lastNode )
+      {
+        mvp      = sceneStore.GetWorldTransform( nodeIndex ) * vp;
+        lastNode = nodeIndex;
+      }
+
+      tested++;
+
+      if ( IsOccluded( mvp, meshSlots[ meshSlot ].aabbCenter, meshSlots[ meshSlot ].aabbExtents ) )
+      {
+        visibility[ meshSlot ] = 0;
+        culled++;
+      }
+    }
+
+    testedInstances += tested;
+    culledInstances += culled;
+  } );
+
+  stats.testedInstances = testedInstances;
+  stats.culledInstances = culledInstances;
+  stats.testTime        = GetCPUTime() - startTime;
+}
+
+bool OcclusionCuller::IsOccluded( FXMMATRIX mvp, const XMFLOAT4& center, const XMFLOAT4& extents ) const
+{
+  if ( depthBuffer.empty() )
+    return false;
+
+  auto centerV = XMVectorSetW( XMLoadFloat4( &center ), 1 );
+
+  float minX    =  FLT_MAX;
+  float minY    =  FLT_MAX;
+  float maxX    = -FLT_MAX;
+  float maxY    = -FLT_MAX;
+  float nearest = 0;
+
+  for ( int corner = 0; corner < 8; corner++ )
+  {
+    auto offset = XMVectorSet( corner & 1 ? extents.x : -extents.x
+                             , corner & 2 ? extents.y : -extents.y
+                             , corner & 4 ? extents.z : -extents.z
+                             , 0 );
+
+    auto clip = XMVector4Transform( XMVectorAdd( centerV, offset ), mvp );
+
+    // Boxes crossing the near plane are too close to be hidden.
+    if ( XMVectorGetW( clip ) < nearW )
+      return false;
+
+    auto screen = ToScreen( clip );
+    minX    = eastl::min( minX, screen.x );
+    minY    = eastl::min( minY, screen.y );
+    maxX    = eastl::max( maxX, screen.x );
+    maxY    = eastl::max( maxY, screen.y );
+    nearest = eastl::max( nearest, screen.z );
+  }
+
+  // Off screen boxes are left for the frustum culling to decide.
+  if ( maxX < 0 || maxY < 0 || minX >= BufferWidth || minY >= BufferHeight )
+    return false;
+
+  int pixelX0 = int( eastl::max( minX, 0.0f ) );
+  int pixelY0 = int( eastl::max( minY, 0.0f ) );
+  int pixelX1 = int( eastl::min( maxX, float( BufferWidth  - 1 ) ) );
+  int pixelY1 = int( eastl::min( maxY, float( BufferHeight - 1 ) ) );
+
+  for ( int tileY = pixelY0 / TileHeight; tileY <= pixelY1 / TileHeight; tileY++ )
+  {
+    for ( int tileX = pixelX0 / TileWidth; tileX <= pixelX1 / TileWidth; tileX++ )
+    {
+      // The whole tile is covered by something closer than the box.
+      if ( tileDepths[ tileY * TileCountX + tileX ] > nearest )
+        continue;
+
+      int x0 = eastl::max( pixelX0, tileX * TileWidth );
+      int y0 = eastl::max( pixelY0, tileY * TileHeight );
+      int x1 = eastl::min( pixelX1, tileX * TileWidth  + TileWidth  - 1 );
+      int y1 = eastl::min( pixelY1, tileY * TileHeight + TileHeight - 1 );
+
+      for ( int y = y0; y <= y1; y++ )
+        for ( int x = x0; x <= x1; x++ )
+          if ( depthBuffer[ y * BufferWidth + x ] <= nearest )
+            return false;
+    }
+  }
+
+  return true;
+}
+
+const OcclusionCuller::Stats& OcclusionCuller::GetStats() const
+{
+  return stats;
+}
+
+const eastl::vector< float >& OcclusionCuller::GetDepthBuffer() const
+{
+  return depthBuffer;
+}
+
+void OcclusionCuller::RasterizeTriangle( XMFLOAT3 v0, XMFLOAT3 v1, XMFLOAT3 v2 )
+{
+  float area = ( v1.x - v0.x ) * ( v2.y - v0.y ) - ( v2.x - v0.x ) * ( v1.y - v0.y );
+  if ( fabsf( area ) < minTriangleArea )
+    return;
+
+  // The winding is not reliable in the content, so both sides are rasterized.
+  if ( area < 0 )
+  {
+    eastl::swap( v1, v2 );
+    area = -area;
+  }
+
+  // Clamped as floats, vertices close to the near plane can be far out of the int range.
+  int minX = int( eastl::clamp( floorf( eastl::min( v0.x, eastl::min( v1.x, v2.x ) ) ), 0.0f, float( BufferWidth ) ) );
+  int minY = int( eastl::clamp( floorf( eastl::min( v0.y, eastl::min( v1.y, v2.y ) ) ), 0.0f, float( BufferHeight ) ) );
+  int maxX = int( eastl::clamp( ceilf ( eastl::max( v0.x, eastl::max( v1.x, v2.x ) ) ), -1.0f, float( BufferWidth  - 1 ) ) );
+  int maxY = int( eastl::clamp( ceilf ( eastl::max( v0.y, eastl::max( v1.y, v2.y ) ) ), -1.0f, float( BufferHeight - 1 ) ) );
+  if ( minX > maxX || minY > maxY )
+    return;
+
+  minX &= ~3;
+
+  // Edge functions as a * x + b * y + c, positive inside.
+  auto edge = []( const XMFLOAT3& from, const XMFLOAT3& to, float& a, float& b, float& c )
+  {
+    a = from.y - to.y;
+    b = to.x - from.x;
+    c = -( a * from.x + b * from.y );
+  };
+
+  float a0, b0, c0, a1, b1, c1, a2, b2, c2;
+  edge( v1, v2, a0, b0, c0 );
+  edge( v2, v0, a1, b1, c1 );
+  edge( v0, v1, a2, b2, c2 );
+
+  // 1/w is interpolated with the barycentrics, which are the normalized edge functions.
+  float invArea = 1.0f / area;
+  float za = ( a0 * v0.z + a1 * v1.z + a2 * v2.z ) * invArea;
+  float zb = ( b0 * v0.z + b1 * v1.z + b2 * v2.z ) * invArea;
+  float zc = ( c0 * v0.z + c1 * v1.z + c2 * v2.z ) * invArea;
+
+  auto laneOffsets = XMVectorSet( 0.5f, 1.5f, 2.5f, 3.5f );
+  auto step        = XMVectorReplicate( 4 );
+
+  for ( int y = minY; y <= maxY; y++ )
+  {
+    float py = y + 0.5f;
+
+    auto px  = XMVectorAdd( XMVectorReplicate( float( minX ) ), laneOffsets );
+    auto e0  = XMVectorMultiplyAdd( XMVectorReplicate( a0 ), px, XMVectorReplicate( b0 * py + c0 ) );
+    auto e1  = XMVectorMultiplyAdd( XMVectorReplicate( a1 ), px, XMVectorReplicate( b1 * py + c1 ) );
+    auto e2  = XMVectorMultiplyAdd( XMVectorReplicate( a2 ), px, XMVectorReplicate( b2 * py + c2 ) );
+    auto z   = XMVectorMultiplyAdd( XMVectorReplicate( za ), px, XMVectorReplicate( zb * py + zc ) );
+    auto de0 = XMVectorReplicate( a0 * 4 );
+    auto de1 = XMVectorReplicate( a1 * 4 );
+    auto de2 = XMVectorReplicate( a2 * 4 );
+    auto dz  = XMVectorReplicate( za * 4 );
+
+    float* row = depthBuffer.data() + y * BufferWidth;
+
+    for ( int x = minX; x <= maxX; x += 4 )
+    {
+      auto inside = XMVectorAndInt( XMVectorAndInt( XMVectorGreaterOrEqual( e0, XMVectorZero() )
+                                                  , XMVectorGreaterOrEqual( e1, XMVectorZero() ) )
+                                                  , XMVectorGreaterOrEqual( e2, XMVectorZero() ) );
+
+      auto current = XMLoadFloat4( reinterpret_cast< XMFLOAT4* >( row + x ) );
+      XMStoreFloat4( reinterpret_cast< XMFLOAT4* >( row + x ), XMVectorSelect( current, XMVectorMax( current, z ), inside ) );
+
+      e0 = XMVectorAdd( e0, de0 );
+      e1 = XMVectorAdd( e1, de1 );
+      e2 = XMVectorAdd( e2, de2 );
+      z  = XMVectorAdd( z, dz );
+    }
+  }
+}
+
+void OcclusionCuller::BuildHierarchy()
+{
+  // Every tile keeps its farthest depth, so a box behind it is behind all of its pixels.
+  for ( int tileY = 0; tileY < TileCountY; tileY++ )
+  {
+    for ( int tileX = 0; tileX < TileCountX; tileX++ )
+    {
+      auto farthest = XMVectorReplicate( FLT_MAX );
+      for ( int y = tileY * TileHeight; y < tileY * TileHeight + TileHeight; y++ )
+      {
+        const float* row = depthBuffer.data() + y * BufferWidth + tileX * TileWidth;
+        for ( int x = 0; x < TileWidth; x += 4 )
+          farthest = XMVectorMin( farthest, XMLoadFloat4( reinterpret_cast< const XMFLOAT4* >( row + x ) ) );
+      }
+
+      farthest = XMVectorMin( farthest, XMVectorSwizzle< 2, 3, 0, 1 >( farthest ) );
+      farthest = XMVectorMin( farthest, XMVectorSwizzle< 1, 0, 3, 2 >( farthest ) );
+      tileDepths[ tileY * TileCountX + tileX ] = XMVectorGetX( farthest );
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+class SceneStore;
+
+// Software occlusion culling. A few occluder meshes are rasterized into a small depth buffer on the CPU, then
+// the mesh slot bounding boxes are tested against it. The buffer stores 1/w, which is linear in screen space and
+// doesn't depend on the depth range of the projection. Zero means empty, bigger is closer.
+class OcclusionCuller
+{
+public:
+  static constexpr int BufferWidth  = 320;
+  static constexpr int BufferHeight = 192;
+  static constexpr int TileWidth    = 8;
+  static constexpr int TileHeight   = 4;
+  static constexpr int TileCountX   = BufferWidth / TileWidth;
+  static constexpr int TileCountY   = BufferHeight / TileHeight;
+
+  struct Stats
+  {
+    double rasterTime        = 0;
+    double testTime          = 0;
+    int    occluderTriangles = 0;
+    int    testedInstances   = 0;
+    int    culledInstances   = 0;
+  };
+
+  void AddOccluderMesh( int meshIndex, eastl::vector< XMFLOAT3 >&& positions, eastl::vector< uint32_t >&& indices );
+  bool HasOccluderMesh( int meshIndex ) const;
+  bool HasOccluders() const;
+
+  // Collects the mesh slots using the occluder meshes. Has to be called after the scene store is built.
+  void SetUpInstances( const SceneStore& sceneStore );
+
+  void RenderOccluders( const SceneStore& sceneStore, FXMMATRIX viewProjection );
+
+  // Clears the visibility of the mesh slots hidden behind the occluders. Slots already invisible are not tested.
+  void CullMeshSlots( const SceneStore& sceneStore, eastl::vector< uint8_t >& visibility );
+
+  bool IsOccluded( FXMMATRIX mvp, const XMFLOAT4& center, const XMFLOAT4& extents ) const;
+
+  const Stats& GetStats() const;
+  const eastl::vector< float >& GetDepthBuffer() const;
+
+private:
+  struct OccluderMesh
+  {
+    eastl::vector< XMFLOAT3 > positions;
+    eastl::vector< uint32_t > indices;
+  };
+
+  void RasterizeTriangle( XMFLOAT3 v0, XMFLOAT3 v1, XMFLOAT3 v2 );
+  void BuildHierarchy();
+
+  eastl::vector_map< int, OccluderMesh > occluderMeshes;
+  eastl::vector< int >                   occluderSlots;
+
+  eastl::vector< float > depthBuffer;
+  eastl::vector< float > tileDepths;
+  XMFLOAT4X4             viewProjection;
+
+  Stats stats;
+};
\ No newline at end of file
@@ -1,12 +1,22 @@
 #include "Scene.h"
 #include "Node.h"
 #include "Camera.h"
+#include "SceneStore.h"
+#include "NodeNameIndex.h"
+#include "FrustumCulling.h"
+#include "InstanceBVH.h"
+#include "OcclusionCuller.h"
+#include "SceneLoader.h"
+#include "WorldPartition.h"
+#include "WorldStreamer.h"
 #include "Common/Color.h"
 #include "Common/Finally.h"
 #include "Common/Files.h"
+#include "Common/MappedFile.h"
 #include "Render/ShaderStructures.h"
 #include "Render/ShaderValues.h"
 #include "Render/Utils.h"
+#include "Render/LowDiscrepancy.h"
 #include "Render/RenderManager.h"
 #include "Render/Mesh.h"
 #include "Render/ResourceDescriptor.h"
@@ -17,6 +27,9 @@
 #include "Render/Swapchain.h"
 #include "Render/RTShaders.h"
 #include "Render/Denoiser.h"
+#include "Render/RenderGraph.h"
+#include "Render/ShaderPackage.h"
+#include "Render/UploadAllocator.h"
 
 #include "assimp/inc/assimp/Importer.hpp"
 #include "assimp/inc/assimp/scene.h"
@@ -29,6 +42,13 @@ static constexpr float initialMaxLog = 4.0f;
 
 static constexpr int triangleExtractRootConstants = 11;
 
+static constexpr int      maxAutoOccluders         = 64;
+static constexpr unsigned maxAutoOccluderTriangles = 2048;
+
+// Each rebuild of the resident scene rebuilds the instance BVH, the scene buffers and the TLAS from scratch, the arriving
+// meshes are collected for a while between them to pay that once for a batch.
+static constexpr int framesBetweenRebuilds = 15;
+
 static void InitializeManualExposure( CommandList& commandList, Resource& expBuffer, Resource& expOnlyBuffer, float exposure )
 {
   ExposureBuffer params;
@@ -41,62 +61,16 @@ static void InitializeManualExposure( CommandList& commandList, Resource& expBuf
   params.logRange        = initialMaxLog - initialMinLog;
   params.invLogRange     = 1.0f / params.logRange;
 
-  auto uploadExposure = RenderManager::GetInstance().GetUploadBufferForResource( expBuffer );
-  commandList.UploadBufferResource( eastl::move( uploadExposure ), expBuffer, &params, sizeof( params ) );
-
-  auto uploadExposureOnly = RenderManager::GetInstance().GetUploadBufferForResource( expOnlyBuffer );
-  commandList.UploadBufferResource( eastl::move( uploadExposureOnly ), expOnlyBuffer, &exposure, sizeof( exposure ) );
+  commandList.UploadBufferResource( expBuffer, &params, sizeof( params ) );
+  commandList.UploadBufferResource( expOnlyBuffer, &exposure, sizeof( exposure ) );
 }
 
-static eastl::wstring GetFileName( const wchar_t* hostFolder )
+static void TearDownResource( CommandList* commandList, eastl::unique_ptr< Resource >& resource )
 {
-  for ( auto& file : std::filesystem::directory_iterator( hostFolder ) )
-    if ( file.is_regular_file() && file.path().extension() == ".fbx" )
-      return std::filesystem::canonical( file.path() ).wstring().data();
-
-  return L"";
-}
-
-static bool Validate( aiMesh* mesh, unsigned meshIx, eastl::wstring& error )
-{
-  aiString    meshName = mesh->mName;
-  const char* meshNameC = meshName.C_Str();
-  if ( !mesh->HasPositions() )
-  {
-    error = L"Mesh (" + eastl::to_wstring( meshIx ) + L") has no positions: " + W( meshNameC );
-    return false;
-  }
-  if ( !mesh->HasFaces() )
-  {
-    error = L"Mesh (" + eastl::to_wstring( meshIx ) + L") has no faces: " + W( meshNameC );
-    return false;
-  }
-  if ( !mesh->HasNormals() )
-  {
-    error = L"Mesh (" + eastl::to_wstring( meshIx ) + L") has no normals: " + W( meshNameC );
-    return false;
-  }
-  if ( mesh->HasBones() )
-  {
-    error = L"Mesh (" + eastl::to_wstring( meshIx ) + L") has bones, which is not yet supported: " + W( meshNameC );
-    return false;
-  }
-
-  return true;
-}
-
-static void Compress( XMHALF4& c, const aiVector3D& u )
-{
-  Float16::Convert( &c.x, u.x );
-  Float16::Convert( &c.y, u.y );
-  Float16::Convert( &c.z, u.z );
-  Float16::Convert( &c.w, 1.0f );
-}
-
-static void Compress( XMHALF2& c, const aiVector3D& u )
-{
-  Float16::Convert( &c.x, u.x );
-  Float16::Convert( &c.y, u.y );
+  if ( commandList )
+    commandList->HoldResource( eastl::move( resource ) );
+  else
+    resource.reset();
 }
 
 struct MeshNode
@@ -105,135 +79,64 @@ struct MeshNode
   XMFLOAT4X4 transform;
 };
 
-static void WalkDCCNodes( aiNode& dccNode, Node& sceneNode )
+static void AddOccluderMesh( OcclusionCuller& occlusionCuller, aiMesh& mesh, int meshIx )
+{
+  eastl::vector< XMFLOAT3 > positions;
+  eastl::vector< uint32_t > indices;
+
+  positions.reserve( mesh.mNumVertices );
+  for ( unsigned vtxIx = 0; vtxIx < mesh.mNumVertices; vtxIx++ )
+    positions.emplace_back( mesh.mVertices[ vtxIx ].x, mesh.mVertices[ vtxIx ].y, mesh.mVertices[ vtxIx ].z );
+
+  indices.reserve( mesh.mNumFaces * 3 );
+  for ( unsigned faceIx = 0; faceIx < mesh.mNumFaces; faceIx++ )
+    for ( unsigned cornerIx = 0; cornerIx < 3; cornerIx++ )
+      indices.emplace_back( uint32_t( mesh.mFaces[ faceIx ].mIndices[ cornerIx ] ) );
+
+  occlusionCuller.AddOccluderMesh( meshIx, eastl::move( positions ), eastl::move( indices ) );
+}
+
+static void WalkDCCNodes( aiNode& dccNode, Node& sceneNode, NodeNameIndex& nodeNameIndex )
 {
   sceneNode.SetTransform( XMMatrixTranspose( XMLoadFloat4x4( (XMFLOAT4X4*)&dccNode.mTransformation ) ) );
   sceneNode.SetName( dccNode.mName.C_Str() );
 
+  nodeNameIndex.Add( sceneNode );
+
   for ( unsigned meshIx = 0; meshIx < dccNode.mNumMeshes; meshIx++ )
     sceneNode.AddChildMesh( dccNode.mMeshes[ meshIx ] );
 
   for ( unsigned childIx = 0; childIx < dccNode.mNumChildren; childIx++ )
   {
     auto& childNode = sceneNode.AddChildNode( eastl::make_unique< Node >() );
-    WalkDCCNodes( *dccNode.mChildren[ childIx ], childNode );
+    WalkDCCNodes( *dccNode.mChildren[ childIx ], childNode, nodeNameIndex );
   }
 }
 
-void Scene::MarshallSceneToGPU( Node& sceneNode, int& instanceCount, Scene& scene )
+void Scene::MarshallSceneToRTInstances( eastl::vector< RTInstance >& rtInstances )
 {
-  auto nodeSlot = int( scene.nodeSlots.size() );
-
-  if ( sceneNode.IsRootChild() )
-    scene.rootNodeChildrenIndices.emplace_back( nodeSlot );
-
-  scene.nodeToIndex[ &sceneNode ] = nodeSlot;
-  scene.indexToNode[ nodeSlot   ] = &sceneNode;
-
-  scene.nodeSlots.emplace_back();
-
-  XMStoreFloat4x4( &scene.nodeSlots[ nodeSlot ].worldTransform, sceneNode.GetTransform() );
+  auto& nodeSlots = sceneStore->GetNodeSlots();
 
-  scene.nodeSlots[ nodeSlot ].cameraSlot      = InvalidSlot;
-  scene.nodeSlots[ nodeSlot ].lightSlot       = InvalidSlot;
-  scene.nodeSlots[ nodeSlot ].firstMeshSlot   = InvalidSlot;
-  scene.nodeSlots[ nodeSlot ].firstChildSlot  = InvalidSlot;
-  scene.nodeSlots[ nodeSlot ].nextSiblingSlot = InvalidSlot;
+  rtInstances.reserve( sceneStore->GetInstanceCount() );
 
-  // From assimp, there can be only one camera per node. So we can just take the first one.
-  sceneNode.ForEachCamera( [&]( Camera& camera ) mutable
+  for ( int nodeIx = 0; nodeIx < sceneStore->GetNodeCount(); nodeIx++ )
   {
-    scene.nodeSlots[ nodeSlot ].cameraSlot = int( scene.cameraSlots.size() );
-
-    scene.cameraSlots.emplace_back();
-    auto& cameraSlot = scene.cameraSlots.back();
-
-    XMStoreFloat4x4( &cameraSlot.projTransform, camera.GetProjTransform() );
-
-    cameraNodeIndex = nodeSlot;
-
-    return false;
-  });
-
-  // From assimp, there can be only one light per node. So we can just take the first one.
-  sceneNode.ForEachLight( [&]( int lightIndex ) mutable
-  {
-    scene.nodeSlots[ nodeSlot ].lightSlot = lightIndex;
-    return false;
-  });
-
-  int lastMeshSlot = -1;
-  sceneNode.ForEachMesh( [&]( int meshIndex ) mutable
-  {
-    instanceCount++;
-
-    int meshSlotIndex = int( scene.meshSlots.size() );
-      
-    if ( scene.nodeSlots[ nodeSlot ].firstMeshSlot == InvalidSlot )
-      scene.nodeSlots[ nodeSlot ].firstMeshSlot = meshSlotIndex;
-    else
-      scene.meshSlots[ lastMeshSlot ].nextSlotIndex = meshSlotIndex;
-
-    lastMeshSlot = meshSlotIndex;
-
-    scene.meshSlots.emplace_back();
-    auto& meshSlot = scene.meshSlots.back();
-
-    auto& aabb = scene.meshes[ meshIndex ]->GetAABB();
-
-    meshSlot.aabbCenter     = XMFLOAT4( aabb.Center.x,  aabb.Center.y,  aabb.Center.z,  1 );
-    meshSlot.aabbExtents    = XMFLOAT4( aabb.Extents.x, aabb.Extents.y, aabb.Extents.z, 1 );
-    meshSlot.ibIndex        = scene.meshes[ meshIndex ]->GetIndexBufferSlot() - SceneBufferResourceBaseSlot;
-    meshSlot.vbIndex        = scene.meshes[ meshIndex ]->GetVertexBufferSlot() - SceneBufferResourceBaseSlot;
-    meshSlot.indexCount     = scene.meshes[ meshIndex ]->GetIndexCount();
-    meshSlot.materialIndex  = scene.meshes[ meshIndex ]->GetMaterialIndex();
-    meshSlot.randomValues.x = PackedVector::XMConvertFloatToHalf( Random() );
-    meshSlot.randomValues.y = PackedVector::XMConvertFloatToHalf( Random() );
-    meshSlot.randomValues.z = PackedVector::XMConvertFloatToHalf( Random() );
-    meshSlot.randomValues.w = PackedVector::XMConvertFloatToHalf( Random() );
-    meshSlot.nextSlotIndex  = InvalidSlot;
-
-    return true;
-  });
-
-  int lastChildSlot = -1;
-  sceneNode.ForEachNode( [&]( Node& childNode ) mutable
-  {
-    int childNodeSlotIndex = int( scene.nodeSlots.size() );
-
-    MarshallSceneToGPU( childNode, instanceCount, scene );
-
-    if ( scene.nodeSlots[ nodeSlot ].firstChildSlot == InvalidSlot )
-      scene.nodeSlots[ nodeSlot ].firstChildSlot = childNodeSlotIndex;
-    else
-      scene.nodeSlots[ lastChildSlot ].nextSiblingSlot = childNodeSlotIndex;
-
-    lastChildSlot = childNodeSlotIndex;
-
-    return true;
-  });
-}
-
-void Scene::MarshallSceneToRTInstances( Node& sceneNode, eastl::vector< RTInstance >& rtInstances, Scene& scene )
-{
-  auto nodeTransform = sceneNode.GetFullTransform();
-
-  sceneNode.ForEachMesh( [&]( int meshIndex ) mutable
-  {
-    rtInstances.emplace_back();
-    auto& instance = rtInstances.back();
+    int meshSlotCount = sceneStore->GetMeshSlotCount( nodeIx );
+    if ( meshSlotCount == 0 )
+      continue;
 
-    instance.accel = &scene.meshes[ meshIndex ]->GetRTBottomLevelAccelerator();
-    XMStoreFloat4x4( &instance.transform, nodeTransform );
+    auto nodeTransform = sceneStore->GetWorldTransform( nodeIx );
+    int  firstMeshSlot = int( nodeSlots[ nodeIx ].firstMeshSlot );
 
-    return true;
-  });
+    for ( int meshSlot = firstMeshSlot; meshSlot < firstMeshSlot + meshSlotCount; meshSlot++ )
+    {
+      rtInstances.emplace_back();
+      auto& instance = rtInstances.back();
 
-  sceneNode.ForEachNode( [&]( Node& childNode ) mutable
-  {
-    MarshallSceneToRTInstances( childNode, rtInstances, scene );
-    return true;
-  });
+      instance.accel = &meshes[ sceneStore->GetMeshIndex( meshSlot ) ]->GetRTBottomLevelAccelerator();
+      XMStoreFloat4x4( &instance.transform, nodeTransform );
+    }
+  }
 }
 
 static void NotifyCamerasOnWindowSizeChange( Node& sceneNode, float aspect )
@@ -314,7 +217,10 @@ void Scene::TearDown( CommandList* commandList )
 }
 
 Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWidth, int screenHeight )
-: manualExposure( 2.0f )
+: hostFolder( hostFolder )
+, screenWidth( screenWidth )
+, screenHeight( screenHeight )
+, manualExposure( 2.0f )
 , targetLuminance( 0.6f )
 , adaptationRate( 0.093f )
 , minExposure( 0.35f )
@@ -322,10 +228,12 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
 , bloomThreshold( 2.0f )
 , bloomStrength( 0.1f )
 {
+  CPUSection cpuSection( L"Load scene" );
+
   auto& manager = RenderManager::GetInstance();
   auto& device  = manager.GetDevice();
 
-  auto sceneFilePath = GetFileName( hostFolder );
+  auto sceneFilePath = SceneLoader::FindSceneFile( hostFolder );
   if ( sceneFilePath.empty() )
   {
     error = L"Failed to find file in: ";
@@ -333,60 +241,253 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
     return;
   }
 
-  Assimp::Importer importer;
-
-  unsigned flags = aiProcess_OptimizeMeshes
-                 | aiProcess_MakeLeftHanded
-                 | aiProcess_FlipUVs
-                 | aiProcess_FlipWindingOrder
-                 | aiProcess_GenNormals
-                 | aiProcess_JoinIdenticalVertices
-                 | aiProcess_ImproveCacheLocality
-                 | aiProcess_LimitBoneWeights
-                 | aiProcess_RemoveRedundantMaterials
-                 | aiProcess_Triangulate
-                 | aiProcess_SortByPType
-                 | aiProcess_FindDegenerates
-                 | aiProcess_FindInvalidData
-                 | aiProcess_FindInstances
-                 | aiProcess_ValidateDataStructure
-                 | aiProcess_CalcTangentSpace
-                 | aiProcess_SplitLargeMeshes;
-
-  importer.SetPropertyInteger( AI_CONFIG_PP_SLM_TRIANGLE_LIMIT, 0xFFFF / 3 );
-
-  importer.ReadFile( N( sceneFilePath.data() ).data(), flags );
-
-  const aiScene* scene = importer.GetScene();
-
-  if ( !scene )
+  // The import and the conversion run while the rest of the scene is set up.
+  loader = eastl::make_unique< SceneLoader >( sceneFilePath.data() );
+
+  indirectDrawCountBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( uint32_t ) * 16, sizeof( uint32_t ), L"indirectDrawCountBuffer" );
+  auto indirectDrawCountBufferDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, IndirectDrawCountBufferSlot, *indirectDrawCountBuffer, sizeof( uint32_t ) );
+  indirectDrawCountBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectDrawCountBufferDesc ) );
+
+  frameParamsBuffer = device.CreateBuffer( ResourceType::ConstantBuffer, HeapType::Default, true, sizeof( FrameParams ), sizeof( FrameParams ), L"frameParamsBuffer" );
+  auto frameParamsBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, FrameParamsBufferUAVSlot, *frameParamsBuffer, sizeof( FrameParams ) );
+  auto frameParamsBufferCBVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ConstantBufferView, FrameParamsBufferCBVSlot, *frameParamsBuffer, sizeof( FrameParams ) );
+  frameParamsBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( frameParamsBufferUAVDesc ) );
+  frameParamsBuffer->AttachResourceDescriptor( ResourceDescriptorType::ConstantBufferView, eastl::move( frameParamsBufferCBVDesc ) );
+
+  skyTexture = device.CreateCubeTexture( nullptr, 512, nullptr, 0, RenderManager::HDRFormat, true, SkyTextureSlot, eastl::nullopt, false, L"skyTexture" );
+
+  exposureBuffer = device.CreateBuffer( ResourceType::ConstantBuffer, HeapType::Default, true, sizeof( ExposureBuffer ), sizeof( ExposureBuffer ), L"Exposure" );
+  auto exposureBufferCBVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ConstantBufferView,  ExposureBufferCBVSlot, *exposureBuffer, sizeof( ExposureBuffer ) );
+  auto exposureBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, ExposureBufferUAVSlot, *exposureBuffer, sizeof( ExposureBuffer ) );
+  exposureBuffer->AttachResourceDescriptor( ResourceDescriptorType::ConstantBufferView,  eastl::move( exposureBufferCBVDesc ) );
+  exposureBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( exposureBufferUAVDesc ) );
+
+  exposureOnlyBuffer = device.Create2DTexture( &commandList, 1, 1, nullptr, 0, PixelFormat::R32F, false, ExposureOnlySlot, ExposureOnlyUAVSlot, false, L"ExposureOnly");
+
+  histogramBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, 256 * sizeof( uint32_t ), sizeof( uint32_t ), L"Histogram" );
+  auto histogramBufferDesc    = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView,  HistogramBufferSlot,    *histogramBuffer, sizeof( uint32_t ) );
+  auto histogramBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, HistogramBufferUAVSlot, *histogramBuffer, sizeof( uint32_t ) );
+  histogramBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView,  eastl::move( histogramBufferDesc    ) );
+  histogramBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( histogramBufferUAVDesc ) );
+
+  InitializeManualExposure( commandList, *exposureBuffer, *exposureOnlyBuffer, 1 );
+
+  auto cullingFile            = ShaderPackage::GetInstance().GetShader( L"Culling" );
+  auto cullingLateFile        = ShaderPackage::GetInstance().GetShader( L"CullingLate" );
+  auto hiZBuildFile           = ShaderPackage::GetInstance().GetShader( L"HiZBuild" );
+  auto prepareCullingFile     = ShaderPackage::GetInstance().GetShader( L"PrepareCulling" );
+  auto specBRDFLUTFile        = ShaderPackage::GetInstance().GetShader( L"SpecBRDFLUT" );
+  auto blurFile               = ShaderPackage::GetInstance().GetShader( L"Blur" );
+  auto downsampleFile         = ShaderPackage::GetInstance().GetShader( L"Downsample" );
+  auto downsample4File        = ShaderPackage::GetInstance().GetShader( L"Downsample4" );
+  auto downsampleMSAA4File    = ShaderPackage::GetInstance().GetShader( L"DownsampleMSAA4" );
+  auto downsample4WLumaFile   = ShaderPackage::GetInstance().GetShader( L"Downsample4WithLuminanceFilter" );
+  auto processReflectionFile  = ShaderPackage::GetInstance().GetShader( L"ProcessReflection" );
+  auto extractBloomFile       = ShaderPackage::GetInstance().GetShader( L"ExtractBloom" );
+  auto blurBloomFile          = ShaderPackage::GetInstance().GetShader( L"BlurBloom" );
+  auto downsampleBloomFile    = ShaderPackage::GetInstance().GetShader( L"DownsampleBloom" );
+  auto upsampleBlurBloomFile  = ShaderPackage::GetInstance().GetShader( L"UpsampleAndBlurBloom" );
+  auto generateHistogramFile  = ShaderPackage::GetInstance().GetShader( L"GenerateHistogram" );
+  auto adaptExposureFile      = ShaderPackage::GetInstance().GetShader( L"AdaptExposure" );
+  auto traceShadowFile        = ShaderPackage::GetInstance().GetShader( L"TraceShadow" );
+  auto traceShadow_sigFile    = ShaderPackage::GetInstance().GetShader( L"TraceShadow_sig" );
+  auto traceGIFile            = ShaderPackage::GetInstance().GetShader( L"TraceGI" );
+  auto traceGI_sigFile        = ShaderPackage::GetInstance().GetShader( L"TraceGI_sig" );
+  auto traceAOFile            = ShaderPackage::GetInstance().GetShader( L"TraceAmbientOcclusion" );
+  auto traceAO_sigFile        = ShaderPackage::GetInstance().GetShader( L"TraceAmbientOcclusion_sig" );
+  auto traceReflecionFile     = ShaderPackage::GetInstance().GetShader( L"TraceReflection" );
+  auto traceReflecion_sigFile = ShaderPackage::GetInstance().GetShader( L"TraceReflection_sig" );
+
+  cullingShader            = device.CreateComputeShader( cullingFile.data, cullingFile.size, L"Culling" );
+  cullingLateShader        = device.CreateComputeShader( cullingLateFile.data, cullingLateFile.size, L"CullingLate" );
+  hiZBuildShader           = device.CreateComputeShader( hiZBuildFile.data, hiZBuildFile.size, L"HiZBuild" );
+  prepareCullingShader     = device.CreateComputeShader( prepareCullingFile.data, prepareCullingFile.size, L"PrepareCulling" );
+  specBRDFLUTShader        = device.CreateComputeShader( specBRDFLUTFile.data, specBRDFLUTFile.size, L"SpecBRDFLUT" );
+  blurShader               = device.CreateComputeShader( blurFile.data, blurFile.size, L"Blur" );
+  downsampleShader         = device.CreateComputeShader( downsampleFile.data, downsampleFile.size, L"Downsample" );
+  downsample4Shader        = device.CreateComputeShader( downsample4File.data, downsample4File.size, L"Downsample4" );
+  downsampleMSAA4Shader    = device.CreateComputeShader( downsampleMSAA4File.data, downsampleMSAA4File.size, L"DownsampleMSAA4" );
+  downsample4WLumaShader   = device.CreateComputeShader( downsample4WLumaFile.data, downsample4WLumaFile.size, L"Downsample4WLuma" );
+  downsampleBloomShader    = device.CreateComputeShader( downsampleBloomFile.data, downsampleBloomFile.size, L"DownsampleBloom" );
+  upsampleBlurBloomShader  = device.CreateComputeShader( upsampleBlurBloomFile.data, upsampleBlurBloomFile.size, L"UpsampleBlurBloom" );
+  extractBloomShader       = device.CreateComputeShader( extractBloomFile.data, extractBloomFile.size, L"ExtractBloom" );
+  blurBloomShader          = device.CreateComputeShader( blurBloomFile.data, blurBloomFile.size, L"BlurBloom" );
+  generateHistogramShader  = device.CreateComputeShader( generateHistogramFile.data, generateHistogramFile.size, L"GenerateHistogram" );
+  adaptExposureShader      = device.CreateComputeShader( adaptExposureFile.data, adaptExposureFile.size, L"AdaptExposure" );
+
+  traceAOShader = device.CreateRTShaders( commandList
+                                        , traceAO_sigFile
+                                        , traceAOFile
+                                        , L"raygen"
+                                        , L"miss"
+                                        , L"anyHit"
+                                        , L"closestHit"
+                                        , sizeof( XMFLOAT2 ) // BuiltInTriangleIntersectionAttributes
+                                        , sizeof( AOPayload )
+                                        , 1 );
+
+  traceShadowShader = device.CreateRTShaders( commandList
+                                            , traceShadow_sigFile
+                                            , traceShadowFile
+                                            , L"raygen"
+                                            , L"miss"
+                                            , L"anyHit"
+                                            , L"closestHit"
+                                            , sizeof( XMFLOAT2 ) // BuiltInTriangleIntersectionAttributes
+                                            , sizeof( ShadowPayload )
+                                            , 1 );
+
+  traceGIShader = device.CreateRTShaders( commandList
+                                        , traceGI_sigFile
+                                        , traceGIFile
+                                        , L"raygen"
+                                        , L"miss"
+                                        , L"anyHit"
+                                        , L"closestHit"
+                                        , sizeof( XMFLOAT2 ) // BuiltInTriangleIntersectionAttributes
+                                        , sizeof( GIPayload )
+                                        , GI_MAX_ITERATIONS );
+
+  traceReflectionShader = device.CreateRTShaders( commandList
+                                                , traceReflecion_sigFile
+                                                , traceReflecionFile
+                                                , L"raygen"
+                                                , L"miss"
+                                                , L"anyHit"
+                                                , L"closestHit"
+                                                , sizeof( XMFLOAT2 ) // BuiltInTriangleIntersectionAttributes
+                                                , sizeof( ReflectionPayload )
+                                                , 1 );
+
+  CreateBRDFLUTTexture( commandList );
+
+  CreateSamplingTextures( commandList );
+
+  RecreateScrenSizeDependantTextures( commandList, screenWidth, screenHeight );
+}
+
+void Scene::UpdateLoading( CommandList& commandList )
+{
+  StepLoading( commandList, SceneLoader::UploadBytesPerFrame, true );
+}
+
+void Scene::FinishLoading( CommandList& commandList )
+{
+  StepLoading( commandList, SIZE_MAX, false );
+
+  while ( loader && !( worldStreamer && worldStreamer->IsSettled() ) )
   {
-    error  = L"Failed to import file: ";
-    error += sceneFilePath;
-    error += L" - ";
-    error += W( importer.GetErrorString() );
-    error += L"\n";
-    return;
+    loader->WaitForConvertedMeshes();
+    StepLoading( commandList, SIZE_MAX, false );
   }
 
-  if ( !scene->HasMeshes() )
+  if ( meshesSinceRebuild > 0 )
+    RebuildResidentScene( commandList );
+}
+
+bool Scene::IsRenderable() const
+{
+  return instanceCount > 0;
+}
+
+void Scene::StepLoading( CommandList& commandList, size_t uploadBudget, bool rebuildPeriodically )
+{
+  if ( !loader )
+    return;
+
+  auto state = loader->GetState();
+  if ( state == SceneLoader::State::Failed )
   {
-    error  = L"file has no meshes: ";
-    error += sceneFilePath;
+    error = loader->GetError();
+    loader.reset();
+    return;
+  }
+
+  if ( state == SceneLoader::State::Importing )
     return;
-  }    
 
-  for ( unsigned meshIx = 0; meshIx < scene->mNumMeshes; meshIx++ )
+  auto& importedScene = loader->GetScene();
+
+  if ( !rootNode )
+    PublishSceneLayout( commandList, importedScene );
+
+  auto cameraPosition = streamingCameraNode ? GetNodeWorldTransform( *streamingCameraNode ).r[ 3 ] : XMVectorZero();
+
+  eastl::vector< int > meshesToLoad;
+  worldStreamer->Update( cameraPosition, GetCPUTime(), meshesToLoad, evictedMeshes );
+  loader->RequestMeshes( meshesToLoad );
+
+  PublishMeshes( commandList, importedScene, uploadBudget );
+
+  framesSinceRebuild++;
+
+  // The evicted meshes are released right away. Otherwise the first meshes are shown as soon as they arrive, and
+  // the rest when the cells are settled, or periodically while they are not.
+  bool rebuild = !evictedMeshes.empty();
+  if ( rebuildPeriodically && meshesSinceRebuild > 0 )
+    rebuild |= instanceCount == 0 || worldStreamer->IsSettled() || framesSinceRebuild >= framesBetweenRebuilds;
+
+  if ( rebuild )
+    RebuildResidentScene( commandList );
+}
+
+void Scene::RebuildResidentScene( CommandList& commandList )
+{
+  CPUSection cpuSection( L"Rebuild resident scene" );
+
+  auto& renderManager = RenderManager::GetInstance();
+  auto& device        = renderManager.GetDevice();
+
+  // The frames in flight can still use the evicted meshes. The command list releases them when the GPU is done,
+  // and only then their descriptor slots are free for the next meshes.
+  for ( int meshIx : evictedMeshes )
   {
-    aiMesh* mesh = scene->mMeshes[ meshIx ];
-    if ( !Validate( mesh, meshIx, error ) )
-      return;
+    meshes[ meshIx ]->Dispose( commandList );
+    meshes[ meshIx ].reset();
   }
+  evictedMeshes.clear();
+
+  sceneStore->Build( *rootNode, meshes );
+  instanceBVH->Build( *sceneStore );
+  occlusionCuller->SetUpInstances( *sceneStore );
+
+  // The TLAS is rebuilt with every transform below, there is nothing to patch.
+  UpdateFullTransforms();
+  movedNodes.clear();
+  unfittedNodes.clear();
 
-  eastl::vector< MaterialSlot > materialSlots;
-  for ( unsigned materialIx = 0; materialIx < scene->mNumMaterials; materialIx++ )
+  meshesSinceRebuild = 0;
+  framesSinceRebuild = 0;
+
+  // Everything was evicted, nothing to render until the next cells arrive.
+  if ( sceneStore->GetInstanceCount() == 0 )
   {
-    aiMaterial* material = scene->mMaterials[ materialIx ];
+    instanceCount = 0;
+    return;
+  }
+
+  BuildSceneBuffers( commandList );
+
+  eastl::vector< RTInstance > rtInstances;
+  MarshallSceneToRTInstances( rtInstances );
+
+  if ( tlas )
+    tlas->Update( device, commandList, eastl::move( rtInstances ) );
+  else
+    tlas = device.CreateRTTopLevelAccelerator( commandList, rtInstances, RTSceneSlot );
+}
+
+// The materials stay for the lifetime of the scene, so their textures are loaded here up front, and are not
+// streamed with the meshes that use them.
+void Scene::PublishSceneLayout( CommandList& commandList, const aiScene& importedScene )
+{
+  CPUSection cpuSection( L"Publish scene layout" );
+
+  auto& device = RenderManager::GetInstance().GetDevice();
+
+  for ( unsigned materialIx = 0; materialIx < importedScene.mNumMaterials; materialIx++ )
+  {
+    aiMaterial* material = importedScene.mMaterials[ materialIx ];
     materialSlots.emplace_back();
     auto& materialSlot = materialSlots.back();
 
@@ -410,6 +511,7 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
     bool isAlphaTested = false;
     bool isTranslucent = false;
     bool isFlipWinding = false;
+    bool isOccluder    = false;
 
     float roughness = 1;
     float metallic  = 0;
@@ -423,6 +525,9 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
     material->Get( "$raw.AlphaTested", 0, 0, isAlphaTested );
     material->Get( "$raw.Translucent", 0, 0, isTranslucent );
     material->Get( "$raw.FlipWinding", 0, 0, isFlipWinding );
+    material->Get( "$raw.Occluder", 0, 0, isOccluder );
+
+    occluderMaterials.push_back( isOccluder );
 
     materialSlot.albedo.w = PackedVector::XMConvertFloatToHalf( alpha );
 
@@ -444,10 +549,10 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
     materialSlot.roughnessTextureIndex = -1;
     materialSlot.metallicTextureIndex = -1;
 
-    LoadTexture( commandList, hostFolder, material, aiTextureType_DIFFUSE,   materialSlot.albedoTextureIndex, &materialSlot.albedoTextureRefIndex );
-    LoadTexture( commandList, hostFolder, material, aiTextureType_SHININESS, materialSlot.roughnessTextureIndex );
-    LoadTexture( commandList, hostFolder, material, aiTextureType_NORMALS,   materialSlot.normalTextureIndex );
-    LoadTexture( commandList, hostFolder, material, aiTextureType_METALNESS, materialSlot.metallicTextureIndex );
+    LoadTexture( commandList, hostFolder.data(), material, aiTextureType_DIFFUSE,   materialSlot.albedoTextureIndex, &materialSlot.albedoTextureRefIndex );
+    LoadTexture( commandList, hostFolder.data(), material, aiTextureType_SHININESS, materialSlot.roughnessTextureIndex );
+    LoadTexture( commandList, hostFolder.data(), material, aiTextureType_NORMALS,   materialSlot.normalTextureIndex );
+    LoadTexture( commandList, hostFolder.data(), material, aiTextureType_METALNESS, materialSlot.metallicTextureIndex );
   }
 
   materialBuffer = CreateBufferFromData( materialSlots.data(), int( materialSlots.size() ), ResourceType::Buffer, device, commandList, L"materialBuffer" );
@@ -455,90 +560,24 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
   materialBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( materialBufferDesc ) );
   commandList.ChangeResourceState( { { *materialBuffer, ResourceStateBits::NonPixelShaderInput | ResourceStateBits::PixelShaderInput } } );
 
-  modelMetaBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( ModelMetaSlot ) * scene->mNumMeshes, sizeof( ModelMetaSlot ), L"modelMetaBuffer" );
+  occlusionCuller = eastl::make_unique< OcclusionCuller >();
+
+  modelMetaBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( ModelMetaSlot ) * importedScene.mNumMeshes, sizeof( ModelMetaSlot ), L"modelMetaBuffer" );
   auto modelMetaBufferDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, ModelMetaBufferSlot, *modelMetaBuffer, sizeof( ModelMetaSlot ) );
   modelMetaBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( modelMetaBufferDesc ) );
 
-  for ( unsigned meshIx = 0; meshIx < scene->mNumMeshes; meshIx++ )
-  {
-    aiMesh* mesh = scene->mMeshes[ meshIx ];
-
-    eastl::vector< VertexFormat > vertices;
-    eastl::vector< uint32_t >     indices;
-
-    auto vMin = XMLoadFloat3( (XMFLOAT3*)&mesh->mVertices[ 0 ].x );
-    auto vMax = XMLoadFloat3( (XMFLOAT3*)&mesh->mVertices[ 0 ].x );
-
-    for ( unsigned vtxIx = 0; vtxIx < mesh->mNumVertices; vtxIx++ )
-    {
-      vertices.emplace_back();
-      auto& vtx = vertices.back();
-
-      aiVector3D v  = mesh->mVertices[ vtxIx ];
-      aiVector3D t  = mesh->mTangents ? mesh->mTangents[ vtxIx ] : aiVector3D();
-      aiVector3D b  = mesh->mBitangents ? mesh->mBitangents[ vtxIx ] : aiVector3D();
-      aiVector3D n  = mesh->mNormals[ vtxIx ];
-      aiVector3D tc = mesh->HasTextureCoords( 0 ) ? mesh->mTextureCoords[ 0 ][ vtxIx ] : aiVector3D(0);
-
-      t.Normalize();
-      b.Normalize();
-      n.Normalize();
-      
-      Compress( vtx.position, v );
-      Compress( vtx.tangent, t );
-      Compress( vtx.bitangent, b );
-      Compress( vtx.normal, n );
-      Compress( vtx.texcoord, tc );
-
-      auto vPoint = XMLoadFloat3( (XMFLOAT3*)&v.x );
-      vMin = XMVectorMin( vMin, vPoint );
-      vMax = XMVectorMax( vMax, vPoint );
-    }
-
-    BoundingBox aabb;
-    BoundingBox::CreateFromPoints( aabb, vMin, vMax );
-
-    for ( unsigned faceIx = 0; faceIx < mesh->mNumFaces; faceIx++ )
-    {
-      auto& face = mesh->mFaces[ faceIx ];
-
-      assert( face.mNumIndices == 3 );
-
-      indices.emplace_back( uint32_t( face.mIndices[ 0 ] ) );
-      indices.emplace_back( uint32_t( face.mIndices[ 1 ] ) );
-      indices.emplace_back( uint32_t( face.mIndices[ 2 ] ) );
-    }
-
-    auto debugVBName = W( mesh->mName.C_Str() ) + L"_VB";
-    auto debugIBName = W( mesh->mName.C_Str() ) + L"_IB";
-    auto vbGPU = CreateBufferFromData( vertices.data(), int( vertices.size() ), ResourceType::Buffer, device, commandList, debugVBName.data() );
-    auto ibGPU = CreateBufferFromData( indices .data(), int( indices .size() ), ResourceType::Buffer, device, commandList, debugIBName.data() );
-
-    commandList.ChangeResourceState( { { *vbGPU, ResourceStateBits::NonPixelShaderInput }
-                                     , { *ibGPU, ResourceStateBits::NonPixelShaderInput } } );
-
-    bool isOpaque = !( materialSlots[ mesh->mMaterialIndex ].flags & MaterialSlot::AlphaTested )
-                 && !( materialSlots[ mesh->mMaterialIndex ].flags & MaterialSlot::Translucent );
-    meshes.emplace_back( eastl::make_unique< Mesh >( commandList
-                                                 , eastl::move( vbGPU )
-                                                 , eastl::move( ibGPU )
-                                                 , int( vertices.size() )
-                                                 , int( indices.size() )
-                                                 , mesh->mMaterialIndex
-                                                 , isOpaque
-                                                 , *modelMetaBuffer
-                                                 , meshIx
-                                                 , aabb
-                                                 , mesh->mName.C_Str() ) );
-  }
+  // The meshes are filled in as they become resident, the scene store leaves out the empty ones.
+  meshes.resize( importedScene.mNumMeshes );
 
   rootNode = eastl::make_unique< Node >();
 
-  WalkDCCNodes( *scene->mRootNode, *rootNode );
+  nodeNameIndex = eastl::make_unique< NodeNameIndex >();
+
+  WalkDCCNodes( *importedScene.mRootNode, *rootNode, *nodeNameIndex );
 
-  for ( unsigned lightIx = 0; lightIx < scene->mNumLights; lightIx++ )
+  for ( unsigned lightIx = 0; lightIx < importedScene.mNumLights; lightIx++ )
   {
-    aiLight* light = scene->mLights[ lightIx ];
+    aiLight* light = importedScene.mLights[ lightIx ];
 
     if ( light->mType != aiLightSource_DIRECTIONAL )
       continue;
@@ -579,14 +618,17 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
   lightBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( lightBufferDesc ) );
   commandList.ChangeResourceState( { { *lightBuffer, ResourceStateBits::NonPixelShaderInput } } );
 
-  if ( scene->HasCameras() )
+  if ( importedScene.HasCameras() )
   {
-    for ( unsigned cameraIx = 0; cameraIx < scene->mNumCameras; cameraIx++ )
+    for ( unsigned cameraIx = 0; cameraIx < importedScene.mNumCameras; cameraIx++ )
     {
-      auto& dccCamera = scene->mCameras[ cameraIx ];
+      auto& dccCamera = importedScene.mCameras[ cameraIx ];
+
+      auto dccCameraNode = FindNodeByName( dccCamera->mName.C_Str() );
+      assert( dccCameraNode );
 
-      auto cameraNode = FindNodeByName( dccCamera->mName.C_Str() );
-      assert( cameraNode );
+      if ( !streamingCameraNode )
+        streamingCameraNode = dccCameraNode;
 
       auto cameraForward      = XMLoadFloat3( (XMFLOAT3*)&dccCamera->mLookAt );
       auto cameraUp           = XMLoadFloat3( (XMFLOAT3*)&dccCamera->mUp );
@@ -600,26 +642,12 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
       eastl::unique_ptr< Camera > camera = eastl::make_unique< Camera >();
       camera->SetProjection( cameraFOVY, float( screenWidth ) / screenHeight, cameraNearDistance, cameraFarDistance);
 
-      cameraNode->SetTransform( cameraTransform * cameraNode->GetTransform() );
-      cameraNode->AddChildCamera( eastl::move( camera ) );
+      dccCameraNode->SetTransform( cameraTransform * dccCameraNode->GetTransform() );
+      dccCameraNode->AddChildCamera( eastl::move( camera ) );
     }
   }
 
-  BuildSceneBuffers( commandList );
-
-  eastl::vector< RTInstance > rtInstances;
-  MarshallSceneToRTInstances( *rootNode, rtInstances, *this );
-  tlas = device.CreateRTTopLevelAccelerator( commandList, rtInstances, RTSceneSlot );
-
-  indirectDrawCountBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( uint32_t ) * 9, sizeof( uint32_t ), L"indirectDrawCountBuffer" );
-  auto indirectDrawCountBufferDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, IndirectDrawCountBufferSlot, *indirectDrawCountBuffer, sizeof( uint32_t ) );
-  indirectDrawCountBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectDrawCountBufferDesc ) );
-
-  frameParamsBuffer = device.CreateBuffer( ResourceType::ConstantBuffer, HeapType::Default, true, sizeof( FrameParams ), sizeof( FrameParams ), L"frameParamsBuffer" );
-  auto frameParamsBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, FrameParamsBufferUAVSlot, *frameParamsBuffer, sizeof( FrameParams ) );
-  auto frameParamsBufferCBVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ConstantBufferView, FrameParamsBufferCBVSlot, *frameParamsBuffer, sizeof( FrameParams ) );
-  frameParamsBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( frameParamsBufferUAVDesc ) );
-  frameParamsBuffer->AttachResourceDescriptor( ResourceDescriptorType::ConstantBufferView, eastl::move( frameParamsBufferCBVDesc ) );
+  cameraNode = FindNodeByName( "Camera" );
 
   lightParamsBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( LightParams ), int( sizeof( LightParams ) * lightSlots.size() ), L"lightParamsBuffer" );
   auto lightParamsBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, ProcessedLightBufferUAVSlot, *lightParamsBuffer, sizeof( LightParams ) );
@@ -633,126 +661,100 @@ Scene::Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWid
   skyBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( skyBufferUAVDesc ) );
   skyBuffer->AttachResourceDescriptor( ResourceDescriptorType::ConstantBufferView, eastl::move( skyBufferCBVDesc ) );
 
-  skyTexture = device.CreateCubeTexture( nullptr, 512, nullptr, 0, RenderManager::HDRFormat, true, SkyTextureSlot, eastl::nullopt, false, L"skyTexture" );
 
-  exposureBuffer = device.CreateBuffer( ResourceType::ConstantBuffer, HeapType::Default, true, sizeof( ExposureBuffer ), sizeof( ExposureBuffer ), L"Exposure" );
-  auto exposureBufferCBVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ConstantBufferView,  ExposureBufferCBVSlot, *exposureBuffer, sizeof( ExposureBuffer ) );
-  auto exposureBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, ExposureBufferUAVSlot, *exposureBuffer, sizeof( ExposureBuffer ) );
-  exposureBuffer->AttachResourceDescriptor( ResourceDescriptorType::ConstantBufferView,  eastl::move( exposureBufferCBVDesc ) );
-  exposureBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( exposureBufferUAVDesc ) );
+  sceneStore  = eastl::make_unique< SceneStore >();
+  instanceBVH = eastl::make_unique< InstanceBVH >();
 
-  exposureOnlyBuffer = device.Create2DTexture( &commandList, 1, 1, nullptr, 0, PixelFormat::R32F, false, ExposureOnlySlot, ExposureOnlyUAVSlot, false, L"ExposureOnly");
+  SetUpOccluders( importedScene );
 
-  histogramBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, 256 * sizeof( uint32_t ), sizeof( uint32_t ), L"Histogram" );
-  auto histogramBufferDesc    = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView,  HistogramBufferSlot,    *histogramBuffer, sizeof( uint32_t ) );
-  auto histogramBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, HistogramBufferUAVSlot, *histogramBuffer, sizeof( uint32_t ) );
-  histogramBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView,  eastl::move( histogramBufferDesc    ) );
-  histogramBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( histogramBufferUAVDesc ) );
+  // There is no cooked format to store the cells in, they are built from the imported scene on the fly.
+  eastl::vector< WorldPartition::MeshInstance > meshInstances;
+  loader->CollectMeshInstances( meshInstances );
 
-  InitializeManualExposure( commandList, *exposureBuffer, *exposureOnlyBuffer, 1 );
+  worldPartition = eastl::make_unique< WorldPartition >();
+  worldPartition->Build( meshInstances, WorldPartition::DefaultCellsPerAxis );
 
-  auto cullingFile            = ReadFileToMemory( L"Content/Shaders/Culling.cso" );
-  auto prepareCullingFile     = ReadFileToMemory( L"Content/Shaders/PrepareCulling.cso" );
-  auto specBRDFLUTFile        = ReadFileToMemory( L"Content/Shaders/SpecBRDFLUT.cso" );
-  auto blurFile               = ReadFileToMemory( L"Content/Shaders/Blur.cso" );
-  auto downsampleFile         = ReadFileToMemory( L"Content/Shaders/Downsample.cso" );
-  auto downsample4File        = ReadFileToMemory( L"Content/Shaders/Downsample4.cso" );
-  auto downsampleMSAA4File    = ReadFileToMemory( L"Content/Shaders/DownsampleMSAA4.cso" );
-  auto downsample4WLumaFile   = ReadFileToMemory( L"Content/Shaders/Downsample4WithLuminanceFilter.cso" );
-  auto processReflectionFile  = ReadFileToMemory( L"Content/Shaders/ProcessReflection.cso" );
-  auto extractBloomFile       = ReadFileToMemory( L"Content/Shaders/ExtractBloom.cso" );
-  auto blurBloomFile          = ReadFileToMemory( L"Content/Shaders/BlurBloom.cso" );
-  auto downsampleBloomFile    = ReadFileToMemory( L"Content/Shaders/DownsampleBloom.cso" );
-  auto upsampleBlurBloomFile  = ReadFileToMemory( L"Content/Shaders/UpsampleAndBlurBloom.cso" );
-  auto generateHistogramFile  = ReadFileToMemory( L"Content/Shaders/GenerateHistogram.cso" );
-  auto adaptExposureFile      = ReadFileToMemory( L"Content/Shaders/AdaptExposure.cso" );
-  auto traceShadowFile        = ReadFileToMemory( L"Content/Shaders/TraceShadow.cso" );
-  auto traceShadow_sigFile    = ReadFileToMemory( L"Content/Shaders/TraceShadow_sig.cso" );
-  auto traceGIFile            = ReadFileToMemory( L"Content/Shaders/TraceGI.cso" );
-  auto traceGI_sigFile        = ReadFileToMemory( L"Content/Shaders/TraceGI_sig.cso" );
-  auto traceAOFile            = ReadFileToMemory( L"Content/Shaders/TraceAmbientOcclusion.cso" );
-  auto traceAO_sigFile        = ReadFileToMemory( L"Content/Shaders/TraceAmbientOcclusion_sig.cso" );
-  auto traceReflecionFile     = ReadFileToMemory( L"Content/Shaders/TraceReflection.cso" );
-  auto traceReflecion_sigFile = ReadFileToMemory( L"Content/Shaders/TraceReflection_sig.cso" );
-
-  cullingShader            = device.CreateComputeShader( cullingFile.data(), int( cullingFile.size() ), L"Culling" );
-  prepareCullingShader     = device.CreateComputeShader( prepareCullingFile.data(), int( prepareCullingFile.size() ), L"PrepareCulling" );
-  specBRDFLUTShader        = device.CreateComputeShader( specBRDFLUTFile.data(), int( specBRDFLUTFile.size() ), L"SpecBRDFLUT" );
-  blurShader               = device.CreateComputeShader( blurFile.data(), int( blurFile.size() ), L"Blur" );
-  downsampleShader         = device.CreateComputeShader( downsampleFile.data(), int( downsampleFile.size() ), L"Downsample" );
-  downsample4Shader        = device.CreateComputeShader( downsample4File.data(), int( downsample4File.size() ), L"Downsample4" );
-  downsampleMSAA4Shader    = device.CreateComputeShader( downsampleMSAA4File.data(), int( downsampleMSAA4File.size() ), L"DownsampleMSAA4" );
-  downsample4WLumaShader   = device.CreateComputeShader( downsample4WLumaFile.data(), int( downsample4WLumaFile.size() ), L"Downsample4WLuma" );
-  downsampleBloomShader    = device.CreateComputeShader( downsampleBloomFile.data(), int( downsampleBloomFile.size() ), L"DownsampleBloom" );
-  upsampleBlurBloomShader  = device.CreateComputeShader( upsampleBlurBloomFile.data(), int( upsampleBlurBloomFile.size() ), L"UpsampleBlurBloom" );
-  extractBloomShader       = device.CreateComputeShader( extractBloomFile.data(), int( extractBloomFile.size() ), L"ExtractBloom" );
-  blurBloomShader          = device.CreateComputeShader( blurBloomFile.data(), int( blurBloomFile.size() ), L"BlurBloom" );
-  generateHistogramShader  = device.CreateComputeShader( generateHistogramFile.data(), int( generateHistogramFile.size() ), L"GenerateHistogram" );
-  adaptExposureShader      = device.CreateComputeShader( adaptExposureFile.data(), int( adaptExposureFile.size() ), L"AdaptExposure" );
+  eastl::vector< size_t > meshByteSizes( importedScene.mNumMeshes );
+  for ( unsigned meshIx = 0; meshIx < importedScene.mNumMeshes; meshIx++ )
+    meshByteSizes[ meshIx ] = loader->GetMeshByteSize( int( meshIx ) );
 
-  traceAOShader = device.CreateRTShaders( commandList
-                                        , traceAO_sigFile
-                                        , traceAOFile
-                                        , L"raygen"
-                                        , L"miss"
-                                        , L"anyHit"
-                                        , L"closestHit"
-                                        , sizeof( XMFLOAT2 ) // BuiltInTriangleIntersectionAttributes
-                                        , sizeof( AOPayload )
-                                        , 1 );
+  worldStreamer = eastl::make_unique< WorldStreamer >( *worldPartition, eastl::move( meshByteSizes ), WorldStreamer::Settings() );
+}
 
-  traceShadowShader = device.CreateRTShaders( commandList
-                                            , traceShadow_sigFile
-                                            , traceShadowFile
-                                            , L"raygen"
-                                            , L"miss"
-                                            , L"anyHit"
-                                            , L"closestHit"
-                                            , sizeof( XMFLOAT2 ) // BuiltInTriangleIntersectionAttributes
-                                            , sizeof( ShadowPayload )
-                                            , 1 );
+void Scene::PublishMeshes( CommandList& commandList, const aiScene& importedScene, size_t uploadBudget )
+{
+  eastl::vector< SceneLoader::ConvertedMesh > batch;
+  loader->TakeConvertedMeshes( uploadBudget, batch );
+  if ( batch.empty() )
+    return;
 
-  traceGIShader = device.CreateRTShaders( commandList
-                                        , traceGI_sigFile
-                                        , traceGIFile
-                                        , L"raygen"
-                                        , L"miss"
-                                        , L"anyHit"
-                                        , L"closestHit"
-                                        , sizeof( XMFLOAT2 ) // BuiltInTriangleIntersectionAttributes
-                                        , sizeof( GIPayload )
-                                        , GI_MAX_ITERATIONS );
+  CPUSection cpuSection( L"Publish meshes" );
 
-  traceReflectionShader = device.CreateRTShaders( commandList
-                                                , traceReflecion_sigFile
-                                                , traceReflecionFile
-                                                , L"raygen"
-                                                , L"miss"
-                                                , L"anyHit"
-                                                , L"closestHit"
-                                                , sizeof( XMFLOAT2 ) // BuiltInTriangleIntersectionAttributes
-                                                , sizeof( ReflectionPayload )
-                                                , 1 );
+  auto& device = RenderManager::GetInstance().GetDevice();
+  auto  now    = GetCPUTime();
 
-  CreateBRDFLUTTexture( commandList );
+  for ( auto& convertedMesh : batch )
+  {
+    int     meshIx = convertedMesh.meshIndex;
+    aiMesh* mesh   = importedScene.mMeshes[ meshIx ];
 
-  auto scramblingRankingTextureData = ReadFileToMemory( L"Content/EngineTextures/scrambling_ranking_128x128_2d_1spp.dds" );
-  auto sobolTextureData             = ReadFileToMemory( L"Content/EngineTextures/sobol_256_4d.dds" );
+    // Evicted while it was converted, or requested twice.
+    if ( !worldStreamer->OnMeshResident( meshIx, now ) )
+      continue;
 
-  int width, height;
-  PixelFormat pf;
+    auto debugVBName = W( mesh->mName.C_Str() ) + L"_VB";
+    auto debugIBName = W( mesh->mName.C_Str() ) + L"_IB";
+    auto vbGPU = CreateBufferFromData( convertedMesh.vertices.data(), int( convertedMesh.vertices.size() ), ResourceType::Buffer, device, commandList, debugVBName.data() );
+    auto ibGPU = CreateBufferFromData( convertedMesh.indices .data(), int( convertedMesh.indices .size() ), ResourceType::Buffer, device, commandList, debugIBName.data() );
 
-  auto texels = ParseSimpleDDS( scramblingRankingTextureData, width, height, pf );
-  assert( pf == PixelFormat::RGBA8888UN );
-  pf = PixelFormat::RGBA8888U;
-  scramblingRankingTexture = device.Create2DTexture( &commandList, width, height, texels.first, texels.second, pf, false, ScramblingRankingSlot, eastl::nullopt, false, L"Scrambling ranking" );
+    commandList.ChangeResourceState( { { *vbGPU, ResourceStateBits::NonPixelShaderInput }
+                                     , { *ibGPU, ResourceStateBits::NonPixelShaderInput } } );
+
+    bool isOpaque = !( materialSlots[ mesh->mMaterialIndex ].flags & MaterialSlot::AlphaTested )
+                 && !( materialSlots[ mesh->mMaterialIndex ].flags & MaterialSlot::Translucent );
+    meshes[ meshIx ] = eastl::make_unique< Mesh >( commandList
+                                                 , eastl::move( vbGPU )
+                                                 , eastl::move( ibGPU )
+                                                 , int( convertedMesh.vertices.size() )
+                                                 , int( convertedMesh.indices.size() )
+                                                 , mesh->mMaterialIndex
+                                                 , isOpaque
+                                                 , *modelMetaBuffer
+                                                 , meshIx
+                                                 , convertedMesh.aabb
+                                                 , mesh->mName.C_Str() );
+
+    meshesSinceRebuild++;
+  }
+}
+
+void Scene::SetUpOccluders( const aiScene& importedScene )
+{
+  for ( unsigned meshIx = 0; meshIx < importedScene.mNumMeshes; meshIx++ )
+    if ( occluderMaterials[ importedScene.mMeshes[ meshIx ]->mMaterialIndex ] )
+      AddOccluderMesh( *occlusionCuller, *importedScene.mMeshes[ meshIx ], meshIx );
+
+  // Without occluders marked in the content, the biggest simple opaque meshes are used.
+  if ( !occlusionCuller->HasOccluders() )
+  {
+    eastl::vector< eastl::pair< float, unsigned > > candidates;
+    for ( unsigned meshIx = 0; meshIx < importedScene.mNumMeshes; meshIx++ )
+    {
+      auto materialFlags = materialSlots[ importedScene.mMeshes[ meshIx ]->mMaterialIndex ].flags;
+      bool isOpaque      = !( materialFlags & MaterialSlot::AlphaTested ) && !( materialFlags & MaterialSlot::Translucent );
+      if ( isOpaque && importedScene.mMeshes[ meshIx ]->mNumFaces <= maxAutoOccluderTriangles )
+      {
+        // Set up before the meshes are resident, the bounds of the import are used.
+        auto extents = ( importedScene.mMeshes[ meshIx ]->mAABB.mMax - importedScene.mMeshes[ meshIx ]->mAABB.mMin ) * 0.5f;
+        candidates.emplace_back( extents.x * extents.y + extents.y * extents.z + extents.z * extents.x, meshIx );
+      }
+    }
 
-  texels = ParseSimpleDDS( sobolTextureData, width, height, pf );
-  assert( pf == PixelFormat::RGBA8888UN );
-  pf = PixelFormat::RGBA8888U;
-  sobolTexture = device.Create2DTexture( &commandList, width, height, texels.first, texels.second, pf, false, SobolSlot, eastl::nullopt, false, L"Sobol" );
+    eastl::sort( candidates.begin(), candidates.end(), []( auto& a, auto& b ) { return a.first > b.first; } );
 
-  RecreateScrenSizeDependantTextures( commandList, screenWidth, screenHeight );
+    for ( int candidateIx = 0; candidateIx < eastl::min( int( candidates.size() ), maxAutoOccluders ); candidateIx++ )
+      AddOccluderMesh( *occlusionCuller, *importedScene.mMeshes[ candidates[ candidateIx ].second ], candidates[ candidateIx ].second );
+  }
 }
 
 const eastl::wstring& Scene::GetError() const
@@ -762,90 +764,136 @@ const eastl::wstring& Scene::GetError() const
 
 void Scene::OnScreenResize( CommandList& commandList, int width, int height )
 {
-  NotifyCamerasOnWindowSizeChange( *rootNode, float( width ) / height );
-  BuildSceneBuffers( commandList );
+  screenWidth  = width;
+  screenHeight = height;
+
+  if ( rootNode )
+  {
+    NotifyCamerasOnWindowSizeChange( *rootNode, float( width ) / height );
+    sceneStore->UpdateCameraProjections();
+  }
+
+  if ( IsRenderable() )
+    BuildSceneBuffers( commandList );
+
   RecreateScrenSizeDependantTextures( commandList, width, height );
 }
 
-void Scene::TearDownSceneBuffers( CommandList& commandList )
+void Scene::TearDownSceneBuffers( CommandList* commandList )
 {
-  commandList.HoldResource( eastl::move( nodeBuffer ) );
-  commandList.HoldResource( eastl::move( rootNodeChildrenInidcesBuffer ) );
-  commandList.HoldResource( eastl::move( meshBuffer ) );
-  commandList.HoldResource( eastl::move( cameraBuffer ) );
-  commandList.HoldResource( eastl::move( indirectOpaqueDrawBuffer ) );
-  commandList.HoldResource( eastl::move( indirectOpaqueTwoSidedDrawBuffer ) );
-  commandList.HoldResource( eastl::move( indirectOpaqueAlphaTestedDrawBuffer ) );
-  commandList.HoldResource( eastl::move( indirectOpaqueTwoSidedAlphaTestedDrawBuffer ) );
-  commandList.HoldResource( eastl::move( indirectTranslucentDrawBuffer ) );
-  commandList.HoldResource( eastl::move( indirectTranslucentTwoSidedDrawBuffer ) );
+  TearDownResource( commandList, nodeBuffer );
+  TearDownResource( commandList, rootNodeChildrenInidcesBuffer );
+  TearDownResource( commandList, meshBuffer );
+  TearDownResource( commandList, cameraBuffer );
+  TearDownResource( commandList, indirectOpaqueDrawBuffer );
+  TearDownResource( commandList, indirectOpaqueTwoSidedDrawBuffer );
+  TearDownResource( commandList, indirectOpaqueAlphaTestedDrawBuffer );
+  TearDownResource( commandList, indirectOpaqueTwoSidedAlphaTestedDrawBuffer );
+  TearDownResource( commandList, indirectTranslucentDrawBuffer );
+  TearDownResource( commandList, indirectTranslucentTwoSidedDrawBuffer );
+  TearDownResource( commandList, indirectLateOpaqueDrawBuffer );
+  TearDownResource( commandList, indirectLateOpaqueTwoSidedDrawBuffer );
+  TearDownResource( commandList, indirectLateOpaqueAlphaTestedDrawBuffer );
+  TearDownResource( commandList, indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer );
+  TearDownResource( commandList, occlusionCandidateBuffer );
 }
 
 void Scene::BuildSceneBuffers( CommandList& commandList )
 {
-  nodeSlots.clear();
-  meshSlots.clear();
-  cameraSlots.clear();
-  rootNodeChildrenIndices.clear();
-  rootNodeChildrenIndices.push_back( 0 ); // This will store the number of root node children
+  auto& nodeSlots               = sceneStore->GetNodeSlots();
+  auto& meshSlots               = sceneStore->GetMeshSlots();
+  auto& cameraSlots             = sceneStore->GetCameraSlots();
+  auto& rootNodeChildrenIndices = sceneStore->GetRootNodeChildrenIndices();
 
-  MarshallSceneToGPU( *rootNode, instanceCount, *this );
-  
-  rootNodeChildrenIndices[ 0 ] = uint32_t( rootNodeChildrenIndices.size() - 1 );
+  instanceCount = sceneStore->GetInstanceCount();
+
+  // The whole node buffer is uploaded, so there is nothing left to patch.
+  changedNodes.clear();
+
+  // The frames in flight keep using the old buffers, the command list releases them once the GPU is done. The
+  // shaders only see the buffers through the descriptor tables bound for each pass, so the new ones can take any
+  // free descriptor slot in the meantime.
+  TearDownSceneBuffers( &commandList );
 
   auto& device = RenderManager::GetInstance().GetDevice();
 
   nodeBuffer = CreateBufferFromData( nodeSlots.data(), int( nodeSlots.size() ), ResourceType::Buffer, device, commandList, L"nodeBuffer" );
-  auto nodeBufferDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, NodeBufferSlot, *nodeBuffer, sizeof( NodeSlot ) );
+  auto nodeBufferDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::ShaderResourceView, SceneBufferResourceBaseSlot, *nodeBuffer, sizeof( NodeSlot ) );
   nodeBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( nodeBufferDesc ) );
 
   rootNodeChildrenInidcesBuffer = CreateBufferFromData( rootNodeChildrenIndices.data(), int( rootNodeChildrenIndices.size() ), ResourceType::Buffer, device, commandList, L"rootNodeChildrenInidcesBuffer" );
-  auto rootNodeChildrenInidcesBufferDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, RootNodeChildrenInidcesBufferSlot, *rootNodeChildrenInidcesBuffer, sizeof( uint32_t ) );
+  auto rootNodeChildrenInidcesBufferDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::ShaderResourceView, SceneBufferResourceBaseSlot, *rootNodeChildrenInidcesBuffer, sizeof( uint32_t ) );
   rootNodeChildrenInidcesBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( rootNodeChildrenInidcesBufferDesc ) );
 
   meshBuffer = CreateBufferFromData( meshSlots.data(), int( meshSlots.size() ), ResourceType::Buffer, device, commandList, L"meshBuffer" );
-  auto meshBufferDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, MeshBufferSlot, *meshBuffer, sizeof( MeshSlot ) );
+  auto meshBufferDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::ShaderResourceView, SceneBufferResourceBaseSlot, *meshBuffer, sizeof( MeshSlot ) );
   meshBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( meshBufferDesc ) );
 
   cameraBuffer = CreateBufferFromData( cameraSlots.data(), int( cameraSlots.size() ), ResourceType::Buffer, device, commandList, L"cameraBuffer" );
-  auto cameraBufferDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, CameraBufferSlot, *cameraBuffer, sizeof( CameraSlot ) );
+  auto cameraBufferDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::ShaderResourceView, SceneBufferResourceBaseSlot, *cameraBuffer, sizeof( CameraSlot ) );
   cameraBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( cameraBufferDesc ) );
 
   indirectOpaqueDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectOpaqueDrawBuffer" );
-  auto indirectOpaqueDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, IndirectOpaqueDrawBufferUAVSlot, *indirectOpaqueDrawBuffer, sizeof( IndirectRender ) );
-  auto indirectOpaqueDrawBufferSRVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView,  IndirectOpaqueDrawBufferSRVSlot, *indirectOpaqueDrawBuffer, sizeof( IndirectRender ) );
+  auto indirectOpaqueDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectOpaqueDrawBuffer, sizeof( IndirectRender ) );
   indirectOpaqueDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectOpaqueDrawBufferUAVDesc ) );
-  indirectOpaqueDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView,  eastl::move( indirectOpaqueDrawBufferSRVDesc ) );
 
   indirectOpaqueTwoSidedDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectOpaqueTwoSidedDrawBuffer" );
-  auto indirectOpaqueTwoSidedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, IndirectOpaqueTwoSidedDrawBufferUAVSlot, *indirectOpaqueTwoSidedDrawBuffer, sizeof( IndirectRender ) );
-  auto indirectOpaqueTwoSidedDrawBufferSRVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView,  IndirectOpaqueTwoSidedDrawBufferSRVSlot, *indirectOpaqueTwoSidedDrawBuffer, sizeof( IndirectRender ) );
+  auto indirectOpaqueTwoSidedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectOpaqueTwoSidedDrawBuffer, sizeof( IndirectRender ) );
   indirectOpaqueTwoSidedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectOpaqueTwoSidedDrawBufferUAVDesc ) );
-  indirectOpaqueTwoSidedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView,  eastl::move( indirectOpaqueTwoSidedDrawBufferSRVDesc ) );
 
   indirectOpaqueAlphaTestedDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectOpaqueAlphaTestedDrawBuffer" );
-  auto indirectOpaqueAlphaTestedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, IndirectOpaqueAlphaTestedDrawBufferUAVSlot, *indirectOpaqueAlphaTestedDrawBuffer, sizeof( IndirectRender ) );
-  auto indirectOpaqueAlphaTestedDrawBufferSRVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView,  IndirectOpaqueAlphaTestedDrawBufferSRVSlot, *indirectOpaqueAlphaTestedDrawBuffer, sizeof( IndirectRender ) );
+  auto indirectOpaqueAlphaTestedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectOpaqueAlphaTestedDrawBuffer, sizeof( IndirectRender ) );
   indirectOpaqueAlphaTestedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectOpaqueAlphaTestedDrawBufferUAVDesc ) );
-  indirectOpaqueAlphaTestedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView,  eastl::move( indirectOpaqueAlphaTestedDrawBufferSRVDesc ) );
 
   indirectOpaqueTwoSidedAlphaTestedDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectOpaqueTwoSidedAlphaTestedDrawBuffer" );
-  auto indirectOpaqueTwoSidedAlphaTestedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, IndirectOpaqueTwoSidedAlphaTestedDrawBufferUAVSlot, *indirectOpaqueTwoSidedAlphaTestedDrawBuffer, sizeof( IndirectRender ) );
-  auto indirectOpaqueTwoSidedAlphaTestedDrawBufferSRVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView,  IndirectOpaqueTwoSidedAlphaTestedDrawBufferSRVSlot, *indirectOpaqueTwoSidedAlphaTestedDrawBuffer, sizeof( IndirectRender ) );
+  auto indirectOpaqueTwoSidedAlphaTestedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectOpaqueTwoSidedAlphaTestedDrawBuffer, sizeof( IndirectRender ) );
   indirectOpaqueTwoSidedAlphaTestedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectOpaqueTwoSidedAlphaTestedDrawBufferUAVDesc ) );
-  indirectOpaqueTwoSidedAlphaTestedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView,  eastl::move( indirectOpaqueTwoSidedAlphaTestedDrawBufferSRVDesc ) );
+
+  // The ray traced passes read the opaque draw lists through one descriptor table, so their views are next to each other.
+  auto indirectOpaqueDrawBufferSRVDescs = device.GetShaderResourceHeap().RequestDescriptorRangeAuto( device
+                                                                                                   , ResourceDescriptorType::ShaderResourceView
+                                                                                                   , SceneBufferResourceBaseSlot
+                                                                                                   , { *indirectOpaqueDrawBuffer
+                                                                                                     , *indirectOpaqueTwoSidedDrawBuffer
+                                                                                                     , *indirectOpaqueAlphaTestedDrawBuffer
+                                                                                                     , *indirectOpaqueTwoSidedAlphaTestedDrawBuffer }
+                                                                                                   , sizeof( IndirectRender ) );
+  indirectOpaqueDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( indirectOpaqueDrawBufferSRVDescs[ 0 ] ) );
+  indirectOpaqueTwoSidedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( indirectOpaqueDrawBufferSRVDescs[ 1 ] ) );
+  indirectOpaqueAlphaTestedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( indirectOpaqueDrawBufferSRVDescs[ 2 ] ) );
+  indirectOpaqueTwoSidedAlphaTestedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( indirectOpaqueDrawBufferSRVDescs[ 3 ] ) );
 
   indirectTranslucentDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectTranslucentDrawBuffer" );
-  auto indirectTranslucentDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, IndirectTranslucentDrawBufferUAVSlot, *indirectTranslucentDrawBuffer, sizeof( IndirectRender ) );
-  auto indirectTranslucentDrawBufferSRVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView,  IndirectTranslucentDrawBufferSRVSlot, *indirectTranslucentDrawBuffer, sizeof( IndirectRender ) );
+  auto indirectTranslucentDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectTranslucentDrawBuffer, sizeof( IndirectRender ) );
+  auto indirectTranslucentDrawBufferSRVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::ShaderResourceView,  SceneBufferResourceBaseSlot, *indirectTranslucentDrawBuffer, sizeof( IndirectRender ) );
   indirectTranslucentDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectTranslucentDrawBufferUAVDesc ) );
   indirectTranslucentDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView,  eastl::move( indirectTranslucentDrawBufferSRVDesc ) );
 
   indirectTranslucentTwoSidedDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectTranslucentTwoSidedDrawBuffer" );
-  auto indirectTranslucentTwoSidedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::UnorderedAccessView, IndirectTranslucentTwoSidedDrawBufferUAVSlot, *indirectTranslucentTwoSidedDrawBuffer, sizeof( IndirectRender ) );
-  auto indirectTranslucentTwoSidedDrawBufferSRVDesc = device.GetShaderResourceHeap().RequestDescriptorFromSlot( device, ResourceDescriptorType::ShaderResourceView, IndirectTranslucentTwoSidedDrawBufferSRVSlot, *indirectTranslucentTwoSidedDrawBuffer, sizeof( IndirectRender ) );
+  auto indirectTranslucentTwoSidedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectTranslucentTwoSidedDrawBuffer, sizeof( IndirectRender ) );
+  auto indirectTranslucentTwoSidedDrawBufferSRVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::ShaderResourceView, SceneBufferResourceBaseSlot, *indirectTranslucentTwoSidedDrawBuffer, sizeof( IndirectRender ) );
   indirectTranslucentTwoSidedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectTranslucentTwoSidedDrawBufferUAVDesc ) );
   indirectTranslucentTwoSidedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::ShaderResourceView, eastl::move( indirectTranslucentTwoSidedDrawBufferSRVDesc ) );
+
+  indirectLateOpaqueDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectLateOpaqueDrawBuffer" );
+  auto indirectLateOpaqueDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectLateOpaqueDrawBuffer, sizeof( IndirectRender ) );
+  indirectLateOpaqueDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectLateOpaqueDrawBufferUAVDesc ) );
+
+  indirectLateOpaqueTwoSidedDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectLateOpaqueTwoSidedDrawBuffer" );
+  auto indirectLateOpaqueTwoSidedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectLateOpaqueTwoSidedDrawBuffer, sizeof( IndirectRender ) );
+  indirectLateOpaqueTwoSidedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectLateOpaqueTwoSidedDrawBufferUAVDesc ) );
+
+  indirectLateOpaqueAlphaTestedDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectLateOpaqueAlphaTestedDrawBuffer" );
+  auto indirectLateOpaqueAlphaTestedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectLateOpaqueAlphaTestedDrawBuffer, sizeof( IndirectRender ) );
+  indirectLateOpaqueAlphaTestedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectLateOpaqueAlphaTestedDrawBufferUAVDesc ) );
+
+  indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( IndirectRender ) * instanceCount, sizeof( IndirectRender ), L"indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer" );
+  auto indirectLateOpaqueTwoSidedAlphaTestedDrawBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer, sizeof( IndirectRender ) );
+  indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( indirectLateOpaqueTwoSidedAlphaTestedDrawBufferUAVDesc ) );
+
+  occlusionCandidateBuffer = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, sizeof( OcclusionCandidate ) * instanceCount, sizeof( OcclusionCandidate ), L"occlusionCandidateBuffer" );
+  auto occlusionCandidateBufferUAVDesc = device.GetShaderResourceHeap().RequestDescriptorAuto( device, ResourceDescriptorType::UnorderedAccessView, SceneBufferResourceBaseSlot, *occlusionCandidateBuffer, sizeof( OcclusionCandidate ) );
+  occlusionCandidateBuffer->AttachResourceDescriptor( ResourceDescriptorType::UnorderedAccessView, eastl::move( occlusionCandidateBufferUAVDesc ) );
 }
 
 Upscaling::Quality Scene::GetUpscalingQuality() const
@@ -874,13 +922,16 @@ void Scene::TearDownScreenSizeDependantTextures( CommandList& commandList )
   commandList.HoldResource( eastl::move( lqColorTexture ) );
   commandList.HoldResource( eastl::move( hqColorTexture ) );
   commandList.HoldResource( eastl::move( depthTexture ) );
+  for ( auto& t : hiZTextures ) commandList.HoldResource( eastl::move( t ) );
   commandList.HoldResource( eastl::move( aoTexture ) );
   commandList.HoldResource( eastl::move( reflectionTexture ) );
   commandList.HoldResource( eastl::move( giTexture ) );
   commandList.HoldResource( eastl::move( lumaTexture ) );
   commandList.HoldResource( eastl::move( shadowTexture ) );
   commandList.HoldResource( eastl::move( shadowTransTexture ) );
-  for ( auto& t : bloomTextures ) for ( auto& tx : t ) commandList.HoldResource( eastl::move( tx ) );
+  if ( postProcessGraph )
+    postProcessGraph->TearDown( commandList );
+  postProcessGraph.reset();
   if ( denoiser )
     denoiser->TearDown( &commandList );
   denoiser.reset();
@@ -900,7 +951,8 @@ void Scene::RecreateScrenSizeDependantTextures( CommandList& commandList, int wi
   if ( upscalingQuality != Upscaling::Quality::Off )
   {
     upscaling = Upscaling::Instantiate();
-    upscaling->Initialize( commandList, upscalingQuality, width, height );
+    if ( upscaling )
+      upscaling->Initialize( commandList, upscalingQuality, width, height );
   }
 
   auto lrts = upscaling ? upscaling->GetRenderingResolution() : XMINT2( width, height );
@@ -918,6 +970,17 @@ void Scene::RecreateScrenSizeDependantTextures( CommandList& commandList, int wi
   depthTexture = device.Create2DTexture( nullptr, lrts.x, lrts.y, nullptr, 0, RenderManager::DepthFormat, false, DepthTextureSlot, eastl::nullopt, false, L"DepthTexture" );
   commandList.ChangeResourceState( *depthTexture, ResourceStateBits::DepthWrite );
 
+  int hiZWidth  = eastl::max( lrts.x >> 1, 1 );
+  int hiZHeight = eastl::max( lrts.y >> 1, 1 );
+  for ( int level = 0; level < HiZLevelCount; ++level )
+  {
+    hiZTextures[ level ] = device.Create2DTexture( &commandList, hiZWidth, hiZHeight, nullptr, 0, PixelFormat::R32F, false, HiZ0TextureSlot + level, HiZ0TextureUAVSlot + level, false, L"HiZ" );
+    hiZWidth  = eastl::max( hiZWidth  >> 1, 1 );
+    hiZHeight = eastl::max( hiZHeight >> 1, 1 );
+  }
+
+  hiZValid = false;
+
   #if USE_AO_WITH_GI
     aoTexture = device.Create2DTexture( &commandList, lrts.x, lrts.y, nullptr, 0, RenderManager::AOFormat,  false, AOTextureSRVSlot, AOTextureUAVSlot, false, L"AOTexture" );
   #endif
@@ -928,18 +991,17 @@ void Scene::RecreateScrenSizeDependantTextures( CommandList& commandList, int wi
   auto bloomWidth  = width  > 2560 ? 1280 : 640;
   auto bloomHeight = height > 1440 ? 768  : 384;
 
-  for ( int bt = 0; bt < 5; ++bt )
-  {
-    bloomTextures[ bt ][ 0 ] = device.Create2DTexture( &commandList, bloomWidth >> bt, bloomHeight >> bt, nullptr, 0, RenderManager::HDRFormat, true, BloomA0TextureSlot + bt, BloomA0TextureUAVSlot + bt, false, L"Bloom_a" );
-    bloomTextures[ bt ][ 1 ] = device.Create2DTexture( &commandList, bloomWidth >> bt, bloomHeight >> bt, nullptr, 0, RenderManager::HDRFormat, true, BloomB0TextureSlot + bt, BloomB0TextureUAVSlot + bt, false, L"Bloom_b" );
-  }
-
   lumaTexture = device.Create2DTexture( &commandList, bloomWidth, bloomHeight, nullptr, 0, RenderManager::LumaFormat, true, LumaTextureSlot, LumaTextureUAVSlot, false, L"Luma" );
 
+  BuildPostProcessGraph( bloomWidth, bloomHeight );
+
   shadowTexture = device.Create2DTexture( &commandList, lrts.x, lrts.y, nullptr, 0, RenderManager::ShadowFormat, true, ShadowTextureSlot, ShadowTextureUAVSlot, false, L"Shadow" );
   shadowTransTexture = device.Create2DTexture( &commandList, lrts.x, lrts.y, nullptr, 0, RenderManager::ShadowTransFormat, true, ShadowTransTextureSlot, ShadowTransTextureUAVSlot, false, L"ShadowTrans" );
 
-  denoiser = CreateDenoiser( device, manager.GetCommandQueue( CommandQueueType::Direct ), commandList, lrts.x, lrts.y );
+  if ( manager.IsHeadless() )
+    denoiser = CreateNullDenoiser();
+  else
+    denoiser = CreateDenoiser( device, manager.GetCommandQueue( CommandQueueType::Direct ), commandList, lrts.x, lrts.y );
 }
 
 void Scene::CreateBRDFLUTTexture( CommandList& commandList )
@@ -957,6 +1019,47 @@ void Scene::CreateBRDFLUTTexture( CommandList& commandList )
   commandList.ChangeResourceState( *specBRDFLUTTexture, ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput );
 }
 
+void Scene::CreateSamplingTextures( CommandList& commandList )
+{
+  static constexpr int      scramblingRankingSize = 128;
+  static constexpr int      sobolSampleCount      = 256;
+  static constexpr uint32_t samplingSeed          = 0x5A4D3C2B;
+
+  auto& device = RenderManager::GetInstance().GetDevice();
+
+  // The scrambling and ranking keys in the file are optimized for the Sobol table next to it, so
+  // the files are used together when they are there. The generated tables work without the files,
+  // but the error of the shadow rays is not distributed as blue noise with them.
+  auto scramblingRankingTextureFile = MappedFile::OpenAsync( L"Content/EngineTextures/scrambling_ranking_128x128_2d_1spp.dds" );
+  auto sobolTextureFile             = MappedFile::OpenAsync( L"Content/EngineTextures/sobol_256_4d.dds" );
+
+  auto scramblingRankingTextureData = scramblingRankingTextureFile.get();
+  auto sobolTextureData             = sobolTextureFile.get();
+
+  if ( scramblingRankingTextureData.empty() || sobolTextureData.empty() )
+  {
+    auto scramblingRanking = LowDiscrepancy::BuildScramblingRankingTable( scramblingRankingSize, samplingSeed );
+    auto sobol             = LowDiscrepancy::BuildSobolTable( sobolSampleCount, samplingSeed );
+
+    scramblingRankingTexture = device.Create2DTexture( &commandList, scramblingRankingSize, scramblingRankingSize, scramblingRanking.data(), int( scramblingRanking.size() ), PixelFormat::RGBA8888U, false, ScramblingRankingSlot, eastl::nullopt, false, L"Scrambling ranking" );
+    sobolTexture             = device.Create2DTexture( &commandList, sobolSampleCount, 1, sobol.data(), int( sobol.size() ), PixelFormat::RGBA8888U, false, SobolSlot, eastl::nullopt, false, L"Sobol" );
+    return;
+  }
+
+  int width, height;
+  PixelFormat pf;
+
+  auto texels = ParseSimpleDDS( scramblingRankingTextureData.data(), int( scramblingRankingTextureData.size() ), width, height, pf );
+  assert( pf == PixelFormat::RGBA8888UN );
+  pf = PixelFormat::RGBA8888U;
+  scramblingRankingTexture = device.Create2DTexture( &commandList, width, height, texels.first, texels.second, pf, false, ScramblingRankingSlot, eastl::nullopt, false, L"Scrambling ranking" );
+
+  texels = ParseSimpleDDS( sobolTextureData.data(), int( sobolTextureData.size() ), width, height, pf );
+  assert( pf == PixelFormat::RGBA8888UN );
+  pf = PixelFormat::RGBA8888U;
+  sobolTexture = device.Create2DTexture( &commandList, width, height, texels.first, texels.second, pf, false, SobolSlot, eastl::nullopt, false, L"Sobol" );
+}
+
 void Scene::CullScene( CommandList& commandList, float jitterX, float jitterY, int targetWidth, int targetHeight, bool useTextureFeedback, bool freezeCulling )
 {
   GPUSection gpuSection( commandList, L"Scene culling" );
@@ -978,6 +1081,10 @@ void Scene::CullScene( CommandList& commandList, float jitterX, float jitterY, i
                                    , { *lightParamsBuffer,                           ResourceStateBits::UnorderedAccess }
                                    , { *skyBuffer,                                   ResourceStateBits::UnorderedAccess } } );
 
+  commandList.ChangeResourceState( *occlusionCandidateBuffer, ResourceStateBits::UnorderedAccess );
+  for ( auto& hiZTexture : hiZTextures )
+    commandList.ChangeResourceState( *hiZTexture, ResourceStateBits::NonPixelShaderInput );
+
   struct
   {
     XMFLOAT4X4 cameraViewProj;
@@ -1003,7 +1110,6 @@ void Scene::CullScene( CommandList& commandList, float jitterX, float jitterY, i
   jitterX *=  2.0f / targetWidth;
   jitterY *= -2.0f / targetHeight;
 
-  auto cameraNode    = FindNodeByName( "Camera" );
   auto nodeTransform = cameraNode->GetTransform();
 
   auto cameraView = XMMatrixInverse( nullptr, nodeTransform );
@@ -1029,7 +1135,7 @@ void Scene::CullScene( CommandList& commandList, float jitterX, float jitterY, i
   prepareCullingParams.feedbackPhase  = useTextureFeedback ? feedbackPhase : 0xFFFFFFFFU;
   prepareCullingParams.frameIndex     = frameCounter;
   prepareCullingParams.freeze         = freezeCulling ? 1 : 0;
-  prepareCullingParams.cameraIndex    = cameraNodeIndex;
+  prepareCullingParams.cameraIndex    = sceneStore->GetCameraNodeIndex();
 
   commandList.SetComputeShader( *prepareCullingShader );
   commandList.SetComputeConstantValues( 0, prepareCullingParams, 0 );
@@ -1043,6 +1149,17 @@ void Scene::CullScene( CommandList& commandList, float jitterX, float jitterY, i
 
   if ( !prepareCullingParams.freeze )
   {
+    struct
+    {
+      uint32_t hiZValid;
+      uint32_t depthWidth;
+      uint32_t depthHeight;
+    } cullingParams;
+
+    cullingParams.hiZValid    = hiZValid ? 1 : 0;
+    cullingParams.depthWidth  = depthTexture->GetTextureWidth();
+    cullingParams.depthHeight = depthTexture->GetTextureHeight();
+
     // Do clipping on instances, the result goes to the indirect args buffer
     commandList.SetComputeShader( *cullingShader );
     commandList.SetComputeShaderResourceView( 0, *nodeBuffer );
@@ -1060,8 +1177,11 @@ void Scene::CullScene( CommandList& commandList, float jitterX, float jitterY, i
     commandList.SetComputeUnorderedAccessView( 12, *frameParamsBuffer );
     commandList.SetComputeUnorderedAccessView( 13, *lightParamsBuffer );
     commandList.SetComputeUnorderedAccessView( 14, *skyBuffer );
+    commandList.SetComputeConstantValues( 15, cullingParams, 0 );
+    commandList.SetComputeDescriptorHeap( 16, RenderManager::GetInstance().GetShaderResourceHeap(), HiZ0TextureSlot );
+    commandList.SetComputeUnorderedAccessView( 17, *occlusionCandidateBuffer );
 
-    commandList.Dispatch( TG( rootNodeChildrenIndices.size(), CullingKernelWidth ), 1, 1 );
+    commandList.Dispatch( TG( sceneStore->GetRootNodeChildrenIndices().size(), CullingKernelWidth ), 1, 1 );
   }
 
   commandList.AddUAVBarrier( { *indirectOpaqueDrawBuffer
@@ -1073,7 +1193,87 @@ void Scene::CullScene( CommandList& commandList, float jitterX, float jitterY, i
                              , *indirectDrawCountBuffer
                              , *frameParamsBuffer
                              , *lightParamsBuffer
-                             , *skyBuffer } );
+                             , *skyBuffer
+                             , *occlusionCandidateBuffer } );
+}
+
+void Scene::CullSceneLate( CommandList& commandList, bool freezeCulling )
+{
+  GPUSection gpuSection( commandList, L"Scene late culling" );
+
+  if ( !freezeCulling )
+  {
+    commandList.ChangeResourceState( { { *indirectOpaqueDrawBuffer,                        ResourceStateBits::UnorderedAccess }
+                                     , { *indirectOpaqueTwoSidedDrawBuffer,                ResourceStateBits::UnorderedAccess }
+                                     , { *indirectOpaqueAlphaTestedDrawBuffer,             ResourceStateBits::UnorderedAccess }
+                                     , { *indirectOpaqueTwoSidedAlphaTestedDrawBuffer,     ResourceStateBits::UnorderedAccess }
+                                     , { *indirectTranslucentDrawBuffer,                   ResourceStateBits::UnorderedAccess }
+                                     , { *indirectTranslucentTwoSidedDrawBuffer,           ResourceStateBits::UnorderedAccess }
+                                     , { *indirectLateOpaqueDrawBuffer,                    ResourceStateBits::UnorderedAccess }
+                                     , { *indirectLateOpaqueTwoSidedDrawBuffer,            ResourceStateBits::UnorderedAccess }
+                                     , { *indirectLateOpaqueAlphaTestedDrawBuffer,         ResourceStateBits::UnorderedAccess }
+                                     , { *indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer, ResourceStateBits::UnorderedAccess }
+                                     , { *indirectDrawCountBuffer,                         ResourceStateBits::UnorderedAccess }
+                                     , { *frameParamsBuffer,                               ResourceStateBits::UnorderedAccess }
+                                     , { *occlusionCandidateBuffer,                        ResourceStateBits::UnorderedAccess } } );
+
+    struct
+    {
+      uint32_t depthWidth;
+      uint32_t depthHeight;
+    } cullingParams;
+
+    cullingParams.depthWidth  = depthTexture->GetTextureWidth();
+    cullingParams.depthHeight = depthTexture->GetTextureHeight();
+
+    // Retest the meshes the early pass rejected, against the pyramid of this frame's early depth
+    commandList.SetComputeShader( *cullingLateShader );
+    commandList.SetComputeConstantValues( 0, cullingParams, 0 );
+    commandList.SetComputeShaderResourceView( 1, *meshBuffer );
+    commandList.SetComputeShaderResourceView( 2, *materialBuffer );
+    commandList.SetComputeDescriptorHeap( 3, RenderManager::GetInstance().GetShaderResourceHeap(), HiZ0TextureSlot );
+    commandList.SetComputeUnorderedAccessView( 4, *indirectOpaqueDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 5, *indirectOpaqueTwoSidedDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 6, *indirectOpaqueAlphaTestedDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 7, *indirectOpaqueTwoSidedAlphaTestedDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 8, *indirectTranslucentDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 9, *indirectTranslucentTwoSidedDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 10, *indirectLateOpaqueDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 11, *indirectLateOpaqueTwoSidedDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 12, *indirectLateOpaqueAlphaTestedDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 13, *indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer );
+    commandList.SetComputeUnorderedAccessView( 14, *indirectDrawCountBuffer );
+    commandList.SetComputeUnorderedAccessView( 15, *frameParamsBuffer );
+    commandList.SetComputeUnorderedAccessView( 16, *occlusionCandidateBuffer );
+
+    commandList.Dispatch( TG( instanceCount, CullingKernelWidth ), 1, 1 );
+
+    commandList.AddUAVBarrier( { *indirectOpaqueDrawBuffer
+                               , *indirectOpaqueTwoSidedDrawBuffer
+                               , *indirectOpaqueAlphaTestedDrawBuffer
+                               , *indirectOpaqueTwoSidedAlphaTestedDrawBuffer
+                               , *indirectTranslucentDrawBuffer
+                               , *indirectTranslucentTwoSidedDrawBuffer
+                               , *indirectLateOpaqueDrawBuffer
+                               , *indirectLateOpaqueTwoSidedDrawBuffer
+                               , *indirectLateOpaqueAlphaTestedDrawBuffer
+                               , *indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer
+                               , *indirectDrawCountBuffer } );
+  }
+
+  commandList.ChangeResourceState( { { *indirectOpaqueDrawBuffer,                        ResourceStateBits::IndirectArgument }
+                                   , { *indirectOpaqueTwoSidedDrawBuffer,                ResourceStateBits::IndirectArgument }
+                                   , { *indirectOpaqueAlphaTestedDrawBuffer,             ResourceStateBits::IndirectArgument }
+                                   , { *indirectOpaqueTwoSidedAlphaTestedDrawBuffer,     ResourceStateBits::IndirectArgument }
+                                   , { *indirectTranslucentDrawBuffer,                   ResourceStateBits::IndirectArgument }
+                                   , { *indirectTranslucentTwoSidedDrawBuffer,           ResourceStateBits::IndirectArgument }
+                                   , { *indirectLateOpaqueDrawBuffer,                    ResourceStateBits::IndirectArgument }
+                                   , { *indirectLateOpaqueTwoSidedDrawBuffer,            ResourceStateBits::IndirectArgument }
+                                   , { *indirectLateOpaqueAlphaTestedDrawBuffer,         ResourceStateBits::IndirectArgument }
+                                   , { *indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer, ResourceStateBits::IndirectArgument }
+                                   , { *indirectDrawCountBuffer,                         ResourceStateBits::IndirectArgument }
+                                   , { *frameParamsBuffer,                               ResourceStateBits::VertexOrConstantBuffer }
+                                   , { *depthTexture,                                    ResourceStateBits::DepthWrite } } );
 }
 
 void Scene::RenderSkyToCube( CommandList& commandList )
@@ -1148,11 +1348,11 @@ void Scene::ClearTexturesAndPrepareRendering( CommandList& commandList, Resource
                                    , { *skyTexture,                                  ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput } } );
 }
 
-void Scene::RenderDepth( CommandList& commandList )
+void Scene::RenderDepth( CommandList& commandList, bool latePass )
 {
   auto& renderManager = RenderManager::GetInstance();
 
-  GPUSection gpuSection( commandList, L"Render depth prepass" );
+  GPUSection gpuSection( commandList, latePass ? L"Render late depth prepass" : L"Render depth prepass" );
 
   commandList.SetRenderTarget( { motionVectorTexture.get(), textureMipTexture.get(), geometryIdsTexture.get() }, depthTexture.get() );
   
@@ -1171,10 +1371,74 @@ void Scene::RenderDepth( CommandList& commandList )
     commandList.ExecuteIndirect( renderManager.GetCommandSignature( sig ), drawBuffer, 0, *indirectDrawCountBuffer, sizeof( uint32_t ) * offset, instanceCount );
   };
 
-  drawPass( PipelinePresets::MeshDepth,         CommandSignatures::MeshDepth,         *indirectOpaqueDrawBuffer,         0 );
-  drawPass( PipelinePresets::MeshDepthTwoSided, CommandSignatures::MeshDepthTwoSided, *indirectOpaqueTwoSidedDrawBuffer, 1 );
-  drawPass( PipelinePresets::MeshDepthAlphaTest, CommandSignatures::MeshDepthAlphaTest, *indirectOpaqueAlphaTestedDrawBuffer, 2 );
-  drawPass( PipelinePresets::MeshDepthTwoSidedAlphaTest, CommandSignatures::MeshDepthTwoSidedAlphaTest, *indirectOpaqueTwoSidedAlphaTestedDrawBuffer, 3 );
+  if ( latePass )
+  {
+    drawPass( PipelinePresets::MeshDepth,         CommandSignatures::MeshDepth,         *indirectLateOpaqueDrawBuffer,         7 );
+    drawPass( PipelinePresets::MeshDepthTwoSided, CommandSignatures::MeshDepthTwoSided, *indirectLateOpaqueTwoSidedDrawBuffer, 8 );
+    drawPass( PipelinePresets::MeshDepthAlphaTest, CommandSignatures::MeshDepthAlphaTest, *indirectLateOpaqueAlphaTestedDrawBuffer, 9 );
+    drawPass( PipelinePresets::MeshDepthTwoSidedAlphaTest, CommandSignatures::MeshDepthTwoSidedAlphaTest, *indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer, 10 );
+  }
+  else
+  {
+    drawPass( PipelinePresets::MeshDepth,         CommandSignatures::MeshDepth,         *indirectOpaqueDrawBuffer,         0 );
+    drawPass( PipelinePresets::MeshDepthTwoSided, CommandSignatures::MeshDepthTwoSided, *indirectOpaqueTwoSidedDrawBuffer, 1 );
+    drawPass( PipelinePresets::MeshDepthAlphaTest, CommandSignatures::MeshDepthAlphaTest, *indirectOpaqueAlphaTestedDrawBuffer, 2 );
+    drawPass( PipelinePresets::MeshDepthTwoSidedAlphaTest, CommandSignatures::MeshDepthTwoSidedAlphaTest, *indirectOpaqueTwoSidedAlphaTestedDrawBuffer, 3 );
+  }
+}
+
+void Scene::BuildHiZ( CommandList& commandList )
+{
+  GPUSection gpuSection( commandList, L"Build Hi-Z" );
+
+  commandList.ChangeResourceState( *depthTexture, ResourceStateBits::NonPixelShaderInput );
+
+  commandList.SetComputeShader( *hiZBuildShader );
+
+  Resource* source = depthTexture.get();
+  for ( auto& hiZTexture : hiZTextures )
+  {
+    struct
+    {
+      uint32_t sourceWidth;
+      uint32_t sourceHeight;
+      uint32_t targetWidth;
+      uint32_t targetHeight;
+    } hiZParams;
+
+    hiZParams.sourceWidth  = source->GetTextureWidth();
+    hiZParams.sourceHeight = source->GetTextureHeight();
+    hiZParams.targetWidth  = hiZTexture->GetTextureWidth();
+    hiZParams.targetHeight = hiZTexture->GetTextureHeight();
+
+    commandList.ChangeResourceState( *hiZTexture, ResourceStateBits::UnorderedAccess );
+    commandList.SetComputeConstantValues( 0, hiZParams, 0 );
+    commandList.SetComputeShaderResourceView( 1, *source );
+    commandList.SetComputeUnorderedAccessView( 2, *hiZTexture );
+    commandList.Dispatch( TG( hiZParams.targetWidth, HiZKernelWidth ), TG( hiZParams.targetHeight, HiZKernelHeight ), 1 );
+    commandList.AddUAVBarrier( { *hiZTexture } );
+    commandList.ChangeResourceState( *hiZTexture, ResourceStateBits::NonPixelShaderInput );
+
+    source = hiZTexture.get();
+  }
+
+  hiZValid = true;
+}
+
+void Scene::PrepareRayTracedPasses( CommandList& commandList )
+{
+  // Everything the ray traced passes share goes into the state all of them ask for,
+  // so they don't change it while they are recorded in parallel.
+  commandList.ChangeResourceState( { { *depthTexture,                                ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
+                                   , { *textureMipTexture,                           ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
+                                   , { *geometryIdsTexture,                          ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
+                                   , { *indirectOpaqueDrawBuffer,                    ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
+                                   , { *indirectOpaqueTwoSidedDrawBuffer,            ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
+                                   , { *indirectOpaqueAlphaTestedDrawBuffer,         ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
+                                   , { *indirectOpaqueTwoSidedAlphaTestedDrawBuffer, ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
+                                   , { *frameParamsBuffer,                           ResourceStateBits::VertexOrConstantBuffer }
+                                   , { *materialBuffer,                              ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
+                                   , { *lightParamsBuffer,                           ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput } } );
 }
 
 void Scene::RenderShadow( CommandList& commandList )
@@ -1185,7 +1449,7 @@ void Scene::RenderShadow( CommandList& commandList )
 
   commandList.ChangeResourceState( { { *shadowTexture,      ResourceStateBits::UnorderedAccess }
                                    , { *shadowTransTexture, ResourceStateBits::UnorderedAccess }
-                                   , { *depthTexture,       ResourceStateBits::NonPixelShaderInput }
+                                   , { *depthTexture,       ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
                                    , { *frameParamsBuffer,  ResourceStateBits::VertexOrConstantBuffer }
                                    , { *materialBuffer,     ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
                                    , { *lightParamsBuffer,  ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput } } );
@@ -1210,8 +1474,7 @@ void Scene::RenderShadow( CommandList& commandList )
   commandList.AddUAVBarrier( { *shadowTexture, *shadowTransTexture } );
 
   commandList.ChangeResourceState( { { *shadowTexture, ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
-                                   , { *shadowTransTexture, ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
-                                   , { *depthTexture, ResourceStateBits::DepthRead } } );
+                                   , { *shadowTransTexture, ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput } } );
 }
 
 void Scene::RenderAO( CommandList& commandList )
@@ -1262,7 +1525,6 @@ void Scene::RenderGI( CommandList& commandList )
 
 void Scene::Denoise( CommandAllocator& commandAllocator, CommandList& commandList, float jitterX, float jitterY, bool showDenoiserDebugLayer )
 {
-  auto cameraNode    = FindNodeByName( "Camera" );
   auto nodeTransform = cameraNode->GetTransform();
 
   auto cameraView = XMMatrixInverse( nullptr, nodeTransform );
@@ -1335,6 +1597,9 @@ void Scene::SetupTriangleBuffers( CommandList& commandList, bool compute )
 {
   auto& manager = RenderManager::GetInstance();
 
+  // The opaque draw lists are allocated as one range, the table starts at the first of them.
+  int indirectOpaqueDrawListsSlot = indirectOpaqueDrawBuffer->GetResourceDescriptor( ResourceDescriptorType::ShaderResourceView )->GetSlot();
+
   commandList.ChangeResourceState( { { *depthTexture,                                ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
                                    , { *textureMipTexture,                           ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput } 
                                    , { *geometryIdsTexture,                          ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
@@ -1355,7 +1620,7 @@ void Scene::SetupTriangleBuffers( CommandList& commandList, bool compute )
     commandList.SetComputeDescriptorHeap( 7,  manager.GetShaderResourceHeap(), SceneBufferResourceBaseSlot );
     commandList.SetComputeDescriptorHeap( 8,  manager.GetShaderResourceHeap(), SceneBufferResourceBaseSlot );
     commandList.SetComputeDescriptorHeap( 9,  manager.GetShaderResourceHeap(), Scene2DResourceBaseSlot );
-    commandList.SetComputeDescriptorHeap( 10, manager.GetShaderResourceHeap(), IndirectOpaqueDrawBufferSRVSlot );
+    commandList.SetComputeDescriptorHeap( 10, manager.GetShaderResourceHeap(), indirectOpaqueDrawListsSlot );
   }
   else
   {
@@ -1369,7 +1634,7 @@ void Scene::SetupTriangleBuffers( CommandList& commandList, bool compute )
     commandList.SetDescriptorHeap( 7,  manager.GetShaderResourceHeap(), SceneBufferResourceBaseSlot );
     commandList.SetDescriptorHeap( 8,  manager.GetShaderResourceHeap(), SceneBufferResourceBaseSlot );
     commandList.SetDescriptorHeap( 9,  manager.GetShaderResourceHeap(), Scene2DResourceBaseSlot );
-    commandList.SetDescriptorHeap( 10, manager.GetShaderResourceHeap(), IndirectOpaqueDrawBufferSRVSlot );
+    commandList.SetDescriptorHeap( 10, manager.GetShaderResourceHeap(), indirectOpaqueDrawListsSlot );
   }
 }
 
@@ -1473,15 +1738,30 @@ void Scene::RenderSky( CommandList& commandList )
   commandList.Draw( 36 );
 }
 
-void Scene::PostProcessing( CommandList& commandList, Resource& backBuffer )
+void Scene::BuildPostProcessGraph( int bloomWidth, int bloomHeight )
 {
+  auto& device = RenderManager::GetInstance().GetDevice();
+
+  const auto shaderInput = ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput;
+
+  postProcessGraph.reset( new RenderGraph );
+  auto& graph = *postProcessGraph;
+
+  auto hqColor  = graph.ImportResource( hqColorTexture.get() );
+  auto exposure = graph.ImportResource( exposureBuffer.get() );
+  auto luma     = graph.ImportResource( lumaTexture.get() );
+
+  backBufferHandle = graph.ImportResource( nullptr );
+
+  for ( int bt = 0; bt < 5; ++bt )
   {
-    GPUSection gpuSection( commandList, L"Extract bloom" );
+    bloomTextures[ bt ][ 0 ] = graph.CreateTransientTexture( { bloomWidth >> bt, bloomHeight >> bt, RenderManager::HDRFormat, BloomA0TextureSlot + bt, BloomA0TextureUAVSlot + bt, L"Bloom_a" } );
+    bloomTextures[ bt ][ 1 ] = graph.CreateTransientTexture( { bloomWidth >> bt, bloomHeight >> bt, RenderManager::HDRFormat, BloomB0TextureSlot + bt, BloomB0TextureUAVSlot + bt, L"Bloom_b" } );
+  }
 
-    commandList.ChangeResourceState( { { *hqColorTexture, ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
-                                     , { *exposureBuffer, ResourceStateBits::VertexOrConstantBuffer }
-                                     , { *bloomTextures[ 0 ][ 0 ], ResourceStateBits::UnorderedAccess }
-                                     , { *lumaTexture, ResourceStateBits::UnorderedAccess } } );
+  auto extractPass = graph.AddPass( L"Extract bloom", [ this, hqColor, luma ]( CommandList& commandList, RenderGraph& renderGraph )
+  {
+    auto& bloom = renderGraph.GetResource( bloomTextures[ 0 ][ 0 ] );
 
     struct
     {
@@ -1490,31 +1770,31 @@ void Scene::PostProcessing( CommandList& commandList, Resource& backBuffer )
       float bloomThreshold;
     } extractParams;
 
-    extractParams.invOutputWidth  = 1.0f / bloomTextures[ 0 ][ 0 ]->GetTextureWidth();
-    extractParams.invOutputHeight = 1.0f / bloomTextures[ 0 ][ 0 ]->GetTextureHeight();
+    extractParams.invOutputWidth  = 1.0f / bloom.GetTextureWidth();
+    extractParams.invOutputHeight = 1.0f / bloom.GetTextureHeight();
     extractParams.bloomThreshold  = bloomThreshold;
 
     commandList.SetComputeShader( *extractBloomShader );
     commandList.SetComputeConstantValues( 0, extractParams, 0 );
     commandList.SetComputeConstantBuffer( 1, *exposureBuffer );
-    commandList.SetComputeShaderResourceView( 2, *hqColorTexture );
-    commandList.SetComputeUnorderedAccessView( 3, *bloomTextures[ 0 ][ 0 ] );
-    commandList.SetComputeUnorderedAccessView( 4, *lumaTexture );
-    commandList.Dispatch( ( bloomTextures[ 0 ][ 0 ]->GetTextureWidth () + ExtractBloomKernelWidth - 1  ) / ExtractBloomKernelWidth
-                        , ( bloomTextures[ 0 ][ 0 ]->GetTextureHeight() + ExtractBloomKernelHeight - 1 ) / ExtractBloomKernelHeight
+    commandList.SetComputeShaderResourceView( 2, renderGraph.GetResource( hqColor ) );
+    commandList.SetComputeUnorderedAccessView( 3, bloom );
+    commandList.SetComputeUnorderedAccessView( 4, renderGraph.GetResource( luma ) );
+    commandList.Dispatch( ( bloom.GetTextureWidth () + ExtractBloomKernelWidth - 1  ) / ExtractBloomKernelWidth
+                        , ( bloom.GetTextureHeight() + ExtractBloomKernelHeight - 1 ) / ExtractBloomKernelHeight
                         , 1 );
 
-    commandList.AddUAVBarrier( { *bloomTextures[ 0 ][ 0 ], *lumaTexture } );
-  }
+    commandList.AddUAVBarrier( { bloom, renderGraph.GetResource( luma ) } );
+  } );
 
-  {
-    GPUSection gpuSection( commandList, L"Downsample bloom" );
+  graph.Use( extractPass, hqColor, shaderInput );
+  graph.Use( extractPass, exposure, ResourceStateBits::VertexOrConstantBuffer );
+  graph.Use( extractPass, bloomTextures[ 0 ][ 0 ], ResourceStateBits::UnorderedAccess );
+  graph.Use( extractPass, luma, ResourceStateBits::UnorderedAccess );
 
-    commandList.ChangeResourceState( { { *bloomTextures[ 0 ][ 0 ], ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
-                                     , { *bloomTextures[ 1 ][ 0 ], ResourceStateBits::UnorderedAccess }
-                                     , { *bloomTextures[ 2 ][ 0 ], ResourceStateBits::UnorderedAccess }
-                                     , { *bloomTextures[ 3 ][ 0 ], ResourceStateBits::UnorderedAccess }
-                                     , { *bloomTextures[ 4 ][ 0 ], ResourceStateBits::UnorderedAccess } } );
+  auto downsamplePass = graph.AddPass( L"Downsample bloom", [ this ]( CommandList& commandList, RenderGraph& renderGraph )
+  {
+    auto& source = renderGraph.GetResource( bloomTextures[ 0 ][ 0 ] );
 
     struct
     {
@@ -1522,28 +1802,34 @@ void Scene::PostProcessing( CommandList& commandList, Resource& backBuffer )
       float invOutputHeight;
     } downsampleParams;
 
-    downsampleParams.invOutputWidth  = 1.0f / bloomTextures[ 0 ][ 0 ]->GetTextureWidth();
-    downsampleParams.invOutputHeight = 1.0f / bloomTextures[ 0 ][ 0 ]->GetTextureHeight();
+    downsampleParams.invOutputWidth  = 1.0f / source.GetTextureWidth();
+    downsampleParams.invOutputHeight = 1.0f / source.GetTextureHeight();
 
     commandList.SetComputeShader( *downsampleBloomShader );
     commandList.SetComputeConstantValues( 0, downsampleParams, 0 );
-    commandList.SetComputeShaderResourceView( 1, *bloomTextures[ 0 ][ 0 ] );
-    commandList.SetComputeUnorderedAccessView( 2, *bloomTextures[ 1 ][ 0 ] );
-    commandList.SetComputeUnorderedAccessView( 3, *bloomTextures[ 2 ][ 0 ] );
-    commandList.SetComputeUnorderedAccessView( 4, *bloomTextures[ 3 ][ 0 ] );
-    commandList.SetComputeUnorderedAccessView( 5, *bloomTextures[ 4 ][ 0 ] );
-    commandList.Dispatch( ( bloomTextures[ 0 ][ 0 ]->GetTextureWidth () / 2 + ExtractBloomKernelWidth - 1  ) / ExtractBloomKernelWidth
-                        , ( bloomTextures[ 0 ][ 0 ]->GetTextureHeight() / 2 + ExtractBloomKernelHeight - 1 ) / ExtractBloomKernelHeight
+    commandList.SetComputeShaderResourceView( 1, source );
+    commandList.SetComputeUnorderedAccessView( 2, renderGraph.GetResource( bloomTextures[ 1 ][ 0 ] ) );
+    commandList.SetComputeUnorderedAccessView( 3, renderGraph.GetResource( bloomTextures[ 2 ][ 0 ] ) );
+    commandList.SetComputeUnorderedAccessView( 4, renderGraph.GetResource( bloomTextures[ 3 ][ 0 ] ) );
+    commandList.SetComputeUnorderedAccessView( 5, renderGraph.GetResource( bloomTextures[ 4 ][ 0 ] ) );
+    commandList.Dispatch( ( source.GetTextureWidth () / 2 + ExtractBloomKernelWidth - 1  ) / ExtractBloomKernelWidth
+                        , ( source.GetTextureHeight() / 2 + ExtractBloomKernelHeight - 1 ) / ExtractBloomKernelHeight
                         , 1 );
 
-    commandList.AddUAVBarrier( { *bloomTextures[ 1 ][ 0 ], *bloomTextures[ 2 ][ 0 ], *bloomTextures[ 3 ][ 0 ], *bloomTextures[ 4 ][ 0 ] } );
-  }
+    commandList.AddUAVBarrier( { renderGraph.GetResource( bloomTextures[ 1 ][ 0 ] )
+                               , renderGraph.GetResource( bloomTextures[ 2 ][ 0 ] )
+                               , renderGraph.GetResource( bloomTextures[ 3 ][ 0 ] )
+                               , renderGraph.GetResource( bloomTextures[ 4 ][ 0 ] ) } );
+  } );
 
-  {
-    GPUSection gpuSection( commandList, L"Blur bloom" );
+  graph.Use( downsamplePass, bloomTextures[ 0 ][ 0 ], shaderInput );
+  for ( int bt = 1; bt < 5; ++bt )
+    graph.Use( downsamplePass, bloomTextures[ bt ][ 0 ], ResourceStateBits::UnorderedAccess );
 
-    commandList.ChangeResourceState( *bloomTextures[ 4 ][ 0 ], ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput );
-    commandList.ChangeResourceState( *bloomTextures[ 4 ][ 1 ], ResourceStateBits::UnorderedAccess );
+  auto blurPass = graph.AddPass( L"Blur bloom", [ this ]( CommandList& commandList, RenderGraph& renderGraph )
+  {
+    auto& source = renderGraph.GetResource( bloomTextures[ 4 ][ 0 ] );
+    auto& target = renderGraph.GetResource( bloomTextures[ 4 ][ 1 ] );
 
     struct
     {
@@ -1551,58 +1837,62 @@ void Scene::PostProcessing( CommandList& commandList, Resource& backBuffer )
       float invOutputHeight;
     } blurParams;
 
-    blurParams.invOutputWidth  = 1.0f / bloomTextures[ 4 ][ 0 ]->GetTextureWidth();
-    blurParams.invOutputHeight = 1.0f / bloomTextures[ 4 ][ 0 ]->GetTextureHeight();
+    blurParams.invOutputWidth  = 1.0f / source.GetTextureWidth();
+    blurParams.invOutputHeight = 1.0f / source.GetTextureHeight();
 
     commandList.SetComputeShader( *blurBloomShader );
     commandList.SetComputeConstantValues( 0, blurParams, 0 );
-    commandList.SetComputeShaderResourceView( 1, *bloomTextures[ 4 ][ 0 ] );
-    commandList.SetComputeUnorderedAccessView( 2, *bloomTextures[ 4 ][ 1 ] );
-    commandList.Dispatch( ( bloomTextures[ 4 ][ 0 ]->GetTextureWidth () + ExtractBloomKernelWidth - 1  ) / ExtractBloomKernelWidth
-                        , ( bloomTextures[ 4 ][ 0 ]->GetTextureHeight() + ExtractBloomKernelHeight - 1 ) / ExtractBloomKernelHeight
+    commandList.SetComputeShaderResourceView( 1, source );
+    commandList.SetComputeUnorderedAccessView( 2, target );
+    commandList.Dispatch( ( source.GetTextureWidth () + ExtractBloomKernelWidth - 1  ) / ExtractBloomKernelWidth
+                        , ( source.GetTextureHeight() + ExtractBloomKernelHeight - 1 ) / ExtractBloomKernelHeight
                         , 1 );
 
-    commandList.AddUAVBarrier( { *bloomTextures[ 4 ][ 1 ] } );
-  }
+    commandList.AddUAVBarrier( { target } );
+  } );
+
+  graph.Use( blurPass, bloomTextures[ 4 ][ 0 ], shaderInput );
+  graph.Use( blurPass, bloomTextures[ 4 ][ 1 ], ResourceStateBits::UnorderedAccess );
 
   for ( int us = 0; us < 4; ++us )
   {
-    GPUSection gpuSection( commandList, L"Upsample blur bloom" );
+    auto upsamplePass = graph.AddPass( L"Upsample blur bloom", [ this, us ]( CommandList& commandList, RenderGraph& renderGraph )
+    {
+      auto& source = renderGraph.GetResource( bloomTextures[ 3 - us ][ 0 ] );
+      auto& lower  = renderGraph.GetResource( bloomTextures[ 4 - us ][ 1 ] );
+      auto& target = renderGraph.GetResource( bloomTextures[ 3 - us ][ 1 ] );
 
-    commandList.ChangeResourceState( *bloomTextures[ 3 - us ][ 0 ], ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput );
-    commandList.ChangeResourceState( *bloomTextures[ 4 - us ][ 1 ], ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput );
-    commandList.ChangeResourceState( *bloomTextures[ 3 - us ][ 1 ], ResourceStateBits::UnorderedAccess );
+      struct
+      {
+        float invOutputWidth;
+        float invOutputHeight;
+        float upsampleBlendFactor;
+      } upsampleParams;
+
+      upsampleParams.invOutputWidth      = 1.0f / source.GetTextureWidth();
+      upsampleParams.invOutputHeight     = 1.0f / source.GetTextureHeight();
+      upsampleParams.upsampleBlendFactor = 0.65f;
+
+      commandList.SetComputeShader( *upsampleBlurBloomShader );
+      commandList.SetComputeConstantValues( 0, upsampleParams, 0 );
+      commandList.SetComputeShaderResourceView( 1, source );
+      commandList.SetComputeShaderResourceView( 2, lower );
+      commandList.SetComputeUnorderedAccessView( 3, target );
+      commandList.Dispatch( ( source.GetTextureWidth () + ExtractBloomKernelWidth - 1  ) / ExtractBloomKernelWidth
+                          , ( source.GetTextureHeight() + ExtractBloomKernelHeight - 1 ) / ExtractBloomKernelHeight
+                          , 1 );
 
-    struct
-    {
-      float invOutputWidth;
-      float invOutputHeight;
-      float upsampleBlendFactor;
-    } upsampleParams;
-
-    upsampleParams.invOutputWidth      = 1.0f / bloomTextures[ 3 - us ][ 0 ]->GetTextureWidth();
-    upsampleParams.invOutputHeight     = 1.0f / bloomTextures[ 3 - us ][ 0 ]->GetTextureHeight();
-    upsampleParams.upsampleBlendFactor = 0.65f;
-
-    commandList.SetComputeShader( *upsampleBlurBloomShader );
-    commandList.SetComputeConstantValues( 0, upsampleParams, 0 );
-    commandList.SetComputeShaderResourceView( 1, *bloomTextures[ 3 - us ][ 0 ] );
-    commandList.SetComputeShaderResourceView( 2, *bloomTextures[ 4 - us ][ 1 ] );
-    commandList.SetComputeUnorderedAccessView( 3, *bloomTextures[ 3 - us ][ 1 ] );
-    commandList.Dispatch( ( bloomTextures[ 3 - us ][ 0 ]->GetTextureWidth () + ExtractBloomKernelWidth - 1  ) / ExtractBloomKernelWidth
-                        , ( bloomTextures[ 3 - us ][ 0 ]->GetTextureHeight() + ExtractBloomKernelHeight - 1 ) / ExtractBloomKernelHeight
-                        , 1 );
+      commandList.AddUAVBarrier( { target } );
+    } );
 
-    commandList.AddUAVBarrier( { *bloomTextures[ 3 - us ][ 1 ] } );
+    graph.Use( upsamplePass, bloomTextures[ 3 - us ][ 0 ], shaderInput );
+    graph.Use( upsamplePass, bloomTextures[ 4 - us ][ 1 ], shaderInput );
+    graph.Use( upsamplePass, bloomTextures[ 3 - us ][ 1 ], ResourceStateBits::UnorderedAccess );
   }
 
+  auto toneMappingPass = graph.AddPass( L"ToneMapping", [ this, hqColor ]( CommandList& commandList, RenderGraph& renderGraph )
   {
-    GPUSection gpuSection( commandList, L"ToneMapping" );
-
-    commandList.ChangeResourceState( { { *exposureBuffer, ResourceStateBits::VertexOrConstantBuffer }
-                                     , { *hqColorTexture, ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
-                                     , { *bloomTextures[ 0 ][ 1 ], ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput }
-                                     , { backBuffer, ResourceStateBits::RenderTarget } } );
+    auto& backBuffer = renderGraph.GetResource( backBufferHandle );
 
     struct
     {
@@ -1621,10 +1911,27 @@ void Scene::PostProcessing( CommandList& commandList, Resource& backBuffer )
     commandList.SetPrimitiveType( PrimitiveType::TriangleList );
     commandList.SetConstantValues( 0, toneMappingParams, 0 );
     commandList.SetConstantBuffer( 1, *exposureBuffer );
-    commandList.SetShaderResourceView( 2, *hqColorTexture );
-    commandList.SetShaderResourceView( 3, *bloomTextures[ 0 ][ 1 ] );
+    commandList.SetShaderResourceView( 2, renderGraph.GetResource( hqColor ) );
+    commandList.SetShaderResourceView( 3, renderGraph.GetResource( bloomTextures[ 0 ][ 1 ] ) );
     commandList.Draw( 3 );
-  }
+  } );
+
+  graph.Use( toneMappingPass, exposure, ResourceStateBits::VertexOrConstantBuffer );
+  graph.Use( toneMappingPass, hqColor, shaderInput );
+  graph.Use( toneMappingPass, bloomTextures[ 0 ][ 1 ], shaderInput );
+  graph.Use( toneMappingPass, backBufferHandle, ResourceStateBits::RenderTarget );
+
+  graph.Compile( [ &device ]( int width, int height, PixelFormat format )
+  {
+    return device.GetPlaced2DTextureSize( width, height, format );
+  } );
+  graph.Realize( device );
+}
+
+void Scene::PostProcessing( CommandList& commandList, Resource& backBuffer )
+{
+  postProcessGraph->SetImportedResource( backBufferHandle, backBuffer );
+  postProcessGraph->Execute( commandList );
 }
 
 void Scene::AdaptExposure( CommandList& commandList )
@@ -1644,8 +1951,7 @@ void Scene::AdaptExposure( CommandList& commandList )
       GPUSection gpuSection( commandList, L"Clear histogram" );
 
       uint32_t zeroes[ 256 ] = { 0 };
-      auto clearHistoUpload = RenderManager::GetInstance().GetUploadBufferForResource( *histogramBuffer );
-      commandList.UploadBufferResource( eastl::move( clearHistoUpload ), *histogramBuffer, zeroes, sizeof( zeroes ) );
+      commandList.UploadBufferResource( *histogramBuffer, zeroes, sizeof( zeroes ) );
     }
 
     {
@@ -1769,13 +2075,21 @@ void Scene::RenderDebugLayer( CommandList& commandList, DebugOutput debugOutput
   commandList.Draw( 4 );
 }
 
-void Scene::Render( CommandAllocator& commandAllocator
-                  , CommandList& commandList
-                  , Resource& backBuffer
-                  , bool useTextureFeedback
-                  , bool freezeCulling
-                  , DebugOutput debugOutput )
+ParallelCommandRecorder::RecordedLists Scene::Render( CommandAllocator*& commandAllocator
+                                                     , eastl::unique_ptr< CommandList >& commandList
+                                                     , eastl::initializer_list< GPUSection* > openSections
+                                                     , Resource& backBuffer
+                                                     , bool useTextureFeedback
+                                                     , bool freezeCulling
+                                                     , DebugOutput debugOutput )
 {
+  if ( !IsRenderable() )
+  {
+    commandList->ChangeResourceState( backBuffer, ResourceStateBits::RenderTarget );
+    commandList->ClearRenderTarget( backBuffer, Color() );
+    return {};
+  }
+
   auto& renderManager = RenderManager::GetInstance();
   auto& device        = renderManager.GetDevice();
 
@@ -1785,72 +2099,292 @@ void Scene::Render( CommandAllocator& commandAllocator
   if ( upscaling )
     jitter = upscaling->GetJitter();
 
-  GPUSection gpuSection( commandList, L"Render scene" );
+  CPUSection cpuSection( L"Record scene" );
+  GPUSection gpuSection( *commandList, L"Render scene" );
+
+  UpdateFullTransforms();
+  UploadChangedNodes( *commandList );
+  UpdateRTScene( *commandList );
 
-  CullScene( commandList, jitter.x, jitter.y, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight(), useTextureFeedback, freezeCulling );
+  CullScene( *commandList, jitter.x, jitter.y, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight(), useTextureFeedback, freezeCulling );
 
   // For the very fist frame, we run culling twice. This is because in culling, we are using prev frame VP transform for culling. So with the
   // first run, we make the current frame matrix, and copy it to prev in the next one.
   if ( frameCounter == 0 )
-    CullScene( commandList, jitter.x, jitter.y, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight(), useTextureFeedback, freezeCulling );
-
-  RenderSkyToCube( commandList );
-  ClearTexturesAndPrepareRendering( commandList, renderTarget );
-
-  commandList.SetViewport( 0, 0, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight() );
-  commandList.SetScissor( 0, 0, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight() );
-
-  RenderDepth( commandList );
-  RenderShadow( commandList );
-  RenderGI( commandList );
-  RenderAO( commandList );
-  RenderReflection( commandList );
-  Denoise( commandAllocator, commandList, jitter.x, jitter.y, debugOutput == DebugOutput::Denoiser );
-  commandList.SetRenderTarget( renderTarget, nullptr );
-  RenderDirectLighting( commandList );
-  commandList.SetRenderTarget( renderTarget, depthTexture.get() );
-  RenderSky( commandList );
-  RenderTranslucent( commandList );
-  Upscale( commandList, backBuffer );
-  PostProcessing( commandList, backBuffer );
-  AdaptExposure( commandList );
-
-  RenderDebugLayer( commandList, debugOutput );
+    CullScene( *commandList, jitter.x, jitter.y, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight(), useTextureFeedback, freezeCulling );
+
+  RenderSkyToCube( *commandList );
+  ClearTexturesAndPrepareRendering( *commandList, renderTarget );
+
+  commandList->SetViewport( 0, 0, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight() );
+  commandList->SetScissor( 0, 0, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight() );
+
+  // Draw what was visible last frame, then retest the rest against the new depth and draw what became visible
+  RenderDepth( *commandList, false );
+  BuildHiZ( *commandList );
+  CullSceneLate( *commandList, freezeCulling );
+  RenderDepth( *commandList, true );
+
+  PrepareRayTracedPasses( *commandList );
+  gpuSection.Close();
+
+  passRecorder.AddPass( L"Render shadow", [ this ]( CommandList& passList ) { RenderShadow( passList ); } );
+  passRecorder.AddPass( L"Render global illumination", [ this ]( CommandList& passList ) { RenderGI( passList ); } );
+  #if USE_AO_WITH_GI
+    passRecorder.AddPass( L"Render ambient occlusion", [ this ]( CommandList& passList ) { RenderAO( passList ); } );
+  #endif
+  passRecorder.AddPass( L"Render reflection", [ this ]( CommandList& passList ) { RenderReflection( passList ); } );
+
+  auto recordedLists = passRecorder.Record( CommandQueueType::Direct );
+
+  for ( auto section = openSections.end(); section != openSections.begin(); )
+    ( *--section )->Suspend();
+
+  recordedLists.emplace( recordedLists.begin(), eastl::move( commandList ), commandAllocator );
+
+  commandAllocator = renderManager.RequestCommandAllocator( CommandQueueType::Direct );
+  commandList      = renderManager.CreateCommandList( *commandAllocator, CommandQueueType::Direct );
+
+  // The timestamps of the sections are taken on the same queue, so they cover the ray traced lists too.
+  for ( auto section : openSections )
+    section->Continue( *commandList );
+
+  GPUSection gpuContinuedSection( *commandList, L"Render scene" );
+
+  commandList->SetViewport( 0, 0, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight() );
+  commandList->SetScissor( 0, 0, renderTarget.GetTextureWidth(), renderTarget.GetTextureHeight() );
+
+  Denoise( *commandAllocator, *commandList, jitter.x, jitter.y, debugOutput == DebugOutput::Denoiser );
+  commandList->SetRenderTarget( renderTarget, nullptr );
+  RenderDirectLighting( *commandList );
+  commandList->SetRenderTarget( renderTarget, depthTexture.get() );
+  RenderSky( *commandList );
+  RenderTranslucent( *commandList );
+  Upscale( *commandList, backBuffer );
+  PostProcessing( *commandList, backBuffer );
+  AdaptExposure( *commandList );
+
+  RenderDebugLayer( *commandList, debugOutput );
 
   ++frameCounter;
+
+  return recordedLists;
+}
+
+const eastl::vector< ParallelCommandRecorder::PassTiming >& Scene::GetPassRecordTimings() const
+{
+  return passRecorder.GetTimings();
+}
+
+Node* Scene::FindNodeByName( const char* name )
+{
+  return nodeNameIndex->Find( name );
+}
+
+void Scene::FindNodesByPrefix( const char* prefix, eastl::vector< Node* >& nodes )
+{
+  nodeNameIndex->FindByPrefix( prefix, nodes );
+}
+
+void Scene::FindNodesByPattern( const char* pattern, eastl::vector< Node* >& nodes )
+{
+  nodeNameIndex->FindByPattern( pattern, nodes );
+}
+
+void Scene::UpdateFullTransforms()
+{
+  // movedNodes is only cleared when the RT scene is updated, the BVH only needs the nodes moved now, when it is queried.
+  int firstMovedNode = int( movedNodes.size() );
+  sceneStore->UpdateWorldTransforms( &movedNodes );
+  unfittedNodes.insert( movedNodes.begin() + firstMovedNode, movedNodes.end() );
+}
+
+void Scene::RefitInstanceBVH()
+{
+  if ( unfittedNodes.empty() )
+    return;
+
+  instanceBVH->Refit( *sceneStore, unfittedNodes.data(), int( unfittedNodes.size() ) );
+  unfittedNodes.clear();
+}
+
+void Scene::CullOnCPU( FXMMATRIX viewProjection, eastl::vector< uint8_t >& visibility ) const
+{
+  CullMeshSlots( *sceneStore, viewProjection, visibility );
+}
+
+CPUCullingStats Scene::CullCameraViewOnCPU()
+{
+  CPUSection cpuSection( L"CPU culling" );
+
+  auto viewProjection = GetCameraViewProjection();
+
+  CPUCullingStats stats;
+
+  {
+    CPUSection frustumSection( L"CPU frustum culling" );
+
+    auto startTime = GetCPUTime();
+    CullOnCPU( viewProjection, cpuVisibility );
+    stats.frustumMs = ( GetCPUTime() - startTime ) * 1000;
+  }
+
+  stats.meshSlots      = int( cpuVisibility.size() );
+  stats.frustumVisible = int( eastl::count( cpuVisibility.begin(), cpuVisibility.end(), uint8_t( 1 ) ) );
+
+  if ( occlusionCuller->HasOccluders() )
+  {
+    CPUSection occlusionSection( L"CPU occlusion culling" );
+
+    CullOcclusionOnCPU( viewProjection, cpuVisibility );
+
+    auto& occlusionStats = occlusionCuller->GetStats();
+    stats.occlusionCulled = occlusionStats.culledInstances;
+    stats.occlusionMs     = ( occlusionStats.rasterTime + occlusionStats.testTime ) * 1000;
+  }
+
+  {
+    CPUSection bvhSection( L"CPU BVH frustum query" );
+
+    auto startTime = GetCPUTime();
+    cpuBVHMeshSlots.clear();
+    QueryMeshSlotsInFrustum( viewProjection, cpuBVHMeshSlots );
+    stats.bvhMs = ( GetCPUTime() - startTime ) * 1000;
+  }
+
+  stats.bvhCandidates = int( cpuBVHMeshSlots.size() );
+
+  return stats;
 }
 
-static Node* FindNodeByName( const char* name, Node& node )
+XMMATRIX Scene::GetCameraViewProjection()
 {
-  if ( strcmp( node.GetName(), name ) == 0 )
-    return &node;
+  auto cameraView = XMMatrixInverse( nullptr, cameraNode->GetTransform() );
 
-  Node* result = nullptr;
-  node.ForEachNode( [&]( Node& childNode ) mutable
+  XMMATRIX cameraProj;
+  cameraNode->ForEachCamera( [ &cameraProj ]( const Camera& camera )
   {
-    result = FindNodeByName( name, childNode );
-    return !result;
+    cameraProj = camera.GetProjTransform();
+    return false;
   } );
 
-  return result;
+  return XMMatrixMultiply( cameraView, cameraProj );
 }
 
-Node* Scene::FindNodeByName( const char* name )
+void Scene::CullOcclusionOnCPU( FXMMATRIX viewProjection, eastl::vector< uint8_t >& visibility )
 {
-  return ::FindNodeByName( name, *rootNode );
+  occlusionCuller->RenderOccluders( *sceneStore, viewProjection );
+  occlusionCuller->CullMeshSlots( *sceneStore, visibility );
 }
 
-void Scene::OnNodeTransformChanged( CommandList& commandList, const Node& node )
+const OcclusionCuller& Scene::GetOcclusionCuller() const
 {
-  auto& manager = RenderManager::GetInstance();
+  return *occlusionCuller;
+}
+
+void Scene::QueryMeshSlotsInFrustum( FXMMATRIX viewProjection, eastl::vector< int >& meshSlots )
+{
+  RefitInstanceBVH();
+  instanceBVH->QueryFrustum( viewProjection, meshSlots );
+}
+
+void Scene::QueryMeshSlotsInSphere( FXMVECTOR center, float radius, eastl::vector< int >& meshSlots )
+{
+  RefitInstanceBVH();
+  instanceBVH->QuerySphere( center, radius, meshSlots );
+}
+
+void Scene::UpdateRTScene( CommandList& commandList )
+{
+  if ( movedNodes.empty() )
+    return;
+
+  auto& nodeSlots = sceneStore->GetNodeSlots();
+
+  // The RT instances are created in mesh slot order, so the instance index is the mesh slot index.
+  eastl::vector< RTInstanceTransform > transforms;
+  for ( int nodeIx : movedNodes )
+  {
+    int meshSlotCount = sceneStore->GetMeshSlotCount( nodeIx );
+    if ( meshSlotCount == 0 )
+      continue;
+
+    XMFLOAT4X4 nodeTransform;
+    XMStoreFloat4x4( &nodeTransform, sceneStore->GetWorldTransform( nodeIx ) );
+
+    int firstMeshSlot = int( nodeSlots[ nodeIx ].firstMeshSlot );
+    for ( int meshSlot = firstMeshSlot; meshSlot < firstMeshSlot + meshSlotCount; meshSlot++ )
+      transforms.push_back( { meshSlot, nodeTransform } );
+  }
+
+  movedNodes.clear();
+
+  tlas->UpdateTransforms( RenderManager::GetInstance().GetDevice(), commandList, transforms );
+}
+
+void Scene::OnNodeTransformChanged( const Node& node )
+{
+  auto nodeIndex = sceneStore->GetNodeIndex( node );
+  assert( nodeIndex >= 0 );
+
+  sceneStore->SetLocalTransform( nodeIndex, node.GetTransform() );
+  changedNodes.insert( nodeIndex );
+}
+
+Node* Scene::GetCameraNode() const
+{
+  return cameraNode;
+}
+
+XMMATRIX Scene::GetNodeWorldTransform( const Node& node ) const
+{
+  auto nodeIndex = sceneStore ? sceneStore->GetNodeIndex( node ) : -1;
+  return nodeIndex >= 0 ? sceneStore->GetWorldTransform( nodeIndex ) : node.GetFullTransform();
+}
+
+void Scene::SetNodeWorldTransform( Node& node, FXMMATRIX worldTransform )
+{
+  auto nodeIndex = sceneStore->GetNodeIndex( node );
+  assert( nodeIndex >= 0 );
+
+  // Most nodes hang from an unmoved root, their world transform is their local one.
+  auto parentIndex     = sceneStore->GetParentIndex( nodeIndex );
+  auto parentTransform = parentIndex >= 0 ? sceneStore->GetWorldTransform( parentIndex ) : XMMatrixIdentity();
+
+  node.SetTransform( XMMatrixIsIdentity( parentTransform ) ? worldTransform : worldTransform * XMMatrixInverse( nullptr, parentTransform ) );
+  OnNodeTransformChanged( node );
+}
+
+void Scene::UploadChangedNodes( CommandList& commandList )
+{
+  if ( changedNodes.empty() )
+    return;
+
+  static constexpr int maxNodeGap = 4;
+
+  eastl::vector< SlotRange > ranges;
+  CoalesceSlotRanges( changedNodes, maxNodeGap, ranges );
+  changedNodes.clear();
 
-  auto nodeIter = nodeToIndex.find( &node );
-  assert( nodeIter != nodeToIndex.end() );
+  int uploadSize = 0;
+  for ( auto& range : ranges )
+    uploadSize += range.count * sizeof( NodeSlot );
 
-  auto  nodeIndex = nodeIter->second;
-  auto& nodeSlot  = nodeSlots[ nodeIndex ];
+  auto& nodeSlots = sceneStore->GetNodeSlots();
+  auto  upload    = commandList.GetUploadAllocator().Allocate( uploadSize, 16 );
 
-  XMStoreFloat4x4( &nodeSlot.worldTransform, node.GetTransform() );
+  int uploadOffset = 0;
+  for ( auto& range : ranges )
+  {
+    memcpy( upload.cpuAddress + uploadOffset, &nodeSlots[ range.first ], range.count * sizeof( NodeSlot ) );
+    uploadOffset += range.count * sizeof( NodeSlot );
+  }
 
-  commandList.UpdateBufferRegion( CreateBufferFromData( &nodeSlot, 1, ResourceType::Buffer, manager.GetDevice(), commandList, L"nodeChange" ), *nodeBuffer, sizeof( NodeSlot ) * nodeIndex );
+  // CopyBufferRegion moves the node buffer to the copy destination state and back itself.
+  uploadOffset = 0;
+  for ( auto& range : ranges )
+  {
+    commandList.CopyBufferRegion( *upload.resource, upload.offset + uploadOffset, *nodeBuffer, range.first * sizeof( NodeSlot ), range.count * sizeof( NodeSlot ) );
+    uploadOffset += range.count * sizeof( NodeSlot );
+  }
 }
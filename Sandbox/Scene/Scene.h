@@ -1,50 +1,112 @@
 #pragma once
 
 #include "Render/Upscaling.h"
+#include "Render/ShaderValues.h"
+#include "Render/ParallelCommandRecorder.h"
+#include "Scene/FrustumCulling.h"
 
 class Mesh;
 class Node;
+class SceneStore;
+class NodeNameIndex;
+class InstanceBVH;
+class OcclusionCuller;
+class RenderGraph;
+class SceneLoader;
+class WorldPartition;
+class WorldStreamer;
 struct RTInstance;
 struct RTShaders;
 struct CommandList;
 struct Resource;
 struct ComputeShader;
-struct NodeSlot;
-struct MeshSlot;
-struct CameraSlot;
 struct LightSlot;
 struct RTTopLevelAccelerator;
 struct PipelineState;
 struct CommandSignature;
 struct CommandAllocator;
+struct GPUSection;
 struct Denoiser;
+struct MaterialSlot;
+struct aiScene;
 
 enum class DebugOutput : uint32_t;
 
 class Scene
 {
 public:
+  // The scene file is loaded on worker threads, call UpdateLoading every frame to stream its meshes in and out.
   Scene( CommandList& commandList, const wchar_t* hostFolder, int screenWidth, int screenHeight );
   ~Scene();
 
+  // Streams the cells of the world around the camera. Uploads the meshes converted since the last call, as much as
+  // fits the per frame budget, evicts the ones no cell needs anymore, and rebuilds the scene buffers and the TLAS
+  // with them. Only the meshes are streamed, the materials and their textures are all loaded with the scene layout,
+  // so evictions recycle the vertex and index buffer slots but never the texture slots. Errors of the load are
+  // reported through GetError.
+  void UpdateLoading( CommandList& commandList );
+
+  // Blocks until the cells around the camera, as many as the memory budget allows, are resident.
+  void FinishLoading( CommandList& commandList );
+
+  // False until the first meshes are resident, Render only clears the back buffer until then.
+  bool IsRenderable() const;
+
   void SetManualExposure( float exposure );
 
   void TearDown( CommandList* commandList );
 
-  void Render( CommandAllocator& commandAllocator
-             , CommandList& commandList
-             , Resource& backBuffer
-             , bool useTextureFeedback
-             , bool freezeCulling
-             , DebugOutput debugOutput );
+  // The ray traced passes are recorded in parallel into lists of their own. The lists to submit before
+  // commandList are returned in order, and commandList and its allocator are replaced with new ones.
+  // The sections open around the call, outermost first, are moved over to the new list.
+  ParallelCommandRecorder::RecordedLists Render( CommandAllocator*& commandAllocator
+                                               , eastl::unique_ptr< CommandList >& commandList
+                                               , eastl::initializer_list< GPUSection* > openSections
+                                               , Resource& backBuffer
+                                               , bool useTextureFeedback
+                                               , bool freezeCulling
+                                               , DebugOutput debugOutput );
+
+  const eastl::vector< ParallelCommandRecorder::PassTiming >& GetPassRecordTimings() const;
 
   Node* FindNodeByName( const char* name );
+  void  FindNodesByPrefix( const char* prefix, eastl::vector< Node* >& nodes );
+  void  FindNodesByPattern( const char* pattern, eastl::vector< Node* >& nodes );
+
+  void OnNodeTransformChanged( const Node& node );
+
+  // The node named Camera the view is rendered from, looked up once when the layout of the scene is published.
+  Node* GetCameraNode() const;
+
+  // Read from the SceneStore, only the nodes not built into it yet compose theirs from their ancestors.
+  XMMATRIX GetNodeWorldTransform( const Node& node ) const;
+
+  // Sets the local transform which puts the node at worldTransform, and calls OnNodeTransformChanged.
+  void SetNodeWorldTransform( Node& node, FXMMATRIX worldTransform );
+
+  void UpdateFullTransforms();
+
+  // Frustum culls the mesh slots on the CPU, with the same test the GPU culling uses. See CullMeshSlots.
+  void CullOnCPU( FXMMATRIX viewProjection, eastl::vector< uint8_t >& visibility ) const;
+
+  // Culls the view of the camera, without the jitter, with CullOnCPU and CullOcclusionOnCPU, and queries the BVH.
+  CPUCullingStats CullCameraViewOnCPU();
+
+  // Rasterizes the occluders, then clears the visibility of the mesh slots hidden behind them.
+  // Meant to run on the result of CullOnCPU, with the same view projection.
+  void CullOcclusionOnCPU( FXMMATRIX viewProjection, eastl::vector< uint8_t >& visibility );
+
+  const OcclusionCuller& GetOcclusionCuller() const;
 
-  void OnNodeTransformChanged( CommandList& commandList, const Node& node );
+  // Collects the mesh slots overlapping the frustum or the sphere, using the instance BVH.
+  // The BVH is refit to the nodes moved since the previous query first.
+  void QueryMeshSlotsInFrustum( FXMMATRIX viewProjection, eastl::vector< int >& meshSlots );
+  void QueryMeshSlotsInSphere( FXMVECTOR center, float radius, eastl::vector< int >& meshSlots );
 
   const eastl::wstring& GetError() const;
 
-  void TearDownSceneBuffers( CommandList& commandList );
+  // Without a command list, the buffers are released right away, so the GPU has to be idle.
+  void TearDownSceneBuffers( CommandList* commandList );
   void TearDownScreenSizeDependantTextures( CommandList& commandList );
 
   void OnScreenResize( CommandList& commandList, int width, int height );
@@ -53,17 +115,32 @@ public:
   void SetUpscalingQuality( CommandList& commandList, int width, int height, Upscaling::Quality quality );
 
 private:
+  void StepLoading( CommandList& commandList, size_t uploadBudget, bool rebuildPeriodically );
+  void PublishSceneLayout( CommandList& commandList, const aiScene& importedScene );
+  void PublishMeshes( CommandList& commandList, const aiScene& importedScene, size_t uploadBudget );
+  void SetUpOccluders( const aiScene& importedScene );
+  void RebuildResidentScene( CommandList& commandList );
+
+  XMMATRIX GetCameraViewProjection();
+  void     RefitInstanceBVH();
+
   void BuildSceneBuffers( CommandList& commandList );
+  void UploadChangedNodes( CommandList& commandList );
+  void UpdateRTScene( CommandList& commandList );
 
   void RecreateScrenSizeDependantTextures( CommandList& commandList, int width, int height );
   void CreateBRDFLUTTexture( CommandList& commandList );
+  void CreateSamplingTextures( CommandList& commandList );
 
   void SetupTriangleBuffers( CommandList& commandList, bool compute );
 
   void CullScene( CommandList& commandList, float jitterX, float jitterY, int targetWidth, int targetHeight, bool useTextureFeedback, bool freezeCulling );
+  void CullSceneLate( CommandList& commandList, bool freezeCulling );
   void ClearTexturesAndPrepareRendering( CommandList& commandList, Resource& renderTarget );
   void RenderSkyToCube( CommandList& commandList );
-  void RenderDepth( CommandList& commandList );
+  void RenderDepth( CommandList& commandList, bool latePass );
+  void BuildHiZ( CommandList& commandList );
+  void PrepareRayTracedPasses( CommandList& commandList );
   void RenderShadow( CommandList& commandList );
   void RenderAO( CommandList& commandList );
   void RenderGI( CommandList& commandList );
@@ -72,6 +149,7 @@ private:
   void RenderDirectLighting( CommandList& commandList );
   void RenderTranslucent( CommandList& commandList );
   void RenderSky( CommandList& commandList );
+  void BuildPostProcessGraph( int bloomWidth, int bloomHeight );
   void PostProcessing( CommandList& commandList, Resource& backBuffer );
   void AdaptExposure( CommandList& commandList );
   void Upscale( CommandList& commandList, Resource& backBuffer );
@@ -79,11 +157,29 @@ private:
 
   eastl::wstring error;
 
-  eastl::vector< NodeSlot   > nodeSlots;
-  eastl::vector< MeshSlot   > meshSlots;
-  eastl::vector< CameraSlot > cameraSlots;
-  eastl::vector< LightSlot  > lightSlots;
-  eastl::vector< uint32_t   > rootNodeChildrenIndices;
+  eastl::unique_ptr< SceneLoader >    loader;
+  eastl::unique_ptr< WorldPartition > worldPartition;
+  eastl::unique_ptr< WorldStreamer >  worldStreamer;
+
+  // The cells are streamed around this camera.
+  Node* streamingCameraNode = nullptr;
+  Node* cameraNode          = nullptr;
+
+  // Still in the scene buffers and the TLAS, they are released with the next rebuild.
+  eastl::vector< int > evictedMeshes;
+
+  eastl::wstring hostFolder;
+  int            screenWidth;
+  int            screenHeight;
+
+  // Meshes made resident since the scene buffers and the TLAS were last rebuilt.
+  int meshesSinceRebuild = 0;
+  int framesSinceRebuild = 0;
+
+  eastl::vector< LightSlot > lightSlots;
+
+  eastl::vector< MaterialSlot > materialSlots;
+  eastl::vector< bool >         occluderMaterials;
 
   eastl::vector< eastl::unique_ptr< Mesh > > meshes;
 
@@ -104,12 +200,18 @@ private:
   eastl::unique_ptr< Resource > indirectOpaqueTwoSidedAlphaTestedDrawBuffer;
   eastl::unique_ptr< Resource > indirectTranslucentDrawBuffer;
   eastl::unique_ptr< Resource > indirectTranslucentTwoSidedDrawBuffer;
+  eastl::unique_ptr< Resource > indirectLateOpaqueDrawBuffer;
+  eastl::unique_ptr< Resource > indirectLateOpaqueTwoSidedDrawBuffer;
+  eastl::unique_ptr< Resource > indirectLateOpaqueAlphaTestedDrawBuffer;
+  eastl::unique_ptr< Resource > indirectLateOpaqueTwoSidedAlphaTestedDrawBuffer;
+  eastl::unique_ptr< Resource > occlusionCandidateBuffer;
   eastl::unique_ptr< Resource > indirectDrawCountBuffer;
   eastl::unique_ptr< Resource > modelMetaBuffer;
 
   eastl::unique_ptr< Resource > lqColorTexture;
   eastl::unique_ptr< Resource > hqColorTexture;
   eastl::unique_ptr< Resource > depthTexture;
+  eastl::unique_ptr< Resource > hiZTextures[ HiZLevelCount ];
 
   eastl::unique_ptr< Resource > aoTexture;
   eastl::unique_ptr< Resource > reflectionTexture;
@@ -123,7 +225,6 @@ private:
   eastl::unique_ptr< Resource > exposureBuffer;
   eastl::unique_ptr< Resource > exposureOnlyBuffer;
 
-  eastl::unique_ptr< Resource > bloomTextures[ 5 ][ 2 ];
   eastl::unique_ptr< Resource > lumaTexture;
   eastl::unique_ptr< Resource > histogramBuffer;
 
@@ -140,6 +241,8 @@ private:
 
   eastl::unique_ptr< ComputeShader > prepareCullingShader;
   eastl::unique_ptr< ComputeShader > cullingShader;
+  eastl::unique_ptr< ComputeShader > cullingLateShader;
+  eastl::unique_ptr< ComputeShader > hiZBuildShader;
   eastl::unique_ptr< ComputeShader > specBRDFLUTShader;
 
   eastl::unique_ptr< ComputeShader > blurShader;
@@ -163,8 +266,17 @@ private:
 
   eastl::unique_ptr< Node > rootNode;
 
-  eastl::vector_map< const Node*, int > nodeToIndex;
-  eastl::vector_map< int, const Node* > indexToNode;
+  eastl::unique_ptr< SceneStore >      sceneStore;
+  eastl::unique_ptr< NodeNameIndex >   nodeNameIndex;
+  eastl::unique_ptr< InstanceBVH >     instanceBVH;
+  eastl::unique_ptr< OcclusionCuller > occlusionCuller;
+
+  eastl::vector< uint8_t > cpuVisibility;
+  eastl::vector< int >     cpuBVHMeshSlots;
+
+  eastl::vector_set< int > changedNodes;
+  eastl::vector< int >     movedNodes;
+  eastl::vector_set< int > unfittedNodes;
 
   eastl::unique_ptr< Denoiser > denoiser;
 
@@ -177,9 +289,17 @@ private:
   eastl::unique_ptr< Upscaling > upscaling;
   Upscaling::Quality           upscalingQuality = Upscaling::DefaultQuality;
 
+  // The bloom textures are transients in the post process graph, these are their handles.
+  eastl::unique_ptr< RenderGraph > postProcessGraph;
+  int                              bloomTextures[ 5 ][ 2 ];
+  int                              backBufferHandle;
+
+  ParallelCommandRecorder passRecorder;
+
   uint32_t frameCounter = 0;
 
-  int cameraNodeIndex = -1;
+  // Cleared when the pyramid is recreated, the early culling pass only uses it after it was built once.
+  bool hiZValid = false;
 
   int instanceCount = 0;
 
@@ -191,6 +311,5 @@ private:
   float bloomThreshold;
   float bloomStrength;
 
-  void MarshallSceneToGPU( Node& sceneNode, int& instanceCount, Scene& scene );
-  void MarshallSceneToRTInstances( Node& sceneNode, eastl::vector< RTInstance >& rtInstances, Scene& scene );
+  void MarshallSceneToRTInstances( eastl::vector< RTInstance >& rtInstances );
 };
@@ -0,0 +1,375 @@
+#include "SceneLoader.h"
+#include "Common/ParallelFor.h"
+
+#include "assimp/inc/assimp/Importer.hpp"
+#include "assimp/inc/assimp/scene.h"
+#include "assimp/inc/assimp/postprocess.h"
+
+// The requests of a frame are small, even a few meshes are worth a thread.
+static constexpr int minMeshesPerRange = 4;
+
+static bool Validate( aiMesh* mesh, unsigned meshIx, eastl::wstring& error )
+{
+  aiString    meshName = mesh->mName;
+  const char* meshNameC = meshName.C_Str();
+  if ( !mesh->HasPositions() )
+  {
+    error = L"Mesh (" + eastl::to_wstring( meshIx ) + L") has no positions: " + W( meshNameC );
+    return false;
+  }
+  if ( !mesh->HasFaces() )
+  {
+    error = L"Mesh (" + eastl::to_wstring( meshIx ) + L") has no faces: " + W( meshNameC );
+    return false;
+  }
+  if ( !mesh->HasNormals() )
+  {
+    error = L"Mesh (" + eastl::to_wstring( meshIx ) + L") has no normals: " + W( meshNameC );
+    return false;
+  }
+  if ( mesh->HasBones() )
+  {
+    error = L"Mesh (" + eastl::to_wstring( meshIx ) + L") has bones, which is not yet supported: " + W( meshNameC );
+    return false;
+  }
+
+  return true;
+}
+
+static void Compress( XMHALF4& c, const aiVector3D& u )
+{
+  Float16::Convert( &c.x, u.x );
+  Float16::Convert( &c.y, u.y );
+  Float16::Convert( &c.z, u.z );
+  Float16::Convert( &c.w, 1.0f );
+}
+
+static void Compress( XMHALF2& c, const aiVector3D& u )
+{
+  Float16::Convert( &c.x, u.x );
+  Float16::Convert( &c.y, u.y );
+}
+
+static void CollectMeshInstances( const aiScene& scene, const aiNode& node, FXMMATRIX parentTransform, eastl::vector< WorldPartition::MeshInstance >& instances )
+{
+  auto transform = XMMatrixTranspose( XMLoadFloat4x4( (const XMFLOAT4X4*)&node.mTransformation ) ) * parentTransform;
+
+  for ( unsigned meshIx = 0; meshIx < node.mNumMeshes; meshIx++ )
+  {
+    auto& aabb = scene.mMeshes[ node.mMeshes[ meshIx ] ]->mAABB;
+
+    BoundingBox localBounds;
+    BoundingBox::CreateFromPoints( localBounds, XMLoadFloat3( (const XMFLOAT3*)&aabb.mMin ), XMLoadFloat3( (const XMFLOAT3*)&aabb.mMax ) );
+
+    instances.emplace_back();
+    instances.back().meshIndex = int( node.mMeshes[ meshIx ] );
+    localBounds.Transform( instances.back().bounds, transform );
+  }
+
+  for ( unsigned childIx = 0; childIx < node.mNumChildren; childIx++ )
+    CollectMeshInstances( scene, *node.mChildren[ childIx ], transform, instances );
+}
+
+size_t SceneLoader::ConvertedMesh::GetByteSize() const
+{
+  return vertices.size() * sizeof( VertexFormat ) + indices.size() * sizeof( uint32_t );
+}
+
+eastl::wstring SceneLoader::FindSceneFile( const wchar_t* hostFolder )
+{
+  for ( auto& file : std::filesystem::directory_iterator( hostFolder ) )
+    if ( file.is_regular_file() && file.path().extension() == ".fbx" )
+      return std::filesystem::canonical( file.path() ).wstring().data();
+
+  return L"";
+}
+
+SceneLoader::SceneLoader( const wchar_t* sceneFilePath, size_t maxQueuedBytes )
+: importer      ( eastl::make_unique< Assimp::Importer >() )
+, maxQueuedBytes( maxQueuedBytes )
+{
+  worker = std::async( std::launch::async, [ this, filePath = eastl::wstring( sceneFilePath ) ]()
+  {
+    Load( filePath );
+  } );
+}
+
+SceneLoader::~SceneLoader()
+{
+  // The import itself can't be cancelled, only the conversions after it.
+  {
+    std::lock_guard< std::mutex > autoLock( queueLock );
+    cancelled = true;
+  }
+  queueChanged.notify_all();
+
+  if ( worker.valid() )
+    worker.wait();
+}
+
+SceneLoader::State SceneLoader::GetState() const
+{
+  std::lock_guard< std::mutex > autoLock( queueLock );
+  return state;
+}
+
+const eastl::wstring& SceneLoader::GetError() const
+{
+  return error;
+}
+
+const aiScene& SceneLoader::GetScene() const
+{
+  assert( scene );
+  return *scene;
+}
+
+void SceneLoader::CollectMeshInstances( eastl::vector< WorldPartition::MeshInstance >& instances ) const
+{
+  assert( scene );
+  ::CollectMeshInstances( *scene, *scene->mRootNode, XMMatrixIdentity(), instances );
+}
+
+size_t SceneLoader::GetMeshByteSize( int meshIndex ) const
+{
+  auto mesh = scene->mMeshes[ meshIndex ];
+  return mesh->mNumVertices * sizeof( VertexFormat ) + mesh->mNumFaces * 3 * sizeof( uint32_t );
+}
+
+void SceneLoader::RequestMeshes( const eastl::vector< int >& meshIndices )
+{
+  if ( meshIndices.empty() )
+    return;
+
+  {
+    std::lock_guard< std::mutex > autoLock( queueLock );
+    requestedMeshes.insert( requestedMeshes.end(), meshIndices.begin(), meshIndices.end() );
+  }
+
+  queueChanged.notify_all();
+}
+
+void SceneLoader::TakeConvertedMeshes( size_t maxBytes, eastl::vector< ConvertedMesh >& batch )
+{
+  {
+    std::lock_guard< std::mutex > autoLock( queueLock );
+
+    size_t batchBytes = 0;
+    int    takenCount = 0;
+    while ( !convertedMeshes.empty() )
+    {
+      size_t byteSize = convertedMeshes.front().GetByteSize();
+      if ( takenCount > 0 && batchBytes + byteSize > maxBytes )
+        break;
+
+      batch.emplace_back( eastl::move( convertedMeshes.front() ) );
+      convertedMeshes.pop();
+
+      batchBytes += byteSize;
+      takenCount++;
+    }
+
+    stats.queuedBytes -= batchBytes;
+    stats.takenMeshes += takenCount;
+  }
+
+  queueChanged.notify_all();
+}
+
+void SceneLoader::WaitForConvertedMeshes()
+{
+  std::unique_lock< std::mutex > autoLock( queueLock );
+  queueChanged.wait( autoLock, [ this ]()
+  {
+    return !convertedMeshes.empty()
+        || state == State::Failed
+        || ( state == State::Ready && requestedMeshes.empty() && convertingMeshes == 0 );
+  } );
+}
+
+SceneLoader::Stats SceneLoader::GetStats() const
+{
+  std::lock_guard< std::mutex > autoLock( queueLock );
+  return stats;
+}
+
+void SceneLoader::Load( eastl::wstring sceneFilePath )
+{
+  SetThreadName( GetCurrentThreadId(), (char*)"Scene loader" );
+
+  auto fail = [ this ]( eastl::wstring&& message )
+  {
+    {
+      std::lock_guard< std::mutex > autoLock( queueLock );
+      error = eastl::move( message );
+      state = State::Failed;
+    }
+    queueChanged.notify_all();
+  };
+
+  unsigned flags = aiProcess_OptimizeMeshes
+                 | aiProcess_MakeLeftHanded
+                 | aiProcess_FlipUVs
+                 | aiProcess_FlipWindingOrder
+                 | aiProcess_GenNormals
+                 | aiProcess_JoinIdenticalVertices
+                 | aiProcess_ImproveCacheLocality
+                 | aiProcess_LimitBoneWeights
+                 | aiProcess_RemoveRedundantMaterials
+                 | aiProcess_Triangulate
+                 | aiProcess_SortByPType
+                 | aiProcess_FindDegenerates
+                 | aiProcess_FindInvalidData
+                 | aiProcess_FindInstances
+                 | aiProcess_ValidateDataStructure
+                 | aiProcess_CalcTangentSpace
+                 | aiProcess_SplitLargeMeshes
+                 | aiProcess_GenBoundingBoxes;
+
+  importer->SetPropertyInteger( AI_CONFIG_PP_SLM_TRIANGLE_LIMIT, 0xFFFF / 3 );
+
+  {
+    CPUSection cpuSection( L"Import scene" );
+    importer->ReadFile( N( sceneFilePath.data() ).data(), flags );
+  }
+
+  const aiScene* importedScene = importer->GetScene();
+
+  if ( !importedScene )
+  {
+    fail( L"Failed to import file: " + sceneFilePath + L" - " + W( importer->GetErrorString() ) + L"\n" );
+    return;
+  }
+
+  if ( !importedScene->HasMeshes() )
+  {
+    fail( L"file has no meshes: " + sceneFilePath );
+    return;
+  }
+
+  for ( unsigned meshIx = 0; meshIx < importedScene->mNumMeshes; meshIx++ )
+  {
+    eastl::wstring meshError;
+    if ( !Validate( importedScene->mMeshes[ meshIx ], meshIx, meshError ) )
+    {
+      fail( eastl::move( meshError ) );
+      return;
+    }
+  }
+
+  {
+    std::lock_guard< std::mutex > autoLock( queueLock );
+    scene           = importedScene;
+    stats.meshCount = int( importedScene->mNumMeshes );
+    state           = State::Ready;
+  }
+  queueChanged.notify_all();
+
+  ConvertRequests();
+}
+
+void SceneLoader::ConvertRequests()
+{
+  eastl::vector< int > batch;
+
+  while ( true )
+  {
+    {
+      std::unique_lock< std::mutex > autoLock( queueLock );
+      queueChanged.wait( autoLock, [ this ]() { return cancelled || !requestedMeshes.empty(); } );
+      if ( cancelled )
+        return;
+
+      batch.swap( requestedMeshes );
+      convertingMeshes = int( batch.size() );
+    }
+
+    ParallelFor( int( batch.size() ), minMeshesPerRange, [ & ]( int firstRequest, int lastRequest )
+    {
+      CPUSection cpuSection( L"Convert meshes" );
+
+      for ( int requestIx = firstRequest; requestIx < lastRequest; requestIx++ )
+        if ( !ConvertMesh( batch[ requestIx ] ) )
+          return;
+    } );
+
+    batch.clear();
+  }
+}
+
+bool SceneLoader::ConvertMesh( int meshIndex )
+{
+  aiMesh* mesh = scene->mMeshes[ meshIndex ];
+
+  ConvertedMesh convertedMesh;
+  convertedMesh.meshIndex = meshIndex;
+
+  auto& vertices = convertedMesh.vertices;
+  auto& indices  = convertedMesh.indices;
+
+  vertices.reserve( mesh->mNumVertices );
+  indices.reserve( mesh->mNumFaces * 3 );
+
+  auto vMin = XMLoadFloat3( (XMFLOAT3*)&mesh->mVertices[ 0 ].x );
+  auto vMax = XMLoadFloat3( (XMFLOAT3*)&mesh->mVertices[ 0 ].x );
+
+  for ( unsigned vtxIx = 0; vtxIx < mesh->mNumVertices; vtxIx++ )
+  {
+    vertices.emplace_back();
+    auto& vtx = vertices.back();
+
+    aiVector3D v  = mesh->mVertices[ vtxIx ];
+    aiVector3D t  = mesh->mTangents ? mesh->mTangents[ vtxIx ] : aiVector3D();
+    aiVector3D b  = mesh->mBitangents ? mesh->mBitangents[ vtxIx ] : aiVector3D();
+    aiVector3D n  = mesh->mNormals[ vtxIx ];
+    aiVector3D tc = mesh->HasTextureCoords( 0 ) ? mesh->mTextureCoords[ 0 ][ vtxIx ] : aiVector3D(0);
+
+    t.Normalize();
+    b.Normalize();
+    n.Normalize();
+
+    Compress( vtx.position, v );
+    Compress( vtx.tangent, t );
+    Compress( vtx.bitangent, b );
+    Compress( vtx.normal, n );
+    Compress( vtx.texcoord, tc );
+
+    auto vPoint = XMLoadFloat3( (XMFLOAT3*)&v.x );
+    vMin = XMVectorMin( vMin, vPoint );
+    vMax = XMVectorMax( vMax, vPoint );
+  }
+
+  BoundingBox::CreateFromPoints( convertedMesh.aabb, vMin, vMax );
+
+  for ( unsigned faceIx = 0; faceIx < mesh->mNumFaces; faceIx++ )
+  {
+    auto& face = mesh->mFaces[ faceIx ];
+
+    assert( face.mNumIndices == 3 );
+
+    indices.emplace_back( uint32_t( face.mIndices[ 0 ] ) );
+    indices.emplace_back( uint32_t( face.mIndices[ 1 ] ) );
+    indices.emplace_back( uint32_t( face.mIndices[ 2 ] ) );
+  }
+
+  size_t byteSize = convertedMesh.GetByteSize();
+
+  std::unique_lock< std::mutex > autoLock( queueLock );
+
+  // A mesh is always let into an empty queue, otherwise a mesh bigger than the limit would stop the load.
+  queueChanged.wait( autoLock, [ & ]() { return cancelled || stats.queuedBytes == 0 || stats.queuedBytes + byteSize <= maxQueuedBytes; } );
+  if ( cancelled )
+    return false;
+
+  convertedMeshes.emplace( eastl::move( convertedMesh ) );
+
+  stats.queuedBytes     += byteSize;
+  stats.peakQueuedBytes  = eastl::max( stats.peakQueuedBytes, stats.queuedBytes );
+  stats.convertedMeshes++;
+  convertingMeshes--;
+
+  autoLock.unlock();
+  queueChanged.notify_all();
+
+  return true;
+}
\ No newline at end of file
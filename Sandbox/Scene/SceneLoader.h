@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Render/ShaderStructures.h"
+#include "WorldPartition.h"
+
+struct aiScene;
+
+namespace Assimp
+{
+  class Importer;
+}
+
+// Imports the scene file, then converts the requested meshes to the GPU format on worker threads, without touching
+// the device. The converted meshes are queued up until the scene takes them, a batch per frame. The conversion waits
+// while too much of them are queued, so the memory peak is bound by maxQueuedBytes, not by the size of the requests.
+// The imported scene is kept for the lifetime of the loader, so evicted meshes can be requested again.
+class SceneLoader
+{
+public:
+  enum class State
+  {
+    Importing,
+    Ready,
+    Failed,
+  };
+
+  struct ConvertedMesh
+  {
+    int                           meshIndex;
+    eastl::vector< VertexFormat > vertices;
+    eastl::vector< uint32_t >     indices;
+    BoundingBox                   aabb;
+
+    size_t GetByteSize() const;
+  };
+
+  struct Stats
+  {
+    int    meshCount       = 0;
+    int    convertedMeshes = 0;
+    int    takenMeshes     = 0;
+    size_t queuedBytes     = 0;
+    size_t peakQueuedBytes = 0;
+  };
+
+  // While streaming in, the converted meshes waiting for the upload are limited, and so is the upload of a frame.
+  static constexpr size_t MaxQueuedBytes      = 256 * 1024 * 1024;
+  static constexpr size_t UploadBytesPerFrame = 32 * 1024 * 1024;
+
+  // The first .fbx file in the folder, empty when there is none.
+  static eastl::wstring FindSceneFile( const wchar_t* hostFolder );
+
+  SceneLoader( const wchar_t* sceneFilePath, size_t maxQueuedBytes = MaxQueuedBytes );
+  ~SceneLoader();
+
+  State GetState() const;
+  const eastl::wstring& GetError() const;
+
+  // The imported scene, for the materials, nodes, lights and cameras. Not available in the Importing state.
+  const aiScene& GetScene() const;
+
+  // Every mesh of every node, with its bounds in world space. Only in the Ready state.
+  void CollectMeshInstances( eastl::vector< WorldPartition::MeshInstance >& instances ) const;
+
+  // The size of the converted mesh, without converting it.
+  size_t GetMeshByteSize( int meshIndex ) const;
+
+  // The meshes are converted in the order of the requests. A mesh can be requested again after it was taken.
+  void RequestMeshes( const eastl::vector< int >& meshIndices );
+
+  // Moves the converted meshes to the batch in the order they were finished, until the batch reaches maxBytes.
+  // A mesh bigger than maxBytes is still taken, when it is the first in the batch.
+  void TakeConvertedMeshes( size_t maxBytes, eastl::vector< ConvertedMesh >& batch );
+
+  // Blocks until there is a converted mesh to take, or there is nothing left to convert.
+  void WaitForConvertedMeshes();
+
+  Stats GetStats() const;
+
+private:
+  void Load( eastl::wstring sceneFilePath );
+  void ConvertRequests();
+  bool ConvertMesh( int meshIndex );
+
+  eastl::unique_ptr< Assimp::Importer > importer;
+  const aiScene*                        scene = nullptr;
+
+  State          state = State::Importing;
+  eastl::wstring error;
+  Stats          stats;
+  size_t         maxQueuedBytes;
+  bool           cancelled = false;
+
+  mutable std::mutex            queueLock;
+  std::condition_variable       queueChanged;
+  eastl::vector< int >          requestedMeshes;
+  int                           convertingMeshes = 0;
+  eastl::queue< ConvertedMesh > convertedMeshes;
+
+  std::future< void > worker;
+};
\ No newline at end of file
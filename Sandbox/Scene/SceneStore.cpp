@@ -0,0 +1,293 @@
+#include "SceneStore.h"
+#include "Node.h"
+#include "Camera.h"
+#include "Render/Mesh.h"
+#include "Render/ShaderValues.h"
+#include "Render/LowDiscrepancy.h"
+
+// Keyed by the node and the mesh, so an instance keeps its values when the store is rebuilt as the scene streams.
+static PackedVector::HALF GetInstanceRandom( int nodeIndex, int meshIndex, int component )
+{
+  using namespace LowDiscrepancy;
+
+  auto hash = Hash( HashCombine( HashCombine( uint32_t( nodeIndex ), uint32_t( meshIndex ) ), uint32_t( component ) ) );
+  return PackedVector::XMConvertFloatToHalf( float( hash >> 8 ) / float( 1 << 24 ) );
+}
+
+void SceneStore::Build( Node& rootNode, const eastl::vector< eastl::unique_ptr< Mesh > >& meshes )
+{
+  Clear();
+
+  rootNodeChildrenIndices.push_back( 0 ); // This will store the number of root node children
+
+  struct StackEntry
+  {
+    Node* node;
+    int   parentIndex;
+  };
+
+  eastl::vector< StackEntry > stack;
+  stack.push_back( { &rootNode, -1 } );
+
+  eastl::vector< int > lastChildIndices;
+
+  while ( !stack.empty() )
+  {
+    auto entry = stack.back();
+    stack.pop_back();
+
+    auto& node      = *entry.node;
+    int   nodeIndex = int( nodeSlots.size() );
+
+    if ( node.IsRootChild() )
+      rootNodeChildrenIndices.emplace_back( nodeIndex );
+
+    node.storeIndex = nodeIndex;
+
+    nodes.push_back( &node );
+    parentIndices.push_back( entry.parentIndex );
+    dirtyTransforms.push_back( true );
+    meshSlotCounts.push_back( 0 );
+    lastChildIndices.push_back( -1 );
+
+    worldTransforms.emplace_back();
+    nodeSlots.emplace_back();
+
+    auto& nodeSlot = nodeSlots.back();
+    XMStoreFloat4x4( &nodeSlot.worldTransform, node.GetTransform() );
+    nodeSlot.cameraSlot      = InvalidSlot;
+    nodeSlot.lightSlot       = InvalidSlot;
+    nodeSlot.firstMeshSlot   = InvalidSlot;
+    nodeSlot.firstChildSlot  = InvalidSlot;
+    nodeSlot.nextSiblingSlot = InvalidSlot;
+
+    if ( entry.parentIndex >= 0 )
+    {
+      auto& lastChildIndex = lastChildIndices[ entry.parentIndex ];
+      if ( lastChildIndex < 0 )
+        nodeSlots[ entry.parentIndex ].firstChildSlot = nodeIndex;
+      else
+        nodeSlots[ lastChildIndex ].nextSiblingSlot = nodeIndex;
+      lastChildIndex = nodeIndex;
+    }
+
+    // From assimp, there can be only one camera per node. So we can just take the first one.
+    node.ForEachCamera( [&]( Camera& camera ) mutable
+    {
+      nodeSlots[ nodeIndex ].cameraSlot = int( cameraSlots.size() );
+
+      cameraSlots.emplace_back();
+      XMStoreFloat4x4( &cameraSlots.back().projTransform, camera.GetProjTransform() );
+      cameras.push_back( &camera );
+
+      cameraNodeIndex = nodeIndex;
+
+      return false;
+    });
+
+    // From assimp, there can be only one light per node. So we can just take the first one.
+    node.ForEachLight( [&]( int lightIndex ) mutable
+    {
+      nodeSlots[ nodeIndex ].lightSlot = lightIndex;
+      return false;
+    });
+
+    // The meshes of a node are always allocated as one contiguous range.
+    node.ForEachMesh( [&]( int meshIndex ) mutable
+    {
+      // While the scene is streamed in, the meshes not yet resident are left out.
+      if ( !meshes[ meshIndex ] )
+        return true;
+
+      int meshSlotIndex = int( meshSlots.size() );
+
+      if ( nodeSlots[ nodeIndex ].firstMeshSlot == InvalidSlot )
+        nodeSlots[ nodeIndex ].firstMeshSlot = meshSlotIndex;
+      else
+        meshSlots[ meshSlotIndex - 1 ].nextSlotIndex = meshSlotIndex;
+
+      meshSlotCounts[ nodeIndex ]++;
+      meshIndices.push_back( meshIndex );
+      meshSlotNodes.push_back( nodeIndex );
+
+      meshSlots.emplace_back();
+      auto& meshSlot = meshSlots.back();
+
+      auto& mesh = *meshes[ meshIndex ];
+      auto& aabb = mesh.GetAABB();
+
+      meshSlot.aabbCenter     = XMFLOAT4( aabb.Center.x,  aabb.Center.y,  aabb.Center.z,  1 );
+      meshSlot.aabbExtents    = XMFLOAT4( aabb.Extents.x, aabb.Extents.y, aabb.Extents.z, 1 );
+      meshSlot.ibIndex        = mesh.GetIndexBufferSlot() - SceneBufferResourceBaseSlot;
+      meshSlot.vbIndex        = mesh.GetVertexBufferSlot() - SceneBufferResourceBaseSlot;
+      meshSlot.indexCount     = mesh.GetIndexCount();
+      meshSlot.materialIndex  = mesh.GetMaterialIndex();
+      meshSlot.randomValues.x = GetInstanceRandom( nodeIndex, meshIndex, 0 );
+      meshSlot.randomValues.y = GetInstanceRandom( nodeIndex, meshIndex, 1 );
+      meshSlot.randomValues.z = GetInstanceRandom( nodeIndex, meshIndex, 2 );
+      meshSlot.randomValues.w = GetInstanceRandom( nodeIndex, meshIndex, 3 );
+      meshSlot.nextSlotIndex  = InvalidSlot;
+
+      return true;
+    });
+
+    // Push the children in reverse, so they are visited and stored in their original order.
+    size_t firstChild = stack.size();
+    node.ForEachNode( [&]( Node& childNode ) mutable
+    {
+      stack.push_back( { &childNode, nodeIndex } );
+      return true;
+    });
+    eastl::reverse( stack.begin() + firstChild, stack.end() );
+  }
+
+  rootNodeChildrenIndices[ 0 ] = uint32_t( rootNodeChildrenIndices.size() - 1 );
+
+  anyDirty = true;
+  UpdateWorldTransforms();
+}
+
+void SceneStore::Clear()
+{
+  for ( auto node : nodes )
+    node->storeIndex = -1;
+
+  nodeSlots.clear();
+  worldTransforms.clear();
+  parentIndices.clear();
+  meshSlotCounts.clear();
+  dirtyTransforms.clear();
+  nodes.clear();
+  meshSlots.clear();
+  meshIndices.clear();
+  meshSlotNodes.clear();
+  cameraSlots.clear();
+  cameras.clear();
+  rootNodeChildrenIndices.clear();
+
+  cameraNodeIndex = -1;
+  anyDirty        = false;
+}
+
+int SceneStore::GetNodeCount() const
+{
+  return int( nodeSlots.size() );
+}
+
+int SceneStore::GetNodeIndex( const Node& node ) const
+{
+  // The node can be in the tree of another store too, the index is only valid in the last one built.
+  int nodeIndex = node.storeIndex;
+  return nodeIndex >= 0 && nodeIndex < int( nodes.size() ) && nodes[ nodeIndex ] == &node ? nodeIndex : -1;
+}
+
+Node& SceneStore::GetNode( int nodeIndex ) const
+{
+  return *nodes[ nodeIndex ];
+}
+
+int SceneStore::GetParentIndex( int nodeIndex ) const
+{
+  return parentIndices[ nodeIndex ];
+}
+
+int SceneStore::GetMeshSlotCount( int nodeIndex ) const
+{
+  return meshSlotCounts[ nodeIndex ];
+}
+
+int SceneStore::GetMeshIndex( int meshSlot ) const
+{
+  return meshIndices[ meshSlot ];
+}
+
+int SceneStore::GetMeshSlotNode( int meshSlot ) const
+{
+  return meshSlotNodes[ meshSlot ];
+}
+
+void SceneStore::SetLocalTransform( int nodeIndex, FXMMATRIX transform )
+{
+  XMStoreFloat4x4( &nodeSlots[ nodeIndex ].worldTransform, transform );
+  dirtyTransforms[ nodeIndex ] = true;
+  anyDirty = true;
+}
+
+XMMATRIX SceneStore::GetLocalTransform( int nodeIndex ) const
+{
+  return XMLoadFloat4x4( &nodeSlots[ nodeIndex ].worldTransform );
+}
+
+XMMATRIX SceneStore::GetWorldTransform( int nodeIndex ) const
+{
+  assert( !anyDirty );
+  return XMLoadFloat4x4( &worldTransforms[ nodeIndex ] );
+}
+
+void SceneStore::UpdateWorldTransforms( eastl::vector< int >* updatedNodes )
+{
+  if ( !anyDirty )
+    return;
+
+  int nodeCount = int( nodeSlots.size() );
+  for ( int nodeIx = 0; nodeIx < nodeCount; nodeIx++ )
+  {
+    int parentIx = parentIndices[ nodeIx ];
+
+    // Parents are always processed before their children, so the dirty state is already propagated.
+    if ( parentIx >= 0 && dirtyTransforms[ parentIx ] )
+      dirtyTransforms[ nodeIx ] = true;
+
+    if ( !dirtyTransforms[ nodeIx ] )
+      continue;
+
+    auto localTransform = XMLoadFloat4x4( &nodeSlots[ nodeIx ].worldTransform );
+    if ( parentIx >= 0 )
+      localTransform = localTransform * XMLoadFloat4x4( &worldTransforms[ parentIx ] );
+
+    XMStoreFloat4x4( &worldTransforms[ nodeIx ], localTransform );
+
+    if ( updatedNodes )
+      updatedNodes->push_back( nodeIx );
+  }
+
+  // Dirty flags are cleared separately, as the children are reading them in the loop above.
+  eastl::fill( dirtyTransforms.begin(), dirtyTransforms.end(), false );
+  anyDirty = false;
+}
+
+void SceneStore::UpdateCameraProjections()
+{
+  for ( size_t cameraIx = 0; cameraIx < cameras.size(); cameraIx++ )
+    XMStoreFloat4x4( &cameraSlots[ cameraIx ].projTransform, cameras[ cameraIx ]->GetProjTransform() );
+}
+
+int SceneStore::GetCameraNodeIndex() const
+{
+  return cameraNodeIndex;
+}
+
+int SceneStore::GetInstanceCount() const
+{
+  return int( meshSlots.size() );
+}
+
+const eastl::vector< NodeSlot >& SceneStore::GetNodeSlots() const
+{
+  return nodeSlots;
+}
+
+const eastl::vector< MeshSlot >& SceneStore::GetMeshSlots() const
+{
+  return meshSlots;
+}
+
+const eastl::vector< CameraSlot >& SceneStore::GetCameraSlots() const
+{
+  return cameraSlots;
+}
+
+const eastl::vector< uint32_t >& SceneStore::GetRootNodeChildrenIndices() const
+{
+  return rootNodeChildrenIndices;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Render/ShaderStructures.h"
+
+class Node;
+class Camera;
+class Mesh;
+
+// Flattened, data oriented copy of the node tree. Nodes are stored in depth first order, so a parent
+// always precedes its children, and the node, mesh and camera arrays are laid out as the GPU expects them.
+class SceneStore
+{
+public:
+  void Build( Node& rootNode, const eastl::vector< eastl::unique_ptr< Mesh > >& meshes );
+  void Clear();
+
+  int GetNodeCount() const;
+
+  // Constant time, the index is kept on the node. -1 for the nodes not in the store.
+  int GetNodeIndex( const Node& node ) const;
+  Node& GetNode( int nodeIndex ) const;
+
+  int GetParentIndex( int nodeIndex ) const;
+  int GetMeshSlotCount( int nodeIndex ) const;
+  int GetMeshIndex( int meshSlot ) const;
+  int GetMeshSlotNode( int meshSlot ) const;
+
+  void SetLocalTransform( int nodeIndex, FXMMATRIX transform );
+  XMMATRIX GetLocalTransform( int nodeIndex ) const;
+  XMMATRIX GetWorldTransform( int nodeIndex ) const;
+
+  // The only cache of the world transforms, Node composes its own on every call. Recalculates the world transforms of
+  // the changed nodes and their subtrees in a single linear pass. The indices of the recalculated nodes are appended
+  // to updatedNodes, if given.
+  void UpdateWorldTransforms( eastl::vector< int >* updatedNodes = nullptr );
+
+  void UpdateCameraProjections();
+
+  int GetCameraNodeIndex() const;
+  int GetInstanceCount() const;
+
+  const eastl::vector< NodeSlot   >& GetNodeSlots() const;
+  const eastl::vector< MeshSlot   >& GetMeshSlots() const;
+  const eastl::vector< CameraSlot >& GetCameraSlots() const;
+  const eastl::vector< uint32_t   >& GetRootNodeChildrenIndices() const;
+
+private:
+  // NodeSlot::worldTransform holds the local transform, the shaders compose the hierarchy themselves.
+  eastl::vector< NodeSlot   > nodeSlots;
+  eastl::vector< XMFLOAT4X4 > worldTransforms;
+  eastl::vector< int        > parentIndices;
+  eastl::vector< int        > meshSlotCounts;
+  eastl::vector< bool       > dirtyTransforms;
+  eastl::vector< Node*      > nodes;
+
+  eastl::vector< MeshSlot > meshSlots;
+  eastl::vector< int      > meshIndices;
+  eastl::vector< int      > meshSlotNodes;
+
+  eastl::vector< CameraSlot    > cameraSlots;
+  eastl::vector< const Camera* > cameras;
+
+  eastl::vector< uint32_t > rootNodeChildrenIndices;
+
+  int  cameraNodeIndex = -1;
+  bool anyDirty        = false;
+};
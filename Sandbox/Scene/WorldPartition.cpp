@@ -0,0 +1,83 @@
+#include "WorldPartition.h"
+
+void WorldPartition::Build( const eastl::vector< MeshInstance >& instances, int cellsPerAxis )
+{
+  cells.clear();
+  meshCells.clear();
+
+  if ( instances.empty() )
+    return;
+
+  // The grid spans the centers only, those decide the cell of an instance.
+  auto gridMin = XMLoadFloat3( &instances.front().bounds.Center );
+  auto gridMax = gridMin;
+  for ( auto& instance : instances )
+  {
+    auto center = XMLoadFloat3( &instance.bounds.Center );
+    gridMin = XMVectorMin( gridMin, center );
+    gridMax = XMVectorMax( gridMax, center );
+  }
+
+  float gridMinX = XMVectorGetX( gridMin );
+  float gridMinZ = XMVectorGetZ( gridMin );
+  float sizeX    = XMVectorGetX( gridMax ) - gridMinX;
+  float sizeZ    = XMVectorGetZ( gridMax ) - gridMinZ;
+  float cellSize = eastl::max( eastl::max( sizeX, sizeZ ) / eastl::max( cellsPerAxis, 1 ), 0.001f );
+  int   gridSize = int( sizeX / cellSize ) + 1;
+
+  eastl::vector_map< int, int > gridToCell;
+
+  for ( auto& instance : instances )
+  {
+    int gridX = int( ( instance.bounds.Center.x - gridMinX ) / cellSize );
+    int gridZ = int( ( instance.bounds.Center.z - gridMinZ ) / cellSize );
+
+    auto iter = gridToCell.find( gridZ * gridSize + gridX );
+    if ( iter == gridToCell.end() )
+    {
+      iter = gridToCell.emplace( gridZ * gridSize + gridX, int( cells.size() ) ).first;
+      cells.emplace_back();
+      cells.back().bounds = instance.bounds;
+    }
+
+    int   cellIx = iter->second;
+    auto& cell   = cells[ cellIx ];
+
+    BoundingBox::CreateMerged( cell.bounds, cell.bounds, instance.bounds );
+
+    if ( eastl::find( cell.meshIndices.begin(), cell.meshIndices.end(), instance.meshIndex ) == cell.meshIndices.end() )
+      cell.meshIndices.push_back( instance.meshIndex );
+
+    if ( instance.meshIndex >= int( meshCells.size() ) )
+      meshCells.resize( instance.meshIndex + 1 );
+
+    auto& cellsOfMesh = meshCells[ instance.meshIndex ];
+    if ( eastl::find( cellsOfMesh.begin(), cellsOfMesh.end(), cellIx ) == cellsOfMesh.end() )
+      cellsOfMesh.push_back( cellIx );
+  }
+}
+
+int WorldPartition::GetCellCount() const
+{
+  return int( cells.size() );
+}
+
+const WorldPartition::Cell& WorldPartition::GetCell( int cellIndex ) const
+{
+  return cells[ cellIndex ];
+}
+
+const eastl::vector< int >& WorldPartition::GetMeshCells( int meshIndex ) const
+{
+  return meshIndex < int( meshCells.size() ) ? meshCells[ meshIndex ] : noCells;
+}
+
+float WorldPartition::GetCellDistance( int cellIndex, FXMVECTOR point ) const
+{
+  auto& bounds = cells[ cellIndex ].bounds;
+
+  float dx = eastl::max( fabsf( XMVectorGetX( point ) - bounds.Center.x ) - bounds.Extents.x, 0.0f );
+  float dz = eastl::max( fabsf( XMVectorGetZ( point ) - bounds.Center.z ) - bounds.Extents.z, 0.0f );
+
+  return sqrtf( dx * dx + dz * dz );
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Uniform grid over the ground plane of the scene. Every mesh instance belongs to the cell its bounds center falls
+// into, and a cell lists the meshes its instances use. A mesh used by instances in more cells is listed in each.
+class WorldPartition
+{
+public:
+  static constexpr int DefaultCellsPerAxis = 16;
+
+  struct MeshInstance
+  {
+    int         meshIndex;
+    BoundingBox bounds;
+  };
+
+  struct Cell
+  {
+    // Of the instances in the cell, these can reach out of the grid cell.
+    BoundingBox          bounds;
+    eastl::vector< int > meshIndices;
+  };
+
+  // The longer side of the scene is split into cellsPerAxis cells, the cells without instances are left out.
+  void Build( const eastl::vector< MeshInstance >& instances, int cellsPerAxis );
+
+  int         GetCellCount() const;
+  const Cell& GetCell( int cellIndex ) const;
+
+  // The cells listing the mesh, empty for meshes without instances.
+  const eastl::vector< int >& GetMeshCells( int meshIndex ) const;
+
+  // Distance from the point to the bounds of the cell on the ground plane, zero inside.
+  float GetCellDistance( int cellIndex, FXMVECTOR point ) const;
+
+private:
+  eastl::vector< Cell >                 cells;
+  eastl::vector< eastl::vector< int > > meshCells;
+  eastl::vector< int >                  noCells;
+};
\ No newline at end of file
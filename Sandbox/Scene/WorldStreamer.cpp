@@ -0,0 +1,202 @@
+#include "WorldStreamer.h"
+#include "WorldPartition.h"
+
+WorldStreamer::WorldStreamer( const WorldPartition& partition, eastl::vector< size_t >&& meshByteSizes, const Settings& settings )
+: partition        ( partition )
+, settings         ( settings )
+, meshByteSizes    ( eastl::move( meshByteSizes ) )
+, cellStates       ( partition.GetCellCount(), CellState::Unloaded )
+, cellPendingMeshes( partition.GetCellCount(), 0 )
+, cellRequestTimes ( partition.GetCellCount(), 0.0 )
+, cellStats        ( partition.GetCellCount() )
+{
+  meshUsers.resize( this->meshByteSizes.size(), 0 );
+  meshStates.resize( this->meshByteSizes.size(), MeshState::Unloaded );
+}
+
+void WorldStreamer::Update( FXMVECTOR cameraPosition, double time, eastl::vector< int >& meshesToLoad, eastl::vector< int >& meshesToEvict )
+{
+  cellOrder.clear();
+  for ( int cellIx = 0; cellIx < partition.GetCellCount(); cellIx++ )
+    cellOrder.emplace_back( partition.GetCellDistance( cellIx, cameraPosition ), cellIx );
+
+  eastl::sort( cellOrder.begin(), cellOrder.end() );
+
+  releasedMeshes.clear();
+
+  for ( auto& cell : cellOrder )
+    if ( cellStates[ cell.second ] != CellState::Unloaded && cell.first > settings.evictRadius )
+      ReleaseCell( cell.second );
+
+  int farthestOrderIx = int( cellOrder.size() ) - 1;
+
+  for ( int orderIx = 0; orderIx < int( cellOrder.size() ) && cellOrder[ orderIx ].first <= settings.loadRadius; orderIx++ )
+  {
+    int cellIx = cellOrder[ orderIx ].second;
+    if ( cellStates[ cellIx ] != CellState::Unloaded )
+      continue;
+
+    // The cells behind this one in the order are all farther, those give their memory to it.
+    size_t loadCost = GetCellLoadCost( cellIx );
+    while ( committedBytes + loadCost > settings.memoryBudget && farthestOrderIx > orderIx )
+    {
+      int farthestCellIx = cellOrder[ farthestOrderIx-- ].second;
+      if ( cellStates[ farthestCellIx ] == CellState::Unloaded )
+        continue;
+
+      ReleaseCell( farthestCellIx );
+      loadCost = GetCellLoadCost( cellIx );
+    }
+
+    if ( committedBytes + loadCost > settings.memoryBudget )
+      break;
+
+    LoadCell( cellIx, time, meshesToLoad );
+  }
+
+  // A mesh released by a cell and used again by another one in the same update is kept.
+  for ( int meshIx : releasedMeshes )
+  {
+    if ( meshUsers[ meshIx ] > 0 || meshStates[ meshIx ] == MeshState::Unloaded )
+      continue;
+
+    if ( meshStates[ meshIx ] == MeshState::Resident )
+      residentBytes -= meshByteSizes[ meshIx ];
+
+    meshStates[ meshIx ] = MeshState::Unloaded;
+    meshesToEvict.push_back( meshIx );
+  }
+}
+
+bool WorldStreamer::OnMeshResident( int meshIndex, double time )
+{
+  if ( meshStates[ meshIndex ] != MeshState::Loading )
+    return false;
+
+  meshStates[ meshIndex ] = MeshState::Resident;
+
+  residentBytes     += meshByteSizes[ meshIndex ];
+  peakResidentBytes  = eastl::max( peakResidentBytes, residentBytes );
+
+  for ( int cellIx : partition.GetMeshCells( meshIndex ) )
+  {
+    if ( cellStates[ cellIx ] != CellState::Loading || --cellPendingMeshes[ cellIx ] > 0 )
+      continue;
+
+    auto latency = time - cellRequestTimes[ cellIx ];
+    auto& stats  = cellStats[ cellIx ];
+    stats.completed++;
+    stats.totalLatency += latency;
+    stats.maxLatency    = eastl::max( stats.maxLatency, latency );
+
+    cellStates[ cellIx ] = CellState::Resident;
+    loadingCells--;
+  }
+
+  return true;
+}
+
+bool WorldStreamer::IsSettled() const
+{
+  return loadingCells == 0;
+}
+
+size_t WorldStreamer::GetResidentBytes() const
+{
+  return residentBytes;
+}
+
+size_t WorldStreamer::GetPeakResidentBytes() const
+{
+  return peakResidentBytes;
+}
+
+size_t WorldStreamer::GetPeakCommittedBytes() const
+{
+  return peakCommittedBytes;
+}
+
+size_t WorldStreamer::GetCellByteSize( int cellIndex ) const
+{
+  size_t byteSize = 0;
+  for ( int meshIx : partition.GetCell( cellIndex ).meshIndices )
+    byteSize += meshByteSizes[ meshIx ];
+  return byteSize;
+}
+
+int WorldStreamer::GetResidentCellCount() const
+{
+  return int( eastl::count( cellStates.begin(), cellStates.end(), CellState::Resident ) );
+}
+
+const eastl::vector< WorldStreamer::CellStats >& WorldStreamer::GetCellStats() const
+{
+  return cellStats;
+}
+
+size_t WorldStreamer::GetCellLoadCost( int cellIndex ) const
+{
+  size_t loadCost = 0;
+  for ( int meshIx : partition.GetCell( cellIndex ).meshIndices )
+    if ( meshUsers[ meshIx ] == 0 )
+      loadCost += meshByteSizes[ meshIx ];
+  return loadCost;
+}
+
+void WorldStreamer::LoadCell( int cellIndex, double time, eastl::vector< int >& meshesToLoad )
+{
+  int pendingMeshes = 0;
+
+  for ( int meshIx : partition.GetCell( cellIndex ).meshIndices )
+  {
+    if ( meshUsers[ meshIx ]++ == 0 )
+    {
+      committedBytes += meshByteSizes[ meshIx ];
+
+      // Released in this update, but not evicted yet, it stays as it is.
+      if ( meshStates[ meshIx ] == MeshState::Unloaded )
+      {
+        meshStates[ meshIx ] = MeshState::Loading;
+        meshesToLoad.push_back( meshIx );
+      }
+    }
+
+    if ( meshStates[ meshIx ] != MeshState::Resident )
+      pendingMeshes++;
+  }
+
+  peakCommittedBytes = eastl::max( peakCommittedBytes, committedBytes );
+
+  cellStats[ cellIndex ].loads++;
+  cellRequestTimes[ cellIndex ]  = time;
+  cellPendingMeshes[ cellIndex ] = pendingMeshes;
+
+  if ( pendingMeshes > 0 )
+  {
+    cellStates[ cellIndex ] = CellState::Loading;
+    loadingCells++;
+  }
+  else
+  {
+    cellStates[ cellIndex ] = CellState::Resident;
+    cellStats[ cellIndex ].completed++;
+  }
+}
+
+void WorldStreamer::ReleaseCell( int cellIndex )
+{
+  if ( cellStates[ cellIndex ] == CellState::Loading )
+    loadingCells--;
+
+  cellStates[ cellIndex ] = CellState::Unloaded;
+  cellStats[ cellIndex ].evictions++;
+
+  for ( int meshIx : partition.GetCell( cellIndex ).meshIndices )
+  {
+    if ( --meshUsers[ meshIx ] > 0 )
+      continue;
+
+    committedBytes -= meshByteSizes[ meshIx ];
+    releasedMeshes.push_back( meshIx );
+  }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+class WorldPartition;
+
+// Decides which cells of the world partition are resident, from the distance of the camera. The cells are loaded
+// nearest first while their meshes fit the memory budget, a nearer cell takes the memory of the farthest resident ones.
+// Meshes shared by cells are counted once. Nothing is loaded here, Update returns the meshes to load and to evict, and
+// OnMeshResident is called when a mesh arrived, so it runs without a device too.
+class WorldStreamer
+{
+public:
+  struct Settings
+  {
+    size_t memoryBudget = size_t( 1536 ) * 1024 * 1024;
+    float  loadRadius   = FLT_MAX;
+    float  evictRadius  = FLT_MAX;
+  };
+
+  struct CellStats
+  {
+    int    loads        = 0;
+    int    evictions    = 0;
+    int    completed    = 0;
+    double totalLatency = 0;
+    double maxLatency   = 0;
+  };
+
+  WorldStreamer( const WorldPartition& partition, eastl::vector< size_t >&& meshByteSizes, const Settings& settings );
+
+  // The meshes to load are added nearest first, the evicted ones are not used by any loading or resident cell anymore.
+  // The time is in seconds, the load latency of the cells is measured from the Update requesting them.
+  void Update( FXMVECTOR cameraPosition, double time, eastl::vector< int >& meshesToLoad, eastl::vector< int >& meshesToEvict );
+
+  // Returns false when the mesh is not waited for, it was evicted while loading or it arrived already.
+  bool OnMeshResident( int meshIndex, double time );
+
+  // True when no cell waits for its meshes.
+  bool IsSettled() const;
+
+  size_t GetResidentBytes() const;
+  size_t GetPeakResidentBytes() const;
+  size_t GetPeakCommittedBytes() const;
+  size_t GetCellByteSize( int cellIndex ) const;
+  int    GetResidentCellCount() const;
+
+  const eastl::vector< CellStats >& GetCellStats() const;
+
+private:
+  enum class CellState
+  {
+    Unloaded,
+    Loading,
+    Resident,
+  };
+
+  enum class MeshState
+  {
+    Unloaded,
+    Loading,
+    Resident,
+  };
+
+  // Bytes the cell would add to the committed memory, its meshes used by other cells are not counted.
+  size_t GetCellLoadCost( int cellIndex ) const;
+
+  void LoadCell( int cellIndex, double time, eastl::vector< int >& meshesToLoad );
+  void ReleaseCell( int cellIndex );
+
+  const WorldPartition& partition;
+  Settings              settings;
+
+  eastl::vector< size_t >    meshByteSizes;
+  eastl::vector< int >       meshUsers;
+  eastl::vector< MeshState > meshStates;
+
+  eastl::vector< CellState > cellStates;
+  eastl::vector< int >       cellPendingMeshes;
+  eastl::vector< double >    cellRequestTimes;
+  eastl::vector< CellStats > cellStats;
+
+  eastl::vector< eastl::pair< float, int > > cellOrder;
+  eastl::vector< int >                       releasedMeshes;
+
+  // Committed is the memory of the meshes used by loading or resident cells, including the ones not arrived yet.
+  size_t committedBytes     = 0;
+  size_t peakCommittedBytes = 0;
+  size_t residentBytes      = 0;
+  size_t peakResidentBytes  = 0;
+  int    loadingCells       = 0;
+};
\ No newline at end of file
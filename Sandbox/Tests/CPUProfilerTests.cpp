@@ -0,0 +1,37 @@
+#include "TestRunner.h"
+
+TEST_CASE( CPUProfilerCollectsEachSectionOnce )
+{
+  CPUProfiler::SetCollecting( true );
+
+  // Drops whatever was recorded before.
+  CPUProfiler::CollectSections( []( const wchar_t*, uint64_t, uint64_t ) {} );
+
+  { CPUSection section( L"Test section" ); }
+  { CPUSection section( L"Test section" ); }
+
+  std::thread( []() { CPUSection section( L"Test worker section" ); } ).join();
+
+  int mainSections   = 0;
+  int workerSections = 0;
+  CPUProfiler::CollectSections( [ & ]( const wchar_t* name, uint64_t start, uint64_t end )
+  {
+    mainSections   += wcscmp( name, L"Test section" ) == 0 && end >= start;
+    workerSections += wcscmp( name, L"Test worker section" ) == 0;
+  } );
+
+  CHECK( mainSections == 2 );
+  CHECK( workerSections == 1 );
+
+  int repeated = 0;
+  CPUProfiler::CollectSections( [ & ]( const wchar_t*, uint64_t, uint64_t ) { repeated++; } );
+  CHECK( repeated == 0 );
+
+  CPUProfiler::SetCollecting( false );
+
+  { CPUSection section( L"Test section" ); }
+
+  int notCollected = 0;
+  CPUProfiler::CollectSections( [ & ]( const wchar_t*, uint64_t, uint64_t ) { notCollected++; } );
+  CHECK( notCollected == 0 );
+}
@@ -0,0 +1,102 @@
+#include "TestRunner.h"
+#include "TestDevice.h"
+#include "Common/ParallelFor.h"
+#include "Render/CommandAllocatorPool.h"
+#include "Render/CommandAllocator.h"
+
+TEST_CASE( CommandAllocatorPoolReusesAnyCompleted )
+{
+  auto& device = GetTestDevice();
+
+  CommandAllocatorPool pool( CommandQueueType::Direct, 4 );
+
+  auto first  = pool.RequestAllocator( device, 0 );
+  auto second = pool.RequestAllocator( device, 0 );
+  auto third  = pool.RequestAllocator( device, 0 );
+  CHECK( first != second && second != third && first != third );
+  CHECK( pool.Size() == 3 );
+
+  pool.DiscardAllocator( 5, first );
+  pool.DiscardAllocator( 2, second );
+  pool.DiscardAllocator( 9, third );
+
+  // The oldest discarded one is still in flight, the one behind it is taken.
+  CHECK( pool.RequestAllocator( device, 3 ) == second );
+  CHECK( pool.Size() == 3 );
+
+  auto fourth = pool.RequestAllocator( device, 3 );
+  CHECK( fourth != first && fourth != second && fourth != third );
+
+  auto stats = pool.GetStats();
+  CHECK( stats.live == 4 && stats.recording == 2 && stats.inFlight == 2 && stats.idle == 0 );
+  CHECK( stats.peak == 4 && stats.createdTotal == 4 && stats.destroyedTotal == 0 );
+
+  // Discarded with a fence which already completed, it is idle right away.
+  pool.DiscardAllocator( 3, fourth );
+  stats = pool.GetStats();
+  CHECK( stats.inFlight == 2 && stats.idle == 1 && stats.recording == 1 );
+}
+
+TEST_CASE( CommandAllocatorPoolShrinksAfterSpike )
+{
+  static constexpr int spikeSize = 6;
+
+  auto& device = GetTestDevice();
+
+  CommandAllocatorPool pool( CommandQueueType::Direct, 2 );
+
+  // Nothing completes during the spike, every request creates an allocator.
+  CommandAllocator* allocators[ spikeSize ];
+  for ( auto& allocator : allocators )
+    allocator = pool.RequestAllocator( device, 0 );
+  for ( int allocatorIx = 0; allocatorIx < spikeSize; ++allocatorIx )
+    pool.DiscardAllocator( allocatorIx + 1, allocators[ allocatorIx ] );
+
+  CHECK( pool.GetStats().peak == spikeSize && pool.GetStats().inFlight == spikeSize );
+
+  // One completed is reused, the other completed ones go, the ones in flight stay over the cap.
+  auto reused = pool.RequestAllocator( device, 3 );
+  CHECK( reused == allocators[ 0 ] || reused == allocators[ 1 ] || reused == allocators[ 2 ] );
+
+  auto stats = pool.GetStats();
+  CHECK( stats.live == 4 && stats.recording == 1 && stats.inFlight == 3 && stats.idle == 0 );
+  CHECK( stats.destroyedTotal == 2 );
+
+  // Once they complete the pool is back at the cap.
+  auto next = pool.RequestAllocator( device, spikeSize );
+  CHECK( next != reused );
+
+  stats = pool.GetStats();
+  CHECK( stats.live == 2 && stats.recording == 2 && stats.inFlight == 0 && stats.idle == 0 );
+  CHECK( stats.createdTotal == spikeSize && stats.destroyedTotal == spikeSize - 2 && stats.peak == spikeSize );
+  CHECK( pool.Size() == 2 );
+}
+
+// Passes recorded on the worker pool every frame, with two frames in flight. The pool only ever holds the
+// allocators of the frames the GPU is not done with, and the ones being recorded.
+TEST_CASE( CommandAllocatorPoolParallelRequests )
+{
+  static constexpr int passCount      = 8;
+  static constexpr int framesInFlight = 2;
+  static constexpr int frameCount     = 100;
+
+  auto& device = GetTestDevice();
+
+  CommandAllocatorPool pool( CommandQueueType::Direct );
+
+  for ( uint64_t fence = 1; fence <= frameCount; ++fence )
+  {
+    uint64_t completedFence = fence > framesInFlight ? fence - framesInFlight : 0;
+
+    ParallelFor( passCount, 1, [ & ]( int begin, int end )
+    {
+      for ( int passIx = begin; passIx < end; ++passIx )
+        pool.DiscardAllocator( fence, pool.RequestAllocator( device, completedFence ) );
+    } );
+  }
+
+  auto stats = pool.GetStats();
+  CHECK( stats.peak <= passCount * ( framesInFlight + 1 ) );
+  CHECK( stats.live == stats.createdTotal - stats.destroyedTotal );
+  CHECK( stats.recording == 0 && stats.inFlight + stats.idle == stats.live );
+}
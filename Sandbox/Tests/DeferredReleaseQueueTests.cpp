@@ -0,0 +1,106 @@
+#include "TestRunner.h"
+#include "Render/DeferredReleaseQueue.h"
+
+// Counts its destructions, the queue only sees it through the unique_ptr.
+struct Released
+{
+  Released( eastl::atomic< int >& destroyed ) : destroyed( destroyed ) {}
+  ~Released() { destroyed++; }
+
+  eastl::atomic< int >& destroyed;
+};
+
+TEST_CASE( DeferredReleaseQueueFenceOrder )
+{
+  eastl::atomic< int > destroyed = 0;
+  int                  invoked   = 0;
+
+  DeferredReleaseQueue queue;
+  queue.Release( 1, eastl::make_unique< Released >( destroyed ) );
+  queue.Release( 1, eastl::make_unique< Released >( destroyed ) );
+  queue.Release( 2, [ & ]() { invoked++; } );
+  queue.Release( 5, eastl::make_unique< Released >( destroyed ) );
+  queue.Release( 5, eastl::unique_ptr< Released >() );
+  CHECK( queue.GetCount() == 4 );
+
+  CHECK( queue.Collect( 0 ) == 0 );
+  CHECK( destroyed == 0 && invoked == 0 );
+
+  CHECK( queue.Collect( 1 ) == 2 );
+  CHECK( destroyed == 2 && invoked == 0 );
+
+  // Everything up to the completed fence goes, later fences stay.
+  CHECK( queue.Collect( 4 ) == 1 );
+  CHECK( destroyed == 2 && invoked == 1 );
+  CHECK( queue.GetCount() == 1 );
+
+  CHECK( queue.Collect( 10 ) == 1 );
+  CHECK( destroyed == 3 && queue.GetCount() == 0 );
+  CHECK( queue.Collect( 10 ) == 0 );
+}
+
+TEST_CASE( DeferredReleaseQueueGrowsInOrder )
+{
+  static constexpr int releaseCount = 1000;
+
+  eastl::atomic< int > destroyed = 0;
+
+  DeferredReleaseQueue queue;
+
+  // Collected in between, so the ring wraps around before it grows.
+  for ( int releaseIx = 0; releaseIx < 100; ++releaseIx )
+    queue.Release( releaseIx, eastl::make_unique< Released >( destroyed ) );
+  CHECK( queue.Collect( 49 ) == 50 );
+
+  for ( int releaseIx = 100; releaseIx < releaseCount; ++releaseIx )
+    queue.Release( releaseIx, eastl::make_unique< Released >( destroyed ) );
+  CHECK( queue.GetCount() == releaseCount - 50 );
+
+  CHECK( queue.Collect( 499 ) == 450 );
+  CHECK( destroyed == 500 );
+  CHECK( queue.Collect( releaseCount ) == releaseCount - 500 );
+  CHECK( destroyed == releaseCount );
+}
+
+// Clear disposes the objects without running the callbacks, as they are only dropped at shutdown.
+TEST_CASE( DeferredReleaseQueueClear )
+{
+  eastl::atomic< int > destroyed = 0;
+  int                  invoked   = 0;
+
+  {
+    DeferredReleaseQueue queue;
+    queue.Release( 3, eastl::make_unique< Released >( destroyed ) );
+    queue.Release( 3, [ & ]() { invoked++; } );
+    queue.Clear();
+    CHECK( queue.GetCount() == 0 && destroyed == 1 && invoked == 0 );
+
+    // The destructor clears what is left.
+    queue.Release( 4, eastl::make_unique< Released >( destroyed ) );
+  }
+
+  CHECK( destroyed == 2 && invoked == 0 );
+}
+
+TEST_CASE( DeferredReleaseQueueBackgroundDestruction )
+{
+  eastl::atomic< int > destroyed = 0;
+  int                  invoked   = 0;
+
+  {
+    DeferredReleaseQueue queue;
+    queue.EnableBackgroundDestruction( "TestRelease" );
+
+    for ( int releaseIx = 0; releaseIx < 64; ++releaseIx )
+      queue.Release( 1, eastl::make_unique< Released >( destroyed ) );
+    queue.Release( 1, [ & ]() { invoked++; } );
+
+    // The callbacks still run on the collecting thread, the rest is handed to the worker.
+    CHECK( queue.Collect( 1 ) == 65 );
+    CHECK( invoked == 1 );
+    CHECK( queue.GetCount() == 0 );
+  }
+
+  // Whatever the worker did not get to is disposed with the queue.
+  CHECK( destroyed == 64 );
+}
@@ -0,0 +1,100 @@
+#include "TestRunner.h"
+#include "Render/DescriptorAllocator.h"
+
+TEST_CASE( DescriptorAllocatorAllocate )
+{
+  DescriptorAllocator allocator( 100, 16 );
+
+  CHECK( allocator.GetBase() == 100 && allocator.GetCapacity() == 16 );
+  CHECK( allocator.Contains( 100 ) && allocator.Contains( 115 ) );
+  CHECK( !allocator.Contains( 99 ) && !allocator.Contains( 116 ) );
+
+  int first  = allocator.Allocate();
+  int second = allocator.Allocate( 4 );
+  CHECK( first >= 100 && second >= 100 );
+  CHECK( second + 4 <= first || first + 1 <= second );
+  CHECK( !allocator.IsFree( first ) );
+  for ( int slot = second; slot < second + 4; ++slot )
+    CHECK( !allocator.IsFree( slot ) );
+
+  auto stats = allocator.GetStats();
+  CHECK( stats.capacity == 16 && stats.used == 5 );
+
+  // Only 11 slots are left.
+  CHECK( allocator.Allocate( 12 ) == -1 );
+  CHECK( allocator.Allocate( 11 ) >= 100 );
+  CHECK( allocator.Allocate() == -1 );
+  CHECK( allocator.GetStats().used == 16 && allocator.GetStats().freeRanges == 0 );
+}
+
+TEST_CASE( DescriptorAllocatorAllocateAt )
+{
+  DescriptorAllocator allocator( 0, 8 );
+
+  CHECK( allocator.AllocateAt( 3 ) );
+  CHECK( !allocator.AllocateAt( 3 ) );
+
+  // The slot splits the free range in two.
+  auto stats = allocator.GetStats();
+  CHECK( stats.used == 1 && stats.freeRanges == 2 && stats.largestFree == 4 );
+
+  // Neither side can hold five slots any more.
+  CHECK( allocator.Allocate( 5 ) == -1 );
+  CHECK( allocator.Allocate( 4 ) == 4 );
+  CHECK( allocator.Allocate( 3 ) == 0 );
+  CHECK( allocator.GetStats().used == 8 );
+}
+
+TEST_CASE( DescriptorAllocatorFreeCoalesces )
+{
+  DescriptorAllocator allocator( 10, 12 );
+
+  int a = allocator.Allocate( 4 );
+  int b = allocator.Allocate( 4 );
+  int c = allocator.Allocate( 4 );
+  CHECK( allocator.GetStats().freeRanges == 0 );
+
+  // Freeing the outer ranges leaves two holes, freeing the middle one joins all three.
+  allocator.Free( a, 4 );
+  allocator.Free( c, 4 );
+  CHECK( allocator.GetStats().freeRanges == 2 && allocator.GetStats().largestFree == 4 );
+
+  allocator.Free( b, 4 );
+  auto stats = allocator.GetStats();
+  CHECK( stats.used == 0 && stats.freeRanges == 1 && stats.largestFree == 12 );
+  CHECK( allocator.Allocate( 12 ) == 10 );
+
+  // Single slots freed out of order come back together as well.
+  for ( int slot = 10; slot < 22; slot += 2 )
+    allocator.Free( slot );
+  CHECK( allocator.GetStats().freeRanges == 6 );
+  for ( int slot = 11; slot < 22; slot += 2 )
+    allocator.Free( slot );
+  CHECK( allocator.GetStats().freeRanges == 1 && allocator.GetStats().largestFree == 12 );
+}
+
+TEST_CASE( DescriptorAllocatorGrow )
+{
+  DescriptorAllocator allocator( 0, 4 );
+
+  CHECK( allocator.Allocate( 2 ) == 0 );
+  CHECK( allocator.Allocate( 3 ) == -1 );
+
+  // The new slots join the free tail of the old ones.
+  allocator.Grow( 8 );
+  CHECK( allocator.GetCapacity() == 8 && allocator.Contains( 7 ) );
+
+  auto stats = allocator.GetStats();
+  CHECK( stats.used == 2 && stats.freeRanges == 1 && stats.largestFree == 6 );
+  CHECK( allocator.Allocate( 6 ) == 2 );
+
+  // Grown while full, the new slots are a range of their own.
+  allocator.Grow( 12 );
+  CHECK( allocator.Allocate( 4 ) == 8 );
+  CHECK( allocator.GetStats().used == 12 );
+
+  allocator.Free( 0, 2 );
+  allocator.Free( 8, 4 );
+  allocator.Free( 2, 6 );
+  CHECK( allocator.GetStats().freeRanges == 1 && allocator.GetStats().largestFree == 12 );
+}
@@ -0,0 +1,80 @@
+#include "TestRunner.h"
+#include "TestScene.h"
+#include "Scene/FrustumCulling.h"
+
+// Boxes touching a frustum plane can go either way, the two implementations round the corners differently.
+static bool IsBorderline( const SceneStore& sceneStore, int meshSlot, FXMMATRIX viewProjection )
+{
+  auto& slot    = sceneStore.GetMeshSlots()[ meshSlot ];
+  auto  mvp     = sceneStore.GetWorldTransform( sceneStore.GetMeshSlotNode( meshSlot ) ) * viewProjection;
+  auto  smaller = XMFLOAT4( slot.aabbExtents.x * 0.999f, slot.aabbExtents.y * 0.999f, slot.aabbExtents.z * 0.999f, 1 );
+  auto  larger  = XMFLOAT4( slot.aabbExtents.x * 1.001f, slot.aabbExtents.y * 1.001f, slot.aabbExtents.z * 1.001f, 1 );
+  return IsOBBVisible( mvp, slot.aabbCenter, smaller ) != IsOBBVisible( mvp, slot.aabbCenter, larger );
+}
+
+TEST_CASE( CullMeshSlotsMatchesReference )
+{
+  // Not a multiple of the block size, the tail block is culled too.
+  TestScene scene( 1001, 0xC0FFEE );
+
+  XMVECTOR eyes[] =
+  {
+    XMVectorSet(    0,   0, -150, 1 ),
+    XMVectorSet(  120,  40,    0, 1 ),
+    XMVectorSet(    0,   0,    0, 1 ),
+    XMVectorSet(  -30, 200,   10, 1 ),
+  };
+
+  for ( auto& eye : eyes )
+  {
+    auto viewProjection = GetTestViewProjection( eye, XMVectorSet( 10, 0, 5, 1 ) );
+
+    eastl::vector< uint8_t > visibility;
+    eastl::vector< uint8_t > referenceVisibility;
+    CullMeshSlots( scene.sceneStore, viewProjection, visibility );
+    CullMeshSlotsReference( scene.sceneStore, viewProjection, referenceVisibility );
+
+    CHECK( visibility.size() == scene.sceneStore.GetMeshSlots().size() );
+    CHECK( referenceVisibility.size() == visibility.size() );
+
+    int visibleCount = 0;
+    int mismatches   = 0;
+    for ( int meshSlot = 0; meshSlot < int( visibility.size() ); ++meshSlot )
+    {
+      visibleCount += referenceVisibility[ meshSlot ];
+      if ( visibility[ meshSlot ] != referenceVisibility[ meshSlot ] && !IsBorderline( scene.sceneStore, meshSlot, viewProjection ) )
+        mismatches++;
+    }
+
+    CHECK( mismatches == 0 );
+    CHECK( visibleCount > 0 && visibleCount < int( visibility.size() ) );
+  }
+}
+
+TEST_CASE( CullMeshSlotsKnownBoxes )
+{
+  TestScene scene( 0, 1 );
+
+  XMFLOAT3 center ( 0, 0, 0 );
+  XMFLOAT3 extents( 1, 1, 1 );
+
+  scene.AddMesh( scene.rootNode, center, extents );
+  scene.AddMesh( scene.AddNode( scene.rootNode, XMMatrixIdentity() ), center, extents );
+  scene.AddMesh( scene.AddNode( scene.rootNode, XMMatrixTranslation( 0, 0, -50 ) ), center, extents );
+  scene.AddMesh( scene.AddNode( scene.rootNode, XMMatrixTranslation( -500, 0, 0 ) ), center, extents );
+  scene.AddMesh( scene.AddNode( scene.rootNode, XMMatrixTranslation( 0, 0, 20 ) ), center, extents );
+  scene.Build();
+
+  auto viewProjection = GetTestViewProjection( XMVectorSet( 0, 0, -10, 1 ), XMVectorSet( 0, 0, 0, 1 ) );
+
+  eastl::vector< uint8_t > visibility;
+  CullMeshSlots( scene.sceneStore, viewProjection, visibility );
+
+  // The root meshes, in front of the camera, behind it, far to the side, further in front.
+  CHECK( visibility.size() == 5 );
+  CHECK( visibility[ 0 ] == 0 );
+  CHECK( visibility[ 1 ] == 1 );
+  CHECK( visibility[ 2 ] == 0 );
+  CHECK( visibility[ 3 ] == 0 );
+  CHECK( visibility[ 4 ] == 1 );
+}
@@ -0,0 +1,109 @@
+#include "TestRunner.h"
+#include "Render/GPUPassStatistics.h"
+
+static constexpr wchar_t testCSVPath[] = L"TestGPUPassStatistics.csv";
+
+static const GPUPassStatistics::PassStats* FindPass( const eastl::vector< GPUPassStatistics::PassStats >& stats, const wchar_t* name )
+{
+  for ( auto& passStats : stats )
+    if ( passStats.name == name )
+      return &passStats;
+
+  return nullptr;
+}
+
+TEST_CASE( GPUPassStatisticsPercentiles )
+{
+  GPUPassStatistics statistics( 20 );
+
+  // 1 to 20 ms out of order, and a pass recorded twice in every frame.
+  for ( int frameIx = 0; frameIx < 20; ++frameIx )
+  {
+    statistics.AddSample( L"Main", ( frameIx * 7 ) % 20 + 1 );
+    statistics.AddSample( L"Shadow", 1.5 );
+    statistics.AddSample( L"Shadow", 2.5 );
+    statistics.EndFrame();
+  }
+
+  auto stats = statistics.GetStats();
+  CHECK( stats.size() == 2 );
+  CHECK( stats[ 0 ].name == L"Main" && stats[ 1 ].name == L"Shadow" );
+
+  // Nearest rank, the 10th and the 19th of the sorted 20.
+  auto& mainPass = stats[ 0 ];
+  CHECK( mainPass.samples == 20 );
+  CHECK( mainPass.average == 10.5 );
+  CHECK( mainPass.median == 10 );
+  CHECK( mainPass.p95 == 19 );
+  CHECK( mainPass.max == 20 );
+
+  auto& shadow = stats[ 1 ];
+  CHECK( shadow.average == 4 && shadow.median == 4 && shadow.p95 == 4 && shadow.max == 4 );
+}
+
+TEST_CASE( GPUPassStatisticsRollingHistory )
+{
+  GPUPassStatistics statistics( 4 );
+
+  CHECK( statistics.GetStats().empty() );
+
+  statistics.AddSample( L"Once", 100 );
+  statistics.EndFrame();
+
+  // Only the last 4 frames count, 7 to 10 ms.
+  for ( int frameIx = 1; frameIx <= 10; ++frameIx )
+  {
+    statistics.AddSample( L"Main", frameIx );
+    statistics.EndFrame();
+
+    // Not recorded since the first frame, the pass stays for a whole history, then it is dropped.
+    CHECK( ( FindPass( statistics.GetStats(), L"Once" ) != nullptr ) == ( frameIx < 4 ) );
+  }
+
+  auto stats = statistics.GetStats();
+  CHECK( stats.size() == 1 );
+
+  auto mainPass = FindPass( stats, L"Main" );
+  CHECK( mainPass && mainPass->samples == 4 );
+  CHECK( mainPass && mainPass->average == 8.5 );
+  CHECK( mainPass && mainPass->median == 8 );
+  CHECK( mainPass && mainPass->p95 == 10 );
+  CHECK( mainPass && mainPass->max == 10 );
+
+  // A frame without the pass does not add a zero sample.
+  statistics.EndFrame();
+  stats    = statistics.GetStats();
+  mainPass = FindPass( stats, L"Main" );
+  CHECK( mainPass && mainPass->average == 8.5 );
+}
+
+TEST_CASE( GPUPassStatisticsCSV )
+{
+  GPUPassStatistics statistics( 8 );
+
+  statistics.AddSample( L"Depth \"prepass\"", 0.25 );
+  statistics.AddSample( L"Lighting, tiled", 1.5 );
+  statistics.EndFrame();
+  statistics.AddSample( L"Lighting, tiled", 2.5 );
+  statistics.EndFrame();
+
+  CHECK( statistics.WriteCSV( testCSVPath ) );
+
+  eastl::string csv;
+  FILE* fileHandle = nullptr;
+  CHECK( _wfopen_s( &fileHandle, testCSVPath, L"rb" ) == 0 );
+  if ( fileHandle )
+  {
+    char buffer[ 256 ];
+    while ( auto readSize = fread( buffer, 1, sizeof( buffer ), fileHandle ) )
+      csv.append( buffer, buffer + readSize );
+    fclose( fileHandle );
+  }
+
+  // The names are quoted with their quotes doubled, so commas and quotes in them survive.
+  CHECK( csv == "pass,average_ms,median_ms,p95_ms,max_ms,samples\n"
+                "\"Depth \"\"prepass\"\"\",0.2500,0.2500,0.2500,0.2500,1\n"
+                "\"Lighting, tiled\",2.0000,1.5000,2.5000,2.5000,2\n" );
+
+  _wremove( testCSVPath );
+}
@@ -0,0 +1,91 @@
+#include "TestRunner.h"
+#include "Scene/HiZPyramid.h"
+
+static float Farthest( float a, float b )
+{
+  #if USE_REVERSE_PROJECTION
+    return eastl::min( a, b );
+  #else
+    return eastl::max( a, b );
+  #endif
+}
+
+// Depth values the same distance from the near or the far plane, in the projection convention in use.
+static float Depth( float distance )
+{
+  #if USE_REVERSE_PROJECTION
+    return 1 - distance;
+  #else
+    return distance;
+  #endif
+}
+
+TEST_CASE( HiZPyramidLevels )
+{
+  // Odd sizes, the last row and column of every level also cover the leftover texels.
+  static constexpr int width  = 13;
+  static constexpr int height = 7;
+
+  eastl::vector< float > depth( width * height );
+  for ( int texelIx = 0; texelIx < width * height; ++texelIx )
+    depth[ texelIx ] = float( ( texelIx * 37 ) % 101 ) / 100;
+
+  HiZPyramid pyramid;
+  pyramid.Build( depth.data(), width, height );
+
+  CHECK( pyramid.GetLevelWidth( 0 ) == 6 && pyramid.GetLevelHeight( 0 ) == 3 );
+  CHECK( pyramid.GetLevelWidth( 1 ) == 3 && pyramid.GetLevelHeight( 1 ) == 1 );
+  CHECK( pyramid.GetLevelWidth( 2 ) == 1 && pyramid.GetLevelHeight( 2 ) == 1 );
+  CHECK( pyramid.GetLevelWidth( HiZLevelCount - 1 ) == 1 && pyramid.GetLevelHeight( HiZLevelCount - 1 ) == 1 );
+
+  auto farthestIn = [ & ]( int x0, int y0, int x1, int y1 )
+  {
+    float farthest = depth[ y0 * width + x0 ];
+    for ( int y = y0; y <= y1; ++y )
+      for ( int x = x0; x <= x1; ++x )
+        farthest = Farthest( farthest, depth[ y * width + x ] );
+    return farthest;
+  };
+
+  auto level0 = pyramid.GetLevel( 0 );
+  CHECK( level0[ 0 ] == farthestIn( 0, 0, 1, 1 ) );
+  CHECK( level0[ 7 ] == farthestIn( 2, 2, 3, 3 ) );
+  CHECK( level0[ 5 ] == farthestIn( 10, 0, 12, 1 ) );
+  CHECK( level0[ 17 ] == farthestIn( 10, 4, 12, 6 ) );
+
+  auto level1 = pyramid.GetLevel( 1 );
+  CHECK( level1[ 2 ] == farthestIn( 8, 0, 12, 6 ) );
+
+  for ( int level = 2; level < HiZLevelCount; ++level )
+    CHECK( pyramid.GetLevel( level )[ 0 ] == farthestIn( 0, 0, width - 1, height - 1 ) );
+}
+
+TEST_CASE( HiZPyramidOcclusion )
+{
+  static constexpr int size = 64;
+
+  // A wall at depth 0.5 in front of the whole screen. The orthographic mvp keeps the box z as the depth.
+  eastl::vector< float > depth( size * size, Depth( 0.5f ) );
+  auto mvp = XMMatrixScaling( 0.1f, 0.1f, 1 );
+
+  HiZPyramid pyramid;
+  CHECK( !pyramid.IsOccluded( mvp, XMFLOAT4( 0, 0, Depth( 0.8f ), 1 ), XMFLOAT4( 1, 1, 0.05f, 0 ) ) );
+
+  pyramid.Build( depth.data(), size, size );
+
+  CHECK( pyramid.IsOccluded( mvp, XMFLOAT4( 0, 0, Depth( 0.8f ), 1 ), XMFLOAT4( 1, 1, 0.05f, 0 ) ) );
+  CHECK( !pyramid.IsOccluded( mvp, XMFLOAT4( 0, 0, Depth( 0.2f ), 1 ), XMFLOAT4( 1, 1, 0.05f, 0 ) ) );
+
+  // Reaching in front of the wall.
+  CHECK( !pyramid.IsOccluded( mvp, XMFLOAT4( 0, 0, Depth( 0.8f ), 1 ), XMFLOAT4( 1, 1, 0.4f, 0 ) ) );
+
+  // Off screen, left for the frustum culling.
+  CHECK( !pyramid.IsOccluded( mvp, XMFLOAT4( 50, 0, Depth( 0.8f ), 1 ), XMFLOAT4( 1, 1, 0.05f, 0 ) ) );
+
+  // A single far texel under the box is enough to see it through.
+  depth[ 30 * size + 30 ] = Depth( 1 );
+  pyramid.Build( depth.data(), size, size );
+
+  CHECK( !pyramid.IsOccluded( mvp, XMFLOAT4( 0, 0, Depth( 0.8f ), 1 ), XMFLOAT4( 1, 1, 0.05f, 0 ) ) );
+  CHECK( pyramid.IsOccluded( mvp, XMFLOAT4( -5, -5, Depth( 0.8f ), 1 ), XMFLOAT4( 1, 1, 0.05f, 0 ) ) );
+}
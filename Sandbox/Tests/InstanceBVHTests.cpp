@@ -0,0 +1,234 @@
+#include "TestRunner.h"
+#include "TestScene.h"
+#include "Scene/InstanceBVH.h"
+#include "Scene/FrustumCulling.h"
+
+static void GetWorldBounds( const SceneStore& sceneStore, int meshSlot, XMVECTOR& aabbMin, XMVECTOR& aabbMax )
+{
+  auto& mesh      = sceneStore.GetMeshSlots()[ meshSlot ];
+  auto  transform = sceneStore.GetWorldTransform( sceneStore.GetMeshSlotNode( meshSlot ) );
+
+  BoundingBox box( XMFLOAT3( mesh.aabbCenter.x, mesh.aabbCenter.y, mesh.aabbCenter.z ), XMFLOAT3( mesh.aabbExtents.x, mesh.aabbExtents.y, mesh.aabbExtents.z ) );
+  box.Transform( box, transform );
+
+  aabbMin = XMVectorSubtract( XMLoadFloat3( &box.Center ), XMLoadFloat3( &box.Extents ) );
+  aabbMax = XMVectorAdd( XMLoadFloat3( &box.Center ), XMLoadFloat3( &box.Extents ) );
+}
+
+static bool Contains( const BVHNode& node, FXMVECTOR aabbMin, FXMVECTOR aabbMax )
+{
+  auto epsilon = XMVectorReplicate( 0.001f );
+  return XMVector3GreaterOrEqual( aabbMin, XMVectorSubtract( XMLoadFloat3( &node.aabbMin ), epsilon ) )
+      && XMVector3LessOrEqual( aabbMax, XMVectorAdd( XMLoadFloat3( &node.aabbMax ), epsilon ) );
+}
+
+// Every mesh slot off the root is in exactly one leaf, and every node bounds everything below it.
+static int CountTreeErrors( const InstanceBVH& bvh, const SceneStore& sceneStore )
+{
+  auto& nodes         = bvh.GetNodes();
+  auto& leafMeshSlots = bvh.GetLeafMeshSlots();
+
+  int errors = 0;
+
+  eastl::vector< int > leafCounts( sceneStore.GetMeshSlots().size(), 0 );
+
+  eastl::vector< int > stack;
+  stack.push_back( 0 );
+  while ( !stack.empty() )
+  {
+    auto& node = nodes[ stack.back() ];
+    stack.pop_back();
+
+    if ( node.instanceCount > 0 )
+    {
+      for ( int leafIx = node.leftOrFirst; leafIx < node.leftOrFirst + node.instanceCount; ++leafIx )
+      {
+        int meshSlot = leafMeshSlots[ leafIx ];
+        leafCounts[ meshSlot ]++;
+
+        XMVECTOR aabbMin, aabbMax;
+        GetWorldBounds( sceneStore, meshSlot, aabbMin, aabbMax );
+        errors += !Contains( node, aabbMin, aabbMax );
+      }
+      continue;
+    }
+
+    for ( int childIx = node.leftOrFirst; childIx < node.leftOrFirst + 2; ++childIx )
+    {
+      auto& child = nodes[ childIx ];
+      errors += !Contains( node, XMLoadFloat3( &child.aabbMin ), XMLoadFloat3( &child.aabbMax ) );
+      stack.push_back( childIx );
+    }
+  }
+
+  for ( int meshSlot = 0; meshSlot < int( leafCounts.size() ); ++meshSlot )
+    errors += leafCounts[ meshSlot ] != ( sceneStore.GetMeshSlotNode( meshSlot ) != 0 ? 1 : 0 );
+
+  return errors;
+}
+
+static eastl::vector< int > QuerySphereBruteForce( const SceneStore& sceneStore, FXMVECTOR center, float radius )
+{
+  eastl::vector< int > meshSlots;
+  for ( int meshSlot = 0; meshSlot < int( sceneStore.GetMeshSlots().size() ); ++meshSlot )
+  {
+    if ( sceneStore.GetMeshSlotNode( meshSlot ) == 0 )
+      continue;
+
+    XMVECTOR aabbMin, aabbMax;
+    GetWorldBounds( sceneStore, meshSlot, aabbMin, aabbMax );
+
+    auto closest = XMVectorClamp( center, aabbMin, aabbMax );
+    if ( XMVectorGetX( XMVector3LengthSq( XMVectorSubtract( closest, center ) ) ) <= radius * radius )
+      meshSlots.push_back( meshSlot );
+  }
+  return meshSlots;
+}
+
+static eastl::vector< int > QuerySphereSorted( const InstanceBVH& bvh, FXMVECTOR center, float radius )
+{
+  eastl::vector< int > meshSlots;
+  bvh.QuerySphere( center, radius, meshSlots );
+  eastl::sort( meshSlots.begin(), meshSlots.end() );
+  return meshSlots;
+}
+
+TEST_CASE( InstanceBVHBuild )
+{
+  TestScene scene( 1000, 0x5EED );
+
+  InstanceBVH bvh;
+  bvh.Build( scene.sceneStore );
+
+  CHECK( !bvh.GetNodes().empty() );
+  CHECK( CountTreeErrors( bvh, scene.sceneStore ) == 0 );
+
+  // The SAH keeps the leaves small, the random boxes are far from the all in one spot case.
+  int largestLeaf = 0;
+  for ( auto& node : bvh.GetNodes() )
+    largestLeaf = eastl::max( largestLeaf, node.instanceCount );
+  CHECK( largestLeaf <= 8 );
+
+  for ( float radius : { 0.0f, 5.0f, 30.0f, 1000.0f } )
+  {
+    auto center = XMVectorSet( 10, -20, 30, 1 );
+    CHECK( QuerySphereSorted( bvh, center, radius ) == QuerySphereBruteForce( scene.sceneStore, center, radius ) );
+  }
+}
+
+// Two clusters far apart, the first split has to separate them.
+TEST_CASE( InstanceBVHSAHSplitsClusters )
+{
+  TestScene scene( 0, 1 );
+
+  for ( int nodeIx = 0; nodeIx < 32; ++nodeIx )
+  {
+    float x = nodeIx < 16 ? -1000.0f : 1000.0f;
+    auto& node = scene.AddNode( scene.rootNode, XMMatrixTranslation( x + scene.Random() * 10, scene.Random() * 10, scene.Random() * 10 ) );
+    scene.AddMesh( node, XMFLOAT3( 0, 0, 0 ), XMFLOAT3( 1, 1, 1 ) );
+  }
+  scene.Build();
+
+  InstanceBVH bvh;
+  bvh.Build( scene.sceneStore );
+
+  auto& nodes = bvh.GetNodes();
+  CHECK( nodes[ 0 ].instanceCount == 0 );
+
+  auto& left  = nodes[ nodes[ 0 ].leftOrFirst ];
+  auto& right = nodes[ nodes[ 0 ].leftOrFirst + 1 ];
+  CHECK( ( left.aabbMax.x < 0 && right.aabbMin.x > 0 ) || ( right.aabbMax.x < 0 && left.aabbMin.x > 0 ) );
+  CHECK( CountTreeErrors( bvh, scene.sceneStore ) == 0 );
+}
+
+TEST_CASE( InstanceBVHRefit )
+{
+  TestScene scene( 500, 0xF17 );
+
+  InstanceBVH bvh;
+  bvh.Build( scene.sceneStore );
+
+  auto& store = scene.sceneStore;
+
+  // Move a child of the root with meshes far away, so its world position is known, and another node a bit.
+  int farSlot = store.GetInstanceCount() - 1;
+  while ( store.GetParentIndex( store.GetMeshSlotNode( farSlot ) ) != 0 )
+    farSlot--;
+
+  int farNode = store.GetMeshSlotNode( farSlot );
+
+  int nearNode = store.GetMeshSlotNode( store.GetInstanceCount() / 2 );
+  CHECK( nearNode != 0 && farNode != nearNode );
+
+  auto farPosition = XMVectorSet( 5000, 0, 0, 1 );
+  store.SetLocalTransform( farNode, XMMatrixTranslationFromVector( farPosition ) );
+  store.SetLocalTransform( nearNode, store.GetLocalTransform( nearNode ) * XMMatrixTranslation( 3, 0, 0 ) );
+
+  eastl::vector< int > movedNodes;
+  store.UpdateWorldTransforms( &movedNodes );
+  bvh.Refit( store, movedNodes.data(), int( movedNodes.size() ) );
+
+  CHECK( CountTreeErrors( bvh, store ) == 0 );
+
+  // The refit root reaches out to the moved node, and the queries find it there.
+  CHECK( bvh.GetNodes()[ 0 ].aabbMax.x > 4900 );
+
+  auto found = QuerySphereSorted( bvh, farPosition, 20 );
+  CHECK( !found.empty() );
+  CHECK( found == QuerySphereBruteForce( store, farPosition, 20 ) );
+
+  for ( float radius : { 5.0f, 50.0f } )
+  {
+    auto center = XMVectorSet( 0, 0, 0, 1 );
+    CHECK( QuerySphereSorted( bvh, center, radius ) == QuerySphereBruteForce( store, center, radius ) );
+  }
+}
+
+// The projected corner test of the culling can keep boxes behind the camera, those are not compared.
+static bool IsInFrontOfCamera( const SceneStore& sceneStore, int meshSlot, FXMMATRIX viewProjection )
+{
+  XMVECTOR aabbMin, aabbMax;
+  GetWorldBounds( sceneStore, meshSlot, aabbMin, aabbMax );
+
+  for ( int cornerIx = 0; cornerIx < 8; ++cornerIx )
+  {
+    auto corner = XMVectorSelect( aabbMin, aabbMax, XMVectorSelectControl( cornerIx & 1, ( cornerIx >> 1 ) & 1, ( cornerIx >> 2 ) & 1, 0 ) );
+    if ( XMVectorGetW( XMVector3Transform( corner, viewProjection ) ) <= 0 )
+      return false;
+  }
+
+  return true;
+}
+
+// The BVH query is conservative, every mesh slot the exact culling keeps has to be among its candidates.
+TEST_CASE( InstanceBVHFrustumQueryCoversCulling )
+{
+  TestScene scene( 1000, 0xC0FFEE );
+
+  InstanceBVH bvh;
+  bvh.Build( scene.sceneStore );
+
+  auto viewProjection = GetTestViewProjection( XMVectorSet( 0, 0, -150, 1 ), XMVectorSet( 10, 0, 5, 1 ) );
+
+  eastl::vector< uint8_t > visibility;
+  CullMeshSlots( scene.sceneStore, viewProjection, visibility );
+
+  eastl::vector< int > candidates;
+  bvh.QueryFrustum( viewProjection, candidates );
+
+  eastl::vector< uint8_t > isCandidate( visibility.size(), 0 );
+  for ( int meshSlot : candidates )
+    isCandidate[ meshSlot ]++;
+
+  int missed     = 0;
+  int duplicates = 0;
+  for ( int meshSlot = 0; meshSlot < int( visibility.size() ); ++meshSlot )
+  {
+    missed     += visibility[ meshSlot ] && !isCandidate[ meshSlot ] && IsInFrontOfCamera( scene.sceneStore, meshSlot, viewProjection );
+    duplicates += isCandidate[ meshSlot ] > 1;
+  }
+
+  CHECK( missed == 0 );
+  CHECK( duplicates == 0 );
+  CHECK( candidates.size() < visibility.size() );
+}
@@ -0,0 +1,22 @@
+#include "TestRunner.h"
+#include "Common/JSON.h"
+
+TEST_CASE( JSONEscapeRoundTrip )
+{
+  eastl::string json;
+  AppendJSONEscaped( json, "Pass \"quoted\" C:\\path\n" );
+  CHECK( json == "Pass \\\"quoted\\\" C:\\\\path" );
+
+  json += "\", \"median\": 1.0";
+
+  eastl::string text;
+  auto end = ReadJSONString( json.data(), text );
+  CHECK( end && strcmp( end, ", \"median\": 1.0" ) == 0 );
+  CHECK( text == "Pass \"quoted\" C:\\path" );
+}
+
+TEST_CASE( JSONUnterminatedString )
+{
+  eastl::string text;
+  CHECK( ReadJSONString( "no closing quote\\\"", text ) == nullptr );
+}
@@ -0,0 +1,110 @@
+#include "TestRunner.h"
+#include "Render/LowDiscrepancy.h"
+
+using namespace LowDiscrepancy;
+
+// Every one of the count bins of [0,1) gets exactly one of the first count values.
+template< typename Value >
+static bool IsStratified( int count, Value value )
+{
+  eastl::vector< int > bins( count, 0 );
+  for ( int valueIx = 0; valueIx < count; ++valueIx )
+  {
+    int bin = int( value( valueIx ) * count );
+    if ( bin < 0 || bin >= count || bins[ bin ]++ )
+      return false;
+  }
+  return true;
+}
+
+TEST_CASE( LowDiscrepancyHalton )
+{
+  CHECK( Halton( 0, 0 ) == 0 && Halton( 0, 1 ) == 0 );
+
+  // Base 2, 3 and 5 radical inverses.
+  CHECK( Halton( 1, 0 ) == 0.5f && Halton( 2, 0 ) == 0.25f && Halton( 3, 0 ) == 0.75f && Halton( 4, 0 ) == 0.125f );
+  CHECK( Halton( 1, 1 ) == float( 1.0 / 3 ) && Halton( 2, 1 ) == float( 2.0 / 3 ) );
+  CHECK( Halton( 3, 1 ) == float( 1.0 / 9 ) && Halton( 5, 1 ) == float( 7.0 / 9 ) );
+  CHECK( Halton( 1, 2 ) == 0.2f && Halton( 6, 2 ) == float( 1.0 / 5 + 1.0 / 25 ) );
+
+  auto value = Halton2D( 7 );
+  CHECK( value.x == 0.875f && value.y == float( 1.0 / 3 + 2.0 / 9 ) );
+
+  // Values right below one stay there after the rounding to float.
+  CHECK( Halton( 0xFFFFFFFF, 0 ) < 1 && Halton( 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 - 1, 1 ) < 1 );
+
+  // The values are exactly on the bin edges, half a bin keeps the float rounding from moving them down one.
+  for ( int dimension = 0; dimension < HaltonMaxDimension; ++dimension )
+  {
+    int count = int( haltonBases[ dimension ] * haltonBases[ dimension ] );
+    CHECK( IsStratified( count, [ & ]( int index ) { return Halton( index, dimension ) + 0.5f / count; } ) );
+  }
+}
+
+TEST_CASE( LowDiscrepancyR2 )
+{
+  // The plastic number g is the real root of x^3 = x + 1, and the nth value is frac( 0.5 + n / g^d ).
+  const double g = 1.32471795724474602596;
+
+  auto first = R2( 0 );
+  CHECK( first.x == 0.5f && first.y == 0.5f );
+
+  for ( uint32_t index : { 1u, 2u, 3u, 100u, 12345u } )
+  {
+    auto   value     = R2( index );
+    double expectedX = fmod( 0.5 + index / g, 1.0 );
+    double expectedY = fmod( 0.5 + index / ( g * g ), 1.0 );
+    CHECK( fabs( value.x - expectedX ) < 1e-5 );
+    CHECK( fabs( value.y - expectedY ) < 1e-5 );
+  }
+}
+
+TEST_CASE( LowDiscrepancySobol )
+{
+  // The first dimension is the base 2 radical inverse, the second the classic 1, 3, 5, 15 direction numbers.
+  for ( uint32_t index = 0; index < 64; ++index )
+    CHECK( Sobol( index, 0 ) == ReverseBits( index ) );
+
+  CHECK( Sobol( 1, 1 ) == 0x80000000 && Sobol( 2, 1 ) == 0xC0000000 && Sobol( 4, 1 ) == 0xA0000000 && Sobol( 8, 1 ) == 0xF0000000 );
+  CHECK( Sobol( 3, 1 ) == 0x40000000 );
+
+  // The third dimension from x^2 + x + 1, with m = 1, 3 and the recurrence giving m3 = 3.
+  CHECK( Sobol( 1, 2 ) == 0x80000000 && Sobol( 2, 2 ) == 0xC0000000 && Sobol( 4, 2 ) == 0x60000000 );
+
+  for ( int dimension = 0; dimension < SobolMaxDimension; ++dimension )
+    for ( int count : { 2, 16, 256 } )
+      CHECK( IsStratified( count, [ & ]( int index ) { return ToUnitFloat( Sobol( index, dimension ) ); } ) );
+
+  // The first two dimensions form a ( 0, 2 ) sequence, 16 points put one in every cell of a 4 x 4 grid.
+  int cells = 0;
+  for ( uint32_t index = 0; index < 16; ++index )
+    cells |= 1 << ( ( Sobol( index, 0 ) >> 30 ) * 4 + ( Sobol( index, 1 ) >> 30 ) );
+  CHECK( cells == 0xFFFF );
+}
+
+TEST_CASE( LowDiscrepancyOwenSobol )
+{
+  // The scrambling keeps the stratification of any power of two prefix.
+  for ( uint32_t seed : { 0u, 1u, 0x5EEDu } )
+    for ( int dimension = 0; dimension < 4; ++dimension )
+      for ( int count : { 4, 64 } )
+        CHECK( IsStratified( count, [ & ]( int index ) { return ToUnitFloat( OwenSobol( index, dimension, seed ) ); } ) );
+
+  // Different seeds and dimensions give different sequences, the same seed the same one.
+  int sameAcrossSeeds      = 0;
+  int sameAcrossDimensions = 0;
+  for ( uint32_t index = 0; index < 64; ++index )
+  {
+    sameAcrossSeeds      += OwenSobol( index, 0, 1 ) == OwenSobol( index, 0, 2 );
+    sameAcrossDimensions += OwenSobol( index, 0, 1 ) == OwenSobol( index, 1, 1 );
+    CHECK( OwenSobol( index, 2, 7 ) == OwenSobol( index, 2, 7 ) );
+  }
+  CHECK( sameAcrossSeeds < 4 );
+  CHECK( sameAcrossDimensions < 4 );
+
+  // The table of the missing sobol_256_4d.dds takes the top byte of the first four dimensions.
+  auto table = BuildSobolTable( 256, 0x5EED );
+  CHECK( table.size() == 256 * 4 );
+  CHECK( table[ 10 * 4 + 3 ] == uint8_t( OwenSobol( 10, 3, 0x5EED ) >> 24 ) );
+  CHECK( IsStratified( 256, [ & ]( int index ) { return table[ index * 4 + 1 ] / 256.0f; } ) );
+}
@@ -0,0 +1,764 @@
+#include "TestRunner.h"
+#include "TestDevice.h"
+#include "TestScene.h"
+#include "Common/Signal.h"
+#include "Common/AsyncJobThread.h"
+#include "Common/MappedFile.h"
+#include "Common/ParallelFor.h"
+#include "Render/Device.h"
+#include "Render/CommandQueue.h"
+#include "Render/CommandList.h"
+#include "Render/CommandAllocator.h"
+#include "Render/CommandAllocatorPool.h"
+#include "Render/ComputeShader.h"
+#include "Render/Resource.h"
+#include "Render/ParallelCommandRecorder.h"
+#include "Render/UploadAllocator.h"
+#include "Render/DeferredReleaseQueue.h"
+#include "Render/DescriptorAllocator.h"
+#include "Render/LowDiscrepancy.h"
+#include "Render/RTInstanceRing.h"
+#include "Render/D3D12/D3DTileHeap.h"
+#include "Scene/HiZPyramid.h"
+#include "../TextureTiler/TileCopy.h"
+
+// Takes two textures worth of tiles and gives them back, the alloc searches the usage of the textures first fit.
+MICRO_BENCHMARK( TileHeapAllocFree )
+{
+  static constexpr int tileCount = TileCount * TileCount * 2;
+
+  // Kept for the whole run, every texture of the heap takes a descriptor slot for good.
+  auto&       device      = GetTestDevice();
+  static auto directQueue = device.CreateCommandQueue( CommandQueueType::Direct );
+  static auto tileHeap    = eastl::make_unique< D3DTileHeap >( device, PixelFormat::BC1UN, L"BenchmarkTileHeap" );
+
+  eastl::vector< TileHeap::Allocation > allocations( tileCount );
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    for ( auto& allocation : allocations )
+      allocation = tileHeap->alloc( device, *directQueue );
+    for ( auto& allocation : allocations )
+      tileHeap->free( allocation );
+  }
+}
+
+// A 4K BC1 mip cut into 512x256 tiles, as the TextureTiler does.
+MICRO_BENCHMARK( TextureTilerBC1Mip )
+{
+  static constexpr int mipBlockWidth   = 1024;
+  static constexpr int mipBlockHeight  = 1024;
+  static constexpr int tileBlockWidth  = 128;
+  static constexpr int tileBlockHeight = 64;
+  static constexpr int blockSize       = 8;
+
+  eastl::vector< uint8_t > mipData( mipBlockWidth * mipBlockHeight * blockSize );
+  eastl::vector< uint8_t > tileData( tileBlockWidth * tileBlockHeight * blockSize );
+  for ( int byteIx = 0; byteIx < int( mipData.size() ); ++byteIx )
+    mipData[ byteIx ] = uint8_t( byteIx * 31 );
+
+  uint32_t checksum = 0;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    CopyMipTiles( mipData.data()
+                , mipBlockWidth
+                , mipBlockHeight
+                , tileBlockWidth
+                , tileBlockHeight
+                , blockSize
+                , tileData.data()
+                , tileData.size()
+                , [ & ]( int tx, int ty ) { checksum += tileData[ tx + ty ]; return true; } );
+  }
+
+  timing.Stop();
+
+  KeepValue( checksum );
+}
+
+// Eight connected functions, like the window signals have at most.
+MICRO_BENCHMARK( SignalDispatch )
+{
+  Signal< int, int > signal;
+
+  int sum = 0;
+  for ( int functionIx = 0; functionIx < 8; ++functionIx )
+    signal.Connect( [ &sum ]( int x, int y ) { sum += x + y; } );
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    signal( iterationIx, 1 );
+
+  timing.Stop();
+
+  KeepValue( sum );
+}
+
+class BenchmarkJobThread : public AsyncJobThread< int >
+{
+public:
+  BenchmarkJobThread()
+  {
+    Start( [ this ]( int& job ) { processed.fetch_add( 1, eastl::memory_order_release ); }, "BenchmarkJobThread" );
+  }
+
+  using AsyncJobThread::Enqueue;
+
+  eastl::atomic< int > processed = 0;
+};
+
+// A job is enqueued by the calling thread and taken by the worker, the time is up when all of them are taken.
+MICRO_BENCHMARK( AsyncJobThreadEnqueue )
+{
+  BenchmarkJobThread jobThread;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    jobThread.Enqueue( int( iterationIx ) );
+
+  while ( jobThread.processed.load( eastl::memory_order_acquire ) < timing.iterations )
+    std::this_thread::yield();
+
+  timing.Stop();
+}
+
+// Four passes like the ray traced ones of a frame, each with a few hundred dispatches, recorded into null lists.
+// The lists are created in the loop, as the frame creates them too.
+struct RecordingSetup
+{
+  static constexpr int passCount         = 4;
+  static constexpr int dispatchesPerPass = 256;
+
+  RecordingSetup()
+  {
+    auto& device = GetTestDevice();
+
+    shader = device.CreateComputeShader( nullptr, 0, L"BenchmarkShader" );
+    input  = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, false, 1024, 4, L"BenchmarkInput" );
+
+    for ( int passIx = 0; passIx < passCount; ++passIx )
+    {
+      outputs   [ passIx ] = device.CreateBuffer( ResourceType::Buffer, HeapType::Default, true, 1024, 4, L"BenchmarkOutput" );
+      allocators[ passIx ] = device.CreateCommandAllocator( CommandQueueType::Direct );
+    }
+  }
+
+  void RecordPass( CommandList& commandList, int passIx )
+  {
+    for ( int dispatchIx = 0; dispatchIx < dispatchesPerPass; ++dispatchIx )
+    {
+      commandList.SetComputeShader( *shader );
+      commandList.SetComputeShaderResourceView( 0, *input );
+      commandList.SetComputeUnorderedAccessView( 1, *outputs[ passIx ] );
+      commandList.SetComputeConstantValues( 2, &dispatchIx, 1 );
+      commandList.Dispatch( 64, 1, 1 );
+      commandList.AddUAVBarrier( { *outputs[ passIx ] } );
+    }
+  }
+
+  ParallelCommandRecorder::RecordedLists CreateLists()
+  {
+    ParallelCommandRecorder::RecordedLists commandLists( passCount );
+    for ( int passIx = 0; passIx < passCount; ++passIx )
+    {
+      commandLists[ passIx ].second = allocators[ passIx ].get();
+      commandLists[ passIx ].first  = GetTestDevice().CreateCommandList( *allocators[ passIx ], CommandQueueType::Direct, 0 );
+    }
+    return commandLists;
+  }
+
+  eastl::unique_ptr< ComputeShader >    shader;
+  eastl::unique_ptr< Resource >         input;
+  eastl::unique_ptr< Resource >         outputs   [ passCount ];
+  eastl::unique_ptr< CommandAllocator > allocators[ passCount ];
+};
+
+MICRO_BENCHMARK( PassRecordingSerial )
+{
+  static RecordingSetup setup;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    auto commandLists = setup.CreateLists();
+    for ( int passIx = 0; passIx < RecordingSetup::passCount; ++passIx )
+      setup.RecordPass( *commandLists[ passIx ].first, passIx );
+  }
+}
+
+MICRO_BENCHMARK( PassRecordingParallel )
+{
+  static RecordingSetup          setup;
+  static ParallelCommandRecorder recorder;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    auto commandLists = setup.CreateLists();
+    for ( int passIx = 0; passIx < RecordingSetup::passCount; ++passIx )
+      recorder.AddPass( L"Benchmark pass", [ passIx ]( CommandList& commandList ) { setup.RecordPass( commandList, passIx ); } );
+    recorder.Record( commandLists );
+  }
+}
+
+// The passes of a frame recorded on the worker pool, each with an allocator of the pool, with two frames in flight.
+// The peak is logged after the run, it stays at the allocators of the frames in flight however long the run is.
+MICRO_BENCHMARK( CommandAllocatorPoolParallelRecording )
+{
+  static constexpr int framesInFlight = 2;
+
+  static RecordingSetup setup;
+
+  auto& device = GetTestDevice();
+
+  CommandAllocatorPool pool( CommandQueueType::Direct );
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    uint64_t fence          = iterationIx + 1;
+    uint64_t completedFence = fence > framesInFlight ? fence - framesInFlight : 0;
+
+    ParallelFor( RecordingSetup::passCount, 1, [ & ]( int begin, int end )
+    {
+      for ( int passIx = begin; passIx < end; ++passIx )
+      {
+        auto allocator   = pool.RequestAllocator( device, completedFence );
+        auto commandList = device.CreateCommandList( *allocator, CommandQueueType::Direct, 0 );
+        setup.RecordPass( *commandList, passIx );
+        pool.DiscardAllocator( fence, allocator );
+      }
+    } );
+  }
+
+  timing.Stop();
+
+  auto stats = pool.GetStats();
+
+  char line[ 128 ];
+  sprintf_s( line, "CommandAllocatorPoolParallelRecording: %d allocators at peak, %d live\n", stats.peak, stats.live );
+  OutputDebugStringA( line );
+}
+
+// The reader MappedFile replaced, kept to compare the two.
+static eastl::vector< uint8_t > ReadFileWithStream( const wchar_t* filePath )
+{
+  std::ifstream   file( filePath, std::ios::binary | std::ios::ate );
+  std::streamsize size = file.tellg();
+  file.seekg( 0, std::ios::beg );
+
+  if ( size < 0 )
+    return {};
+
+  eastl::vector< uint8_t > buffer( size );
+  if ( file.read( (char*)buffer.data(), size ) )
+    return buffer;
+
+  return {};
+}
+
+// Below PooledBufferSize MappedFile reads the file into a pooled buffer, above it the file is mapped.
+static const wchar_t* GetBenchmarkFile( size_t size )
+{
+  static const wchar_t* smallPath = L"BenchmarkSmall.bin";
+  static const wchar_t* largePath = L"BenchmarkLarge.bin";
+
+  auto path = size < MappedFile::PooledBufferSize ? smallPath : largePath;
+
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, path, L"wb" ) == 0 )
+  {
+    eastl::vector< uint8_t > data( size );
+    for ( size_t byteIx = 0; byteIx < size; ++byteIx )
+      data[ byteIx ] = uint8_t( byteIx * 13 );
+    fwrite( data.data(), 1, data.size(), fileHandle );
+    fclose( fileHandle );
+  }
+
+  return path;
+}
+
+// A byte of every cache line, it stands in for the parsing of the data.
+static uint32_t SumBytes( const uint8_t* data, size_t size )
+{
+  uint32_t sum = 0;
+  for ( size_t byteIx = 0; byteIx < size; byteIx += 64 )
+    sum += data[ byteIx ];
+  return sum;
+}
+
+// The file is written before the timing starts, so the reads come from the file cache, like most loads of a session.
+template< typename ReadFunc >
+static void BenchmarkFileRead( TestRunner::Timing& timing, size_t size, ReadFunc&& readFunc )
+{
+  auto path = GetBenchmarkFile( size );
+
+  uint32_t sum = 0;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    sum += readFunc( path );
+
+  timing.Stop();
+
+  KeepValue( sum );
+}
+
+static uint32_t ReadStream( const wchar_t* path )
+{
+  auto data = ReadFileWithStream( path );
+  return SumBytes( data.data(), data.size() );
+}
+
+static uint32_t ReadMapped( const wchar_t* path )
+{
+  MappedFile file( path, MappedFile::AccessHint::Sequential );
+  return SumBytes( file.data(), file.size() );
+}
+
+MICRO_BENCHMARK( FileReadStream16K )
+{
+  BenchmarkFileRead( timing, 16 * 1024, ReadStream );
+}
+
+MICRO_BENCHMARK( FileReadMapped16K )
+{
+  BenchmarkFileRead( timing, 16 * 1024, ReadMapped );
+}
+
+MICRO_BENCHMARK( FileReadStream8M )
+{
+  BenchmarkFileRead( timing, 8 * 1024 * 1024, ReadStream );
+}
+
+MICRO_BENCHMARK( FileReadMapped8M )
+{
+  BenchmarkFileRead( timing, 8 * 1024 * 1024, ReadMapped );
+}
+
+MICRO_BENCHMARK( Halton2D )
+{
+  float sum = 0;
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    auto value = LowDiscrepancy::Halton2D( uint32_t( iterationIx + 1 ) );
+    sum += value.x + value.y;
+  }
+
+  KeepValue( sum );
+}
+
+MICRO_BENCHMARK( OwenSobol )
+{
+  uint32_t sum = 0;
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    sum += LowDiscrepancy::OwenSobol( uint32_t( iterationIx ), iterationIx & 3, 0x5EED );
+
+  KeepValue( sum );
+}
+
+// One scope per iteration, nested in the scope of a frame, like the passes of the render loop are.
+static void BenchmarkCPUSections( TestRunner::Timing& timing, bool collecting )
+{
+  auto dropSections = []( const wchar_t*, uint64_t, uint64_t ) {};
+
+  CPUProfiler::SetCollecting( collecting );
+  CPUProfiler::CollectSections( dropSections );
+
+  timing.Start();
+
+  {
+    CPUSection frameSection( L"Benchmark frame" );
+    for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+      CPUSection section( L"Benchmark section" );
+  }
+
+  timing.Stop();
+
+  CPUProfiler::CollectSections( dropSections );
+  CPUProfiler::SetCollecting( false );
+}
+
+MICRO_BENCHMARK( CPUSectionIdle )
+{
+  BenchmarkCPUSections( timing, false );
+}
+
+// The ring of the thread wraps around many times, which is what a long capture does too.
+MICRO_BENCHMARK( CPUSectionRecording )
+{
+  BenchmarkCPUSections( timing, true );
+}
+
+// Chains of depth nodes below the root, each node turned and offset from its parent, for the world transform benchmarks.
+struct BenchmarkNodeChains
+{
+  BenchmarkNodeChains( int nodeCount, int depth )
+    : scene( 0, 1 )
+  {
+    auto transform = XMMatrixRotationY( 0.1f ) * XMMatrixTranslation( 1, 0, 0 );
+
+    Node* parent = &scene.rootNode;
+    for ( int nodeIx = 0; nodeIx < nodeCount; ++nodeIx )
+    {
+      if ( nodeIx % depth == 0 )
+      {
+        parent = &scene.rootNode;
+        chainRoots.push_back( nodeIx );
+      }
+
+      parent = &scene.AddNode( *parent, transform );
+      nodes.push_back( parent );
+    }
+
+    scene.Build();
+  }
+
+  TestScene              scene;
+  eastl::vector< Node* > nodes;
+  eastl::vector< int   > chainRoots;
+};
+
+static BenchmarkNodeChains& GetWorldTransformChains()
+{
+  static BenchmarkNodeChains chains( 100 * 1000, 12 );
+  return chains;
+}
+
+// Every world transform of 100k nodes, 12 deep, composed from the ancestors of each node, like Node does.
+MICRO_BENCHMARK( WorldTransformsComposed )
+{
+  auto& chains = GetWorldTransformChains();
+
+  timing.Start();
+
+  auto sum = XMVectorZero();
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    for ( auto node : chains.nodes )
+      sum += node->GetFullTransform().r[ 3 ];
+
+  timing.Stop();
+
+  KeepValue( XMVectorGetX( sum ) );
+}
+
+// The same world transforms read from the store, after a hundred of the chains were moved, like a frame with
+// moving objects does.
+MICRO_BENCHMARK( WorldTransformsCached )
+{
+  static constexpr int movedChains = 100;
+
+  auto& chains = GetWorldTransformChains();
+  auto& store  = chains.scene.sceneStore;
+
+  timing.Start();
+
+  auto sum = XMVectorZero();
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    for ( int chainIx = 0; chainIx < movedChains; ++chainIx )
+    {
+      auto nodeIndex = store.GetNodeIndex( *chains.nodes[ chains.chainRoots[ ( iterationIx * movedChains + chainIx ) % chains.chainRoots.size() ] ] );
+      store.SetLocalTransform( nodeIndex, XMMatrixTranslation( float( iterationIx ), 0, 0 ) );
+    }
+
+    store.UpdateWorldTransforms();
+
+    for ( int nodeIx = 0; nodeIx < store.GetNodeCount(); ++nodeIx )
+      sum += store.GetWorldTransform( nodeIx ).r[ 3 ];
+  }
+
+  timing.Stop();
+
+  KeepValue( XMVectorGetX( sum ) );
+}
+
+static BenchmarkNodeChains& GetTraversalChains()
+{
+  static BenchmarkNodeChains chains( 1000 * 1000, 8 );
+  return chains;
+}
+
+static XMVECTOR SumNodeTree( Node& node )
+{
+  auto sum = node.GetTransform().r[ 3 ];
+  node.ForEachNode( [ &sum ]( Node& child ) { sum += SumNodeTree( child ); return true; } );
+  return sum;
+}
+
+// A depth first walk of 1M nodes, reading the local transform of each, through the pointers of the node tree.
+MICRO_BENCHMARK( NodeTreeTraversal )
+{
+  auto& chains = GetTraversalChains();
+
+  timing.Start();
+
+  auto sum = XMVectorZero();
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    sum += SumNodeTree( chains.scene.rootNode );
+
+  timing.Stop();
+
+  KeepValue( XMVectorGetX( sum ) );
+}
+
+// The same walk over the store, which keeps the nodes in depth first order, so it is a linear read.
+MICRO_BENCHMARK( SceneStoreTraversal )
+{
+  auto& chains = GetTraversalChains();
+  auto& store  = chains.scene.sceneStore;
+
+  timing.Start();
+
+  auto sum = XMVectorZero();
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    for ( int nodeIx = 0; nodeIx < store.GetNodeCount(); ++nodeIx )
+      sum += store.GetLocalTransform( nodeIx ).r[ 3 ];
+
+  timing.Stop();
+
+  KeepValue( XMVectorGetX( sum ) );
+}
+
+// A 1080p depth buffer of slopes, so the levels are not all the same value.
+static const eastl::vector< float >& GetBenchmarkDepth()
+{
+  static eastl::vector< float > depth;
+  if ( depth.empty() )
+  {
+    depth.resize( 1920 * 1080 );
+    for ( int texelIx = 0; texelIx < int( depth.size() ); ++texelIx )
+      depth[ texelIx ] = float( ( texelIx % 1920 ) + ( texelIx / 1920 ) * 3 ) / ( 1920 + 1080 * 3 );
+  }
+  return depth;
+}
+
+MICRO_BENCHMARK( HiZPyramidBuild1080p )
+{
+  auto& depth = GetBenchmarkDepth();
+
+  HiZPyramid pyramid;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    pyramid.Build( depth.data(), 1920, 1080 );
+
+  timing.Stop();
+
+  KeepValue( pyramid.GetLevel( HiZLevelCount - 1 )[ 0 ] );
+}
+
+// A thousand boxes of different sizes spread over the screen, each tested on its own.
+MICRO_BENCHMARK( HiZPyramidOcclusionTest )
+{
+  static constexpr int boxCount = 1000;
+
+  HiZPyramid pyramid;
+  pyramid.Build( GetBenchmarkDepth().data(), 1920, 1080 );
+
+  eastl::vector< XMFLOAT4 > centers;
+  eastl::vector< XMFLOAT4 > extents;
+  for ( int boxIx = 0; boxIx < boxCount; ++boxIx )
+  {
+    centers.emplace_back( float( boxIx % 40 ) - 20, float( boxIx / 40 ) - 12.5f, 0.2f + ( boxIx % 7 ) * 0.1f, 1.0f );
+    extents.emplace_back( 0.1f + ( boxIx % 5 ) * 0.3f, 0.1f + ( boxIx % 3 ) * 0.5f, 0.05f, 0.0f );
+  }
+
+  // Orthographic, the box z is the depth, the screen spans -20 to 20 on x.
+  auto mvp = XMMatrixScaling( 0.05f, 0.08f, 1 );
+
+  int occluded = 0;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+    for ( int boxIx = 0; boxIx < boxCount; ++boxIx )
+      occluded += pyramid.IsOccluded( mvp, centers[ boxIx ], extents[ boxIx ] );
+
+  timing.Stop();
+
+  KeepValue( occluded );
+}
+
+// Node slot sized uploads. Every few thousand of them the list is retired, with two frames in flight, so the
+// pages are recycled like in the render loop.
+MICRO_BENCHMARK( UploadAllocatorAllocate )
+{
+  static constexpr int allocationsPerList = 4096;
+  static constexpr int framesInFlight     = 2;
+
+  UploadPagePool  pool( []( int size ) { return GetTestDevice().AllocateUploadBuffer( size, L"BenchmarkUploadPage" ); } );
+  UploadAllocator allocator( pool );
+
+  uint64_t fence  = 0;
+  uint8_t* cursor = nullptr;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    cursor = allocator.Allocate( 192, 16 ).cpuAddress;
+
+    if ( ( iterationIx + 1 ) % allocationsPerList == 0 )
+    {
+      allocator.Retire( CommandQueueType::Direct, ++fence );
+      if ( fence > framesInFlight )
+        pool.RecyclePages( CommandQueueType::Direct, fence - framesInFlight );
+    }
+  }
+
+  timing.Stop();
+
+  allocator.Retire( CommandQueueType::Direct, ++fence );
+
+  KeepValue( cursor );
+}
+
+// An iteration is a frame releasing 100k small buffers and collecting the ones of two frames before. Creating the
+// buffers is timed too, it costs the same with and without the background destruction.
+static void BenchmarkDeferredRelease( TestRunner::Timing& timing, bool backgroundDestruction )
+{
+  static constexpr int releasesPerFrame = 100 * 1000;
+  static constexpr int framesInFlight   = 2;
+
+  DeferredReleaseQueue queue;
+  if ( backgroundDestruction )
+    queue.EnableBackgroundDestruction( "BenchmarkRelease" );
+
+  int collected = 0;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    uint64_t fence = iterationIx + 1;
+    for ( int releaseIx = 0; releaseIx < releasesPerFrame; ++releaseIx )
+      queue.Release( fence, eastl::make_unique< eastl::vector< uint8_t > >( 64 ) );
+
+    if ( fence > framesInFlight )
+      collected += queue.Collect( fence - framesInFlight );
+  }
+
+  timing.Stop();
+
+  queue.Clear();
+
+  KeepValue( collected );
+}
+
+MICRO_BENCHMARK( DeferredReleaseFrame )
+{
+  BenchmarkDeferredRelease( timing, false );
+}
+
+MICRO_BENCHMARK( DeferredReleaseFrameBackground )
+{
+  BenchmarkDeferredRelease( timing, true );
+}
+
+// A region of the scene buffer size, half of it in use by ranges of 1 to 8 slots. Each iteration frees the oldest
+// range and allocates a new one, so the free ranges are split and coalesced all the time.
+MICRO_BENCHMARK( DescriptorAllocatorChurn )
+{
+  static constexpr int capacity   = SceneBufferResourceCount;
+  static constexpr int liveRanges = capacity / 2 / 4;
+
+  struct Range
+  {
+    int slot;
+    int count;
+  };
+
+  DescriptorAllocator allocator( SceneBufferResourceBaseSlot, capacity );
+
+  eastl::vector< Range > ranges( liveRanges );
+  for ( int rangeIx = 0; rangeIx < liveRanges; ++rangeIx )
+  {
+    int count = 1 + rangeIx % 8;
+    ranges[ rangeIx ] = { allocator.Allocate( count ), count };
+  }
+
+  int failed = 0;
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    auto& range = ranges[ iterationIx % liveRanges ];
+    if ( range.slot >= 0 )
+      allocator.Free( range.slot, range.count );
+
+    range.count = 1 + ( iterationIx * 5 ) % 8;
+    range.slot  = allocator.Allocate( range.count );
+    failed += range.slot < 0;
+  }
+
+  timing.Stop();
+
+  KeepValue( failed );
+}
+
+// The layout of the DXR instance descriptor, without the D3D12 headers.
+struct BenchmarkRTInstance
+{
+  float    transform[ 3 ][ 4 ];
+  uint32_t idAndMask;
+  uint32_t hitGroupAndFlags;
+  uint64_t accelerationStructure;
+};
+
+// A frame of 100k instances with a thousand of them moved, written into the ring of instance buffers with two
+// frames in flight, so each buffer gets the changes of three frames.
+MICRO_BENCHMARK( RTInstanceRingUpdate )
+{
+  static constexpr int instanceCount  = 100 * 1000;
+  static constexpr int movedInstances = 1000;
+  static constexpr int framesInFlight = 2;
+
+  RTInstanceRing< BenchmarkRTInstance > ring;
+  ring.ResetInstances( instanceCount );
+
+  eastl::vector< eastl::vector< BenchmarkRTInstance > > memory;
+  auto allocateBuffer = [ &memory ]( int bufferIndex, int count )
+  {
+    if ( bufferIndex >= int( memory.size() ) )
+      memory.resize( bufferIndex + 1 );
+    memory[ bufferIndex ].resize( count );
+    return memory[ bufferIndex ].data();
+  };
+
+  XMFLOAT4X4 transform;
+  XMStoreFloat4x4( &transform, XMMatrixRotationY( 0.5f ) * XMMatrixTranslation( 1, 2, 3 ) );
+
+  timing.Start();
+
+  for ( int iterationIx = 0; iterationIx < timing.iterations; ++iterationIx )
+  {
+    uint64_t fence = iterationIx + 1;
+
+    ring.BeginChanges();
+    for ( int movedIx = 0; movedIx < movedInstances; ++movedIx )
+      PackRTTransform( transform, ring.ChangeInstance( ( iterationIx * movedInstances + movedIx * 97 ) % instanceCount ).transform );
+
+    int bufferIndex = ring.AcquireBuffer( fence > framesInFlight ? fence - framesInFlight : 0, allocateBuffer );
+    ring.RetireBuffer( bufferIndex, fence );
+  }
+
+  timing.Stop();
+
+  KeepValue( ring.GetLastCopyCount() );
+}
@@ -0,0 +1,93 @@
+#include "TestRunner.h"
+#include "Scene/Node.h"
+#include "Scene/NodeNameIndex.h"
+
+struct NamedNodes
+{
+  NamedNodes( eastl::initializer_list< const char* > names )
+  {
+    for ( auto name : names )
+    {
+      nodes.emplace_back( eastl::make_unique< Node >() );
+      nodes.back()->SetName( name );
+      index.Add( *nodes.back() );
+    }
+  }
+
+  // The names of the found nodes, joined with spaces.
+  eastl::string Names( const eastl::vector< Node* >& found ) const
+  {
+    eastl::string result;
+    for ( auto node : found )
+    {
+      if ( !result.empty() )
+        result += ' ';
+      result += node->GetName();
+    }
+    return result;
+  }
+
+  eastl::string FindByPrefix( const char* prefix ) const
+  {
+    eastl::vector< Node* > found;
+    index.FindByPrefix( prefix, found );
+    return Names( found );
+  }
+
+  eastl::string FindByPattern( const char* pattern ) const
+  {
+    eastl::vector< Node* > found;
+    index.FindByPattern( pattern, found );
+    return Names( found );
+  }
+
+  eastl::vector< eastl::unique_ptr< Node > > nodes;
+  NodeNameIndex                              index;
+};
+
+TEST_CASE( NodeNameIndexFind )
+{
+  NamedNodes named( { "Camera", "Lamp", "Camera", "Chair" } );
+
+  // The first added one wins, like the depth first search of the tree.
+  CHECK( named.index.Find( "Camera" ) == named.nodes[ 0 ].get() );
+  CHECK( named.index.Find( "Chair" ) == named.nodes[ 3 ].get() );
+  CHECK( named.index.Find( "Cam" ) == nullptr );
+  CHECK( named.index.Find( "" ) == nullptr );
+
+  named.index.Clear();
+  CHECK( named.index.Find( "Camera" ) == nullptr );
+}
+
+TEST_CASE( NodeNameIndexFindByPrefix )
+{
+  NamedNodes named( { "Lamp_2", "Chair", "Lamp_10", "Lamp", "Lam", "Table_Lamp" } );
+
+  CHECK( named.FindByPrefix( "Lamp" ) == "Lamp Lamp_10 Lamp_2" );
+  CHECK( named.FindByPrefix( "Lamp_" ) == "Lamp_10 Lamp_2" );
+  CHECK( named.FindByPrefix( "Table" ) == "Table_Lamp" );
+  CHECK( named.FindByPrefix( "Sofa" ) == "" );
+  CHECK( named.FindByPrefix( "" ) == "Chair Lam Lamp Lamp_10 Lamp_2 Table_Lamp" );
+
+  // Added after the first query, the names are sorted again.
+  named.nodes.emplace_back( eastl::make_unique< Node >() );
+  named.nodes.back()->SetName( "Lamp_1" );
+  named.index.Add( *named.nodes.back() );
+
+  CHECK( named.FindByPrefix( "Lamp_" ) == "Lamp_1 Lamp_10 Lamp_2" );
+}
+
+TEST_CASE( NodeNameIndexFindByPattern )
+{
+  NamedNodes named( { "Lamp_2", "Chair", "Lamp_10", "Lamp", "Table_Lamp", "Chair" } );
+
+  CHECK( named.FindByPattern( "Lamp" ) == "Lamp" );
+  CHECK( named.FindByPattern( "Lamp_?" ) == "Lamp_2" );
+  CHECK( named.FindByPattern( "Lamp*" ) == "Lamp Lamp_10 Lamp_2" );
+  CHECK( named.FindByPattern( "*Lamp" ) == "Lamp Table_Lamp" );
+  CHECK( named.FindByPattern( "*_*" ) == "Lamp_10 Lamp_2 Table_Lamp" );
+  CHECK( named.FindByPattern( "C??ir" ) == "Chair Chair" );
+  CHECK( named.FindByPattern( "*a*a*" ) == "Table_Lamp" );
+  CHECK( named.FindByPattern( "*" ) == "Chair Chair Lamp Lamp_10 Lamp_2 Table_Lamp" );
+  CHECK( named.FindByPattern( "Sofa*" ) == "" );
+}
@@ -0,0 +1,130 @@
+#include "TestRunner.h"
+#include "TestScene.h"
+#include "Scene/OcclusionCuller.h"
+
+// A 6 x 6 wall on the z = 0 plane, facing the camera at z = -10, and boxes around it.
+struct OccludedScene : TestScene
+{
+  OccludedScene()
+    : TestScene( 0, 1 )
+  {
+    auto& wallNode = AddNode( rootNode, XMMatrixIdentity() );
+    wallMesh = AddMesh( wallNode, XMFLOAT3( 0, 0, 0 ), XMFLOAT3( 3, 3, 0.01f ) );
+
+    hiddenMesh = AddMeshAt( XMFLOAT3( 0, 0, 10 ), XMFLOAT3( 1, 1, 1 ) );
+    besideMesh = AddMeshAt( XMFLOAT3( 8, 0, 10 ), XMFLOAT3( 1, 1, 1 ) );
+    frontMesh  = AddMeshAt( XMFLOAT3( 0, 0, -5 ), XMFLOAT3( 1, 1, 1 ) );
+    largerMesh = AddMeshAt( XMFLOAT3( 0, 0, 10 ), XMFLOAT3( 10, 10, 1 ) );
+    Build();
+
+    eastl::vector< XMFLOAT3 > positions = { { -3, -3, 0 }, { 3, -3, 0 }, { 3, 3, 0 }, { -3, 3, 0 } };
+    eastl::vector< uint32_t > indices   = { 0, 1, 2, 0, 2, 3 };
+    occlusionCuller.AddOccluderMesh( wallMesh, eastl::move( positions ), eastl::move( indices ) );
+    occlusionCuller.SetUpInstances( sceneStore );
+
+    XMStoreFloat4x4( &viewProjection, GetTestViewProjection( XMVectorSet( 0, 0, -10, 1 ), XMVectorSet( 0, 0, 0, 1 ) ) );
+  }
+
+  int AddMeshAt( const XMFLOAT3& position, const XMFLOAT3& extents )
+  {
+    return AddMesh( AddNode( rootNode, XMMatrixTranslation( position.x, position.y, position.z ) ), XMFLOAT3( 0, 0, 0 ), extents );
+  }
+
+  bool IsOccluded( int meshIndex ) const
+  {
+    for ( int meshSlot = 0; meshSlot < sceneStore.GetInstanceCount(); ++meshSlot )
+    {
+      if ( sceneStore.GetMeshIndex( meshSlot ) != meshIndex )
+        continue;
+
+      auto& slot = sceneStore.GetMeshSlots()[ meshSlot ];
+      auto  mvp  = sceneStore.GetWorldTransform( sceneStore.GetMeshSlotNode( meshSlot ) ) * XMLoadFloat4x4( &viewProjection );
+      return occlusionCuller.IsOccluded( mvp, slot.aabbCenter, slot.aabbExtents );
+    }
+
+    return false;
+  }
+
+  OcclusionCuller occlusionCuller;
+  XMFLOAT4X4      viewProjection;
+
+  int wallMesh;
+  int hiddenMesh;
+  int besideMesh;
+  int frontMesh;
+  int largerMesh;
+};
+
+TEST_CASE( OcclusionCullerRasterizesOccluders )
+{
+  OccludedScene scene;
+
+  scene.occlusionCuller.RenderOccluders( scene.sceneStore, XMLoadFloat4x4( &scene.viewProjection ) );
+
+  auto& depthBuffer = scene.occlusionCuller.GetDepthBuffer();
+  CHECK( depthBuffer.size() == OcclusionCuller::BufferWidth * OcclusionCuller::BufferHeight );
+  CHECK( scene.occlusionCuller.GetStats().occluderTriangles == 2 );
+
+  auto depthAt = [ & ]( int x, int y ) { return depthBuffer[ y * OcclusionCuller::BufferWidth + x ]; };
+
+  // The wall is 10 units away everywhere, the buffer stores 1/w.
+  int centerX = OcclusionCuller::BufferWidth / 2;
+  int centerY = OcclusionCuller::BufferHeight / 2;
+  CHECK( fabsf( depthAt( centerX, centerY ) - 0.1f ) < 0.001f );
+  CHECK( fabsf( depthAt( centerX - 20, centerY + 20 ) - 0.1f ) < 0.001f );
+
+  // The wall covers 3 / ( 10 * tan( 30 ) ) of the half height, the rest stays empty.
+  int wallHalfHeight = int( 3 / ( 10 * tanf( XMConvertToRadians( 30 ) ) ) * centerY );
+  CHECK( depthAt( centerX, centerY - wallHalfHeight + 2 ) > 0 );
+  CHECK( depthAt( centerX, centerY - wallHalfHeight - 2 ) == 0 );
+  CHECK( depthAt( 0, 0 ) == 0 );
+  CHECK( depthAt( OcclusionCuller::BufferWidth - 1, OcclusionCuller::BufferHeight - 1 ) == 0 );
+}
+
+TEST_CASE( OcclusionCullerHidesBoxesBehindOccluders )
+{
+  OccludedScene scene;
+
+  scene.occlusionCuller.RenderOccluders( scene.sceneStore, XMLoadFloat4x4( &scene.viewProjection ) );
+
+  CHECK( scene.IsOccluded( scene.hiddenMesh ) );
+  CHECK( !scene.IsOccluded( scene.besideMesh ) );
+  CHECK( !scene.IsOccluded( scene.frontMesh ) );
+  CHECK( !scene.IsOccluded( scene.largerMesh ) );
+
+  // The occluder is not hidden by itself.
+  CHECK( !scene.IsOccluded( scene.wallMesh ) );
+
+  // Only the visible slots are tested, the already culled ones are left alone.
+  eastl::vector< uint8_t > visibility( scene.sceneStore.GetInstanceCount(), 1 );
+  visibility[ 0 ] = 0;
+  scene.occlusionCuller.CullMeshSlots( scene.sceneStore, visibility );
+
+  int visibleCount = 0;
+  for ( int meshSlot = 0; meshSlot < int( visibility.size() ); ++meshSlot )
+  {
+    bool hidden = scene.sceneStore.GetMeshIndex( meshSlot ) == scene.hiddenMesh;
+    CHECK( visibility[ meshSlot ] == ( meshSlot > 0 && !hidden ? 1 : 0 ) );
+    visibleCount += visibility[ meshSlot ];
+  }
+
+  auto& stats = scene.occlusionCuller.GetStats();
+  CHECK( stats.testedInstances == int( visibility.size() ) - 1 );
+  CHECK( stats.culledInstances == 1 );
+  CHECK( visibleCount == int( visibility.size() ) - 2 );
+}
+
+// Without a rendered buffer, and with the occluder behind the camera, nothing is hidden.
+TEST_CASE( OcclusionCullerWithoutOcclusion )
+{
+  OccludedScene scene;
+
+  CHECK( !scene.IsOccluded( scene.hiddenMesh ) );
+
+  auto behindCamera = GetTestViewProjection( XMVectorSet( 0, 0, 5, 1 ), XMVectorSet( 0, 0, 20, 1 ) );
+  XMStoreFloat4x4( &scene.viewProjection, behindCamera );
+  scene.occlusionCuller.RenderOccluders( scene.sceneStore, behindCamera );
+
+  CHECK( scene.occlusionCuller.GetStats().occluderTriangles == 0 );
+  CHECK( !scene.IsOccluded( scene.hiddenMesh ) );
+}
@@ -0,0 +1,118 @@
+#include "TestRunner.h"
+#include "Render/PipelineKey.h"
+#include "Render/D3D12/D3DPipelineCache.h"
+
+static constexpr wchar_t testCachePath[] = L"TestPipelineCache.bin";
+
+// The published FNV-1a 64 test vectors.
+TEST_CASE( HashBytesFNV1a )
+{
+  CHECK( HashBytes( "", 0 ) == 0xCBF29CE484222325 );
+  CHECK( HashBytes( "a", 1 ) == 0xAF63DC4C8601EC8C );
+  CHECK( HashBytes( "foobar", 6 ) == 0x85944171F73967E8 );
+
+  // Chaining is the same as hashing the bytes in one go.
+  CHECK( HashBytes( "bar", 3, HashBytes( "foo", 3 ) ) == HashBytes( "foobar", 6 ) );
+}
+
+// The descriptions are built over different garbage, only the fields in use may end up in the key.
+TEST_CASE( HashPipelineDescIgnoresUnusedBytes )
+{
+  static const uint8_t vertexShader[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+  alignas( PipelineDesc ) uint8_t storage[ 2 ][ sizeof( PipelineDesc ) ];
+  memset( storage[ 0 ], 0x00, sizeof( PipelineDesc ) );
+  memset( storage[ 1 ], 0xCD, sizeof( PipelineDesc ) );
+
+  PipelineDesc* descs[ 2 ];
+  for ( int descIx = 0; descIx < 2; ++descIx )
+  {
+    auto& desc = *new ( storage[ descIx ] ) PipelineDesc;
+    desc.vsData            = vertexShader;
+    desc.vsSize            = sizeof( vertexShader );
+    desc.targetFormat[ 0 ] = PixelFormat::RGBA8888UN;
+    desc.vertexDesc.stride = 16;
+
+    auto& element = desc.vertexDesc.elements[ 0 ];
+    element.dataType     = VertexDesc::Element::DataType::R32G32B32F;
+    element.dataOffset   = 0;
+    element.elementIndex = 0;
+    strcpy_s( element.elementName, "POSITION" );
+
+    // The rest of the elements stay garbage, the hash stops at the first unused one.
+    desc.vertexDesc.elements[ 1 ].dataType = VertexDesc::Element::DataType::None;
+
+    descs[ descIx ] = &desc;
+  }
+
+  auto key = HashPipelineDesc( *descs[ 0 ] );
+  CHECK( key == HashPipelineDesc( *descs[ 1 ] ) );
+
+  descs[ 1 ]->rasterizerDesc.cullMode = RasterizerDesc::CullMode::None;
+  CHECK( key != HashPipelineDesc( *descs[ 1 ] ) );
+
+  descs[ 1 ]->rasterizerDesc.cullMode = descs[ 0 ]->rasterizerDesc.cullMode;
+  descs[ 1 ]->vertexDesc.elements[ 0 ].elementName[ 0 ] = 'p';
+  CHECK( key != HashPipelineDesc( *descs[ 1 ] ) );
+
+  descs[ 0 ]->~PipelineDesc();
+  descs[ 1 ]->~PipelineDesc();
+}
+
+TEST_CASE( PipelineCacheFileInvalidation )
+{
+  DXGI_ADAPTER_DESC1 adapterDesc = {};
+  adapterDesc.VendorId = 0x10DE;
+  adapterDesc.DeviceId = 0x2684;
+  adapterDesc.SubSysId = 0x1234;
+  adapterDesc.Revision = 0xA1;
+
+  auto header = D3DPipelineCache::MakeFileHeader( adapterDesc );
+
+  eastl::vector< uint8_t > library( 1000 );
+  for ( int byteIx = 0; byteIx < int( library.size() ); ++byteIx )
+    library[ byteIx ] = uint8_t( byteIx * 7 );
+
+  _wremove( testCachePath );
+  CHECK( D3DPipelineCache::ReadLibraryFile( testCachePath, header ).empty() );
+
+  CHECK( D3DPipelineCache::WriteLibraryFile( testCachePath, header, library ) );
+  CHECK( D3DPipelineCache::ReadLibraryFile( testCachePath, header ) == library );
+
+  // Any other cache version or adapter starts an empty library.
+  auto otherVersion = header;
+  otherVersion.version++;
+  CHECK( D3DPipelineCache::ReadLibraryFile( testCachePath, otherVersion ).empty() );
+
+  auto otherDriver = header;
+  otherDriver.revision++;
+  CHECK( D3DPipelineCache::ReadLibraryFile( testCachePath, otherDriver ).empty() );
+
+  auto otherDevice = header;
+  otherDevice.deviceId++;
+  CHECK( D3DPipelineCache::ReadLibraryFile( testCachePath, otherDevice ).empty() );
+
+  // A file cut short by a crash during the save.
+  FILE* fileHandle = nullptr;
+  CHECK( _wfopen_s( &fileHandle, testCachePath, L"wb" ) == 0 );
+  if ( fileHandle )
+  {
+    auto fileHeader = header;
+    fileHeader.librarySize = library.size();
+    fwrite( &fileHeader, sizeof( fileHeader ), 1, fileHandle );
+    fwrite( library.data(), 1, library.size() / 2, fileHandle );
+    fclose( fileHandle );
+  }
+  CHECK( D3DPipelineCache::ReadLibraryFile( testCachePath, header ).empty() );
+
+  // Not a cache file at all.
+  CHECK( _wfopen_s( &fileHandle, testCachePath, L"wb" ) == 0 );
+  if ( fileHandle )
+  {
+    fwrite( library.data(), 1, library.size(), fileHandle );
+    fclose( fileHandle );
+  }
+  CHECK( D3DPipelineCache::ReadLibraryFile( testCachePath, header ).empty() );
+
+  _wremove( testCachePath );
+}
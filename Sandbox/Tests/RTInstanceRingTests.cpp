@@ -0,0 +1,133 @@
+#include "TestRunner.h"
+#include "Render/RTInstanceRing.h"
+
+struct TestInstance
+{
+  float    transform[ 3 ][ 4 ];
+  uint32_t id;
+};
+
+// Buffers in CPU memory, the fences are counted by the test.
+struct TestInstanceRing : RTInstanceRing< TestInstance >
+{
+  int Acquire( uint64_t completedFence )
+  {
+    return AcquireBuffer( completedFence, [ this ]( int bufferIndex, int count )
+    {
+      if ( bufferIndex >= int( memory.size() ) )
+        memory.resize( bufferIndex + 1 );
+
+      allocations++;
+      memory[ bufferIndex ].assign( count, TestInstance() );
+      return memory[ bufferIndex ].data();
+    } );
+  }
+
+  void Reset( int count )
+  {
+    auto instances = ResetInstances( count );
+    for ( int instanceIx = 0; instanceIx < count; ++instanceIx )
+      instances[ instanceIx ] = { {}, uint32_t( instanceIx ) };
+  }
+
+  void Change( eastl::initializer_list< int > instanceIndices )
+  {
+    BeginChanges();
+    for ( auto instanceIndex : instanceIndices )
+      ChangeInstance( instanceIndex ).id += 1000;
+  }
+
+  bool IsUpToDate( int bufferIndex ) const
+  {
+    auto& buffer = GetBuffer( bufferIndex );
+    for ( int instanceIx = 0; instanceIx < GetInstanceCount(); ++instanceIx )
+      if ( buffer.mappedData[ instanceIx ].id != GetInstances()[ instanceIx ].id )
+        return false;
+    return true;
+  }
+
+  eastl::vector< eastl::vector< TestInstance > > memory;
+
+  int allocations = 0;
+};
+
+TEST_CASE( RTInstanceRingCopiesOnlyChanges )
+{
+  TestInstanceRing ring;
+  ring.Reset( 100 );
+
+  // A new buffer is written in full.
+  int first = ring.Acquire( 0 );
+  CHECK( first == 0 && ring.GetLastCopyCount() == 100 && ring.IsUpToDate( first ) );
+  ring.RetireBuffer( first, 1 );
+
+  // The first one is still in flight.
+  ring.Change( { 5, 7 } );
+  int second = ring.Acquire( 0 );
+  CHECK( second == 1 && ring.GetLastCopyCount() == 100 && ring.IsUpToDate( second ) );
+  ring.RetireBuffer( second, 2 );
+
+  // Once it is done, it only gets the changes it missed.
+  ring.Change( { 9 } );
+  CHECK( ring.Acquire( 1 ) == first );
+  CHECK( ring.GetLastCopyCount() == 3 && ring.IsUpToDate( first ) );
+  ring.RetireBuffer( first, 3 );
+
+  // The changes both buffers have are dropped.
+  CHECK( ring.GetChangeCount() == 1 );
+
+  ring.Change( { 9, 11 } );
+  CHECK( ring.Acquire( 3 ) == first );
+  CHECK( ring.GetLastCopyCount() == 2 && ring.IsUpToDate( first ) );
+  ring.RetireBuffer( first, 4 );
+
+  CHECK( ring.Acquire( 4 ) == first );
+  CHECK( ring.GetLastCopyCount() == 0 );
+  ring.RetireBuffer( first, 5 );
+
+  CHECK( ring.Acquire( 5 ) == first && ring.GetBufferCount() == 2 && ring.allocations == 2 );
+}
+
+TEST_CASE( RTInstanceRingResets )
+{
+  TestInstanceRing ring;
+  ring.Reset( 10 );
+  ring.RetireBuffer( ring.Acquire( 0 ), 1 );
+
+  // A change of most of the instances is copied in one go.
+  ring.Change( { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 } );
+  CHECK( ring.Acquire( 1 ) == 0 && ring.GetLastCopyCount() == 10 );
+  ring.RetireBuffer( 0, 2 );
+
+  // A reset rewrites the buffers in full and drops the log.
+  ring.Change( { 3 } );
+  ring.Reset( 10 );
+  CHECK( ring.GetChangeCount() == 0 );
+  CHECK( ring.Acquire( 2 ) == 0 && ring.GetLastCopyCount() == 10 && ring.IsUpToDate( 0 ) );
+  ring.RetireBuffer( 0, 3 );
+
+  // More instances than the buffer holds, it gets new memory.
+  ring.Reset( 50 );
+  CHECK( ring.Acquire( 3 ) == 0 );
+  CHECK( ring.allocations == 2 && ring.GetBuffer( 0 ).capacity == 50 && ring.IsUpToDate( 0 ) );
+  ring.RetireBuffer( 0, 4 );
+
+  // Empty, the buffer still has room for one.
+  TestInstanceRing empty;
+  empty.Reset( 0 );
+  CHECK( empty.Acquire( 0 ) == 0 && empty.GetBuffer( 0 ).capacity == 1 && empty.GetLastCopyCount() == 0 );
+}
+
+TEST_CASE( RTInstanceRingPackTransform )
+{
+  XMFLOAT4X4 transform;
+  XMStoreFloat4x4( &transform, XMMatrixScaling( 2, 3, 4 ) * XMMatrixTranslation( 10, 20, 30 ) );
+
+  float packed[ 3 ][ 4 ];
+  PackRTTransform( transform, packed );
+
+  // Row major 3x4, the translation in the last column.
+  CHECK( packed[ 0 ][ 0 ] == 2 && packed[ 1 ][ 1 ] == 3 && packed[ 2 ][ 2 ] == 4 );
+  CHECK( packed[ 0 ][ 3 ] == 10 && packed[ 1 ][ 3 ] == 20 && packed[ 2 ][ 3 ] == 30 );
+  CHECK( packed[ 0 ][ 1 ] == 0 && packed[ 1 ][ 0 ] == 0 && packed[ 2 ][ 0 ] == 0 );
+}
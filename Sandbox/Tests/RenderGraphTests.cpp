@@ -0,0 +1,114 @@
+#include "TestRunner.h"
+#include "Render/RenderGraph.h"
+#include "Render/MemoryHeap.h"
+#include "Render/Resource.h"
+
+using Type  = CommandList::ResourceBarrier::Type;
+using Split = CommandList::ResourceBarrier::Split;
+
+static constexpr uint64_t megabyte = 1024 * 1024;
+
+// Four bytes a texel, the graph aligns the sizes to the heap alignment itself.
+static uint64_t TestSize( int width, int height, PixelFormat )
+{
+  return uint64_t( width ) * height * 4;
+}
+
+static const RenderGraph::Barrier* FindBarrier( const RenderGraph& graph, int pass, RenderGraph::Handle handle, Type type, Split split )
+{
+  for ( auto& barrier : graph.GetBarriers( pass ) )
+    if ( barrier.handle == handle && barrier.type == type && barrier.split == split )
+      return &barrier;
+
+  return nullptr;
+}
+
+TEST_CASE( RenderGraphCompile )
+{
+  RenderGraph graph;
+
+  auto noPass = []( CommandList&, RenderGraph& ) {};
+
+  int gbufferPass   = graph.AddPass( L"GBuffer", noPass );
+  int lightingPass  = graph.AddPass( L"Lighting", noPass );
+  int blurPass      = graph.AddPass( L"Blur", noPass );
+  int compositePass = graph.AddPass( L"Composite", noPass );
+  int presentPass   = graph.AddPass( L"Present", noPass );
+
+  // The imported resource is not touched until the graph is realized.
+  auto backBuffer = graph.ImportResource( nullptr );
+  auto gbuffer    = graph.CreateTransientTexture( { 1024, 1024, PixelFormat::RGBA8888UN, -1, -1, L"gbuffer" } );
+  auto lit        = graph.CreateTransientTexture( { 1024, 1024, PixelFormat::RGBA8888UN, -1, -1, L"lit" } );
+  auto blurred    = graph.CreateTransientTexture( { 512, 512, PixelFormat::RGBA8888UN, -1, -1, L"blurred" } );
+  auto overlay    = graph.CreateTransientTexture( { 1024, 1024, PixelFormat::RGBA8888UN, -1, -1, L"overlay" } );
+
+  graph.Use( gbufferPass, gbuffer, ResourceStateBits::RenderTarget );
+  graph.Use( lightingPass, gbuffer, ResourceStateBits::PixelShaderInput );
+  graph.Use( lightingPass, lit, ResourceStateBits::RenderTarget );
+  graph.Use( blurPass, gbuffer, ResourceStateBits::NonPixelShaderInput );
+  graph.Use( blurPass, blurred, ResourceStateBits::UnorderedAccess );
+  graph.Use( compositePass, lit, ResourceStateBits::PixelShaderInput );
+  graph.Use( compositePass, blurred, ResourceStateBits::PixelShaderInput );
+  graph.Use( compositePass, backBuffer, ResourceStateBits::RenderTarget );
+  graph.Use( presentPass, overlay, ResourceStateBits::RenderTarget );
+  graph.Use( presentPass, backBuffer, ResourceStateBits::Present );
+
+  graph.Compile( TestSize );
+
+  // The two reads of the gbuffer are one transition to both states.
+  CHECK( FindBarrier( graph, gbufferPass, gbuffer, Type::Transition, Split::None ) );
+  auto gbufferRead = FindBarrier( graph, lightingPass, gbuffer, Type::Transition, Split::None );
+  CHECK( gbufferRead && gbufferRead->state.bits == ( ResourceStateBits::PixelShaderInput | ResourceStateBits::NonPixelShaderInput ) );
+  CHECK( !FindBarrier( graph, blurPass, gbuffer, Type::Transition, Split::None ) );
+
+  // The lit texture is not used by the blur, its transition is split around it.
+  CHECK( FindBarrier( graph, blurPass, lit, Type::Transition, Split::Begin ) );
+  CHECK( FindBarrier( graph, compositePass, lit, Type::Transition, Split::End ) );
+
+  CHECK( FindBarrier( graph, compositePass, backBuffer, Type::Transition, Split::None ) );
+  CHECK( FindBarrier( graph, presentPass, backBuffer, Type::Transition, Split::None ) );
+
+  // The gbuffer, lit and blurred textures live at the same time, the overlay takes the memory of the one at 0.
+  CHECK( graph.GetHeapOffset( overlay ) == 0 );
+  CHECK( graph.GetHeapOffset( blurred ) == 8 * megabyte );
+  CHECK( graph.GetHeapOffset( gbuffer ) + graph.GetHeapOffset( lit ) == 4 * megabyte );
+
+  auto sharing = graph.GetHeapOffset( gbuffer ) == 0 ? gbuffer : lit;
+  CHECK( FindBarrier( graph, presentPass, overlay, Type::Aliasing, Split::None ) );
+  CHECK( FindBarrier( graph, sharing == gbuffer ? gbufferPass : lightingPass, sharing, Type::Aliasing, Split::None ) );
+  CHECK( !FindBarrier( graph, blurPass, blurred, Type::Aliasing, Split::None ) );
+
+  auto& stats = graph.GetStats();
+  CHECK( stats.passCount == 5 && stats.batchCount == 5 );
+  CHECK( stats.barrierCount == 12 );
+  CHECK( stats.splitBarrierCount == 1 );
+  CHECK( stats.aliasingBarrierCount == 2 );
+  CHECK( stats.transientMemory == 13 * megabyte );
+  CHECK( stats.heapSize == 9 * megabyte );
+
+  // Compiling again starts from scratch.
+  graph.Compile( TestSize );
+  CHECK( graph.GetStats().barrierCount == 12 && graph.GetBarriers( blurPass ).size() == 2 );
+}
+
+// Sizes are aligned to the heap alignment, and a texture without uses takes no memory.
+TEST_CASE( RenderGraphTransientSizes )
+{
+  RenderGraph graph;
+
+  int pass = graph.AddPass( L"Pass", []( CommandList&, RenderGraph& ) {} );
+
+  auto small = graph.CreateTransientTexture( { 10, 10, PixelFormat::RGBA8888UN, -1, -1, L"small" } );
+  graph.CreateTransientTexture( { 4096, 4096, PixelFormat::RGBA8888UN, -1, -1, L"unused" } );
+  graph.Use( pass, small, ResourceStateBits::UnorderedAccess );
+  graph.Use( pass, small, ResourceStateBits::CopySource );
+
+  graph.Compile( TestSize );
+
+  CHECK( graph.GetStats().transientMemory == RenderGraph::HeapAlignment );
+  CHECK( graph.GetStats().heapSize == RenderGraph::HeapAlignment );
+  CHECK( graph.GetBarriers( pass ).size() == 1 );
+
+  // The uses of one pass are merged into one state.
+  CHECK( graph.GetBarriers( pass )[ 0 ].state.bits == ( ResourceStateBits::UnorderedAccess | ResourceStateBits::CopySource ) );
+}
@@ -0,0 +1,44 @@
+#include "TestRunner.h"
+#include "Render/Utils.h"
+
+static bool RangesAre( const eastl::vector< SlotRange >& ranges, eastl::initializer_list< SlotRange > expected )
+{
+  if ( ranges.size() != expected.size() )
+    return false;
+
+  auto range = ranges.begin();
+  for ( auto& expectedRange : expected )
+  {
+    if ( range->first != expectedRange.first || range->count != expectedRange.count )
+      return false;
+    ++range;
+  }
+
+  return true;
+}
+
+TEST_CASE( CoalesceSlotRanges )
+{
+  eastl::vector< SlotRange > ranges;
+
+  CoalesceSlotRanges( {}, 4, ranges );
+  CHECK( ranges.empty() );
+
+  CoalesceSlotRanges( { 7 }, 4, ranges );
+  CHECK( RangesAre( ranges, { { 7, 1 } } ) );
+
+  // Neighbours always merge.
+  CoalesceSlotRanges( { 3, 4, 5, 6 }, 0, ranges );
+  CHECK( RangesAre( ranges, { { 3, 4 } } ) );
+
+  // A gap of exactly maxGap slots still merges, one more starts a new range.
+  CoalesceSlotRanges( { 0, 5, 11 }, 4, ranges );
+  CHECK( RangesAre( ranges, { { 0, 6 }, { 11, 1 } } ) );
+
+  CoalesceSlotRanges( { 0, 2, 4, 100, 101, 200 }, 1, ranges );
+  CHECK( RangesAre( ranges, { { 0, 5 }, { 100, 2 }, { 200, 1 } } ) );
+
+  // The previous ranges are replaced, not appended to.
+  CoalesceSlotRanges( { 9 }, 1, ranges );
+  CHECK( RangesAre( ranges, { { 9, 1 } } ) );
+}
@@ -0,0 +1,165 @@
+#include "TestRunner.h"
+#include "Scene/SceneLoader.h"
+
+static constexpr wchar_t testScenePath[] = L"TestSceneLoader.obj";
+static constexpr int     testMeshCount   = 6;
+
+// Flat fans of a growing number of triangles, side by side, so every mesh has a different size.
+static bool WriteTestScene()
+{
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, testScenePath, L"wb" ) != 0 || !fileHandle )
+    return false;
+
+  int vertexBase = 1;
+  for ( int meshIx = 0; meshIx < testMeshCount; ++meshIx )
+  {
+    int   ringSize = meshIx + 3;
+    float centerX  = meshIx * 10.0f;
+
+    fprintf( fileHandle, "o Fan%d\n", meshIx );
+    fprintf( fileHandle, "v %f 0 0\n", centerX );
+    for ( int ringIx = 0; ringIx < ringSize; ++ringIx )
+    {
+      float angle = XM_2PI * ringIx / ringSize;
+      fprintf( fileHandle, "v %f %f 0\n", centerX + cosf( angle ), sinf( angle ) );
+    }
+    for ( int ringIx = 0; ringIx < ringSize; ++ringIx )
+      fprintf( fileHandle, "f %d %d %d\n", vertexBase, vertexBase + 1 + ringIx, vertexBase + 1 + ( ringIx + 1 ) % ringSize );
+
+    vertexBase += ringSize + 1;
+  }
+
+  fclose( fileHandle );
+  return true;
+}
+
+// Waits for the converted meshes and takes them one by one until count of them arrived.
+static void TakeMeshes( SceneLoader& loader, int count, eastl::vector< SceneLoader::ConvertedMesh >& meshes )
+{
+  while ( int( meshes.size() ) < count )
+  {
+    loader.WaitForConvertedMeshes();
+    loader.TakeConvertedMeshes( 0, meshes );
+  }
+}
+
+TEST_CASE( SceneLoaderOrdering )
+{
+  CHECK( WriteTestScene() );
+
+  SceneLoader loader( testScenePath );
+
+  // Requested during the import, the conversion starts when the scene is ready.
+  eastl::vector< int > requests = { 4, 1, 3 };
+  loader.RequestMeshes( requests );
+
+  eastl::vector< SceneLoader::ConvertedMesh > meshes;
+  loader.WaitForConvertedMeshes();
+  CHECK( loader.GetState() == SceneLoader::State::Ready );
+
+  if ( loader.GetState() == SceneLoader::State::Ready )
+  {
+    CHECK( loader.GetStats().meshCount == testMeshCount );
+
+    eastl::vector< WorldPartition::MeshInstance > instances;
+    loader.CollectMeshInstances( instances );
+    CHECK( instances.size() == testMeshCount );
+
+    // Fewer requests than a range of the parallel conversion, so they are finished in the order of the requests.
+    TakeMeshes( loader, int( requests.size() ), meshes );
+    CHECK( meshes.size() == requests.size() );
+    for ( int meshIx = 0; meshIx < int( meshes.size() ); ++meshIx )
+    {
+      auto& mesh = meshes[ meshIx ];
+      CHECK( mesh.meshIndex == requests[ meshIx ] );
+      CHECK( mesh.GetByteSize() == loader.GetMeshByteSize( mesh.meshIndex ) );
+      CHECK( !mesh.indices.empty() && mesh.indices.size() % 3 == 0 );
+    }
+
+    // A taken mesh can be requested again.
+    loader.RequestMeshes( { 1, 0 } );
+    TakeMeshes( loader, int( requests.size() ) + 2, meshes );
+    CHECK( meshes[ 3 ].meshIndex == 1 && meshes[ 4 ].meshIndex == 0 );
+    CHECK( meshes[ 3 ].vertices.size() == meshes[ 1 ].vertices.size() );
+
+    auto stats = loader.GetStats();
+    CHECK( stats.convertedMeshes == 5 && stats.takenMeshes == 5 && stats.queuedBytes == 0 );
+  }
+
+  _wremove( testScenePath );
+}
+
+TEST_CASE( SceneLoaderPeakMemory )
+{
+  CHECK( WriteTestScene() );
+
+  eastl::vector< int > allMeshes;
+  for ( int meshIx = 0; meshIx < testMeshCount; ++meshIx )
+    allMeshes.push_back( meshIx );
+
+  // Below the size of any mesh, only one of them is let into the queue at a time.
+  {
+    SceneLoader loader( testScenePath, 1 );
+    loader.RequestMeshes( allMeshes );
+
+    eastl::vector< SceneLoader::ConvertedMesh > meshes;
+    loader.WaitForConvertedMeshes();
+    CHECK( loader.GetState() == SceneLoader::State::Ready );
+
+    if ( loader.GetState() == SceneLoader::State::Ready )
+    {
+      size_t largestMesh = 0;
+      for ( int meshIx = 0; meshIx < testMeshCount; ++meshIx )
+        largestMesh = eastl::max( largestMesh, loader.GetMeshByteSize( meshIx ) );
+
+      TakeMeshes( loader, testMeshCount, meshes );
+
+      auto stats = loader.GetStats();
+      CHECK( stats.convertedMeshes == testMeshCount && stats.takenMeshes == testMeshCount );
+      CHECK( stats.peakQueuedBytes == largestMesh );
+    }
+  }
+
+  // With room for the two largest meshes, the queue never goes above the limit, however many are requested.
+  {
+    SceneLoader sizer( testScenePath );
+    sizer.WaitForConvertedMeshes();
+    CHECK( sizer.GetState() == SceneLoader::State::Ready );
+
+    if ( sizer.GetState() == SceneLoader::State::Ready )
+    {
+      eastl::vector< size_t > meshSizes;
+      for ( int meshIx = 0; meshIx < testMeshCount; ++meshIx )
+        meshSizes.push_back( sizer.GetMeshByteSize( meshIx ) );
+      eastl::sort( meshSizes.begin(), meshSizes.end() );
+
+      size_t maxQueuedBytes = meshSizes[ testMeshCount - 1 ] + meshSizes[ testMeshCount - 2 ];
+
+      SceneLoader loader( testScenePath, maxQueuedBytes );
+      loader.RequestMeshes( allMeshes );
+      loader.RequestMeshes( allMeshes );
+
+      eastl::vector< SceneLoader::ConvertedMesh > meshes;
+      TakeMeshes( loader, testMeshCount * 2, meshes );
+
+      auto stats = loader.GetStats();
+      CHECK( stats.takenMeshes == testMeshCount * 2 );
+      CHECK( stats.peakQueuedBytes > 0 && stats.peakQueuedBytes <= maxQueuedBytes );
+    }
+  }
+
+  _wremove( testScenePath );
+}
+
+TEST_CASE( SceneLoaderMissingFile )
+{
+  SceneLoader loader( L"TestSceneLoaderMissing.obj" );
+  loader.RequestMeshes( { 0 } );
+
+  // The failed import ends the wait, there is nothing to convert.
+  loader.WaitForConvertedMeshes();
+  CHECK( loader.GetState() == SceneLoader::State::Failed );
+  CHECK( !loader.GetError().empty() );
+  CHECK( loader.GetStats().convertedMeshes == 0 );
+}
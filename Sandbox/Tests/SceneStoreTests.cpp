@@ -0,0 +1,121 @@
+#include "TestRunner.h"
+#include "TestScene.h"
+
+static bool IsNear( FXMMATRIX a, CXMMATRIX b )
+{
+  auto epsilon = XMVectorReplicate( 0.001f );
+  return XMVector4NearEqual( a.r[ 0 ], b.r[ 0 ], epsilon )
+      && XMVector4NearEqual( a.r[ 1 ], b.r[ 1 ], epsilon )
+      && XMVector4NearEqual( a.r[ 2 ], b.r[ 2 ], epsilon )
+      && XMVector4NearEqual( a.r[ 3 ], b.r[ 3 ], epsilon );
+}
+
+TEST_CASE( SceneStoreNodeIndices )
+{
+  TestScene scene( 100, 0xBEEF );
+
+  int wrongIndices = 0;
+  for ( int nodeIx = 0; nodeIx < scene.sceneStore.GetNodeCount(); ++nodeIx )
+    wrongIndices += scene.sceneStore.GetNodeIndex( scene.sceneStore.GetNode( nodeIx ) ) != nodeIx;
+
+  CHECK( wrongIndices == 0 );
+
+  Node outsider;
+  CHECK( scene.sceneStore.GetNodeIndex( outsider ) == -1 );
+
+  auto& lastNode = scene.sceneStore.GetNode( scene.sceneStore.GetNodeCount() - 1 );
+  scene.sceneStore.Clear();
+  CHECK( scene.sceneStore.GetNodeIndex( lastNode ) == -1 );
+}
+
+TEST_CASE( SceneStoreWorldTransforms )
+{
+  TestScene scene( 0, 1 );
+
+  auto& parent = scene.AddNode( scene.rootNode, XMMatrixTranslation( 10, 0, 0 ) );
+  auto& child  = scene.AddNode( parent, XMMatrixRotationY( XM_PIDIV2 ) );
+  auto& leaf   = scene.AddNode( child, XMMatrixTranslation( 0, 0, 5 ) );
+  auto& other  = scene.AddNode( scene.rootNode, XMMatrixTranslation( 0, 3, 0 ) );
+  scene.Build();
+
+  auto& store = scene.sceneStore;
+  store.UpdateWorldTransforms();
+
+  for ( auto node : { &parent, &child, &leaf, &other } )
+    CHECK( IsNear( store.GetWorldTransform( store.GetNodeIndex( *node ) ), node->GetFullTransform() ) );
+
+  // Moving the parent moves its subtree, and only that.
+  parent.SetTransform( XMMatrixTranslation( -10, 0, 0 ) );
+  store.SetLocalTransform( store.GetNodeIndex( parent ), parent.GetTransform() );
+
+  eastl::vector< int > updatedNodes;
+  store.UpdateWorldTransforms( &updatedNodes );
+
+  CHECK( updatedNodes.size() == 3 );
+  CHECK( eastl::find( updatedNodes.begin(), updatedNodes.end(), store.GetNodeIndex( other ) ) == updatedNodes.end() );
+
+  for ( auto node : { &parent, &child, &leaf, &other } )
+    CHECK( IsNear( store.GetWorldTransform( store.GetNodeIndex( *node ) ), node->GetFullTransform() ) );
+
+  // The leaf is rotated by the child, so its offset ends up on the x axis.
+  auto leafPosition = store.GetWorldTransform( store.GetNodeIndex( leaf ) ).r[ 3 ];
+  CHECK( XMVector3NearEqual( leafPosition, XMVectorSet( -5, 0, 0, 1 ), XMVectorReplicate( 0.001f ) ) );
+
+  updatedNodes.clear();
+  store.UpdateWorldTransforms( &updatedNodes );
+  CHECK( updatedNodes.empty() );
+}
+
+// The meshes come and go while the scene streams, the instances left keep their random values.
+TEST_CASE( SceneStoreStableRandomValues )
+{
+  TestScene scene( 50, 0xCAFE );
+
+  auto& store = scene.sceneStore;
+
+  auto findSlot = [ & ]( int nodeIndex, int meshIndex ) -> const MeshSlot*
+  {
+    for ( int meshSlot = 0; meshSlot < store.GetInstanceCount(); ++meshSlot )
+      if ( store.GetMeshSlotNode( meshSlot ) == nodeIndex && store.GetMeshIndex( meshSlot ) == meshIndex )
+        return &store.GetMeshSlots()[ meshSlot ];
+    return nullptr;
+  };
+
+  eastl::vector< MeshSlot > slots = store.GetMeshSlots();
+  eastl::vector< int >      slotNodes;
+  eastl::vector< int >      slotMeshes;
+  for ( int meshSlot = 0; meshSlot < store.GetInstanceCount(); ++meshSlot )
+  {
+    slotNodes.push_back( store.GetMeshSlotNode( meshSlot ) );
+    slotMeshes.push_back( store.GetMeshIndex( meshSlot ) );
+  }
+
+  for ( int meshIx = 0; meshIx < int( scene.meshes.size() ); meshIx += 3 )
+    scene.meshes[ meshIx ].reset();
+  scene.Build();
+
+  CHECK( store.GetInstanceCount() < int( slots.size() ) );
+
+  int missing = 0;
+  int changed = 0;
+  for ( int slotIx = 0; slotIx < int( slots.size() ); ++slotIx )
+  {
+    if ( !scene.meshes[ slotMeshes[ slotIx ] ] )
+      continue;
+
+    auto slot = findSlot( slotNodes[ slotIx ], slotMeshes[ slotIx ] );
+    if ( !slot )
+    {
+      missing++;
+      continue;
+    }
+
+    changed += memcmp( &slot->randomValues, &slots[ slotIx ].randomValues, sizeof( slot->randomValues ) ) != 0;
+  }
+
+  CHECK( missing == 0 );
+  CHECK( changed == 0 );
+
+  // Not the same value for every instance either.
+  CHECK( memcmp( &slots[ 0 ].randomValues, &slots[ 1 ].randomValues, sizeof( slots[ 0 ].randomValues ) ) != 0 );
+}
@@ -0,0 +1,11 @@
+#include "TestDevice.h"
+#include "Render/Factory.h"
+#include "Render/Adapter.h"
+#include "Render/Device.h"
+
+Device& GetTestDevice()
+{
+  static auto adapter = Factory::CreateNull()->CreateDefaultAdapter();
+  static auto device  = adapter->CreateDevice();
+  return *device;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+struct Device;
+
+// The null device of the tests and benchmarks which need one. Created on the first call, without a render manager,
+// and kept until the process exits.
+Device& GetTestDevice();
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "TestRunner.h"
+#include "Common/CommandLine.h"
+#include "Common/JSON.h"
+
+// A benchmark run is at least this long, so the timer resolution does not matter.
+static constexpr double minimumRunSeconds = 0.02;
+static constexpr int    benchmarkRunCount = 7;
+static constexpr int    maximumIterations = 1 << 24;
+
+template< typename Func >
+struct Registered
+{
+  const char* name;
+  Func        func;
+};
+
+// Function local, the registrations run during the static initialization of the other files.
+static eastl::vector< Registered< TestRunner::TestFunc > >& GetTests()
+{
+  static eastl::vector< Registered< TestRunner::TestFunc > > tests;
+  return tests;
+}
+
+static eastl::vector< Registered< TestRunner::BenchmarkFunc > >& GetBenchmarks()
+{
+  static eastl::vector< Registered< TestRunner::BenchmarkFunc > > benchmarks;
+  return benchmarks;
+}
+
+static bool IsSelected( const char* name, const eastl::string& filter )
+{
+  return filter.empty() || strstr( name, filter.data() );
+}
+
+static bool WriteResults( const wchar_t* path, const eastl::string& json )
+{
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, path, L"wb" ) )
+    return false;
+
+  fwrite( json.data(), 1, json.size(), fileHandle );
+  fclose( fileHandle );
+  return true;
+}
+
+static int RunTests( const eastl::string& filter, const wchar_t* outputPath )
+{
+  eastl::string json = "{\n  \"tests\": [\n";
+  int failedCount = 0;
+  int testCount   = 0;
+
+  for ( auto& test : GetTests() )
+  {
+    if ( !IsSelected( test.name, filter ) )
+      continue;
+
+    TestRunner::Context testContext;
+    test.func( testContext );
+
+    if ( !testContext.failures.empty() )
+      failedCount++;
+
+    json += testCount++ > 0 ? ",\n" : "";
+    json += "    { \"name\": \"";
+    AppendJSONEscaped( json, test.name );
+    json += testContext.failures.empty() ? "\", \"passed\": true, \"failures\": [" : "\", \"passed\": false, \"failures\": [";
+    for ( int failureIx = 0; failureIx < int( testContext.failures.size() ); ++failureIx )
+    {
+      json += failureIx > 0 ? ", \"" : " \"";
+      AppendJSONEscaped( json, testContext.failures[ failureIx ] );
+      json += "\"";
+    }
+    json += " ] }";
+
+    OutputDebugStringA( ( eastl::string( testContext.failures.empty() ? "Passed: " : "FAILED: " ) + test.name + "\n" ).data() );
+    for ( auto& failure : testContext.failures )
+      OutputDebugStringA( ( "  " + failure + "\n" ).data() );
+  }
+
+  char summary[ 128 ];
+  sprintf_s( summary, "\n  ],\n  \"count\": %d,\n  \"failed\": %d\n}\n", testCount, failedCount );
+  json += summary;
+
+  WriteResults( outputPath, json );
+
+  return failedCount;
+}
+
+static double RunBenchmark( TestRunner::BenchmarkFunc func, int iterations )
+{
+  TestRunner::Timing timing;
+  timing.iterations = iterations;
+  timing.Start();
+  func( timing );
+  if ( timing.stop < timing.start )
+    timing.Stop();
+  return timing.stop - timing.start;
+}
+
+static int RunBenchmarks( const eastl::string& filter, const wchar_t* outputPath )
+{
+  eastl::string json = "{\n  \"benchmarks\": [\n";
+  int benchmarkCount = 0;
+
+  for ( auto& benchmark : GetBenchmarks() )
+  {
+    if ( !IsSelected( benchmark.name, filter ) )
+      continue;
+
+    // Warms up the caches, then doubles the iterations until a run is long enough.
+    int iterations = 1;
+    for ( auto seconds = RunBenchmark( benchmark.func, iterations ); seconds < minimumRunSeconds && iterations < maximumIterations; )
+    {
+      iterations = seconds > 0 ? int( eastl::min( iterations * minimumRunSeconds * 1.2 / seconds, double( maximumIterations ) ) ) : iterations * 2;
+      iterations = eastl::max( iterations, 1 );
+      seconds    = RunBenchmark( benchmark.func, iterations );
+    }
+
+    eastl::vector< double > nanoseconds;
+    for ( int runIx = 0; runIx < benchmarkRunCount; ++runIx )
+      nanoseconds.push_back( RunBenchmark( benchmark.func, iterations ) * 1e9 / iterations );
+
+    eastl::sort( nanoseconds.begin(), nanoseconds.end() );
+
+    char line[ 256 ];
+    sprintf_s( line, "\", \"iterations\": %d, \"medianNs\": %.3f, \"minNs\": %.3f, \"maxNs\": %.3f }"
+             , iterations
+             , nanoseconds[ benchmarkRunCount / 2 ]
+             , nanoseconds.front()
+             , nanoseconds.back() );
+
+    json += benchmarkCount++ > 0 ? ",\n" : "";
+    json += "    { \"name\": \"";
+    AppendJSONEscaped( json, benchmark.name );
+    json += line;
+
+    sprintf_s( line, "%s: %.3f ns\n", benchmark.name, nanoseconds[ benchmarkRunCount / 2 ] );
+    OutputDebugStringA( line );
+  }
+
+  json += "\n  ]\n}\n";
+
+  return WriteResults( outputPath, json ) ? 0 : -1;
+}
+
+void TestRunner::Context::Check( bool passed, const char* expression, const char* file, int line )
+{
+  if ( passed )
+    return;
+
+  char failure[ 512 ];
+  sprintf_s( failure, "%s(%d): %s", file, line, expression );
+  failures.emplace_back( failure );
+}
+
+void TestRunner::Timing::Start()
+{
+  start = GetCPUTime();
+}
+
+void TestRunner::Timing::Stop()
+{
+  stop = GetCPUTime();
+}
+
+TestRunner::Registration::Registration( const char* name, TestFunc func )
+{
+  GetTests().push_back( { name, func } );
+}
+
+TestRunner::Registration::Registration( const char* name, BenchmarkFunc func )
+{
+  GetBenchmarks().push_back( { name, func } );
+}
+
+bool TestRunner::ParseCommandLine( const wchar_t* commandLine, Options& options )
+{
+  auto tokens = SplitCommandLine( commandLine );
+
+  for ( int tokenIx = 0; tokenIx < int( tokens.size() ); ++tokenIx )
+  {
+    auto& token   = tokens[ tokenIx ];
+    bool  hasNext = tokenIx + 1 < int( tokens.size() );
+
+    if ( token == L"-test" || token == L"-microbench" )
+    {
+      options.runTests      = token == L"-test";
+      options.runBenchmarks = token == L"-microbench";
+      if ( hasNext && tokens[ tokenIx + 1 ][ 0 ] != L'-' )
+        options.filter = tokens[ ++tokenIx ];
+    }
+    else if ( token == L"-output" && hasNext )
+      options.outputPath = tokens[ ++tokenIx ];
+  }
+
+  if ( options.outputPath.empty() )
+    options.outputPath = options.runTests ? L"Tests.json" : L"MicroBenchmarks.json";
+
+  return options.runTests || options.runBenchmarks;
+}
+
+int TestRunner::Run( const Options& options )
+{
+  auto filter = N( options.filter.data() );
+
+  if ( options.runTests )
+    return RunTests( filter, options.outputPath.data() );
+
+  return RunBenchmarks( filter, options.outputPath.data() );
+}
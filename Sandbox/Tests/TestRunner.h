@@ -0,0 +1,76 @@
+#pragma once
+
+// Unit tests and micro benchmarks, compiled into the app and run by -test and -microbench before a window is created.
+// Tests register themselves with TEST_CASE and check with CHECK, the benchmarks with MICRO_BENCHMARK. Tests which
+// need a device create the null device themselves. The results are written as JSON, the exit code of the tests is
+// the number of failed ones.
+// They are a mode of the app rather than a target of their own. The code they cover, the tile heap, the tiler, Signal,
+// AsyncJobThread and the sample sequences included, builds on the Windows precompiled header with the rest of the app,
+// so there is no Linux build of them.
+class TestRunner
+{
+public:
+  struct Options
+  {
+    bool           runTests      = false;
+    bool           runBenchmarks = false;
+    eastl::wstring filter;
+    eastl::wstring outputPath;
+  };
+
+  struct Context
+  {
+    void Check( bool passed, const char* expression, const char* file, int line );
+
+    eastl::vector< eastl::string > failures;
+  };
+
+  // The body runs its loop iterations times, the runner picks the count so a run is long enough to be measured.
+  // Setup before Start and cleanup after Stop are left out of the time.
+  struct Timing
+  {
+    void Start();
+    void Stop();
+
+    int    iterations = 1;
+    double start      = 0;
+    double stop       = 0;
+  };
+
+  using TestFunc      = void ( * )( Context& testContext );
+  using BenchmarkFunc = void ( * )( Timing& timing );
+
+  struct Registration
+  {
+    Registration( const char* name, TestFunc func );
+    Registration( const char* name, BenchmarkFunc func );
+  };
+
+  // Returns false without -test or -microbench on the command line.
+  // -test [filter] [-output path]
+  // -microbench [filter] [-output path]
+  static bool ParseCommandLine( const wchar_t* commandLine, Options& options );
+
+  // Only the tests and benchmarks with the filter in their names are run.
+  static int Run( const Options& options );
+};
+
+#define TEST_CASE( name ) \
+  static void name##Test( TestRunner::Context& testContext ); \
+  static TestRunner::Registration name##TestRegistration( #name, name##Test ); \
+  static void name##Test( TestRunner::Context& testContext )
+
+#define CHECK( expression ) testContext.Check( bool( expression ), #expression, __FILE__, __LINE__ )
+
+#define MICRO_BENCHMARK( name ) \
+  static void name##Benchmark( TestRunner::Timing& timing ); \
+  static TestRunner::Registration name##BenchmarkRegistration( #name, name##Benchmark ); \
+  static void name##Benchmark( TestRunner::Timing& timing )
+
+// Keeps the compiler from dropping the work of a benchmark loop.
+template< typename T >
+inline void KeepValue( const T& value )
+{
+  static volatile T sink;
+  sink = value;
+}
\ No newline at end of file
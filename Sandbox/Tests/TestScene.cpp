@@ -0,0 +1,66 @@
+#include "TestScene.h"
+
+TestScene::TestScene( int nodeCount, uint32_t seed )
+  : randomState( seed ? seed : 1 )
+{
+  rootNode.SetName( "Root" );
+
+  eastl::vector< Node* > nodes;
+  for ( int nodeIx = 0; nodeIx < nodeCount; ++nodeIx )
+  {
+    auto rotation    = XMMatrixRotationRollPitchYaw( Random() * XM_2PI, Random() * XM_2PI, Random() * XM_2PI );
+    auto scale       = XMMatrixScaling( 0.5f + Random() * 1.5f, 0.5f + Random() * 1.5f, 0.5f + Random() * 1.5f );
+    auto translation = XMMatrixTranslation( Random() * 200 - 100, Random() * 200 - 100, Random() * 200 - 100 );
+
+    // Every fourth node goes below an earlier one, so the world transforms are composed too.
+    auto& parent = nodeIx % 4 == 3 ? *nodes[ int( Random() * nodes.size() ) ] : rootNode;
+    auto& node   = AddNode( parent, scale * rotation * translation );
+    nodes.push_back( &node );
+
+    int meshCount = 1 + int( Random() * 3 );
+    for ( int meshIx = 0; meshIx < meshCount; ++meshIx )
+    {
+      XMFLOAT3 center ( Random() * 10 - 5, Random() * 10 - 5, Random() * 10 - 5 );
+      XMFLOAT3 extents( 0.1f + Random() * 5, 0.1f + Random() * 5, 0.1f + Random() * 5 );
+      AddMesh( node, center, extents );
+    }
+  }
+
+  Build();
+}
+
+Node& TestScene::AddNode( Node& parent, FXMMATRIX transform )
+{
+  auto node = eastl::make_unique< Node >();
+  node->SetTransform( transform );
+  return parent.AddChildNode( eastl::move( node ) );
+}
+
+int TestScene::AddMesh( Node& node, const XMFLOAT3& center, const XMFLOAT3& extents )
+{
+  int meshIndex = int( meshes.size() );
+  meshes.emplace_back( eastl::make_unique< Mesh >( BoundingBox( center, extents ), 3, 0 ) );
+  node.AddChildMesh( meshIndex );
+  return meshIndex;
+}
+
+void TestScene::Build()
+{
+  sceneStore.Build( rootNode, meshes );
+}
+
+float TestScene::Random()
+{
+  // xorshift32, the same sequence on every platform, unlike rand.
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return float( randomState >> 8 ) / float( 1 << 24 );
+}
+
+XMMATRIX GetTestViewProjection( FXMVECTOR eye, FXMVECTOR target )
+{
+  auto view       = XMMatrixLookAtLH( eye, target, XMVectorSet( 0, 1, 0, 0 ) );
+  auto projection = XMMatrixPerspectiveFovLH( XMConvertToRadians( 60 ), 16.0f / 9, 0.1f, 1000 );
+  return view * projection;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Scene/Node.h"
+#include "Scene/SceneStore.h"
+#include "Render/Mesh.h"
+
+// Random nodes below the root, each with one to three bounds only meshes, for the tests of the CPU side scene
+// queries. The nodes are spread in a 200 unit cube around the origin, some of them with children of their own.
+// The same seed gives the same scene.
+struct TestScene
+{
+  TestScene( int nodeCount, uint32_t seed );
+
+  Node& AddNode( Node& parent, FXMMATRIX transform );
+  int   AddMesh( Node& node, const XMFLOAT3& center, const XMFLOAT3& extents );
+
+  // Rebuilds the store, call it after adding nodes and meshes.
+  void Build();
+
+  // Uniform in [ 0, 1 ), from the seed.
+  float Random();
+
+  Node                                       rootNode;
+  eastl::vector< eastl::unique_ptr< Mesh > > meshes;
+  SceneStore                                 sceneStore;
+
+  uint32_t randomState;
+};
+
+// A 16:9 perspective camera looking at target.
+XMMATRIX GetTestViewProjection( FXMVECTOR eye, FXMVECTOR target );
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "TestRunner.h"
+#include "../TextureTiler/TileCopy.h"
+
+// An 8x4 block mip of one byte blocks, cut into 4x2 block tiles.
+TEST_CASE( TextureTilerTileOrder )
+{
+  eastl::vector< uint8_t > mipData( 32 );
+  for ( int byteIx = 0; byteIx < 32; ++byteIx )
+    mipData[ byteIx ] = uint8_t( byteIx );
+
+  eastl::vector< uint8_t >                  tileData( 8 );
+  eastl::vector< eastl::vector< uint8_t > > tiles;
+  eastl::vector< eastl::pair< int, int > >  coordinates;
+
+  bool completed = CopyMipTiles( mipData.data(), 8, 4, 4, 2, 1, tileData.data(), tileData.size(), [ & ]( int tx, int ty )
+  {
+    tiles.push_back( tileData );
+    coordinates.emplace_back( tx, ty );
+    return true;
+  } );
+
+  CHECK( completed );
+  CHECK( tiles.size() == 4 );
+  CHECK( coordinates[ 1 ] == eastl::make_pair( 1, 0 ) && coordinates[ 2 ] == eastl::make_pair( 0, 1 ) );
+
+  uint8_t secondTile[] = { 4, 5, 6, 7, 12, 13, 14, 15 };
+  CHECK( memcmp( tiles[ 1 ].data(), secondTile, 8 ) == 0 );
+
+  uint8_t thirdTile[] = { 16, 17, 18, 19, 24, 25, 26, 27 };
+  CHECK( memcmp( tiles[ 2 ].data(), thirdTile, 8 ) == 0 );
+}
+
+TEST_CASE( TextureTilerStopsOnFailure )
+{
+  eastl::vector< uint8_t > mipData( 32 );
+  eastl::vector< uint8_t > tileData( 8 );
+
+  int tileCount = 0;
+  bool completed = CopyMipTiles( mipData.data(), 8, 4, 4, 2, 1, tileData.data(), tileData.size(), [ & ]( int, int ) { return ++tileCount < 2; } );
+
+  CHECK( !completed );
+  CHECK( tileCount == 2 );
+}
@@ -0,0 +1,95 @@
+#include "TestRunner.h"
+#include "TestDevice.h"
+#include "Render/UploadAllocator.h"
+#include "Render/Device.h"
+#include "Render/Resource.h"
+
+static constexpr int testPageSize = 4096;
+
+// A pool of small pages on the null device, counting the pages it creates.
+struct TestPagePool : UploadPagePool
+{
+  TestPagePool()
+    : UploadPagePool( [ this ]( int size )
+      {
+        createdPages++;
+        return GetTestDevice().AllocateUploadBuffer( size, L"TestUploadPage" );
+      }, testPageSize )
+  {
+  }
+
+  int createdPages = 0;
+};
+
+TEST_CASE( UploadAllocatorLinear )
+{
+  TestPagePool    pool;
+  UploadAllocator allocator( pool );
+
+  auto first  = allocator.Allocate( 100, 1 );
+  auto second = allocator.Allocate( 10, 256 );
+  auto third  = allocator.Allocate( 4, 4 );
+  CHECK( first.resource && first.cpuAddress );
+  CHECK( first.offset == 0 && second.offset == 256 && third.offset == 268 );
+  CHECK( second.resource == first.resource && third.resource == first.resource );
+  CHECK( second.cpuAddress == first.cpuAddress + 256 );
+  CHECK( pool.createdPages == 1 );
+
+  // The rest of the page is too small, the allocation starts a new one.
+  auto fourth = allocator.Allocate( testPageSize - 100, 16 );
+  CHECK( fourth.resource != first.resource && fourth.offset == 0 );
+  CHECK( pool.createdPages == 2 );
+
+  allocator.Retire( CommandQueueType::Direct, 5 );
+
+  auto stats = pool.GetStats();
+  CHECK( stats.pageCount == 2 && stats.retiredPageCount == 2 && stats.freePageCount == 0 );
+  CHECK( stats.pageMemory == 2 * testPageSize );
+}
+
+TEST_CASE( UploadAllocatorRecyclesPages )
+{
+  TestPagePool pool;
+
+  {
+    UploadAllocator allocator( pool );
+    allocator.Allocate( 64, 16 );
+    allocator.Retire( CommandQueueType::Direct, 5 );
+  }
+
+  // Only the fence of the queue the page was retired on frees it.
+  pool.RecyclePages( CommandQueueType::Direct, 4 );
+  pool.RecyclePages( CommandQueueType::Copy, 5 );
+  CHECK( pool.GetStats().retiredPageCount == 1 && pool.GetStats().freePageCount == 0 );
+
+  pool.RecyclePages( CommandQueueType::Direct, 5 );
+  CHECK( pool.GetStats().retiredPageCount == 0 && pool.GetStats().freePageCount == 1 );
+
+  // The next list starts on the recycled page, from its beginning.
+  UploadAllocator allocator( pool );
+  auto allocation = allocator.Allocate( 64, 16 );
+  CHECK( allocation.offset == 0 );
+  CHECK( pool.createdPages == 1 && pool.GetStats().freePageCount == 0 );
+
+  allocator.Retire( CommandQueueType::Direct, 6 );
+}
+
+TEST_CASE( UploadAllocatorOversizedPages )
+{
+  TestPagePool    pool;
+  UploadAllocator allocator( pool );
+
+  allocator.Allocate( 64, 16 );
+
+  // Bigger than a page, it gets a page of its own.
+  auto large = allocator.Allocate( testPageSize * 3, 16 );
+  CHECK( large.offset == 0 );
+  CHECK( pool.GetStats().pageMemory == testPageSize * 4 );
+
+  allocator.Retire( CommandQueueType::Compute, 1 );
+  pool.RecyclePages( CommandQueueType::Compute, 1 );
+
+  // The oversized page is released instead of reused.
+  auto stats = pool.GetStats();
+  CHECK( stats.pageCount == 1 && stats.freePageCount == 1 && stats.pageMemory == testPageSize );
+}
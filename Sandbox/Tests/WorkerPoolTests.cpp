@@ -0,0 +1,67 @@
+#include "TestRunner.h"
+#include "Common/WorkerPool.h"
+#include "Common/ParallelFor.h"
+
+TEST_CASE( WorkerPoolRunsQueuedJobsBeforeExit )
+{
+  eastl::atomic< int > done = 0;
+
+  {
+    WorkerPool pool( 2, "TestWorker" );
+    for ( int jobIx = 0; jobIx < 100; ++jobIx )
+      pool.Enqueue( [ &done ]() { done++; } );
+  }
+
+  CHECK( done == 100 );
+}
+
+TEST_CASE( WorkerPoolAsyncResult )
+{
+  WorkerPool pool( 1, "TestWorker" );
+
+  auto result = pool.Async( []() { return 42; } );
+
+  CHECK( result.get() == 42 );
+}
+
+TEST_CASE( ParallelForCoversRangeOnce )
+{
+  for ( int count : { 0, 1, 7, 64, 1000, 4099 } )
+  {
+    eastl::vector< eastl::atomic< int > > visits( count );
+    for ( auto& visit : visits )
+      visit = 0;
+
+    eastl::atomic< int > rangeCount = 0;
+    ParallelFor( count, 16, [ & ]( int begin, int end )
+    {
+      rangeCount++;
+      for ( int ix = begin; ix < end; ++ix )
+        visits[ ix ]++;
+    } );
+
+    int wrongVisits = 0;
+    for ( auto& visit : visits )
+      wrongVisits += visit != 1;
+
+    CHECK( wrongVisits == 0 );
+    CHECK( rangeCount <= eastl::max( 1, ( count + 15 ) / 16 ) );
+  }
+}
+
+// Every range starts another ParallelFor, the inner ones run on the threads of the outer ones without waiting.
+TEST_CASE( ParallelForNested )
+{
+  static constexpr int outerCount = 64;
+  static constexpr int innerCount = 256;
+
+  eastl::atomic< int > sum = 0;
+
+  ParallelFor( outerCount, 1, [ & ]( int outerBegin, int outerEnd )
+  {
+    for ( int outerIx = outerBegin; outerIx < outerEnd; ++outerIx )
+      ParallelFor( innerCount, 8, [ & ]( int innerBegin, int innerEnd ) { sum += innerEnd - innerBegin; } );
+  } );
+
+  CHECK( sum == outerCount * innerCount );
+}
@@ -0,0 +1,154 @@
+#include "TestRunner.h"
+#include "Scene/WorldPartition.h"
+#include "Scene/WorldStreamer.h"
+
+static WorldPartition::MeshInstance MakeInstance( int meshIndex, const XMFLOAT3& center, float extent )
+{
+  return { meshIndex, BoundingBox( center, XMFLOAT3( extent, extent, extent ) ) };
+}
+
+// Five cells along the x axis, 10 units apart, each with a mesh of its own, and a mesh shared by the first two.
+struct StreamedWorld
+{
+  static constexpr int cellCount = 5;
+
+  StreamedWorld()
+  {
+    eastl::vector< WorldPartition::MeshInstance > instances;
+    for ( int cellIx = 0; cellIx < cellCount; ++cellIx )
+      instances.push_back( MakeInstance( cellIx, XMFLOAT3( cellIx * 10.0f, 0, 0 ), 1 ) );
+    instances.push_back( MakeInstance( sharedMesh, XMFLOAT3( 0.5f, 0, 0 ), 1 ) );
+    instances.push_back( MakeInstance( sharedMesh, XMFLOAT3( 10.5f, 0, 0 ), 1 ) );
+
+    partition.Build( instances, 4 );
+  }
+
+  eastl::vector< size_t > GetMeshByteSizes() const
+  {
+    eastl::vector< size_t > meshByteSizes( cellCount, 100 );
+    meshByteSizes.push_back( 50 );
+    return meshByteSizes;
+  }
+
+  static constexpr int sharedMesh = cellCount;
+
+  WorldPartition partition;
+};
+
+TEST_CASE( WorldPartitionCells )
+{
+  WorldPartition partition;
+  partition.Build( {}, 4 );
+  CHECK( partition.GetCellCount() == 0 );
+
+  // The grid spans 0 to 10 with a cell size of 5, the height of the instances does not matter.
+  eastl::vector< WorldPartition::MeshInstance > instances;
+  instances.push_back( MakeInstance( 0, XMFLOAT3( 0, 0, 0 ), 1 ) );
+  instances.push_back( MakeInstance( 1, XMFLOAT3( 2, 50, 1 ), 1 ) );
+  instances.push_back( MakeInstance( 0, XMFLOAT3( 7, 0, 2 ), 1 ) );
+  instances.push_back( MakeInstance( 2, XMFLOAT3( 7, 0, 7 ), 3 ) );
+  instances.push_back( MakeInstance( 3, XMFLOAT3( 10, 0, 10 ), 0.5f ) );
+  instances.push_back( MakeInstance( 1, XMFLOAT3( 1, 0, 2 ), 1 ) );
+  partition.Build( instances, 2 );
+
+  CHECK( partition.GetCellCount() == 4 );
+
+  // A mesh is listed once in a cell, however many of its instances are there, and in every cell it is used in.
+  auto& firstCell = partition.GetCell( 0 );
+  CHECK( firstCell.meshIndices.size() == 2 && firstCell.meshIndices[ 0 ] == 0 && firstCell.meshIndices[ 1 ] == 1 );
+  CHECK( partition.GetMeshCells( 0 ).size() == 2 );
+  CHECK( partition.GetMeshCells( 1 ).size() == 1 && partition.GetMeshCells( 1 )[ 0 ] == 0 );
+  CHECK( partition.GetMeshCells( 5 ).empty() );
+
+  // The bounds of a cell are the merged bounds of its instances, and can reach out of the grid cell.
+  int largeCell = partition.GetMeshCells( 2 )[ 0 ];
+  CHECK( partition.GetCellDistance( largeCell, XMVectorSet( 7, 0, 7, 1 ) ) == 0 );
+  CHECK( partition.GetCellDistance( largeCell, XMVectorSet( 4.5f, 0, 4.5f, 1 ) ) == 0 );
+  CHECK( fabsf( partition.GetCellDistance( largeCell, XMVectorSet( 7, 100, 12, 1 ) ) - 2 ) < 0.0001f );
+  CHECK( fabsf( partition.GetCellDistance( largeCell, XMVectorSet( 13, 0, 14, 1 ) ) - 5 ) < 0.0001f );
+}
+
+TEST_CASE( WorldStreamerBudget )
+{
+  StreamedWorld world;
+  CHECK( world.partition.GetCellCount() == StreamedWorld::cellCount );
+
+  WorldStreamer::Settings settings;
+  settings.memoryBudget = 300;
+
+  WorldStreamer streamer( world.partition, world.GetMeshByteSizes(), settings );
+
+  eastl::vector< int > meshesToLoad;
+  eastl::vector< int > meshesToEvict;
+
+  // The two nearest cells fit the budget, the shared mesh is counted once.
+  streamer.Update( XMVectorSet( 0, 0, 0, 1 ), 0, meshesToLoad, meshesToEvict );
+  CHECK( meshesToLoad == eastl::vector< int >( { 0, StreamedWorld::sharedMesh, 1 } ) );
+  CHECK( meshesToEvict.empty() );
+  CHECK( !streamer.IsSettled() );
+
+  CHECK( streamer.OnMeshResident( 0, 1 ) );
+  CHECK( streamer.OnMeshResident( StreamedWorld::sharedMesh, 1 ) );
+  CHECK( streamer.GetResidentCellCount() == 1 && !streamer.IsSettled() );
+  CHECK( streamer.OnMeshResident( 1, 2 ) );
+  CHECK( !streamer.OnMeshResident( 1, 2 ) );
+  CHECK( streamer.IsSettled() );
+  CHECK( streamer.GetResidentCellCount() == 2 && streamer.GetResidentBytes() == 250 );
+  CHECK( streamer.GetCellStats()[ 1 ].maxLatency == 2 );
+
+  // Nothing changes while the camera stays.
+  meshesToLoad.clear();
+  streamer.Update( XMVectorSet( 0, 0, 0, 1 ), 3, meshesToLoad, meshesToEvict );
+  CHECK( meshesToLoad.empty() && meshesToEvict.empty() );
+
+  // At the other end the nearer cells take the memory of the farthest resident ones.
+  streamer.Update( XMVectorSet( 40, 0, 0, 1 ), 4, meshesToLoad, meshesToEvict );
+  CHECK( meshesToLoad == eastl::vector< int >( { 4, 3, 2 } ) );
+  CHECK( meshesToEvict == eastl::vector< int >( { 0, 1, StreamedWorld::sharedMesh } ) );
+  CHECK( streamer.GetResidentBytes() == 0 );
+  CHECK( streamer.GetCellStats()[ 0 ].evictions == 1 && streamer.GetCellStats()[ 1 ].evictions == 1 );
+
+  CHECK( streamer.GetPeakCommittedBytes() == 300 );
+  CHECK( streamer.GetPeakResidentBytes() == 250 );
+  CHECK( streamer.GetCellByteSize( 0 ) == 150 );
+}
+
+TEST_CASE( WorldStreamerRadius )
+{
+  StreamedWorld world;
+
+  WorldStreamer::Settings settings;
+  settings.loadRadius  = 15;
+  settings.evictRadius = 25;
+
+  WorldStreamer streamer( world.partition, world.GetMeshByteSizes(), settings );
+
+  eastl::vector< int > meshesToLoad;
+  eastl::vector< int > meshesToEvict;
+
+  streamer.Update( XMVectorSet( 0, 0, 0, 1 ), 0, meshesToLoad, meshesToEvict );
+  CHECK( meshesToLoad == eastl::vector< int >( { 0, StreamedWorld::sharedMesh, 1 } ) );
+
+  // Between the two radii the cells stay, beyond the evict radius they go, even when not arrived yet.
+  meshesToLoad.clear();
+  streamer.Update( XMVectorSet( 20, 0, 0, 1 ), 1, meshesToLoad, meshesToEvict );
+  CHECK( meshesToLoad == eastl::vector< int >( { 2, 3 } ) );
+  CHECK( meshesToEvict.empty() );
+
+  meshesToLoad.clear();
+  streamer.Update( XMVectorSet( 40, 0, 0, 1 ), 2, meshesToLoad, meshesToEvict );
+  CHECK( meshesToLoad == eastl::vector< int >( { 4 } ) );
+
+  // The cells are released nearest first, the shared mesh goes with the second one.
+  CHECK( meshesToEvict == eastl::vector< int >( { 1, 0, StreamedWorld::sharedMesh } ) );
+
+  // Evicted while loading, the mesh is not waited for anymore.
+  CHECK( !streamer.OnMeshResident( 0, 3 ) );
+  CHECK( !streamer.IsSettled() );
+
+  CHECK( streamer.OnMeshResident( 2, 3 ) );
+  CHECK( streamer.OnMeshResident( 3, 3 ) );
+  CHECK( streamer.OnMeshResident( 4, 3 ) );
+  CHECK( streamer.IsSettled() );
+  CHECK( streamer.GetResidentCellCount() == 3 && streamer.GetResidentBytes() == 300 );
+}
@@ -2,6 +2,8 @@
 #include "../DearImGui/imgui.h"
 #include "Render/ShaderStructures.h"
 #include "Render/RenderManager.h"
+#include "Render/Device.h"
+#include "Render/GPUPassStatistics.h"
 
 static constexpr int fpsPeriod = 10;
 
@@ -76,7 +78,8 @@ void DebugWindow::Tick( CommandList& commandList, double timeElapsed )
     fpsAccum = 0;
   }
 
-  auto memoryStats = RenderManager::GetInstance().GetMemoryStats();
+  auto memoryStats    = RenderManager::GetInstance().GetMemoryStats();
+  auto allocatorStats = RenderManager::GetInstance().GetCommandAllocatorStats( CommandQueueType::Direct );
 
   if ( ImGui::Begin( "Debug", nullptr, ImGuiWindowFlags_AlwaysAutoResize ) )
   {
@@ -105,6 +108,14 @@ void DebugWindow::Tick( CommandList& commandList, double timeElapsed )
 
     ImGui::Checkbox( "Freeze culling", &freezeCulling );
 
+    ImGui::Checkbox( "CPU culling", &cpuCulling );
+    if ( cpuCulling )
+    {
+      ImGui::Text( "Frustum: %d / %d mesh slots visible, %.3f ms", cpuCullingStats.frustumVisible, cpuCullingStats.meshSlots, cpuCullingStats.frustumMs );
+      ImGui::Text( "Occlusion: %d mesh slots hidden, %.3f ms", cpuCullingStats.occlusionCulled, cpuCullingStats.occlusionMs );
+      ImGui::Text( "BVH: %d candidate mesh slots, %.3f ms", cpuCullingStats.bvhCandidates, cpuCullingStats.bvhMs );
+    }
+
     ImGui::Separator();
 
     if ( ImGui::BeginCombo( "Debug output", GetDebugOutputName( debugOutput ), ImGuiComboFlags_PopupAlignLeft | ImGuiComboFlags_HeightRegular ) )
@@ -128,6 +139,37 @@ void DebugWindow::Tick( CommandList& commandList, double timeElapsed )
 
     ImGui::Separator();
 
+    ImGui::Text( "Command allocators: %d live, %d in flight, %d created", allocatorStats.live, allocatorStats.inFlight, allocatorStats.createdTotal );
+
+    ImGui::SliderInt( "CPU capture frames", &cpuCaptureFrames, 1, 300 );
+    if ( CPUProfiler::IsCapturing() )
+      ImGui::Text( "Capturing CPU trace..." );
+    else if ( ImGui::Button( "Capture CPU trace" ) )
+      CPUProfiler::StartCapture( cpuCaptureFrames, L"CPUTrace.json" );
+
+    ImGui::Separator();
+
+    auto& gpuPassStatistics = RenderManager::GetInstance().GetDevice().GetGPUPassStatistics();
+    if ( ImGui::TreeNode( "GPU passes (ms)" ) )
+    {
+      ImGui::Text( "%-40s %8s %8s %8s %8s", "Pass", "avg", "p50", "p95", "max" );
+      for ( auto& passStats : gpuPassStatistics.GetStats() )
+        ImGui::Text( "%-40s %8.3f %8.3f %8.3f %8.3f", N( passStats.name.data() ).data(), passStats.average, passStats.median, passStats.p95, passStats.max );
+      ImGui::TreePop();
+    }
+
+    if ( ImGui::Button( "Dump GPU stats to CSV" ) )
+      gpuPassStatistics.WriteCSV( L"GPUStats.csv" );
+
+    if ( ImGui::TreeNode( "Parallel pass recording (ms)" ) )
+    {
+      for ( auto& timing : passRecordTimings )
+        ImGui::Text( "%-40s %8.3f", N( timing.name ).data(), timing.recordTime * 1000 );
+      ImGui::TreePop();
+    }
+
+    ImGui::Separator();
+
     ImGui::Text( "Texture count: %d", memoryStats.textureCount );
     ImGui::Text( "Texture virtual allocation size (MB): %.3f", double( memoryStats.virtualAllocationSize ) / ( 1024 * 1024 ) );
     ImGui::Text( "Texture physical allocation size (MB): %.3f", double( memoryStats.physicalAllocationSize ) / ( 1024 * 1024 ) );
@@ -189,3 +231,18 @@ DebugOutput DebugWindow::GetDebugOutput() const
 {
   return debugOutput;
 }
+
+bool DebugWindow::GetCPUCulling() const
+{
+  return cpuCulling;
+}
+
+void DebugWindow::SetCPUCullingStats( const CPUCullingStats& stats )
+{
+  cpuCullingStats = stats;
+}
+
+void DebugWindow::SetPassRecordTimings( const eastl::vector< ParallelCommandRecorder::PassTiming >& timings )
+{
+  passRecordTimings = timings;
+}
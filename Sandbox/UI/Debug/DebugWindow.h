@@ -3,6 +3,8 @@
 #include "../UIWindow.h"
 #include "Render/Upscaling.h"
 #include "Render/ShaderStructures.h"
+#include "Render/ParallelCommandRecorder.h"
+#include "Scene/FrustumCulling.h"
 
 enum class FrameDebugModeCB : int;
 
@@ -22,6 +24,10 @@ public:
   int                GetDebugHeapTextureIndex () const;
   bool               GetFreezeCulling         () const;
   DebugOutput        GetDebugOutput           () const;
+  bool               GetCPUCulling            () const;
+
+  void SetCPUCullingStats( const CPUCullingStats& stats );
+  void SetPassRecordTimings( const eastl::vector< ParallelCommandRecorder::PassTiming >& timings );
 
 
 private:
@@ -34,6 +40,11 @@ private:
 
   bool freezeCulling = false;
 
+  bool            cpuCulling = false;
+  CPUCullingStats cpuCullingStats;
+
+  eastl::vector< ParallelCommandRecorder::PassTiming > passRecordTimings;
+
   bool renderTexture      = false;
   int  renderTextureIndex = 0;
 
@@ -45,4 +56,6 @@ private:
   float manualExposure = 1.1f;
 
   DebugOutput debugOutput = DebugOutput::None;
+
+  int cpuCaptureFrames = 10;
 };
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "WorldStreamingSimulation.h"
+#include "Scene/SceneLoader.h"
+#include "Scene/WorldPartition.h"
+#include "Common/CommandLine.h"
+
+#include "assimp/inc/assimp/scene.h"
+
+// After the end of the path the streamer gets this many frames to settle, a budget too small for the cells around
+// the last position would keep it loading and evicting forever.
+static constexpr int maxSettleFrames = 3600;
+
+static eastl::vector< XMFLOAT3 > ReadCameraPath( const wchar_t* path )
+{
+  eastl::vector< XMFLOAT3 > cameraPath;
+
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, path, L"rb" ) )
+    return cameraPath;
+
+  char line[ 256 ];
+  while ( fgets( line, sizeof( line ), fileHandle ) )
+  {
+    XMFLOAT3 position;
+    if ( sscanf_s( line, "%f %f %f", &position.x, &position.y, &position.z ) == 3 )
+      cameraPath.push_back( position );
+  }
+
+  fclose( fileHandle );
+  return cameraPath;
+}
+
+bool WorldStreamingSimulation::ParseCommandLine( const wchar_t* commandLine, Options& options )
+{
+  auto tokens = SplitCommandLine( commandLine );
+  bool enabled = false;
+
+  for ( int tokenIx = 0; tokenIx < int( tokens.size() ); ++tokenIx )
+  {
+    auto& token   = tokens[ tokenIx ];
+    bool  hasNext = tokenIx + 1 < int( tokens.size() );
+
+    if ( token == L"-streamingsim" && hasNext )
+    {
+      enabled = true;
+      options.cameraPathPath = tokens[ ++tokenIx ];
+    }
+    else if ( token == L"-output" && hasNext )
+      options.outputPath = tokens[ ++tokenIx ];
+    else if ( token == L"-budget" && hasNext )
+      options.settings.memoryBudget = size_t( eastl::max( _wtoi( tokens[ ++tokenIx ].data() ), 1 ) ) * 1024 * 1024;
+    else if ( token == L"-loadradius" && hasNext )
+      options.settings.loadRadius = float( _wtof( tokens[ ++tokenIx ].data() ) );
+    else if ( token == L"-evictradius" && hasNext )
+      options.settings.evictRadius = float( _wtof( tokens[ ++tokenIx ].data() ) );
+    else if ( token == L"-frametime" && hasNext )
+      options.frameTime = _wtof( tokens[ ++tokenIx ].data() ) / 1000;
+  }
+
+  return enabled;
+}
+
+int WorldStreamingSimulation::Run( const wchar_t* hostFolder, const Options& options )
+{
+  auto cameraPath = ReadCameraPath( options.cameraPathPath.data() );
+  if ( cameraPath.empty() )
+  {
+    OutputDebugStringW( ( L"Failed to read camera path: " + options.cameraPathPath + L"\n" ).data() );
+    return -1;
+  }
+
+  auto sceneFilePath = SceneLoader::FindSceneFile( hostFolder );
+  if ( sceneFilePath.empty() )
+  {
+    OutputDebugStringW( ( L"Failed to find file in: " + eastl::wstring( hostFolder ) + L"\n" ).data() );
+    return -1;
+  }
+
+  SceneLoader loader( sceneFilePath.data() );
+
+  loader.WaitForConvertedMeshes();
+  if ( loader.GetState() == SceneLoader::State::Failed )
+  {
+    OutputDebugStringW( loader.GetError().data() );
+    return -1;
+  }
+
+  eastl::vector< WorldPartition::MeshInstance > meshInstances;
+  loader.CollectMeshInstances( meshInstances );
+
+  WorldPartition partition;
+  partition.Build( meshInstances, WorldPartition::DefaultCellsPerAxis );
+
+  eastl::vector< size_t > meshByteSizes( loader.GetScene().mNumMeshes );
+  for ( int meshIx = 0; meshIx < int( meshByteSizes.size() ); meshIx++ )
+    meshByteSizes[ meshIx ] = loader.GetMeshByteSize( meshIx );
+
+  WorldStreamer streamer( partition, eastl::move( meshByteSizes ), options.settings );
+
+  eastl::vector< int >                        meshesToLoad;
+  eastl::vector< int >                        meshesToEvict;
+  eastl::vector< SceneLoader::ConvertedMesh > batch;
+
+  int frameCount    = 0;
+  int maxFrameCount = int( cameraPath.size() ) + maxSettleFrames;
+  for ( ; frameCount < int( cameraPath.size() ) || ( !streamer.IsSettled() && frameCount < maxFrameCount ); frameCount++ )
+  {
+    auto frameStart = GetCPUTime();
+    auto& position  = cameraPath[ eastl::min( frameCount, int( cameraPath.size() ) - 1 ) ];
+
+    streamer.Update( XMLoadFloat3( &position ), frameStart, meshesToLoad, meshesToEvict );
+    loader.RequestMeshes( meshesToLoad );
+
+    // The same budget as the upload of the app, what is taken is resident.
+    loader.TakeConvertedMeshes( SceneLoader::UploadBytesPerFrame, batch );
+    for ( auto& convertedMesh : batch )
+      streamer.OnMeshResident( convertedMesh.meshIndex, GetCPUTime() );
+
+    meshesToLoad.clear();
+    meshesToEvict.clear();
+    batch.clear();
+
+    // The conversion keeps running on the workers for the rest of the frame.
+    auto remainingTime = options.frameTime - ( GetCPUTime() - frameStart );
+    if ( remainingTime > 0 )
+      std::this_thread::sleep_for( std::chrono::duration< double >( remainingTime ) );
+  }
+
+  bool settled = streamer.IsSettled();
+  if ( !settled )
+    OutputDebugStringW( ( L"The streaming did not settle in " + eastl::to_wstring( maxSettleFrames ) + L" frames after the camera path\n" ).data() );
+
+  FILE* fileHandle = nullptr;
+  if ( _wfopen_s( &fileHandle, options.outputPath.data(), L"wb" ) )
+    return -1;
+
+  fprintf( fileHandle
+         , "{\n  \"frames\": %d,\n  \"pathFrames\": %d,\n  \"settled\": %s,\n  \"budgetBytes\": %zu,\n  \"peakResidentBytes\": %zu,\n  \"peakCommittedBytes\": %zu,\n  \"peakQueuedBytes\": %zu,\n  \"cells\": [\n"
+         , frameCount
+         , int( cameraPath.size() )
+         , settled ? "true" : "false"
+         , options.settings.memoryBudget
+         , streamer.GetPeakResidentBytes()
+         , streamer.GetPeakCommittedBytes()
+         , loader.GetStats().peakQueuedBytes );
+
+  auto& cellStats = streamer.GetCellStats();
+  for ( int cellIx = 0; cellIx < int( cellStats.size() ); ++cellIx )
+  {
+    auto& stats = cellStats[ cellIx ];
+    fprintf( fileHandle
+           , "    { \"cell\": %d, \"meshes\": %d, \"bytes\": %zu, \"loads\": %d, \"evictions\": %d, \"averageLatencyMs\": %.4f, \"maxLatencyMs\": %.4f }%s\n"
+           , cellIx
+           , int( partition.GetCell( cellIx ).meshIndices.size() )
+           , streamer.GetCellByteSize( cellIx )
+           , stats.loads
+           , stats.evictions
+           , stats.completed > 0 ? stats.totalLatency * 1000 / stats.completed : 0.0
+           , stats.maxLatency * 1000
+           , cellIx + 1 < int( cellStats.size() ) ? "," : "" );
+  }
+  fprintf( fileHandle, "  ]\n}\n" );
+
+  fclose( fileHandle );
+
+  return 0;
+}
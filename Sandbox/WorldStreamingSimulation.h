@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Scene/WorldStreamer.h"
+
+// Replays a camera path through the world streamer, without a window or a device. The meshes are converted by the
+// scene loader for real, only the upload is left out, so the load latency of the cells is close to the one in the app.
+// The path is a text file with an "x y z" camera position per line, one line per frame. When the path is over, the
+// last position is kept until the cells settle, or for a limited number of frames. The peak memory, the load latency
+// per cell and whether the cells settled are written as JSON.
+class WorldStreamingSimulation
+{
+public:
+  struct Options
+  {
+    eastl::wstring          cameraPathPath;
+    eastl::wstring          outputPath = L"StreamingSimulation.json";
+    WorldStreamer::Settings settings;
+    double                  frameTime  = 1.0 / 60;
+  };
+
+  // Returns false without -streamingsim on the command line.
+  // -streamingsim path [-output path] [-budget megabytes] [-loadradius distance] [-evictradius distance] [-frametime milliseconds]
+  static bool ParseCommandLine( const wchar_t* commandLine, Options& options );
+
+  // Returns non zero when the scene or the camera path can't be loaded.
+  static int Run( const wchar_t* hostFolder, const Options& options );
+};
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <Windows.h>
+
+#include "../Sandbox/Render/ShaderPackageFormat.h"
+
+namespace fs = std::filesystem;
+
+struct ShaderFile
+{
+  std::wstring name;
+  fs::path     path;
+  uint64_t     nameHash;
+};
+
+static uint32_t alignUp( uint32_t value, uint32_t alignment )
+{
+  return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+// The debug build reads the _d variants, which are stored under the same name in their own package.
+static std::vector< ShaderFile > collectShaders( const fs::path& directory, bool debug )
+{
+  std::vector< ShaderFile > shaders;
+
+  for ( auto& entry : fs::directory_iterator( directory ) )
+  {
+    if ( !entry.is_regular_file() || entry.path().extension() != ".cso" )
+      continue;
+
+    auto name    = entry.path().stem().wstring();
+    bool isDebug = name.size() > 2 && name.compare( name.size() - 2, 2, L"_d" ) == 0;
+    if ( isDebug != debug )
+      continue;
+
+    if ( debug )
+      name.resize( name.size() - 2 );
+
+    shaders.push_back( { name, entry.path(), HashShaderName( name.data() ) } );
+  }
+
+  std::sort( shaders.begin(), shaders.end(), []( const ShaderFile& a, const ShaderFile& b ) { return a.nameHash < b.nameHash; } );
+
+  return shaders;
+}
+
+static bool readFile( const fs::path& path, std::vector< uint8_t >& data )
+{
+  std::ifstream   file( path, std::ios::binary | std::ios::ate );
+  std::streamsize size = file.tellg();
+  file.seekg( 0, std::ios::beg );
+
+  if ( size < 0 )
+    return false;
+
+  data.resize( size_t( size ) );
+  return bool( file.read( (char*)data.data(), size ) );
+}
+
+static bool isUpToDate( const fs::path& packagePath, const std::vector< ShaderFile >& shaders )
+{
+  std::error_code error;
+  auto packageTime = fs::last_write_time( packagePath, error );
+  if ( error )
+    return false;
+
+  // A removed shader does not touch any timestamp, but changes the count.
+  ShaderPackageHeader header = {};
+  std::ifstream file( packagePath, std::ios::binary );
+  if ( !file.read( (char*)&header, sizeof( header ) ) || header.version != ShaderPackageHeader::Version || header.entryCount != shaders.size() )
+    return false;
+
+  for ( auto& shader : shaders )
+    if ( fs::last_write_time( shader.path ) > packageTime )
+      return false;
+
+  return true;
+}
+
+static int pack( const std::vector< ShaderFile >& shaders, const fs::path& packagePath )
+{
+  for ( size_t shaderIx = 1; shaderIx < shaders.size(); ++shaderIx )
+  {
+    if ( shaders[ shaderIx ].nameHash == shaders[ shaderIx - 1 ].nameHash )
+    {
+      std::wcout << L"Name hash collision between " << shaders[ shaderIx - 1 ].name << L" and " << shaders[ shaderIx ].name << L"!\n";
+      return -1;
+    }
+  }
+
+  ShaderPackageHeader header;
+  header.magic      = ShaderPackageHeader::Magic;
+  header.version    = ShaderPackageHeader::Version;
+  header.entryCount = uint32_t( shaders.size() );
+  header.reserved   = 0;
+
+  std::vector< ShaderPackageEntry > entries( shaders.size() );
+  std::vector< uint8_t >            blob;
+
+  uint32_t dataStart = alignUp( uint32_t( sizeof( header ) + sizeof( ShaderPackageEntry ) * entries.size() ), ShaderPackageHeader::DataAlignment );
+
+  std::vector< uint8_t > shaderData;
+  for ( size_t shaderIx = 0; shaderIx < shaders.size(); ++shaderIx )
+  {
+    if ( !readFile( shaders[ shaderIx ].path, shaderData ) )
+    {
+      std::wcout << L"Failed to read " << shaders[ shaderIx ].path.wstring() << L"!\n";
+      return -1;
+    }
+
+    blob.resize( alignUp( uint32_t( blob.size() ), ShaderPackageHeader::DataAlignment ) );
+
+    entries[ shaderIx ].nameHash = shaders[ shaderIx ].nameHash;
+    entries[ shaderIx ].offset   = dataStart + uint32_t( blob.size() );
+    entries[ shaderIx ].size     = uint32_t( shaderData.size() );
+
+    blob.insert( blob.end(), shaderData.begin(), shaderData.end() );
+  }
+
+  // Written next to the package and renamed, so a running game never maps a half written file.
+  auto tempPath = packagePath;
+  tempPath += ".tmp";
+
+  {
+    std::ofstream file( tempPath, std::ios::binary | std::ios::trunc );
+    std::vector< uint8_t > padding( dataStart - sizeof( header ) - sizeof( ShaderPackageEntry ) * entries.size() );
+
+    file.write( (const char*)&header, sizeof( header ) );
+    file.write( (const char*)entries.data(), sizeof( ShaderPackageEntry ) * entries.size() );
+    file.write( (const char*)padding.data(), padding.size() );
+    file.write( (const char*)blob.data(), blob.size() );
+
+    if ( !file )
+    {
+      std::cout << "Failed to write the package!\n";
+      return -1;
+    }
+  }
+
+  std::error_code error;
+  fs::rename( tempPath, packagePath, error );
+  if ( error )
+  {
+    std::cout << "Failed to replace the package!\n";
+    return -1;
+  }
+
+  std::wcout << L"Packed " << shaders.size() << L" shaders into " << packagePath.wstring() << L"\n";
+  return 0;
+}
+
+// Stands in for the driver reading the bytecode, so both paths pay for touching the data.
+static uint32_t touch( const uint8_t* data, size_t size )
+{
+  uint32_t sum = 0;
+  for ( size_t byteIx = 0; byteIx < size; ++byteIx )
+    sum += data[ byteIx ];
+  return sum;
+}
+
+// Compares what the game did before, one ifstream read per shader, against mapping the package.
+// The files are in the system cache after the first round, so this measures the syscalls and copies, not the disk.
+static int benchmark( const std::vector< ShaderFile >& shaders, const fs::path& packagePath )
+{
+  using Clock = std::chrono::steady_clock;
+
+  constexpr int rounds = 50;
+
+  uint32_t checksum = 0;
+
+  auto looseStart = Clock::now();
+  for ( int round = 0; round < rounds; ++round )
+  {
+    for ( auto& shader : shaders )
+    {
+      std::vector< uint8_t > data;
+      if ( !readFile( shader.path, data ) )
+        return -1;
+      checksum += touch( data.data(), data.size() );
+    }
+  }
+  auto looseEnd = Clock::now();
+
+  auto packageStart = Clock::now();
+  for ( int round = 0; round < rounds; ++round )
+  {
+    auto fileHandle = CreateFileW( packagePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr );
+    if ( fileHandle == INVALID_HANDLE_VALUE )
+    {
+      std::cout << "Failed to open the package!\n";
+      return -1;
+    }
+
+    auto mappingHandle = CreateFileMappingW( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    auto mappedData    = mappingHandle ? static_cast< const uint8_t* >( MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 ) ) : nullptr;
+    if ( !mappedData )
+    {
+      std::cout << "Failed to map the package!\n";
+      return -1;
+    }
+
+    auto& header     = *reinterpret_cast< const ShaderPackageHeader* >( mappedData );
+    auto  entries    = reinterpret_cast< const ShaderPackageEntry* >( mappedData + sizeof( ShaderPackageHeader ) );
+    auto  entriesEnd = entries + header.entryCount;
+
+    for ( auto& shader : shaders )
+    {
+      auto entry = std::lower_bound( entries, entriesEnd, shader.nameHash, []( const ShaderPackageEntry& entry, uint64_t hash ) { return entry.nameHash < hash; } );
+      if ( entry == entriesEnd || entry->nameHash != shader.nameHash )
+      {
+        std::wcout << shader.name << L" is missing from the package, pack it first!\n";
+        return -1;
+      }
+      checksum += touch( mappedData + entry->offset, entry->size );
+    }
+
+    UnmapViewOfFile( mappedData );
+    CloseHandle( mappingHandle );
+    CloseHandle( fileHandle );
+  }
+  auto packageEnd = Clock::now();
+
+  auto looseMs   = std::chrono::duration< double, std::milli >( looseEnd - looseStart ).count() / rounds;
+  auto packageMs = std::chrono::duration< double, std::milli >( packageEnd - packageStart ).count() / rounds;
+
+  std::cout << "Loading " << shaders.size() << " shaders, average of " << rounds << " rounds (checksum " << checksum << ")\n";
+  std::cout << "  file per shader: " << looseMs << " ms\n";
+  std::cout << "  package:         " << packageMs << " ms\n";
+  std::cout << "  speedup:         " << looseMs / std::max( packageMs, 0.001 ) << "x\n";
+
+  return 0;
+}
+
+int main( int argc, char* argv[] )
+{
+  if ( argc < 3 )
+  {
+    std::cout << "Usage: ShaderPacker <shader directory> <package path> [-debug] [-benchmark]\n";
+    return -1;
+  }
+
+  fs::path directory( argv[ 1 ] );
+  fs::path packagePath( argv[ 2 ] );
+
+  bool debug        = false;
+  bool runBenchmark = false;
+  for ( int argIx = 3; argIx < argc; ++argIx )
+  {
+    std::string arg( argv[ argIx ] );
+    if ( arg == "-debug" )
+      debug = true;
+    else if ( arg == "-benchmark" )
+      runBenchmark = true;
+    else
+    {
+      std::cout << "Unknown option " << arg << "!\n";
+      return -1;
+    }
+  }
+
+  if ( !fs::is_directory( directory ) )
+  {
+    std::cout << "Shader directory not found!\n";
+    return -1;
+  }
+
+  auto shaders = collectShaders( directory, debug );
+  if ( shaders.empty() )
+  {
+    std::cout << "No shaders found!\n";
+    return -1;
+  }
+
+  if ( runBenchmark )
+    return benchmark( shaders, packagePath );
+
+  if ( isUpToDate( packagePath, shaders ) )
+  {
+    std::cout << "Shader package is up to date.\n";
+    return 0;
+  }
+
+  return pack( shaders, packagePath );
+}
@@ -5,6 +5,7 @@
 #include <intrin.h>
 
 #include "../Sandbox/Render/TextureStreamers/TFFFormat.h"
+#include "TileCopy.h"
 
 #define MAKEFOURCC(ch0, ch1, ch2, ch3) ((uint32_t)(uint8_t)(ch0) | ((uint32_t)(uint8_t)(ch1) << 8) | ((uint32_t)(uint8_t)(ch2) << 16) | ((uint32_t)(uint8_t)(ch3) << 24 ))
 
@@ -305,8 +306,6 @@ int main(int argc, char* argv[])
 
   uint8_t* mipData = new uint8_t[ 1024 * 1024 * 1024 ]; // Just big enough to hold "any" size
 
-  int sourceTileMemoryWidth = tileBlockWidth * getBlockSize( ddsHeader );
-
   fseek( inputTextureFileHandle, firstMip, SEEK_SET );
   for ( int mip = 0; mip < int( ddsHeader.mipMapCount ) - tailMipCount; ++mip )
   {
@@ -317,46 +316,21 @@ int main(int argc, char* argv[])
 
     int mipBlockWidth  = std::max( ( int( ddsHeader.width  ) / 4 ) >> mip, 1 );
     int mipBlockHeight = std::max( ( int( ddsHeader.height ) / 4 ) >> mip, 1 );
-    int htiles         = std::max( mipBlockWidth  / tileBlockWidth,  1 );
-    int vtiles         = std::max( mipBlockHeight / tileBlockHeight, 1 );
-
-    auto blockSize = getBlockSize( ddsHeader );
 
-    for ( int ty = 0; ty < vtiles; ++ty )
+    auto writeTile = [&]( int tx, int ty )
     {
-      for ( int tx = 0; tx < htiles; ++tx )
-      {
-        int lineStart   = ty * htiles * tileMemorySize;
-        int readCursor  = lineStart + tx * sourceTileMemoryWidth;
-        int writeCursor = 0;
-
-        auto writeOneLine = [&]()
-        {
-          bool isLeftMostBlock  = tx == 0;
-          bool isRightMostBlock = tx == htiles - 1;
-
-          memcpy_s( tileData + writeCursor, sizeof( tileData ) - writeCursor, mipData + readCursor, sourceTileMemoryWidth );
-          readCursor += mipBlockWidth * blockSize;
-          writeCursor += sourceTileMemoryWidth;
-        };
-
-        bool isTopMostBlock    = ty == 0;
-        bool isBottomMostBlock = ty == vtiles - 1;
-
-        for ( int by = 0; by < tileBlockHeight; ++by )
-          writeOneLine();
-
-        if ( !write( outputTextureFileHandle, tileData, tileMemorySize ) )
-          return -1;
-
-        #if _DEBUG
-          if ( forReserved )
-            WriteTile( outputFileName, mip, tx, ty, tffHeader.tileWidth, tffHeader.tileHeight, tileData, tileMemorySize, ddsHeader );
-          else
-            WriteTile( outputFileName, mip, tx, ty, tffHeader.tileWidth + 8, tffHeader.tileHeight + 8, tileData, tileMemorySize, ddsHeader );
-        #endif
-      }
-    }
+      if ( !write( outputTextureFileHandle, tileData, tileMemorySize ) )
+        return false;
+
+      #if _DEBUG
+        WriteTile( outputFileName, mip, tx, ty, tffHeader.tileWidth, tffHeader.tileHeight, tileData, tileMemorySize, ddsHeader );
+      #endif
+
+      return true;
+    };
+
+    if ( !CopyMipTiles( mipData, mipBlockWidth, mipBlockHeight, tileBlockWidth, tileBlockHeight, getBlockSize( ddsHeader ), tileData, sizeof( tileData ), writeTile ) )
+      return -1;
   }
 
   fclose( outputTextureFileHandle );
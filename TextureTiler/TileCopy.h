@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Cuts a block compressed mip into tiles, in the order the tiles are written to the TFF file. tileFunc gets the
+// tile coordinates once the tile is in tileData, and stops the copy by returning false. The micro benchmarks of
+// the Sandbox measure the tiling with this too.
+template< typename TileFunc >
+inline bool CopyMipTiles( const uint8_t* mipData
+                        , int mipBlockWidth
+                        , int mipBlockHeight
+                        , int tileBlockWidth
+                        , int tileBlockHeight
+                        , int blockSize
+                        , uint8_t* tileData
+                        , size_t tileDataSize
+                        , TileFunc&& tileFunc )
+{
+  int htiles                = mipBlockWidth  / tileBlockWidth  > 1 ? mipBlockWidth  / tileBlockWidth  : 1;
+  int vtiles                = mipBlockHeight / tileBlockHeight > 1 ? mipBlockHeight / tileBlockHeight : 1;
+  int tileMemorySize        = tileBlockWidth * tileBlockHeight * blockSize;
+  int sourceTileMemoryWidth = tileBlockWidth * blockSize;
+
+  for ( int ty = 0; ty < vtiles; ++ty )
+  {
+    for ( int tx = 0; tx < htiles; ++tx )
+    {
+      int lineStart   = ty * htiles * tileMemorySize;
+      int readCursor  = lineStart + tx * sourceTileMemoryWidth;
+      int writeCursor = 0;
+
+      for ( int by = 0; by < tileBlockHeight; ++by )
+      {
+        memcpy_s( tileData + writeCursor, tileDataSize - writeCursor, mipData + readCursor, sourceTileMemoryWidth );
+        readCursor  += mipBlockWidth * blockSize;
+        writeCursor += sourceTileMemoryWidth;
+      }
+
+      if ( !tileFunc( tx, ty ) )
+        return false;
+    }
+  }
+
+  return true;
+}
\ No newline at end of file